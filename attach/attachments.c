@@ -42,6 +42,7 @@
 #include "ncrypt/lib.h"
 #include "parse/lib.h"
 #include "mview.h"
+#include "mx.h"
 
 /**
  * struct AttachMatch - An attachment matching a regex for attachment counter
@@ -59,6 +60,7 @@ static GSList *AttachExclude = NULL; ///< List of attachment types to be ignored
 static GSList *InlineAllow = NULL; ///< List of inline types to counted
 static GSList *InlineExclude = NULL; ///< List of inline types to ignore
 static struct Notify *AttachmentsNotify = NULL; ///< Notifications: #NotifyAttach
+static uint32_t AttachRulesHash = 0; ///< Hash of the lists, 0 if it needs recalculating
 
 /**
  * attachmatch_free - Free an AttachMatch - Implements ::list_free_t - @ingroup list_free_api
@@ -241,31 +243,102 @@ static int count_body_parts(struct Body *b)
   return (count < 0) ? 0 : count;
 }
 
+/**
+ * attach_rules_hash - Get a hash of the rules for counting attachments
+ * @retval num Hash, never 0
+ *
+ * An attachment count is only valid for the rules it was counted with.
+ */
+static uint32_t attach_rules_hash(void)
+{
+  if (AttachRulesHash == 0)
+  {
+    GSList *lists[] = { AttachAllow, AttachExclude, InlineAllow, InlineExclude };
+    GChecksum *checksum = g_checksum_new(G_CHECKSUM_MD5);
+
+    for (size_t i = 0; i < mutt_array_size(lists); i++)
+    {
+      for (GSList *np = lists[i]; np != NULL; np = np->next)
+      {
+        const struct AttachMatch *a = np->data;
+        g_checksum_update(checksum, (const guchar *) a->major, -1);
+        g_checksum_update(checksum, (const guchar *) "/", 1);
+        g_checksum_update(checksum, (const guchar *) a->minor, -1);
+        g_checksum_update(checksum, (const guchar *) "\n", 1);
+      }
+      g_checksum_update(checksum, (const guchar *) "|", 1);
+    }
+
+    guint8 digest[16] = { 0 };
+    gsize digest_len = sizeof(digest);
+    g_checksum_get_digest(checksum, digest, &digest_len);
+    g_checksum_free(checksum);
+    memcpy(&AttachRulesHash, digest, sizeof(AttachRulesHash));
+  }
+
+  /* The lowest bit is $count_alternatives */
+  const bool c_count_alternatives = cs_subset_bool(SpaceMutt->sub, "count_alternatives");
+  const uint32_t hash = (AttachRulesHash & ~1U) | c_count_alternatives;
+  return (hash == 0) ? 2 : hash;
+}
+
+/**
+ * mutt_count_needs_message - Does counting the attachments need the message?
+ * @param e Email
+ * @retval true The message must be opened for mutt_count_body_parts()
+ *
+ * The count, or the MIME summary it's calculated from, may already be known,
+ * e.g. from the header cache.
+ */
+bool mutt_count_needs_message(const struct Email *e)
+{
+  if (!e || e->attach_valid || e->mime_summary)
+    return false;
+
+  return !e->body || !e->body->parts;
+}
+
 /**
  * mutt_count_body_parts - Count the MIME Body parts
  * @param m Mailbox
  * @param e Email
- * @param fp File to parse
+ * @param fp File to parse, may be NULL, see mutt_count_needs_message()
  * @retval num Number of MIME Body parts
+ *
+ * The count is saved in the header cache, along with a summary of the MIME
+ * structure.  If the attachment rules change, it's recounted from the summary.
  */
-int mutt_count_body_parts(const struct Mailbox *m, struct Email *e, FILE *fp)
+int mutt_count_body_parts(struct Mailbox *m, struct Email *e, FILE *fp)
 {
   if (!m || !e)
     return 0;
 
-  bool keep_parts = false;
-
   if (e->attach_valid)
     return e->attach_total;
 
-  if (e->body->parts)
-    keep_parts = true;
-  else
+  const uint32_t rules = attach_rules_hash();
+  if (e->mime_summary && (e->attach_rules == rules))
+  {
+    trace_counter("attach_count_cached", 1);
+    e->attach_valid = true;
+    return e->attach_total;
+  }
+
+  const bool keep_parts = (e->body->parts != NULL);
+  struct Body *b_summary = keep_parts ? NULL : part_summary_body(e->mime_summary);
+  if (keep_parts && !e->mime_summary)
+  {
+    e->mime_summary = part_summary_new(e->body);
+  }
+  else if (!keep_parts && !b_summary)
+  {
+    trace_counter("attach_count_parsed", 1);
     mutt_parse_mime_message(e, fp);
+  }
 
   if (AttachAllow || AttachExclude || InlineAllow || InlineExclude)
   {
-    e->attach_total = count_body_parts(e->body);
+    e->attach_total = count_body_parts(b_summary ? b_summary : e->body);
   }
   else
   {
@@ -274,9 +347,19 @@ int mutt_count_body_parts(const struct Mailbox *m, struct Email *e, FILE *fp)
 
   e->attach_valid = true;
 
-  if (!keep_parts)
+  if (b_summary)
+    mutt_body_free(&b_summary);
+  else if (!keep_parts)
     mutt_body_free(&e->body->parts);
 
+  /* Remember the count, so the message needn't be read again.
+   * This is called while the index is drawn, so don't write it yet. */
+  if (e->mime_summary)
+  {
+    e->attach_rules = rules;
+    mx_hcache_defer(m, e);
+  }
+
   return e->attach_total;
 }
 
@@ -298,6 +381,7 @@ void mutt_attachments_reset(struct MailboxView *mv)
       break;
     e->attach_valid = false;
     e->attach_total = 0;
+    e->attach_rules = 0;
   }
 }
 
@@ -375,6 +459,7 @@ static enum CommandResult parse_attach_list(struct Buffer *buf, struct Buffer *s
   if (!a)
     return MUTT_CMD_ERROR;
 
+  AttachRulesHash = 0;
   log_notify("NT_ATTACH_ADD: %s/%s", a->major, a->minor);
   notify_send(AttachmentsNotify, NT_ATTACH, NT_ATTACH_ADD, NULL);
 
@@ -443,6 +528,7 @@ static enum CommandResult parse_unattach_list(struct Buffer *buf, struct Buffer
 
   FREE(&tmp);
 
+  AttachRulesHash = 0;
   notify_send(AttachmentsNotify, NT_ATTACH, NT_ATTACH_DELETE, NULL);
 
   return MUTT_CMD_SUCCESS;
@@ -553,6 +639,7 @@ enum CommandResult parse_unattachments(struct Buffer *buf, struct Buffer *s,
     g_slist_free_full(g_steal_pointer(&InlineAllow), (GDestroyNotify)attachmatch_free);
     g_slist_free_full(g_steal_pointer(&InlineExclude), (GDestroyNotify)attachmatch_free);
 
+    AttachRulesHash = 0;
     log_notify("NT_ATTACH_DELETE_ALL");
     notify_send(AttachmentsNotify, NT_ATTACH, NT_ATTACH_DELETE_ALL, NULL);
     return 0;
@@ -597,7 +684,9 @@ void mutt_parse_mime_message(struct Email *e, FILE *fp)
                           (e->body->type == TYPE_MULTIPART);
   const bool not_parsed = (e->body->parts == NULL);
 
-  if (right_type && fp && not_parsed)
+  const bool parse = right_type && fp && not_parsed;
+
+  if (parse)
   {
     mutt_parse_part(fp, e->body);
     if (WithCrypto)
@@ -606,5 +695,13 @@ void mutt_parse_mime_message(struct Email *e, FILE *fp)
     }
   }
 
+  /* Summarise the structure, once it's known */
+  if (parse || (!e->mime_summary && (!right_type || !not_parsed)))
+  {
+    part_summary_free(&e->mime_summary);
+    e->mime_summary = part_summary_new(e->body);
+    e->attach_rules = 0;
+  }
+
   e->attach_valid = false;
 }
@@ -23,6 +23,7 @@
 #ifndef MUTT_ATTACH_ATTACHMENTS_H
 #define MUTT_ATTACH_ATTACHMENTS_H
 
+#include <stdbool.h>
 #include <stdio.h>
 
 struct Email;
@@ -46,8 +47,9 @@ enum NotifyAttach
 void attach_init(void);
 void attach_cleanup(void);
 
-void mutt_attachments_reset (struct MailboxView *mv);
-int  mutt_count_body_parts  (const struct Mailbox *m, struct Email *e, FILE *fp);
-void mutt_parse_mime_message(struct Email *e, FILE *fp);
+void mutt_attachments_reset  (struct MailboxView *mv);
+int  mutt_count_body_parts   (struct Mailbox *m, struct Email *e, FILE *fp);
+bool mutt_count_needs_message(const struct Email *e);
+void mutt_parse_mime_message (struct Email *e, FILE *fp);
 
 #endif /* MUTT_ATTACH_ATTACHMENTS_H */
@@ -54,6 +54,7 @@
 #include "attach/lib.h"
 #include "color/lib.h"
 #include "imap/lib.h"
+#include "index/lib.h"
 #include "key/lib.h"
 #include "menu/lib.h"
 #include "pager/lib.h"
@@ -174,6 +175,27 @@ enum CommandResult parse_rc_line_cwd(const char *line, char *cwd, struct Buffer
   return ret;
 }
 
+/**
+ * parse_rc_command_cwd - Run a Command in a relative directory
+ * @param cmd  Command to run
+ * @param args Arguments of the Command
+ * @param cwd  File relative where to run the Command
+ * @param err  Where to write error messages
+ * @retval #CommandResult Result e.g. #MUTT_CMD_SUCCESS
+ */
+enum CommandResult parse_rc_command_cwd(const struct Command *cmd, const char *args,
+                                        char *cwd, struct Buffer *err)
+{
+  MuttrcStack = g_slist_prepend(MuttrcStack, mutt_str_dup(NONULL(cwd)));
+
+  enum CommandResult ret = parse_rc_command(cmd, args, err);
+
+  g_free(MuttrcStack->data);
+  MuttrcStack = g_slist_delete_link(MuttrcStack, MuttrcStack);
+
+  return ret;
+}
+
 /**
  * mutt_get_sourced_cwd - Get the current file path that is being parsed
  * @retval ptr File path that is being parsed or cwd at runtime
@@ -354,6 +376,40 @@ warn:
   return MUTT_CMD_WARNING;
 }
 
+/**
+ * parse_hcache_gc - Parse the 'hcache-gc' command - Implements Command::parse() - @ingroup command_parse
+ *
+ * Remove the stale entries of the current Mailbox from the header cache.
+ */
+static enum CommandResult parse_hcache_gc(struct Buffer *buf, struct Buffer *s,
+                                          intptr_t data, struct Buffer *err)
+{
+  if (MoreArgs(s))
+  {
+    buf_printf(err, _("%s: too many arguments"), "hcache-gc");
+    return MUTT_CMD_WARNING;
+  }
+
+  struct Mailbox *m = get_current_mailbox();
+  if (!m)
+  {
+    buf_strcpy(err, _("No mailbox is open"));
+    return MUTT_CMD_WARNING;
+  }
+
+  const int removed = mx_hcache_gc(m, true);
+  if (removed < 0)
+  {
+    buf_printf(err, _("%s: %s doesn't use the header cache"), "hcache-gc", mailbox_path(m));
+    return MUTT_CMD_WARNING;
+  }
+
+  log_message(ngettext("Removed %d stale header cache entry",
+                       "Removed %d stale header cache entries", removed),
+              removed);
+  return MUTT_CMD_SUCCESS;
+}
+
 /**
  * parse_ifdef - Parse the 'ifdef' and 'ifndef' commands - Implements Command::parse() - @ingroup command_parse
  *
@@ -1172,6 +1228,51 @@ static enum CommandResult parse_tag_transforms(struct Buffer *buf, struct Buffer
   return MUTT_CMD_SUCCESS;
 }
 
+/**
+ * parse_trace_dump - Parse the 'trace-dump' command - Implements Command::parse() - @ingroup command_parse
+ *
+ * Save the performance trace collected so far, to the file given or `$trace_file`.
+ */
+static enum CommandResult parse_trace_dump(struct Buffer *buf, struct Buffer *s,
+                                           intptr_t data, struct Buffer *err)
+{
+  if (MoreArgs(s))
+  {
+    parse_extract_token(buf, s, TOKEN_NO_FLAGS);
+    if (MoreArgs(s))
+    {
+      buf_printf(err, _("%s: too many arguments"), "trace-dump");
+      return MUTT_CMD_WARNING;
+    }
+  }
+  else
+  {
+    buf_strcpy(buf, cs_subset_path(SpaceMutt->sub, "trace_file"));
+  }
+
+  if (buf_is_empty(buf))
+  {
+    buf_printf(err, _("%s: no file given and $trace_file is unset"), "trace-dump");
+    return MUTT_CMD_WARNING;
+  }
+
+  if (!TraceEnabled)
+  {
+    buf_printf(err, _("%s: tracing is disabled, set $trace_file"), "trace-dump");
+    return MUTT_CMD_WARNING;
+  }
+
+  buf_expand_path(buf);
+  if (!trace_dump(buf_string(buf)))
+  {
+    buf_printf(err, _("Could not write trace to %s: %s"), buf_string(buf), strerror(errno));
+    return MUTT_CMD_ERROR;
+  }
+
+  log_message(_("Trace written to %s"), buf_string(buf));
+  return MUTT_CMD_SUCCESS;
+}
+
 /**
  * parse_unignore - Parse the 'unignore' command - Implements Command::parse() - @ingroup command_parse
  */
@@ -1490,6 +1591,7 @@ static const struct Command MuttCommands[] = {
   { "exec",                mutt_parse_exec,        0 },
   { "finish",              parse_finish,           0 },
   { "group",               parse_group,            MUTT_GROUP },
+  { "hcache-gc",           parse_hcache_gc,        0 },
   { "hdr_order",           parse_gslist,           IP &HeaderOrderList },
   { "ifdef",               parse_ifdef,            0 },
   { "ifndef",              parse_ifdef,            1 },
@@ -1514,6 +1616,7 @@ static const struct Command MuttCommands[] = {
   { "tag-formats",         parse_tag_formats,      0 },
   { "tag-transforms",      parse_tag_transforms,   0 },
   { "toggle",              parse_set,              MUTT_SET_INV },
+  { "trace-dump",          parse_trace_dump,       0 },
   { "unalias",             parse_unalias,          0 },
   { "unalternates",        parse_unalternates,     0 },
   { "unalternative_order", parse_ungslist,         IP &AlternativeOrderList },
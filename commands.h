@@ -44,6 +44,7 @@ enum CommandResult parse_unmailboxes     (struct Buffer *buf, struct Buffer *s,
 enum CommandResult parse_unsubjectrx_list(struct Buffer *buf, struct Buffer *s, intptr_t data, struct Buffer *err);
 enum CommandResult parse_unsubscribe_from(struct Buffer *buf, struct Buffer *s, intptr_t data, struct Buffer *err);
 
+enum CommandResult parse_rc_command_cwd(const struct Command *cmd, const char *args, char *cwd, struct Buffer *err);
 enum CommandResult parse_rc_line_cwd(const char *line, char *cwd, struct Buffer *err);
 char *mutt_get_sourced_cwd(void);
 bool mailbox_add_simple(const char *mailbox, struct Buffer *err);
@@ -45,11 +45,17 @@
  * Usage with Compression Level set to X:
  * - open(level X) -> N times compress() -> close()
  * - open(level X) -> N times decompress() -> close()
+ *
+ * Small, similar records compress much better with a shared dictionary.
+ * Backends that support it implement dict_train() and dict_load():
+ * - dict_train(samples) -> dictionary
+ * - open(level X) -> dict_load(dictionary) -> N times compress() -> close()
  */
 
 #ifndef MUTT_COMPRESS_LIB_H
 #define MUTT_COMPRESS_LIB_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 /// Opaque type for compression data
@@ -110,6 +116,39 @@ struct ComprOps
    */
   void *(*decompress)(ComprHandle *handle, const char *cbuf, size_t clen);
 
+  /**
+   * @defgroup compress_dict_train dict_train()
+   * @ingroup compress_api
+   *
+   * dict_train - Create a compression dictionary from sample data
+   * @param[in]  samples Samples, one after another
+   * @param[in]  sizes   Length of each sample
+   * @param[in]  count   Number of samples
+   * @param[out] dlen    Length of the dictionary
+   * @retval ptr  Success, dictionary (the caller must free it)
+   * @retval NULL Otherwise, e.g. too few samples
+   *
+   * @note Optional, may be NULL if the backend doesn't support dictionaries
+   */
+  void *(*dict_train)(const char *samples, const size_t *sizes, size_t count, size_t *dlen);
+
+  /**
+   * @defgroup compress_dict_load dict_load()
+   * @ingroup compress_api
+   *
+   * dict_load - Use a dictionary for compress() and decompress()
+   * @param[in] handle Compression handle
+   * @param[in] dict   Dictionary from dict_train() (copied)
+   * @param[in] dlen   Length of the dictionary
+   * @retval true  Success
+   * @retval false Otherwise
+   *
+   * Data compressed without the dictionary can still be decompressed.
+   *
+   * @note Optional, may be NULL if the backend doesn't support dictionaries
+   */
+  bool (*dict_load)(ComprHandle *handle, const void *dict, size_t dlen);
+
   /**
    * @defgroup compress_close close()
    * @ingroup compress_api
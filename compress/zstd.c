@@ -30,7 +30,10 @@
  */
 
 #include "config.h"
+#include <limits.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <zdict.h>
 #include <zstd.h>
 #include "private.h"
 #include "mutt/lib.h"
@@ -39,6 +42,9 @@
 #define MIN_COMP_LEVEL 1  ///< Minimum compression level for zstd
 #define MAX_COMP_LEVEL 22 ///< Maximum compression level for zstd
 
+/// Maximum size of a trained dictionary
+#define ZSTD_DICT_SIZE (16 * 1024)
+
 /**
  * struct ZstdComprData - Private Zstandard Compression Data
  */
@@ -49,6 +55,10 @@ struct ZstdComprData
 
   ZSTD_CCtx *cctx; ///< Compression context
   ZSTD_DCtx *dctx; ///< Decompression context
+
+  ZSTD_CDict *cdict;     ///< Digested dictionary for compression
+  ZSTD_DDict *ddict;     ///< Digested dictionary for decompression
+  unsigned int dict_id;  ///< ID of the dictionary, written in each frame
 };
 
 /**
@@ -124,7 +134,11 @@ static void *compr_zstd_compress(ComprHandle *handle, const char *data,
   size_t len = ZSTD_compressBound(dlen);
   cdata->buf = g_realloc(cdata->buf, len);
 
-  size_t rc = ZSTD_compressCCtx(cdata->cctx, cdata->buf, len, data, dlen, cdata->level);
+  size_t rc;
+  if (cdata->cdict)
+    rc = ZSTD_compress_usingCDict(cdata->cctx, cdata->buf, len, data, dlen, cdata->cdict);
+  else
+    rc = ZSTD_compressCCtx(cdata->cctx, cdata->buf, len, data, dlen, cdata->level);
   if (ZSTD_isError(rc))
     return NULL; // LCOV_EXCL_LINE
 
@@ -153,13 +167,77 @@ static void *compr_zstd_decompress(ComprHandle *handle, const char *cbuf, size_t
     return NULL; // LCOV_EXCL_LINE
   cdata->buf = g_realloc(cdata->buf, len);
 
-  size_t rc = ZSTD_decompressDCtx(cdata->dctx, cdata->buf, len, cbuf, clen);
+  // Frames record the dictionary they need; 0 means none
+  size_t rc;
+  const unsigned int dict_id = ZSTD_getDictID_fromFrame(cbuf, clen);
+  if (dict_id == 0)
+    rc = ZSTD_decompressDCtx(cdata->dctx, cdata->buf, len, cbuf, clen);
+  else if (cdata->ddict && (dict_id == cdata->dict_id))
+    rc = ZSTD_decompress_usingDDict(cdata->dctx, cdata->buf, len, cbuf, clen, cdata->ddict);
+  else
+    return NULL;
   if (ZSTD_isError(rc))
     return NULL; // LCOV_EXCL_LINE
 
   return cdata->buf;
 }
 
+/**
+ * compr_zstd_dict_train - Create a compression dictionary from sample data - Implements ComprOps::dict_train() - @ingroup compress_dict_train
+ */
+static void *compr_zstd_dict_train(const char *samples, const size_t *sizes,
+                                   size_t count, size_t *dlen)
+{
+  if (!samples || !sizes || (count == 0) || (count > UINT_MAX) || !dlen)
+    return NULL;
+
+  void *dict = g_malloc(ZSTD_DICT_SIZE);
+  size_t rc = ZDICT_trainFromBuffer(dict, ZSTD_DICT_SIZE, samples, sizes, (unsigned int) count);
+  if (ZDICT_isError(rc))
+  {
+    log_debug1("Training a dictionary failed: %s", ZDICT_getErrorName(rc));
+    FREE(&dict);
+    return NULL;
+  }
+
+  *dlen = rc;
+  return dict;
+}
+
+/**
+ * compr_zstd_dict_load - Use a dictionary for compress() and decompress() - Implements ComprOps::dict_load() - @ingroup compress_dict_load
+ */
+static bool compr_zstd_dict_load(ComprHandle *handle, const void *dict, size_t dlen)
+{
+  if (!handle || !dict || (dlen == 0))
+    return false;
+
+  // Decloak an opaque pointer
+  struct ZstdComprData *cdata = handle;
+
+  const unsigned int dict_id = ZDICT_getDictID(dict, dlen);
+  if (dict_id == 0)
+    return false;
+
+  ZSTD_CDict *cdict = ZSTD_createCDict(dict, dlen, cdata->level);
+  ZSTD_DDict *ddict = ZSTD_createDDict(dict, dlen);
+  if (!cdict || !ddict)
+  {
+    // LCOV_EXCL_START
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+    return false;
+    // LCOV_EXCL_STOP
+  }
+
+  ZSTD_freeCDict(cdata->cdict);
+  ZSTD_freeDDict(cdata->ddict);
+  cdata->cdict = cdict;
+  cdata->ddict = ddict;
+  cdata->dict_id = dict_id;
+  return true;
+}
+
 /**
  * compr_zstd_close - Close a compression context - Implements ComprOps::close() - @ingroup compress_close
  */
@@ -177,7 +255,10 @@ static void compr_zstd_close(ComprHandle **ptr)
   if (cdata->dctx)
     ZSTD_freeDCtx(cdata->dctx);
 
+  ZSTD_freeCDict(cdata->cdict);
+  ZSTD_freeDDict(cdata->ddict);
+
   zstd_cdata_free((struct ZstdComprData **) ptr);
 }
 
-COMPRESS_OPS(zstd, MIN_COMP_LEVEL, MAX_COMP_LEVEL)
+COMPRESS_DICT_OPS(zstd, MIN_COMP_LEVEL, MAX_COMP_LEVEL)
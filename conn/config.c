@@ -77,6 +77,9 @@ static struct ConfigDef ConnVarsSsl[] = {
   { "ssl_force_tls", DT_BOOL, true, 0, NULL,
     "(ssl) Require TLS encryption for all connections"
   },
+  { "ssl_session_file", DT_PATH|D_PATH_FILE, 0, 0, NULL,
+    "(ssl) File to save TLS sessions in, for resumption"
+  },
   { "ssl_starttls", DT_QUAD, MUTT_YES, 0, NULL,
     "(ssl) Use STARTTLS on servers advertising the capability"
   },
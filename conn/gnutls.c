@@ -611,11 +611,12 @@ static int tls_check_one_certificate(const gnutls_datum_t *certdata,
 
 /**
  * tls_check_certificate - Check a connection's certificate
- * @param conn Connection to a server
+ * @param[in]  conn     Connection to a server
+ * @param[out] verified Set to true if the chain passed without the user's help
  * @retval 1 Certificate is valid
  * @retval 0 Error, or certificate is invalid
  */
-static int tls_check_certificate(struct Connection *conn)
+static int tls_check_certificate(struct Connection *conn, bool *verified)
 {
   struct TlsSockData *data = conn->sockdata;
   gnutls_session_t session = data->session;
@@ -625,6 +626,8 @@ static int tls_check_certificate(struct Connection *conn)
   int certerr, savedcert, rc = 0;
   int max_preauth_pass = -1;
 
+  *verified = false;
+
   /* tls_verify_peers() calls gnutls_certificate_verify_peers2(),
    * which verifies the auth_type is GNUTLS_CRD_CERTIFICATE
    * and that get_certificate_type() for the server is GNUTLS_CRT_X509.
@@ -661,6 +664,13 @@ static int tls_check_certificate(struct Connection *conn)
     }
   }
 
+  /* Every certificate passed, and none was found in $certificate_file */
+  if ((certstat == 0) && (preauthrc == 0) && !savedcert)
+  {
+    *verified = true;
+    return 1;
+  }
+
   /* then check interactively, starting from chain root */
   for (int i = cert_list_size - 1; i >= 0; i--)
   {
@@ -692,6 +702,88 @@ static int tls_check_certificate(struct Connection *conn)
   return rc;
 }
 
+/**
+ * tls_peer_digest - Get the digest of the server's certificate
+ * @param[in]  session TLS session
+ * @param[out] md      Buffer for the SHA-256 digest
+ * @param[in]  mdsize  Size of md
+ * @retval num Length of the digest, 0 on error
+ */
+static size_t tls_peer_digest(gnutls_session_t session, unsigned char *md, size_t mdsize)
+{
+  unsigned int cert_list_size = 0;
+  const gnutls_datum_t *cert_list = gnutls_certificate_get_peers(session, &cert_list_size);
+  if (!cert_list || (cert_list_size == 0))
+    return 0;
+
+  size_t mdlen = mdsize;
+  if (gnutls_fingerprint(GNUTLS_DIG_SHA256, &cert_list[0], md, &mdlen) < 0)
+    return 0;
+
+  return mdlen;
+}
+
+/**
+ * tls_check_unchanged - Has the server's certificate already been verified?
+ * @param conn Connection to a server
+ * @param ts   Server's TLS Session
+ * @retval true The certificate passed verification earlier, is still in date and matches the host
+ */
+static bool tls_check_unchanged(struct Connection *conn, const struct TlsSession *ts)
+{
+  struct TlsSockData *data = conn->sockdata;
+  unsigned char md[64] = { 0 };
+
+  size_t mdlen = tls_peer_digest(data->session, md, sizeof(md));
+  if ((mdlen == 0) || !tls_session_cert_known(ts, md, mdlen))
+    return false;
+
+  unsigned int cert_list_size = 0;
+  const gnutls_datum_t *cert_list = gnutls_certificate_get_peers(data->session, &cert_list_size);
+  gnutls_x509_crt_t cert;
+  if (gnutls_x509_crt_init(&cert) < 0)
+    return false;
+
+  bool valid = (gnutls_x509_crt_import(cert, &cert_list[0], GNUTLS_X509_FMT_DER) >= 0);
+
+  const bool c_ssl_verify_dates = cs_subset_bool(SpaceMutt->sub, "ssl_verify_dates");
+  if (valid && (c_ssl_verify_dates != MUTT_NO))
+  {
+    valid = (gnutls_x509_crt_get_expiration_time(cert) >= mutt_date_now()) &&
+            (gnutls_x509_crt_get_activation_time(cert) <= mutt_date_now());
+  }
+
+  const bool c_ssl_verify_host = cs_subset_bool(SpaceMutt->sub, "ssl_verify_host");
+  if (valid && (c_ssl_verify_host != MUTT_NO))
+    valid = gnutls_x509_crt_check_hostname(cert, conn->account.host);
+
+  gnutls_x509_crt_deinit(cert);
+  if (!valid)
+    return false;
+
+  log_debug2("certificate unchanged, skipping verification");
+  return true;
+}
+
+/**
+ * tls_save_session - Remember the session for resumption
+ * @param conn Connection to a server
+ *
+ * With TLS 1.3, the session tickets arrive after the handshake, so this is
+ * called when the connection is closed.
+ */
+static void tls_save_session(struct Connection *conn)
+{
+  struct TlsSockData *data = conn->sockdata;
+  gnutls_datum_t sess = { 0 };
+
+  if (gnutls_session_get_data2(data->session, &sess) < 0)
+    return;
+
+  tls_session_set(tls_session_get(&conn->account), sess.data, sess.size);
+  gnutls_free(sess.data);
+}
+
 /**
  * tls_get_client_cert - Get the client certificate for a TLS connection
  * @param conn Connection to a server
@@ -935,6 +1027,10 @@ static int tls_negotiate(struct Connection *conn)
 
   gnutls_credentials_set(data->session, GNUTLS_CRD_CERTIFICATE, data->xcred);
 
+  /* offer the server's last session for resumption */
+  struct TlsSession *ts = tls_session_get(&conn->account);
+  const bool offered = ts->data && (gnutls_session_set_data(data->session, ts->data, ts->len) == 0);
+
   do
   {
     err = gnutls_handshake(data->session);
@@ -951,11 +1047,29 @@ static int tls_negotiate(struct Connection *conn)
     {
       log_fault("gnutls_handshake: %s", gnutls_strerror(err));
     }
+
+    /* Don't offer the session again, in case it caused the failure */
+    if (offered)
+      tls_session_set(ts, NULL, 0);
     goto fail;
   }
 
-  if (tls_check_certificate(conn) == 0)
-    goto fail;
+  tls_session_count(ts, gnutls_session_is_resumed(data->session));
+
+  if (!tls_check_unchanged(conn, ts))
+  {
+    bool verified = false;
+    if (tls_check_certificate(conn, &verified) == 0)
+      goto fail;
+
+    /* Only remember a certificate that passed without the user's help */
+    unsigned char md[64] = { 0 };
+    size_t mdlen = tls_peer_digest(data->session, md, sizeof(md));
+    if (!verified)
+      tls_session_user_trusted(ts);
+    else if (mdlen > 0)
+      tls_session_cert_verified(ts, md, mdlen);
+  }
 
   /* set Security Strength Factor (SSF) for SASL */
   /* NB: gnutls_cipher_get_key_size() returns key length in bytes */
@@ -1012,6 +1126,7 @@ static int tls_socket_close(struct Connection *conn)
      * It is not required for the initiator of the close to wait for the
      * responding close_notify alert before closing the read side of the
      * connection.  */
+    tls_save_session(conn);
     gnutls_bye(data->session, GNUTLS_SHUT_WR);
 
     gnutls_certificate_free_credentials(data->xcred);
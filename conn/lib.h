@@ -39,6 +39,7 @@
  * | conn/sasl.c           | @subpage conn_sasl            |
  * | conn/sasl_plain.c     | @subpage conn_sasl_plain      |
  * | conn/socket.c         | @subpage conn_socket          |
+ * | conn/tlscache.c       | @subpage conn_tlscache        |
  * | conn/tunnel.c         | @subpage conn_tunnel          |
  * | conn/zstrm.c          | @subpage conn_zstrm           |
  */
@@ -67,6 +68,8 @@ struct Buffer;
 
 #ifdef USE_SSL
 int mutt_ssl_starttls(struct Connection *conn);
+
+void tls_sessions_cleanup(void);
 #endif
 
 int getdnsdomainname(struct Buffer *result);
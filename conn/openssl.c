@@ -73,6 +73,7 @@
 #define X509_getm_notBefore X509_get_notBefore
 #define X509_getm_notAfter X509_get_notAfter
 #define X509_STORE_CTX_get0_chain X509_STORE_CTX_get_chain
+#define X509_STORE_CTX_get0_cert(ctx) ((ctx)->cert)
 #define SSL_has_pending SSL_pending
 #endif
 
@@ -88,6 +89,9 @@ static int HostExDataIndex = -1;
  * skips a certificate in the chain, the stored value will be non-null. */
 static int SkipModeExDataIndex = -1;
 
+/// Index for storing the server's TlsSession in the SSL structure
+static int SessionExDataIndex = -1;
+
 /** Keep a handle on accepted certificates in case we want to
  * open up another connection to the same server in this session */
 static STACK_OF(X509) *SslSessionCerts = NULL;
@@ -987,6 +991,18 @@ static bool interactive_check_cert(X509 *cert, int idx, size_t len, SSL *ssl, bo
   return (rc > 1);
 }
 
+/**
+ * ssl_user_trusted - Note that the user, not a CA, vouched for a certificate
+ * @param ssl SSL structure
+ * @retval true Always
+ */
+static bool ssl_user_trusted(SSL *ssl)
+{
+  if (SessionExDataIndex != -1)
+    tls_session_user_trusted(SSL_get_ex_data(ssl, SessionExDataIndex));
+  return true;
+}
+
 /**
  * ssl_verify_callback - Certificate verification callback
  * @param preverify_ok If true, don't question the user if they skipped verification
@@ -1047,7 +1063,7 @@ static int ssl_verify_callback(int preverify_ok, X509_STORE_CTX *ctx)
           certificates_equal(cert, last_cert, last_cert_md, last_cert_mdlen))
       {
         log_debug2("ignoring duplicate skipped certificate");
-        return true;
+        return ssl_user_trusted(ssl);
       }
     }
 
@@ -1063,7 +1079,7 @@ static int ssl_verify_callback(int preverify_ok, X509_STORE_CTX *ctx)
   {
     log_debug2("using cached certificate");
     SSL_set_ex_data(ssl, SkipModeExDataIndex, NULL);
-    return true;
+    return ssl_user_trusted(ssl);
   }
 
   /* check hostname only for the leaf certificate */
@@ -1076,7 +1092,7 @@ static int ssl_verify_callback(int preverify_ok, X509_STORE_CTX *ctx)
       log_fault(_("Certificate host check failed: %s"), buf);
       /* we disallow (a)ccept always in the prompt, because it will have no effect
        * for hostname mismatches. */
-      return interactive_check_cert(cert, pos, len, ssl, false);
+      return interactive_check_cert(cert, pos, len, ssl, false) && ssl_user_trusted(ssl);
     }
     log_debug2("hostname check passed");
   }
@@ -1089,7 +1105,7 @@ static int ssl_verify_callback(int preverify_ok, X509_STORE_CTX *ctx)
     {
       log_debug2("digest check passed");
       SSL_set_ex_data(ssl, SkipModeExDataIndex, NULL);
-      return true;
+      return ssl_user_trusted(ssl);
     }
 
     /* log verification error */
@@ -1098,12 +1114,118 @@ static int ssl_verify_callback(int preverify_ok, X509_STORE_CTX *ctx)
     log_debug2("X509_verify_cert: %s", buf);
 
     /* prompt user */
-    return interactive_check_cert(cert, pos, len, ssl, true);
+    return interactive_check_cert(cert, pos, len, ssl, true) && ssl_user_trusted(ssl);
   }
 
   return true;
 }
 
+/**
+ * ssl_cert_verify_callback - Verify the server's certificate chain
+ * @param ctx X509 store context
+ * @param arg Unused
+ * @retval 1 Certificate chain is trusted
+ * @retval 0 Certificate chain is not trusted
+ *
+ * If the server presents the same certificate that OpenSSL verified earlier in
+ * this session, there's no need to check the chain again.  Otherwise, OpenSSL
+ * verifies the chain and ssl_verify_callback() is called for each certificate.
+ *
+ * Only a certificate that passed without the user's help is remembered.  One
+ * the user accepted must be checked, and perhaps prompted for, every time.
+ */
+static int ssl_cert_verify_callback(X509_STORE_CTX *ctx, void *arg)
+{
+  SSL *ssl = X509_STORE_CTX_get_ex_data(ctx, SSL_get_ex_data_X509_STORE_CTX_idx());
+  struct TlsSession *ts = ssl ? SSL_get_ex_data(ssl, SessionExDataIndex) : NULL;
+  X509 *cert = X509_STORE_CTX_get0_cert(ctx);
+
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int mdlen = 0;
+  if (!cert || !X509_digest(cert, EVP_sha256(), md, &mdlen))
+    mdlen = 0;
+
+  if ((mdlen > 0) && tls_session_cert_known(ts, md, mdlen) &&
+      check_certificate_expiration(cert, true))
+  {
+    char buf[256] = { 0 };
+    const char *host = SSL_get_ex_data(ssl, HostExDataIndex);
+    const bool c_ssl_verify_host = cs_subset_bool(SpaceMutt->sub, "ssl_verify_host");
+    if ((c_ssl_verify_host == MUTT_NO) || (host && check_host(cert, host, buf, sizeof(buf))))
+    {
+      log_debug2("certificate unchanged, skipping verification");
+      return 1;
+    }
+  }
+
+  if (ts)
+    ts->user_trusted = false;
+
+  int rc = X509_verify_cert(ctx);
+  if ((rc > 0) && (mdlen > 0) && ts && !ts->user_trusted)
+    tls_session_cert_verified(ts, md, mdlen);
+
+  return rc;
+}
+
+/**
+ * ssl_new_session_callback - Remember a new session for resumption
+ * @param ssl  SSL structure
+ * @param sess New session
+ * @retval 0 The session wasn't kept
+ *
+ * With TLS 1.3, the server may send session tickets at any time after the
+ * handshake, so this is called from SSL_read() too.
+ */
+static int ssl_new_session_callback(SSL *ssl, SSL_SESSION *sess)
+{
+  struct TlsSession *ts = SSL_get_ex_data(ssl, SessionExDataIndex);
+  if (!ts)
+    return 0;
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(LIBRESSL_VERSION_NUMBER)
+  if (!SSL_SESSION_is_resumable(sess))
+    return 0;
+#endif
+
+  int len = i2d_SSL_SESSION(sess, NULL);
+  if (len <= 0)
+    return 0;
+
+  unsigned char *data = g_malloc(len);
+  unsigned char *p = data;
+  if (i2d_SSL_SESSION(sess, &p) == len)
+    tls_session_set(ts, data, len);
+  FREE(&data);
+
+  return 0;
+}
+
+/**
+ * ssl_offer_session - Offer the server's last session for resumption
+ * @param ssl SSL structure
+ * @param ts  Server's TLS Session
+ * @retval true A session was offered
+ */
+static bool ssl_offer_session(SSL *ssl, struct TlsSession *ts)
+{
+  if (!ts || !ts->data)
+    return false;
+
+  const unsigned char *p = ts->data;
+  SSL_SESSION *sess = d2i_SSL_SESSION(NULL, &p, ts->len);
+  if (!sess)
+  {
+    ERR_clear_error();
+    tls_session_set(ts, NULL, 0);
+    return false;
+  }
+
+  bool offered = SSL_set_session(ssl, sess);
+  SSL_SESSION_free(sess);
+  return offered;
+}
+
 /**
  * ssl_negotiate - Attempt to negotiate SSL over the wire
  * @param conn    Connection to a server
@@ -1145,6 +1267,18 @@ static int ssl_negotiate(struct Connection *conn, struct SslSockData *ssldata)
     return -1;
   }
 
+  if (SessionExDataIndex == -1)
+    SessionExDataIndex = SSL_get_ex_new_index(0, "session", NULL, NULL, NULL);
+
+  struct TlsSession *ts = tls_session_get(&conn->account);
+  if ((SessionExDataIndex == -1) || !SSL_set_ex_data(ssldata->ssl, SessionExDataIndex, ts))
+  {
+    log_debug1("#5 failed to save session in SSL structure");
+    ts = NULL;
+  }
+
+  const bool offered = ssl_offer_session(ssldata->ssl, ts);
+
   SSL_set_verify(ssldata->ssl, SSL_VERIFY_PEER, ssl_verify_callback);
   SSL_set_mode(ssldata->ssl, SSL_MODE_AUTO_RETRY);
 
@@ -1180,9 +1314,15 @@ retry:
 
     log_fault(_("SSL failed: %s"), errmsg);
 
+    /* Don't offer the session again, in case it caused the failure */
+    if (offered)
+      tls_session_set(ts, NULL, 0);
+
     return -1;
   }
 
+  tls_session_count(ts, SSL_session_reused(ssldata->ssl));
+
   return 0;
 }
 
@@ -1279,6 +1419,12 @@ static int ssl_setup(struct Connection *conn)
     log_fault(_("Warning: error enabling ssl_verify_partial_chains"));
   }
 
+  /* Sessions are cached per server by tls_session_get(), not by OpenSSL */
+  SSL_CTX_set_session_cache_mode(sockdata(conn)->sctx,
+                                 SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(sockdata(conn)->sctx, ssl_new_session_callback);
+  SSL_CTX_set_cert_verify_callback(sockdata(conn)->sctx, ssl_cert_verify_callback, NULL);
+
   sockdata(conn)->ssl = SSL_new(sockdata(conn)->sctx);
   SSL_set_fd(sockdata(conn)->ssl, conn->fd);
 
@@ -25,14 +25,30 @@
 
 #include "config.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include "mutt/lib.h"
 
+struct ConnAccount;
 struct Connection;
 
 #ifdef USE_SSL
 /// Array of text making up a Certificate
 ARRAY_HEAD(CertArray, const char *);
 
+/**
+ * struct TlsSession - A server's TLS session, for resumption
+ */
+struct TlsSession
+{
+  char *key;                 ///< Server, "host:port"
+  unsigned char *data;       ///< Session, serialised by the TLS library
+  size_t len;                ///< Length of data
+  unsigned char cert_md[32]; ///< SHA-256 digest of the server's certificate
+  bool cert_verified;        ///< cert_md has passed verification
+  bool user_trusted;         ///< The user accepted the certificate, don't save the session
+};
+ARRAY_HEAD(TlsSessionArray, struct TlsSession *);
+
 void cert_array_clear(struct CertArray *carr);
 
 /**
@@ -47,6 +63,14 @@ struct CertMenuData
 
 int mutt_ssl_socket_setup(struct Connection *conn);
 int dlg_certificate(const char *title, struct CertArray *carr, bool allow_always, bool allow_skip);
+
+struct TlsSession *tls_session_get          (const struct ConnAccount *cac);
+void               tls_session_set          (struct TlsSession *ts, const void *data, size_t len);
+bool               tls_session_cert_known   (const struct TlsSession *ts, const unsigned char *md, size_t mdlen);
+void               tls_session_cert_verified(struct TlsSession *ts, const unsigned char *md, size_t mdlen);
+void               tls_session_user_trusted (struct TlsSession *ts);
+void               tls_session_count        (const struct TlsSession *ts, bool resumed);
+void               tls_sessions_stats       (unsigned int *hits, unsigned int *misses);
 #else
 /**
  * [Dummy] Set up the socket multiplexor
@@ -0,0 +1,322 @@
+/**
+ * @file
+ * Cache of TLS sessions, for resumption
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page conn_tlscache Cache of TLS sessions
+ *
+ * A full TLS handshake costs several round trips and a certificate check.
+ * Each server's most recent session is kept, so that the next connection to
+ * it can be resumed with an abbreviated handshake.
+ *
+ * The sessions are opaque, serialised by the TLS library.  If
+ * `$ssl_session_file` is set, they're loaded from there on first use and
+ * saved back, if they've changed, by tls_sessions_cleanup().  Each line of the
+ * file is: `host:port base64-session`
+ *
+ * The digest of the server's certificate is also remembered, once it has
+ * passed the library's verification, without any help from the user.  If a
+ * later full handshake presents the same certificate, the checks needn't be
+ * repeated.  The digests are never saved.
+ *
+ * A session whose certificate the user accepted (at the prompt, or from
+ * `$certificate_file`) is only kept in memory.  Saving it would let the next
+ * NeoMutt resume it without asking.
+ *
+ * Resumed and full handshakes are counted by the `tls_resume_hit` and
+ * `tls_resume_miss` trace counters.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "connaccount.h"
+#include "ssl.h"
+
+/// Sessions, one per server
+static struct TlsSessionArray TlsSessions = ARRAY_HEAD_INITIALIZER;
+/// Has $ssl_session_file been read?
+static bool TlsSessionsLoaded = false;
+/// Have the sessions changed since $ssl_session_file was read?
+static bool TlsSessionsDirty = false;
+/// Number of handshakes that resumed a session
+static unsigned int TlsResumeHits = 0;
+/// Number of full handshakes
+static unsigned int TlsResumeMisses = 0;
+
+/**
+ * tls_session_free - Free a TLS Session
+ * @param ptr TLS Session to free
+ */
+static void tls_session_free(struct TlsSession **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct TlsSession *ts = *ptr;
+  FREE(&ts->key);
+  FREE(&ts->data);
+  FREE(ptr);
+}
+
+/**
+ * tls_session_find - Find the TLS Session for a server
+ * @param key Server, "host:port"
+ * @param create If true, create a TLS Session if there isn't one
+ * @retval ptr TLS Session
+ */
+static struct TlsSession *tls_session_find(const char *key, bool create)
+{
+  struct TlsSession **tp = NULL;
+  ARRAY_FOREACH(tp, &TlsSessions)
+  {
+    if (mutt_str_equal((*tp)->key, key))
+      return *tp;
+  }
+
+  if (!create)
+    return NULL;
+
+  struct TlsSession *ts = g_new0(struct TlsSession, 1);
+  ts->key = mutt_str_dup(key);
+  ARRAY_ADD(&TlsSessions, ts);
+  return ts;
+}
+
+/**
+ * tls_sessions_load - Read the sessions from $ssl_session_file
+ */
+static void tls_sessions_load(void)
+{
+  TlsSessionsLoaded = true;
+
+  const char *const c_ssl_session_file = cs_subset_path(SpaceMutt->sub, "ssl_session_file");
+  if (!c_ssl_session_file)
+    return;
+
+  FILE *fp = mutt_file_fopen(c_ssl_session_file, "r");
+  if (!fp)
+    return;
+
+  char *line = NULL;
+  size_t linelen = 0;
+  int count = 0;
+  while ((line = mutt_file_read_line(line, &linelen, fp, NULL, MUTT_RL_NO_FLAGS)))
+  {
+    char *b64 = strchr(line, ' ');
+    if (!b64)
+      continue;
+    *b64++ = '\0';
+
+    const size_t dlen = strlen(b64);
+    char *data = g_malloc(dlen + 1);
+    const int len = mutt_b64_decode(b64, data, dlen + 1);
+    if (len <= 0)
+    {
+      FREE(&data);
+      continue;
+    }
+
+    struct TlsSession *ts = tls_session_find(line, true);
+    FREE(&ts->data);
+    ts->data = (unsigned char *) data;
+    ts->len = len;
+    count++;
+  }
+  FREE(&line);
+  mutt_file_fclose(&fp);
+
+  log_debug2("loaded %d TLS sessions from %s", count, c_ssl_session_file);
+}
+
+/**
+ * tls_sessions_save - Write the sessions to $ssl_session_file
+ */
+static void tls_sessions_save(void)
+{
+  const char *const c_ssl_session_file = cs_subset_path(SpaceMutt->sub, "ssl_session_file");
+  if (!c_ssl_session_file)
+    return;
+
+  FILE *fp = mutt_file_fopen(c_ssl_session_file, "w");
+  if (!fp)
+  {
+    log_debug1("can't write TLS sessions to %s", c_ssl_session_file);
+    return;
+  }
+
+  struct TlsSession **tp = NULL;
+  ARRAY_FOREACH(tp, &TlsSessions)
+  {
+    const struct TlsSession *ts = *tp;
+    if (!ts->data || ts->user_trusted)
+      continue;
+
+    const size_t b64len = ((ts->len + 2) / 3) * 4 + 1;
+    char *b64 = g_malloc(b64len);
+    mutt_b64_encode((const char *) ts->data, ts->len, b64, b64len);
+    fprintf(fp, "%s %s\n", ts->key, b64);
+    FREE(&b64);
+  }
+
+  mutt_file_fclose(&fp);
+}
+
+/**
+ * tls_session_get - Get the TLS Session for a server
+ * @param cac Account of the server
+ * @retval ptr TLS Session, owned by the cache
+ */
+struct TlsSession *tls_session_get(const struct ConnAccount *cac)
+{
+  if (!TlsSessionsLoaded)
+    tls_sessions_load();
+
+  char key[256] = { 0 };
+  snprintf(key, sizeof(key), "%s:%u", cac->host, cac->port);
+  return tls_session_find(key, true);
+}
+
+/**
+ * tls_session_set - Remember a server's latest session
+ * @param ts   TLS Session
+ * @param data Serialised session, NULL to forget it
+ * @param len  Length of data
+ */
+void tls_session_set(struct TlsSession *ts, const void *data, size_t len)
+{
+  if (!ts)
+    return;
+
+  FREE(&ts->data);
+  ts->len = 0;
+
+  if (data && (len > 0))
+  {
+    ts->data = g_malloc(len);
+    memcpy(ts->data, data, len);
+    ts->len = len;
+  }
+
+  TlsSessionsDirty = true;
+}
+
+/**
+ * tls_session_cert_known - Has this certificate already been verified?
+ * @param ts     TLS Session
+ * @param md     SHA-256 digest of the server's certificate
+ * @param mdlen  Length of md
+ * @retval true The certificate passed verification earlier
+ */
+bool tls_session_cert_known(const struct TlsSession *ts, const unsigned char *md, size_t mdlen)
+{
+  if (!ts || !ts->cert_verified || (mdlen != sizeof(ts->cert_md)))
+    return false;
+
+  return memcmp(ts->cert_md, md, mdlen) == 0;
+}
+
+/**
+ * tls_session_cert_verified - Remember that a certificate passed verification
+ * @param ts     TLS Session
+ * @param md     SHA-256 digest of the server's certificate
+ * @param mdlen  Length of md
+ */
+void tls_session_cert_verified(struct TlsSession *ts, const unsigned char *md, size_t mdlen)
+{
+  if (!ts)
+    return;
+
+  ts->user_trusted = false;
+  ts->cert_verified = (mdlen == sizeof(ts->cert_md));
+  if (ts->cert_verified)
+    memcpy(ts->cert_md, md, mdlen);
+}
+
+/**
+ * tls_session_user_trusted - Remember that the user accepted a certificate
+ * @param ts TLS Session
+ *
+ * The certificate didn't pass verification by itself, so it mustn't skip the
+ * checks next time, and the session mustn't be saved.
+ */
+void tls_session_user_trusted(struct TlsSession *ts)
+{
+  if (!ts)
+    return;
+
+  ts->cert_verified = false;
+  if (!ts->user_trusted)
+    TlsSessionsDirty = true;
+  ts->user_trusted = true;
+}
+
+/**
+ * tls_session_count - Count a handshake
+ * @param ts      TLS Session
+ * @param resumed True if the session was resumed
+ */
+void tls_session_count(const struct TlsSession *ts, bool resumed)
+{
+  if (resumed)
+    TlsResumeHits++;
+  else
+    TlsResumeMisses++;
+
+  trace_counter(resumed ? "tls_resume_hit" : "tls_resume_miss", 1);
+  log_debug2("%s: TLS session %s (resumed %u, full %u)", ts ? ts->key : "",
+             resumed ? "resumed" : "negotiated", TlsResumeHits, TlsResumeMisses);
+}
+
+/**
+ * tls_sessions_stats - Get the number of resumed and full handshakes
+ * @param[out] hits   Number of handshakes that resumed a session
+ * @param[out] misses Number of full handshakes
+ */
+void tls_sessions_stats(unsigned int *hits, unsigned int *misses)
+{
+  if (hits)
+    *hits = TlsResumeHits;
+  if (misses)
+    *misses = TlsResumeMisses;
+}
+
+/**
+ * tls_sessions_cleanup - Save and free the cache of TLS sessions
+ */
+void tls_sessions_cleanup(void)
+{
+  if (TlsSessionsDirty)
+    tls_sessions_save();
+  TlsSessionsDirty = false;
+
+  struct TlsSession **tp = NULL;
+  ARRAY_FOREACH(tp, &TlsSessions)
+  {
+    tls_session_free(tp);
+  }
+  ARRAY_FREE(&TlsSessions);
+  TlsSessionsLoaded = false;
+}
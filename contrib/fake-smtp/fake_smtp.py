@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2024 SpaceMutt developers
+#
+# This program is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 2 of the License, or (at your option) any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""A minimal SMTP server for testing the outbox.
+
+Modes:
+  accept  accept every message and save it to the spool directory
+  refuse  reject every message with a temporary error
+  stall   accept the connection, then never answer
+"""
+
+import argparse
+import os
+import socketserver
+import time
+
+
+class Handler(socketserver.StreamRequestHandler):
+    def send(self, line):
+        self.wfile.write((line + "\r\n").encode())
+        self.wfile.flush()
+
+    def handle(self):
+        mode = self.server.mode
+        if mode == "stall":
+            time.sleep(3600)
+            return
+
+        self.send("220 localhost fake-smtp")
+        while True:
+            line = self.rfile.readline()
+            if not line:
+                return
+            cmd = line.decode(errors="replace").strip().upper()
+            if cmd.startswith(("EHLO", "HELO")):
+                self.send("250 localhost")
+            elif cmd.startswith("MAIL FROM"):
+                if mode == "refuse":
+                    self.send("451 4.3.0 Try again later")
+                else:
+                    self.send("250 OK")
+            elif cmd.startswith("RCPT TO"):
+                self.send("250 OK")
+            elif cmd == "DATA":
+                self.send("354 End data with <CR><LF>.<CR><LF>")
+                self.save(self.read_data())
+                self.send("250 OK queued")
+            elif cmd == "RSET" or cmd == "NOOP":
+                self.send("250 OK")
+            elif cmd == "QUIT":
+                self.send("221 Bye")
+                return
+            else:
+                self.send("502 Command not implemented")
+
+    def read_data(self):
+        lines = []
+        while True:
+            line = self.rfile.readline()
+            if not line or line in (b".\r\n", b".\n"):
+                return b"".join(lines)
+            if line.startswith(b".."):
+                line = line[1:]
+            lines.append(line)
+
+    def save(self, data):
+        self.server.count += 1
+        name = "%d-%d.eml" % (int(time.time()), self.server.count)
+        with open(os.path.join(self.server.spool, name), "wb") as f:
+            f.write(data)
+        print("saved", name, flush=True)
+
+
+class Server(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("mode", choices=["accept", "refuse", "stall"])
+    parser.add_argument("--port", type=int, default=2525)
+    parser.add_argument("--spool", default=".")
+    args = parser.parse_args()
+
+    with Server(("127.0.0.1", args.port), Handler) as server:
+        server.mode = args.mode
+        server.spool = args.spool
+        server.count = 0
+        print("listening on port", args.port, "in", args.mode, "mode", flush=True)
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -30,15 +30,150 @@
 #include "config.h"
 #include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
 #include "mutt/lib.h"
 #include "config/lib.h"
 #include "email/lib.h"
 #include "core/lib.h"
 #include "lib.h"
 
+/// Size of the blocks read when scanning a file
+#define CONTENT_BLOCK (64 * 1024)
+
+/// Number of files whose Content is remembered
+#define CONTENT_CACHE_SIZE 8
+
+/// Repeat a byte across a 64-bit word
+#define BYTES(b) (UINT64_C(0x0101010101010101) * (b))
+
+/**
+ * struct ContentCacheEntry - A remembered analysis of a file
+ *
+ * The Content of a file only depends on its bytes, so it can be reused until
+ * the file changes.
+ */
+struct ContentCacheEntry
+{
+  dev_t dev;               ///< Device of the file
+  ino_t ino;               ///< Inode of the file
+  off_t size;              ///< Size of the file
+  struct timespec mtime;   ///< Modification time of the file
+  struct Content info;     ///< Analysis of the file
+};
+
+/// Recently analysed files
+static struct ContentCacheEntry ContentCache[CONTENT_CACHE_SIZE] = { 0 };
+/// Next slot to be replaced in ContentCache
+static int ContentCacheNext = 0;
+
+/**
+ * content_cache_find - Find the cached analysis of a file
+ * @param st File info
+ * @retval ptr  Cached Content
+ * @retval NULL File hasn't been analysed, or it has changed
+ */
+static const struct Content *content_cache_find(struct stat *st)
+{
+  for (int i = 0; i < CONTENT_CACHE_SIZE; i++)
+  {
+    struct ContentCacheEntry *cc = &ContentCache[i];
+    if ((cc->ino == st->st_ino) && (cc->dev == st->st_dev) &&
+        (cc->size == st->st_size) && (cc->size != 0) &&
+        (mutt_file_stat_timespec_compare(st, MUTT_STAT_MTIME, &cc->mtime) == 0))
+    {
+      return &cc->info;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * content_cache_add - Remember the analysis of a file
+ * @param st   File info
+ * @param info Analysis of the file
+ *
+ * A file modified during the current second could be changed again without
+ * its mtime moving, so it isn't cached.
+ */
+static void content_cache_add(struct stat *st, const struct Content *info)
+{
+  if ((st->st_size == 0) || (st->st_mtime >= mutt_date_now()))
+    return;
+
+  struct ContentCacheEntry *cc = &ContentCache[ContentCacheNext];
+  ContentCacheNext = (ContentCacheNext + 1) % CONTENT_CACHE_SIZE;
+
+  cc->dev = st->st_dev;
+  cc->ino = st->st_ino;
+  cc->size = st->st_size;
+  mutt_file_get_stat_timespec(&cc->mtime, st, MUTT_STAT_MTIME);
+  cc->info = *info;
+}
+
+/**
+ * skip_plain - Count a run of bytes that need no special handling
+ * @param[in]     info       Info about an Attachment
+ * @param[in,out] whitespace Number of trailing spaces
+ * @param[in]     buf        Buffer to scan
+ * @param[in]     buflen     Length of the buffer
+ * @retval num Length of the run
+ *
+ * Printable ASCII and 8-bit bytes only affect the counters, so they're
+ * checked eight at a time.  Any control character, including the line
+ * endings, ends the run.
+ */
+static size_t skip_plain(struct Content *info, int *whitespace, const char *buf, size_t buflen)
+{
+  size_t n = 0;
+
+  for (; (buflen - n) >= sizeof(uint64_t); n += sizeof(uint64_t))
+  {
+    uint64_t x;
+    memcpy(&x, buf + n, sizeof(x));
+
+    const uint64_t del = x ^ BYTES(0x7f);
+    if (((x - BYTES(0x20)) & ~x & BYTES(0x80)) || ((del - BYTES(0x01)) & ~del & BYTES(0x80)))
+      break;
+
+    const long hibin = (((x >> 7) & BYTES(0x01)) * BYTES(0x01)) >> 56;
+    info->hibin += hibin;
+    info->ascii += sizeof(x) - hibin;
+
+    int spaces = 0;
+    while ((spaces < (int) sizeof(x)) && (buf[n + sizeof(x) - 1 - spaces] == ' '))
+      spaces++;
+
+    if (spaces == (int) sizeof(x))
+      *whitespace += spaces;
+    else
+      *whitespace = spaces;
+  }
+
+  for (; n < buflen; n++)
+  {
+    const unsigned char ch = buf[n];
+    if ((ch < 32) || (ch == 127))
+      break;
+
+    if (ch & 0x80)
+      info->hibin++;
+    else
+      info->ascii++;
+
+    if (ch == ' ')
+      (*whitespace)++;
+    else
+      *whitespace = 0;
+  }
+
+  return n;
+}
+
 /**
  * mutt_update_content_info - Cache some info about an email
  * @param info   Info about an Attachment
@@ -67,6 +202,21 @@ void mutt_update_content_info(struct Content *info, struct ContentState *s,
 
   for (; buflen; buf++, buflen--)
   {
+    /* Past the start of a line, only the line endings and the control
+     * characters need looking at */
+    if (!was_cr && (linelen >= 4))
+    {
+      size_t n = skip_plain(info, &whitespace, buf, buflen);
+      if (n != 0)
+      {
+        linelen += n;
+        buf += n;
+        buflen -= n;
+        if (buflen == 0)
+          break;
+      }
+    }
+
     char ch = *buf;
 
     if (was_cr)
@@ -184,6 +334,9 @@ void mutt_update_content_info(struct Content *info, struct ContentState *s,
  * @retval ptr Newly allocated Content
  *
  * Also set the body charset, sometimes, or not.
+ *
+ * Unless the file is converted, the analysis is remembered until the file
+ * changes, so attaching and then sending a file only reads it once.
  */
 struct Content *mutt_get_content_info(const char *fname, struct Body *b,
                                       struct ConfigSubset *sub)
@@ -193,7 +346,7 @@ struct Content *mutt_get_content_info(const char *fname, struct Body *b,
   FILE *fp = NULL;
   char *fromcode = NULL;
   char *tocode = NULL;
-  char buf[100] = { 0 };
+  char *buf = NULL;
   size_t r;
 
   struct stat st = { 0 };
@@ -260,10 +413,24 @@ struct Content *mutt_get_content_info(const char *fname, struct Body *b,
     strlist_free(&chs);
   }
 
-  rewind(fp);
-  while ((r = fread(buf, 1, sizeof(buf), fp)))
-    mutt_update_content_info(info, &cstate, buf, r);
-  mutt_update_content_info(info, &cstate, 0, 0);
+  const struct Content *cached = content_cache_find(&st);
+  if (cached)
+  {
+    log_debug2("using cached content info for %s", fname);
+    *info = *cached;
+  }
+  else
+  {
+    buf = g_malloc(CONTENT_BLOCK);
+    rewind(fp);
+    while ((r = fread(buf, 1, CONTENT_BLOCK, fp)))
+      mutt_update_content_info(info, &cstate, buf, r);
+    mutt_update_content_info(info, &cstate, 0, 0);
+    FREE(&buf);
+
+    if (!ferror(fp))
+      content_cache_add(&st, info);
+  }
 
   mutt_file_fclose(&fp);
 
@@ -64,8 +64,8 @@
 size_t mutt_convert_file_to(FILE *fp, const char *fromcode, struct StrList const *const tocodes,
                             int *tocode, struct Content *info)
 {
-  char bufi[256] = { 0 };
-  char bufu[512] = { 0 };
+  char bufi[4096] = { 0 };
+  char bufu[8192] = { 0 };
   char bufo[4 * sizeof(bufi)] = { 0 };
   size_t rc;
 
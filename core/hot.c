@@ -0,0 +1,152 @@
+/**
+ * @file
+ * Packed per-Email view data
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page core_hot Packed per-Email view data
+ *
+ * The index, limit and tagging code repeatedly scan every Email in a Mailbox,
+ * but only look at a few flags, numbers and dates.  MailboxHot keeps a copy of
+ * those fields in arrays parallel to Mailbox.emails.
+ *
+ * The copies are refreshed:
+ * - whenever the Mailbox is renumbered, e.g. mview_update(), mutt_set_vnum()
+ * - whenever a flag is changed by mutt_set_flag()
+ * - whenever an Email is rescored
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "hot.h"
+
+/**
+ * hot_alloc - Resize the hot arrays
+ * @param hot     Hot data
+ * @param old_max Current number of slots
+ * @param new_max New number of slots
+ *
+ * New slots are cleared.
+ */
+void hot_alloc(struct MailboxHot *hot, int old_max, int new_max)
+{
+  if (!hot || (new_max <= 0))
+    return;
+
+  hot->flags = g_realloc(hot->flags, new_max * sizeof(EmailHotFlags));
+  hot->vnum = g_realloc(hot->vnum, new_max * sizeof(int));
+  hot->score = g_realloc(hot->score, new_max * sizeof(int));
+  hot->date_sent = g_realloc(hot->date_sent, new_max * sizeof(time_t));
+  hot->received = g_realloc(hot->received, new_max * sizeof(time_t));
+  hot->size = g_realloc(hot->size, new_max * sizeof(LOFF_T));
+  hot->hdr_size = g_realloc(hot->hdr_size, new_max * sizeof(int));
+
+  for (int i = MAX(old_max, 0); i < new_max; i++)
+  {
+    hot->flags[i] = EMAIL_HOT_NO_FLAGS;
+    hot->vnum[i] = -1;
+    hot->score[i] = 0;
+    hot->date_sent[i] = 0;
+    hot->received[i] = 0;
+    hot->size[i] = 0;
+    hot->hdr_size[i] = 0;
+  }
+}
+
+/**
+ * hot_free - Free the hot arrays
+ * @param hot Hot data
+ */
+void hot_free(struct MailboxHot *hot)
+{
+  if (!hot)
+    return;
+
+  FREE(&hot->flags);
+  FREE(&hot->vnum);
+  FREE(&hot->score);
+  FREE(&hot->date_sent);
+  FREE(&hot->received);
+  FREE(&hot->size);
+  FREE(&hot->hdr_size);
+}
+
+/**
+ * hot_set - Copy an Email's hot fields into a slot
+ * @param hot Hot data
+ * @param idx Slot, the Email's position in Mailbox.emails
+ * @param e   Email, NULL to clear the slot
+ */
+void hot_set(struct MailboxHot *hot, int idx, const struct Email *e)
+{
+  if (!hot || !hot->flags || (idx < 0))
+    return;
+
+  if (!e)
+  {
+    hot->flags[idx] = EMAIL_HOT_NO_FLAGS;
+    hot->vnum[idx] = -1;
+    return;
+  }
+
+  EmailHotFlags flags = EMAIL_HOT_NO_FLAGS;
+  if (e->read)
+    flags |= EMAIL_HOT_READ;
+  if (e->old)
+    flags |= EMAIL_HOT_OLD;
+  if (e->flagged)
+    flags |= EMAIL_HOT_FLAGGED;
+  if (e->replied)
+    flags |= EMAIL_HOT_REPLIED;
+  if (e->deleted)
+    flags |= EMAIL_HOT_DELETED;
+  if (e->purge)
+    flags |= EMAIL_HOT_PURGE;
+  if (e->tagged)
+    flags |= EMAIL_HOT_TAGGED;
+  if (e->changed)
+    flags |= EMAIL_HOT_CHANGED;
+  if (e->expired)
+    flags |= EMAIL_HOT_EXPIRED;
+  if (e->superseded)
+    flags |= EMAIL_HOT_SUPERSEDED;
+  if (e->visible)
+    flags |= EMAIL_HOT_VISIBLE;
+  if (e->collapsed)
+    flags |= EMAIL_HOT_COLLAPSED;
+
+  hot->flags[idx] = flags;
+  hot->vnum[idx] = e->vnum;
+  hot->score[idx] = e->score;
+  hot->date_sent[idx] = e->date_sent;
+  hot->received[idx] = e->received;
+  if (e->body)
+  {
+    hot->size[idx] = e->body->length;
+    hot->hdr_size[idx] = (int) (e->body->offset - e->body->hdr_offset);
+  }
+  else
+  {
+    hot->size[idx] = 0;
+    hot->hdr_size[idx] = 0;
+  }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file
+ * Packed per-Email view data
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CORE_HOT_H
+#define MUTT_CORE_HOT_H
+
+#include "config.h"
+#include <stdint.h>
+#include <time.h>
+
+struct Email;
+
+typedef uint16_t EmailHotFlags;          ///< Flags for MailboxHot.flags, e.g. #EMAIL_HOT_READ
+#define EMAIL_HOT_NO_FLAGS           0   ///< No flags are set
+#define EMAIL_HOT_READ         (1 << 0)  ///< Email.read
+#define EMAIL_HOT_OLD          (1 << 1)  ///< Email.old
+#define EMAIL_HOT_FLAGGED      (1 << 2)  ///< Email.flagged
+#define EMAIL_HOT_REPLIED      (1 << 3)  ///< Email.replied
+#define EMAIL_HOT_DELETED      (1 << 4)  ///< Email.deleted
+#define EMAIL_HOT_PURGE        (1 << 5)  ///< Email.purge
+#define EMAIL_HOT_TAGGED       (1 << 6)  ///< Email.tagged
+#define EMAIL_HOT_CHANGED      (1 << 7)  ///< Email.changed
+#define EMAIL_HOT_EXPIRED      (1 << 8)  ///< Email.expired
+#define EMAIL_HOT_SUPERSEDED   (1 << 9)  ///< Email.superseded
+#define EMAIL_HOT_VISIBLE      (1 << 10) ///< Email.visible
+#define EMAIL_HOT_COLLAPSED    (1 << 11) ///< Email.collapsed
+
+/**
+ * struct MailboxHot - Packed copies of the Emails' hot fields
+ *
+ * Each array runs parallel to Mailbox.emails.  The Email is authoritative;
+ * these copies let loops over the whole Mailbox scan contiguous memory
+ * instead of chasing a pointer per message.
+ */
+struct MailboxHot
+{
+  EmailHotFlags *flags;  ///< Flags, e.g. #EMAIL_HOT_READ
+  int *vnum;             ///< Email.vnum
+  int *score;            ///< Email.score
+  time_t *date_sent;     ///< Email.date_sent
+  time_t *received;      ///< Email.received
+  LOFF_T *size;          ///< Size of the body, Body.length
+  int *hdr_size;         ///< Size of the header, Body.offset - Body.hdr_offset
+};
+
+void hot_alloc(struct MailboxHot *hot, int old_max, int new_max);
+void hot_free (struct MailboxHot *hot);
+void hot_set  (struct MailboxHot *hot, int idx, const struct Email *e);
+
+#endif /* MUTT_CORE_HOT_H */
@@ -35,6 +35,9 @@
 #include "mailbox.h"
 #include "spacemutt.h"
 
+/// Size of the chunks of a Mailbox's Arena
+#define MAILBOX_ARENA_SIZE (256 * 1024)
+
 /// Lookups for Mailbox types
 static const struct Mapping MailboxTypes[] = {
   // clang-format off
@@ -75,6 +78,7 @@ struct Mailbox *mailbox_new(void)
   m->email_max = 25;
   m->emails = g_malloc0_n(m->email_max, sizeof(struct Email *));
   m->v2r = g_malloc0_n(m->email_max, sizeof(int));
+  hot_alloc(&m->hot, 0, m->email_max);
   m->gen = mailbox_gen();
   m->notify_user = true;
   m->poll_new_mail = true;
@@ -82,6 +86,44 @@ struct Mailbox *mailbox_new(void)
   return m;
 }
 
+/**
+ * mailbox_arena - Get the Arena for a Mailbox's Emails
+ * @param m Mailbox
+ * @retval ptr Arena, created if necessary
+ *
+ * Emails allocated from here are released together, once the Mailbox has been
+ * closed and the last of them has been freed.
+ */
+struct Arena *mailbox_arena(struct Mailbox *m)
+{
+  if (!m)
+    return NULL;
+
+  if (!m->arena)
+    m->arena = arena_new(MAILBOX_ARENA_SIZE);
+
+  return m->arena;
+}
+
+/**
+ * mailbox_hot_update - Refresh the packed view data of an Email
+ * @param m Mailbox
+ * @param e Email that has changed
+ *
+ * This is a no-op if the Email isn't at position Email.msgno, e.g. the Mailbox
+ * is still being read.  The next renumbering will catch up.
+ */
+void mailbox_hot_update(struct Mailbox *m, const struct Email *e)
+{
+  if (!m || !e || !m->emails)
+    return;
+
+  if ((e->msgno < 0) || (e->msgno >= m->email_max) || (m->emails[e->msgno] != e))
+    return;
+
+  hot_set(&m->hot, e->msgno, e);
+}
+
 /**
  * mailbox_free - Free a Mailbox
  * @param[out] ptr Mailbox to free
@@ -115,6 +157,7 @@ void mailbox_free(struct Mailbox **ptr)
 
   for (size_t i = 0; i < m->email_max; i++)
     email_free(&m->emails[i]);
+  arena_release(&m->arena);
 
   m->email_max = 0;
   m->msg_count = 0;
@@ -132,6 +175,7 @@ void mailbox_free(struct Mailbox **ptr)
   FREE(&m->name);
   FREE(&m->realpath);
   FREE(&m->emails);
+  hot_free(&m->hot);
   FREE(&m->v2r);
   notify_free(&m->notify);
   mailbox_gc_run();
@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <time.h>
 #include "mutt/lib.h"
+#include "hot.h"
 
 struct ConfigSubset;
 struct Email;
@@ -95,7 +96,9 @@ struct Mailbox
 
   struct Email **emails;              ///< Array of Emails
   int email_max;                      ///< Size of `emails` array
+  struct Arena *arena;                ///< Memory for the Emails, see mailbox_arena()
   int *v2r;                           ///< Mapping from virtual to real msgno
+  struct MailboxHot hot;              ///< Packed copies of the Emails' view data
   int vcount;                         ///< The number of virtual messages
 
   bool notified;                      ///< User has been notified
@@ -110,6 +113,8 @@ struct Mailbox
   bool changed                : 1;    ///< Mailbox has been modified
   bool dontwrite              : 1;    ///< Don't write the mailbox on close
   bool first_check_stats_done : 1;    ///< True when the check have been done at least one time
+  bool hcache_gc_done         : 1;    ///< Stale header cache entries were looked for, see mx_hcache_idle()
+  bool hcache_pending         : 1;    ///< Some Emails need saving to the header cache
   bool notify_user            : 1;    ///< Notify the user of new mail
   bool peekonly               : 1;    ///< Just taking a glance, revert atime
   bool poll_new_mail          : 1;    ///< Check for new mail
@@ -192,11 +197,13 @@ struct EventMailbox
   struct Mailbox *mailbox; ///< The Mailbox this Event relates to
 };
 
+struct Arena   *mailbox_arena     (struct Mailbox *m);
 void            mailbox_changed   (struct Mailbox *m, enum NotifyMailbox action);
 struct Mailbox *mailbox_find      (const char *path);
 struct Mailbox *mailbox_find_name (const char *name);
 void            mailbox_free      (struct Mailbox **ptr);
 int             mailbox_gen       (void);
+void            mailbox_hot_update(struct Mailbox *m, const struct Email *e);
 struct Mailbox *mailbox_new       (void);
 bool            mailbox_set_subset(struct Mailbox *m, struct ConfigSubset *sub);
 void            mailbox_size_add  (struct Mailbox *m, const struct Email *e);
@@ -288,6 +288,20 @@ struct MxOps
    */
   int (*msg_save_hcache)(struct Mailbox *m, struct Email *e);
 
+  /**
+   * @defgroup mx_mbox_hcache_gc mbox_hcache_gc()
+   * @ingroup mx_api
+   *
+   * mbox_hcache_gc - Remove stale entries from the header cache
+   * @param m     Mailbox
+   * @param force Ignore $header_cache_gc_interval
+   * @retval num Number of entries removed
+   * @retval -1  Failure, or the header cache isn't in use
+   *
+   * @pre m is not NULL
+   */
+  int (*mbox_hcache_gc)(struct Mailbox *m, bool force);
+
   /**
    * @defgroup mx_tags_edit tags_edit()
    * @ingroup mx_api
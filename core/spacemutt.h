@@ -61,6 +61,7 @@ enum NotifyGlobal
   NT_GLOBAL_STARTUP = 1, ///< SpaceMutt is initialised
   NT_GLOBAL_SHUTDOWN,    ///< SpaceMutt is about to close
   NT_GLOBAL_COMMAND,     ///< A SpaceMutt command
+  NT_GLOBAL_CHILD,       ///< A child process has exited
 };
 
 bool            spacemutt_account_add   (struct SpaceMutt *n, struct Account *a);
@@ -158,6 +158,7 @@ const char *name_menu_type(enum MenuType mt)
     DEBUG_NAME(MENU_KEY_SELECT_SMIME);
 #endif
     DEBUG_NAME(MENU_INDEX);
+    DEBUG_NAME(MENU_OUTBOX);
     DEBUG_NAME(MENU_PAGER);
     DEBUG_NAME(MENU_PGP);
     DEBUG_NAME(MENU_POSTPONED);
@@ -172,6 +173,7 @@ const char *name_notify_global(int id)
 {
   switch (id)
   {
+    DEBUG_NAME(NT_GLOBAL_CHILD);
     DEBUG_NAME(NT_GLOBAL_COMMAND);
     DEBUG_NAME(NT_GLOBAL_SHUTDOWN);
     DEBUG_NAME(NT_GLOBAL_STARTUP);
@@ -236,6 +238,7 @@ const char *name_window_type(const struct MuttWindow *win)
     DEBUG_NAME(WT_DLG_GPGME);
     DEBUG_NAME(WT_DLG_HISTORY);
     DEBUG_NAME(WT_DLG_INDEX);
+    DEBUG_NAME(WT_DLG_OUTBOX);
     DEBUG_NAME(WT_DLG_PAGER);
     DEBUG_NAME(WT_DLG_PATTERN);
     DEBUG_NAME(WT_DLG_PGP);
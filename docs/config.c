@@ -1633,7 +1633,10 @@
 ** .pp
 ** This variable specifies the header cache backend.  If no backend is
 ** specified, the first available backend will be used in the following order:
-** tokyocabinet, kyotocabinet, qdbm, rocksdb, gdbm, bdb, tdb, lmdb.
+** tokyocabinet, kyotocabinet, qdbm, rocksdb, gdbm, bdb, tdb, lmdb, logdb.
+** .pp
+** \fIlogdb\fP is built in and needs no library.  It's an append-only log with
+** a memory-mapped index, suited to a cache that's loaded once and read often.
 */
 
 #ifdef USE_HCACHE_COMPRESSION
@@ -1650,8 +1653,27 @@
 ** When NeoMutt is compiled with lz4, zstd or zlib, the header cache backend
 ** can use these compression methods for compressing the cache files.
 ** This results in much smaller cache file sizes and may even improve speed.
+** .pp
+** With zstd, NeoMutt trains a dictionary from the first headers it caches
+** for each mailbox and stores it in the cache.  Headers compressed with it
+** are several times smaller again.
 */
 #endif
+
+{ "header_cache_gc_interval", DT_NUMBER, 7 },
+/*
+** .pp
+** The header cache keeps an entry for every message it has seen, even after
+** the message has been deleted or moved.  While a mailbox is open and you're
+** idle, SpaceMutt removes the entries for messages that are no longer in it,
+** then compacts the cache file, if the backend supports it.
+** .pp
+** This variable sets the minimum number of days between two of these clean
+** ups of the same mailbox.  If it's 0, the cache is only cleaned up by the
+** "$hcache-gc" command.
+** .pp
+** The clean up applies to IMAP, POP, Maildir and MH mailboxes.
+*/
 #endif
 
 { "header_color_partial", DT_BOOL, false },
@@ -2865,6 +2887,18 @@
 ** articles headers will be saved in cache when you quit newsgroup.
 */
 
+#ifdef USE_ZLIB
+{ "nntp_compress", DT_BOOL, true },
+/*
+** .pp
+** When \fIset\fP, NeoMutt will use the COMPRESS DEFLATE extension (RFC8054)
+** if advertised by the news server.
+** .pp
+** Overview data compresses well, so this speeds up entering large
+** newsgroups.
+*/
+#endif
+
 { "nntp_listgroup", DT_BOOL, true },
 /*
 ** .pp
@@ -2903,6 +2937,43 @@
 ** connect to news server.
 */
 
+{ "outbox", DT_PATH, 0 },
+/*
+** .pp
+** If this is set to a directory, messages are queued there instead of being
+** sent immediately.  SpaceMutt sends them in the background, so the next
+** message can be written while the server is slow or unreachable.
+** .pp
+** A message that can't be sent is retried, see $$outbox_retry_delay and
+** $$outbox_retry_max.  The queue survives restarts.  Use \fC<outbox>\fP to
+** see the queued messages, send one immediately, or cancel one.  A cancelled
+** message is moved to $$postponed.
+** .pp
+** The copy in $$record is saved once the message has been sent, exactly as it
+** was sent.  If $$fcc_before_send is set, or the copy would be changed by
+** $$fcc_clear or $$fcc_attach, it's saved when the message is queued instead.
+** .pp
+** The background process can't ask anything.  If $$smtp_url is set, SpaceMutt
+** logs in before the first message is sent, asking for a password if needed.
+** .pp
+** The directory must exist and should only be readable by you.
+*/
+
+{ "outbox_retry_delay", DT_NUMBER, 60 },
+/*
+** .pp
+** The number of seconds to wait before retrying a message in the $$outbox
+** that couldn't be sent.  The delay doubles after each failure, up to an hour.
+*/
+
+{ "outbox_retry_max", DT_NUMBER, 10 },
+/*
+** .pp
+** The number of attempts to send a message in the $$outbox before giving up.
+** A message that has failed stays in the queue until it is retried or
+** cancelled.  If set to 0, SpaceMutt never gives up.
+*/
+
 { "pager", D_STRING_COMMAND, "" },
 /*
 ** .pp
@@ -5075,6 +5146,24 @@
 #endif
 
 #ifdef USE_SSL
+{ "ssl_session_file", DT_PATH, 0 },
+/*
+** .pp
+** NeoMutt remembers the TLS sessions it has negotiated and offers them when it
+** reconnects to the same server, which avoids a full handshake.  This variable
+** specifies a file where these sessions are saved, so that they can also be
+** resumed by the next NeoMutt.  If unset (the default), the sessions are only
+** kept in memory.
+** .pp
+** The file is written when NeoMutt exits.  A session is only saved if the
+** server's certificate passed verification without your help; if you accepted
+** it at the prompt, the session is only kept in memory.
+** .pp
+** The file is created with mode 0600.  Anyone who can read it could decrypt
+** traffic that was protected by the saved sessions, so keep it private, e.g.
+** next to your $$certificate_file.
+*/
+
 { "ssl_starttls", DT_QUAD, MUTT_YES },
 /*
 ** .pp
@@ -5437,6 +5526,23 @@
 ** command will only filter out quote levels above this number.
 */
 
+{ "trace_file", DT_PATH, 0 },
+/*
+** .pp
+** If set, NeoMutt records how long its expensive operations take, e.g.
+** opening, checking and syncing mailboxes, header cache lookups, IMAP
+** commands, sorting, threading and redrawing menus.
+** .pp
+** When NeoMutt exits, the trace is saved to this file in the Chrome
+** trace-event format.  It can be viewed in \fCchrome://tracing\fP or
+** \fChttps://ui.perfetto.dev\fP.  The file also contains a histogram of the
+** durations of each operation.
+** .pp
+** The trace can be saved at any time using the \fCtrace-dump\fP command.
+** .pp
+** Unsetting this variable stops the recording.
+*/
+
 { "trash", D_STRING_MAILBOX, 0 },
 /*
 ** .pp
@@ -44,7 +44,21 @@
  */
 struct Body *mutt_body_new(void)
 {
-  struct Body *p = g_new0(struct Body, 1);
+  return mutt_body_new_arena(NULL);
+}
+
+/**
+ * mutt_body_new_arena - Create a new Body in an Arena
+ * @param arena Arena to allocate from, may be NULL
+ * @retval ptr Newly allocated Body
+ *
+ * The Body is freed by mutt_body_free(), as usual, but its memory is only
+ * released when the Arena is.
+ */
+struct Body *mutt_body_new_arena(struct Arena *arena)
+{
+  struct Body *p = arena ? arena_alloc(arena, sizeof(struct Body)) : g_new0(struct Body, 1);
+  p->arena = arena_ref(arena);
 
   p->disposition = DISP_ATTACH;
   p->use_disp = true;
@@ -96,7 +110,12 @@ void mutt_body_free(struct Body **ptr)
 
     mutt_env_free(&b->mime_headers);
     mutt_body_free(&b->parts);
-    FREE(&b);
+
+    /* The memory is released with the Mailbox's arena */
+    if (b->arena)
+      arena_release(&b->arena);
+    else
+      FREE(&b);
   }
 
   *ptr = NULL;
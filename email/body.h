@@ -72,6 +72,7 @@ struct Body
   struct Body *next;              ///< next attachment in the list
   struct Body *parts;             ///< parts of a multipart or message/rfc822
   struct Email *email;            ///< header information for message/rfc822
+  struct Arena *arena;            ///< Memory of the Body, see mutt_body_new_arena()
   struct AttachPtr *aptr;         ///< Menu information, used in recvattach.c
   struct Envelope *mime_headers;  ///< Memory hole protected headers
   time_t stamp;                   ///< Time stamp of last encoding update
@@ -119,5 +120,6 @@ bool         mutt_body_cmp_strict(const struct Body *b1, const struct Body *b2);
 void         mutt_body_free      (struct Body **ptr);
 char *       mutt_body_get_charset(struct Body *b, char *buf, size_t buflen);
 struct Body *mutt_body_new       (void);
+struct Body *mutt_body_new_arena (struct Arena *arena);
 
 #endif /* MUTT_EMAIL_BODY_H */
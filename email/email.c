@@ -35,6 +35,7 @@
 #include "email.h"
 #include "body.h"
 #include "envelope.h"
+#include "summary.h"
 #include "tags.h"
 
 void nm_edata_free(void **ptr);
@@ -59,6 +60,7 @@ void email_free(struct Email **ptr)
 
   mutt_env_free(&e->env);
   mutt_body_free(&e->body);
+  part_summary_free(&e->mime_summary);
   FREE(&e->tree);
   FREE(&e->path);
 #ifdef USE_NOTMUCH
@@ -67,6 +69,14 @@ void email_free(struct Email **ptr)
   driver_tags_free(e->tags);
   notify_free(&e->notify);
 
+  /* The memory is released with the Mailbox's arena */
+  if (e->arena)
+  {
+    arena_release(&e->arena);
+    *ptr = NULL;
+    return;
+  }
+
   FREE(ptr);
 }
 
@@ -75,10 +85,24 @@ void email_free(struct Email **ptr)
  * @retval ptr Newly created Email
  */
 struct Email *email_new(void)
+{
+  return email_new_arena(NULL);
+}
+
+/**
+ * email_new_arena - Create a new Email in an Arena
+ * @param arena Arena to allocate from, may be NULL
+ * @retval ptr Newly created Email
+ *
+ * The Email is freed by email_free(), as usual, but its memory is only
+ * released when the Arena is.
+ */
+struct Email *email_new_arena(struct Arena *arena)
 {
   static size_t sequence = 0;
 
-  struct Email *e = g_new0(struct Email, 1);
+  struct Email *e = arena ? arena_alloc(arena, sizeof(struct Email)) : g_new0(struct Email, 1);
+  e->arena = arena_ref(arena);
   e->tags = NULL;
   e->visible = true;
   e->sequence = sequence++;
@@ -27,12 +27,15 @@
 
 #include "config.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 #include <glib.h>
 #include "mutt/lib.h"
 #include "ncrypt/lib.h"
 #include "tags.h"
 
+struct PartSummaryArray;
+
 /**
  * struct Email - The envelope/body of an email
  */
@@ -61,6 +64,10 @@ struct Email
   time_t date_sent;            ///< Time when the message was sent (UTC)
   time_t received;             ///< Time when the message was placed in the mailbox
   int lines;                   ///< How many lines in the body of this message?
+  struct PartSummaryArray *mime_summary; ///< Summary of the MIME parts, see part_summary_new()
+  uint32_t attach_rules;       ///< Attachment rules that attach_total was counted with
+  uint32_t score_rules;        ///< Score rules that score was calculated with, 0 if unknown
+  uint32_t score_inputs;       ///< Hash of the fields the score rules depend on
 
   // ---------------------------------------------------------------------------
   // Management data - Runtime info and glue to hold the objects together
@@ -73,6 +80,7 @@ struct Email
   TagList *tags;               ///< For drivers that support server tagging
   struct Notify *notify;       ///< Notifications: #NotifyEmail, #EventEmail
   void *edata;                 ///< Driver-specific data
+  struct Arena *arena;         ///< Memory of the Email, see email_new_arena()
 
   bool active          : 1;    ///< Message is not to be removed
   bool changed         : 1;    ///< Email has been edited
@@ -100,6 +108,7 @@ struct Email
   bool attach_del      : 1;    ///< Has an attachment marked for deletion
   bool attach_valid    : 1;    ///< true when the attachment count is valid
   bool display_subject : 1;    ///< Used for threading
+  bool hcache_pending  : 1;    ///< Needs saving to the header cache, see mx_hcache_flush()
   bool matched         : 1;    ///< Search matches this Email
   bool quasi_deleted   : 1;    ///< Deleted from neomutt, but not modified on disk
   bool recip_valid     : 1;    ///< Is_recipient is valid
@@ -213,6 +222,7 @@ struct EventHeader
 bool          email_cmp_strict(const struct Email *e1, const struct Email *e2);
 void          email_free      (struct Email **ptr);
 struct Email *email_new       (void);
+struct Email *email_new_arena (struct Arena *arena);
 size_t        email_size      (const struct Email *e);
 
 GList *header_add   (GQueue *hdrlist, const char *header);
@@ -38,6 +38,8 @@
 #include "core/lib.h"
 #include "envelope.h"
 #include "email.h"
+#include "parse.h"
+#include "rfc2047.h"
 #include "mutt/gqueue.h"
 
 
@@ -47,7 +49,22 @@
  */
 struct Envelope *mutt_env_new(void)
 {
-  struct Envelope *env = g_new0(struct Envelope, 1);
+  return mutt_env_new_arena(NULL);
+}
+
+/**
+ * mutt_env_new_arena - Create a new Envelope in an Arena
+ * @param arena Arena to allocate from, may be NULL
+ * @retval ptr New Envelope
+ *
+ * The Envelope is freed by mutt_env_free(), as usual, but its memory is only
+ * released when the Arena is.  Its fields are allocated normally.
+ */
+struct Envelope *mutt_env_new_arena(struct Arena *arena)
+{
+  struct Envelope *env = arena ? arena_alloc(arena, sizeof(struct Envelope)) :
+                                 g_new0(struct Envelope, 1);
+  env->arena = arena_ref(arena);
   env->return_path = mutt_addrlist_new();
   env->from = mutt_addrlist_new();
   env->to = mutt_addrlist_new();
@@ -163,15 +180,67 @@ void mutt_env_free(struct Envelope **ptr)
   g_queue_free_full(env->references, g_free);
   g_queue_free_full(env->in_reply_to, g_free);
   g_queue_free_full(env->userhdrs, g_free);
+  FREE(&env->lazy);
 
 #ifdef USE_AUTOCRYPT
   mutt_autocrypthdr_free(&env->autocrypt);
   mutt_autocrypthdr_free(&env->autocrypt_gossip);
 #endif
 
+  /* The memory is released with the Mailbox's arena */
+  if (env->arena)
+  {
+    arena_release(&env->arena);
+    *ptr = NULL;
+    return;
+  }
+
   FREE(ptr);
 }
 
+/**
+ * mutt_env_materialize - Parse the header fields that were deferred
+ * @param env Envelope
+ *
+ * When a mailbox is opened, header fields that aren't needed by the index,
+ * e.g. Mail-Followup-To, are kept unparsed in Envelope.lazy.
+ * See mutt_rfc822_read_header_lazy().
+ *
+ * This parses and decodes them.  It must be called before reading any of
+ * those fields.  It's cheap if there's nothing to do.
+ *
+ * A deferred List-Post is handled like an eager one: if $auto_subscribe is
+ * set now, the list is subscribed to.
+ */
+void mutt_env_materialize(struct Envelope *env)
+{
+  if (!env || !env->lazy)
+    return;
+
+  char *raw = env->lazy;
+  env->lazy = NULL;
+
+  for (char *line = raw; line && (*line != '\0');)
+  {
+    char *nl = strchr(line, '\n');
+    if (nl)
+      *nl = '\0';
+
+    char *colon = strchr(line, ':');
+    if (colon)
+    {
+      *colon = '\0';
+      mutt_rfc822_parse_line(env, NULL, line, colon - line,
+                             mutt_str_skip_email_wsp(colon + 1), false, false, false);
+    }
+
+    line = nl ? nl + 1 : NULL;
+  }
+  FREE(&raw);
+
+  rfc2047_decode_addrlist(env->mail_followup_to);
+}
+
 /**
  * mutt_env_notify_send - Send an Envelope change notification
  * @param e Email
@@ -197,6 +266,9 @@ void mutt_env_merge(struct Envelope *base, struct Envelope **extra)
   if (!base || !extra || !*extra)
     return;
 
+  mutt_env_materialize(base);
+  mutt_env_materialize(*extra);
+
 /* copies each existing element if necessary, and sets the element
  * to NULL in the source so that mutt_env_free doesn't leave us
  * with dangling pointers. */
@@ -295,7 +367,8 @@ bool mutt_env_cmp_strict(const struct Envelope *e1, const struct Envelope *e2)
         !mutt_addrlist_equal(e1->sender, e2->sender) ||
         !mutt_addrlist_equal(e1->reply_to, e2->reply_to) ||
         !mutt_addrlist_equal(e1->to, e2->to) || !mutt_addrlist_equal(e1->cc, e2->cc) ||
-        !mutt_addrlist_equal(e1->return_path, e2->return_path))
+        !mutt_addrlist_equal(e1->return_path, e2->return_path) ||
+        !mutt_str_equal(e1->lazy, e2->lazy))
     {
       return false;
     }
@@ -321,6 +394,7 @@ void mutt_env_to_local(struct Envelope *env)
   if (!env)
     return;
 
+  mutt_env_materialize(env);
   mutt_addrlist_to_local(env->return_path);
   mutt_addrlist_to_local(env->from);
   mutt_addrlist_to_local(env->to);
@@ -359,6 +433,8 @@ int mutt_env_to_intl(struct Envelope *env, const char **tag, char **err)
   if (!env)
     return 1;
 
+  mutt_env_materialize(env);
+
   int rc = 0;
   H_TO_INTL(return_path);
   H_TO_INTL(from);
@@ -84,11 +84,13 @@ struct Envelope
   GQueue *references;                  ///< message references (in reverse order)
   GQueue *in_reply_to;                 ///< in-reply-to header content
   GQueue *userhdrs;                    ///< user defined headers
+  char *lazy;                          ///< Unparsed header fields, see mutt_env_materialize()
 #ifdef USE_AUTOCRYPT
   struct AutocryptHeader *autocrypt;        ///< Autocrypt header
   struct AutocryptHeader *autocrypt_gossip; ///< Autocrypt Gossip header
 #endif
   unsigned char changed; ///< Changed fields, e.g. #MUTT_ENV_CHANGED_SUBJECT
+  struct Arena *arena;   ///< Memory of the Envelope, see mutt_env_new_arena()
 };
 
 /**
@@ -149,8 +151,10 @@ enum NotifyEnvelope
 
 bool             mutt_env_cmp_strict (const struct Envelope *e1, const struct Envelope *e2);
 void             mutt_env_free       (struct Envelope **ptr);
+void             mutt_env_materialize(struct Envelope *env);
 void             mutt_env_merge      (struct Envelope *base, struct Envelope **extra);
 struct Envelope *mutt_env_new        (void);
+struct Envelope *mutt_env_new_arena  (struct Arena *arena);
 bool             mutt_env_notify_send(struct Email *e, enum NotifyEnvelope type);
 void             mutt_env_set_subject(struct Envelope *env, const char *subj);
 int              mutt_env_to_intl    (struct Envelope *env, const char **tag, char **err);
@@ -37,6 +37,7 @@
  * | email/parse.c          | @subpage email_parse     |
  * | email/rfc2047.c        | @subpage email_rfc2047   |
  * | email/rfc2231.c        | @subpage email_rfc2231   |
+ * | email/summary.c        | @subpage email_summary   |
  * | email/tags.c           | @subpage email_tags      |
  * | email/thread.c         | @subpage email_thread    |
  * | email/url.c            | @subpage email_url       |
@@ -59,6 +60,7 @@
 #include "parse.h"
 #include "rfc2047.h"
 #include "rfc2231.h"
+#include "summary.h"
 #include "tags.h"
 #include "thread.h"
 #include "url.h"
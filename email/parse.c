@@ -63,6 +63,9 @@
  * Cap the value to prevent overflow of Body.length */
 #define CONTENT_TOO_BIG (1 << 30)
 
+/// Amount of a file to read at once when parsing a header
+#define HEADER_BLOCK_SIZE 8192
+
 static void parse_part(FILE *fp, struct Body *b, int *counter);
 static struct Body *rfc822_parse_message(FILE *fp, struct Body *parent, int *counter);
 static struct Body *parse_multipart(FILE *fp, const char *boundary,
@@ -1192,169 +1195,432 @@ size_t mutt_rfc822_read_line(FILE *fp, struct Buffer *buf)
 }
 
 /**
- * mutt_rfc822_read_header - Parses an RFC822 header
- * @param fp        Stream to read from
- * @param e         Current Email (optional)
- * @param user_hdrs If set, store user headers
- *                  Used for recall-message and postpone modes
- * @param weed      If this parameter is set and the user has activated the
- *                  $weed option, honor the header weed list for user headers.
- *                  Used for recall-message
- * @retval ptr Newly allocated envelope structure
+ * mutt_rfc822_next_field - Find the next header field in a block of memory
+ * @param[in]     buf Header data, must be writable and have room for a NUL at buf[len]
+ * @param[in]     len Length of the data
+ * @param[in,out] pos Offset of the next field, updated past the field
+ * @param[in]     eof true if buf holds all the remaining data
+ * @param[out]    hf  Field that was found
+ * @retval #HDR_FIELD A field was found
+ * @retval #HDR_END   The end of the header was reached
+ * @retval #HDR_MORE  More data is needed to finish the field (only if !eof)
  *
- * Caller should free the Envelope using mutt_env_free().
+ * The field's continuation lines are found with memchr() and unfolded in
+ * place.  The unfolded field is never longer than the original, so it's
+ * NUL-terminated inside buf and handed back as slices, without copying.
+ *
+ * A line without a colon (e.g. a From_ line, or the start of a body that has
+ * no blank line) is returned as-is, with hf->name_len set to 0.  It is not
+ * NUL-terminated and buf isn't changed, so the caller can treat it as the
+ * start of the body.
+ *
+ * Nothing is changed if #HDR_MORE is returned.  The caller can move the
+ * unparsed data, add more and try again.
  */
-struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hdrs, bool weed)
+enum HeaderToken mutt_rfc822_next_field(char *buf, size_t len, size_t *pos,
+                                        bool eof, struct HeaderField *hf)
 {
-  if (!fp)
-    return NULL;
+  if (!buf || !pos || !hf)
+    return HDR_END;
 
-  struct Envelope *env = mutt_env_new();
-  char *p = NULL;
-  LOFF_T loc = e ? e->offset : ftello(fp);
-  if (loc < 0)
+  if (*pos >= len)
+    return eof ? HDR_END : HDR_MORE;
+
+  char *start = buf + *pos;
+  char *end = buf + len;
+
+  /* The first physical line */
+  char *nl = memchr(start, '\n', end - start);
+  if (!nl && !eof)
+    return HDR_MORE;
+
+  char *eol = nl ? nl : end;
+  char *next = nl ? nl + 1 : end;
+
+  /* A blank line, or a stray continuation line, ends the header */
+  if ((eol == start) || mutt_str_is_email_wsp(start[0]))
   {
-    log_debug1("ftello: %s (errno %d)", strerror(errno), errno);
-    loc = 0;
+    *pos = next - buf;
+    return HDR_END;
   }
 
-  struct Buffer *line = buf_pool_get();
+  memset(hf, 0, sizeof(*hf));
+
+  char *colon = start;
+  while ((colon < eol) && (*colon != ':') && (*colon != ' ') && (*colon != '\t'))
+    colon++;
 
-  if (e)
+  if ((colon == eol) || (*colon != ':'))
   {
-    if (!e->body)
-    {
-      e->body = mutt_body_new();
+    hf->line = start;
+    hf->len = eol - start;
+    *pos = next - buf;
+    return HDR_FIELD;
+  }
+
+  /* Find the end of the field before changing anything */
+  char *field_end = next;
+  while ((field_end < end) && ((*field_end == ' ') || (*field_end == '\t')))
+  {
+    nl = memchr(field_end, '\n', end - field_end);
+    if (!nl && !eof)
+      return HDR_MORE;
+    field_end = nl ? nl + 1 : end;
+  }
 
-      /* set the defaults from RFC1521 */
-      e->body->type = TYPE_TEXT;
-      e->body->subtype = mutt_str_dup("plain");
-      e->body->encoding = ENC_7BIT;
-      e->body->length = -1;
+  /* We can't tell if the next line is a continuation */
+  if ((field_end == end) && !eof)
+    return HDR_MORE;
 
-      /* RFC2183 says this is arbitrary */
-      e->body->disposition = DISP_INLINE;
-    }
+  /* Unfold: trim the trailing space from each line, join the lines with a
+   * single space and drop the continuation's leading space */
+  char *w = eol;
+  while ((w > start) && mutt_str_is_email_wsp(w[-1]))
+    w--;
+
+  for (char *line = next; line < field_end;)
+  {
+    while ((*line == ' ') || (*line == '\t'))
+      line++;
+
+    nl = memchr(line, '\n', field_end - line);
+    char *line_end = nl ? nl : field_end;
+
+    *w++ = ' ';
+    const size_t line_len = line_end - line;
+    memmove(w, line, line_len);
+    w += line_len;
+    while ((w > start) && mutt_str_is_email_wsp(w[-1]))
+      w--;
+
+    line = nl ? nl + 1 : field_end;
   }
+  *w = '\0';
 
-  while (true)
+  hf->line = start;
+  hf->len = w - start;
+  hf->name_len = colon - start;
+  hf->value = mutt_str_skip_email_wsp(colon + 1);
+  hf->value_len = w - hf->value;
+
+  *pos = field_end - buf;
+  return HDR_FIELD;
+}
+
+/**
+ * rfc822_header_init - Prepare an Email for its header to be parsed
+ * @param e     Email (optional)
+ * @param arena Arena to allocate the Body from (optional)
+ */
+static void rfc822_header_init(struct Email *e, struct Arena *arena)
+{
+  if (!e || e->body)
+    return;
+
+  e->body = mutt_body_new_arena(arena);
+
+  /* set the defaults from RFC1521 */
+  e->body->type = TYPE_TEXT;
+  e->body->subtype = mutt_str_dup("plain");
+  e->body->encoding = ENC_7BIT;
+  e->body->length = -1;
+
+  /* RFC2183 says this is arbitrary */
+  e->body->disposition = DISP_INLINE;
+}
+
+/**
+ * rfc822_field_is_lazy - Can the parsing of this field be deferred?
+ * @param name     Field name, e.g. "Reply-To"
+ * @param name_len Length of the name
+ * @retval true The field isn't needed by the index, sorting or threading
+ *
+ * Reply-To stays eager: the index uses it for `$to_chars` and `%A`.
+ *
+ * These fields are kept unparsed until mutt_env_materialize() is called.
+ */
+static bool rfc822_field_is_lazy(const char *name, size_t name_len)
+{
+  static const char *const LazyFields[] = {
+    "List-Subscribe", "List-Unsubscribe", "Mail-Followup-To",
+    "Organization",   "X-Original-To",
+  };
+
+  for (size_t i = 0; i < mutt_array_size(LazyFields); i++)
   {
-    LOFF_T line_start_loc = loc;
-    size_t len = mutt_rfc822_read_line(fp, line);
-    if (buf_is_empty(line))
+    if ((name_len == mutt_str_len(LazyFields[i])) &&
+        mutt_istrn_equal(name, LazyFields[i], name_len))
     {
-      break;
+      return true;
     }
-    loc += len;
-    const char *lines = buf_string(line);
-    p = strpbrk(lines, ": \t");
-    if (!p || (*p != ':'))
-    {
-      char return_path[1024] = { 0 };
-      time_t t = 0;
+  }
 
-      /* some bogus MTAs will quote the original "From " line */
-      if (mutt_str_startswith(lines, ">From "))
-      {
-        continue; /* just ignore */
-      }
-      else if (is_from(lines, return_path, sizeof(return_path), &t))
-      {
-        /* MH sometimes has the From_ line in the middle of the header! */
-        if (e && (e->received == 0))
-          e->received = t - mutt_date_local_tz(t);
-        continue;
-      }
+  /* List-Post feeds $auto_subscribe, so it's needed straight away.
+   * If it's deferred, mutt_env_materialize() subscribes when it's parsed. */
+  if ((name_len == 9) && mutt_istrn_equal(name, "List-Post", 9))
+    return !cs_subset_bool(SpaceMutt->sub, "auto_subscribe");
+
+  return false;
+}
+
+/**
+ * rfc822_parse_field - Parse one header field
+ * @param env       Envelope of the email
+ * @param e         Email (optional)
+ * @param hf        Field from mutt_rfc822_next_field()
+ * @param user_hdrs If true, save into the Envelope's userhdrs
+ * @param weed      If true, perform header weeding (filtering)
+ * @param lazy      If true, defer parsing the fields the index doesn't need
+ * @retval true  The field was part of the header
+ * @retval false The field is the start of the body
+ */
+static bool rfc822_parse_field(struct Envelope *env, struct Email *e,
+                               struct HeaderField *hf, bool user_hdrs,
+                               bool weed, bool lazy)
+{
+  if (hf->name_len == 0)
+  {
+    char line[1024] = { 0 };
+    mutt_strn_copy(line, hf->line, hf->len, sizeof(line));
+
+    char return_path[1024] = { 0 };
+    time_t t = 0;
+
+    /* some bogus MTAs will quote the original "From " line */
+    if (mutt_str_startswith(line, ">From "))
+      return true; /* just ignore */
 
-      /* We need to seek back to the start of the body. Note that we
-       * keep track of loc ourselves, since calling ftello() incurs
-       * a syscall, which can be expensive to do for every single line */
-      (void) mutt_file_seek(fp, line_start_loc, SEEK_SET);
-      break; /* end of header */
+    if (is_from(line, return_path, sizeof(return_path), &t))
+    {
+      /* MH sometimes has the From_ line in the middle of the header! */
+      if (e && (e->received == 0))
+        e->received = t - mutt_date_local_tz(t);
+      return true;
     }
-    size_t name_len = p - lines;
 
-    char buf[1024] = { 0 };
-    if (mutt_replacelist_match(SpamList, buf, sizeof(buf), lines))
+    return false; /* end of header */
+  }
+
+  char *lines = hf->line;
+
+  char buf[1024] = { 0 };
+  if (mutt_replacelist_match(SpamList, buf, sizeof(buf), lines))
+  {
+    if (!mutt_regexlist_match(NoSpamList, lines))
     {
-      if (!mutt_regexlist_match(NoSpamList, lines))
+      /* if spam tag already exists, figure out how to amend it */
+      if ((!buf_is_empty(&env->spam)) && (*buf != '\0'))
       {
-        /* if spam tag already exists, figure out how to amend it */
-        if ((!buf_is_empty(&env->spam)) && (*buf != '\0'))
-        {
-          /* If `$spam_separator` defined, append with separator */
-          const char *const c_spam_separator = cs_subset_string(SpaceMutt->sub, "spam_separator");
-          if (c_spam_separator)
-          {
-            buf_addstr(&env->spam, c_spam_separator);
-            buf_addstr(&env->spam, buf);
-          }
-          else /* overwrite */
-          {
-            buf_reset(&env->spam);
-            buf_addstr(&env->spam, buf);
-          }
-        }
-        else if (buf_is_empty(&env->spam) && (*buf != '\0'))
+        /* If `$spam_separator` defined, append with separator */
+        const char *const c_spam_separator = cs_subset_string(SpaceMutt->sub, "spam_separator");
+        if (c_spam_separator)
         {
-          /* spam tag is new, and match expr is non-empty; copy */
+          buf_addstr(&env->spam, c_spam_separator);
           buf_addstr(&env->spam, buf);
         }
-        else if (buf_is_empty(&env->spam))
+        else /* overwrite */
         {
-          /* match expr is empty; plug in null string if no existing tag */
-          buf_addstr(&env->spam, "");
+          buf_reset(&env->spam);
+          buf_addstr(&env->spam, buf);
         }
-
-        if (!buf_is_empty(&env->spam))
-          log_debug5("spam = %s", env->spam.data);
       }
+      else if (buf_is_empty(&env->spam) && (*buf != '\0'))
+      {
+        /* spam tag is new, and match expr is non-empty; copy */
+        buf_addstr(&env->spam, buf);
+      }
+      else if (buf_is_empty(&env->spam))
+      {
+        /* match expr is empty; plug in null string if no existing tag */
+        buf_addstr(&env->spam, "");
+      }
+
+      if (!buf_is_empty(&env->spam))
+        log_debug5("spam = %s", env->spam.data);
     }
+  }
+
+  lines[hf->name_len] = '\0';
+  if (hf->value_len == 0)
+    return true; /* skip empty header fields */
+
+  if (lazy && rfc822_field_is_lazy(lines, hf->name_len))
+  {
+    /* Keep "Name: value\n", the value was unfolded by mutt_rfc822_next_field() */
+    const size_t old_len = mutt_str_len(env->lazy);
+    const size_t add_len = hf->name_len + hf->value_len + 4;
+    env->lazy = g_realloc(env->lazy, old_len + add_len);
+    snprintf(env->lazy + old_len, add_len, "%s: %s\n", lines, hf->value);
+    return true;
+  }
+
+  mutt_rfc822_parse_line(env, e, lines, hf->name_len, hf->value, user_hdrs, weed, true);
+  return true;
+}
 
-    *p = '\0';
-    p = mutt_str_skip_email_wsp(p + 1);
-    if (*p == '\0')
-      continue; /* skip empty header fields */
+/**
+ * rfc822_header_finish - Tidy up an Email after its header has been parsed
+ * @param env         Envelope of the email
+ * @param e           Email (optional)
+ * @param body_offset Offset of the body
+ */
+static void rfc822_header_finish(struct Envelope *env, struct Email *e, LOFF_T body_offset)
+{
+  if (!e)
+    return;
+
+  e->body->hdr_offset = e->offset;
+  e->body->offset = body_offset;
+
+  rfc2047_decode_envelope(env);
 
-    mutt_rfc822_parse_line(env, e, lines, name_len, p, user_hdrs, weed, true);
+  if (e->received < 0)
+  {
+    log_debug1("resetting invalid received time to 0");
+    e->received = 0;
   }
 
-  buf_pool_release(&line);
+  /* check for missing or invalid date */
+  if (e->date_sent <= 0)
+  {
+    log_debug1("no date found, using received time from msg separator");
+    e->date_sent = e->received;
+  }
 
-  if (e)
+#ifdef USE_AUTOCRYPT
+  const bool c_autocrypt = cs_subset_bool(SpaceMutt->sub, "autocrypt");
+  if (c_autocrypt)
   {
-    e->body->hdr_offset = e->offset;
-    e->body->offset = ftello(fp);
+    mutt_autocrypt_process_autocrypt_header(e, env);
+    /* No sense in taking up memory after the header is processed */
+    mutt_autocrypthdr_free(&env->autocrypt);
+  }
+#endif
+}
 
-    rfc2047_decode_envelope(env);
+/**
+ * rfc822_read_header - Parses an RFC822 header
+ * @param fp        Stream to read from
+ * @param e         Current Email (optional)
+ * @param user_hdrs If set, store user headers
+ * @param weed      If set, honour the header weed list for user headers
+ * @param lazy      If set, defer parsing the fields the index doesn't need
+ * @param arena     Arena to allocate the Envelope and Body from (optional)
+ * @retval ptr Newly allocated envelope structure
+ *
+ * The header is read in blocks and split by mutt_rfc822_next_field().
+ * Afterwards, the stream is left at the start of the body.
+ */
+static struct Envelope *rfc822_read_header(FILE *fp, struct Email *e, bool user_hdrs,
+                                           bool weed, bool lazy, struct Arena *arena)
+{
+  if (!fp)
+    return NULL;
 
-    if (e->received < 0)
-    {
-      log_debug1("resetting invalid received time to 0");
-      e->received = 0;
-    }
+  struct Envelope *env = mutt_env_new_arena(arena);
+  LOFF_T start = ftello(fp);
+  if (start < 0)
+  {
+    log_debug1("ftello: %s (errno %d)", strerror(errno), errno);
+    start = 0;
+  }
 
-    /* check for missing or invalid date */
-    if (e->date_sent <= 0)
+  rfc822_header_init(e, arena);
+
+  size_t size = HEADER_BLOCK_SIZE;
+  char *blk = g_malloc(size);
+  size_t used = 0;    // Bytes of data in blk
+  size_t pos = 0;     // Offset of the next field in blk
+  LOFF_T base = 0;    // Offset of blk from start
+  bool eof = false;
+
+  while (true)
+  {
+    const size_t field_start = pos;
+    struct HeaderField hf = { 0 };
+    enum HeaderToken rc = mutt_rfc822_next_field(blk, used, &pos, eof, &hf);
+
+    if (rc == HDR_MORE)
     {
-      log_debug1("no date found, using received time from msg separator");
-      e->date_sent = e->received;
+      /* Discard the parsed fields and read some more */
+      memmove(blk, blk + pos, used - pos);
+      base += pos;
+      used -= pos;
+      pos = 0;
+
+      if ((size - used) < (HEADER_BLOCK_SIZE / 2))
+      {
+        size *= 2;
+        blk = g_realloc(blk, size);
+      }
+
+      const size_t want = size - used - 1;
+      const size_t got = fread(blk + used, 1, want, fp);
+      used += got;
+      blk[used] = '\0';
+      if (got < want)
+        eof = true;
+      continue;
     }
 
-#ifdef USE_AUTOCRYPT
-    const bool c_autocrypt = cs_subset_bool(SpaceMutt->sub, "autocrypt");
-    if (c_autocrypt)
+    if (rc == HDR_END)
+      break;
+
+    if (!rfc822_parse_field(env, e, &hf, user_hdrs, weed, lazy))
     {
-      mutt_autocrypt_process_autocrypt_header(e, env);
-      /* No sense in taking up memory after the header is processed */
-      mutt_autocrypthdr_free(&env->autocrypt);
+      pos = field_start;
+      break;
     }
-#endif
   }
 
+  FREE(&blk);
+
+  /* We read past the header, so seek back to the start of the body. */
+  const LOFF_T body_offset = start + base + pos;
+  (void) mutt_file_seek(fp, body_offset, SEEK_SET);
+
+  rfc822_header_finish(env, e, body_offset);
   return env;
 }
 
+/**
+ * mutt_rfc822_read_header - Parses an RFC822 header
+ * @param fp        Stream to read from
+ * @param e         Current Email (optional)
+ * @param user_hdrs If set, store user headers
+ *                  Used for recall-message and postpone modes
+ * @param weed      If this parameter is set and the user has activated the
+ *                  $weed option, honor the header weed list for user headers.
+ *                  Used for recall-message
+ * @retval ptr Newly allocated envelope structure
+ *
+ * Afterwards, the stream is left at the start of the body.
+ *
+ * Caller should free the Envelope using mutt_env_free().
+ */
+struct Envelope *mutt_rfc822_read_header(FILE *fp, struct Email *e, bool user_hdrs, bool weed)
+{
+  return rfc822_read_header(fp, e, user_hdrs, weed, false, NULL);
+}
+
+/**
+ * mutt_rfc822_read_header_lazy - Parse an RFC822 header for the index
+ * @param fp    Stream to read from
+ * @param e     Current Email
+ * @param arena Arena to allocate the Envelope and Body from (optional)
+ * @retval ptr Newly allocated envelope structure
+ *
+ * Only the fields needed by the index, sorting and threading are parsed.
+ * The rest, e.g. Mail-Followup-To, are kept raw until mutt_env_materialize().
+ * This is used when opening a mailbox.
+ *
+ * Caller should free the Envelope using mutt_env_free().
+ */
+struct Envelope *mutt_rfc822_read_header_lazy(FILE *fp, struct Email *e, struct Arena *arena)
+{
+  return rfc822_read_header(fp, e, false, false, true, arena);
+}
+
 /**
  * mutt_read_mime_header - Parse a MIME header
  * @param fp      stream to read from
@@ -29,11 +29,36 @@
 #include <stdio.h>
 #include "mime.h"
 
+struct Arena;
 struct Body;
 struct Buffer;
 struct Email;
 struct Envelope;
 
+/**
+ * enum HeaderToken - Result of mutt_rfc822_next_field()
+ */
+enum HeaderToken
+{
+  HDR_FIELD, ///< A header field was found
+  HDR_END,   ///< End of the header
+  HDR_MORE,  ///< More data is needed
+};
+
+/**
+ * struct HeaderField - An unfolded header field
+ *
+ * The strings point into the caller's buffer.
+ */
+struct HeaderField
+{
+  char *line;       ///< Whole field, e.g. "Subject: hello"
+  size_t len;       ///< Length of the field
+  size_t name_len;  ///< Length of the field name, 0 if the line has no colon
+  char *value;      ///< Field body, e.g. "hello"
+  size_t value_len; ///< Length of the field body
+};
+
 void             mutt_auto_subscribe      (const char *mailto);
 int              mutt_check_encoding      (const char *c);
 enum ContentType mutt_check_mime_type     (const char *s);
@@ -48,7 +73,9 @@ struct Body *    mutt_read_mime_header    (FILE *fp, bool digest);
 int              mutt_rfc822_parse_line   (struct Envelope *env, struct Email *e, const char *name, size_t name_len, const char *body, bool user_hdrs, bool weed, bool do_2047);
 struct Body *    mutt_rfc822_parse_message(FILE *fp, struct Body *b);
 struct Envelope *mutt_rfc822_read_header  (FILE *fp, struct Email *e, bool user_hdrs, bool weed);
+struct Envelope *mutt_rfc822_read_header_lazy(FILE *fp, struct Email *e, struct Arena *arena);
 size_t           mutt_rfc822_read_line    (FILE *fp, struct Buffer *out);
+enum HeaderToken mutt_rfc822_next_field   (char *buf, size_t len, size_t *pos, bool eof, struct HeaderField *hf);
 
 void mutt_filter_commandline_header_tag  (char *header);
 void mutt_filter_commandline_header_value(char *header);
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * Summary of an email's MIME structure
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page email_summary Summary of an email's MIME structure
+ *
+ * Parsing the MIME structure of an email means reading the whole message.
+ * A PartSummary keeps the facts about each part that the index needs, e.g. to
+ * count attachments.  It's small enough to be stored in the header cache.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "summary.h"
+#include "body.h"
+#include "mime.h"
+
+/**
+ * part_crypto_flags - Get the crypto markers of a part
+ * @param b Body of the part
+ * @retval num Flags, see #PartSummaryFlags
+ */
+static PartSummaryFlags part_crypto_flags(const struct Body *b)
+{
+  PartSummaryFlags flags = PART_SUM_NO_FLAGS;
+
+  if (b->type == TYPE_MULTIPART)
+  {
+    if (mutt_istr_equal(b->subtype, "signed"))
+      flags |= PART_SUM_SIGNED;
+    else if (mutt_istr_equal(b->subtype, "encrypted"))
+      flags |= PART_SUM_ENCRYPTED;
+  }
+  else if (b->type == TYPE_APPLICATION)
+  {
+    if (mutt_istr_equal(b->subtype, "pgp-signature") ||
+        mutt_istr_equal(b->subtype, "pkcs7-signature") ||
+        mutt_istr_equal(b->subtype, "x-pkcs7-signature"))
+    {
+      flags |= PART_SUM_SIGNED;
+    }
+    else if (mutt_istr_equal(b->subtype, "pgp-encrypted") ||
+             mutt_istr_equal(b->subtype, "pkcs7-mime") ||
+             mutt_istr_equal(b->subtype, "x-pkcs7-mime"))
+    {
+      flags |= PART_SUM_ENCRYPTED;
+    }
+  }
+
+  if (b->goodsig)
+    flags |= PART_SUM_GOODSIG;
+  if (b->badsig)
+    flags |= PART_SUM_BADSIG;
+
+  return flags;
+}
+
+/**
+ * part_summary_add - Summarise a list of parts
+ * @param psa   Summary to add to
+ * @param b     First part
+ * @param depth Nesting depth of the parts
+ */
+static void part_summary_add(struct PartSummaryArray *psa, const struct Body *b, int depth)
+{
+  for (; b; b = b->next)
+  {
+    struct PartSummary ps = { 0 };
+    ps.subtype = mutt_str_dup(b->subtype);
+    ps.length = b->length;
+    ps.type = b->type;
+    ps.encoding = b->encoding;
+    ps.disposition = b->disposition;
+    ps.depth = depth;
+    ps.flags = part_crypto_flags(b);
+    ARRAY_ADD(psa, ps);
+
+    if (b->parts && (depth < PART_SUM_MAX_DEPTH))
+      part_summary_add(psa, b->parts, depth + 1);
+  }
+}
+
+/**
+ * part_summary_new - Summarise the MIME structure of an email
+ * @param b Body of the email, with its parts parsed
+ * @retval ptr New PartSummaryArray
+ */
+struct PartSummaryArray *part_summary_new(const struct Body *b)
+{
+  if (!b)
+    return NULL;
+
+  struct PartSummaryArray *psa = g_new0(struct PartSummaryArray, 1);
+  part_summary_add(psa, b, 0);
+  return psa;
+}
+
+/**
+ * part_summary_free - Free a PartSummaryArray
+ * @param ptr PartSummaryArray to free
+ */
+void part_summary_free(struct PartSummaryArray **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct PartSummaryArray *psa = *ptr;
+  struct PartSummary *ps = NULL;
+  ARRAY_FOREACH(ps, psa)
+  {
+    FREE(&ps->subtype);
+  }
+  ARRAY_FREE(psa);
+  FREE(ptr);
+}
+
+/**
+ * part_summary_body - Rebuild the MIME structure from a summary
+ * @param psa Summary
+ * @retval ptr Tree of Bodies, NULL if the summary is empty or malformed
+ *
+ * The Bodies only have the summarised fields set, e.g. type and subtype.
+ * Nothing can be read from them.
+ *
+ * @note The caller must free the Bodies with mutt_body_free()
+ */
+struct Body *part_summary_body(const struct PartSummaryArray *psa)
+{
+  if (!psa || ARRAY_EMPTY(psa))
+    return NULL;
+
+  /* The most recent Body at each depth, for linking siblings and children */
+  struct Body *last[PART_SUM_MAX_DEPTH + 2] = { 0 };
+  struct Body *top = NULL;
+
+  const struct PartSummary *ps = NULL;
+  ARRAY_FOREACH(ps, psa)
+  {
+    const int depth = ps->depth;
+    if ((depth > PART_SUM_MAX_DEPTH) || ((depth > 0) && !last[depth - 1]))
+    {
+      mutt_body_free(&top);
+      return NULL;
+    }
+
+    struct Body *b = mutt_body_new();
+    b->subtype = mutt_str_dup(ps->subtype);
+    b->length = ps->length;
+    b->type = ps->type;
+    b->encoding = ps->encoding;
+    b->disposition = ps->disposition;
+    b->goodsig = (ps->flags & PART_SUM_GOODSIG);
+    b->badsig = (ps->flags & PART_SUM_BADSIG);
+
+    if (last[depth])
+      last[depth]->next = b;
+    else if (depth == 0)
+      top = b;
+    else
+      last[depth - 1]->parts = b;
+
+    last[depth] = b;
+    last[depth + 1] = NULL;
+  }
+
+  return top;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file
+ * Summary of an email's MIME structure
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_EMAIL_SUMMARY_H
+#define MUTT_EMAIL_SUMMARY_H
+
+#include "config.h"
+#include <stdint.h>
+#include "mutt/lib.h"
+
+struct Body;
+
+/* Crypto markers of a MIME part */
+typedef uint8_t PartSummaryFlags;          ///< Flags for PartSummary.flags, e.g. #PART_SUM_SIGNED
+#define PART_SUM_NO_FLAGS         0  ///< No flags are set
+#define PART_SUM_SIGNED     (1 << 0) ///< Signed part, or a signature
+#define PART_SUM_ENCRYPTED  (1 << 1) ///< Encrypted part
+#define PART_SUM_GOODSIG    (1 << 2) ///< Good signature
+#define PART_SUM_BADSIG     (1 << 3) ///< Bad signature
+
+/// Parts nested deeper than this aren't summarised
+#define PART_SUM_MAX_DEPTH 32
+
+/**
+ * struct PartSummary - Summary of one MIME part
+ *
+ * The parts are listed depth-first, so a part's children follow it.
+ */
+struct PartSummary
+{
+  char *subtype;              ///< Content-Type subtype, e.g. "html"
+  LOFF_T length;              ///< Length of the part, in bytes
+  unsigned char type;         ///< Content-Type, #ContentType
+  unsigned char encoding;     ///< Content-Transfer-Encoding, #ContentEncoding
+  unsigned char disposition;  ///< Content-Disposition, #ContentDisposition
+  unsigned char depth;        ///< Nesting depth, 0 for the top-level part
+  PartSummaryFlags flags;     ///< Crypto markers, e.g. #PART_SUM_SIGNED
+};
+ARRAY_HEAD(PartSummaryArray, struct PartSummary);
+
+struct PartSummaryArray *part_summary_new (const struct Body *b);
+void                     part_summary_free(struct PartSummaryArray **ptr);
+struct Body *            part_summary_body(const struct PartSummaryArray *psa);
+
+#endif /* MUTT_EMAIL_SUMMARY_H */
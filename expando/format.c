@@ -117,8 +117,24 @@ int format_string(struct Buffer *buf, int min_cols, int max_cols, enum FormatJus
   bool escaped = false;
   int used_cols = 0;
 
-  for (; (n > 0) && (k = mbrtowc(&wc, str, n, &mbstate1)); str += k, n -= k)
+  for (; n > 0; str += k, n -= k)
   {
+    k = escaped ? 0 : mutt_mb_ascii_len(str, n);
+    if (k != 0)
+    {
+      /* Printable ASCII is one column per byte, anything that won't fit is dropped */
+      const size_t fit = (max_cols > 0) ? MIN(k, (size_t) max_cols) : 0;
+      buf_addstr_n(buf, str, fit);
+      used_cols += fit;
+      min_cols -= fit;
+      max_cols -= fit;
+      continue;
+    }
+
+    k = mutt_mb_mbrtowc(&wc, str, n, &mbstate1);
+    if (k == 0)
+      break;
+
     if ((k == ICONV_ILLEGAL_SEQ) || (k == ICONV_BUF_TOO_SMALL))
     {
       if ((k == ICONV_ILLEGAL_SEQ) && (errno == EILSEQ))
@@ -156,7 +172,7 @@ int format_string(struct Buffer *buf, int min_cols, int max_cols, enum FormatJus
 #endif
           if (!IsWPrint(wc))
         wc = '?';
-      w = wcwidth(wc);
+      w = mutt_mb_char_width(wc);
     }
 
     // It'll require _some_ space
@@ -340,6 +340,7 @@ void mutt_set_flag(struct Mailbox *m, struct Email *e, enum MessageType flag,
     struct EventMailbox ev_m = { m };
     notify_send(m->notify, NT_MAILBOX, NT_MAILBOX_CHANGE, &ev_m);
   }
+  mailbox_hot_update(m, e);
 
   /* if the message status has changed, we need to invalidate the cached
    * search results so that any future search will match the current status
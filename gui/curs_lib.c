@@ -345,8 +345,25 @@ void mutt_paddstr(struct MuttWindow *win, int n, const char *s)
   size_t len = mutt_str_len(s);
   mbstate_t mbstate = { 0 };
 
-  for (; len && (k = mbrtowc(&wc, s, len, &mbstate)); s += k, len -= k)
+  for (; len; s += k, len -= k)
   {
+    k = mutt_mb_ascii_len(s, len);
+    if (k != 0)
+    {
+      /* Printable ASCII is one column per byte */
+      const size_t fit = (n > 0) ? MIN(k, (size_t) n) : 0;
+      if (fit != 0)
+        mutt_window_addnstr(win, s, fit);
+      n -= fit;
+      if (fit < k)
+        break;
+      continue;
+    }
+
+    k = mutt_mb_mbrtowc(&wc, s, len, &mbstate);
+    if (k == 0)
+      break;
+
     if ((k == ICONV_ILLEGAL_SEQ) || (k == ICONV_BUF_TOO_SMALL))
     {
       if (k == ICONV_ILLEGAL_SEQ)
@@ -356,7 +373,7 @@ void mutt_paddstr(struct MuttWindow *win, int n, const char *s)
     }
     if (!IsWPrint(wc))
       wc = '?';
-    const int w = wcwidth(wc);
+    const int w = mutt_mb_char_width(wc);
     if (w >= 0)
     {
       if (w > n)
@@ -392,8 +409,24 @@ size_t mutt_wstr_trunc(const char *src, size_t maxlen, size_t maxwid, size_t *wi
 
   n = mutt_str_len(src);
 
-  for (w = 0; n && (cl = mbrtowc(&wc, src, n, &mbstate)); src += cl, n -= cl)
+  for (w = 0; n; src += cl, n -= cl)
   {
+    cl = mutt_mb_ascii_len(src, n);
+    if (cl != 0)
+    {
+      /* Printable ASCII is one column per byte */
+      const size_t fit = MIN(cl, MIN(maxlen - l, maxwid - w));
+      l += fit;
+      w += fit;
+      if (fit < cl)
+        break;
+      continue;
+    }
+
+    cl = mutt_mb_mbrtowc(&wc, src, n, &mbstate);
+    if (cl == 0)
+      break;
+
     if (cl == ICONV_ILLEGAL_SEQ)
     {
       memset(&mbstate, 0, sizeof(mbstate));
@@ -406,7 +439,7 @@ size_t mutt_wstr_trunc(const char *src, size_t maxlen, size_t maxwid, size_t *wi
       wc = ReplacementChar;
     }
 
-    cw = wcwidth(wc);
+    cw = mutt_mb_char_width(wc);
     /* hack because MUTT_TREE symbols aren't turned into characters
      * until rendered by print_enriched_string() */
     if ((cw < 0) && (src[0] == MUTT_SPECIAL_INDEX))
@@ -463,8 +496,20 @@ size_t mutt_strnwidth(const char *s, size_t n)
   size_t k;
   mbstate_t mbstate = { 0 };
 
-  for (w = 0; n && (k = mbrtowc(&wc, s, n, &mbstate)); s += k, n -= k)
+  for (w = 0; n; s += k, n -= k)
   {
+    k = mutt_mb_ascii_len(s, n);
+    if (k != 0)
+    {
+      /* Printable ASCII is one column per byte */
+      w += k;
+      continue;
+    }
+
+    k = mutt_mb_mbrtowc(&wc, s, n, &mbstate);
+    if (k == 0)
+      break;
+
     if (*s == MUTT_SPECIAL_INDEX)
     {
       s += 2; /* skip the index coloring sequence */
@@ -481,7 +526,7 @@ size_t mutt_strnwidth(const char *s, size_t n)
     }
     if (!IsWPrint(wc))
       wc = '?';
-    w += wcwidth(wc);
+    w += mutt_mb_char_width(wc);
   }
   return w;
 }
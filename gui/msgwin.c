@@ -116,7 +116,7 @@ void measure(struct MwCharArray *chars, const char *str, const struct AttrColor
   while (*str && (str_len > 0))
   {
     wchar_t wc = L'\0';
-    size_t consumed = mbrtowc(&wc, str, str_len, &mbstate);
+    size_t consumed = mutt_mb_mbrtowc(&wc, str, str_len, &mbstate);
     if (consumed == 0)
       break;
 
@@ -132,7 +132,7 @@ void measure(struct MwCharArray *chars, const char *str, const struct AttrColor
       consumed = str_len;
     }
 
-    int wchar_width = wcwidth(wc);
+    int wchar_width = mutt_mb_char_width(wc);
     if (wchar_width < 0)
       wchar_width = 1;
 
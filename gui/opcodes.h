@@ -270,6 +270,7 @@ const char *opcodes_get_name       (int op);
   /* L10N: Help screen description for OP_DELETE */ \
   /*       Alias Dialog: <op_delete> */ \
   /*       Index: <op_delete> */ \
+  /*       Outbox Dialog: <op_delete> */ \
   /*       Postponed Dialog: <op_delete> */ \
   _fmt(OP_DELETE,                             N_("delete the current entry")) \
   /* L10N: Help screen description for OP_DELETE_MAILBOX */ \
@@ -393,6 +394,7 @@ const char *opcodes_get_name       (int op);
   /*       Compose Dialog: <op_exit> */ \
   /*       GPGME Key Selection Dialog: <op_exit> */ \
   /*       Index: <op_exit> */ \
+  /*       Outbox Dialog: <op_exit> */ \
   /*       Pager: <op_exit> */ \
   /*       PGP Key Selection Dialog: <op_exit> */ \
   /*       Postponed Dialog: <op_exit> */ \
@@ -421,6 +423,7 @@ const char *opcodes_get_name       (int op);
   /*       Browser: <op_generic_select_entry> */ \
   /*       GPGME Key Selection Dialog: <op_generic_select_entry> */ \
   /*       History Dialog: <op_generic_select_entry> */ \
+  /*       Outbox Dialog: <op_generic_select_entry> */ \
   /*       Pattern Dialog: <op_generic_select_entry> */ \
   /*       PGP Key Selection Dialog: <op_generic_select_entry> */ \
   /*       Postponed Dialog: <op_generic_select_entry> */ \
@@ -642,6 +645,9 @@ const char *opcodes_get_name       (int op);
   /*       Menu: <menu_movement> */ \
   /*       Pager: <op_pager_next_page> */ \
   _fmt(OP_NEXT_PAGE,                          N_("move to the next page")) \
+  /* L10N: Help screen description for OP_OUTBOX */ \
+  /*       Index: <op_outbox> */ \
+  _fmt(OP_OUTBOX,                             N_("show the messages waiting to be sent")) \
   /* L10N: Help screen description for OP_PAGER_BOTTOM */ \
   /*       Pager: <op_pager_bottom> */ \
   _fmt(OP_PAGER_BOTTOM,                       N_("jump to the bottom of the message")) \
@@ -131,6 +131,9 @@ static struct ConfigDef HcacheVars[] = {
   { "header_cache_backend", DT_STRING, 0, 0, hcache_validator,
     "(hcache) Header cache backend to use"
   },
+  { "header_cache_gc_interval", DT_NUMBER|D_INTEGER_NOT_NEGATIVE, 7, 0, NULL,
+    "(hcache) Days between removing stale entries from the header cache"
+  },
   { NULL },
   // clang-format on
 };
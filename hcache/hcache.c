@@ -39,6 +39,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 #include <glib.h>
 #include "mutt/lib.h"
@@ -53,14 +54,67 @@
 #include "serialize.h"
 
 #if !(defined(HAVE_BDB) || defined(HAVE_GDBM) || defined(HAVE_KC) ||           \
-      defined(HAVE_LMDB) || defined(HAVE_QDBM) || defined(HAVE_ROCKSDB) ||     \
-      defined(HAVE_TC) || defined(HAVE_TDB))
+      defined(HAVE_LMDB) || defined(HAVE_LOGDB) || defined(HAVE_QDBM) ||       \
+      defined(HAVE_ROCKSDB) || defined(HAVE_TC) || defined(HAVE_TDB))
 #error "No hcache backend defined"
 #endif
 
 /// Header Cache version
 static unsigned int HcacheVer = 0x0;
 
+/// Flush a batch of writes once it's this big
+#define HCACHE_BATCH_BYTES (4 * 1024 * 1024)
+
+/**
+ * struct HCachePending - A write waiting for hcache_flush()
+ */
+struct HCachePending
+{
+  void *data;  ///< Value to store, NULL to delete the key
+  size_t dlen; ///< Length of the value
+};
+
+/// Raw key holding the time of the last hcache_gc()
+static const char *const HCACHE_GC_KEY = "GCTIME";
+
+#ifdef USE_HCACHE_COMPRESSION
+/// Key holding the compression dictionary, stored like an Email
+static const char *const HCACHE_DICT_KEY = "COMPRDICT";
+/// Train the dictionary once this many records have been sampled
+#define HCACHE_DICT_SAMPLES 1000
+/// Fewest records worth training a dictionary from
+#define HCACHE_DICT_SAMPLES_MIN 100
+/// Train the dictionary once the samples are this big
+#define HCACHE_DICT_SAMPLE_BYTES (2 * 1024 * 1024)
+/// Don't sample records bigger than this
+#define HCACHE_DICT_SAMPLE_MAX (64 * 1024)
+
+ARRAY_HEAD(SizeArray, size_t);
+
+/**
+ * struct HCacheTrainer - Samples for a compression dictionary
+ */
+struct HCacheTrainer
+{
+  struct Buffer *samples;  ///< Uncompressed records, back to back
+  struct SizeArray sizes;  ///< Length of each record
+};
+#endif
+
+ARRAY_HEAD(HCacheKeyArray, char *);
+
+/**
+ * struct HCacheGc - Private data for gc_key()
+ */
+struct HCacheGc
+{
+  struct HeaderCache *hc;         ///< Header cache
+  struct HashTable *live;         ///< Keys of the Emails in the folder
+  const char *const *raw_keys;    ///< Keys of the raw data, NULL-terminated
+  size_t prefix_len;              ///< Length of "folder/"
+  struct HCacheKeyArray dead;     ///< Real keys to delete
+};
+
 /**
  * struct RealKey - Hcache key name (including compression method)
  */
@@ -109,6 +163,15 @@ static void hcache_free(struct HeaderCache **ptr)
   struct HeaderCache *hc = *ptr;
   FREE(&hc->folder);
 
+#ifdef USE_HCACHE_COMPRESSION
+  if (hc->trainer)
+  {
+    buf_free(&hc->trainer->samples);
+    ARRAY_FREE(&hc->trainer->sizes);
+    FREE(&hc->trainer);
+  }
+#endif
+
   FREE(ptr);
 }
 
@@ -254,21 +317,31 @@ static void *dump_email(struct HeaderCache *hc, const struct Email *e, int *off,
   d = serial_dump_body(e->body, d, off, convert);
   d = serial_dump_tags(e->tags, d, off);
 
+  d = serial_dump_summary(e->mime_summary, d, off);
+  d = serial_dump_uint32_t(e->attach_rules, d, off);
+  d = serial_dump_int(e->attach_total, d, off);
+
+  /* Without its rules, a score is meaningless, see mutt_score_message() */
+  d = serial_dump_uint32_t(e->score_rules, d, off);
+  d = serial_dump_uint32_t(e->score_inputs, d, off);
+  d = serial_dump_int((e->score_rules != 0) ? e->score : 0, d, off);
+
   return d;
 }
 
 /**
  * restore_email - Restore an Email from data retrieved from the cache
- * @param d Data retrieved using hcache_fetch_email()
+ * @param d     Data retrieved using hcache_fetch_email()
+ * @param arena Arena to allocate the Email from (optional)
  * @retval ptr Success, the restored header (can't be NULL)
  *
  * @note The returned Email must be free'd by caller code with
  *       email_free()
  */
-static struct Email *restore_email(const unsigned char *d)
+static struct Email *restore_email(const unsigned char *d, struct Arena *arena)
 {
   int off = 0;
-  struct Email *e = email_new();
+  struct Email *e = email_new_arena(arena);
   bool convert = !CharsetIsUtf8;
 
   off += sizeof(uint32_t);     // skip validate
@@ -294,13 +367,27 @@ static struct Email *restore_email(const unsigned char *d)
   serial_restore_int(&num, d, &off);
   e->lines = num;
 
-  e->env = mutt_env_new();
+  e->env = mutt_env_new_arena(arena);
   serial_restore_envelope(e->env, d, &off, convert);
 
-  e->body = mutt_body_new();
+  e->body = mutt_body_new_arena(arena);
   serial_restore_body(e->body, d, &off, convert);
   serial_restore_tags(&e->tags, d, &off);
 
+  /* The attachment count is only trusted if the rules haven't changed,
+   * see mutt_count_body_parts() */
+  serial_restore_summary(&e->mime_summary, d, &off);
+  serial_restore_uint32_t(&e->attach_rules, d, &off);
+  serial_restore_int(&num, d, &off);
+  e->attach_total = num;
+
+  /* The score is only trusted if the rules and the fields they depend on
+   * haven't changed, see mutt_score_message() */
+  serial_restore_uint32_t(&e->score_rules, d, &off);
+  serial_restore_uint32_t(&e->score_inputs, d, &off);
+  serial_restore_int(&num, d, &off);
+  e->score = (int) num;
+
   return e;
 }
 
@@ -420,13 +507,181 @@ static char *get_foldername(const char *folder)
   return p;
 }
 
+/**
+ * pending_free - Free a pending write - Implements ::hash_hdata_free_t - @ingroup hash_hdata_free_api
+ */
+static void pending_free(int type, void *obj, intptr_t data)
+{
+  struct HCachePending *hp = obj;
+  FREE(&hp->data);
+  FREE(&hp);
+}
+
+/**
+ * pending_add - Queue a write until hcache_flush()
+ * @param hc   Header cache handle
+ * @param rk   Real key
+ * @param data Value to store (the pending write takes ownership), NULL to delete
+ * @param dlen Length of the value
+ * @retval 0   Success
+ * @retval num Error from flushing the batch
+ *
+ * A later write to the same key replaces an earlier one.
+ */
+static int pending_add(struct HeaderCache *hc, const struct RealKey *rk,
+                       void *data, size_t dlen)
+{
+  if (!hc->pending)
+  {
+    hc->pending = mutt_hash_new(256, MUTT_HASH_STRDUP_KEYS);
+    mutt_hash_set_destructor(hc->pending, pending_free, 0);
+  }
+
+  struct HCachePending *hp = mutt_hash_find(hc->pending, rk->key);
+  if (hp)
+  {
+    hc->pending_bytes -= hp->dlen;
+    FREE(&hp->data);
+  }
+  else
+  {
+    hp = g_new0(struct HCachePending, 1);
+    mutt_hash_insert(hc->pending, rk->key, hp);
+  }
+
+  hp->data = data;
+  hp->dlen = data ? dlen : 0;
+  hc->pending_bytes += hp->dlen + rk->keylen;
+
+  if (hc->pending_bytes > HCACHE_BATCH_BYTES)
+    return hcache_flush(hc);
+
+  return 0;
+}
+
+/**
+ * fetch_raw - Multiplexor for StoreOps::fetch
+ * @param[in]  hc      Header cache handle
+ * @param[in]  rk      Real key
+ * @param[out] dlen    Length of the value
+ * @param[out] pending Set if the value came from a pending write
+ * @retval ptr Value, release it with free_raw()
+ *
+ * Pending writes are checked first, so a batch reads its own writes.
+ */
+static void *fetch_raw(struct HeaderCache *hc, const struct RealKey *rk,
+                       size_t *dlen, bool *pending)
+{
+  *pending = false;
+  if (hc->pending)
+  {
+    struct HCachePending *hp = mutt_hash_find(hc->pending, rk->key);
+    if (hp)
+    {
+      *pending = true;
+      *dlen = hp->dlen;
+      return hp->data;
+    }
+  }
+
+  return hc->store_ops->fetch(hc->store_handle, rk->key, rk->keylen, dlen);
+}
+
 /**
  * free_raw - Multiplexor for StoreOps::free
+ * @param hc      Header cache handle
+ * @param data    Value from fetch_raw()
+ * @param pending The value came from a pending write
+ */
+static void free_raw(struct HeaderCache *hc, void **data, bool pending)
+{
+  if (pending)
+    *data = NULL;
+  else
+    hc->store_ops->free(hc->store_handle, data);
+}
+
+#ifdef USE_HCACHE_COMPRESSION
+/**
+ * dict_open - Load the compression dictionary, or start sampling for one
+ * @param hc Header cache handle
+ */
+static void dict_open(struct HeaderCache *hc)
+{
+  if (!hc->compr_ops->dict_load)
+    return;
+
+  size_t dlen = 0;
+  bool pending = false;
+  struct RealKey *rk = realkey(hc, HCACHE_DICT_KEY, strlen(HCACHE_DICT_KEY), true);
+  void *dict = fetch_raw(hc, rk, &dlen, &pending);
+  if (dict)
+  {
+    if (!hc->compr_ops->dict_load(hc->compr_handle, dict, dlen))
+      log_debug1("Can't load the %s dictionary", hc->compr_ops->name);
+    free_raw(hc, &dict, pending);
+    return;
+  }
+
+  hc->trainer = g_new0(struct HCacheTrainer, 1);
+  hc->trainer->samples = buf_new(NULL);
+  ARRAY_INIT(&hc->trainer->sizes);
+}
+
+/**
+ * dict_train - Train the compression dictionary and save it
+ * @param hc Header cache handle
+ *
+ * The samples are discarded, whether or not training succeeds.
  */
-static void free_raw(struct HeaderCache *hc, void **data)
+static void dict_train(struct HeaderCache *hc)
 {
-  hc->store_ops->free(hc->store_handle, data);
+  struct HCacheTrainer *ht = hc->trainer;
+  hc->trainer = NULL;
+
+  size_t dlen = 0;
+  void *dict = hc->compr_ops->dict_train(buf_string(ht->samples), ARRAY_GET(&ht->sizes, 0),
+                                         ARRAY_SIZE(&ht->sizes), &dlen);
+  if (dict && hc->compr_ops->dict_load(hc->compr_handle, dict, dlen))
+  {
+    log_debug3("Trained a %zu byte %s dictionary from %zu records", dlen,
+               hc->compr_ops->name, ARRAY_SIZE(&ht->sizes));
+
+    struct RealKey *rk = realkey(hc, HCACHE_DICT_KEY, strlen(HCACHE_DICT_KEY), true);
+    if (hc->batch)
+      pending_add(hc, rk, g_steal_pointer(&dict), dlen);
+    else
+      hc->store_ops->store(hc->store_handle, rk->key, rk->keylen, dict, dlen);
+  }
+  FREE(&dict);
+
+  buf_free(&ht->samples);
+  ARRAY_FREE(&ht->sizes);
+  FREE(&ht);
+}
+
+/**
+ * dict_sample - Keep a record for training the compression dictionary
+ * @param hc   Header cache handle
+ * @param data Uncompressed record
+ * @param dlen Length of the record
+ */
+static void dict_sample(struct HeaderCache *hc, const char *data, size_t dlen)
+{
+  struct HCacheTrainer *ht = hc->trainer;
+  if ((dlen == 0) || (dlen > HCACHE_DICT_SAMPLE_MAX))
+    return;
+
+  buf_addstr_n(ht->samples, data, dlen);
+  ARRAY_ADD(&ht->sizes, dlen);
+
+  if ((ARRAY_SIZE(&ht->sizes) >= HCACHE_DICT_SAMPLES) ||
+      (buf_len(ht->samples) >= HCACHE_DICT_SAMPLE_BYTES))
+  {
+    dict_train(hc);
+  }
 }
+#endif
 
 /**
  * generate_hcachever - Calculate hcache version from dynamic configuration
@@ -539,6 +794,12 @@ struct HeaderCache *hcache_open(const char *path, const char *folder,
   }
 
   buf_pool_release(&hcpath);
+
+#ifdef USE_HCACHE_COMPRESSION
+  if (hc && hc->compr_ops)
+    dict_open(hc);
+#endif
+
   return hc;
 }
 
@@ -552,6 +813,14 @@ void hcache_close(struct HeaderCache **ptr)
 
   struct HeaderCache *hc = *ptr;
 
+#ifdef USE_HCACHE_COMPRESSION
+  // Don't waste a smaller sample; the next open would start again
+  if (hc->trainer && (ARRAY_SIZE(&hc->trainer->sizes) >= HCACHE_DICT_SAMPLES_MIN))
+    dict_train(hc);
+#endif
+
+  hcache_flush(hc);
+
 #ifdef USE_HCACHE_COMPRESSION
   if (hc->compr_ops)
     hc->compr_ops->close(&hc->compr_handle);
@@ -572,9 +841,13 @@ struct HCacheEntry hcache_fetch_email(struct HeaderCache *hc, const char *key,
   if (!hc)
     return hce;
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "hcache", "hcache_fetch_email");
+
   size_t dlen = 0;
+  bool pending = false;
   struct RealKey *rk = realkey(hc, key, keylen, true);
-  void *data = hc->store_ops->fetch(hc->store_handle, rk->key, rk->keylen, &dlen);
+  void *data = fetch_raw(hc, rk, &dlen, &pending);
   void *to_free = data;
   if (!data)
   {
@@ -609,10 +882,12 @@ struct HCacheEntry hcache_fetch_email(struct HeaderCache *hc, const char *key,
   }
 #endif
 
-  hce.email = restore_email(data);
+  hce.email = restore_email(data, hc->arena);
 
 end:
-  free_raw(hc, &to_free);
+  free_raw(hc, &to_free, pending);
+  trace_counter(hce.email ? "hcache_hit" : "hcache_miss", 1);
+  trace_end(&span, NULL);
   return hce;
 }
 
@@ -630,10 +905,11 @@ bool hcache_fetch_raw_obj_full(struct HeaderCache *hc, const char *key,
                                size_t keylen, void *dst, size_t dstlen)
 {
   bool rc = true;
+  bool pending = false;
   size_t srclen = 0;
 
   struct RealKey *rk = realkey(hc, key, keylen, false);
-  void *src = hc->store_ops->fetch(hc->store_handle, rk->key, rk->keylen, &srclen);
+  void *src = fetch_raw(hc, rk, &srclen, &pending);
 
   if (src && (srclen == dstlen))
   {
@@ -643,7 +919,7 @@ bool hcache_fetch_raw_obj_full(struct HeaderCache *hc, const char *key,
   {
     rc = false;
   }
-  free_raw(hc, &src);
+  free_raw(hc, &src, pending);
   return rc;
 }
 
@@ -658,14 +934,15 @@ bool hcache_fetch_raw_obj_full(struct HeaderCache *hc, const char *key,
 char *hcache_fetch_raw_str(struct HeaderCache *hc, const char *key, size_t keylen)
 {
   char *res = NULL;
+  bool pending = false;
   size_t dlen = 0;
 
   struct RealKey *rk = realkey(hc, key, keylen, false);
-  void *data = hc->store_ops->fetch(hc->store_handle, rk->key, rk->keylen, &dlen);
+  void *data = fetch_raw(hc, rk, &dlen, &pending);
   if (data)
   {
     res = g_strndup(data, dlen);
-    free_raw(hc, &data);
+    free_raw(hc, &data, pending);
   }
   return res;
 }
@@ -679,6 +956,9 @@ int hcache_store_email(struct HeaderCache *hc, const char *key, size_t keylen,
   if (!hc)
     return -1;
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "hcache", "hcache_store_email");
+
   int dlen = 0;
   char *data = dump_email(hc, e, &dlen, uidvalidity);
 
@@ -689,12 +969,16 @@ int hcache_store_email(struct HeaderCache *hc, const char *key, size_t keylen,
      * decompressing on fetch().  */
     size_t hlen = header_size();
 
+    if (hc->trainer)
+      dict_sample(hc, data + hlen, dlen - hlen);
+
     /* data / dlen gets ptr to compressed data here */
     size_t clen = dlen;
     void *cdata = hc->compr_ops->compress(hc->compr_handle, data + hlen, dlen - hlen, &clen);
     if (!cdata)
     {
       FREE(&data);
+      trace_end(&span, NULL);
       return -1;
     }
 
@@ -709,11 +993,18 @@ int hcache_store_email(struct HeaderCache *hc, const char *key, size_t keylen,
   }
 #endif
 
+  trace_counter("hcache_store_bytes", dlen);
+
+  int rc = 0;
   struct RealKey *rk = realkey(hc, key, keylen, true);
-  int rc = hc->store_ops->store(hc->store_handle, rk->key, rk->keylen, data, dlen);
+  if (hc->batch)
+    rc = pending_add(hc, rk, g_steal_pointer(&data), dlen);
+  else
+    rc = hc->store_ops->store(hc->store_handle, rk->key, rk->keylen, data, dlen);
 
   FREE(&data);
 
+  trace_end(&span, NULL);
   return rc;
 }
 
@@ -734,9 +1025,14 @@ int hcache_store_raw(struct HeaderCache *hc, const char *key, size_t keylen,
     return -1;
 
   struct RealKey *rk = realkey(hc, key, keylen, false);
-  int rc = hc->store_ops->store(hc->store_handle, rk->key, rk->keylen, data, dlen);
+  if (hc->batch)
+  {
+    void *copy = g_malloc(dlen);
+    memcpy(copy, data, dlen);
+    return pending_add(hc, rk, copy, dlen);
+  }
 
-  return rc;
+  return hc->store_ops->store(hc->store_handle, rk->key, rk->keylen, data, dlen);
 }
 
 /**
@@ -748,6 +1044,8 @@ int hcache_delete_email(struct HeaderCache *hc, const char *key, size_t keylen)
     return -1;
 
   struct RealKey *rk = realkey(hc, key, keylen, true);
+  if (hc->batch)
+    return pending_add(hc, rk, NULL, 0);
 
   return hc->store_ops->delete_record(hc->store_handle, rk->key, rk->keylen);
 }
@@ -761,6 +1059,186 @@ int hcache_delete_raw(struct HeaderCache *hc, const char *key, size_t keylen)
     return -1;
 
   struct RealKey *rk = realkey(hc, key, keylen, false);
+  if (hc->batch)
+    return pending_add(hc, rk, NULL, 0);
 
   return hc->store_ops->delete_record(hc->store_handle, rk->key, rk->keylen);
 }
+
+/**
+ * is_raw_key - Is this the key of some raw data?
+ * @param gc   GC state
+ * @param key  Key, without the folder
+ * @param klen Length of the key
+ * @retval true The key is in the raw key list
+ */
+static bool is_raw_key(const struct HCacheGc *gc, const char *key, size_t klen)
+{
+  if ((klen == strlen(HCACHE_GC_KEY)) && mutt_strn_equal(key, HCACHE_GC_KEY, klen))
+    return true;
+
+  for (const char *const *rk = gc->raw_keys; rk && *rk; rk++)
+  {
+    if ((klen == strlen(*rk)) && mutt_strn_equal(key, *rk, klen))
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * gc_key - Collect a key that no longer belongs to an Email - Implements ::store_walk_t
+ */
+static bool gc_key(const char *key, size_t klen, void *wdata)
+{
+  struct HCacheGc *gc = wdata;
+  const char *folder = gc->hc->folder;
+
+  if ((klen <= gc->prefix_len) || !mutt_strn_equal(key, folder, gc->prefix_len - 1) ||
+      (key[gc->prefix_len - 1] != '/'))
+  {
+    return true; // Another folder sharing the Store
+  }
+
+  const char *name = key + gc->prefix_len;
+  size_t nlen = klen - gc->prefix_len;
+
+  // A nested folder sharing the Store; Email keys never contain a '/'
+  if (memchr(name, '/', nlen))
+    return true;
+
+  if (is_raw_key(gc, name, nlen))
+    return true;
+
+#ifdef USE_HCACHE_COMPRESSION
+  if (gc->hc->compr_ops)
+  {
+    // Email keys end with the compression type; others were written without it
+    const size_t slen = strlen(gc->hc->compr_ops->name) + 1;
+    if ((nlen > slen) && (name[nlen - slen] == '-') &&
+        mutt_strn_equal(name + nlen - slen + 1, gc->hc->compr_ops->name, slen - 1))
+    {
+      nlen -= slen;
+
+      if ((nlen == strlen(HCACHE_DICT_KEY)) && mutt_strn_equal(name, HCACHE_DICT_KEY, nlen))
+        return true;
+    }
+  }
+#endif
+
+  char *email_key = g_strndup(name, nlen);
+  if (!mutt_hash_find(gc->live, email_key))
+    ARRAY_ADD(&gc->dead, g_strndup(key, klen));
+  FREE(&email_key);
+
+  return true;
+}
+
+/**
+ * hcache_gc_due - Is it time to remove the stale entries from the cache?
+ */
+bool hcache_gc_due(struct HeaderCache *hc)
+{
+  if (!hc)
+    return false;
+
+  const short c_header_cache_gc_interval = cs_subset_number(SpaceMutt->sub, "header_cache_gc_interval");
+  if (c_header_cache_gc_interval <= 0)
+    return false;
+
+  time_t last = 0;
+  if (!hcache_fetch_raw_obj(hc, HCACHE_GC_KEY, strlen(HCACHE_GC_KEY), &last))
+  {
+    // A new cache has nothing to collect, so start the clock
+    last = mutt_date_now();
+    hcache_store_raw(hc, HCACHE_GC_KEY, strlen(HCACHE_GC_KEY), &last, sizeof(last));
+    return false;
+  }
+
+  return (mutt_date_now() - last) >= ((time_t) c_header_cache_gc_interval * 24 * 60 * 60);
+}
+
+/**
+ * hcache_gc - Remove the stale entries of a folder from the cache
+ */
+int hcache_gc(struct HeaderCache *hc, struct HashTable *live, const char *const *raw_keys)
+{
+  if (!hc || !live)
+    return -1;
+
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "hcache", "hcache_gc");
+
+  // The walk only sees what's in the Store
+  hcache_flush(hc);
+
+  struct HCacheGc gc = { hc, live, raw_keys, strlen(hc->folder) + 1, ARRAY_HEAD_INITIALIZER };
+  int rc = hc->store_ops->walk(hc->store_handle, gc_key, &gc);
+
+  // The Store can't be changed during the walk, so delete the keys afterwards
+  int removed = 0;
+  char **kp = NULL;
+  ARRAY_FOREACH(kp, &gc.dead)
+  {
+    if (hc->store_ops->delete_record(hc->store_handle, *kp, strlen(*kp)) == 0)
+      removed++;
+    FREE(kp);
+  }
+  ARRAY_FREE(&gc.dead);
+
+  if (removed > 0)
+    hc->store_ops->compact(hc->store_handle);
+
+  time_t now = mutt_date_now();
+  hcache_store_raw(hc, HCACHE_GC_KEY, strlen(HCACHE_GC_KEY), &now, sizeof(now));
+
+  log_debug1("%s: removed %d stale entries", hc->folder, removed);
+  trace_counter("hcache_gc_removed", removed);
+  trace_end(&span, hc->folder);
+
+  return (rc == 0) ? removed : -1;
+}
+
+/**
+ * hcache_flush - Write the pending changes to the Store
+ */
+int hcache_flush(struct HeaderCache *hc)
+{
+  if (!hc)
+    return 0;
+
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "hcache", "hcache_flush");
+
+  int rc = 0;
+  if (hc->pending)
+  {
+    struct HashWalkState state = { 0 };
+    struct HashElem *he = NULL;
+    while ((he = mutt_hash_walk(hc->pending, &state)))
+    {
+      const char *key = he->key.strkey;
+      struct HCachePending *hp = he->data;
+      int rc2 = 0;
+      if (hp->data)
+        rc2 = hc->store_ops->store(hc->store_handle, key, strlen(key), hp->data, hp->dlen);
+      else
+        rc2 = hc->store_ops->delete_record(hc->store_handle, key, strlen(key));
+
+      if ((rc2 != 0) && (rc == 0))
+        rc = rc2;
+    }
+
+    trace_counter("hcache_flush_bytes", hc->pending_bytes);
+    mutt_hash_free(&hc->pending);
+    hc->pending_bytes = 0;
+  }
+
+  // The cache stays open, so don't hold the writes in a transaction
+  const int rc_sync = hc->store_ops->sync(hc->store_handle);
+  if ((rc_sync != 0) && (rc == 0))
+    rc = rc_sync;
+
+  trace_end(&span, NULL);
+  return rc;
+}
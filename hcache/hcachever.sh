@@ -1,7 +1,7 @@
 #!/bin/sh
 
 BASEVERSION=8
-STRUCTURES="Address Body Buffer Email Envelope ListNode Parameter"
+STRUCTURES="Address Body Buffer Email Envelope ListNode Parameter PartSummary"
 
 cleanstruct () {
   echo "$1" | sed -e 's/.* //'
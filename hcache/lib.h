@@ -55,6 +55,21 @@
  * **not** affect the CRC.  In this case, it is vital that you bump the
  * **`BASEVERSION`** variable in `hcache/hcachever.sh`
  *
+ * ## Garbage Collection
+ *
+ * Entries for Emails that have been deleted, or moved to another folder, are
+ * never read again.  While a mailbox is open and the user is idle, hcache_gc()
+ * deletes them (at most once every `$header_cache_gc_interval` days) and
+ * compacts the Store.  It's never done while a mailbox is being opened.
+ *
+ * ## Compression Dictionary
+ *
+ * Cached headers are small and alike, so a general-purpose compressor finds
+ * little to share within one record.  If the compression backend supports it
+ * (zstd), the cache samples the first records it stores, trains a dictionary
+ * and keeps it in the Store.  Later records are compressed with it.  Records
+ * written without the dictionary can still be read.
+ *
  * ## Source
  *
  * | File                | Description        |
@@ -73,8 +88,11 @@
 #include "compress/lib.h"
 #include "store/lib.h"
 
+struct Arena;
 struct Buffer;
 struct Email;
+struct HashTable;
+struct HCacheTrainer;
 
 /**
  * struct HeaderCache - Header Cache
@@ -90,6 +108,11 @@ struct HeaderCache
   StoreHandle *store_handle;          ///< Store handle
   const struct ComprOps *compr_ops;   ///< Compression backend
   ComprHandle *compr_handle;          ///< Compression handle
+  struct Arena *arena;                ///< Allocate fetched Emails from here (optional)
+  bool batch;                         ///< Queue writes until hcache_flush()
+  struct HashTable *pending;          ///< Queued writes, real key -> HCachePending
+  size_t pending_bytes;               ///< Size of the queued writes
+  struct HCacheTrainer *trainer;      ///< Samples for a compression dictionary (optional)
 };
 
 /**
@@ -128,10 +151,26 @@ struct HeaderCache *hcache_open(const char *path, const char *folder, hcache_nam
  * hcache_close - Close the connection to the header cache
  * @param ptr Pointer to the struct HeaderCache structure got by hcache_open()
  *
+ * Any pending writes are flushed first.
+ *
  * @note The pointer will be set to NULL
  */
 void hcache_close(struct HeaderCache **ptr);
 
+/**
+ * hcache_flush - Write the pending changes to the Store
+ * @param hc Pointer to the struct HeaderCache structure got by hcache_open()
+ * @retval 0   Success
+ * @retval num Error code of the first write that failed
+ *
+ * If HeaderCache.batch is set, stores and deletes are queued in memory.
+ * They're written when the batch gets large, or when the cache is flushed or
+ * closed.  Fetches see the queued writes.
+ *
+ * The writes are then committed, so other processes see them.
+ */
+int hcache_flush(struct HeaderCache *hc);
+
 /**
  * hcache_store_email - Store a Header along with a validity datum
  * @param hc          Pointer to the struct HeaderCache structure got by hcache_open()
@@ -184,4 +223,24 @@ int hcache_delete_email(struct HeaderCache *hc, const char *key, size_t keylen);
  */
 int hcache_delete_raw(struct HeaderCache *hc, const char *key, size_t keylen);
 
+/**
+ * hcache_gc_due - Is it time to remove the stale entries from the cache?
+ * @param hc Pointer to the struct HeaderCache structure got by hcache_open()
+ * @retval true $header_cache_gc_interval days have passed since hcache_gc()
+ */
+bool hcache_gc_due(struct HeaderCache *hc);
+
+/**
+ * hcache_gc - Remove the stale entries of a folder from the cache
+ * @param hc       Pointer to the struct HeaderCache structure got by hcache_open()
+ * @param live     Keys of the Emails in the folder, as passed to hcache_store_email()
+ * @param raw_keys NULL-terminated list of keys used by hcache_store_raw(), may be NULL
+ * @retval num Number of entries removed
+ * @retval -1  Error
+ *
+ * Every entry of the folder that isn't in @a live or @a raw_keys is deleted.
+ * If any were, the Store is compacted.
+ */
+int hcache_gc(struct HeaderCache *hc, struct HashTable *live, const char *const *raw_keys);
+
 #endif /* MUTT_HCACHE_LIB_H */
@@ -620,6 +620,7 @@ unsigned char *serial_dump_envelope(const struct Envelope *env,
   d = serial_dump_char(env->xref, d, off, false);
   d = serial_dump_char(env->followup_to, d, off, false);
   d = serial_dump_char(env->x_comment_to, d, off, convert);
+  d = serial_dump_char(env->lazy, d, off, false);
 
   return d;
 }
@@ -676,6 +677,12 @@ void serial_restore_envelope(struct Envelope *env, const unsigned char *d, int *
   serial_restore_char(&env->xref, d, off, false);
   serial_restore_char(&env->followup_to, d, off, false);
   serial_restore_char(&env->x_comment_to, d, off, convert);
+  serial_restore_char(&env->lazy, d, off, false);
+
+  /* List-Post was deferred if $auto_subscribe was unset when the email was
+   * parsed.  Parsing it subscribes to the list. */
+  if (c_auto_subscribe && env->lazy && mutt_istr_find(env->lazy, "List-Post:"))
+    mutt_env_materialize(env);
 }
 
 /**
@@ -724,3 +731,75 @@ void serial_restore_tags(TagList **tl, const unsigned char *d, int *off)
     counter--;
   }
 }
+
+/**
+ * serial_dump_summary - Pack a PartSummaryArray into a binary blob
+ * @param[in]     psa  PartSummaryArray to pack, may be NULL
+ * @param[in]     d    Binary blob to add to
+ * @param[in,out] off  Offset into the blob
+ * @retval ptr End of the newly packed binary
+ *
+ * A NULL summary, i.e. the MIME structure isn't known, is stored as zero parts.
+ */
+unsigned char *serial_dump_summary(const struct PartSummaryArray *psa,
+                                   unsigned char *d, int *off)
+{
+  d = serial_dump_int(psa ? ARRAY_SIZE(psa) : 0, d, off);
+  if (!psa)
+    return d;
+
+  const struct PartSummary *ps = NULL;
+  ARRAY_FOREACH(ps, psa)
+  {
+    // clang-format off
+    uint32_t packed = ps->type +
+                     (ps->encoding    <<  4) +
+                     (ps->disposition <<  7) +
+                     (ps->depth       <<  9) +
+                     (ps->flags       << 17);
+    // clang-format on
+    d = serial_dump_uint32_t(packed, d, off);
+    d = serial_dump_uint64_t(ps->length, d, off);
+    d = serial_dump_char(ps->subtype, d, off, false);
+  }
+
+  return d;
+}
+
+/**
+ * serial_restore_summary - Unpack a PartSummaryArray from a binary blob
+ * @param[out]    psa  Store the unpacked PartSummaryArray here
+ * @param[in]     d    Binary blob to read from
+ * @param[in,out] off  Offset into the blob
+ */
+void serial_restore_summary(struct PartSummaryArray **psa, const unsigned char *d, int *off)
+{
+  unsigned int counter = 0;
+  serial_restore_int(&counter, d, off);
+  if (counter == 0)
+    return;
+
+  *psa = g_new0(struct PartSummaryArray, 1);
+  ARRAY_RESERVE(*psa, counter);
+
+  while (counter)
+  {
+    uint32_t packed = 0;
+    uint64_t big = 0;
+    struct PartSummary ps = { 0 };
+
+    serial_restore_uint32_t(&packed, d, off);
+    ps.type        =  (packed        & ((1 << 4) - 1)); // bits 0-3 (4)
+    ps.encoding    = ((packed >>  4) & ((1 << 3) - 1)); // bits 4-6 (3)
+    ps.disposition = ((packed >>  7) & ((1 << 2) - 1)); // bits 7-8 (2)
+    ps.depth       = ((packed >>  9) & ((1 << 8) - 1)); // bits 9-16 (8)
+    ps.flags       = ((packed >> 17) & ((1 << 8) - 1)); // bits 17-24 (8)
+
+    serial_restore_uint64_t(&big, d, off);
+    ps.length = big;
+    serial_restore_char(&ps.subtype, d, off, false);
+
+    ARRAY_ADD(*psa, ps);
+    counter--;
+  }
+}
@@ -32,9 +32,11 @@
 struct Body;
 struct Buffer;
 struct Envelope;
+struct PartSummaryArray;
 
 unsigned char *serial_dump_address  (const AddressList *al,          unsigned char *d, int *off, bool convert);
 unsigned char *serial_dump_body     (const struct Body *b,           unsigned char *d, int *off, bool convert);
+unsigned char *serial_dump_summary  (const struct PartSummaryArray *psa, unsigned char *d, int *off);
 unsigned char *serial_dump_tags     (const TagList *tl,              unsigned char *d, int *off);
 unsigned char *serial_dump_buffer   (const struct Buffer *buf,       unsigned char *d, int *off, bool convert);
 unsigned char *serial_dump_char     (const char *c,                  unsigned char *d, int *off, bool convert);
@@ -47,6 +49,7 @@ unsigned char *serial_dump_parameter(const ParameterList *pl, unsigned char *d,
 
 void serial_restore_address  (AddressList *al,   const unsigned char *d, int *off, bool convert);
 void serial_restore_body     (struct Body *b,           const unsigned char *d, int *off, bool convert);
+void serial_restore_summary  (struct PartSummaryArray **psa, const unsigned char *d, int *off);
 void serial_restore_tags     (TagList **tl,             const unsigned char *d, int *off);
 void serial_restore_buffer   (struct Buffer *buf,       const unsigned char *d, int *off, bool convert);
 void serial_restore_char     (char **c,                 const unsigned char *d, int *off, bool convert);
@@ -1399,6 +1399,7 @@ void index_W(const struct ExpandoNode *node, void *data, MuttFormatFlags flags,
   if (!e || !e->env)
     return;
 
+  mutt_env_materialize(e->env);
   const char *s = e->env->organization;
   buf_strcpy(buf, s);
 }
@@ -1430,6 +1431,9 @@ long index_X_num(const struct ExpandoNode *node, void *data, MuttFormatFlags fla
 
   struct Mailbox *m = hfi->mailbox;
 
+  if (!mutt_count_needs_message(e))
+    return mutt_count_body_parts(m, e, NULL);
+
   struct Message *msg = mx_msg_open(m, e);
   if (!msg)
     return 0;
@@ -32,11 +32,21 @@
  * @page neo_hook Parse and execute user-defined hooks
  *
  * Parse and execute user-defined hooks
+ *
+ * Hooks are compiled when they're defined: the pattern is compiled and the
+ * Command to run is looked up.  They're indexed by type, so firing a hook only
+ * looks at the hooks of that type.
+ *
+ * The result of matching a hook's pattern against a mailbox's Email is
+ * remembered.  It's forgotten if the Email's flags change, or if anything that
+ * a pattern might depend on changes, e.g. config, a mailbox, or a command is
+ * run.  Patterns using relative dates, e.g. `~d<1d`, are always evaluated.
  */
 
 #include "config.h"
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include "mutt/lib.h"
@@ -72,18 +82,55 @@ struct Hook
   char *source_file;           ///< Used for relative-directory source
   PatternList *pattern;        ///< Used for fcc,save,send-hook
   struct Expando *expando;     ///< Used for format hooks
+  struct Command cmd;          ///< Command to run, looked up when the hook is defined
+  const char *args;            ///< Arguments of the Command, within Hook.command
+  bool dynamic;                ///< Pattern depends on the time, e.g. `~d<1d`
+  struct HashTable *memo;      ///< Remembered matches, Email.sequence -> HookMemo
+  unsigned int memo_gen;       ///< Value of HookGen when the memo was started
 };
 typedef GSList HookList;
+ARRAY_HEAD(HookArray, struct Hook *);
+
+/**
+ * struct HookMemo - Remembered result of matching a Hook against an Email
+ */
+struct HookMemo
+{
+  uint32_t flags;         ///< Email's flags when matched, see email_flags()
+  int score;              ///< Email's score when matched
+  SecurityFlags security; ///< Email's security when matched
+  bool match;             ///< Did the pattern match?
+};
+
+/// Number of #HookFlags bits
+#define HOOK_NUM_TYPES 20
+
+/// Forget a Hook's matches once it has remembered this many
+#define HOOK_MEMO_MAX 4096
 
 /// All simple hooks, e.g. MUTT_FOLDER_HOOK
 static HookList *Hooks = NULL;
 
+/// Simple hooks, indexed by the bit number of their types
+static struct HookArray HooksByType[HOOK_NUM_TYPES];
+
+/// Changes when a remembered match may no longer be valid
+static unsigned int HookGen = 0;
+
 /// All Index Format hooks
 static struct HashTable *IdxFmtHooks = NULL;
 
 /// The type of the hook currently being executed, e.g. #MUTT_SAVE_HOOK
 static HookFlags CurrentHookType = MUTT_HOOK_NO_FLAGS;
 
+/**
+ * hook_memo_free - Free a remembered match - Implements ::hash_hdata_free_t - @ingroup hash_hdata_free_api
+ */
+static void hook_memo_free(int type, void *obj, intptr_t data)
+{
+  FREE(&obj);
+}
+
 /**
  * hook_free - Free a Hook
  * @param ptr Hook to free
@@ -105,6 +152,7 @@ static void hook_free(struct Hook **ptr)
   }
   mutt_patternlist_free_full(h->pattern);
   expando_free(&h->expando);
+  mutt_hash_free(&h->memo);
   FREE(ptr);
 }
 
@@ -117,6 +165,177 @@ static struct Hook *hook_new(void)
   return g_new0(struct Hook, 1);
 }
 
+/**
+ * hook_compile_command - Look up the Command a Hook will run
+ * @param hook Hook
+ *
+ * If the Hook's command starts with a plain name, the Command is looked up
+ * once, now.  Otherwise, e.g. `$my_cmd`, the line is parsed when it's run.
+ */
+static void hook_compile_command(struct Hook *hook)
+{
+  memset(&hook->cmd, 0, sizeof(hook->cmd));
+  hook->args = NULL;
+
+  const char *name = hook->command;
+  if (!name)
+    return;
+
+  SKIPWS(name);
+  size_t len = strspn(name, "abcdefghijklmnopqrstuvwxyz0123456789-_");
+  if ((len == 0) || ((name[len] != '\0') && !isspace((unsigned char) name[len])))
+    return;
+
+  char *cmd_name = g_strndup(name, len);
+  const struct Command *cmd = command_get(cmd_name);
+  FREE(&cmd_name);
+  if (!cmd)
+    return;
+
+  hook->cmd = *cmd;
+  hook->args = name + len;
+  SKIPWS(hook->args);
+}
+
+/**
+ * hook_exec - Run a Hook's command
+ * @param hook Hook
+ * @param err  Buffer for error messages
+ * @retval #CommandResult Result e.g. #MUTT_CMD_SUCCESS
+ */
+static enum CommandResult hook_exec(const struct Hook *hook, struct Buffer *err)
+{
+  if (hook->cmd.parse)
+    return parse_rc_command_cwd(&hook->cmd, hook->args, hook->source_file, err);
+
+  return parse_rc_line_cwd(hook->command, hook->source_file, err);
+}
+
+/**
+ * pattern_is_dynamic - Does a pattern depend on the current time?
+ * @param pat Pattern to check
+ * @retval true Part of the pattern is evaluated relative to "now"
+ */
+static bool pattern_is_dynamic(const PatternList *pat)
+{
+  for (const GSList *np = pat; np != NULL; np = np->next)
+  {
+    const struct Pattern *p = np->data;
+    if (p->dynamic || pattern_is_dynamic(p->child))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * email_flags - Pack the flags of an Email that a pattern may check
+ * @param e Email
+ * @retval num Flags
+ */
+static uint32_t email_flags(const struct Email *e)
+{
+  return (e->expired << 0) | (e->flagged << 1) | (e->old << 2) | (e->read << 3) |
+         (e->replied << 4) | (e->superseded << 5) | (e->trash << 6) |
+         (e->deleted << 7) | (e->purge << 8) | (e->tagged << 9) |
+         (e->collapsed << 10) | (e->attach_valid << 11) | (e->changed << 12);
+}
+
+/**
+ * hook_match - Does a Hook's pattern match an Email?
+ * @param hook  Hook with a pattern
+ * @param m     Mailbox
+ * @param e     Email
+ * @param cache Cache for the pattern functions
+ * @param memo  Remember the result; the Email belongs to a Mailbox
+ * @retval true The pattern matches
+ *
+ * Emails that are being composed can change at any time, so their results
+ * mustn't be remembered.
+ */
+static bool hook_match(struct Hook *hook, struct Mailbox *m, struct Email *e,
+                       struct PatternCache *cache, bool memo)
+{
+  if (!memo || !e || hook->dynamic)
+  {
+    return (mutt_pattern_exec(hook->pattern->data, 0, m, e, cache) > 0) ^
+           hook->regex.pat_not;
+  }
+
+  if (hook->memo && ((hook->memo_gen != HookGen) || (hook->memo->count >= HOOK_MEMO_MAX)))
+    mutt_hash_free(&hook->memo);
+
+  if (!hook->memo)
+  {
+    hook->memo = mutt_hash_int_new(64, MUTT_HASH_NO_FLAGS);
+    mutt_hash_set_destructor(hook->memo, hook_memo_free, 0);
+    hook->memo_gen = HookGen;
+  }
+
+  const uint32_t flags = email_flags(e);
+  struct HookMemo *hm = mutt_hash_int_find(hook->memo, e->sequence);
+  if (hm && (hm->flags == flags) && (hm->score == e->score) && (hm->security == e->security))
+    return hm->match;
+
+  bool match = (mutt_pattern_exec(hook->pattern->data, 0, m, e, cache) > 0) ^
+               hook->regex.pat_not;
+
+  if (!hm)
+  {
+    hm = g_new0(struct HookMemo, 1);
+    mutt_hash_int_insert(hook->memo, e->sequence, hm);
+  }
+  hm->flags = flags;
+  hm->score = e->score;
+  hm->security = e->security;
+  hm->match = match;
+
+  return match;
+}
+
+/**
+ * hooks_by_type - Get the simple hooks of one type
+ * @param type Hook type, a single bit, e.g. #MUTT_SAVE_HOOK
+ * @retval ptr Hooks, in the order they were defined
+ *
+ * A hook's commands may define more hooks, which can move the array, so look
+ * up each Hook by index while running them.
+ */
+static struct HookArray *hooks_by_type(HookFlags type)
+{
+  for (int i = 0; i < HOOK_NUM_TYPES; i++)
+  {
+    if (type & (1U << i))
+      return &HooksByType[i];
+  }
+
+  return &HooksByType[0];
+}
+
+/**
+ * hook_index_add - Add a Hook to the index of its types
+ * @param hook Hook to add
+ */
+static void hook_index_add(struct Hook *hook)
+{
+  for (int i = 0; i < HOOK_NUM_TYPES; i++)
+  {
+    if (hook->type & (1U << i))
+      ARRAY_ADD(&HooksByType[i], hook);
+  }
+}
+
+/**
+ * hook_index_rebuild - Rebuild the index of the Hooks by type
+ */
+static void hook_index_rebuild(void)
+{
+  for (int i = 0; i < HOOK_NUM_TYPES; i++)
+    ARRAY_FREE(&HooksByType[i]);
+
+  for (GSList *np = Hooks; np != NULL; np = np->next)
+    hook_index_add(np->data);
+}
+
 /**
  * mutt_parse_charset_iconv_hook - Parse 'charset-hook' and 'iconv-hook' commands - Implements Command::parse() - @ingroup command_parse
  */
@@ -319,8 +538,10 @@ enum CommandResult mutt_parse_hook(struct Buffer *buf, struct Buffer *s,
          * a common action to perform is to change the default (.) entry
          * based upon some other information. */
         FREE(&hook->command);
+        FREE(&hook->source_file);
         hook->command = buf_strdup(cmd);
         hook->source_file = mutt_get_sourced_cwd();
+        hook_compile_command(hook);
         rc = MUTT_CMD_SUCCESS;
         goto cleanup;
       }
@@ -371,8 +592,11 @@ enum CommandResult mutt_parse_hook(struct Buffer *buf, struct Buffer *s,
   hook->regex.regex = rx;
   hook->regex.pat_not = pat_not;
   hook->expando = exp;
+  hook->dynamic = pattern_is_dynamic(pat);
+  hook_compile_command(hook);
 
   Hooks = g_slist_append(Hooks, hook);
+  hook_index_add(hook);
   rc = MUTT_CMD_SUCCESS;
 
 cleanup:
@@ -400,6 +624,8 @@ void mutt_delete_hooks(HookFlags type)
     }
     np = next;
   }
+
+  hook_index_rebuild();
 }
 
 /**
@@ -519,6 +745,7 @@ static enum CommandResult mutt_parse_idxfmt_hook(struct Buffer *buf, struct Buff
   hook->regex.regex = NULL;
   hook->regex.pat_not = pat_not;
   hook->expando = exp;
+  hook->dynamic = pattern_is_dynamic(pat);
   exp = NULL;
 
   hl = g_slist_append(hl, hook);
@@ -618,15 +845,13 @@ void mutt_folder_hook(const char *path, const char *desc)
 
   CurrentHookType = MUTT_FOLDER_HOOK;
 
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  struct HookArray *ha = hooks_by_type(MUTT_FOLDER_HOOK);
+  for (size_t i = 0; i < ARRAY_SIZE(ha); i++)
   {
-    struct Hook *hook = np->data;
+    struct Hook *hook = *ARRAY_GET(ha, i);
     if (!hook->command)
       continue;
 
-    if (!(hook->type & MUTT_FOLDER_HOOK))
-      continue;
-
     const char *match = NULL;
     if (mutt_regex_match(&hook->regex, path))
       match = path;
@@ -637,7 +862,7 @@ void mutt_folder_hook(const char *path, const char *desc)
     {
       log_debug1("folder-hook '%s' matches '%s'", hook->regex.pattern, match);
       log_debug5("    %s", hook->command);
-      if (parse_rc_line_cwd(hook->command, hook->source_file, err) == MUTT_CMD_ERROR)
+      if (hook_exec(hook, err) == MUTT_CMD_ERROR)
       {
         log_fault("%s", buf_string(err));
         break;
@@ -659,15 +884,12 @@ void mutt_folder_hook(const char *path, const char *desc)
  */
 char *mutt_find_hook(HookFlags type, const char *pat)
 {
-
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  struct Hook **hp = NULL;
+  ARRAY_FOREACH(hp, hooks_by_type(type))
   {
-    struct Hook *tmp = np->data;
-    if (tmp->type & type)
-    {
-      if (mutt_regex_match(&tmp->regex, pat))
-        return tmp->command;
-    }
+    struct Hook *tmp = *hp;
+    if (mutt_regex_match(&tmp->regex, pat))
+      return tmp->command;
   }
   return NULL;
 }
@@ -685,29 +907,30 @@ void mutt_message_hook(struct Mailbox *m, struct Email *e, HookFlags type)
 
   CurrentHookType = type;
 
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  /* Only the message-hook is run on an Email in a Mailbox,
+   * the others are run on an Email that's being composed */
+  const bool memo = (type == MUTT_MESSAGE_HOOK);
+
+  struct HookArray *ha = hooks_by_type(type);
+  for (size_t i = 0; i < ARRAY_SIZE(ha); i++)
   {
-    struct Hook *hook = np->data;
+    struct Hook *hook = *ARRAY_GET(ha, i);
     if (!hook->command)
       continue;
 
-    if (hook->type & type)
+    if (hook_match(hook, m, e, &cache, memo))
     {
-      if ((mutt_pattern_exec(hook->pattern->data, 0, m, e, &cache) > 0) ^
-          hook->regex.pat_not)
+      if (hook_exec(hook, err) == MUTT_CMD_ERROR)
       {
-        if (parse_rc_line_cwd(hook->command, hook->source_file, err) == MUTT_CMD_ERROR)
-        {
-          log_fault("%s", buf_string(err));
-          CurrentHookType = MUTT_HOOK_NO_FLAGS;
-          buf_pool_release(&err);
+        log_fault("%s", buf_string(err));
+        CurrentHookType = MUTT_HOOK_NO_FLAGS;
+        buf_pool_release(&err);
 
-          return;
-        }
-        /* Executing arbitrary commands could affect the pattern results,
-         * so the cache has to be wiped */
-        memset(&cache, 0, sizeof(cache));
+        return;
       }
+      /* Executing arbitrary commands could affect the pattern results,
+       * so the cache has to be wiped */
+      memset(&cache, 0, sizeof(cache));
     }
   }
   buf_pool_release(&err);
@@ -728,23 +951,24 @@ static int addr_hook(struct Buffer *path, HookFlags type, struct Mailbox *m, str
 {
   struct PatternCache cache = { 0 };
 
+  /* The save-hook is run on an Email in a Mailbox,
+   * the fcc-hook on an Email that's being composed */
+  const bool memo = (type == MUTT_SAVE_HOOK);
+
   /* determine if a matching hook exists */
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  struct Hook **hp = NULL;
+  ARRAY_FOREACH(hp, hooks_by_type(type))
   {
-    struct Hook *hook = np->data;
+    struct Hook *hook = *hp;
     if (!hook->command)
       continue;
 
-    if (hook->type & type)
+    if (hook_match(hook, m, e, &cache, memo))
     {
-      if ((mutt_pattern_exec(hook->pattern->data, 0, m, e, &cache) > 0) ^
-          hook->regex.pat_not)
-      {
-        buf_alloc(path, PATH_MAX);
-        mutt_make_string(path, -1, hook->expando, m, -1, e, MUTT_FORMAT_PLAIN, NULL);
-        buf_fix_dptr(path);
-        return 0;
-      }
+      buf_alloc(path, PATH_MAX);
+      mutt_make_string(path, -1, hook->expando, m, -1, e, MUTT_FORMAT_PLAIN, NULL);
+      buf_fix_dptr(path);
+      return 0;
     }
   }
 
@@ -838,11 +1062,11 @@ void mutt_select_fcc(struct Buffer *path, struct Email *e)
  */
 static void list_hook(GSList **matches, const char *match, HookFlags type)
 {
-  struct Hook *tmp = NULL;
-
-  for (GSList *np = *matches; np != NULL; np = np->next)
+  struct Hook **hp = NULL;
+  ARRAY_FOREACH(hp, hooks_by_type(type))
   {
-    if ((tmp->type & type) && mutt_regex_match(&tmp->regex, match))
+    struct Hook *tmp = *hp;
+    if (mutt_regex_match(&tmp->regex, match))
     {
       *matches = g_slist_append(*matches, mutt_str_dup(tmp->command));
     }
@@ -876,10 +1100,11 @@ void mutt_account_hook(const char *url)
 
   struct Buffer *err = buf_pool_get();
 
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  struct HookArray *ha = hooks_by_type(MUTT_ACCOUNT_HOOK);
+  for (size_t i = 0; i < ARRAY_SIZE(ha); i++)
   {
-    struct Hook *hook = np->data;
-    if (!(hook->command && (hook->type & MUTT_ACCOUNT_HOOK)))
+    struct Hook *hook = *ARRAY_GET(ha, i);
+    if (!hook->command)
       continue;
 
     if (mutt_regex_match(&hook->regex, url))
@@ -888,7 +1113,7 @@ void mutt_account_hook(const char *url)
       log_debug1("account-hook '%s' matches '%s'", hook->regex.pattern, url);
       log_debug5("    %s", hook->command);
 
-      if (parse_rc_line_cwd(hook->command, hook->source_file, err) == MUTT_CMD_ERROR)
+      if (hook_exec(hook, err) == MUTT_CMD_ERROR)
       {
         log_fault("%s", buf_string(err));
         buf_pool_release(&err);
@@ -914,13 +1139,14 @@ void mutt_timeout_hook(void)
 {
   struct Buffer *err = buf_pool_get();
 
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  struct HookArray *ha = hooks_by_type(MUTT_TIMEOUT_HOOK);
+  for (size_t i = 0; i < ARRAY_SIZE(ha); i++)
   {
-    struct Hook *hook = np->data;
-    if (!(hook->command && (hook->type & MUTT_TIMEOUT_HOOK)))
+    struct Hook *hook = *ARRAY_GET(ha, i);
+    if (!hook->command)
       continue;
 
-    if (parse_rc_line_cwd(hook->command, hook->source_file, err) == MUTT_CMD_ERROR)
+    if (hook_exec(hook, err) == MUTT_CMD_ERROR)
     {
       log_fault("%s", buf_string(err));
       buf_reset(err);
@@ -946,13 +1172,14 @@ void mutt_startup_shutdown_hook(HookFlags type)
 {
   struct Buffer *err = buf_pool_get();
 
-  for (GSList *np = Hooks; np != NULL; np = np->next)
+  struct HookArray *ha = hooks_by_type(type);
+  for (size_t i = 0; i < ARRAY_SIZE(ha); i++)
   {
-    struct Hook *hook = np->data;
-    if (!(hook->command && (hook->type & type)))
+    struct Hook *hook = *ARRAY_GET(ha, i);
+    if (!hook->command)
       continue;
 
-    if (parse_rc_line_cwd(hook->command, hook->source_file, err) == MUTT_CMD_ERROR)
+    if (hook_exec(hook, err) == MUTT_CMD_ERROR)
     {
       log_fault("%s", buf_string(err));
       buf_reset(err);
@@ -986,8 +1213,7 @@ const struct Expando *mutt_idxfmt_hook(const char *name, struct Mailbox *m, stru
   for (GSList *np = hl; np != NULL; np = np->next)
   {
     struct Hook *hook = np->data;
-    struct Pattern *pat = hook->pattern->data;
-    if ((mutt_pattern_exec(pat, 0, m, e, &cache) > 0) ^ hook->regex.pat_not)
+    if (hook_match(hook, m, e, &cache, true))
     {
       exp = hook->expando;
       break;
@@ -1026,10 +1252,95 @@ static const struct Command HookCommands[] = {
   // clang-format on
 };
 
+/**
+ * hook_affects_patterns - Can a Command or Config change a pattern's result?
+ * @param name Name of the Command or Config variable
+ * @param list Names that matter
+ * @param num  Number of names
+ * @retval true The name is in the list
+ */
+static bool hook_affects_patterns(const char *name, const char *const *list, size_t num)
+{
+  for (size_t i = 0; i < num; i++)
+  {
+    if (mutt_str_equal(name, list[i]))
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * hook_observer - Notification that a pattern's result may have changed - Implements ::observer_t - @ingroup observer_api
+ *
+ * Forget the remembered results of matching the hooks' patterns.
+ *
+ * Hooks run commands all the time, e.g. `set`, so only the Commands and Config
+ * that patterns depend on count.  Aliases, alternates and scores have their
+ * own notifications.
+ */
+static int hook_observer(struct NotifyCallback *nc)
+{
+  // Commands that change the lists, groups and attachment counts
+  static const char *const Commands[] = {
+    "attachments", "group",   "lists",       "subscribe",
+    "unattachments", "ungroup", "unlists",   "unsubscribe",
+  };
+
+  // Config read while matching, e.g. by mutt_addr_is_user()
+  static const char *const Configs[] = {
+    "count_alternatives", "external_search_command", "from",
+    "hostname",           "thorough_search",         "use_domain",
+  };
+
+  switch (nc->event_type)
+  {
+    case NT_COMMAND:
+    {
+      // The event is an array of Commands and an index into it
+      const struct Command *cmd = nc->event_data;
+      if (cmd && hook_affects_patterns(cmd[nc->event_subtype].name, Commands,
+                                       mutt_array_size(Commands)))
+      {
+        HookGen++;
+      }
+      break;
+    }
+    case NT_CONFIG:
+    {
+      const struct EventConfig *ev_c = nc->event_data;
+      if (ev_c && hook_affects_patterns(ev_c->name, Configs, mutt_array_size(Configs)))
+        HookGen++;
+      break;
+    }
+    case NT_ALIAS:
+    case NT_ALTERN:
+    case NT_MAILBOX:
+    case NT_SCORE:
+      HookGen++;
+      break;
+    default:
+      break;
+  }
+
+  return 0;
+}
+
 /**
  * hooks_init - Setup feature commands
  */
 void hooks_init(void)
 {
   commands_register(HookCommands, mutt_array_size(HookCommands));
+  notify_observer_add(SpaceMutt->notify, NT_ALL, hook_observer, NULL);
+}
+
+/**
+ * hooks_cleanup - Free all the hooks
+ */
+void hooks_cleanup(void)
+{
+  notify_observer_remove(SpaceMutt->notify, hook_observer, NULL);
+  mutt_delete_hooks(MUTT_HOOK_NO_FLAGS);
+  delete_idxfmt_hooks();
 }
@@ -131,6 +131,23 @@ static struct ImapCommand *cmd_new(struct ImapAccountData *adata)
   return cmd;
 }
 
+/**
+ * cmd_trace_name - Get the name of a command for the trace
+ * @param cmd    Command being traced
+ * @param cmdstr Command string
+ *
+ * Only the command name is kept, e.g. "FETCH" or "UID STORE", so that no
+ * credentials end up in the trace.
+ */
+static void cmd_trace_name(struct ImapCommand *cmd, const char *cmdstr)
+{
+  size_t len = strcspn(cmdstr, " ");
+  if (mutt_istrn_equal(cmdstr, "UID ", 4))
+    len = 4 + strcspn(cmdstr + 4, " ");
+
+  mutt_strn_copy(cmd->name, cmdstr, MIN(len, sizeof(cmd->name) - 1), sizeof(cmd->name));
+}
+
 /**
  * cmd_queue - Add a IMAP command to the queue
  * @param adata Imap Account data
@@ -160,6 +177,12 @@ static int cmd_queue(struct ImapAccountData *adata, const char *cmdstr, ImapCmdF
   if (buf_add_printf(&adata->cmdbuf, "%s %s\r\n", cmd->seq, cmdstr) < 0)
     return IMAP_RES_BAD;
 
+  if (TraceEnabled)
+  {
+    cmd_trace_name(cmd, cmdstr);
+    trace_begin_async(&cmd->span, "imap", "imap_command");
+  }
+
   return 0;
 }
 
@@ -1219,6 +1242,7 @@ int imap_cmd_step(struct ImapAccountData *adata)
           adata->lastcmd = (adata->lastcmd + 1) % adata->cmdslots;
         }
         cmd->state = cmd_status(adata->buf);
+        trace_end(&cmd->span, cmd->name);
         rc = cmd->state;
         if (cmd->state == IMAP_RES_NO || cmd->state == IMAP_RES_BAD)
         {
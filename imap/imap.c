@@ -2421,6 +2421,7 @@ const struct MxOps MxImapOps = {
   .msg_close        = imap_msg_close,
   .msg_padding_size = NULL,
   .msg_save_hcache  = imap_msg_save_hcache,
+  .mbox_hcache_gc   = imap_mbox_hcache_gc,
   .tags_edit        = imap_tags_edit,
   .tags_commit      = imap_tags_commit,
   .path_probe       = imap_path_probe,
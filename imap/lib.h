@@ -67,6 +67,7 @@ struct Buffer;
 struct ConnAccount;
 struct Email;
 struct EmailArray;
+struct Pattern;
 struct stat;
 
 /* imap.c */
@@ -110,6 +111,7 @@ void imap_get_parent_path(const char *path, char *buf, size_t buflen);
 void imap_clean_path(char *path, size_t plen);
 
 /* search.c */
-bool imap_search(struct Mailbox *m, const PatternList *pat);
+bool imap_search(struct Mailbox *m, PatternList *pat);
+int imap_search_match(struct Mailbox *m, const struct Pattern *pat, struct Email *e);
 
 #endif /* MUTT_IMAP_LIB_H */
@@ -46,6 +46,7 @@ void imap_mdata_free(void **ptr)
   struct ImapMboxData *mdata = *ptr;
 
   imap_mdata_cache_reset(mdata);
+  imap_search_free(mdata, true);
   g_slist_free_full(g_steal_pointer(&mdata->flags), g_free);
   FREE(&mdata->name);
   FREE(&mdata->real_name);
@@ -29,8 +29,10 @@
 #include "private.h"
 #include "mutt/lib.h"
 
-struct Mailbox;
 struct ImapAccountData;
+struct ImapSearchLeaf;
+struct Mailbox;
+struct UidArray;
 
 /**
  * struct ImapMboxData - IMAP-specific Mailbox data - @extends Mailbox
@@ -63,6 +65,11 @@ struct ImapMboxData
 
   struct HeaderCache *hcache; ///< Email header cache
   struct timespec mtime;      ///< Time Mailbox was last changed
+
+  // Server-side searches, see imap_search()
+  ARRAY_HEAD(ImapSearchLeafArray, struct ImapSearchLeaf *) search_leaves; ///< Results of the last imap_search()
+  struct HashTable *search_cache; ///< Cached results: query -> ImapSearchCache
+  struct UidArray *search_uids;   ///< UIDs from the SEARCH that's running
 };
 
 void                 imap_mdata_free(void **ptr);
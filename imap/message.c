@@ -1111,6 +1111,9 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
   if (!adata || (adata->mailbox != m))
     return -1;
 
+  /* New mail stays out of the Arena, see imap_read_headers() */
+  struct Arena *arena = initial_download ? mailbox_arena(m) : NULL;
+
   struct Buffer *hdr_list = buf_pool_get();
   buf_strcpy(hdr_list, want_headers);
   const char *const c_imap_headers = cs_subset_string(SpaceMutt->sub, "imap_headers");
@@ -1244,7 +1247,7 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
 
       progress_update(progress, msgno++, -1);
 
-      struct Email *e = email_new();
+      struct Email *e = email_new_arena(arena);
       mx_alloc_memory(m, m->msg_count);
 
       m->emails[m->msg_count++] = e;
@@ -1278,7 +1281,7 @@ static int read_headers_fetch_new(struct Mailbox *m, unsigned int msn_begin,
       rewind(fp);
       /* NOTE: if Date: header is missing, mutt_rfc822_read_header depends
        *   on h.received being set */
-      e->env = mutt_rfc822_read_header(fp, e, false, false);
+      e->env = mutt_rfc822_read_header_lazy(fp, e, arena);
       /* body built as a side-effect of mutt_rfc822_read_header */
       e->body->length = h.content_length;
       mailbox_size_add(m, e);
@@ -1375,6 +1378,10 @@ retry:
 
 #ifdef USE_HCACHE
   imap_hcache_open(adata, mdata, true);
+  /* Only the initial download goes in the Arena.  New mail may replace
+   * Emails, whose memory the Arena couldn't reuse. */
+  if (mdata->hcache)
+    mdata->hcache->arena = initial_download ? mailbox_arena(m) : NULL;
 
   if (mdata->hcache && initial_download)
   {
@@ -2208,3 +2215,48 @@ int imap_msg_save_hcache(struct Mailbox *m, struct Email *e)
 #endif
   return rc;
 }
+
+/**
+ * imap_mbox_hcache_gc - Remove stale entries from the header cache - Implements MxOps::mbox_hcache_gc() - @ingroup mx_mbox_hcache_gc
+ */
+int imap_mbox_hcache_gc(struct Mailbox *m, bool force)
+{
+  int rc = -1;
+#ifdef USE_HCACHE
+  static const char *const raw_keys[] = { "UIDVALIDITY", "UIDNEXT", "MODSEQ", "UIDSEQSET", NULL };
+
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  if (!mdata || !adata)
+    return -1;
+
+  bool close_hc = true;
+  if (mdata->hcache)
+    close_hc = false;
+  else
+    imap_hcache_open(adata, mdata, false);
+
+  if (mdata->hcache && (force || hcache_gc_due(mdata->hcache)))
+  {
+    struct HashTable *live = mutt_hash_new(MAX(m->msg_count, 32), MUTT_HASH_STRDUP_KEYS);
+    char key[16] = { 0 };
+    for (int i = 0; i < m->msg_count; i++)
+    {
+      struct Email *e = m->emails[i];
+      struct ImapEmailData *edata = e ? imap_edata_get(e) : NULL;
+      if (!edata)
+        continue;
+
+      snprintf(key, sizeof(key), "%u", edata->uid);
+      mutt_hash_insert(live, key, e);
+    }
+
+    rc = hcache_gc(mdata->hcache, live, raw_keys);
+    mutt_hash_free(&live);
+  }
+
+  if (close_hc)
+    imap_hcache_close(mdata);
+#endif
+  return rc;
+}
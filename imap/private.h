@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <glib.h>
+#include "mutt/lib.h"
 #include "config/lib.h"
 
 struct Buffer;
@@ -159,6 +160,8 @@ struct ImapCommand
 {
   char seq[SEQ_LEN + 1]; ///< Command tag, e.g. 'a0001'
   int state;            ///< Command state, e.g. #IMAP_RES_NEW
+  struct TraceSpan span; ///< Time from sending the command to its completion
+  char name[16];        ///< Command name for the trace, e.g. 'FETCH'
 };
 
 /**
@@ -212,6 +215,7 @@ bool imap_msg_open(struct Mailbox *m, struct Message *msg, struct Email *e);
 int imap_msg_close(struct Mailbox *m, struct Message *msg);
 int imap_msg_commit(struct Mailbox *m, struct Message *msg);
 int imap_msg_save_hcache(struct Mailbox *m, struct Email *e);
+int imap_mbox_hcache_gc(struct Mailbox *m, bool force);
 
 /* util.c */
 #ifdef USE_HCACHE
@@ -254,5 +258,6 @@ void imap_disallow_reopen(struct Mailbox *m);
 
 /* search.c */
 void cmd_parse_search(struct ImapAccountData *adata, const char *s);
+void imap_search_free(struct ImapMboxData *mdata, bool all);
 
 #endif /* MUTT_IMAP_PRIVATE_H */
@@ -25,52 +25,175 @@
  * @page imap_search Search routines
  *
  * IMAP search routines
+ *
+ * Patterns that need the body of an Email (`~b`, `~B`, `~h` and `=/`) are
+ * expensive to evaluate locally, because every message has to be downloaded.
+ * Each of these leaves is sent to the server as a separate `UID SEARCH`.
+ *
+ * The server can't evaluate regexes, so a regex leaf is searched for its
+ * literal text, see mutt_regex_literal().  Its result is a superset, which is
+ * checked locally.  Case-sensitive string matches are treated the same way.
+ *
+ * Cheap patterns (dates, sizes, flags, addresses and subjects) are never
+ * searched on their own, but when they're ANDed with an expensive leaf they're
+ * added to its query to narrow the result.  The translation is always a
+ * superset of the local pattern, e.g. dates are widened by a day to cover
+ * time zones, so anything that falls outside the narrowed query is decided by
+ * the cheap pattern alone.
+ *
+ * The results are cached in the Mailbox, keyed by the query.  Emails don't
+ * change, so a result remains valid until the UIDVALIDITY changes; new Emails
+ * are searched for incrementally.  Queries with flags are also keyed by the
+ * MODSEQ.  Local flag changes can make these results stale, so any Email whose
+ * flags now match the query is evaluated locally.
  */
 
 #include "config.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include "private.h"
 #include "mutt/lib.h"
 #include "email/lib.h"
 #include "core/lib.h"
+#include "mutt.h"
 #include "lib.h"
 #include "pattern/lib.h"
 #include "adata.h"
+#include "edata.h"
 #include "mdata.h"
+#include "msg_set.h"
+
+/// Maximum number of SEARCH results cached for a Mailbox
+#define IMAP_SEARCH_CACHE_MAX 64
+
+/// Shortest regex literal that's worth sending to the server
+#define IMAP_SEARCH_LITERAL_MIN 3
+
+typedef uint8_t ImapSearchFlags;      ///< Flags used to narrow a search, e.g. #IMAP_SEARCH_SEEN
+#define IMAP_SEARCH_NO_FLAGS       0  ///< No flags are set
+#define IMAP_SEARCH_SEEN     (1 << 0) ///< Email has been read
+#define IMAP_SEARCH_ANSWERED (1 << 1) ///< Email has been replied to
+#define IMAP_SEARCH_FLAGGED  (1 << 2) ///< Email has been flagged
+#define IMAP_SEARCH_DELETED  (1 << 3) ///< Email has been deleted
+
+/**
+ * enum ImapSearchKind - How well the server can evaluate a Pattern
+ */
+enum ImapSearchKind
+{
+  IMAP_SEARCH_LOCAL,    ///< Evaluate the Pattern locally
+  IMAP_SEARCH_EXACT,    ///< The server's result is the answer
+  IMAP_SEARCH_SUPERSET, ///< The server's result must be checked locally
+};
+
+/**
+ * struct ImapSearchNarrow - Cheap Patterns that narrow a search
+ */
+struct ImapSearchNarrow
+{
+  struct Buffer *query;  ///< Search keys, each followed by a space
+  ImapSearchFlags set;   ///< Flags the Email must have
+  ImapSearchFlags unset; ///< Flags the Email mustn't have
+};
+
+/**
+ * struct ImapSearchCache - Cached result of a SEARCH
+ */
+struct ImapSearchCache
+{
+  uint32_t uidvalidity;      ///< UIDVALIDITY of the Mailbox
+  unsigned long long modseq; ///< MODSEQ of the Mailbox, if the query uses flags
+  unsigned int uid_high;     ///< Highest UID that has been searched
+  struct UidArray uids;      ///< Sorted UIDs of the matching Emails
+};
+
+/**
+ * struct ImapSearchLeaf - Server's result for one Pattern
+ */
+struct ImapSearchLeaf
+{
+  const struct Pattern *pat; ///< Pattern that was searched for
+  bool exact;                ///< Result doesn't need checking locally
+  ImapSearchFlags set;       ///< Flags the query required
+  ImapSearchFlags unset;     ///< Flags the query excluded
+  unsigned int uid_high;     ///< Highest UID that was searched
+  struct UidArray uids;      ///< Sorted UIDs of the matching Emails
+};
 
 // fwd decl, mutually recursive: check_pattern_list, check_pattern
 static int check_pattern_list(const PatternList *patterns);
 
-// fwd-decl, mutually recursive: compile_search, compile_search_children
-static bool compile_search(const struct ImapAccountData *adata,
-                           const struct Pattern *pat, struct Buffer *buf);
+/**
+ * search_literal_ok - Can this text be sent to the server?
+ * @param str    Text to search for
+ * @param min    Minimum length
+ * @param reject Characters that mustn't occur, or NULL
+ * @retval true The text is printable ASCII and long enough
+ *
+ * Servers disagree about non-ASCII searches without a CHARSET, so they're
+ * left to the client.
+ */
+static bool search_literal_ok(const char *str, size_t min, const char *reject)
+{
+  if (!str || (strlen(str) < min))
+    return false;
+
+  for (const char *p = str; *p; p++)
+  {
+    if ((*p < ' ') || (*p > '~'))
+      return false;
+    if (reject && strchr(reject, *p))
+      return false;
+  }
+
+  return true;
+}
 
 /**
- * check_pattern - Check whether a pattern can be searched server-side
+ * search_kind - How well can the server evaluate a Pattern?
  * @param pat Pattern to check
- * @retval true  Pattern can be searched server-side
- * @retval false Pattern cannot be searched server-side
+ * @retval enum #ImapSearchKind
+ *
+ * IMAP SEARCH is case-insensitive, so only a case-insensitive string match
+ * is exact.
  */
-static bool check_pattern(const struct Pattern *pat)
+static enum ImapSearchKind search_kind(const struct Pattern *pat)
 {
+  if (pat->child || pat->sendmode)
+    return IMAP_SEARCH_LOCAL;
+
   switch (pat->op)
   {
     case MUTT_PAT_BODY:
     case MUTT_PAT_HEADER:
     case MUTT_PAT_WHOLE_MSG:
       if (pat->string_match)
-        return true;
+        return pat->ign_case ? IMAP_SEARCH_EXACT : IMAP_SEARCH_SUPERSET;
+      if (!pat->group_match && search_literal_ok(pat->literal, IMAP_SEARCH_LITERAL_MIN, NULL))
+        return IMAP_SEARCH_SUPERSET;
       break;
     case MUTT_PAT_SERVERSEARCH:
-      return true;
-      break;
-    default:
-      if (pat->child && check_pattern_list(pat->child))
-        return true;
+      if (pat->string_match)
+        return IMAP_SEARCH_EXACT;
       break;
   }
-  return false;
+  return IMAP_SEARCH_LOCAL;
+}
+
+/**
+ * check_pattern - Check whether a pattern can be searched server-side
+ * @param pat Pattern to check
+ * @retval true  Pattern can be searched server-side
+ * @retval false Pattern cannot be searched server-side
+ */
+static bool check_pattern(const struct Pattern *pat)
+{
+  if (pat->child)
+    return check_pattern_list(pat->child) > 0;
+
+  return search_kind(pat) != IMAP_SEARCH_LOCAL;
 }
 
 /**
@@ -91,45 +214,6 @@ static int check_pattern_list(const PatternList *patterns)
   return positives;
 }
 
-/**
- * compile_search_children - Compile a search command for a pattern's children
- * @param adata Imap Account data
- * @param pat Parent pattern
- * @param buf Buffer for the resulting command
- * @retval true  Success
- * @retval false Failure
- */
-static bool compile_search_children(const struct ImapAccountData *adata,
-                                    const struct Pattern *pat, struct Buffer *buf)
-{
-  int clauses = check_pattern_list(pat->child);
-  if (clauses == 0)
-    return true;
-
-  buf_addch(buf, '(');
-
-  for (GSList *np = pat->child; np != NULL; np = np->next)
-  {
-    struct Pattern *c = np->data;
-    if (!check_pattern(c))
-      continue;
-
-    if ((pat->op == MUTT_PAT_OR) && (clauses > 1))
-      buf_addstr(buf, "OR ");
-
-    if (!compile_search(adata, c, buf))
-      return false;
-
-    if (clauses > 1)
-      buf_addch(buf, ' ');
-
-    clauses--;
-  }
-
-  buf_addch(buf, ')');
-  return true;
-}
-
 /**
  * compile_search_self - Compile a search command for a pattern
  * @param adata Imap Account data
@@ -144,6 +228,15 @@ static bool compile_search_self(const struct ImapAccountData *adata,
   char term[256] = { 0 };
   char *delim = NULL;
 
+  if (!pat->string_match && (pat->op != MUTT_PAT_SERVERSEARCH))
+  {
+    /* A regex: search for its literal text, see search_kind() */
+    buf_addstr(buf, (pat->op == MUTT_PAT_BODY) ? "BODY " : "TEXT ");
+    imap_quote_string(term, sizeof(term), pat->literal, false);
+    buf_addstr(buf, term);
+    return true;
+  }
+
   switch (pat->op)
   {
     case MUTT_PAT_HEADER:
@@ -193,28 +286,434 @@ static bool compile_search_self(const struct ImapAccountData *adata,
 }
 
 /**
- * compile_search - Convert NeoMutt pattern to IMAP search
- * @param adata Imap Account data
- * @param pat Pattern to convert
- * @param buf Buffer for result
+ * compile_narrow_date - Compile a date range into search keys
+ * @param pat    Date Pattern
+ * @param since  Search key for the start of the range, e.g. "SENTSINCE"
+ * @param before Search key for the end of the range, e.g. "SENTBEFORE"
+ * @param buf    Buffer for the keys
+ * @retval true Keys were added
+ *
+ * The server compares dates without their times or time zones, so the range
+ * is widened by a day at either end.
+ */
+static bool compile_narrow_date(const struct Pattern *pat, const char *since,
+                                const char *before, struct Buffer *buf)
+{
+  const long day = 24 * 60 * 60;
+  struct Buffer *date = buf_pool_get();
+  bool added = false;
+
+  if (pat->min > day)
+  {
+    mutt_date_make_imap_day(date, pat->min - day);
+    buf_add_printf(buf, "%s %s ", since, buf_string(date));
+    added = true;
+  }
+
+  if ((pat->max > 0) && (pat->max < mutt_date_now()))
+  {
+    mutt_date_make_imap_day(date, pat->max + (2 * day));
+    buf_add_printf(buf, "%s %s ", before, buf_string(date));
+    added = true;
+  }
+
+  buf_pool_release(&date);
+  return added;
+}
+
+/**
+ * compile_narrow_flag - Compile a flag into a search key
+ * @param narrow Narrowing keys
+ * @param flag   Flag, e.g. #IMAP_SEARCH_SEEN
+ * @param set    True if the Email must have the flag
+ * @retval true Key was added
+ */
+static bool compile_narrow_flag(struct ImapSearchNarrow *narrow, ImapSearchFlags flag, bool set)
+{
+  static const char *const FlagNames[] = { "SEEN", "ANSWERED", "FLAGGED", "DELETED" };
+
+  for (size_t i = 0; i < mutt_array_size(FlagNames); i++)
+  {
+    if (flag != (1 << i))
+      continue;
+
+    buf_add_printf(narrow->query, "%s%s ", set ? "" : "NOT ", FlagNames[i]);
+    if (set)
+      narrow->set |= flag;
+    else
+      narrow->unset |= flag;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * compile_narrow - Compile a cheap Pattern into search keys
+ * @param pat    Pattern
+ * @param narrow Narrowing keys
+ * @retval true Keys were added
+ *
+ * The keys must match a superset of the Emails the Pattern matches.
+ * A negated Pattern can only be translated if the keys are exact.
+ */
+static bool compile_narrow(const struct Pattern *pat, struct ImapSearchNarrow *narrow)
+{
+  if (pat->child || pat->sendmode)
+    return false;
+
+  const char *key = NULL;
+  const char *str = NULL;
+
+  switch (pat->op)
+  {
+    case MUTT_PAT_DATE:
+    case MUTT_PAT_DATE_RECEIVED:
+      if (pat->pat_not || pat->dynamic)
+        return false;
+      if (pat->op == MUTT_PAT_DATE)
+        return compile_narrow_date(pat, "SENTSINCE", "SENTBEFORE", narrow->query);
+      return compile_narrow_date(pat, "SINCE", "BEFORE", narrow->query);
+
+    case MUTT_PAT_SIZE:
+      /* Locally, the size is that of the body, so only the minimum is safe */
+      if (pat->pat_not || (pat->min < 1))
+        return false;
+      buf_add_printf(narrow->query, "LARGER %ld ", pat->min - 1);
+      return true;
+
+    case MUTT_FLAG:
+      return compile_narrow_flag(narrow, IMAP_SEARCH_FLAGGED, !pat->pat_not);
+    case MUTT_READ:
+      return compile_narrow_flag(narrow, IMAP_SEARCH_SEEN, !pat->pat_not);
+    case MUTT_UNREAD:
+      return compile_narrow_flag(narrow, IMAP_SEARCH_SEEN, pat->pat_not);
+    case MUTT_REPLIED:
+      return compile_narrow_flag(narrow, IMAP_SEARCH_ANSWERED, !pat->pat_not);
+    case MUTT_DELETED:
+      return compile_narrow_flag(narrow, IMAP_SEARCH_DELETED, !pat->pat_not);
+    case MUTT_NEW:
+    case MUTT_OLD:
+      /* New and old are both unread */
+      if (pat->pat_not)
+        return false;
+      return compile_narrow_flag(narrow, IMAP_SEARCH_SEEN, false);
+
+    case MUTT_PAT_FROM:
+      key = "FROM";
+      break;
+    case MUTT_PAT_TO:
+      key = "TO";
+      break;
+    case MUTT_PAT_CC:
+      key = "CC";
+      break;
+    case MUTT_PAT_SUBJECT:
+      key = "SUBJECT";
+      break;
+
+    default:
+      return false;
+  }
+
+  if (pat->pat_not || pat->group_match || pat->is_alias)
+    return false;
+
+  /* Address searches match the header text, so avoid its punctuation */
+  const char *reject = (pat->op == MUTT_PAT_SUBJECT) ? NULL : "<>\"";
+  if (pat->string_match)
+    str = search_literal_ok(pat->p.str, 1, reject) ? pat->p.str : NULL;
+  else
+    str = search_literal_ok(pat->literal, IMAP_SEARCH_LITERAL_MIN, reject) ? pat->literal : NULL;
+
+  if (!str)
+    return false;
+
+  char term[256] = { 0 };
+  imap_quote_string(term, sizeof(term), str, false);
+  buf_add_printf(narrow->query, "%s %s ", key, term);
+  return true;
+}
+
+/**
+ * search_uid_high - Get the highest UID in a Mailbox
+ * @param m Mailbox
+ * @retval num Highest UID
+ */
+static unsigned int search_uid_high(struct Mailbox *m)
+{
+  unsigned int uid_high = 0;
+
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct ImapEmailData *edata = imap_edata_get(m->emails[i]);
+    if (edata && (edata->uid > uid_high))
+      uid_high = edata->uid;
+  }
+
+  return uid_high;
+}
+
+/**
+ * search_cache_free - Free a cached SEARCH result - Implements ::hash_hdata_free_t - @ingroup hash_hdata_free_api
+ */
+static void search_cache_free(int type, void *obj, intptr_t data)
+{
+  struct ImapSearchCache *sc = obj;
+
+  ARRAY_FREE(&sc->uids);
+  FREE(&sc);
+}
+
+/**
+ * search_exec - Run a SEARCH, using the cache
+ * @param m         Mailbox
+ * @param query     Search keys
+ * @param use_flags True if the query uses flags
+ * @param uid_high  Highest UID in the Mailbox
+ * @param uida      Array for the matching UIDs (sorted)
  * @retval true  Success
- * @retval false Failure
+ * @retval false The SEARCH failed
  *
- * Convert neomutt Pattern to IMAP SEARCH command containing only elements
- * that require full-text search (neomutt already has what it needs for most
- * match types, and does a better job (eg server doesn't support regexes).
+ * If the cached result is only missing new Emails, they're searched for
+ * incrementally.
+ */
+static bool search_exec(struct Mailbox *m, const char *query, bool use_flags,
+                        unsigned int uid_high, struct UidArray *uida)
+{
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  const unsigned long long modseq = use_flags ? mdata->modseq : 0;
+
+  /* Without a MODSEQ, there's no telling when the flags have changed */
+  const bool cacheable = !use_flags || (modseq != 0);
+
+  struct ImapSearchCache *sc = NULL;
+  if (cacheable && mdata->search_cache)
+  {
+    sc = mutt_hash_find(mdata->search_cache, query);
+    if (sc && ((sc->uidvalidity != mdata->uidvalidity) || (sc->modseq != modseq)))
+    {
+      mutt_hash_delete(mdata->search_cache, query, sc);
+      sc = NULL;
+    }
+  }
+
+  if (!sc || (sc->uid_high < uid_high))
+  {
+    struct UidArray found = ARRAY_HEAD_INITIALIZER;
+    const unsigned int uid_min = sc ? sc->uid_high + 1 : 1;
+
+    struct Buffer *buf = buf_pool_get();
+    if (uid_min > 1)
+      buf_printf(buf, "UID SEARCH UID %u:* %s", uid_min, query);
+    else
+      buf_printf(buf, "UID SEARCH %s", query);
+
+    mdata->search_uids = &found;
+    const bool ok = (imap_exec(adata, buf_string(buf), IMAP_CMD_NO_FLAGS) == IMAP_EXEC_SUCCESS);
+    mdata->search_uids = NULL;
+    buf_pool_release(&buf);
+
+    if (!ok)
+    {
+      ARRAY_FREE(&found);
+      return false;
+    }
+
+    if (!sc)
+    {
+      sc = g_new0(struct ImapSearchCache, 1);
+      sc->uidvalidity = mdata->uidvalidity;
+      sc->modseq = modseq;
+      ARRAY_INIT(&sc->uids);
+
+      if (cacheable)
+      {
+        if (!mdata->search_cache || (mdata->search_cache->count >= IMAP_SEARCH_CACHE_MAX))
+        {
+          mutt_hash_free(&mdata->search_cache);
+          mdata->search_cache = mutt_hash_new(IMAP_SEARCH_CACHE_MAX, MUTT_HASH_STRDUP_KEYS);
+          mutt_hash_set_destructor(mdata->search_cache, search_cache_free, 0);
+        }
+        mutt_hash_insert(mdata->search_cache, query, sc);
+      }
+    }
+
+    /* "n:*" always includes the highest UID, even if it's less than n */
+    unsigned int *up = NULL;
+    ARRAY_FOREACH(up, &found)
+    {
+      if (*up >= uid_min)
+        ARRAY_ADD(&sc->uids, *up);
+    }
+    ARRAY_FREE(&found);
+    ARRAY_SORT(&sc->uids, imap_sort_uid, NULL);
+    sc->uid_high = uid_high;
+  }
+
+  ARRAY_FREE(uida);
+  ARRAY_RESERVE(uida, ARRAY_SIZE(&sc->uids));
+  unsigned int *up = NULL;
+  ARRAY_FOREACH(up, &sc->uids)
+  {
+    ARRAY_ADD(uida, *up);
+  }
+
+  if (!cacheable)
+    search_cache_free(0, sc, 0);
+
+  return true;
+}
+
+/**
+ * search_leaf - Search the server for one Pattern
+ * @param m        Mailbox
+ * @param pat      Pattern to search for
+ * @param narrow   Keys from the Pattern's ancestors
+ * @param uid_high Highest UID in the Mailbox
+ * @retval true  Success, or the Pattern will be evaluated locally
+ * @retval false An exact search failed
  */
-static bool compile_search(const struct ImapAccountData *adata,
-                           const struct Pattern *pat, struct Buffer *buf)
+static bool search_leaf(struct Mailbox *m, struct Pattern *pat,
+                        const struct ImapSearchNarrow *narrow, unsigned int uid_high)
 {
-  if (!check_pattern(pat))
+  const enum ImapSearchKind kind = search_kind(pat);
+  if (kind == IMAP_SEARCH_LOCAL)
     return true;
 
-  if (pat->pat_not)
-    buf_addstr(buf, "NOT ");
+  struct ImapAccountData *adata = imap_adata_get(m);
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+
+  struct Buffer *query = buf_pool_get();
+  buf_copy(query, narrow->query);
+  bool ok = compile_search_self(adata, pat, query);
+
+  struct ImapSearchLeaf *leaf = g_new0(struct ImapSearchLeaf, 1);
+  ARRAY_INIT(&leaf->uids);
 
-  return pat->child ? compile_search_children(adata, pat, buf) :
-                      compile_search_self(adata, pat, buf);
+  if (ok)
+  {
+    const bool use_flags = (narrow->set | narrow->unset) != IMAP_SEARCH_NO_FLAGS;
+    ok = search_exec(m, buf_string(query), use_flags, uid_high, &leaf->uids);
+  }
+
+  if (ok)
+  {
+    leaf->pat = pat;
+    leaf->exact = (kind == IMAP_SEARCH_EXACT);
+    leaf->set = narrow->set;
+    leaf->unset = narrow->unset;
+    leaf->uid_high = uid_high;
+    ARRAY_ADD(&mdata->search_leaves, leaf);
+    pat->server = true;
+
+    /* Other users of the Pattern, e.g. hooks, rely on e->matched */
+    unsigned int *up = NULL;
+    ARRAY_FOREACH(up, &leaf->uids)
+    {
+      struct Email *e = leaf->exact ? mutt_hash_int_find(mdata->uid_hash, *up) : NULL;
+      if (e)
+        e->matched = true;
+    }
+  }
+  else
+  {
+    ARRAY_FREE(&leaf->uids);
+    FREE(&leaf);
+  }
+
+  log_debug2("%s: %s", ok ? "searched" : "failed", buf_string(query));
+  buf_pool_release(&query);
+
+  /* If a superset can't be found, the Pattern is evaluated locally */
+  return ok || (kind == IMAP_SEARCH_SUPERSET);
+}
+
+/**
+ * search_list - Search the server for the expensive Patterns in a list
+ * @param m        Mailbox
+ * @param patterns List of Patterns
+ * @param conj     True if the Patterns are ANDed together
+ * @param narrow   Keys from the Patterns' ancestors
+ * @param uid_high Highest UID in the Mailbox
+ * @retval true  Success
+ * @retval false A search failed
+ */
+static bool search_list(struct Mailbox *m, PatternList *patterns, bool conj,
+                        const struct ImapSearchNarrow *narrow, unsigned int uid_high)
+{
+  struct ImapSearchNarrow ctx = { 0 };
+  ctx.query = buf_pool_get();
+  buf_copy(ctx.query, narrow->query);
+  ctx.set = narrow->set;
+  ctx.unset = narrow->unset;
+
+  /* If any sibling is false, the AND is false whatever the others are */
+  if (conj)
+  {
+    for (GSList *np = patterns; np != NULL; np = np->next)
+      compile_narrow(np->data, &ctx);
+  }
+
+  bool ok = true;
+  for (GSList *np = patterns; ok && (np != NULL); np = np->next)
+  {
+    struct Pattern *pat = np->data;
+    if (!check_pattern(pat))
+      continue;
+
+    if (!pat->child)
+    {
+      ok = search_leaf(m, pat, &ctx, uid_high);
+      continue;
+    }
+
+    switch (pat->op)
+    {
+      case MUTT_PAT_AND:
+        ok = search_list(m, pat->child, true, &ctx, uid_high);
+        break;
+      case MUTT_PAT_OR:
+        ok = search_list(m, pat->child, false, &ctx, uid_high);
+        break;
+      default:
+      {
+        /* Thread patterns are evaluated on other Emails */
+        struct ImapSearchNarrow none = { 0 };
+        none.query = buf_pool_get();
+        ok = search_list(m, pat->child, true, &none, uid_high);
+        buf_pool_release(&none.query);
+        break;
+      }
+    }
+  }
+
+  buf_pool_release(&ctx.query);
+  return ok;
+}
+
+/**
+ * imap_search_free - Free the results of the server-side searches
+ * @param mdata Imap Mailbox data
+ * @param all   If true, free the cache too
+ */
+void imap_search_free(struct ImapMboxData *mdata, bool all)
+{
+  if (!mdata)
+    return;
+
+  struct ImapSearchLeaf **lp = NULL;
+  ARRAY_FOREACH(lp, &mdata->search_leaves)
+  {
+    struct ImapSearchLeaf *leaf = *lp;
+    ARRAY_FREE(&leaf->uids);
+    FREE(&leaf);
+  }
+  ARRAY_FREE(&mdata->search_leaves);
+
+  if (all)
+    mutt_hash_free(&mdata->search_cache);
 }
 
 /**
@@ -223,8 +722,10 @@ static bool compile_search(const struct ImapAccountData *adata,
  * @param pat Pattern to match
  * @retval true  Success
  * @retval false Failure
+ *
+ * The results are used by imap_search_match().
  */
-bool imap_search(struct Mailbox *m, const PatternList *pat)
+bool imap_search(struct Mailbox *m, PatternList *pat)
 {
   for (int i = 0; i < m->msg_count; i++)
   {
@@ -234,20 +735,93 @@ bool imap_search(struct Mailbox *m, const PatternList *pat)
     e->matched = false;
   }
 
-  if (check_pattern_list(pat) == 0)
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  imap_search_free(mdata, false);
+
+  if (!mdata || (check_pattern_list(pat) == 0))
     return true;
 
-  struct Buffer *buf = buf_pool_get();
-  buf_addstr(buf, "UID SEARCH ");
+  struct ImapSearchNarrow narrow = { 0 };
+  narrow.query = buf_pool_get();
 
-  struct ImapAccountData *adata = imap_adata_get(m);
-  const bool ok = compile_search(adata, pat->data, buf) &&
-                  (imap_exec(adata, buf_string(buf), IMAP_CMD_NO_FLAGS) == IMAP_EXEC_SUCCESS);
+  const bool ok = search_list(m, pat, true, &narrow, search_uid_high(m));
 
-  buf_pool_release(&buf);
+  buf_pool_release(&narrow.query);
   return ok;
 }
 
+/**
+ * search_uid_cmp - Compare two UIDs, for bsearch()
+ * @param a First UID
+ * @param b Second UID
+ * @retval <0 a precedes b
+ * @retval  0 a and b are identical
+ * @retval >0 b precedes a
+ */
+static int search_uid_cmp(const void *a, const void *b)
+{
+  return imap_sort_uid(a, b, NULL);
+}
+
+/**
+ * imap_search_match - Look up the server's result for a Pattern
+ * @param m   Mailbox
+ * @param pat Pattern, ignoring its pat_not
+ * @param e   Email
+ * @retval  1 The Email matches
+ * @retval  0 The Email doesn't match
+ * @retval -1 The Pattern must be evaluated locally
+ */
+int imap_search_match(struct Mailbox *m, const struct Pattern *pat, struct Email *e)
+{
+  if (!pat || !pat->server || !e)
+    return -1;
+
+  struct ImapMboxData *mdata = imap_mdata_get(m);
+  struct ImapEmailData *edata = imap_edata_get(e);
+  if (!mdata || !edata)
+    return -1;
+
+  struct ImapSearchLeaf **lp = NULL;
+  ARRAY_FOREACH(lp, &mdata->search_leaves)
+  {
+    const struct ImapSearchLeaf *leaf = *lp;
+    if (leaf->pat != pat)
+      continue;
+
+    if (edata->uid > leaf->uid_high)
+      return -1;
+
+    if (bsearch(&edata->uid, leaf->uids.entries, ARRAY_SIZE(&leaf->uids),
+                sizeof(unsigned int), search_uid_cmp))
+    {
+      return leaf->exact ? 1 : -1;
+    }
+
+    /* The server may have seen different flags.  If the Email's flags match
+     * the query now, the server's answer might be stale. */
+    ImapSearchFlags flags = IMAP_SEARCH_NO_FLAGS;
+    if (e->read)
+      flags |= IMAP_SEARCH_SEEN;
+    if (e->replied)
+      flags |= IMAP_SEARCH_ANSWERED;
+    if (e->flagged)
+      flags |= IMAP_SEARCH_FLAGGED;
+    if (e->deleted)
+      flags |= IMAP_SEARCH_DELETED;
+
+    if ((leaf->set | leaf->unset) && ((flags & leaf->set) == leaf->set) &&
+        ((flags & leaf->unset) == IMAP_SEARCH_NO_FLAGS))
+    {
+      return -1;
+    }
+
+    return 0;
+  }
+
+  return -1;
+}
+
 /**
  * cmd_parse_search - Store SEARCH response for later use
  * @param adata Imap Account data
@@ -256,17 +830,17 @@ bool imap_search(struct Mailbox *m, const PatternList *pat)
 void cmd_parse_search(struct ImapAccountData *adata, const char *s)
 {
   unsigned int uid;
-  struct Email *e = NULL;
   struct ImapMboxData *mdata = adata->mailbox->mdata;
 
   log_debug2("Handling SEARCH");
 
+  if (!mdata->search_uids)
+    return;
+
   while ((s = imap_next_word((char *) s)) && (*s != '\0'))
   {
     if (!mutt_str_atoui(s, &uid))
       continue;
-    e = mutt_hash_int_find(mdata->uid_hash, uid);
-    if (e)
-      e->matched = true;
+    ARRAY_ADD(mdata->search_uids, uid);
   }
 }
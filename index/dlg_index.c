@@ -249,10 +249,10 @@ int find_next_undeleted(struct MailboxView *mv, int msgno, bool uncollapse)
   int index = -1;
   for (int i = msgno + 1; i < m->vcount; i++)
   {
-    struct Email *e = mutt_get_virt_email(m, i);
-    if (!e)
+    const int inum = m->v2r[i];
+    if ((inum < 0) || (inum >= m->msg_count) || !m->emails[inum])
       continue;
-    if (!e->deleted)
+    if (!(m->hot.flags[inum] & EMAIL_HOT_DELETED))
     {
       index = i;
       break;
@@ -281,12 +281,12 @@ int find_previous_undeleted(struct MailboxView *mv, int msgno, bool uncollapse)
   struct Mailbox *m = mv->mailbox;
 
   int index = -1;
-  for (int i = msgno - 1; i >= 0; i--)
+  for (int i = MIN(msgno, m->vcount) - 1; i >= 0; i--)
   {
-    struct Email *e = mutt_get_virt_email(m, i);
-    if (!e)
+    const int inum = m->v2r[i];
+    if ((inum < 0) || (inum >= m->msg_count) || !m->emails[inum])
       continue;
-    if (!e->deleted)
+    if (!(m->hot.flags[inum] & EMAIL_HOT_DELETED))
     {
       index = i;
       break;
@@ -319,12 +319,13 @@ int find_first_message(struct MailboxView *mv)
   int old = -1;
   for (int i = 0; i < m->vcount; i++)
   {
-    struct Email *e = mutt_get_virt_email(m, i);
-    if (!e)
+    const int inum = m->v2r[i];
+    if ((inum < 0) || (inum >= m->msg_count) || !m->emails[inum])
       continue;
-    if (!e->read && !e->deleted)
+    const EmailHotFlags flags = m->hot.flags[inum];
+    if (!(flags & (EMAIL_HOT_READ | EMAIL_HOT_DELETED)))
     {
-      if (!e->old)
+      if (!(flags & EMAIL_HOT_OLD))
         return i;
       if (old == -1)
         old = i;
@@ -525,6 +526,7 @@ static void update_index_unthreaded(struct MailboxView *mv, enum MxStatus check)
 
       // mark email as visited so we don't re-apply the pattern next time
       e->limit_visited = true;
+      hot_set(&mv->mailbox->hot, i, e);
     }
   }
 
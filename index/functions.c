@@ -168,6 +168,7 @@ const struct MenuFuncOp OpIndex[] = { /* map: index */
   { "next-undeleted",                OP_MAIN_NEXT_UNDELETED },
   { "next-unread",                   OP_MAIN_NEXT_UNREAD },
   { "next-unread-mailbox",           OP_MAIN_NEXT_UNREAD_MAILBOX },
+  { "outbox",                        OP_OUTBOX },
   { "parent-message",                OP_MAIN_PARENT_MESSAGE },
   { "pipe-entry",                    OP_PIPE },
   { "pipe-message",                  OP_PIPE },
@@ -2035,6 +2036,22 @@ static int op_next_entry(struct IndexSharedData *shared, struct IndexPrivateData
   return FR_SUCCESS;
 }
 
+/**
+ * op_outbox - Show the messages waiting to be sent - Implements ::index_function_t - @ingroup index_function_api
+ */
+static int op_outbox(struct IndexSharedData *shared, struct IndexPrivateData *priv, int op)
+{
+  if (!outbox_enabled(shared->sub))
+  {
+    log_fault(_("$outbox is unset"));
+    return FR_ERROR;
+  }
+
+  dlg_outbox();
+  menu_queue_redraw(priv->menu, MENU_REDRAW_FULL);
+  return FR_SUCCESS;
+}
+
 /**
  * op_pipe - Pipe message/attachment to a shell command - Implements ::index_function_t - @ingroup index_function_api
  */
@@ -3209,6 +3226,7 @@ static const struct IndexFunction IndexFunctions[] = {
   { OP_MAIN_UNTAG_PATTERN,                  op_main_untag_pattern,                CHECK_IN_MAILBOX },
   { OP_MARK_MSG,                            op_mark_msg,                          CHECK_IN_MAILBOX | CHECK_MSGCOUNT | CHECK_VISIBLE },
   { OP_NEXT_ENTRY,                          op_next_entry,                        CHECK_IN_MAILBOX | CHECK_MSGCOUNT | CHECK_VISIBLE },
+  { OP_OUTBOX,                              op_outbox,                            CHECK_ATTACH },
   { OP_PIPE,                                op_pipe,                              CHECK_IN_MAILBOX | CHECK_MSGCOUNT | CHECK_VISIBLE },
   { OP_POST,                                op_post,                              CHECK_ATTACH | CHECK_IN_MAILBOX },
   { OP_PREV_ENTRY,                          op_prev_entry,                        CHECK_IN_MAILBOX | CHECK_MSGCOUNT | CHECK_VISIBLE },
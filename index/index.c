@@ -84,6 +84,7 @@
 #include "mutt_thread.h"
 #include "muttlib.h"
 #include "mview.h"
+#include "mx.h"
 #include "private_data.h"
 #include "score.h"
 #include "shared_data.h"
@@ -517,6 +518,7 @@ static int index_score_observer(struct NotifyCallback *nc)
     mutt_score_message(m, e, true);
     e->attr_color = NULL; // Force recalc of colour
   }
+  mx_hcache_flush(m);
 
   log_debug5("score done");
   return 0;
@@ -291,7 +291,7 @@ void mutt_opts_cleanup(void)
 
   mutt_replacelist_free_full(g_steal_pointer(&SpamList));
 
-  mutt_delete_hooks(MUTT_HOOK_NO_FLAGS);
+  hooks_cleanup();
 
   mutt_hist_cleanup();
   mutt_keys_cleanup();
@@ -550,6 +550,8 @@ int mutt_init(struct ConfigSet *cs, const char *dlevel, const char *dfile,
     goto done;
   }
 
+  mutt_trace_start();
+
   if (need_pause && !OptNoCurses)
   {
     log_queue_flush(log_writer_terminal);
@@ -238,6 +238,12 @@ struct KeyEvent mutt_getch(GetChFlags flags)
 #endif
   mutt_sig_allow_interrupt(false);
 
+  if (SigChld)
+  {
+    SigChld = false;
+    notify_send(SpaceMutt->notify, NT_GLOBAL, NT_GLOBAL_CHILD, NULL);
+  }
+
   if (SigInt)
   {
     mutt_query_exit();
@@ -48,6 +48,7 @@ extern const struct MenuOpSeq BrowserDefaultBindings[];
 extern const struct MenuOpSeq ComposeDefaultBindings[];
 extern const struct MenuOpSeq EditorDefaultBindings[];
 extern const struct MenuOpSeq IndexDefaultBindings[];
+extern const struct MenuOpSeq OutboxDefaultBindings[];
 extern const struct MenuOpSeq PagerDefaultBindings[];
 extern const struct MenuOpSeq PgpDefaultBindings[];
 extern const struct MenuOpSeq PostponedDefaultBindings[];
@@ -187,6 +188,7 @@ void km_init(void)
   create_bindings(EditorDefaultBindings, MENU_EDITOR);
   create_bindings(GenericDefaultBindings, MENU_GENERIC);
   create_bindings(IndexDefaultBindings, MENU_INDEX);
+  create_bindings(OutboxDefaultBindings, MENU_OUTBOX);
   create_bindings(PagerDefaultBindings, MENU_PAGER);
   create_bindings(PostponedDefaultBindings, MENU_POSTPONED);
   create_bindings(QueryDefaultBindings, MENU_QUERY);
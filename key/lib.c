@@ -48,6 +48,7 @@ extern const struct MenuFuncOp OpBrowser[];
 extern const struct MenuFuncOp OpCompose[];
 extern const struct MenuFuncOp OpEditor[];
 extern const struct MenuFuncOp OpIndex[];
+extern const struct MenuFuncOp OpOutbox[];
 extern const struct MenuFuncOp OpPager[];
 extern const struct MenuFuncOp OpPgp[];
 extern const struct MenuFuncOp OpPostponed[];
@@ -552,6 +553,8 @@ const struct MenuFuncOp *km_get_table(enum MenuType mtype)
     case MENU_KEY_SELECT_SMIME:
       return OpSmime;
 #endif
+    case MENU_OUTBOX:
+      return OpOutbox;
     case MENU_PAGER:
       return OpPager;
     case MENU_PGP:
@@ -36,7 +36,9 @@
 #include "core/lib.h"
 #include "hcache/lib.h"
 #include "edata.h"
+#include "hcache.h"
 #include "mailbox.h"
+#include "mdata.h"
 
 /**
  * maildir_hcache_key - Get the header cache key for an Email
@@ -63,12 +65,18 @@ static size_t maildir_hcache_keylen(const char *fn)
 }
 
 /**
- * maildir_hcache_close - Close the Header Cache
- * @param ptr Header Cache
+ * maildir_hcache_close - Close the Mailbox's Header Cache
+ * @param m Mailbox
+ *
+ * Any pending writes are flushed.
  */
-void maildir_hcache_close(struct HeaderCache **ptr)
+void maildir_hcache_close(struct Mailbox *m)
 {
-  hcache_close(ptr);
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  if (!mdata)
+    return;
+
+  hcache_close(&mdata->hcache);
 }
 
 /**
@@ -90,17 +98,77 @@ int maildir_hcache_delete(struct HeaderCache *hc, struct Email *e)
 }
 
 /**
- * maildir_hcache_open - Open the Header Cache
+ * maildir_hcache_flush - Write the Header Cache's pending changes
  * @param m Mailbox
  */
-struct HeaderCache *maildir_hcache_open(struct Mailbox *m)
+void maildir_hcache_flush(struct Mailbox *m)
+{
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  if (!mdata)
+    return;
+
+  hcache_flush(mdata->hcache);
+}
+
+/**
+ * maildir_hcache_gc - Remove stale entries from the Header Cache
+ * @param m     Mailbox
+ * @param force Ignore $header_cache_gc_interval
+ * @retval num Number of entries removed
+ * @retval -1  Error, or no Header Cache
+ */
+int maildir_hcache_gc(struct Mailbox *m, bool force)
+{
+  struct HeaderCache *hc = maildir_hcache_open(m, NULL);
+  if (!hc || (!force && !hcache_gc_due(hc)))
+    return -1;
+
+  struct HashTable *live = mutt_hash_new(MAX(m->msg_count, 32), MUTT_HASH_STRDUP_KEYS);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e || !e->path)
+      continue;
+
+    const char *key = maildir_hcache_key(e);
+    char *name = g_strndup(key, maildir_hcache_keylen(key));
+    mutt_hash_insert(live, name, e);
+    FREE(&name);
+  }
+
+  int rc = hcache_gc(hc, live, NULL);
+  mutt_hash_free(&live);
+  return rc;
+}
+
+/**
+ * maildir_hcache_open - Get the Mailbox's Header Cache
+ * @param m     Mailbox
+ * @param arena Arena to allocate fetched Emails from (optional)
+ * @retval ptr  Header Cache, owned by the Mailbox
+ * @retval NULL No Header Cache
+ *
+ * The Header Cache is opened on first use and stays open until
+ * maildir_hcache_close().  Its writes are batched.
+ */
+struct HeaderCache *maildir_hcache_open(struct Mailbox *m, struct Arena *arena)
 {
-  if (!m)
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  if (!mdata)
     return NULL;
 
-  const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
+  if (!mdata->hcache)
+  {
+    const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
+    mdata->hcache = hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+    if (mdata->hcache)
+      mdata->hcache->batch = true;
+  }
+
+  if (mdata->hcache)
+    mdata->hcache->arena = arena;
 
-  return hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+  return mdata->hcache;
 }
 
 /**
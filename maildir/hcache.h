@@ -23,25 +23,31 @@
 #ifndef MUTT_MAILDIR_HCACHE_H
 #define MUTT_MAILDIR_HCACHE_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 
+struct Arena;
 struct Email;
 struct HeaderCache;
 struct Mailbox;
 
 #ifdef USE_HCACHE
 
-void                maildir_hcache_close (struct HeaderCache **ptr);
+void                maildir_hcache_close (struct Mailbox *m);
 int                 maildir_hcache_delete(struct HeaderCache *hc, struct Email *e);
-struct HeaderCache *maildir_hcache_open  (struct Mailbox *m);
+void                maildir_hcache_flush (struct Mailbox *m);
+int                 maildir_hcache_gc    (struct Mailbox *m, bool force);
+struct HeaderCache *maildir_hcache_open  (struct Mailbox *m, struct Arena *arena);
 struct Email *      maildir_hcache_read  (struct HeaderCache *hc, struct Email *e, const char *fn);
 int                 maildir_hcache_store (struct HeaderCache *hc, struct Email *e);
 
 #else
 
-static inline void                maildir_hcache_close (struct HeaderCache **ptr) {}
+static inline void                maildir_hcache_close (struct Mailbox *m) {}
 static inline int                 maildir_hcache_delete(struct HeaderCache *hc, struct Email *e) { return 0; }
-static inline struct HeaderCache *maildir_hcache_open  (struct Mailbox *m) { return NULL; }
+static inline void                maildir_hcache_flush (struct Mailbox *m) {}
+static inline int                 maildir_hcache_gc    (struct Mailbox *m, bool force) { return -1; }
+static inline struct HeaderCache *maildir_hcache_open  (struct Mailbox *m, struct Arena *arena) { return NULL; }
 static inline struct Email *      maildir_hcache_read  (struct HeaderCache *hc, struct Email *e, const char *fn) { return NULL; }
 static inline int                 maildir_hcache_store (struct HeaderCache *hc, struct Email *e) { return 0; }
 
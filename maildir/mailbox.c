@@ -27,8 +27,9 @@
  */
 
 #include "config.h"
-#include <dirent.h>
+#include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <string.h>
@@ -159,7 +160,7 @@ bool maildir_parse_stream(FILE *fp, const char *fname, bool is_old, struct Email
   if (size == 0)
     return false;
 
-  e->env = mutt_rfc822_read_header(fp, e, false, false);
+  e->env = mutt_rfc822_read_header_lazy(fp, e, NULL);
 
   if (e->received == 0)
     e->received = e->date_sent;
@@ -256,20 +257,111 @@ static int maildir_sort_inode(const void *a, const void *b, void *sdata)
   return mutt_numeric_cmp(ma->inode, mb->inode);
 }
 
+/**
+ * maildir_scan_subdir - Get a DirScan for a Maildir subdirectory
+ * @param m      Mailbox
+ * @param subdir Subdirectory, "cur" or "new"
+ * @param st     Status of the subdirectory, NULL if the caller doesn't have it
+ * @retval ptr  DirScan, rewound
+ * @retval NULL Error
+ *
+ * The subdirectory is kept open between checks.  It's reopened if its path now
+ * refers to a different directory.
+ *
+ * @note Call maildir_scan_release() when finished
+ */
+static struct DirScan *maildir_scan_subdir(struct Mailbox *m, const char *subdir,
+                                           const struct stat *st)
+{
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  if (!mdata && !m->mdata)
+  {
+    mdata = maildir_mdata_new();
+    m->mdata = mdata;
+    m->mdata_free = maildir_mdata_free;
+  }
+
+  struct Buffer *path = buf_pool_get();
+  buf_printf(path, "%s/%s", mailbox_path(m), subdir);
+
+  struct DirScan *ds = NULL;
+  if (!mdata)
+  {
+    ds = dirscan_open(AT_FDCWD, buf_string(path), true);
+    buf_pool_release(&path);
+    return ds;
+  }
+
+  struct DirScan **dsp = mutt_str_equal(subdir, "cur") ? &mdata->scan_cur : &mdata->scan_new;
+
+  if (*dsp)
+  {
+    struct stat st_now = { 0 };
+    if (!st && (stat(buf_string(path), &st_now) == 0))
+      st = &st_now;
+
+    if (!dirscan_same(*dsp, st) || !dirscan_rewind(*dsp))
+      dirscan_close(dsp);
+  }
+
+  ds = *dsp;
+  if (!ds)
+  {
+    ds = dirscan_open(AT_FDCWD, buf_string(path), true);
+    if (dirscan_fd(ds) < DIRSCAN_KEEP_MAX_FD)
+      *dsp = ds;
+  }
+
+  buf_pool_release(&path);
+  return ds;
+}
+
+/**
+ * maildir_scan_release - Finish with a DirScan from maildir_scan_subdir()
+ * @param m   Mailbox
+ * @param ptr DirScan to release
+ */
+static void maildir_scan_release(struct Mailbox *m, struct DirScan **ptr)
+{
+  struct MaildirMboxData *mdata = maildir_mdata_get(m);
+  if (!mdata || ((*ptr != mdata->scan_new) && (*ptr != mdata->scan_cur)))
+    dirscan_close(ptr);
+  else
+    dirscan_finish(*ptr);
+  *ptr = NULL;
+}
+
+/**
+ * maildir_name_time - Get the delivery time from a Maildir filename
+ * @param name Filename, e.g. "1700000000.M1P2.host:2,S"
+ * @retval num Delivery time
+ * @retval 0   The name doesn't start with a time
+ */
+static time_t maildir_name_time(const char *name)
+{
+  time_t t = 0;
+  for (; isdigit((unsigned char) *name); name++)
+    t = (t * 10) + (*name - '0');
+
+  return (*name == '.') ? t : 0;
+}
+
 /**
  * maildir_parse_dir - Read a Maildir mailbox
  * @param[in]  m        Mailbox
  * @param[out] mda      Array for results
  * @param[in]  subdir   Subdirectory, e.g. 'new'
+ * @param[in]  st       Status of the subdirectory, may be NULL
  * @param[in]  progress Progress bar
  * @retval  0 Success
  * @retval -1 Error
  * @retval -2 Aborted
  */
 static int maildir_parse_dir(struct Mailbox *m, struct MdEmailArray *mda,
-                             const char *subdir, struct Progress *progress)
+                             const char *subdir, const struct stat *st,
+                             struct Progress *progress)
 {
-  struct dirent *de = NULL;
+  const struct DirEntry *de = NULL;
   int rc = 0;
   bool is_old = false;
   struct MdEmail *entry = NULL;
@@ -277,39 +369,38 @@ static int maildir_parse_dir(struct Mailbox *m, struct MdEmailArray *mda,
 
   struct Buffer *buf = buf_pool_get();
 
-  buf_printf(buf, "%s/%s", mailbox_path(m), subdir);
   is_old = mutt_str_equal("cur", subdir);
 
-  DIR *dir = mutt_file_opendir(buf_string(buf), MUTT_OPENDIR_CREATE);
-  if (!dir)
+  struct DirScan *ds = maildir_scan_subdir(m, subdir, st);
+  if (!ds)
   {
     rc = -1;
     goto cleanup;
   }
 
-  while (((de = readdir(dir))) && !SigInt)
+  while (((de = dirscan_next(ds))) && !SigInt)
   {
-    if (*de->d_name == '.')
+    if (*de->name == '.')
       continue;
 
-    log_debug2("queueing %s", de->d_name);
+    log_debug2("queueing %s", de->name);
 
     e = maildir_email_new();
     e->old = is_old;
-    maildir_parse_flags(e, de->d_name);
+    maildir_parse_flags(e, de->name);
 
     progress_update(progress, ARRAY_SIZE(mda) + 1, -1);
 
-    buf_printf(buf, "%s/%s", subdir, de->d_name);
+    buf_printf(buf, "%s/%s", subdir, de->name);
     e->path = buf_strdup(buf);
 
     entry = maildir_entry_new();
     entry->email = e;
-    entry->inode = de->d_ino;
+    entry->inode = de->ino;
     ARRAY_ADD(mda, entry);
   }
 
-  closedir(dir);
+  maildir_scan_release(m, &ds);
 
   if (SigInt)
   {
@@ -325,18 +416,71 @@ cleanup:
   return rc;
 }
 
+#ifdef USE_INOTIFY
+/**
+ * maildir_parse_events - Turn the monitor's file events into a Maildir list
+ * @param[in]  events    File events, in the order they occurred
+ * @param[out] mda       Array for the files that were added
+ * @param[out] hash_gone Hash Table: "base-filename" -> path of a removed file
+ *
+ * Only the latest event for each message counts.  A flag change by another
+ * client shows up as a file moved out of, then back into, a subdirectory.
+ */
+static void maildir_parse_events(struct MonitorEventArray *events,
+                                 struct MdEmailArray *mda, GHashTable *hash_gone)
+{
+  GHashTable *hash_seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  struct Buffer *canon = buf_pool_get();
+  struct Buffer *path = buf_pool_get();
+
+  for (size_t i = ARRAY_SIZE(events); i > 0; i--)
+  {
+    struct MonitorEvent *ev = ARRAY_GET(events, i - 1);
+
+    maildir_canon_filename(canon, ev->name);
+    if (g_hash_table_contains(hash_seen, buf_string(canon)))
+      continue;
+    g_hash_table_add(hash_seen, buf_strdup(canon));
+
+    buf_printf(path, "%s/%s", ev->subdir, ev->name);
+    if (ev->type == MONITOR_EV_REMOVED)
+    {
+      log_debug2("removed %s", buf_string(path));
+      g_hash_table_insert(hash_gone, buf_strdup(canon), buf_strdup(path));
+      continue;
+    }
+
+    log_debug2("queueing %s", buf_string(path));
+
+    struct Email *e = maildir_email_new();
+    e->old = mutt_str_equal("cur", ev->subdir);
+    maildir_parse_flags(e, ev->name);
+    e->path = buf_strdup(path);
+
+    struct MdEmail *entry = maildir_entry_new();
+    entry->email = e;
+    ARRAY_ADD(mda, entry);
+  }
+
+  buf_pool_release(&canon);
+  buf_pool_release(&path);
+  g_hash_table_destroy(hash_seen);
+}
+#endif
+
 /**
  * maildir_delayed_parsing - This function does the second parsing pass
- * @param[in]  m   Mailbox
- * @param[out] mda Maildir array to parse
+ * @param[in]  m        Mailbox
+ * @param[out] mda      Maildir array to parse
  * @param[in]  progress Progress bar
+ * @param[in]  arena    Arena for Emails from the Header Cache (optional)
  */
 static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
-                                    struct Progress *progress)
+                                    struct Progress *progress, struct Arena *arena)
 {
   char fn[PATH_MAX] = { 0 };
 
-  struct HeaderCache *hc = maildir_hcache_open(m);
+  struct HeaderCache *hc = maildir_hcache_open(m, arena);
 
   struct MdEmail *md = NULL;
   struct MdEmail **mdp = NULL;
@@ -369,8 +513,6 @@ static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
       }
     }
   }
-
-  maildir_hcache_close(&hc);
 }
 
 /**
@@ -385,13 +527,12 @@ static void maildir_delayed_parsing(struct Mailbox *m, struct MdEmailArray *mda,
 static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
                               bool check_new, bool check_stats)
 {
-  DIR *dir = NULL;
-  struct dirent *de = NULL;
+  const struct DirEntry *de = NULL;
   char *p = NULL;
   struct stat st = { 0 };
+  bool have_st = false;
 
   struct Buffer *path = buf_pool_get();
-  struct Buffer *msgpath = buf_pool_get();
   buf_printf(path, "%s/%s", mailbox_path(m), dir_name);
 
   /* when $mail_check_recent is set, if the new/ directory hasn't been modified since
@@ -399,8 +540,8 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
   const bool c_mail_check_recent = cs_subset_bool(SpaceMutt->sub, "mail_check_recent");
   if (check_new && c_mail_check_recent)
   {
-    if ((stat(buf_string(path), &st) == 0) &&
-        (mutt_file_stat_timespec_compare(&st, MUTT_STAT_MTIME, &m->last_visited) < 0))
+    have_st = (stat(buf_string(path), &st) == 0);
+    if (have_st && (mutt_file_stat_timespec_compare(&st, MUTT_STAT_MTIME, &m->last_visited) < 0))
     {
       check_new = false;
     }
@@ -409,8 +550,8 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
   if (!(check_new || check_stats))
     goto cleanup;
 
-  dir = mutt_file_opendir(buf_string(path), MUTT_OPENDIR_CREATE);
-  if (!dir)
+  struct DirScan *ds = maildir_scan_subdir(m, dir_name, have_st ? &st : NULL);
+  if (!ds)
   {
     m->type = MUTT_UNKNOWN;
     goto cleanup;
@@ -420,12 +561,12 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
 
   char delimiter_version[8] = { 0 };
   snprintf(delimiter_version, sizeof(delimiter_version), "%c2,", c_maildir_field_delimiter);
-  while ((de = readdir(dir)))
+  while ((de = dirscan_next(ds)))
   {
-    if (*de->d_name == '.')
+    if (*de->name == '.')
       continue;
 
-    p = strstr(de->d_name, delimiter_version);
+    p = strstr(de->name, delimiter_version);
     if (p && strchr(p + 3, 'T'))
       continue;
 
@@ -441,11 +582,11 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
         m->msg_unread++;
       if (check_new)
       {
-        if (c_mail_check_recent)
+        /* ensure this message was received since leaving this m.
+         * If the filename says it was delivered since, there's no need to stat it. */
+        if (c_mail_check_recent && (maildir_name_time(de->name) <= m->last_visited.tv_sec))
         {
-          buf_printf(msgpath, "%s/%s", buf_string(path), de->d_name);
-          /* ensure this message was received since leaving this m */
-          if ((stat(buf_string(msgpath), &st) == 0) &&
+          if ((fstatat(dirscan_fd(ds), de->name, &st, 0) == 0) &&
               (mutt_file_stat_timespec_compare(&st, MUTT_STAT_CTIME, &m->last_visited) <= 0))
           {
             continue;
@@ -464,11 +605,10 @@ static void maildir_check_dir(struct Mailbox *m, const char *dir_name,
     }
   }
 
-  closedir(dir);
+  maildir_scan_release(m, &ds);
 
 cleanup:
   buf_pool_release(&path);
-  buf_pool_release(&msgpath);
 }
 
 /**
@@ -502,7 +642,7 @@ static int maildir_read_dir(struct Mailbox *m, const char *subdir)
   }
 
   struct MdEmailArray mda = ARRAY_HEAD_INITIALIZER;
-  int rc = maildir_parse_dir(m, &mda, subdir, progress);
+  int rc = maildir_parse_dir(m, &mda, subdir, NULL, progress);
   progress_free(&progress);
   if (rc < 0)
     return -1;
@@ -512,7 +652,7 @@ static int maildir_read_dir(struct Mailbox *m, const char *subdir)
     progress = progress_new(MUTT_PROGRESS_READ, ARRAY_SIZE(&mda));
     progress_set_message(progress, _("Reading %s..."), mailbox_path(m));
   }
-  maildir_delayed_parsing(m, &mda, progress);
+  maildir_delayed_parsing(m, &mda, progress, mailbox_arena(m));
   progress_free(&progress);
 
   maildir_move_to_mailbox(m, &mda);
@@ -545,6 +685,7 @@ static enum MxStatus maildir_check(struct Mailbox *m)
   int num_new = 0;            /* number of new messages added to the mailbox */
   bool flags_changed = false; /* message flags were changed in the mailbox */
   GHashTable *hash_names = NULL; // Hash Table: "base-filename" -> MdEmail
+  GHashTable *hash_gone = NULL;  // Hash Table: "base-filename" -> removed path
   struct MaildirMboxData *mdata = maildir_mdata_get(m);
 
   const bool c_check_new = cs_subset_bool(SpaceMutt->sub, "check_new");
@@ -566,43 +707,68 @@ static enum MxStatus maildir_check(struct Mailbox *m)
     return MX_STATUS_ERROR;
   }
 
-  /* determine which subdirectories need to be scanned */
-  if (mutt_file_stat_timespec_compare(&st_new, MUTT_STAT_MTIME, &mdata->mtime) > 0)
-    changed = MMC_NEW_DIR;
-  if (mutt_file_stat_timespec_compare(&st_cur, MUTT_STAT_MTIME, &mdata->mtime_cur) > 0)
-    changed |= MMC_CUR_DIR;
-
-  if (changed == MMC_NO_DIRS)
-  {
-    buf_pool_release(&buf);
-    return MX_STATUS_OK; /* nothing to do */
-  }
+  struct MdEmailArray mda = ARRAY_HEAD_INITIALIZER;
 
-  /* Update the modification times on the mailbox.
-   *
-   * The monitor code notices changes in the open mailbox too quickly.
-   * In practice, this sometimes leads to all the new messages not being
-   * noticed during the SAME group of mtime stat updates.  To work around
-   * the problem, don't update the stat times for a monitor caused check. */
 #ifdef USE_INOTIFY
+  /* If the monitor has seen every change to the mailbox, just apply the
+   * changes it saw, rather than rescanning both subdirectories. */
   if (MonitorCurMboxChanged)
   {
     MonitorCurMboxChanged = false;
+
+    struct MonitorEventArray events = ARRAY_HEAD_INITIALIZER;
+    if (mutt_monitor_take_events(m, &events))
+    {
+      hash_gone = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+      maildir_parse_events(&events, &mda, hash_gone);
+      mutt_monitor_events_free(&events);
+
+      mutt_file_get_stat_timespec(&mdata->mtime_cur, &st_cur, MUTT_STAT_MTIME);
+      mutt_file_get_stat_timespec(&mdata->mtime, &st_new, MUTT_STAT_MTIME);
+
+      if (ARRAY_EMPTY(&mda) && (g_hash_table_size(hash_gone) == 0))
+      {
+        g_hash_table_destroy(hash_gone);
+        buf_pool_release(&buf);
+        return MX_STATUS_OK; /* nothing to do */
+      }
+    }
+    else
+    {
+      /* Events were lost.  The monitor code notices changes in the open
+       * mailbox too quickly.  In practice, this sometimes leads to all the
+       * new messages not being noticed during the SAME group of mtime stat
+       * updates.  To work around the problem, don't update the stat times
+       * for a monitor caused check. */
+      changed = MMC_NEW_DIR | MMC_CUR_DIR;
+    }
   }
   else
 #endif
   {
+    /* determine which subdirectories need to be scanned */
+    if (mutt_file_stat_timespec_compare(&st_new, MUTT_STAT_MTIME, &mdata->mtime) > 0)
+      changed = MMC_NEW_DIR;
+    if (mutt_file_stat_timespec_compare(&st_cur, MUTT_STAT_MTIME, &mdata->mtime_cur) > 0)
+      changed |= MMC_CUR_DIR;
+
+    if (changed == MMC_NO_DIRS)
+    {
+      buf_pool_release(&buf);
+      return MX_STATUS_OK; /* nothing to do */
+    }
+
+    /* Update the modification times on the mailbox. */
     mutt_file_get_stat_timespec(&mdata->mtime_cur, &st_cur, MUTT_STAT_MTIME);
     mutt_file_get_stat_timespec(&mdata->mtime, &st_new, MUTT_STAT_MTIME);
   }
 
   /* do a fast scan of just the filenames in
    * the subdirectories that have changed.  */
-  struct MdEmailArray mda = ARRAY_HEAD_INITIALIZER;
   if (changed & MMC_NEW_DIR)
-    maildir_parse_dir(m, &mda, "new", NULL);
+    maildir_parse_dir(m, &mda, "new", &st_new, NULL);
   if (changed & MMC_CUR_DIR)
-    maildir_parse_dir(m, &mda, "cur", NULL);
+    maildir_parse_dir(m, &mda, "cur", &st_cur, NULL);
 
   /* we create a hash table keyed off the canonical (sans flags) filename
    * of each message we scanned.  This is used in the loop over the
@@ -660,7 +826,9 @@ static enum MxStatus maildir_check(struct Mailbox *m)
      * Check to see if we have enough information to know if the
      * message has disappeared out from underneath us.  */
     else if (((changed & MMC_NEW_DIR) && mutt_strn_equal(e->path, "new/", 4)) ||
-             ((changed & MMC_CUR_DIR) && mutt_strn_equal(e->path, "cur/", 4)))
+             ((changed & MMC_CUR_DIR) && mutt_strn_equal(e->path, "cur/", 4)) ||
+             (hash_gone && mutt_str_equal(g_hash_table_lookup(hash_gone, buf_string(buf)),
+                                          e->path)))
     {
       /* This message disappeared, so we need to simulate a "reopen"
        * event.  We know it disappeared because we just scanned the
@@ -675,17 +843,22 @@ static enum MxStatus maildir_check(struct Mailbox *m)
        * modified, so we assume that it is still present and
        * unchanged.  */
     }
+
+    /* Some flags were set directly, bypassing mutt_set_flag() */
+    mailbox_hot_update(m, e);
   }
 
-  /* destroy the file name hash */
+  /* destroy the file name hashes */
   g_hash_table_destroy(hash_names);
+  if (hash_gone)
+    g_hash_table_destroy(hash_gone);
 
   /* If we didn't just get new mail, update the tables. */
   if (occult)
     mailbox_changed(m, NT_MAILBOX_RESORT);
 
   /* do any delayed parsing we need to do. */
-  maildir_delayed_parsing(m, &mda, NULL);
+  maildir_delayed_parsing(m, &mda, NULL, NULL);
 
   /* Incorporate new messages */
   num_new = maildir_move_to_mailbox(m, &mda);
@@ -841,7 +1014,7 @@ enum MxStatus maildir_mbox_sync(struct Mailbox *m)
   if (check == MX_STATUS_ERROR)
     return check;
 
-  struct HeaderCache *hc = maildir_hcache_open(m);
+  struct HeaderCache *hc = maildir_hcache_open(m, NULL);
 
   struct Progress *progress = NULL;
   if (m->verbose)
@@ -862,7 +1035,7 @@ enum MxStatus maildir_mbox_sync(struct Mailbox *m)
     }
   }
   progress_free(&progress);
-  maildir_hcache_close(&hc);
+  maildir_hcache_flush(m);
 
   /* XXX race condition? */
 
@@ -887,7 +1060,7 @@ enum MxStatus maildir_mbox_sync(struct Mailbox *m)
   return check;
 
 err:
-  maildir_hcache_close(&hc);
+  maildir_hcache_flush(m);
   return MX_STATUS_ERROR;
 }
 
@@ -897,5 +1070,14 @@ err:
  */
 enum MxStatus maildir_mbox_close(struct Mailbox *m)
 {
+  maildir_hcache_close(m);
   return MX_STATUS_OK;
 }
+
+/**
+ * maildir_mbox_hcache_gc - Remove stale entries from the header cache - Implements MxOps::mbox_hcache_gc() - @ingroup mx_mbox_hcache_gc
+ */
+int maildir_mbox_hcache_gc(struct Mailbox *m, bool force)
+{
+  return maildir_hcache_gc(m, force);
+}
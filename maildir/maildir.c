@@ -60,6 +60,7 @@ const struct MxOps MxMaildirOps = {
   .msg_close        = maildir_msg_close,
   .msg_padding_size = NULL,
   .msg_save_hcache  = maildir_msg_save_hcache,
+  .mbox_hcache_gc   = maildir_mbox_hcache_gc,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
   .path_probe       = maildir_path_probe,
@@ -26,6 +26,8 @@
 #include <sys/types.h>
 #include <time.h>
 
+struct DirScan;
+struct HeaderCache;
 struct Mailbox;
 
 /**
@@ -33,9 +35,12 @@ struct Mailbox;
  */
 struct MaildirMboxData
 {
-  struct timespec mtime;     ///< Time Mailbox was last changed
-  struct timespec mtime_cur; ///< Timestamp of the 'cur' dir
-  mode_t umask;              ///< umask to use when creating files
+  struct timespec mtime;      ///< Time Mailbox was last changed
+  struct timespec mtime_cur;  ///< Timestamp of the 'cur' dir
+  mode_t umask;               ///< umask to use when creating files
+  struct HeaderCache *hcache; ///< Header cache, open while the Mailbox is
+  struct DirScan *scan_new;   ///< The 'new' dir, kept open between checks
+  struct DirScan *scan_cur;   ///< The 'cur' dir, kept open between checks
 };
 
 void                    maildir_mdata_free(void **ptr);
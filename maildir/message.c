@@ -27,7 +27,6 @@
  */
 
 #include "config.h"
-#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
@@ -118,34 +117,34 @@ static FILE *maildir_open_find_message_dir(const char *folder, const char *uniqu
   struct Buffer *tunique = buf_pool_get();
   struct Buffer *fname = buf_pool_get();
 
-  struct dirent *de = NULL;
+  const struct DirEntry *de = NULL;
 
   FILE *fp = NULL;
   int oe = ENOENT;
 
   buf_printf(dirname, "%s/%s", folder, subfolder);
 
-  DIR *dir = mutt_file_opendir(buf_string(dirname), MUTT_OPENDIR_CREATE);
-  if (!dir)
+  struct DirScan *ds = dirscan_open(AT_FDCWD, buf_string(dirname), true);
+  if (!ds)
   {
     errno = ENOENT;
     goto cleanup;
   }
 
-  while ((de = readdir(dir)))
+  while ((de = dirscan_next(ds)))
   {
-    maildir_canon_filename(tunique, de->d_name);
+    maildir_canon_filename(tunique, de->name);
 
     if (mutt_str_equal(buf_string(tunique), unique))
     {
-      buf_printf(fname, "%s/%s/%s", folder, subfolder, de->d_name);
+      buf_printf(fname, "%s/%s/%s", folder, subfolder, de->name);
       fp = mutt_file_fopen(buf_string(fname), "r");
       oe = errno;
       break;
     }
   }
 
-  closedir(dir);
+  dirscan_close(&ds);
 
   if (newname && fp)
     *newname = buf_strdup(fname);
@@ -621,11 +620,6 @@ int maildir_msg_close(struct Mailbox *m, struct Message *msg)
  */
 int maildir_msg_save_hcache(struct Mailbox *m, struct Email *e)
 {
-  int rc = 0;
-
-  struct HeaderCache *hc = maildir_hcache_open(m);
-  rc = maildir_hcache_store(hc, e);
-  maildir_hcache_close(&hc);
-
-  return rc;
+  struct HeaderCache *hc = maildir_hcache_open(m, NULL);
+  return maildir_hcache_store(hc, e);
 }
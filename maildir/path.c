@@ -27,7 +27,7 @@
  */
 
 #include "config.h"
-#include <dirent.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -56,8 +56,8 @@ int maildir_path_canon(struct Buffer *path)
  */
 int maildir_path_is_empty(struct Buffer *path)
 {
-  DIR *dir = NULL;
-  struct dirent *de = NULL;
+  struct DirScan *ds = NULL;
+  const struct DirEntry *de = NULL;
   int rc = 1; /* assume empty until we find a message */
   char realpath[PATH_MAX] = { 0 };
   int iter = 0;
@@ -70,18 +70,18 @@ int maildir_path_is_empty(struct Buffer *path)
      * find old messages without having to scan both subdirs */
     snprintf(realpath, sizeof(realpath), "%s/%s", buf_string(path),
              (iter == 0) ? "cur" : "new");
-    dir = mutt_file_opendir(realpath, MUTT_OPENDIR_CREATE);
-    if (!dir)
+    ds = dirscan_open(AT_FDCWD, realpath, true);
+    if (!ds)
       return -1;
-    while ((de = readdir(dir)))
+    while ((de = dirscan_next(ds)))
     {
-      if (*de->d_name != '.')
+      if (*de->name != '.')
       {
         rc = 0;
         break;
       }
     }
-    closedir(dir);
+    dirscan_close(&ds);
     iter++;
   } while (rc && iter < 2);
 
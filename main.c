@@ -536,6 +536,20 @@ done:
   return 0;
 }
 
+/**
+ * main_hcache_observer - Notification that a timeout has occurred - Implements ::observer_t - @ingroup observer_api
+ *
+ * While the user is idle, clean up the header cache of the current Mailbox.
+ */
+static int main_hcache_observer(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_TIMEOUT)
+    return 0;
+
+  mx_hcache_idle(get_current_mailbox());
+  return 0;
+}
+
 /**
  * main - Start NeoMutt
  * @param argc Number of command line arguments
@@ -991,6 +1005,7 @@ main
   notify_observer_add(SpaceMutt->sub->notify, NT_CONFIG, main_log_observer, NULL);
   notify_observer_add(SpaceMutt->sub->notify, NT_CONFIG, main_config_observer, NULL);
   notify_observer_add(SpaceMutt->notify, NT_TIMEOUT, main_timeout_observer, NULL);
+  notify_observer_add(SpaceMutt->notify, NT_TIMEOUT, main_hcache_observer, NULL);
 
   if (sendflags & SEND_POSTPONED)
   {
@@ -1404,6 +1419,7 @@ main
     mutt_startup_shutdown_hook(MUTT_STARTUP_HOOK);
     log_notify("NT_GLOBAL_STARTUP");
     notify_send(SpaceMutt->notify, NT_GLOBAL, NT_GLOBAL_STARTUP, NULL);
+    outbox_init();
 
     notify_send(SpaceMutt->notify_resize, NT_RESIZE, 0, NULL);
     window_redraw(NULL);
@@ -1436,6 +1452,10 @@ main
       repeat_error = false;
     }
     imap_logout_all();
+    outbox_cleanup();
+#ifdef USE_SSL
+    tls_sessions_cleanup();
+#endif
 #ifdef USE_SASL_CYRUS
     mutt_sasl_cleanup();
 #endif
@@ -1464,6 +1484,7 @@ main_exit:
     notify_observer_remove(SpaceMutt->sub->notify, main_log_observer, NULL);
     notify_observer_remove(SpaceMutt->sub->notify, main_config_observer, NULL);
     notify_observer_remove(SpaceMutt->notify, main_timeout_observer, NULL);
+    notify_observer_remove(SpaceMutt->notify, main_hcache_observer, NULL);
   }
   g_slist_free_full(g_steal_pointer(&commands), g_free);
   MuttLogWriter = log_writer_queue;
@@ -1480,12 +1501,14 @@ main_exit:
   menu_cleanup();
   crypt_cleanup();
   mutt_ch_cache_cleanup();
+  mutt_mb_width_reset();
   mutt_opts_cleanup();
   subjrx_cleanup();
   attach_cleanup();
   alternates_cleanup();
   mutt_keys_cleanup();
   mutt_prex_cleanup();
+  mutt_trace_stop();
   config_cache_cleanup();
   spacemutt_free(&SpaceMutt);
   cs_free(&cs);
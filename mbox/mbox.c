@@ -236,7 +236,7 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
       progress_update(progress, count, (int) (loc / (m->size / 100 + 1)));
 
       mx_alloc_memory(m, m->msg_count);
-      e = email_new();
+      e = email_new_arena(mailbox_arena(m));
       m->emails[m->msg_count] = e;
       e->offset = loc;
       e->index = m->msg_count;
@@ -263,7 +263,7 @@ static enum MxOpenReturns mmdf_parse_mailbox(struct Mailbox *m)
         e->received = t - mutt_date_local_tz(t);
       }
 
-      e->env = mutt_rfc822_read_header(adata->fp, e, false, false);
+      e->env = mutt_rfc822_read_header_lazy(adata->fp, e, m->arena);
 
       loc = ftello(adata->fp);
       if (loc < 0)
@@ -419,13 +419,13 @@ static enum MxOpenReturns mbox_parse_mailbox(struct Mailbox *m)
 
       mx_alloc_memory(m, m->msg_count);
 
-      m->emails[m->msg_count] = email_new();
+      m->emails[m->msg_count] = email_new_arena(mailbox_arena(m));
       e_cur = m->emails[m->msg_count];
       e_cur->received = t - mutt_date_local_tz(t);
       e_cur->offset = loc;
       e_cur->index = m->msg_count;
 
-      e_cur->env = mutt_rfc822_read_header(adata->fp, e_cur, false, false);
+      e_cur->env = mutt_rfc822_read_header_lazy(adata->fp, e_cur, m->arena);
 
       /* if we know how long this message is, either just skip over the body,
        * or if we don't know how many lines there are, count them now (this will
@@ -557,6 +557,7 @@ static int reopen_mailbox(struct Mailbox *m)
 
   bool (*cmp_headers)(const struct Email *, const struct Email *) = NULL;
   struct Email **e_old = NULL;
+  struct Arena *old_arena = NULL;
   int old_msg_count;
   bool msg_mod = false;
   int rc = -1;
@@ -581,6 +582,8 @@ static int reopen_mailbox(struct Mailbox *m)
   mutt_hash_free(&m->subj_hash);
   mutt_hash_free(&m->label_hash);
   FREE(&m->v2r);
+  /* the old headers live until the new ones have been read */
+  old_arena = g_steal_pointer(&m->arena);
   if (m->readonly)
   {
     for (int i = 0; i < m->msg_count; i++)
@@ -633,6 +636,7 @@ static int reopen_mailbox(struct Mailbox *m)
     for (int i = 0; i < old_msg_count; i++)
       email_free(&(e_old[i]));
     FREE(&e_old);
+    arena_release(&old_arena);
 
     m->verbose = true;
     return -1;
@@ -710,6 +714,7 @@ static int reopen_mailbox(struct Mailbox *m)
     }
     FREE(&e_old);
   }
+  arena_release(&old_arena);
 
   mailbox_changed(m, NT_MAILBOX_UPDATE);
   m->verbose = true;
@@ -1290,7 +1295,7 @@ static enum MxStatus mbox_mbox_sync(struct Mailbox *m)
        * change/deleted message */
       if (m->verbose)
         log_message(_("Committing changes..."));
-      i = mutt_file_copy_stream(fp, adata->fp);
+      i = (mutt_file_copy_stream(fp, adata->fp) < 0) ? -1 : 0;
 
       if (ferror(adata->fp))
         i = -1;
@@ -1727,6 +1732,7 @@ const struct MxOps MxMboxOps = {
   .msg_close        = mbox_msg_close,
   .msg_padding_size = mbox_msg_padding_size,
   .msg_save_hcache  = NULL,
+  .mbox_hcache_gc   = NULL,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
   .path_probe       = mbox_path_probe,
@@ -1757,6 +1763,7 @@ const struct MxOps MxMmdfOps = {
   .msg_close        = mbox_msg_close,
   .msg_padding_size = mmdf_msg_padding_size,
   .msg_save_hcache  = NULL,
+  .mbox_hcache_gc   = NULL,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
   .path_probe       = mbox_path_probe,
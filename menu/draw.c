@@ -479,6 +479,9 @@ void menu_redraw_current(struct Menu *menu)
  */
 int menu_redraw(struct Menu *menu)
 {
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "gui", "menu_redraw");
+
   /* See if all or part of the screen needs to be updated.  */
   if (menu->redraw & MENU_REDRAW_FULL)
     menu_redraw_full(menu);
@@ -490,5 +493,6 @@ int menu_redraw(struct Menu *menu)
   else if (menu->redraw == MENU_REDRAW_CURRENT)
     menu_redraw_current(menu);
 
+  trace_end(&span, NULL);
   return OP_NULL;
 }
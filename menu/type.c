@@ -46,6 +46,7 @@ const struct Mapping MenuNames[] = {
   { "dialog",           MENU_DIALOG },
   { "editor",           MENU_EDITOR },
   { "index",            MENU_INDEX },
+  { "outbox",           MENU_OUTBOX },
   { "pager",            MENU_PAGER },
   { "postpone",         MENU_POSTPONED },
   { "pgp",              MENU_PGP },
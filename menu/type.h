@@ -49,6 +49,7 @@ enum MenuType
   MENU_KEY_SELECT_SMIME, ///< Select a SMIME key
 #endif
   MENU_INDEX,            ///< Index panel (list of emails)
+  MENU_OUTBOX,           ///< Messages waiting to be sent
   MENU_PAGER,            ///< Pager pager (email viewer)
   MENU_PGP,              ///< PGP encryption menu
   MENU_POSTPONED,        ///< Select a postponed email
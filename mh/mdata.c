@@ -30,6 +30,9 @@
 #include "mutt/lib.h"
 #include "core/lib.h"
 #include "mdata.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
 
 /**
  * mh_mdata_free - Free the private Mailbox data - Implements Mailbox::mdata_free() - @ingroup mailbox_mdata_free
@@ -39,6 +42,12 @@ void mh_mdata_free(void **ptr)
   if (!ptr || !*ptr)
     return;
 
+  struct MhMboxData *mdata = *ptr;
+#ifdef USE_HCACHE
+  hcache_close(&mdata->hcache);
+#endif
+  dirscan_close(&mdata->scan);
+
   FREE(ptr);
 }
 
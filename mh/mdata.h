@@ -26,6 +26,8 @@
 #include <sys/types.h>
 #include <time.h>
 
+struct DirScan;
+struct HeaderCache;
 struct Mailbox;
 
 /**
@@ -33,9 +35,11 @@ struct Mailbox;
  */
 struct MhMboxData
 {
-  struct timespec mtime;     ///< Time Mailbox was last changed
-  struct timespec mtime_seq; ///< Time '.mh_sequences' was last changed
-  mode_t          umask;     ///< umask to use when creating files
+  struct timespec     mtime;     ///< Time Mailbox was last changed
+  struct timespec     mtime_seq; ///< Time '.mh_sequences' was last changed
+  mode_t              umask;     ///< umask to use when creating files
+  struct HeaderCache *hcache;    ///< Header cache, open while the Mailbox is
+  struct DirScan     *scan;      ///< The folder, kept open between checks
 };
 
 void               mh_mdata_free(void **ptr);
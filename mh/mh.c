@@ -33,7 +33,6 @@
 
 #include "config.h"
 #include <ctype.h>
-#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
@@ -69,24 +68,97 @@ struct HeaderCache;
 
 struct Progress;
 
+/**
+ * mh_scan_folder - Get a DirScan for an MH folder
+ * @param m Mailbox
+ * @retval ptr  DirScan, rewound
+ * @retval NULL Error
+ *
+ * The folder is kept open between checks.  It's reopened if its path now
+ * refers to a different directory.
+ *
+ * @note Call mh_scan_release() when finished
+ */
+static struct DirScan *mh_scan_folder(struct Mailbox *m)
+{
+  struct MhMboxData *mdata = mh_mdata_get(m);
+  if (!mdata && !m->mdata)
+  {
+    mdata = mh_mdata_new();
+    m->mdata = mdata;
+    m->mdata_free = mh_mdata_free;
+  }
+
+  if (!mdata)
+    return dirscan_open(AT_FDCWD, mailbox_path(m), false);
+
+  if (mdata->scan)
+  {
+    struct stat st = { 0 };
+    if ((stat(mailbox_path(m), &st) != 0) || !dirscan_same(mdata->scan, &st) ||
+        !dirscan_rewind(mdata->scan))
+    {
+      dirscan_close(&mdata->scan);
+    }
+  }
+
+  struct DirScan *ds = mdata->scan;
+  if (!ds)
+  {
+    ds = dirscan_open(AT_FDCWD, mailbox_path(m), false);
+    if (dirscan_fd(ds) < DIRSCAN_KEEP_MAX_FD)
+      mdata->scan = ds;
+  }
+
+  return ds;
+}
+
+/**
+ * mh_scan_release - Finish with a DirScan from mh_scan_folder()
+ * @param m   Mailbox
+ * @param ptr DirScan to release
+ */
+static void mh_scan_release(struct Mailbox *m, struct DirScan **ptr)
+{
+  struct MhMboxData *mdata = mh_mdata_get(m);
+  if (!mdata || (*ptr != mdata->scan))
+    dirscan_close(ptr);
+  else
+    dirscan_finish(*ptr);
+  *ptr = NULL;
+}
+
 /**
  * mh_already_notified - Has the message changed
  * @param m     Mailbox
+ * @param ds    Open folder, may be NULL
  * @param msgno Message number
  * @retval 1 Modification time on the message file is older than the last visit to this mailbox
  * @retval 0 Modification time on the message file is newer
  * @retval -1 Error
  */
-static int mh_already_notified(struct Mailbox *m, int msgno)
+static int mh_already_notified(struct Mailbox *m, struct DirScan *ds, int msgno)
 {
   char path[PATH_MAX] = { 0 };
   struct stat st = { 0 };
+  int rc;
 
-  if ((snprintf(path, sizeof(path), "%s/%d", mailbox_path(m), msgno) < sizeof(path)) &&
-      (stat(path, &st) == 0))
+  if (ds)
   {
-    return (mutt_file_stat_timespec_compare(&st, MUTT_STAT_MTIME, &m->last_visited) <= 0);
+    snprintf(path, sizeof(path), "%d", msgno);
+    rc = fstatat(dirscan_fd(ds), path, &st, 0);
+  }
+  else if (snprintf(path, sizeof(path), "%s/%d", mailbox_path(m), msgno) < sizeof(path))
+  {
+    rc = stat(path, &st);
+  }
+  else
+  {
+    rc = -1;
   }
+
+  if (rc == 0)
+    return (mutt_file_stat_timespec_compare(&st, MUTT_STAT_MTIME, &m->last_visited) <= 0);
   return -1;
 }
 
@@ -118,21 +190,21 @@ static bool mh_valid_message(const char *s)
  */
 int mh_check_empty(struct Buffer *path)
 {
-  struct dirent *de = NULL;
+  const struct DirEntry *de = NULL;
   int rc = 1; /* assume empty until we find a message */
 
-  DIR *dir = mutt_file_opendir(buf_string(path), MUTT_OPENDIR_NONE);
-  if (!dir)
+  struct DirScan *ds = dirscan_open(AT_FDCWD, buf_string(path), false);
+  if (!ds)
     return -1;
-  while ((de = readdir(dir)))
+  while ((de = dirscan_next(ds)))
   {
-    if (mh_valid_message(de->d_name))
+    if (mh_valid_message(de->name))
     {
       rc = 0;
       break;
     }
   }
-  closedir(dir);
+  dirscan_close(&ds);
 
   return rc;
 }
@@ -143,8 +215,7 @@ int mh_check_empty(struct Buffer *path)
 static enum MxStatus mh_mbox_check_stats(struct Mailbox *m, uint8_t flags)
 {
   struct MhSequences mhs = { 0 };
-  DIR *dir = NULL;
-  struct dirent *de = NULL;
+  const struct DirEntry *de = NULL;
 
   /* when $mail_check_recent is set and the .mh_sequences file hasn't changed
    * since the last m visit, there is no "new mail" */
@@ -161,6 +232,7 @@ static enum MxStatus mh_mbox_check_stats(struct Mailbox *m, uint8_t flags)
   m->msg_unread = 0;
   m->msg_flagged = 0;
 
+  struct DirScan *ds = mh_scan_folder(m);
   enum MxStatus rc = MX_STATUS_OK;
   bool check_new = true;
   for (int i = mhs.max; i > 0; i--)
@@ -174,7 +246,7 @@ static enum MxStatus mh_mbox_check_stats(struct Mailbox *m, uint8_t flags)
       {
         /* if the first unseen message we encounter was in the m during the
          * last visit, don't notify about it */
-        if (!c_mail_check_recent || (mh_already_notified(m, i) == 0))
+        if (!c_mail_check_recent || (mh_already_notified(m, ds, i) == 0))
         {
           m->has_new = true;
           rc = MX_STATUS_NEW_MAIL;
@@ -189,17 +261,16 @@ static enum MxStatus mh_mbox_check_stats(struct Mailbox *m, uint8_t flags)
 
   mh_seq_free(&mhs);
 
-  dir = mutt_file_opendir(mailbox_path(m), MUTT_OPENDIR_NONE);
-  if (dir)
+  if (ds)
   {
-    while ((de = readdir(dir)))
+    while ((de = dirscan_next(ds)))
     {
-      if (*de->d_name == '.')
+      if (*de->name == '.')
         continue;
-      if (mh_valid_message(de->d_name))
+      if (mh_valid_message(de->name))
         m->msg_count++;
     }
-    closedir(dir);
+    mh_scan_release(m, &ds);
   }
 
   return rc;
@@ -245,8 +316,8 @@ static void mh_update_emails(struct MhEmailArray *mha, struct MhSequences *mhs)
  */
 static int mh_commit_msg(struct Mailbox *m, struct Message *msg, struct Email *e, bool updseq)
 {
-  struct dirent *de = NULL;
-  char *cp = NULL, *dep = NULL;
+  const struct DirEntry *de = NULL;
+  const char *cp = NULL, *dep = NULL;
   unsigned int n, hi = 0;
   char path[PATH_MAX] = { 0 };
   char tmp[16] = { 0 };
@@ -257,17 +328,17 @@ static int mh_commit_msg(struct Mailbox *m, struct Message *msg, struct Email *e
     return -1;
   }
 
-  DIR *dir = mutt_file_opendir(mailbox_path(m), MUTT_OPENDIR_NONE);
-  if (!dir)
+  struct DirScan *ds = mh_scan_folder(m);
+  if (!ds)
   {
     log_perror("%s", mailbox_path(m));
     return -1;
   }
 
   /* figure out what the next message number is */
-  while ((de = readdir(dir)))
+  while ((de = dirscan_next(ds)))
   {
-    dep = de->d_name;
+    dep = de->name;
     if (*dep == ',')
       dep++;
     cp = dep;
@@ -285,7 +356,7 @@ static int mh_commit_msg(struct Mailbox *m, struct Message *msg, struct Email *e
         hi = n;
     }
   }
-  closedir(dir);
+  mh_scan_release(m, &ds);
 
   /* Now try to rename the file to the proper name.
    * Note: We may have to try multiple times, until we find a free slot.  */
@@ -443,40 +514,37 @@ static void mh_update_mtime(struct Mailbox *m)
  */
 static int mh_parse_dir(struct Mailbox *m, struct MhEmailArray *mha, struct Progress *progress)
 {
-  struct dirent *de = NULL;
+  const struct DirEntry *de = NULL;
   int rc = 0;
   struct MhEmail *entry = NULL;
   struct Email *e = NULL;
 
-  struct Buffer *buf = buf_pool_get();
-  buf_strcpy(buf, mailbox_path(m));
-
-  DIR *dir = mutt_file_opendir(buf_string(buf), MUTT_OPENDIR_NONE);
-  if (!dir)
+  struct DirScan *ds = mh_scan_folder(m);
+  if (!ds)
   {
     rc = -1;
     goto cleanup;
   }
 
-  while (((de = readdir(dir))) && !SigInt)
+  while (((de = dirscan_next(ds))) && !SigInt)
   {
-    if (!mh_valid_message(de->d_name))
+    if (!mh_valid_message(de->name))
       continue;
 
-    log_debug2("queueing %s", de->d_name);
+    log_debug2("queueing %s", de->name);
 
     e = email_new();
 
     progress_update(progress, ARRAY_SIZE(mha) + 1, -1);
 
-    e->path = mutt_str_dup(de->d_name);
+    e->path = mutt_str_dup(de->name);
 
     entry = mh_entry_new();
     entry->email = e;
     ARRAY_ADD(mha, entry);
   }
 
-  closedir(dir);
+  mh_scan_release(m, &ds);
 
   if (SigInt)
   {
@@ -485,8 +553,6 @@ static int mh_parse_dir(struct Mailbox *m, struct MhEmailArray *mha, struct Prog
   }
 
 cleanup:
-  buf_pool_release(&buf);
-
   return rc;
 }
 
@@ -504,12 +570,13 @@ static int mh_sort_path(const void *a, const void *b, void *sdata)
  * mh_parse_message - Actually parse an MH message
  * @param fname  Message filename
  * @param e      Email to populate (OPTIONAL)
+ * @param arena  Arena to allocate from (OPTIONAL)
  * @retval ptr Populated Email
  *
  * This may also be used to fill out a fake header structure generated by lazy
  * mh parsing.
  */
-static struct Email *mh_parse_message(const char *fname, struct Email *e)
+static struct Email *mh_parse_message(const char *fname, struct Email *e, struct Arena *arena)
 {
   FILE *fp = mutt_file_fopen(fname, "r");
   if (!fp)
@@ -525,9 +592,9 @@ static struct Email *mh_parse_message(const char *fname, struct Email *e)
   }
 
   if (!e)
-    e = email_new();
+    e = email_new_arena(arena);
 
-  e->env = mutt_rfc822_read_header(fp, e, false, false);
+  e->env = mutt_rfc822_read_header_lazy(fp, e, arena);
 
   if (e->received != 0)
     e->received = e->date_sent;
@@ -540,20 +607,52 @@ static struct Email *mh_parse_message(const char *fname, struct Email *e)
   return e;
 }
 
+#ifdef USE_HCACHE
+/**
+ * mh_hcache_open - Get the Mailbox's Header Cache
+ * @param m     Mailbox
+ * @param arena Arena to allocate fetched Emails from (optional)
+ * @retval ptr  Header Cache, owned by the Mailbox
+ * @retval NULL No Header Cache
+ *
+ * The Header Cache is opened on first use and stays open until the Mailbox is
+ * closed.  Its writes are batched.
+ */
+static struct HeaderCache *mh_hcache_open(struct Mailbox *m, struct Arena *arena)
+{
+  struct MhMboxData *mdata = mh_mdata_get(m);
+  if (!mdata)
+    return NULL;
+
+  if (!mdata->hcache)
+  {
+    const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
+    mdata->hcache = hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+    if (mdata->hcache)
+      mdata->hcache->batch = true;
+  }
+
+  if (mdata->hcache)
+    mdata->hcache->arena = arena;
+
+  return mdata->hcache;
+}
+#endif
+
 /**
  * mh_delayed_parsing - This function does the second parsing pass
- * @param[in]  m   Mailbox
- * @param[out] mha Mh array to parse
+ * @param[in]  m        Mailbox
+ * @param[out] mha      Mh array to parse
  * @param[in]  progress Progress bar
+ * @param[in]  arena    Arena to allocate the Emails from (optional)
  */
 static void mh_delayed_parsing(struct Mailbox *m, struct MhEmailArray *mha,
-                               struct Progress *progress)
+                               struct Progress *progress, struct Arena *arena)
 {
   char fn[PATH_MAX] = { 0 };
 
 #ifdef USE_HCACHE
-  const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
-  struct HeaderCache *hc = hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+  struct HeaderCache *hc = mh_hcache_open(m, arena);
 #endif
 
   struct MhEmail *md = NULL;
@@ -583,7 +682,7 @@ static void mh_delayed_parsing(struct Mailbox *m, struct MhEmailArray *mha,
     {
       snprintf(fn, sizeof(fn), "%s/%s", mailbox_path(m), md->email->path);
 
-      if (mh_parse_message(fn, md->email))
+      if (mh_parse_message(fn, md->email, arena))
       {
         md->header_parsed = true;
 #ifdef USE_HCACHE
@@ -598,9 +697,6 @@ static void mh_delayed_parsing(struct Mailbox *m, struct MhEmailArray *mha,
       }
     }
   }
-#ifdef USE_HCACHE
-  hcache_close(&hc);
-#endif
 
   const enum SortType c_sort = cs_subset_sort(SpaceMutt->sub, "sort");
   if (m && mha && (ARRAY_SIZE(mha) > 0) && (c_sort == SORT_ORDER))
@@ -697,7 +793,7 @@ static bool mh_read_dir(struct Mailbox *m)
     progress = progress_new(MUTT_PROGRESS_READ, ARRAY_SIZE(&mha));
     progress_set_message(progress, _("Reading %s..."), mailbox_path(m));
   }
-  mh_delayed_parsing(m, &mha, progress);
+  mh_delayed_parsing(m, &mha, progress, mailbox_arena(m));
   progress_free(&progress);
 
   if (mh_seq_read(&mhs, mailbox_path(m)) < 0)
@@ -787,10 +883,8 @@ static int mh_msg_save_hcache(struct Mailbox *m, struct Email *e)
 {
   int rc = 0;
 #ifdef USE_HCACHE
-  const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
-  struct HeaderCache *hc = hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+  struct HeaderCache *hc = mh_hcache_open(m, NULL);
   rc = hcache_store_email(hc, e->path, strlen(e->path), e, 0);
-  hcache_close(&hc);
 #endif
   return rc;
 }
@@ -975,7 +1069,7 @@ static enum MxStatus mh_check(struct Mailbox *m)
   struct MhEmailArray mha = ARRAY_HEAD_INITIALIZER;
 
   mh_parse_dir(m, &mha, NULL);
-  mh_delayed_parsing(m, &mha, NULL);
+  mh_delayed_parsing(m, &mha, NULL, NULL);
 
   if (mh_seq_read(&mhs, mailbox_path(m)) < 0)
     return MX_STATUS_ERROR;
@@ -1069,8 +1163,7 @@ static enum MxStatus mh_mbox_sync(struct Mailbox *m)
 
   struct HeaderCache *hc = NULL;
 #ifdef USE_HCACHE
-  const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
-  hc = hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+  hc = mh_hcache_open(m, NULL);
 #endif
 
   struct Progress *progress = NULL;
@@ -1094,7 +1187,7 @@ static enum MxStatus mh_mbox_sync(struct Mailbox *m)
   progress_free(&progress);
 
 #ifdef USE_HCACHE
-  hcache_close(&hc);
+  hcache_flush(hc);
 #endif
 
   mh_seq_update(m);
@@ -1122,7 +1215,7 @@ static enum MxStatus mh_mbox_sync(struct Mailbox *m)
 
 err:
 #ifdef USE_HCACHE
-  hcache_close(&hc);
+  hcache_flush(hc);
 #endif
   return MX_STATUS_ERROR;
 }
@@ -1133,9 +1226,39 @@ err:
  */
 static enum MxStatus mh_mbox_close(struct Mailbox *m)
 {
+#ifdef USE_HCACHE
+  struct MhMboxData *mdata = mh_mdata_get(m);
+  if (mdata)
+    hcache_close(&mdata->hcache);
+#endif
   return MX_STATUS_OK;
 }
 
+/**
+ * mh_mbox_hcache_gc - Remove stale entries from the header cache - Implements MxOps::mbox_hcache_gc() - @ingroup mx_mbox_hcache_gc
+ */
+static int mh_mbox_hcache_gc(struct Mailbox *m, bool force)
+{
+  int rc = -1;
+#ifdef USE_HCACHE
+  struct HeaderCache *hc = mh_hcache_open(m, NULL);
+  if (!hc || (!force && !hcache_gc_due(hc)))
+    return -1;
+
+  struct HashTable *live = mutt_hash_new(MAX(m->msg_count, 32), MUTT_HASH_NO_FLAGS);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (e && e->path)
+      mutt_hash_insert(live, e->path, e);
+  }
+
+  rc = hcache_gc(hc, live, NULL);
+  mutt_hash_free(&live);
+#endif
+  return rc;
+}
+
 /**
  * mh_msg_open - Open an email message in a Mailbox - Implements MxOps::msg_open() - @ingroup mx_msg_open
  */
@@ -1254,6 +1377,7 @@ const struct MxOps MxMhOps = {
   .msg_close        = mh_msg_close,
   .msg_padding_size = NULL,
   .msg_save_hcache  = mh_msg_save_hcache,
+  .mbox_hcache_gc   = mh_mbox_hcache_gc,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
   .path_probe       = mh_path_probe,
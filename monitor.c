@@ -66,9 +66,22 @@ static size_t PollFdsLen = 0;
 static struct pollfd *PollFds = NULL;
 /// Monitor file descriptor of the current mailbox
 static int MonitorCurMboxDescriptor = -1;
+/// Monitor file descriptor of the 'cur' directory of the current Maildir mailbox
+static int MonitorCurMboxCurDescriptor = -1;
+/// Path of the current Maildir mailbox, whose file events are queued
+static char *MonitorCurMboxPath = NULL;
+/// File events of the current Maildir mailbox, waiting to be applied
+static struct MonitorEventArray MonitorCurMboxEvents = ARRAY_HEAD_INITIALIZER;
+/// Set to true when file events of the current mailbox have been lost
+static bool MonitorCurMboxOverflow = false;
 
 #define INOTIFY_MASK_DIR (IN_MOVED_TO | IN_ATTRIB | IN_CLOSE_WRITE | IN_ISDIR)
 #define INOTIFY_MASK_FILE IN_CLOSE_WRITE
+/// Extra events for the 'new' and 'cur' directories of the current Maildir mailbox
+#define INOTIFY_MASK_EVENTS (IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE)
+
+/// Maximum number of queued file events before falling back to a full scan
+#define MONITOR_EVENTS_MAX 10000
 
 #define EVENT_BUFLEN MAX(4096, sizeof(struct inotify_event) + NAME_MAX + 1)
 
@@ -204,6 +217,7 @@ static void monitor_check_cleanup(void)
     mutt_poll_fd_remove(INotifyFd);
     close(INotifyFd);
     INotifyFd = -1;
+    MonitorCurMboxCurDescriptor = -1;
     MonitorFilesChanged = false;
   }
 }
@@ -317,6 +331,129 @@ static int monitor_handle_ignore(int desc)
   return new_desc;
 }
 
+/**
+ * mutt_monitor_events_free - Free an array of file events
+ * @param events Events to free
+ */
+void mutt_monitor_events_free(struct MonitorEventArray *events)
+{
+  if (!events)
+    return;
+
+  struct MonitorEvent *ev = NULL;
+  ARRAY_FOREACH(ev, events)
+  {
+    FREE(&ev->name);
+  }
+  ARRAY_FREE(events);
+}
+
+/**
+ * monitor_event_queue - Queue a file event of the current Maildir mailbox
+ * @param event  inotify event
+ * @param subdir Subdirectory the event belongs to, "new" or "cur"
+ */
+static void monitor_event_queue(const struct inotify_event *event, const char *subdir)
+{
+  if (!MonitorCurMboxPath || MonitorCurMboxOverflow)
+    return;
+
+  if ((event->len == 0) || (event->mask & IN_ISDIR) || (event->name[0] == '.'))
+    return;
+
+  enum MonitorEventType type;
+  if (event->mask & (IN_CREATE | IN_MOVED_TO))
+    type = MONITOR_EV_ADDED;
+  else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+    type = MONITOR_EV_REMOVED;
+  else
+    return;
+
+  if (ARRAY_SIZE(&MonitorCurMboxEvents) >= MONITOR_EVENTS_MAX)
+  {
+    log_debug3("too many file events queued, a full scan is needed");
+    mutt_monitor_events_free(&MonitorCurMboxEvents);
+    MonitorCurMboxOverflow = true;
+    return;
+  }
+
+  struct MonitorEvent ev = { type, subdir, mutt_str_dup(event->name) };
+  ARRAY_ADD(&MonitorCurMboxEvents, ev);
+}
+
+/**
+ * monitor_cur_mbox_attach - Watch the files of the current Maildir mailbox
+ *
+ * The 'new' directory is watched by the regular Monitor.  Only for the current
+ * mailbox, its mask is widened and 'cur' is watched too.  The file events of
+ * both directories are queued, so that the Maildir backend can apply them
+ * without rescanning the mailbox.
+ *
+ * Changes made before the watches were added are unknown, so the first check
+ * of the mailbox rescans it.
+ */
+static void monitor_cur_mbox_attach(void)
+{
+  struct Mailbox *m_cur = get_current_mailbox();
+  if (!m_cur || (m_cur->type != MUTT_MAILDIR) || MonitorCurMboxPath)
+    return;
+
+  struct Buffer *path = buf_pool_get();
+  buf_printf(path, "%s/new", m_cur->realpath);
+  int desc = inotify_add_watch(INotifyFd, buf_string(path), IN_MASK_ADD | INOTIFY_MASK_EVENTS);
+  if (desc != -1)
+  {
+    buf_printf(path, "%s/cur", m_cur->realpath);
+    desc = inotify_add_watch(INotifyFd, buf_string(path), INOTIFY_MASK_EVENTS);
+    if (desc == -1)
+    {
+      log_debug2("inotify_add_watch failed for '%s', errno=%d %s",
+                 buf_string(path), errno, strerror(errno));
+
+      /* Narrow the mask of 'new' again */
+      buf_printf(path, "%s/new", m_cur->realpath);
+      inotify_add_watch(INotifyFd, buf_string(path), INOTIFY_MASK_DIR);
+    }
+  }
+  else
+  {
+    log_debug2("inotify_add_watch failed for '%s', errno=%d %s",
+               buf_string(path), errno, strerror(errno));
+  }
+
+  if (desc != -1)
+  {
+    log_debug3("inotify_add_watch descriptor=%d for '%s'", desc, buf_string(path));
+    MonitorCurMboxCurDescriptor = desc;
+    MonitorCurMboxPath = mutt_str_dup(m_cur->realpath);
+  }
+  MonitorCurMboxOverflow = true;
+  MonitorCurMboxChanged = true;
+  buf_pool_release(&path);
+}
+
+/**
+ * monitor_cur_mbox_detach - Stop watching the files of the current mailbox
+ */
+static void monitor_cur_mbox_detach(void)
+{
+  if ((MonitorCurMboxCurDescriptor != -1) && (INotifyFd != -1))
+  {
+    inotify_rm_watch(INotifyFd, MonitorCurMboxCurDescriptor);
+    log_debug3("inotify_rm_watch descriptor=%d", MonitorCurMboxCurDescriptor);
+
+    /* Narrow the mask of 'new' again, it may be shared with a background Mailbox */
+    struct Buffer *path = buf_pool_get();
+    buf_printf(path, "%s/new", MonitorCurMboxPath);
+    inotify_add_watch(INotifyFd, buf_string(path), INOTIFY_MASK_DIR);
+    buf_pool_release(&path);
+  }
+  MonitorCurMboxCurDescriptor = -1;
+  FREE(&MonitorCurMboxPath);
+  mutt_monitor_events_free(&MonitorCurMboxEvents);
+  MonitorCurMboxOverflow = false;
+}
+
 /**
  * monitor_resolve - Get the monitor for a mailbox
  * @param[out] info Details of the mailbox's monitor
@@ -455,10 +592,33 @@ int mutt_monitor_poll(void)
                 event = (const struct inotify_event *) ptr;
                 log_debug3("+ detail: descriptor=%d mask=0x%x",
                            event->wd, event->mask);
-                if (event->mask & IN_IGNORED)
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                  MonitorCurMboxOverflow = true;
+                  MonitorCurMboxChanged = true;
+                }
+                else if (event->wd == MonitorCurMboxCurDescriptor)
+                {
+                  if (event->mask & IN_IGNORED)
+                  {
+                    MonitorCurMboxCurDescriptor = -1;
+                    MonitorCurMboxOverflow = true;
+                  }
+                  else
+                  {
+                    monitor_event_queue(event, "cur");
+                  }
+                  MonitorCurMboxChanged = true;
+                }
+                else if (event->mask & IN_IGNORED)
+                {
                   monitor_handle_ignore(event->wd);
+                }
                 else if (event->wd == MonitorCurMboxDescriptor)
+                {
+                  monitor_event_queue(event, "new");
                   MonitorCurMboxChanged = true;
+                }
                 ptr += sizeof(struct inotify_event) + event->len;
               }
             }
@@ -490,7 +650,10 @@ int mutt_monitor_add(struct Mailbox *m)
   if (desc != RESOLVE_RES_OK_NOTEXISTING)
   {
     if (!m && (desc == RESOLVE_RES_OK_EXISTING))
+    {
       MonitorCurMboxDescriptor = info.monitor->desc;
+      monitor_cur_mbox_attach();
+    }
     rc = (desc == RESOLVE_RES_OK_EXISTING) ? 0 : -1;
     goto cleanup;
   }
@@ -507,7 +670,10 @@ int mutt_monitor_add(struct Mailbox *m)
 
   log_debug3("inotify_add_watch descriptor=%d for '%s'", desc, info.path);
   if (!m)
+  {
     MonitorCurMboxDescriptor = desc;
+    monitor_cur_mbox_attach();
+  }
 
   monitor_new(&info, desc);
 
@@ -535,6 +701,7 @@ int mutt_monitor_remove(struct Mailbox *m)
   {
     MonitorCurMboxDescriptor = -1;
     MonitorCurMboxChanged = false;
+    monitor_cur_mbox_detach();
   }
 
   if (monitor_resolve(&info, m) != RESOLVE_RES_OK_EXISTING)
@@ -577,3 +744,35 @@ cleanup:
   monitor_info_free(&info2);
   return rc;
 }
+
+/**
+ * mutt_monitor_take_events - Take the queued file events of the current mailbox
+ * @param[in]  m      Mailbox
+ * @param[out] events Array for the events, in the order they occurred
+ * @retval true  The events describe all the changes to the Mailbox
+ * @retval false Events were lost, or the Mailbox isn't monitored; it must be rescanned
+ *
+ * The queue is emptied in either case.
+ */
+bool mutt_monitor_take_events(struct Mailbox *m, struct MonitorEventArray *events)
+{
+  if (!m || !events)
+    return false;
+
+  bool rc = MonitorCurMboxPath && !MonitorCurMboxOverflow &&
+            (MonitorCurMboxCurDescriptor != -1) && (MonitorCurMboxDescriptor != -1) &&
+            mutt_str_equal(MonitorCurMboxPath, m->realpath);
+
+  if (rc)
+  {
+    *events = MonitorCurMboxEvents;
+    ARRAY_INIT(&MonitorCurMboxEvents);
+  }
+  else
+  {
+    mutt_monitor_events_free(&MonitorCurMboxEvents);
+  }
+  MonitorCurMboxOverflow = false;
+
+  return rc;
+}
@@ -25,14 +25,37 @@
 #define MUTT_MONITOR_H
 
 #include <stdbool.h>
+#include "mutt/lib.h"
 
 struct Mailbox;
 
+/**
+ * enum MonitorEventType - Change to an entry of a monitored directory
+ */
+enum MonitorEventType
+{
+  MONITOR_EV_ADDED,   ///< File was created or moved into the directory
+  MONITOR_EV_REMOVED, ///< File was deleted or moved out of the directory
+};
+
+/**
+ * struct MonitorEvent - A change to a file in the current Maildir mailbox
+ */
+struct MonitorEvent
+{
+  enum MonitorEventType type; ///< What happened to the file
+  const char *subdir;         ///< Subdirectory, "new" or "cur"
+  char *name;                 ///< Filename, relative to the subdirectory
+};
+ARRAY_HEAD(MonitorEventArray, struct MonitorEvent);
+
 extern bool MonitorFilesChanged;   ///< true after a monitored file has changed
 extern bool MonitorCurMboxChanged; ///< true after the current mailbox has changed
 
 int mutt_monitor_add(struct Mailbox *m);
 int mutt_monitor_remove(struct Mailbox *m);
 int mutt_monitor_poll(void);
+bool mutt_monitor_take_events(struct Mailbox *m, struct MonitorEventArray *events);
+void mutt_monitor_events_free(struct MonitorEventArray *events);
 
 #endif /* MUTT_MONITOR_H */
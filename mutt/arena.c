@@ -0,0 +1,228 @@
+/**
+ * @file
+ * Bump allocator for objects that share a lifetime
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mutt_arena Bump allocator
+ *
+ * An Arena hands out memory from large chunks.  Allocating is a pointer bump
+ * and there's no per-object free.  Everything is released at once by
+ * arena_free().
+ *
+ * This suits lots of small objects that die together, e.g. the Emails of a
+ * Mailbox.  Objects from an Arena must not be passed to FREE().
+ *
+ * An Arena can be shared by reference counting.  The creator holds the first
+ * reference and long-lived objects take one each, with arena_ref().  The
+ * memory is released when the last one is dropped, with arena_release().
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "arena.h"
+#include "memory.h"
+
+/// Alignment of every allocation
+#define ARENA_ALIGN 16
+
+/// Default size of a chunk
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+/**
+ * struct ArenaChunk - A block of memory in an Arena
+ */
+struct ArenaChunk
+{
+  struct ArenaChunk *next; ///< Older chunk
+  size_t size;             ///< Size of data
+  size_t used;             ///< Bytes used in data
+  max_align_t data[];      ///< Memory to hand out
+};
+
+/**
+ * arena_new - Create an Arena
+ * @param chunk_size Size of each chunk, 0 for the default
+ * @retval ptr New Arena
+ */
+struct Arena *arena_new(size_t chunk_size)
+{
+  struct Arena *arena = g_new0(struct Arena, 1);
+  arena->chunk_size = (chunk_size == 0) ? ARENA_CHUNK_SIZE : chunk_size;
+  arena->refs = 1;
+  return arena;
+}
+
+/**
+ * arena_ref - Take a reference to an Arena
+ * @param arena Arena
+ * @retval ptr The same Arena
+ */
+struct Arena *arena_ref(struct Arena *arena)
+{
+  if (arena)
+    arena->refs++;
+  return arena;
+}
+
+/**
+ * arena_release - Drop a reference to an Arena
+ * @param ptr Arena to release
+ *
+ * The Arena is freed when its last reference is dropped.
+ */
+void arena_release(struct Arena **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct Arena *arena = *ptr;
+  *ptr = NULL;
+
+  if (arena->refs > 0)
+    arena->refs--;
+  if (arena->refs == 0)
+    arena_free(&arena);
+}
+
+/**
+ * arena_free - Free an Arena and everything allocated from it
+ * @param ptr Arena to free
+ *
+ * Any references are ignored.
+ */
+void arena_free(struct Arena **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct Arena *arena = *ptr;
+  struct ArenaChunk *chunk = arena->chunks;
+  while (chunk)
+  {
+    struct ArenaChunk *next = chunk->next;
+    FREE(&chunk);
+    chunk = next;
+  }
+
+  FREE(ptr);
+}
+
+/**
+ * arena_chunk_new - Add a chunk to an Arena
+ * @param arena Arena
+ * @param size  Minimum amount of space needed
+ * @retval ptr New chunk
+ *
+ * Oversized requests get a chunk of their own, behind the current one, so
+ * the space left in the current chunk isn't wasted.
+ */
+static struct ArenaChunk *arena_chunk_new(struct Arena *arena, size_t size)
+{
+  const bool big = (size > (arena->chunk_size / 4));
+  const size_t data_size = big ? size : arena->chunk_size;
+
+  struct ArenaChunk *chunk = g_malloc(sizeof(struct ArenaChunk) + data_size);
+  chunk->size = data_size;
+  chunk->used = 0;
+
+  if (big && arena->chunks)
+  {
+    chunk->next = arena->chunks->next;
+    arena->chunks->next = chunk;
+  }
+  else
+  {
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+  }
+
+  return chunk;
+}
+
+/**
+ * arena_alloc - Allocate zeroed memory from an Arena
+ * @param arena Arena
+ * @param size  Number of bytes
+ * @retval ptr Memory, aligned for any type
+ */
+void *arena_alloc(struct Arena *arena, size_t size)
+{
+  if (!arena)
+    return NULL;
+
+  size = (size + (ARENA_ALIGN - 1)) & ~((size_t) ARENA_ALIGN - 1);
+  if (size == 0)
+    size = ARENA_ALIGN;
+
+  struct ArenaChunk *chunk = arena->chunks;
+  if (!chunk || ((chunk->size - chunk->used) < size))
+    chunk = arena_chunk_new(arena, size);
+
+  void *ptr = (char *) chunk->data + chunk->used;
+  chunk->used += size;
+  arena->allocated += size;
+
+  memset(ptr, 0, size);
+  return ptr;
+}
+
+/**
+ * arena_strdup - Copy a string into an Arena
+ * @param arena Arena
+ * @param str   String to copy
+ * @retval ptr Copy of the string
+ * @retval NULL str was NULL
+ */
+char *arena_strdup(struct Arena *arena, const char *str)
+{
+  if (!arena || !str)
+    return NULL;
+
+  const size_t len = strlen(str);
+  char *copy = arena_alloc(arena, len + 1);
+  memcpy(copy, str, len);
+  return copy;
+}
+
+/**
+ * arena_owns - Was this memory allocated from an Arena?
+ * @param arena Arena
+ * @param ptr   Memory to check
+ * @retval true ptr lies in one of the Arena's chunks
+ */
+bool arena_owns(const struct Arena *arena, const void *ptr)
+{
+  if (!arena || !ptr)
+    return false;
+
+  const uintptr_t p = (uintptr_t) ptr;
+  for (const struct ArenaChunk *chunk = arena->chunks; chunk; chunk = chunk->next)
+  {
+    const uintptr_t start = (uintptr_t) chunk->data;
+    if ((p >= start) && (p < (start + chunk->used)))
+      return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file
+ * Bump allocator for objects that share a lifetime
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MUTT_ARENA_H
+#define MUTT_MUTT_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct ArenaChunk;
+
+/**
+ * struct Arena - A bump allocator
+ *
+ * Memory is handed out from large chunks and is only released when the whole
+ * Arena is freed.
+ */
+struct Arena
+{
+  struct ArenaChunk *chunks; ///< Chunks, newest first
+  size_t chunk_size;         ///< Size of a new chunk
+  size_t allocated;          ///< Number of bytes handed out
+  size_t refs;               ///< References, see arena_ref()
+};
+
+void *        arena_alloc  (struct Arena *arena, size_t size);
+void          arena_free   (struct Arena **ptr);
+struct Arena *arena_new    (size_t chunk_size);
+bool          arena_owns   (const struct Arena *arena, const void *ptr);
+struct Arena *arena_ref    (struct Arena *arena);
+void          arena_release(struct Arena **ptr);
+char *        arena_strdup (struct Arena *arena, const char *str);
+
+#endif /* MUTT_MUTT_ARENA_H */
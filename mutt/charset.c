@@ -41,6 +41,7 @@
 #include "charset.h"
 #include "buffer.h"
 #include "logging2.h"
+#include "mbyte.h"
 #include "memory.h"
 #include "pool.h"
 #include "regex3.h"
@@ -1025,6 +1026,45 @@ int mutt_ch_fgetconv(struct FgetConv *fc)
   return EOF;
 }
 
+/**
+ * mutt_ch_fgetconv_read - Convert a block of a file's character set
+ * @param fc     FgetConv handle
+ * @param buf    Buffer for the result
+ * @param buflen Length of the buffer
+ * @retval num Number of bytes read, 0 at the end of the file
+ *
+ * Unlike mutt_ch_fgetconv(), the data isn't returned one character at a time.
+ * If there's no conversion, the file is read directly.
+ */
+size_t mutt_ch_fgetconv_read(struct FgetConv *fc, char *buf, size_t buflen)
+{
+  if (!fc || !buf)
+    return 0;
+  if (!iconv_t_valid(fc->cd))
+    return fread(buf, 1, buflen, fc->fp);
+
+  size_t len = 0;
+  while (len < buflen)
+  {
+    /* Take whatever has already been converted */
+    if (fc->p && (fc->p < fc->ob))
+    {
+      const size_t n = MIN((size_t) (fc->ob - fc->p), buflen - len);
+      memcpy(buf + len, fc->p, n);
+      fc->p += n;
+      len += n;
+      continue;
+    }
+
+    const int c = mutt_ch_fgetconv(fc);
+    if (c == EOF)
+      break;
+    buf[len++] = (char) c;
+  }
+
+  return len;
+}
+
 /**
  * mutt_ch_fgetconvs - Convert a file's charset into a string buffer
  * @param buf    Buffer for result
@@ -1063,7 +1103,8 @@ char *mutt_ch_fgetconvs(char *buf, size_t buflen, struct FgetConv *fc)
  * @param charset New character set
  *
  * Check if this character set is utf-8 and pick a suitable replacement
- * character for unprintable characters.
+ * character for unprintable characters.  The table of character widths is
+ * rebuilt.
  *
  * @note This calls `bind_textdomain_codeset()` which will affect future
  * message translations.
@@ -1085,6 +1126,9 @@ void mutt_ch_set_charset(const char *charset)
     ReplacementChar = '?';
   }
 
+  /* The locale may have changed, too */
+  mutt_mb_width_reset();
+
 #if defined(HAVE_BIND_TEXTDOMAIN_CODESET) && defined(ENABLE_NLS)
   bind_textdomain_codeset(PACKAGE, buf);
 #endif
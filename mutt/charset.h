@@ -84,6 +84,7 @@ int              mutt_ch_convert_string(char **ps, const char *from, const char
 int              mutt_ch_fgetconv(struct FgetConv *fc);
 void             mutt_ch_fgetconv_close(struct FgetConv **ptr);
 struct FgetConv *mutt_ch_fgetconv_open(FILE *fp, const char *from, const char *to, uint8_t flags);
+size_t           mutt_ch_fgetconv_read(struct FgetConv *fc, char *buf, size_t buflen);
 char *           mutt_ch_fgetconvs(char *buf, size_t buflen, struct FgetConv *fc);
 const char *     mutt_ch_get_default_charset(const struct StrList *const assumed_charset);
 char *           mutt_ch_get_langinfo_charset(void);
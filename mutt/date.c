@@ -823,6 +823,24 @@ int mutt_date_make_imap(struct Buffer *buf, time_t timestamp)
                     tm.tm_sec, tz / 60, abs(tz) % 60);
 }
 
+/**
+ * mutt_date_make_imap_day - Format a day in IMAP SEARCH style: D-MMM-YYYY
+ * @param buf       Buffer to store the results
+ * @param timestamp Time to format
+ * @retval num Characters written to buf
+ *
+ * e.g., 5-Mar-2016. The day is always in UTC.
+ */
+int mutt_date_make_imap_day(struct Buffer *buf, time_t timestamp)
+{
+  if (!buf)
+    return -1;
+
+  struct tm tm = mutt_date_gmtime(timestamp);
+
+  return buf_printf(buf, "%d-%s-%d", tm.tm_mday, Months[tm.tm_mon], tm.tm_year + 1900);
+}
+
 /**
  * mutt_date_make_tls - Format date in TLS certificate verification style
  * @param buf       Buffer to store the results
@@ -0,0 +1,340 @@
+/**
+ * @file
+ * Read directories with few syscalls
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mutt_dirscan Read directories with few syscalls
+ *
+ * A DirScan reads a directory through a descriptor that can be kept open and
+ * rewound between scans, e.g. for every mailbox check.  The descriptor can be
+ * used with openat() and fstatat(), so callers don't need to build full paths.
+ *
+ * On Linux the entries are read with getdents64() into a large buffer, so a
+ * directory of 200,000 files takes a few dozen syscalls.  Elsewhere, readdir()
+ * is used.  The buffer is only held during a scan; one spare is kept for the
+ * next scan, so a DirScan that's kept open between scans costs little memory.
+ *
+ * The entry's type comes from the directory, if the filesystem supports it,
+ * which often saves a stat().
+ */
+
+#include "config.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dirscan.h"
+#include "file.h"
+#include "logging2.h"
+#include "memory.h"
+#include "trace.h"
+#if defined(__linux__) && defined(HAVE_SYS_SYSCALL_H)
+#include <sys/syscall.h>
+#endif
+
+#ifdef SYS_getdents64
+/// Size of the buffer for getdents64()
+#define DIRSCAN_BUFSIZE (256 * 1024)
+
+/**
+ * struct LinuxDirent64 - Directory entry, as returned by getdents64()
+ */
+struct LinuxDirent64
+{
+  uint64_t d_ino;           ///< Inode number
+  int64_t d_off;            ///< Offset to the next entry
+  unsigned short d_reclen;  ///< Length of this entry
+  unsigned char d_type;     ///< File type
+  char d_name[];            ///< Filename
+};
+
+/// A getdents64() buffer that no DirScan is using
+static char *SpareBuf = NULL;
+#endif
+
+/**
+ * struct DirScan - An open directory
+ */
+struct DirScan
+{
+  int fd;             ///< Directory descriptor
+  dev_t dev;          ///< Device of the directory
+  ino_t ino;          ///< Inode of the directory
+  struct DirEntry de; ///< Current entry
+#ifdef SYS_getdents64
+  char *buf;          ///< Buffer for getdents64()
+  size_t len;         ///< Number of bytes in the buffer
+  size_t pos;         ///< Offset of the next entry in the buffer
+  bool eof;           ///< No more entries
+#else
+  DIR *dir;           ///< Directory stream, using a copy of the descriptor
+#endif
+};
+
+#ifdef SYS_getdents64
+/**
+ * dirscan_buf_release - Give up a DirScan's buffer
+ * @param ds DirScan
+ *
+ * The buffer is kept for the next scan, unless there's already a spare.
+ */
+static void dirscan_buf_release(struct DirScan *ds)
+{
+  if (!ds->buf)
+    return;
+
+  if (SpareBuf)
+    FREE(&ds->buf);
+  else
+    SpareBuf = ds->buf;
+
+  ds->buf = NULL;
+  ds->len = 0;
+  ds->pos = 0;
+}
+#endif
+
+/**
+ * dirscan_open - Open a directory for scanning
+ * @param dirfd  Directory that a relative path is relative to, or AT_FDCWD
+ * @param path   Path of the directory
+ * @param create Create the directory if it doesn't exist
+ * @retval ptr  New DirScan
+ * @retval NULL Error, see errno
+ */
+struct DirScan *dirscan_open(int dirfd, const char *path, bool create)
+{
+  if (!path)
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+  int fd = openat(dirfd, path, flags);
+  if ((fd < 0) && (errno == ENOENT) && create)
+  {
+    const int rc = (dirfd == AT_FDCWD) ? mutt_file_mkdir(path, S_IRWXU) :
+                                         mkdirat(dirfd, path, S_IRWXU);
+    if ((rc == 0) || (errno == EEXIST))
+      fd = openat(dirfd, path, flags);
+  }
+  if (fd < 0)
+    return NULL;
+
+  struct stat st = { 0 };
+  if (fstat(fd, &st) != 0)
+  {
+    const int err = errno;
+    close(fd);
+    errno = err;
+    return NULL;
+  }
+
+  struct DirScan *ds = g_new0(struct DirScan, 1);
+  ds->fd = fd;
+  ds->dev = st.st_dev;
+  ds->ino = st.st_ino;
+
+#ifndef SYS_getdents64
+  int fd2 = dup(fd);
+  ds->dir = (fd2 < 0) ? NULL : fdopendir(fd2);
+  if (!ds->dir)
+  {
+    const int err = errno;
+    if (fd2 >= 0)
+      close(fd2);
+    close(fd);
+    FREE(&ds);
+    errno = err;
+    return NULL;
+  }
+#endif
+
+  return ds;
+}
+
+/**
+ * dirscan_close - Close a DirScan
+ * @param ptr DirScan to close
+ */
+void dirscan_close(struct DirScan **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct DirScan *ds = *ptr;
+#ifdef SYS_getdents64
+  dirscan_buf_release(ds);
+#else
+  closedir(ds->dir);
+#endif
+  close(ds->fd);
+  FREE(ptr);
+}
+
+/**
+ * dirscan_fd - Get the descriptor of a DirScan
+ * @param ds DirScan
+ * @retval num Descriptor, for use with openat() and fstatat()
+ * @retval -1  Error
+ */
+int dirscan_fd(const struct DirScan *ds)
+{
+  return ds ? ds->fd : -1;
+}
+
+/**
+ * dirscan_rewind - Start reading a directory from the beginning
+ * @param ds DirScan
+ * @retval true Success
+ *
+ * The next scan sees the current contents of the directory.
+ */
+bool dirscan_rewind(struct DirScan *ds)
+{
+  if (!ds)
+    return false;
+
+#ifdef SYS_getdents64
+  dirscan_buf_release(ds);
+  ds->eof = false;
+  return lseek(ds->fd, 0, SEEK_SET) == 0;
+#else
+  rewinddir(ds->dir);
+  return true;
+#endif
+}
+
+/**
+ * dirscan_finish - Finish a scan early
+ * @param ds DirScan
+ *
+ * Release the memory used by a scan that stopped before the end of the
+ * directory.  The DirScan can be kept, but must be rewound before the next
+ * scan.
+ */
+void dirscan_finish(struct DirScan *ds)
+{
+  if (!ds)
+    return;
+
+#ifdef SYS_getdents64
+  dirscan_buf_release(ds);
+  ds->eof = true;
+#endif
+}
+
+/**
+ * dirscan_same - Is this the directory that was opened?
+ * @param ds DirScan
+ * @param st Result of a stat() of the directory's path
+ * @retval true The path still refers to the open directory
+ *
+ * If the directory has been replaced, the DirScan should be reopened.
+ */
+bool dirscan_same(const struct DirScan *ds, const struct stat *st)
+{
+  return ds && st && (ds->dev == st->st_dev) && (ds->ino == st->st_ino);
+}
+
+/**
+ * dirscan_next - Read the next entry of a directory
+ * @param ds DirScan
+ * @retval ptr  Next entry
+ * @retval NULL No more entries, or error
+ *
+ * The entries "." and ".." are skipped.
+ */
+const struct DirEntry *dirscan_next(struct DirScan *ds)
+{
+  if (!ds)
+    return NULL;
+
+#ifdef SYS_getdents64
+  while (true)
+  {
+    if (ds->pos >= ds->len)
+    {
+      if (ds->eof)
+        return NULL;
+
+      if (!ds->buf)
+      {
+        ds->buf = SpareBuf ? SpareBuf : g_malloc(DIRSCAN_BUFSIZE);
+        SpareBuf = NULL;
+      }
+
+      long n = syscall(SYS_getdents64, ds->fd, ds->buf, DIRSCAN_BUFSIZE);
+      trace_counter("dirscan_getdents", 1);
+      if (n <= 0)
+      {
+        if (n < 0)
+          log_debug1("getdents64 failed: %s", strerror(errno));
+        dirscan_buf_release(ds);
+        ds->eof = true;
+        return NULL;
+      }
+      ds->len = n;
+      ds->pos = 0;
+    }
+
+    const struct LinuxDirent64 *ld = (const struct LinuxDirent64 *) (ds->buf + ds->pos);
+    ds->pos += ld->d_reclen;
+
+    if ((ld->d_name[0] == '.') &&
+        ((ld->d_name[1] == '\0') || ((ld->d_name[1] == '.') && (ld->d_name[2] == '\0'))))
+    {
+      continue;
+    }
+
+    ds->de.name = ld->d_name;
+    ds->de.ino = ld->d_ino;
+    ds->de.type = ld->d_type;
+    return &ds->de;
+  }
+#else
+  struct dirent *de = NULL;
+  while ((de = readdir(ds->dir)))
+  {
+    if ((de->d_name[0] == '.') &&
+        ((de->d_name[1] == '\0') || ((de->d_name[1] == '.') && (de->d_name[2] == '\0'))))
+    {
+      continue;
+    }
+
+    ds->de.name = de->d_name;
+    ds->de.ino = de->d_ino;
+#ifdef DT_UNKNOWN
+    ds->de.type = de->d_type;
+#else
+    ds->de.type = 0;
+#endif
+    return &ds->de;
+  }
+  return NULL;
+#endif
+}
@@ -0,0 +1,54 @@
+/**
+ * @file
+ * Read directories with few syscalls
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MUTT_DIRSCAN_H
+#define MUTT_MUTT_DIRSCAN_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+struct DirScan;
+struct stat;
+
+/// Don't keep a DirScan open if its descriptor is this high.
+/// The usual limit is 1024, and there may be hundreds of mailboxes.
+#define DIRSCAN_KEEP_MAX_FD 256
+
+/**
+ * struct DirEntry - An entry in a directory
+ */
+struct DirEntry
+{
+  const char *name;   ///< Filename, valid until the next dirscan_next()
+  ino_t ino;          ///< Inode number
+  unsigned char type; ///< File type, e.g. DT_REG, or DT_UNKNOWN
+};
+
+void                   dirscan_close (struct DirScan **ptr);
+int                    dirscan_fd    (const struct DirScan *ds);
+void                   dirscan_finish(struct DirScan *ds);
+const struct DirEntry *dirscan_next  (struct DirScan *ds);
+struct DirScan *       dirscan_open  (int dirfd, const char *path, bool create);
+bool                   dirscan_rewind(struct DirScan *ds);
+bool                   dirscan_same  (const struct DirScan *ds, const struct stat *st);
+
+#endif /* MUTT_MUTT_DIRSCAN_H */
@@ -60,9 +60,33 @@
 #include "path.h"
 #include "pool.h"
 #include "string2.h"
+#include "trace.h"
 #ifdef USE_FLOCK
 #include <sys/file.h>
 #endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+
+/// Copies smaller than this use stdio, the syscalls aren't worth it
+#define COPY_FAST_MIN (64 * 1024)
+
+/// Largest chunk to ask the kernel to copy at once
+#define COPY_FAST_CHUNK (1024 * 1024 * 1024)
+
+/**
+ * enum CopyMethod - Ways to copy between file descriptors in the kernel
+ */
+enum CopyMethod
+{
+  COPY_FILE_RANGE, ///< copy_file_range(), may share extents or copy on the server
+  COPY_SENDFILE,   ///< sendfile(), from a file to anything
+  COPY_SPLICE,     ///< splice(), from a file to a pipe
+  COPY_MAX,
+};
+
+/// Methods the kernel doesn't implement, so we don't retry them
+static bool CopyUnsupported[COPY_MAX];
 
 /// These characters must be escaped in regular expressions
 static const char RxSpecialChars[] = "^.[$()|*+?{\\";
@@ -246,6 +270,148 @@ void mutt_file_unlink(const char *s)
   close(fd);
 }
 
+/**
+ * copy_fd_chunk - Copy part of a file in the kernel
+ * @param method Copy method, e.g. #COPY_SENDFILE
+ * @param fd_in  Source file, at its current offset
+ * @param fd_out Destination file, at its current offset
+ * @param len    Maximum number of bytes to copy
+ * @retval >0 Number of bytes copied
+ * @retval  0 End of the source file
+ * @retval -1 Error, see errno
+ *
+ * All the methods advance the offsets of both descriptors.
+ */
+static ssize_t copy_fd_chunk(enum CopyMethod method, int fd_in, int fd_out, size_t len)
+{
+  switch (method)
+  {
+#ifdef HAVE_COPY_FILE_RANGE
+    case COPY_FILE_RANGE:
+      return copy_file_range(fd_in, NULL, fd_out, NULL, len, 0);
+#endif
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    case COPY_SENDFILE:
+      return sendfile(fd_out, fd_in, NULL, len);
+#endif
+#ifdef HAVE_SPLICE
+    case COPY_SPLICE:
+      return splice(fd_in, NULL, fd_out, NULL, len, SPLICE_F_MOVE);
+#endif
+    default:
+      errno = ENOSYS;
+      return -1;
+  }
+}
+
+/**
+ * copy_fast - Copy between two streams without going through userspace
+ * @param[in]  fp_in  Source file
+ * @param[in]  fp_out Destination file
+ * @param[in]  size   Maximum number of bytes to copy
+ * @param[out] copied Number of bytes copied
+ * @retval  0 Done, or nothing could be copied: use stdio for the rest
+ * @retval -1 Error, see errno
+ *
+ * The stdio buffers are flushed and both descriptors are copied between using
+ * copy_file_range(), falling back to sendfile() and splice().  Afterwards, the
+ * streams are repositioned, so stdio can carry on from where the kernel
+ * stopped.
+ *
+ * Only regular source files are handled.  If the kernel or the filesystem
+ * doesn't support any method, nothing is copied and the caller falls back to
+ * its stdio loop.
+ */
+static int copy_fast(FILE *fp_in, FILE *fp_out, size_t size, size_t *copied)
+{
+  *copied = 0;
+
+  if (size < COPY_FAST_MIN)
+    return 0;
+
+  const int fd_in = fileno(fp_in);
+  const int fd_out = fileno(fp_out);
+  struct stat st_in = { 0 };
+  struct stat st_out = { 0 };
+  if ((fd_in < 0) || (fd_out < 0) || (fstat(fd_in, &st_in) != 0) ||
+      (fstat(fd_out, &st_out) != 0) || !S_ISREG(st_in.st_mode))
+  {
+    return 0;
+  }
+
+  // In append mode, the kernel methods either fail or ignore O_APPEND
+  const int fl_out = fcntl(fd_out, F_GETFL);
+  if ((fl_out < 0) || (fl_out & O_APPEND))
+    return 0;
+
+  const off_t pos_in = ftello(fp_in);
+  if ((pos_in < 0) || (pos_in >= st_in.st_size) ||
+      ((st_in.st_size - pos_in) < COPY_FAST_MIN))
+  {
+    return 0;
+  }
+
+  if (fflush(fp_out) != 0)
+    return -1;
+
+  // The stream may have read ahead, so point the descriptor at its position
+  if (lseek(fd_in, pos_in, SEEK_SET) != pos_in)
+    return 0;
+
+  size = MIN(size, (size_t) (st_in.st_size - pos_in));
+
+  enum CopyMethod method = COPY_FILE_RANGE;
+  int rc = 0;
+  while ((*copied < size) && (method < COPY_MAX))
+  {
+    if (CopyUnsupported[method] || ((method == COPY_FILE_RANGE) && !S_ISREG(st_out.st_mode)) ||
+        ((method == COPY_SPLICE) && !S_ISFIFO(st_out.st_mode)))
+    {
+      method++;
+      continue;
+    }
+
+    ssize_t n = copy_fd_chunk(method, fd_in, fd_out, MIN(size - *copied, COPY_FAST_CHUNK));
+    if (n > 0)
+    {
+      *copied += n;
+      continue;
+    }
+    if (n == 0) // The file has shrunk
+      break;
+    if (errno == EINTR)
+      continue;
+
+    if (errno == ENOSYS)
+      CopyUnsupported[method] = true;
+
+    if ((errno == ENOSYS) || (errno == EXDEV) || (errno == EINVAL) ||
+        (errno == EOPNOTSUPP) || (errno == EBADF) || (errno == ESPIPE))
+    {
+      log_debug3("copy method %d unsupported: %s", method, strerror(errno));
+      method++;
+      continue;
+    }
+
+    rc = -1; // A real error, e.g. ENOSPC
+    break;
+  }
+
+  const int err = errno;
+  // Resync the streams with their descriptors, discarding any read-ahead
+  if (!mutt_file_seek(fp_in, pos_in + *copied, SEEK_SET))
+    rc = -1;
+  const off_t pos_out = lseek(fd_out, 0, SEEK_CUR);
+  if ((pos_out >= 0) && (fseeko(fp_out, pos_out, SEEK_SET) != 0))
+    rc = -1;
+
+  if (*copied > 0)
+    trace_counter("file_copy_fast_bytes", *copied);
+
+  errno = err;
+  return rc;
+}
+
 /**
  * mutt_file_copy_bytes - Copy some content from one file to another
  * @param fp_in  Source file
@@ -253,12 +419,19 @@ void mutt_file_unlink(const char *s)
  * @param size   Maximum number of bytes to copy
  * @retval  0 Success
  * @retval -1 Error, see errno
+ *
+ * Large copies between files are done by the kernel, see copy_fast().
  */
 int mutt_file_copy_bytes(FILE *fp_in, FILE *fp_out, size_t size)
 {
   if (!fp_in || !fp_out)
     return -1;
 
+  size_t copied = 0;
+  if (copy_fast(fp_in, fp_out, size, &copied) != 0)
+    return -1;
+  size -= copied;
+
   while (size > 0)
   {
     char buf[2048] = { 0 };
@@ -283,13 +456,18 @@ int mutt_file_copy_bytes(FILE *fp_in, FILE *fp_out, size_t size)
  * @param fp_out Destination file
  * @retval num Success, number of bytes copied
  * @retval  -1 Error, see errno
+ *
+ * Large copies between files are done by the kernel, see copy_fast().
  */
-int mutt_file_copy_stream(FILE *fp_in, FILE *fp_out)
+ssize_t mutt_file_copy_stream(FILE *fp_in, FILE *fp_out)
 {
   if (!fp_in || !fp_out)
     return -1;
 
   size_t total = 0;
+  if (copy_fast(fp_in, fp_out, SSIZE_MAX, &total) != 0)
+    return -1;
+
   size_t l;
   char buf[1024] = { 0 };
 
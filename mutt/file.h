@@ -92,7 +92,7 @@ int         mutt_file_chmod_add(const char *path, mode_t mode);
 int         mutt_file_chmod_add_stat(const char *path, mode_t mode, struct stat *st);
 int         mutt_file_chmod_rm_stat(const char *path, mode_t mode, struct stat *st);
 int         mutt_file_copy_bytes(FILE *fp_in, FILE *fp_out, size_t size);
-int         mutt_file_copy_stream(FILE *fp_in, FILE *fp_out);
+ssize_t     mutt_file_copy_stream(FILE *fp_in, FILE *fp_out);
 time_t      mutt_file_decrease_mtime(const char *fp, struct stat *st);
 void        mutt_file_expand_fmt(struct Buffer *dest, const char *fmt, const char *src);
 void        mutt_file_expand_fmt_quote(char *dest, size_t destlen, const char *fmt, const char *src);
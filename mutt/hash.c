@@ -25,35 +25,113 @@
  * @page mutt_hash Hash Table data structure
  *
  * Hash Table data structure.
+ *
+ * The table uses open addressing with Robin Hood probing: the slots are a
+ * power-of-two array of 32-bit hashes, alongside an array of HashElem
+ * pointers.  A lookup compares hashes before keys and stops as soon as it
+ * passes the point where the key would have been put.
+ *
+ * Each slot holds one key.  Duplicate keys, #MUTT_HASH_ALLOW_DUPS, are chained
+ * from the slot's HashElem, newest first.
+ *
+ * HashElems are allocated from an Arena and never move, so callers may keep
+ * pointers to them, e.g. the Config Set.
  */
 
 #include "config.h"
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <glib.h>
 #include "hash.h"
+#include "arena.h"
 #include "memory.h"
 #include "string2.h"
 
-#define SOME_PRIME 149711
+/// Smallest number of slots in a Hash Table
+#define HASH_MIN_SLOTS 8
+
+/// Multipliers for hash_mix(), from wyhash
+#define HASH_P0 0xa0761d6478bd642fULL
+#define HASH_P1 0xe7037ed1a0b428dbULL
+#define HASH_P2 0x8ebc6af09c88c6e3ULL
+#define HASH_P3 0x589965cc75374cc3ULL
 
 /**
- * gen_hash_string - Generate a hash from a string - Implements ::hash_gen_hash_t - @ingroup hash_gen_hash_api
+ * hash_mix - Multiply two numbers and fold the 128-bit product
+ * @param a First number
+ * @param b Second number
+ * @retval num Mixed value
+ */
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+  const __uint128_t r = (__uint128_t) a * b;
+  return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+  const uint64_t ha = a >> 32, la = (uint32_t) a;
+  const uint64_t hb = b >> 32, lb = (uint32_t) b;
+  const uint64_t rh = ha * hb, rl = la * lb;
+  const uint64_t rm0 = ha * lb, rm1 = hb * la;
+  const uint64_t t = rl + (rm0 << 32);
+  const uint64_t lo = t + (rm1 << 32);
+  const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+  return lo ^ hi;
+#endif
+}
+
+/**
+ * hash_read - Read up to eight bytes as a number
+ * @param p   Bytes to read
+ * @param len Number of bytes, 0-8
+ * @retval num Bytes as a number
+ */
+static inline uint64_t hash_read(const unsigned char *p, size_t len)
+{
+  uint64_t v = 0;
+  memcpy(&v, p, len);
+  return v;
+}
+
+/**
+ * hash_bytes - Hash a block of memory
+ * @param p   Bytes to hash
+ * @param len Number of bytes
+ * @retval num Hash
  *
- * @note If the key is NULL or empty, the retval will be 0
+ * This is a simplified wyhash: 16 bytes at a time are folded in with a
+ * 64x64->128 bit multiply.
  */
-static size_t gen_hash_string(union HashKey key, size_t num_elems)
+static uint64_t hash_bytes(const unsigned char *p, size_t len)
 {
-  size_t hash = 0;
-  const unsigned char *s = (const unsigned char *) key.strkey;
-  if (!s)
-    return 0;
+  uint64_t seed = HASH_P0;
+  uint64_t a = 0, b = 0;
+  size_t i = len;
 
-  while (*s != '\0')
-    hash += ((hash << 7) + *s++);
-  hash = (hash * SOME_PRIME) % num_elems;
+  for (; i > 16; i -= 16, p += 16)
+    seed = hash_mix(hash_read(p, 8) ^ HASH_P1, hash_read(p + 8, 8) ^ seed);
 
-  return hash;
+  if (i > 8)
+  {
+    a = hash_read(p, 8);
+    b = hash_read(p + 8, i - 8);
+  }
+  else
+  {
+    a = hash_read(p, i);
+  }
+
+  return hash_mix(HASH_P1 ^ len, hash_mix(a ^ HASH_P1, b ^ seed ^ HASH_P2));
+}
+
+/**
+ * gen_hash_string - Generate a hash from a string - Implements ::hash_gen_hash_t - @ingroup hash_gen_hash_api
+ */
+static size_t gen_hash_string(union HashKey key)
+{
+  const char *s = NONULL(key.strkey);
+  return hash_bytes((const unsigned char *) s, strlen(s));
 }
 
 /**
@@ -67,19 +145,21 @@ static int cmp_key_string(union HashKey a, union HashKey b)
 /**
  * gen_hash_case_string - Generate a hash from a string (ignore the case) - Implements ::hash_gen_hash_t - @ingroup hash_gen_hash_api
  *
- * @note If the key is NULL or empty, the retval will be 0
+ * The string is lowercased, like strcasecmp(), before it's hashed.
  */
-static size_t gen_hash_case_string(union HashKey key, size_t num_elems)
+static size_t gen_hash_case_string(union HashKey key)
 {
-  size_t hash = 0;
-  const unsigned char *s = (const unsigned char *) key.strkey;
-  if (!s)
-    return 0;
+  const char *s = NONULL(key.strkey);
+  const size_t len = strlen(s);
 
-  while (*s != '\0')
-    hash += ((hash << 7) + tolower(*s++));
-  hash = (hash * SOME_PRIME) % num_elems;
+  char stack[256];
+  char *lower = (len < sizeof(stack)) ? stack : g_malloc(len);
+  for (size_t i = 0; i < len; i++)
+    lower[i] = tolower((unsigned char) s[i]);
 
+  const size_t hash = hash_bytes((const unsigned char *) lower, len);
+  if (lower != stack)
+    FREE(&lower);
   return hash;
 }
 
@@ -94,9 +174,9 @@ static int cmp_key_case_string(union HashKey a, union HashKey b)
 /**
  * gen_hash_int - Generate a hash from an integer - Implements ::hash_gen_hash_t - @ingroup hash_gen_hash_api
  */
-static size_t gen_hash_int(union HashKey key, size_t num_elems)
+static size_t gen_hash_int(union HashKey key)
 {
-  return (key.intkey % num_elems);
+  return hash_mix(key.intkey ^ HASH_P0, HASH_P3);
 }
 
 /**
@@ -111,21 +191,215 @@ static int cmp_key_int(union HashKey a, union HashKey b)
   return 1;
 }
 
+/**
+ * hash_tag - Generate the hash that's stored in a slot
+ * @param table Hash Table
+ * @param key   Key to hash
+ * @retval num Hash, never 0
+ *
+ * The low bits pick the slot; all 32 bits are compared before the keys are.
+ */
+static uint32_t hash_tag(const struct HashTable *table, union HashKey key)
+{
+  const uint64_t hash = table->gen_hash(key);
+  const uint32_t tag = (uint32_t) (hash ^ (hash >> 32));
+  return (tag == 0) ? 1 : tag;
+}
+
+/**
+ * hash_dist - How far is a slot from its key's preferred slot?
+ * @param table Hash Table
+ * @param slot  Slot in use
+ * @retval num Probe distance
+ */
+static inline size_t hash_dist(const struct HashTable *table, size_t slot)
+{
+  const size_t mask = table->num_elems - 1;
+  return (slot - (table->hashes[slot] & mask)) & mask;
+}
+
+/**
+ * hash_find_slot - Find the slot holding a key
+ * @param[in]  table Hash Table to search
+ * @param[in]  key   Key to find
+ * @param[in]  tag   Hash of the key, hash_tag()
+ * @param[out] slot  Slot holding the key
+ * @retval true The key was found
+ *
+ * Robin Hood probing keeps keys in order of probe distance, so the search can
+ * stop at the first slot that's closer to home than the key would be.
+ */
+static bool hash_find_slot(const struct HashTable *table, union HashKey key,
+                           uint32_t tag, size_t *slot)
+{
+  if (table->count == 0)
+    return false;
+
+  const size_t mask = table->num_elems - 1;
+  size_t i = tag & mask;
+  for (size_t dist = 0; table->hashes[i] != 0; dist++, i = (i + 1) & mask)
+  {
+    if (hash_dist(table, i) < dist)
+      break;
+    if ((table->hashes[i] == tag) && (table->cmp_key(table->table[i]->key, key) == 0))
+    {
+      *slot = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * hash_place - Put a new key into the Hash Table
+ * @param table Hash Table
+ * @param tag   Hash of the key, hash_tag()
+ * @param he    HashElem (and its duplicates)
+ *
+ * @pre The key isn't in the table and there's a free slot
+ *
+ * Any key that's closer to home than the new one is moved along.
+ */
+static void hash_place(struct HashTable *table, uint32_t tag, struct HashElem *he)
+{
+  const size_t mask = table->num_elems - 1;
+  size_t i = tag & mask;
+  for (size_t dist = 0;; dist++, i = (i + 1) & mask)
+  {
+    if (table->hashes[i] == 0)
+    {
+      table->hashes[i] = tag;
+      table->table[i] = he;
+      return;
+    }
+
+    const size_t d = hash_dist(table, i);
+    if (d < dist)
+    {
+      const uint32_t tmp_tag = table->hashes[i];
+      struct HashElem *tmp_he = table->table[i];
+      table->hashes[i] = tag;
+      table->table[i] = he;
+      tag = tmp_tag;
+      he = tmp_he;
+      dist = d;
+    }
+  }
+}
+
+/**
+ * hash_resize - Change the number of slots in a Hash Table
+ * @param table     Hash Table
+ * @param num_slots New number of slots, a power of two
+ *
+ * The HashElems don't move, so pointers to them stay valid.
+ */
+static void hash_resize(struct HashTable *table, size_t num_slots)
+{
+  uint32_t *old_hashes = table->hashes;
+  struct HashElem **old_table = table->table;
+  const size_t old_num = table->num_elems;
+
+  table->num_elems = num_slots;
+  table->hashes = g_malloc0_n(num_slots, sizeof(uint32_t));
+  table->table = g_malloc0_n(num_slots, sizeof(struct HashElem *));
+
+  for (size_t i = 0; i < old_num; i++)
+  {
+    if (old_hashes[i] != 0)
+      hash_place(table, old_hashes[i], old_table[i]);
+  }
+
+  FREE(&old_hashes);
+  FREE(&old_table);
+}
+
+/**
+ * hash_remove_slot - Empty a slot
+ * @param table Hash Table
+ * @param slot  Slot to empty
+ *
+ * The following keys are shifted back, so no tombstones are needed.
+ */
+static void hash_remove_slot(struct HashTable *table, size_t slot)
+{
+  const size_t mask = table->num_elems - 1;
+  size_t next = (slot + 1) & mask;
+  while ((table->hashes[next] != 0) && (hash_dist(table, next) > 0))
+  {
+    table->hashes[slot] = table->hashes[next];
+    table->table[slot] = table->table[next];
+    slot = next;
+    next = (next + 1) & mask;
+  }
+
+  table->hashes[slot] = 0;
+  table->table[slot] = NULL;
+  table->count--;
+}
+
+/**
+ * hash_elem_new - Get a HashElem for a Hash Table
+ * @param table Hash Table
+ * @retval ptr Empty HashElem
+ *
+ * HashElems are carved from an Arena, rather than being allocated one by one.
+ * Deleted ones are kept on a list for reuse.
+ */
+static struct HashElem *hash_elem_new(struct HashTable *table)
+{
+  struct HashElem *he = table->spare;
+  if (he)
+  {
+    table->spare = he->next;
+    memset(he, 0, sizeof(*he));
+    return he;
+  }
+
+  if (!table->pool)
+  {
+    const size_t size = table->num_elems * sizeof(struct HashElem) / 2;
+    table->pool = arena_new(CLAMP(size, 1024, 64 * 1024));
+  }
+  return arena_alloc(table->pool, sizeof(struct HashElem));
+}
+
+/**
+ * hash_elem_free - Release a HashElem
+ * @param table Hash Table
+ * @param he    HashElem to release
+ *
+ * The data is freed, using the table's destructor, and the key, if it's owned.
+ */
+static void hash_elem_free(struct HashTable *table, struct HashElem *he)
+{
+  if (table->hdata_free)
+    table->hdata_free(he->type, he->data, table->hdata);
+  if (table->strdup_keys)
+    FREE(&he->key.strkey);
+
+  he->next = table->spare;
+  table->spare = he;
+}
+
 /**
  * hash_new - Create a new Hash Table
  * @param num_elems Number of elements it should contain
  * @retval ptr New Hash Table
  *
- * The Hash Table can contain more elements than num_elems, but they will be
- * chained together.
+ * The Hash Table will grow if more than num_elems keys are added.
  */
 static struct HashTable *hash_new(size_t num_elems)
 {
   struct HashTable *table = g_new0(struct HashTable, 1);
-  if (num_elems == 0)
-    num_elems = 2;
-  table->num_elems = num_elems;
-  table->table = g_malloc0_n(num_elems, sizeof(struct HashElem *));
+
+  size_t num_slots = HASH_MIN_SLOTS;
+  while ((num_slots / 8 * 7) < num_elems)
+    num_slots *= 2;
+
+  table->num_elems = num_slots;
+  table->hashes = g_malloc0_n(num_slots, sizeof(uint32_t));
+  table->table = g_malloc0_n(num_slots, sizeof(struct HashElem *));
   return table;
 }
 
@@ -135,7 +409,10 @@ static struct HashTable *hash_new(size_t num_elems)
  * @param key   Key to hash on
  * @param type  Data type
  * @param data  Data to associate with key
- * @retval ptr Newly inserted HashElem
+ * @retval ptr  Newly inserted HashElem
+ * @retval NULL The key exists, and duplicates aren't allowed
+ *
+ * Duplicates are added to the front of the key's list.
  */
 static struct HashElem *union_hash_insert(struct HashTable *table,
                                           union HashKey key, int type, void *data)
@@ -143,38 +420,34 @@ static struct HashElem *union_hash_insert(struct HashTable *table,
   if (!table)
     return NULL; // LCOV_EXCL_LINE
 
-  struct HashElem *he = g_new0(struct HashElem, 1);
-  size_t hash = table->gen_hash(key, table->num_elems);
+  const uint32_t tag = hash_tag(table, key);
+  size_t slot = 0;
+  const bool found = hash_find_slot(table, key, tag, &slot);
+
+  if (found && !table->allow_dups)
+  {
+    if (table->strdup_keys)
+      FREE(&key.strkey);
+    return NULL;
+  }
+
+  struct HashElem *he = hash_elem_new(table);
   he->key = key;
   he->data = data;
   he->type = type;
 
-  if (table->allow_dups)
+  if (found)
   {
-    he->next = table->table[hash];
-    table->table[hash] = he;
+    he->next = table->table[slot];
+    table->table[slot] = he;
+    return he;
   }
-  else
-  {
-    struct HashElem *tmp = NULL, *last = NULL;
 
-    for (tmp = table->table[hash], last = NULL; tmp; last = tmp, tmp = tmp->next)
-    {
-      const int rc = table->cmp_key(tmp->key, key);
-      if (rc == 0)
-      {
-        FREE(&he);
-        return NULL;
-      }
-      if (rc > 0)
-        break;
-    }
-    if (last)
-      last->next = he;
-    else
-      table->table[hash] = he;
-    he->next = tmp;
-  }
+  if ((table->count + 1) > (table->num_elems / 8 * 7))
+    hash_resize(table, MAX(table->num_elems * 2, HASH_MIN_SLOTS));
+
+  hash_place(table, tag, he);
+  table->count++;
   return he;
 }
 
@@ -189,14 +462,10 @@ static struct HashElem *union_hash_find_elem(const struct HashTable *table, unio
   if (!table)
     return NULL; // LCOV_EXCL_LINE
 
-  size_t hash = table->gen_hash(key, table->num_elems);
-  struct HashElem *he = table->table[hash];
-  for (; he; he = he->next)
-  {
-    if (table->cmp_key(key, he->key) == 0)
-      return he;
-  }
-  return NULL;
+  size_t slot = 0;
+  if (!hash_find_slot(table, key, hash_tag(table, key), &slot))
+    return NULL;
+  return table->table[slot];
 }
 
 /**
@@ -220,27 +489,27 @@ static void *union_hash_find(const struct HashTable *table, union HashKey key)
  * @param table   Hash Table to use
  * @param key     Key (either string or integer)
  * @param data    Private data to match (or NULL for any match)
+ *
+ * The key isn't used once the first HashElem has been freed.
  */
 static void union_hash_delete(struct HashTable *table, union HashKey key, const void *data)
 {
   if (!table)
     return; // LCOV_EXCL_LINE
 
-  size_t hash = table->gen_hash(key, table->num_elems);
-  struct HashElem *he = table->table[hash];
-  struct HashElem **he_last = &table->table[hash];
+  size_t slot = 0;
+  if (!hash_find_slot(table, key, hash_tag(table, key), &slot))
+    return;
+
+  struct HashElem **he_last = &table->table[slot];
+  struct HashElem *he = *he_last;
 
   while (he)
   {
-    if (((data == he->data) || !data) && (table->cmp_key(he->key, key) == 0))
+    if ((data == he->data) || !data)
     {
       *he_last = he->next;
-      if (table->hdata_free)
-        table->hdata_free(he->type, he->data, table->hdata);
-      if (table->strdup_keys)
-        FREE(&he->key.strkey);
-      FREE(&he);
-
+      hash_elem_free(table, he);
       he = *he_last;
     }
     else
@@ -249,6 +518,9 @@ static void union_hash_delete(struct HashTable *table, union HashKey key, const
       he = he->next;
     }
   }
+
+  if (!table->table[slot])
+    hash_remove_slot(table, slot);
 }
 
 /**
@@ -405,7 +677,8 @@ void *mutt_hash_int_find(const struct HashTable *table, unsigned int intkey)
  * @param strkey String key to search for
  * @retval ptr HashElem matching the key
  *
- * Unlike mutt_hash_find_elem(), this will return the first matching entry.
+ * This returns the most recently inserted entry for the key.
+ * Any duplicates can be found by following HashElem.next.
  */
 struct HashElem *mutt_hash_find_bucket(const struct HashTable *table, const char *strkey)
 {
@@ -413,10 +686,8 @@ struct HashElem *mutt_hash_find_bucket(const struct HashTable *table, const char
     return NULL;
 
   union HashKey key;
-
   key.strkey = strkey;
-  size_t hash = table->gen_hash(key, table->num_elems);
-  return table->table[hash];
+  return union_hash_find_elem(table, key);
 }
 
 /**
@@ -430,10 +701,9 @@ void mutt_hash_delete(struct HashTable *table, const char *strkey, const void *d
   if (!table || !strkey || (strkey[0] == '\0'))
     return;
   union HashKey key;
-  // Copy the key because union_hash_delete() may use it after the HashElem is freed.
-  key.strkey = mutt_str_dup(strkey);
+  // The key may belong to a HashElem; union_hash_delete() only uses it to find the slot.
+  key.strkey = strkey;
   union_hash_delete(table, key, data);
-  FREE(&key.strkey);
 }
 
 /**
@@ -461,21 +731,19 @@ void mutt_hash_free(struct HashTable **ptr)
     return;
 
   struct HashTable *table = *ptr;
-  struct HashElem *he = NULL, *tmp = NULL;
 
   for (size_t i = 0; i < table->num_elems; i++)
   {
-    for (he = table->table[i]; he;)
+    for (struct HashElem *he = table->table[i]; he; he = he->next)
     {
-      tmp = he;
-      he = he->next;
-      if (table->hdata_free && tmp->data)
-        table->hdata_free(tmp->type, tmp->data, table->hdata);
+      if (table->hdata_free && he->data)
+        table->hdata_free(he->type, he->data, table->hdata);
       if (table->strdup_keys)
-        FREE(&tmp->key.strkey);
-      FREE(&tmp);
+        FREE(&he->key.strkey);
     }
   }
+  arena_free(&table->pool);
+  FREE(&table->hashes);
   FREE(&table->table);
   FREE(ptr);
 }
@@ -503,7 +771,7 @@ struct HashElem *mutt_hash_walk(const struct HashTable *table, struct HashWalkSt
 
   while (state->index < table->num_elems)
   {
-    if (table->table[state->index])
+    if (table->hashes[state->index] != 0)
     {
       state->last = table->table[state->index];
       return state->last;
@@ -27,6 +27,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+struct Arena;
+
 /**
  * union HashKey - The data item stored in a HashElem
  */
@@ -44,7 +46,7 @@ struct HashElem
   int type;              ///< Type of data stored in Hash Table, e.g. #DT_STRING
   union HashKey key;     ///< Key representing the data
   void *data;            ///< User-supplied data
-  struct HashElem *next; ///< Linked List
+  struct HashElem *next; ///< Next HashElem with the same key (duplicates)
 };
 
 /**
@@ -65,13 +67,12 @@ typedef void (*hash_hdata_free_t)(int type, void *obj, intptr_t data);
  *
  * Prototype for a Key hashing function
  *
- * @param key       Key to hash
- * @param num_elems Number of elements in the Hash Table
+ * @param key Key to hash
  *
- * Turn a Key (a string or an integer) into a hash id.
- * The hash id will be a number between 0 and (num_elems-1).
+ * Turn a Key (a string or an integer) into a well-mixed hash.
+ * The Hash Table uses the low bits to pick a slot.
  */
-typedef size_t (*hash_gen_hash_t)(union HashKey key, size_t num_elems);
+typedef size_t (*hash_gen_hash_t)(union HashKey key);
 
 /**
  * @defgroup hash_cmp_key_api Hash Table Compare API
@@ -91,14 +92,20 @@ typedef int (*hash_cmp_key_t)(union HashKey a, union HashKey b);
 /**
  * struct HashTable - A Hash Table
  *
- * @note The number of actual elements in the HashTable isn't recorded.
+ * An open-addressing table using Robin Hood probing.
+ * Each slot holds one key; duplicate keys are chained from it by HashElem.next.
+ * The table doubles in size when it's 7/8 full.
  */
 struct HashTable
 {
-  size_t num_elems;             ///< Number of buckets in the Hash Table
+  size_t num_elems;             ///< Number of slots in the Hash Table (a power of two)
+  size_t count;                 ///< Number of slots in use (distinct keys)
   bool strdup_keys : 1;         ///< if set, the key->strkey is strdup()'d
   bool allow_dups  : 1;         ///< if set, duplicate keys are allowed
-  struct HashElem **table;      ///< Array of Hash keys
+  uint32_t *hashes;             ///< Hash of each slot's key, 0 if the slot is empty
+  struct HashElem **table;      ///< HashElem of each slot's key
+  struct Arena *pool;           ///< Storage for the HashElems
+  struct HashElem *spare;       ///< Deleted HashElems, ready for reuse
   hash_gen_hash_t gen_hash;     ///< Function to generate hash id from the key
   hash_cmp_key_t cmp_key;       ///< Function to compare two Hash keys
   intptr_t hdata;               ///< Data to pass to the hdata_free() function
@@ -130,8 +137,8 @@ struct HashElem * mutt_hash_typed_insert  (struct HashTable *table, const char *
  */
 struct HashWalkState
 {
-  size_t index;          ///< Current position in table
-  struct HashElem *last; ///< Current element in linked list
+  size_t index;          ///< Current slot in table
+  struct HashElem *last; ///< Current element in list of duplicates
 };
 
 struct HashElem *mutt_hash_walk(const struct HashTable *table, struct HashWalkState *state);
@@ -29,12 +29,14 @@
  *
  * | File             | Description             |
  * | :--------------- | :---------------------- |
+ * | mutt/arena.c     | @subpage mutt_arena     |
  * | mutt/array.h     | @subpage mutt_array     |
  * | mutt/atoi.c      | @subpage mutt_atoi      |
  * | mutt/base64.c    | @subpage mutt_base64    |
  * | mutt/buffer.c    | @subpage mutt_buffer    |
  * | mutt/charset.c   | @subpage mutt_charset   |
  * | mutt/date.c      | @subpage mutt_date      |
+ * | mutt/dirscan.c   | @subpage mutt_dirscan   |
  * | mutt/envlist.c   | @subpage mutt_envlist   |
  * | mutt/eqi.h       | @subpage mutt_eqi       |
  * | mutt/exit.c      | @subpage mutt_exit      |
@@ -57,6 +59,7 @@
  * | mutt/strlist.c   | @subpage mutt_slist     |
  * | mutt/state.c     | @subpage mutt_state     |
  * | mutt/string.c    | @subpage mutt_string    |
+ * | mutt/trace.c     | @subpage mutt_trace     |
  *
  * @note The library is self-contained -- some files may depend on others in
  *       the library, but none depends on source from outside.
@@ -69,12 +72,14 @@
 
 #include "config.h"
 // IWYU pragma: begin_keep
+#include "arena.h"
 #include "array.h"
 #include "atoi.h"
 #include "base64.h"
 #include "buffer.h"
 #include "charset.h"
 #include "date.h"
+#include "dirscan.h"
 #include "envlist.h"
 #include "eqi.h"
 #include "exit.h"
@@ -99,6 +104,7 @@
 #include "strlist.h"
 #include "state.h"
 #include "string2.h"
+#include "trace.h"
 // IWYU pragma: end_keep
 
 #if defined(COMPILER_IS_CLANG) || defined(COMPILER_IS_GCC)
@@ -25,12 +25,20 @@
  * @page mutt_mbyte Multi-byte String manipulation functions
  *
  * Some commonly-used multi-byte string manipulation routines.
+ *
+ * Measuring the width of strings is done for every line of the screen, so it
+ * has some shortcuts.  Runs of printable ASCII are found eight bytes at a
+ * time, UTF-8 is decoded directly and the results of wcwidth() and iswprint()
+ * are kept in a table.  The table is filled in from libc, a page at a time, so
+ * the results are always the same as calling libc.
  */
 
 #include "config.h"
 #include <ctype.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <wchar.h>
 #include <wctype.h>
@@ -44,6 +52,232 @@
 
 bool OptLocales; ///< (pseudo) set if user has valid locale definition
 
+/// Number of characters in a page of the width table
+#define WIDTH_PAGE_SIZE 256
+/// Number of pages in the width table, enough for the first three Unicode planes
+#define WIDTH_PAGES (0x30000 / WIDTH_PAGE_SIZE)
+
+#define WIDTH_MASK  0x0f ///< Width table: wcwidth() + 1
+#define WIDTH_PRINT 0x10 ///< Width table: iswprint() is true
+
+/// Eight copies of a byte
+#define BYTES(b) (UINT64_C(0x0101010101010101) * (b))
+
+/**
+ * struct WidthTable - Widths of characters in the current locale
+ */
+struct WidthTable
+{
+  bool valid;                        ///< The locale has been examined
+  bool ascii;                        ///< Printable ASCII is one byte and one column
+  bool utf8;                         ///< The locale's character set is UTF-8
+  unsigned char *pages[WIDTH_PAGES]; ///< Pages of the table, filled in when needed
+};
+
+/// Widths of characters in the current locale
+static struct WidthTable Widths = { 0 };
+
+/**
+ * width_table_init - Examine the current locale
+ */
+static void width_table_init(void)
+{
+  char *charset = mutt_ch_get_langinfo_charset();
+  Widths.utf8 = mutt_ch_is_utf8(charset);
+  FREE(&charset);
+
+  Widths.ascii = Widths.utf8 || (MB_CUR_MAX == 1);
+  Widths.valid = true;
+}
+
+/**
+ * width_table_get - Look up a character in the width table
+ * @param wc Character
+ * @retval num Table entry, e.g. #WIDTH_PRINT
+ * @retval -1  Character isn't in the table
+ */
+static int width_table_get(wchar_t wc)
+{
+  const unsigned long cp = wc;
+  if (cp >= (WIDTH_PAGES * WIDTH_PAGE_SIZE))
+    return -1;
+
+  unsigned char *page = Widths.pages[cp / WIDTH_PAGE_SIZE];
+  if (!page)
+  {
+    page = g_malloc(WIDTH_PAGE_SIZE);
+    const wchar_t first = cp - (cp % WIDTH_PAGE_SIZE);
+    for (int i = 0; i < WIDTH_PAGE_SIZE; i++)
+    {
+      const int w = wcwidth(first + i);
+      page[i] = ((w + 1) & WIDTH_MASK) | (iswprint(first + i) ? WIDTH_PRINT : 0);
+    }
+    Widths.pages[cp / WIDTH_PAGE_SIZE] = page;
+  }
+
+  return page[cp % WIDTH_PAGE_SIZE];
+}
+
+/**
+ * mutt_mb_char_width - Measure the screen width of a character
+ * @param wc Character to examine
+ * @retval num Width in screen columns, -1 if unprintable
+ *
+ * This gives the same result as wcwidth(), but remembers it.
+ */
+int mutt_mb_char_width(wchar_t wc)
+{
+  const int entry = width_table_get(wc);
+  if (entry < 0)
+    return wcwidth(wc);
+
+  return (entry & WIDTH_MASK) - 1;
+}
+
+/**
+ * mutt_mb_char_print - Is a character printable?
+ * @param wc Character to examine
+ * @retval true Character is printable
+ *
+ * This gives the same result as iswprint(), but remembers it.
+ */
+bool mutt_mb_char_print(wchar_t wc)
+{
+  const int entry = width_table_get(wc);
+  if (entry < 0)
+    return iswprint(wc);
+
+  return (entry & WIDTH_PRINT);
+}
+
+/**
+ * mutt_mb_width_reset - Forget the widths of characters
+ *
+ * This must be called if the locale changes.
+ */
+void mutt_mb_width_reset(void)
+{
+  for (size_t i = 0; i < mutt_array_size(Widths.pages); i++)
+    FREE(&Widths.pages[i]);
+
+  Widths.valid = false;
+}
+
+/**
+ * mutt_mb_ascii_len - Count the printable ASCII at the start of a string
+ * @param s String to examine
+ * @param n Length of the string
+ * @retval num Number of bytes of printable ASCII
+ *
+ * Each of these bytes is a character one screen column wide.  If the locale
+ * can't guarantee that, e.g. it uses a stateful encoding, 0 is returned.
+ */
+size_t mutt_mb_ascii_len(const char *s, size_t n)
+{
+  if (!s)
+    return 0;
+
+  if (!Widths.valid)
+    width_table_init();
+  if (!Widths.ascii)
+    return 0;
+
+  size_t len = 0;
+  for (; (n - len) >= sizeof(uint64_t); len += sizeof(uint64_t))
+  {
+    uint64_t x;
+    memcpy(&x, s + len, sizeof(x));
+
+    const uint64_t del = x ^ BYTES(0x7f);
+    if ((x & BYTES(0x80)) || ((x - BYTES(0x20)) & ~x & BYTES(0x80)) ||
+        ((del - BYTES(0x01)) & ~del & BYTES(0x80)))
+    {
+      break;
+    }
+  }
+
+  for (; len < n; len++)
+  {
+    const unsigned char ch = s[len];
+    if ((ch < 0x20) || (ch > 0x7e))
+      break;
+  }
+
+  return len;
+}
+
+/**
+ * mutt_mb_mbrtowc - Convert a multibyte character to a wide character
+ * @param pwc Wide character
+ * @param s   String to convert
+ * @param n   Length of the string
+ * @param ps  Conversion state
+ * @retval num Same as mbrtowc()
+ *
+ * This gives the same result as mbrtowc(), but ASCII and valid UTF-8 are
+ * decoded directly.  Anything unusual is passed to libc.
+ */
+size_t mutt_mb_mbrtowc(wchar_t *pwc, const char *s, size_t n, mbstate_t *ps)
+{
+  if (!Widths.valid)
+    width_table_init();
+
+  if (!pwc || !s || (n == 0) || !ps || !mbsinit(ps))
+    return mbrtowc(pwc, s, n, ps);
+
+  const unsigned char *u = (const unsigned char *) s;
+  if (Widths.ascii && (u[0] < 0x80))
+  {
+    *pwc = u[0];
+    return (u[0] == '\0') ? 0 : 1;
+  }
+
+#ifdef __STDC_ISO_10646__
+  if (Widths.utf8)
+  {
+    wchar_t wc = 0;
+    size_t len = 0;
+    wchar_t min = 0;
+
+    if ((u[0] >= 0xc2) && (u[0] <= 0xdf))
+    {
+      wc = u[0] & 0x1f;
+      len = 2;
+      min = 0x80;
+    }
+    else if ((u[0] >= 0xe0) && (u[0] <= 0xef))
+    {
+      wc = u[0] & 0x0f;
+      len = 3;
+      min = 0x800;
+    }
+    else if ((u[0] >= 0xf0) && (u[0] <= 0xf4))
+    {
+      wc = u[0] & 0x07;
+      len = 4;
+      min = 0x10000;
+    }
+
+    if ((len != 0) && (len <= n))
+    {
+      size_t i = 1;
+      for (; (i < len) && ((u[i] & 0xc0) == 0x80); i++)
+        wc = (wc << 6) | (u[i] & 0x3f);
+
+      /* Complete, shortest form, and not a surrogate or beyond Unicode */
+      if ((i == len) && (wc >= min) && (wc <= 0x10ffff) &&
+          ((wc < 0xd800) || (wc > 0xdfff)))
+      {
+        *pwc = wc;
+        return len;
+      }
+    }
+  }
+#endif
+
+  return mbrtowc(pwc, s, n, ps);
+}
+
 /**
  * mutt_mb_charlen - Count the bytes in a (multibyte) character
  * @param[in]  s     String to be examined
@@ -148,8 +382,20 @@ int mutt_mb_width(const char *str, int col, bool indent)
 
   while (*str && (str_len > 0))
   {
+    if (!nl)
+    {
+      const size_t ascii = mutt_mb_ascii_len(str, str_len);
+      if (ascii != 0)
+      {
+        total_width += ascii;
+        str += ascii;
+        str_len -= ascii;
+        continue;
+      }
+    }
+
     wchar_t wc = L'\0';
-    size_t consumed = mbrtowc(&wc, str, str_len, &mbstate);
+    size_t consumed = mutt_mb_mbrtowc(&wc, str, str_len, &mbstate);
     if (consumed == 0)
       break;
 
@@ -165,7 +411,7 @@ int mutt_mb_width(const char *str, int col, bool indent)
       consumed = str_len;
     }
 
-    int wchar_width = wcwidth(wc);
+    int wchar_width = mutt_mb_char_width(wc);
     if (wchar_width < 0)
       wchar_width = 1;
 
@@ -198,7 +444,7 @@ int mutt_mb_width(const char *str, int col, bool indent)
  */
 int mutt_mb_wcwidth(wchar_t wc)
 {
-  int n = wcwidth(wc);
+  int n = mutt_mb_char_width(wc);
   if (IsWPrint(wc) && (n > 0))
     return n;
   if (!(wc & ~0x7f))
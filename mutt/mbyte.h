@@ -27,6 +27,7 @@
 #include <ctype.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <wchar.h>
 #include <wctype.h> // IWYU pragma: keep
 
 struct Buffer;
@@ -35,23 +36,28 @@ extern bool OptLocales;
 
 #ifdef LOCALES_HACK
 #define IsPrint(ch) (isprint((unsigned char) (ch)) || ((unsigned char) (ch) >= 0xa0))
-#define IsWPrint(wc) (iswprint(wc) || wc >= 0xa0)
+#define IsWPrint(wc) (mutt_mb_char_print(wc) || wc >= 0xa0)
 #else
 #define IsPrint(ch) (isprint((unsigned char) (ch)) || (OptLocales ? 0 : ((unsigned char) (ch) >= 0xa0)))
-#define IsWPrint(wc) (iswprint(wc) || (OptLocales ? 0 : (wc >= 0xa0)))
+#define IsWPrint(wc) (mutt_mb_char_print(wc) || (OptLocales ? 0 : (wc >= 0xa0)))
 #endif
 
+size_t mutt_mb_ascii_len(const char *s, size_t n);
+bool   mutt_mb_char_print(wchar_t wc);
+int    mutt_mb_char_width(wchar_t wc);
 int    mutt_mb_charlen(const char *s, int *width);
 int    mutt_mb_filter_unprintable(char **s);
 bool   mutt_mb_get_initials(const char *name, char *buf, size_t buflen);
 bool   mutt_mb_is_display_corrupting_utf8(wchar_t wc);
 bool   mutt_mb_is_lower(const char *s);
 bool   mutt_mb_is_shell_char(wchar_t ch);
+size_t mutt_mb_mbrtowc(wchar_t *pwc, const char *s, size_t n, mbstate_t *ps);
 size_t mutt_mb_mbstowcs(wchar_t **pwbuf, size_t *pwbuflen, size_t i, const char *buf);
 void   buf_mb_wcstombs(struct Buffer *dest, const wchar_t *wstr, size_t wlen);
 int    mutt_mb_wcswidth(const wchar_t *s, size_t n);
 int    mutt_mb_wcwidth(wchar_t wc);
 int    mutt_mb_width(const char *str, int col, bool indent);
 size_t mutt_mb_width_ceiling(const wchar_t *s, size_t n, int w1);
+void   mutt_mb_width_reset(void);
 
 #endif /* MUTT_MUTT_MBYTE_H */
@@ -37,6 +37,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "config/types.h"
 #include "atoi.h"
 #include "buffer.h"
@@ -608,3 +609,154 @@ bool mutt_regex_match(const struct Regex *regex, const char *str)
 {
   return mutt_regex_capture(regex, str, 0, NULL);
 }
+
+/**
+ * literal_drop_char - Remove the last character from a literal
+ * @param buf Literal
+ *
+ * A quantifier applies to a whole multibyte character, not just its last byte.
+ */
+static void literal_drop_char(struct Buffer *buf)
+{
+  while ((buf->dptr > buf->data) && ((buf->dptr[-1] & 0xC0) == 0x80))
+    buf->dptr--;
+  if (buf->dptr > buf->data)
+    buf->dptr--;
+  *buf->dptr = '\0';
+}
+
+/**
+ * literal_keep - Keep the longest literal found so far
+ * @param best Longest literal so far
+ * @param cur  Literal that has just ended, will be reset
+ */
+static void literal_keep(struct Buffer *best, struct Buffer *cur)
+{
+  if (buf_len(cur) > buf_len(best))
+    buf_copy(best, cur);
+  buf_reset(cur);
+}
+
+/**
+ * literal_skip_bracket - Skip over a bracket expression
+ * @param p Character after the opening '['
+ * @retval ptr  Closing ']'
+ * @retval NULL The bracket expression isn't closed
+ *
+ * A ']' may appear first, or within a class, e.g. `[]x]` or `[[:digit:]]`.
+ */
+static const char *literal_skip_bracket(const char *p)
+{
+  if (*p == '^')
+    p++;
+  if (*p == ']')
+    p++;
+
+  for (; *p; p++)
+  {
+    if (*p == ']')
+      return p;
+
+    // Character class [:alpha:], equivalence class [=e=] or collating symbol [.-.]
+    if ((p[0] == '[') && ((p[1] == ':') || (p[1] == '=') || (p[1] == '.')))
+    {
+      const char delim = p[1];
+      const char *end = p + 2;
+      while (*end && !((end[0] == delim) && (end[1] == ']')))
+        end++;
+      if (*end == '\0')
+        return NULL;
+      p = end + 1;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * mutt_regex_literal - Find some text that every match of a regex contains
+ * @param regex Extended regular expression
+ * @retval ptr  Longest literal run, e.g. "invoice" for "^invoice [0-9]+"
+ * @retval NULL The regex has no literal that must match
+ *
+ * This lets a regex be pre-filtered by a plain substring search, e.g. on an
+ * IMAP server.  It's conservative: a regex with alternatives or groups has no
+ * literal.  The caller must free the string.
+ */
+char *mutt_regex_literal(const char *regex)
+{
+  if (!regex)
+    return NULL;
+
+  struct Buffer *best = buf_pool_get();
+  struct Buffer *cur = buf_pool_get();
+  char *literal = NULL;
+
+  for (const char *p = regex; *p; p++)
+  {
+    switch (*p)
+    {
+      case '|':
+      case '(':
+      case ')':
+        goto done; // Alternatives may not contain any literal
+
+      case '*':
+      case '?':
+        // The previous character is optional
+        literal_drop_char(cur);
+        literal_keep(best, cur);
+        break;
+
+      case '{':
+        literal_drop_char(cur);
+        literal_keep(best, cur);
+        p = strchr(p, '}');
+        if (!p)
+          goto done;
+        break;
+
+      case '+':
+        // The previous character is required, but may repeat
+        literal_keep(best, cur);
+        break;
+
+      case '.':
+      case '^':
+      case '$':
+        literal_keep(best, cur);
+        break;
+
+      case '[':
+        literal_keep(best, cur);
+        p = literal_skip_bracket(p + 1);
+        if (!p)
+          goto done;
+        break;
+
+      case '\\':
+        p++;
+        if (*p == '\0')
+          goto done;
+        // Class, anchor or back-reference, e.g. \w, \< (GNU) or \1
+        if (isalnum((unsigned char) *p) || strchr("<>`'", *p))
+          literal_keep(best, cur);
+        else
+          buf_addch(cur, *p);
+        break;
+
+      default:
+        buf_addch(cur, *p);
+        break;
+    }
+  }
+
+  literal_keep(best, cur);
+  if (!buf_is_empty(best))
+    literal = buf_strdup(best);
+
+done:
+  buf_pool_release(&best);
+  buf_pool_release(&cur);
+  return literal;
+}
@@ -119,4 +119,6 @@ int             mutt_replacelist_remove(ReplaceList **rl, const char *pat);
 bool mutt_regex_match  (const struct Regex *regex, const char *str);
 bool mutt_regex_capture(const struct Regex *regex, const char *str, size_t num, regmatch_t matches[]);
 
+char *mutt_regex_literal(const char *regex);
+
 #endif /* MUTT_MUTT_REGEX3_H */
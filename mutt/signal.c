@@ -63,6 +63,7 @@ static sig_handler_t ExitHandler = mutt_sig_exit_handler;
 /// Function to handle SIGSEGV (11) signals
 static sig_handler_t SegvHandler = mutt_sig_exit_handler;
 
+volatile sig_atomic_t SigChld;  ///< true after SIGCHLD is received
 volatile sig_atomic_t SigInt;   ///< true after SIGINT is received
 volatile sig_atomic_t SigWinch; ///< true after SIGWINCH is received
 
@@ -118,6 +119,17 @@ void mutt_sig_empty_handler(int sig)
 {
 }
 
+/**
+ * sig_child_handler - Note that a child process has exited - Implements ::sig_handler_t - @ingroup sig_handler_api
+ * @param sig Signal number, SIGCHLD
+ *
+ * The child isn't reaped here; whoever started it calls waitpid().
+ */
+static void sig_child_handler(int sig)
+{
+  SigChld = true;
+}
+
 /**
  * mutt_sig_exit_handler - Notify the user and shutdown gracefully
  * @param sig Signal number, e.g. SIGINT
@@ -194,8 +206,8 @@ void mutt_sig_init(sig_handler_t sig_fn, sig_handler_t exit_fn, sig_handler_t se
   sigaction(SIGWINCH, &act, NULL);
 
   /* POSIX doesn't allow us to ignore SIGCHLD,
-   * so we just install a dummy handler for it */
-  act.sa_handler = mutt_sig_empty_handler;
+   * so we just note that it happened */
+  act.sa_handler = sig_child_handler;
   /* don't need to block any other signals here */
   sigemptyset(&act.sa_mask);
   /* we don't want to mess with stopped children */
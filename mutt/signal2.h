@@ -33,6 +33,7 @@ void show_backtrace(void);
 static inline void show_backtrace(void) {}
 #endif
 
+extern volatile sig_atomic_t SigChld;  ///< true after SIGCHLD is received
 extern volatile sig_atomic_t SigInt;   ///< true after SIGINT is received
 extern volatile sig_atomic_t SigWinch; ///< true after SIGWINCH is received
 
@@ -0,0 +1,446 @@
+/**
+ * @file
+ * Lightweight performance tracing
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page mutt_trace Lightweight performance tracing
+ *
+ * Record how long the expensive operations take, e.g. opening a mailbox.
+ *
+ * - Spans time a region of code using the monotonic clock.  Spans may be
+ *   nested; the nesting depth is recorded.
+ * - Every span name has a histogram of its durations (power-of-two buckets,
+ *   in microseconds).
+ * - Counters accumulate named values, e.g. header cache hits.
+ *
+ * The trace can be saved in the Chrome trace-event format, which can be
+ * viewed in `chrome://tracing` or https://ui.perfetto.dev
+ *
+ * When tracing is disabled, trace_begin() and trace_counter() are an inline
+ * test of #TraceEnabled and trace_end() is a test of the span's start time.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <glib.h>
+#include "trace.h"
+#include "array.h"
+#include "file.h"
+#include "logging2.h"
+#include "memory.h"
+#include "string2.h"
+
+/// Maximum number of events kept, the rest are counted and dropped
+#define TRACE_MAX_EVENTS 500000
+
+/// Number of histogram buckets, the last one covers everything >= 2^30 us
+#define TRACE_BUCKETS 32
+
+bool TraceEnabled = false; ///< Is tracing enabled?
+
+/**
+ * struct TraceEvent - A completed span
+ */
+struct TraceEvent
+{
+  const char *cat;   ///< Category
+  const char *name;  ///< Name
+  char *detail;      ///< Optional description
+  uint64_t start_ns; ///< Start time
+  uint64_t dur_ns;   ///< Duration
+  int depth;         ///< Nesting depth, -1 for async spans
+};
+ARRAY_HEAD(TraceEventArray, struct TraceEvent);
+
+/**
+ * struct TraceHistogram - Distribution of the durations of a span
+ */
+struct TraceHistogram
+{
+  uint64_t count;                    ///< Number of spans
+  uint64_t total_us;                 ///< Total duration
+  uint64_t max_us;                   ///< Longest duration
+  uint64_t buckets[TRACE_BUCKETS];   ///< Bucket n counts durations < 2^n us
+};
+
+/// Completed spans
+static struct TraceEventArray TraceEvents = ARRAY_HEAD_INITIALIZER;
+/// Number of spans that didn't fit in TraceEvents
+static uint64_t TraceDropped = 0;
+/// Histograms of span durations: name -> TraceHistogram
+static GHashTable *TraceHistograms = NULL;
+/// Counters: name -> int64_t
+static GHashTable *TraceCounters = NULL;
+/// Time that tracing was first enabled
+static uint64_t TraceStartNs = 0;
+/// Nesting depth of the running spans
+static int TraceDepth = 0;
+
+/**
+ * trace_now_ns - Read the monotonic clock
+ * @retval num Time in nanoseconds
+ */
+static uint64_t trace_now_ns(void)
+{
+  struct timespec ts = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * trace_span_begin - Start a span
+ * @param span  Span to start
+ * @param cat   Category, a static string
+ * @param name  Name, a static string
+ * @param async Span may overlap others
+ *
+ * @note Use trace_begin() or trace_begin_async() instead
+ */
+void trace_span_begin(struct TraceSpan *span, const char *cat, const char *name, bool async)
+{
+  if (!span)
+    return;
+
+  span->cat = cat;
+  span->name = name;
+  span->async = async;
+  span->start_ns = trace_now_ns();
+
+  if (!async)
+    TraceDepth++;
+}
+
+/**
+ * trace_histogram_add - Add a duration to a span's histogram
+ * @param name   Name of the span
+ * @param dur_ns Duration
+ */
+static void trace_histogram_add(const char *name, uint64_t dur_ns)
+{
+  if (!TraceHistograms)
+    TraceHistograms = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+
+  struct TraceHistogram *th = g_hash_table_lookup(TraceHistograms, name);
+  if (!th)
+  {
+    th = g_new0(struct TraceHistogram, 1);
+    g_hash_table_insert(TraceHistograms, (gpointer) name, th);
+  }
+
+  const uint64_t us = dur_ns / 1000;
+  int bucket = 0;
+  while ((bucket < (TRACE_BUCKETS - 1)) && ((1ULL << bucket) <= us))
+    bucket++;
+
+  th->count++;
+  th->total_us += us;
+  th->max_us = MAX(th->max_us, us);
+  th->buckets[bucket]++;
+}
+
+/**
+ * trace_span_end - Finish a span
+ * @param span   Span to finish
+ * @param detail Optional description (copied)
+ *
+ * @note Use trace_end() instead
+ */
+void trace_span_end(struct TraceSpan *span, const char *detail)
+{
+  if (!span || (span->start_ns == 0))
+    return;
+
+  const uint64_t now = trace_now_ns();
+  const uint64_t dur = now - span->start_ns;
+
+  if (!span->async && (TraceDepth > 0))
+    TraceDepth--;
+
+  trace_histogram_add(span->name, dur);
+
+  if (ARRAY_SIZE(&TraceEvents) < TRACE_MAX_EVENTS)
+  {
+    struct TraceEvent te = {
+      .cat = span->cat,
+      .name = span->name,
+      .detail = g_strdup(detail),
+      .start_ns = span->start_ns,
+      .dur_ns = dur,
+      .depth = span->async ? -1 : TraceDepth,
+    };
+    ARRAY_ADD(&TraceEvents, te);
+  }
+  else
+  {
+    TraceDropped++;
+  }
+
+  span->start_ns = 0;
+}
+
+/**
+ * trace_count - Add to a counter
+ * @param name  Name of the counter, a static string
+ * @param delta Amount to add
+ *
+ * @note Use trace_counter() instead
+ */
+void trace_count(const char *name, int64_t delta)
+{
+  if (!name)
+    return;
+
+  if (!TraceCounters)
+    TraceCounters = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+
+  int64_t *value = g_hash_table_lookup(TraceCounters, name);
+  if (!value)
+  {
+    value = g_new0(int64_t, 1);
+    g_hash_table_insert(TraceCounters, (gpointer) name, value);
+  }
+
+  *value += delta;
+}
+
+/**
+ * trace_enable - Turn tracing on or off
+ * @param enable True to start recording
+ *
+ * Turning tracing off keeps everything recorded so far.
+ */
+void trace_enable(bool enable)
+{
+  if (enable && (TraceStartNs == 0))
+    TraceStartNs = trace_now_ns();
+
+  if (enable != TraceEnabled)
+    log_debug1("tracing %s", enable ? "enabled" : "disabled");
+
+  TraceEnabled = enable;
+}
+
+/**
+ * trace_json_string - Write a JSON string
+ * @param fp  File to write to
+ * @param str String to write
+ */
+static void trace_json_string(FILE *fp, const char *str)
+{
+  fputc('"', fp);
+  for (const unsigned char *s = (const unsigned char *) NONULL(str); *s; s++)
+  {
+    if ((*s == '"') || (*s == '\\'))
+      fprintf(fp, "\\%c", *s);
+    else if (*s < 0x20)
+      fprintf(fp, "\\u%04x", *s);
+    else
+      fputc(*s, fp);
+  }
+  fputc('"', fp);
+}
+
+/**
+ * trace_ts - Convert a time to a trace timestamp
+ * @param ns Time in nanoseconds
+ * @retval num Microseconds since tracing started
+ */
+static double trace_ts(uint64_t ns)
+{
+  return (ns < TraceStartNs) ? 0.0 : (double) (ns - TraceStartNs) / 1000.0;
+}
+
+/**
+ * trace_dump_events - Write the spans and counters as trace events
+ * @param fp File to write to
+ */
+static void trace_dump_events(FILE *fp)
+{
+  fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+        "\"args\":{\"name\":\"SpaceMutt\"}}",
+        fp);
+
+  int id = 0;
+  struct TraceEvent *te = NULL;
+  ARRAY_FOREACH(te, &TraceEvents)
+  {
+    fputs(",\n{\"cat\":", fp);
+    trace_json_string(fp, te->cat);
+    fputs(",\"name\":", fp);
+    trace_json_string(fp, te->name);
+
+    if (te->depth < 0)
+    {
+      // Async spans are a begin/end pair, matched by id
+      fprintf(fp, ",\"ph\":\"b\",\"id\":%d,\"ts\":%.3f,\"pid\":1,\"tid\":1", id,
+              trace_ts(te->start_ns));
+      if (te->detail)
+      {
+        fputs(",\"args\":{\"detail\":", fp);
+        trace_json_string(fp, te->detail);
+        fputc('}', fp);
+      }
+      fputs("},\n{\"cat\":", fp);
+      trace_json_string(fp, te->cat);
+      fputs(",\"name\":", fp);
+      trace_json_string(fp, te->name);
+      fprintf(fp, ",\"ph\":\"e\",\"id\":%d,\"ts\":%.3f,\"pid\":1,\"tid\":1}", id,
+              trace_ts(te->start_ns + te->dur_ns));
+      id++;
+      continue;
+    }
+
+    fprintf(fp, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1",
+            trace_ts(te->start_ns), (double) te->dur_ns / 1000.0);
+    fprintf(fp, ",\"args\":{\"depth\":%d", te->depth);
+    if (te->detail)
+    {
+      fputs(",\"detail\":", fp);
+      trace_json_string(fp, te->detail);
+    }
+    fputs("}}", fp);
+  }
+
+  if (!TraceCounters)
+    return;
+
+  const double now = trace_ts(trace_now_ns());
+  GHashTableIter iter;
+  gpointer key = NULL;
+  gpointer value = NULL;
+  g_hash_table_iter_init(&iter, TraceCounters);
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    fputs(",\n{\"name\":", fp);
+    trace_json_string(fp, key);
+    fprintf(fp, ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"value\":%lld}}",
+            now, (long long) *(int64_t *) value);
+  }
+}
+
+/**
+ * trace_dump_histograms - Write the histograms of the span durations
+ * @param fp File to write to
+ */
+static void trace_dump_histograms(FILE *fp)
+{
+  fputs("{", fp);
+  if (!TraceHistograms)
+  {
+    fputs("}", fp);
+    return;
+  }
+
+  bool first = true;
+  GHashTableIter iter;
+  gpointer key = NULL;
+  gpointer value = NULL;
+  g_hash_table_iter_init(&iter, TraceHistograms);
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    const struct TraceHistogram *th = value;
+
+    fputs(first ? "\n" : ",\n", fp);
+    first = false;
+    trace_json_string(fp, key);
+    fprintf(fp, ":{\"count\":%llu,\"total_us\":%llu,\"max_us\":%llu,\"buckets_us\":{",
+            (unsigned long long) th->count, (unsigned long long) th->total_us,
+            (unsigned long long) th->max_us);
+
+    bool first_bucket = true;
+    for (int i = 0; i < TRACE_BUCKETS; i++)
+    {
+      if (th->buckets[i] == 0)
+        continue;
+      if (i == (TRACE_BUCKETS - 1))
+        fprintf(fp, "%s\">=%llu\":%llu", first_bucket ? "" : ",",
+                1ULL << (i - 1), (unsigned long long) th->buckets[i]);
+      else
+        fprintf(fp, "%s\"<%llu\":%llu", first_bucket ? "" : ",", 1ULL << i,
+                (unsigned long long) th->buckets[i]);
+      first_bucket = false;
+    }
+    fputs("}}", fp);
+  }
+  fputs("\n}", fp);
+}
+
+/**
+ * trace_dump - Save the trace in Chrome trace-event format
+ * @param path File to write
+ * @retval true Success
+ *
+ * Alongside the standard "traceEvents", the file contains the span histograms
+ * and the number of dropped events.
+ */
+bool trace_dump(const char *path)
+{
+  if (!path || (path[0] == '\0'))
+    return false;
+
+  FILE *fp = mutt_file_fopen(path, "w");
+  if (!fp)
+  {
+    log_perror(path);
+    return false;
+  }
+
+  fputs("{\"traceEvents\":[\n", fp);
+  trace_dump_events(fp);
+  fputs("\n],\n\"displayTimeUnit\":\"ms\",\n\"histograms\":", fp);
+  trace_dump_histograms(fp);
+  fprintf(fp, ",\n\"droppedEvents\":%llu\n}\n", (unsigned long long) TraceDropped);
+
+  if (mutt_file_fclose(&fp) != 0)
+  {
+    log_perror(path);
+    return false;
+  }
+
+  log_debug1("saved %zu trace events to %s", ARRAY_SIZE(&TraceEvents), path);
+  return true;
+}
+
+/**
+ * trace_cleanup - Free the recorded trace
+ */
+void trace_cleanup(void)
+{
+  struct TraceEvent *te = NULL;
+  ARRAY_FOREACH(te, &TraceEvents)
+  {
+    FREE(&te->detail);
+  }
+  ARRAY_FREE(&TraceEvents);
+
+  if (TraceHistograms)
+    g_hash_table_destroy(g_steal_pointer(&TraceHistograms));
+  if (TraceCounters)
+    g_hash_table_destroy(g_steal_pointer(&TraceCounters));
+
+  TraceDropped = 0;
+  TraceDepth = 0;
+  TraceStartNs = 0;
+  TraceEnabled = false;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * Lightweight performance tracing
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_MUTT_TRACE_H
+#define MUTT_MUTT_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+extern bool TraceEnabled;
+
+/**
+ * struct TraceSpan - A timed region of code
+ *
+ * A span is only started if tracing is enabled.
+ * trace_end() on a span that wasn't started does nothing.
+ */
+struct TraceSpan
+{
+  const char *cat;   ///< Category, e.g. "mx"
+  const char *name;  ///< Name of the span, e.g. "mx_mbox_open"
+  uint64_t start_ns; ///< Start time, 0 if the span isn't running
+  bool async;        ///< Span may overlap others, e.g. pipelined IMAP commands
+};
+
+void trace_span_begin(struct TraceSpan *span, const char *cat, const char *name, bool async);
+void trace_span_end  (struct TraceSpan *span, const char *detail);
+void trace_count     (const char *name, int64_t delta);
+
+void trace_enable (bool enable);
+bool trace_dump   (const char *path);
+void trace_cleanup(void);
+
+/**
+ * trace_begin - Start a span
+ * @param span Span to start
+ * @param cat  Category, a static string
+ * @param name Name, a static string
+ */
+static inline void trace_begin(struct TraceSpan *span, const char *cat, const char *name)
+{
+  if (TraceEnabled)
+    trace_span_begin(span, cat, name, false);
+}
+
+/**
+ * trace_begin_async - Start a span that may overlap others
+ * @param span Span to start
+ * @param cat  Category, a static string
+ * @param name Name, a static string
+ */
+static inline void trace_begin_async(struct TraceSpan *span, const char *cat, const char *name)
+{
+  if (TraceEnabled)
+    trace_span_begin(span, cat, name, true);
+}
+
+/**
+ * trace_end - Finish a span
+ * @param span   Span to finish
+ * @param detail Optional description, e.g. a mailbox path (copied)
+ */
+static inline void trace_end(struct TraceSpan *span, const char *detail)
+{
+  if (span->start_ns != 0)
+    trace_span_end(span, detail);
+}
+
+/**
+ * trace_counter - Add to a counter
+ * @param name  Name of the counter, a static string
+ * @param delta Amount to add
+ */
+static inline void trace_counter(const char *name, int64_t delta)
+{
+  if (TraceEnabled)
+    trace_count(name, delta);
+}
+
+#endif /* MUTT_MUTT_TRACE_H */
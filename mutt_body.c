@@ -76,6 +76,7 @@ int mutt_body_copy(FILE *fp, struct Body **b_dst, struct Body *b_src)
   b = *b_dst;
 
   memcpy(b, b_src, sizeof(struct Body));
+  b->arena = NULL;
   b->parameter = g_queue_new();
   b->parts = NULL;
   b->next = NULL;
@@ -841,6 +841,9 @@ static struct ConfigDef MainVars[] = {
   { "to_chars", DT_MBTABLE, IP " +TCFLR", 0, NULL,
     "Indicator characters for the 'To' field in the index"
   },
+  { "trace_file", DT_PATH|D_PATH_FILE, 0, 0, NULL,
+    "Record a performance trace and save it to this file on exit"
+  },
   { "trash", DT_STRING|D_STRING_MAILBOX, 0, 0, NULL,
     "Folder to put deleted emails"
   },
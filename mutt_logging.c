@@ -180,6 +180,38 @@ void mutt_log_stop(void)
   FREE(&CurrentFile);
 }
 
+/**
+ * mutt_trace_start - Start recording a performance trace
+ *
+ * Tracing is only enabled if `$trace_file` is set.
+ */
+void mutt_trace_start(void)
+{
+  const char *const c_trace_file = cs_subset_path(SpaceMutt->sub, "trace_file");
+  trace_enable(c_trace_file != NULL);
+}
+
+/**
+ * mutt_trace_stop - Save the performance trace and stop recording
+ */
+void mutt_trace_stop(void)
+{
+  if (SpaceMutt && TraceEnabled)
+  {
+    const char *const c_trace_file = cs_subset_path(SpaceMutt->sub, "trace_file");
+    if (c_trace_file)
+    {
+      struct Buffer *path = buf_pool_get();
+      buf_strcpy(path, c_trace_file);
+      buf_expand_path(path);
+      if (!trace_dump(buf_string(path)))
+        log_debug1("Can't write trace file: %s", buf_string(path));
+      buf_pool_release(&path);
+    }
+  }
+  trace_cleanup();
+}
+
 /**
  * mutt_log_set_file - Change the logging file
  * @param file Name to use
@@ -307,6 +339,11 @@ int main_log_observer(struct NotifyCallback *nc)
     const short c_debug_level = cs_subset_number(SpaceMutt->sub, "debug_level");
     mutt_log_set_level(debug_level_to_log_level(c_debug_level), true);
   }
+  else if (mutt_str_equal(ev_c->name, "trace_file"))
+  {
+    const char *const c_trace_file = cs_subset_path(SpaceMutt->sub, "trace_file");
+    trace_enable(c_trace_file != NULL);
+  }
   else
   {
     return 0;
@@ -40,6 +40,8 @@ GLogLevelFlags debug_level_to_log_level(short debug_level);
 void mutt_log_prep(void);
 int  mutt_log_start(void);
 void mutt_log_stop(void);
+void mutt_trace_start(void);
+void mutt_trace_stop(void);
 int  mutt_log_set_level(GLogLevelFlags level, bool verbose);
 int  mutt_log_set_file(const char *file);
 
@@ -1050,6 +1050,9 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
   if (!tctx->hash)
     init = true;
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "sort", "mutt_sort_threads");
+
   if (init)
   {
     tctx->hash = mutt_hash_new(m->msg_count * 2, MUTT_HASH_ALLOW_DUPS);
@@ -1278,6 +1281,8 @@ void mutt_sort_threads(struct ThreadsContext *tctx, bool init)
     /* Draw the thread tree. */
     mutt_draw_tree(tctx);
   }
+
+  trace_end(&span, mailbox_path(m));
 }
 
 /**
@@ -1426,8 +1431,12 @@ off_t mutt_set_vnum(struct Mailbox *m)
       e->vnum = m->vcount;
       m->v2r[m->vcount] = i;
       m->vcount++;
-      vsize += e->body->length + e->body->offset - e->body->hdr_offset + padding;
     }
+
+    /* Collapsing a thread changes visible and vnum, so refresh everything */
+    hot_set(&m->hot, i, e);
+    if (e->vnum >= 0)
+      vsize += m->hot.size[i] + m->hot.hdr_size[i] + padding;
   }
 
   return vsize;
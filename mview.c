@@ -207,6 +207,8 @@ void mview_update(struct MailboxView *mv)
 
     if (c_score)
       mutt_score_message(mv->mailbox, e, false);
+    else if (e->score_rules != 0)
+      e->score = 0; // Don't show a score remembered by the header cache
 
     if (e->changed)
       m->changed = true;
@@ -222,8 +224,13 @@ void mview_update(struct MailboxView *mv)
       if (!e->old)
         m->msg_new++;
     }
+
+    hot_set(&m->hot, msgno, e);
   }
 
+  /* Save any new scores */
+  mx_hcache_flush(m);
+
   /* rethread from scratch */
   mutt_sort_headers(mv, true);
 }
@@ -293,6 +300,7 @@ static void update_tables(struct MailboxView *mv)
           m->msg_new++;
       }
 
+      hot_set(&m->hot, j, m->emails[j]);
       j++;
     }
     else
@@ -383,13 +391,16 @@ int ea_add_tagged(struct EmailArray *ea, struct MailboxView *mv, struct Email *e
       return -1;
 
     struct Mailbox *m = mv->mailbox;
+    const EmailHotFlags want = EMAIL_HOT_VISIBLE | EMAIL_HOT_TAGGED;
     for (int i = 0; i < m->msg_count; i++)
     {
+      /* Scan the packed flags, only touching the tagged Emails */
+      if ((m->hot.flags[i] & want) != want)
+        continue;
+
       e = m->emails[i];
       if (!e)
         break;
-      if (!message_is_tagged(e))
-        continue;
 
       ARRAY_ADD(ea, e);
     }
@@ -514,6 +525,7 @@ bool mutt_limit_current_thread(struct MailboxView *mv, struct Email *e)
       m->vcount++;
       mv->vsize += (body->length + body->offset - body->hdr_offset);
     }
+    hot_set(&m->hot, i, e);
   }
   return true;
 }
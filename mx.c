@@ -369,7 +369,10 @@ bool mx_mbox_open(struct Mailbox *m, OpenMailboxFlags flags)
   m->msg_tagged = 0;
   m->vcount = 0;
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "mx", "mx_mbox_open");
   enum MxOpenReturns rc = m->mx_ops->mbox_open(m);
+  trace_end(&span, mailbox_path(m));
   m->opened++;
 
   if ((rc == MX_OPEN_OK) || (rc == MX_OPEN_ABORT))
@@ -393,6 +396,9 @@ bool mx_mbox_open(struct Mailbox *m, OpenMailboxFlags flags)
     goto error;
   }
 
+  // An interrupted open doesn't know all the Emails, so can't tell what's stale
+  m->hcache_gc_done = (rc != MX_OPEN_OK);
+
   if (!m->peekonly)
     m->has_new = false;
   OptForceRefresh = false;
@@ -425,6 +431,8 @@ void mx_fastclose_mailbox(struct Mailbox *m, bool keep_account)
   if (!m->peekonly)
     mutt_mailbox_set_notified(m);
 
+  mx_hcache_flush(m);
+
   if (m->mx_ops)
     m->mx_ops->mbox_close(m);
 
@@ -442,6 +450,10 @@ void mx_fastclose_mailbox(struct Mailbox *m, bool keep_account)
     }
   }
 
+  /* Every Email in the Arena holds a reference, so any that outlive the
+   * Mailbox keep it alive */
+  arena_release(&m->arena);
+
   if (!m->visible)
   {
     mx_ac_remove(m, keep_account);
@@ -732,6 +744,7 @@ enum MxStatus mx_mbox_close(struct Mailbox *m)
         {
           e->tagged = false;
         }
+        hot_set(&m->hot, i, e);
       }
 
       i = imap_copy_messages(m, &ea, buf_string(mbox), SAVE_MOVE);
@@ -832,6 +845,7 @@ enum MxStatus mx_mbox_close(struct Mailbox *m)
 
         e->deleted = false;
         e->purge = false;
+        hot_set(&m->hot, i, e);
       }
       m->msg_deleted = 0;
     }
@@ -961,6 +975,7 @@ enum MxStatus mx_mbox_sync(struct Mailbox *m)
             break;
           e->deleted = false;
           e->purge = false;
+          hot_set(&m->hot, i, e);
         }
         m->msg_deleted = 0;
       }
@@ -981,10 +996,13 @@ enum MxStatus mx_mbox_sync(struct Mailbox *m)
       return MX_STATUS_OK;
   }
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "mx", "mx_mbox_sync");
   if (m->type == MUTT_IMAP)
     rc = imap_sync_mailbox(m, purge, false);
   else
     rc = sync_mailbox(m);
+  trace_end(&span, mailbox_path(m));
   if (rc != MX_STATUS_ERROR)
   {
     if ((m->type == MUTT_IMAP) && !purge)
@@ -1107,6 +1125,9 @@ enum MxStatus mx_mbox_check(struct Mailbox *m)
   if (!m || !m->mx_ops)
     return MX_STATUS_ERROR;
 
+  /* Called between screen updates, so a good time to catch up */
+  mx_hcache_flush(m);
+
   const short c_mail_check = cs_subset_number(SpaceMutt->sub, "mail_check");
 
   time_t t = mutt_date_now();
@@ -1115,7 +1136,10 @@ enum MxStatus mx_mbox_check(struct Mailbox *m)
 
   m->last_checked = t;
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "mx", "mx_mbox_check");
   enum MxStatus rc = m->mx_ops->mbox_check(m);
+  trace_end(&span, mailbox_path(m));
   if ((rc == MX_STATUS_NEW_MAIL) || (rc == MX_STATUS_REOPENED))
   {
     mailbox_changed(m, NT_MAILBOX_INVALID);
@@ -1238,6 +1262,7 @@ void mx_alloc_memory(struct Mailbox *m, int req_size)
     m->emails[i] = NULL;
     m->v2r[i] = -1;
   }
+  hot_alloc(&m->hot, m->email_max, req_size);
 
   m->email_max = req_size;
 }
@@ -1788,6 +1813,88 @@ int mx_save_hcache(struct Mailbox *m, struct Email *e)
   return m->mx_ops->msg_save_hcache(m, e);
 }
 
+/**
+ * mx_hcache_defer - Save an Email to the header cache later
+ * @param m Mailbox
+ * @param e Email
+ *
+ * Code that runs while the index is being drawn, e.g. the `%X` expando,
+ * shouldn't write to the header cache.  The Email is saved, with any others,
+ * by mx_hcache_flush().
+ */
+void mx_hcache_defer(struct Mailbox *m, struct Email *e)
+{
+  if (!m || !e || !m->mx_ops || !m->mx_ops->msg_save_hcache)
+    return;
+
+  e->hcache_pending = true;
+  m->hcache_pending = true;
+}
+
+/**
+ * mx_hcache_flush - Save the deferred Emails to the header cache
+ * @param m Mailbox
+ * @retval num Number of Emails saved
+ *
+ * @sa mx_hcache_defer()
+ */
+int mx_hcache_flush(struct Mailbox *m)
+{
+  if (!m || !m->hcache_pending)
+    return 0;
+
+  m->hcache_pending = false;
+
+  int count = 0;
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e)
+      break;
+    if (!e->hcache_pending)
+      continue;
+
+    e->hcache_pending = false;
+    if (mx_save_hcache(m, e) == 0)
+      count++;
+  }
+
+  log_debug2("saved %d deferred emails to the header cache", count);
+  return count;
+}
+
+/**
+ * mx_hcache_idle - Remove stale entries from the header cache, while idle
+ * @param m Mailbox
+ *
+ * This is tried once each time the Mailbox is opened, rather than during the
+ * open, because a clean up may compact the whole cache file.
+ * See $header_cache_gc_interval.
+ */
+void mx_hcache_idle(struct Mailbox *m)
+{
+  if (!m || (m->opened == 0) || m->hcache_gc_done)
+    return;
+
+  m->hcache_gc_done = true;
+  mx_hcache_gc(m, false);
+}
+
+/**
+ * mx_hcache_gc - Remove stale entries from the header cache - Wrapper for MxOps::mbox_hcache_gc()
+ * @param m     Mailbox
+ * @param force Ignore $header_cache_gc_interval
+ * @retval num Number of entries removed
+ * @retval -1  Failure, or the Mailbox doesn't use the header cache
+ */
+int mx_hcache_gc(struct Mailbox *m, bool force)
+{
+  if (!m || !m->mx_ops || !m->mx_ops->mbox_hcache_gc)
+    return -1;
+
+  return m->mx_ops->mbox_hcache_gc(m, force);
+}
+
 /**
  * mx_type - Return the type of the Mailbox
  * @param m Mailbox
@@ -51,6 +51,10 @@ struct Message *     mx_msg_open_new      (struct Mailbox *m, const struct Email
 struct Message *     mx_msg_open          (struct Mailbox *m, struct Email *e);
 int                  mx_msg_padding_size  (struct Mailbox *m);
 int                  mx_save_hcache       (struct Mailbox *m, struct Email *e);
+void                 mx_hcache_defer      (struct Mailbox *m, struct Email *e);
+int                  mx_hcache_flush      (struct Mailbox *m);
+int                  mx_hcache_gc         (struct Mailbox *m, bool force);
+void                 mx_hcache_idle       (struct Mailbox *m);
 int                  mx_path_canon        (struct Buffer *path, const char *folder, enum MailboxType *type);
 int                  mx_path_canon2       (struct Mailbox *m, const char *folder);
 enum MailboxType     mx_path_probe        (const char *path);
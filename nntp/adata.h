@@ -43,6 +43,7 @@ struct NntpAccountData
   bool hasLISTGROUPrange  : 1; ///< Server supports LISTGROUPrange command
   bool hasOVER            : 1; ///< Server supports OVER command
   bool hasXOVER           : 1; ///< Server supports XOVER command
+  bool hasCOMPRESS        : 1; ///< Server supports COMPRESS DEFLATE command
   unsigned int use_tls    : 3;
   unsigned int status     : 3;
   bool cacheable          : 1;
@@ -1268,6 +1268,7 @@ void nntp_article_status(struct Mailbox *m, struct Email *e, char *group, anum_t
     {
       /* can't use mutt_set_flag() because mview_update() didn't get called yet */
       e->read = true;
+      mailbox_hot_update(m, e);
       return;
     }
   }
@@ -1279,7 +1280,10 @@ void nntp_article_status(struct Mailbox *m, struct Email *e, char *group, anum_t
   /* article isn't read but cached, it's old */
   const bool c_mark_old = cs_subset_bool(SpaceMutt->sub, "mark_old");
   if (c_mark_old)
+  {
     e->old = true;
+    mailbox_hot_update(m, e);
+  }
 }
 
 /**
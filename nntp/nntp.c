@@ -98,8 +98,25 @@ struct FetchCtx
   unsigned char *messages;
   struct Progress *progress;
   struct HeaderCache *hc;
+  struct EmailArray hc_pending; ///< Emails waiting to be stored in the header cache
 };
 
+/**
+ * struct HeadCtx - Keep track when getting article headers from a server
+ */
+struct HeadCtx
+{
+  struct FetchCtx *fc;  ///< Fetch context
+  const anum_t *anums;  ///< Article numbers being fetched
+  anum_t anum;          ///< Article number of the current response
+  FILE *fp;             ///< Temporary file for the current response
+};
+
+/// Maximum number of NNTP commands sent ahead of their responses
+#define NNTP_PIPELINE_DEPTH 16
+/// Number of articles requested by each OVER command
+#define NNTP_OVER_WINDOW 5000
+
 /**
  * struct ChildCtx - Keep track of the children of an article
  */
@@ -144,6 +161,7 @@ static int nntp_capabilities(struct NntpAccountData *adata)
   adata->hasLISTGROUP = false;
   adata->hasLISTGROUPrange = false;
   adata->hasOVER = false;
+  adata->hasCOMPRESS = false;
   FREE(&adata->authenticators);
 
   struct Buffer *buf = buf_pool_get();
@@ -204,6 +222,12 @@ static int nntp_capabilities(struct NntpAccountData *adata)
     {
       adata->hasOVER = true;
     }
+    else if ((plen = mutt_str_startswith(buf_string(buf), "COMPRESS ")))
+    {
+      buf_addch(buf, ' ');
+      if (mutt_istr_find(buf->data + plen - 1, " DEFLATE "))
+        adata->hasCOMPRESS = true;
+    }
     else if (mutt_str_startswith(buf_string(buf), "LIST "))
     {
       const char *p = buf_find_string(buf, " NEWSGROUPS");
@@ -788,6 +812,68 @@ done:
   return rc;
 }
 
+/**
+ * nntp_read_lines - Read the lines of a multi-line response
+ * @param mdata    NNTP Mailbox data
+ * @param progress Progress bar (OPTIONAL)
+ * @param func     Callback function (OPTIONAL, the lines are discarded)
+ * @param data     Data for callback function
+ * @retval  0 Success
+ * @retval -1 Connection lost
+ * @retval -2 Error in func(*line, *data)
+ */
+static int nntp_read_lines(struct NntpMboxData *mdata, struct Progress *progress,
+                           int (*func)(char *, void *), void *data)
+{
+  char buf[1024] = { 0 };
+  unsigned int lines = 0;
+  size_t off = 0;
+  int rc = 0;
+
+  char *line = g_malloc(sizeof(buf));
+
+  while (true)
+  {
+    char *p = NULL;
+    int chunk = mutt_socket_readln_d(buf, sizeof(buf), mdata->adata->conn, MUTT_SOCK_LOG_LEVEL_FULL);
+    if (chunk < 0)
+    {
+      mdata->adata->status = NNTP_NONE;
+      rc = -1;
+      break;
+    }
+
+    p = buf;
+    if (!off && (buf[0] == '.'))
+    {
+      if (buf[1] == '\0')
+        break;
+      if (buf[1] == '.')
+        p++;
+    }
+
+    mutt_str_copy(line + off, p, sizeof(buf));
+
+    if (chunk >= sizeof(buf))
+    {
+      off += strlen(p);
+    }
+    else
+    {
+      progress_update(progress, ++lines, -1);
+
+      if ((rc == 0) && func && (func(line, data) < 0))
+        rc = -2;
+      off = 0;
+    }
+
+    line = g_realloc(line, off + sizeof(buf));
+  }
+  FREE(&line);
+
+  return rc;
+}
+
 /**
  * nntp_fetch_lines - Read lines, calling a callback function for each
  * @param mdata NNTP Mailbox data
@@ -807,15 +893,11 @@ done:
 static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen,
                             const char *msg, int (*func)(char *, void *), void *data)
 {
-  bool done = false;
   int rc;
 
-  while (!done)
+  while (true)
   {
     char buf[1024] = { 0 };
-    char *line = NULL;
-    unsigned int lines = 0;
-    size_t off = 0;
     struct Progress *progress = NULL;
 
     mutt_str_copy(buf, query, sizeof(buf));
@@ -827,57 +909,95 @@ static int nntp_fetch_lines(struct NntpMboxData *mdata, char *query, size_t qlen
       return 1;
     }
 
-    line = g_malloc(sizeof(buf));
-    rc = 0;
-
     if (msg)
     {
       progress = progress_new(MUTT_PROGRESS_READ, 0);
       progress_set_message(progress, "%s", msg);
     }
 
-    while (true)
+    rc = nntp_read_lines(mdata, progress, func, data);
+    func(NULL, data);
+    progress_free(&progress);
+
+    /* connection lost, reconnect and try again */
+    if (rc != -1)
+      break;
+  }
+
+  return rc;
+}
+
+/**
+ * nntp_fetch_lines_pipelined - Send several commands at once, reading the lines of each response
+ * @param[in]  mdata  NNTP Mailbox data
+ * @param[in]  cmds   Commands to send
+ * @param[in]  num    Number of commands
+ * @param[in]  status Callback function for the status line of each response
+ * @param[in]  func   Callback function for each line of a response
+ * @param[in]  data   Data for callback functions
+ * @param[out] done   Number of commands whose response has been handled
+ * @retval  0 Success
+ * @retval -1 Connection lost
+ * @retval -2 Error in a callback function
+ *
+ * Up to #NNTP_PIPELINE_DEPTH commands are sent ahead of their responses
+ * (RFC3977, 3.5).  This function calls status(idx, *line, *data) for the
+ * status line of each response.  A 2xx status is taken to start a multi-line
+ * response: func(*line, *data) is called for each line, then func(NULL, *data).
+ *
+ * Once a callback fails, no more commands are sent, but the responses of
+ * those already sent are still read, to keep the connection usable.
+ */
+static int nntp_fetch_lines_pipelined(struct NntpMboxData *mdata, char **cmds, size_t num,
+                                      int (*status)(size_t, const char *, void *),
+                                      int (*func)(char *, void *), void *data, size_t *done)
+{
+  struct Connection *conn = mdata->adata->conn;
+  char buf[1024] = { 0 };
+  size_t sent = 0;
+  int rc = 0;
+
+  *done = 0;
+  if (mdata->adata->status != NNTP_OK)
+    return -1;
+
+  for (size_t i = 0; i < num; i++)
+  {
+    while ((rc == 0) && (sent < num) && ((sent - i) < NNTP_PIPELINE_DEPTH))
     {
-      char *p = NULL;
-      int chunk = mutt_socket_readln_d(buf, sizeof(buf), mdata->adata->conn, MUTT_SOCK_LOG_LEVEL_FULL);
-      if (chunk < 0)
+      if (mutt_socket_send(conn, cmds[sent]) < 0)
       {
         mdata->adata->status = NNTP_NONE;
-        break;
+        return -1;
       }
+      sent++;
+    }
+    if (i == sent)
+      break;
 
-      p = buf;
-      if (!off && (buf[0] == '.'))
-      {
-        if (buf[1] == '\0')
-        {
-          done = true;
-          break;
-        }
-        if (buf[1] == '.')
-          p++;
-      }
+    if (mutt_socket_readln(buf, sizeof(buf), conn) < 0)
+    {
+      mdata->adata->status = NNTP_NONE;
+      return -1;
+    }
 
-      mutt_str_copy(line + off, p, sizeof(buf));
+    if ((rc == 0) && (status(i, buf, data) < 0))
+      rc = -2;
 
-      if (chunk >= sizeof(buf))
+    if (buf[0] == '2')
+    {
+      int rc_lines = nntp_read_lines(mdata, NULL, (rc == 0) ? func : NULL, data);
+      if (rc_lines == -1)
+        return -1;
+      if (rc == 0)
       {
-        off += strlen(p);
+        func(NULL, data);
+        rc = rc_lines;
       }
-      else
-      {
-        progress_update(progress, ++lines, -1);
-
-        if ((rc == 0) && (func(line, data) < 0))
-          rc = -2;
-        off = 0;
-      }
-
-      line = g_realloc(line, off + sizeof(buf));
     }
-    FREE(&line);
-    func(NULL, data);
-    progress_free(&progress);
+
+    if (rc == 0)
+      *done = i + 1;
   }
 
   return rc;
@@ -1031,6 +1151,62 @@ static int fetch_numbers(char *line, void *data)
   return 0;
 }
 
+/**
+ * fetch_ctx_store_hcache - Store the pending Emails in the header cache
+ * @param fc Fetch context
+ *
+ * The header cache is written in batches, once per server response, rather
+ * than in between reading the lines of the response.
+ */
+static void fetch_ctx_store_hcache(struct FetchCtx *fc)
+{
+#ifdef USE_HCACHE
+  char buf[16] = { 0 };
+  struct Email **ep = NULL;
+  ARRAY_FOREACH(ep, &fc->hc_pending)
+  {
+    snprintf(buf, sizeof(buf), ANUM_FMT, nntp_edata_get(*ep)->article_num);
+    log_debug2("hcache_store_email %s", buf);
+    hcache_store_email(fc->hc, buf, strlen(buf), *ep, 0);
+  }
+#endif
+  ARRAY_SHRINK(&fc->hc_pending, ARRAY_SIZE(&fc->hc_pending));
+}
+
+/**
+ * fetch_ctx_add_email - Save an article's header in the Mailbox
+ * @param fc   Fetch context
+ * @param e    Email
+ * @param anum Article number
+ */
+static void fetch_ctx_add_email(struct FetchCtx *fc, struct Email *e, anum_t anum)
+{
+  struct Mailbox *m = fc->mailbox;
+  struct NntpMboxData *mdata = m->mdata;
+
+  mx_alloc_memory(m, m->msg_count);
+  m->emails[m->msg_count] = e;
+  e->index = m->msg_count++;
+  e->read = false;
+  e->old = false;
+  e->deleted = false;
+  e->edata = nntp_edata_new();
+  e->edata_free = nntp_edata_free;
+  nntp_edata_get(e)->article_num = anum;
+  if (fc->restore)
+  {
+    e->changed = true;
+  }
+  else
+  {
+    nntp_article_status(m, e, NULL, anum);
+    if (!e->read)
+      nntp_parse_xref(m, e);
+  }
+  if (anum > mdata->last_loaded)
+    mdata->last_loaded = anum;
+}
+
 /**
  * parse_overview_line - Parse overview line
  * @param line String to parse
@@ -1040,10 +1216,16 @@ static int fetch_numbers(char *line, void *data)
  */
 static int parse_overview_line(char *line, void *data)
 {
-  if (!line || !data)
+  if (!data)
     return 0;
 
   struct FetchCtx *fc = data;
+  if (!line)
+  {
+    fetch_ctx_store_hcache(fc);
+    return 0;
+  }
+
   struct Mailbox *m = fc->mailbox;
   if (!m)
     return -1;
@@ -1052,6 +1234,7 @@ static int parse_overview_line(char *line, void *data)
   struct Email *e = NULL;
   char *header = NULL, *field = NULL;
   bool save = true;
+  bool store = false;
   anum_t anum = 0;
 
   /* parse article number */
@@ -1104,12 +1287,8 @@ static int parse_overview_line(char *line, void *data)
   }
   rewind(fp);
 
-  /* allocate memory for headers */
-  mx_alloc_memory(m, m->msg_count);
-
   /* parse header */
-  m->emails[m->msg_count] = email_new();
-  e = m->emails[m->msg_count];
+  e = email_new();
   e->env = mutt_rfc822_read_header(fp, e, false, false);
   e->env->newsgroups = mutt_str_dup(mdata->group);
   e->received = e->date_sent;
@@ -1128,7 +1307,6 @@ static int parse_overview_line(char *line, void *data)
       log_debug2("hcache_fetch_email %s", buf);
       email_free(&e);
       e = hce.email;
-      m->emails[m->msg_count] = e;
       e->edata = NULL;
       e->read = false;
       e->old = false;
@@ -1147,43 +1325,258 @@ static int parse_overview_line(char *line, void *data)
     else
     {
       /* not cached yet, store header */
-      log_debug2("hcache_store_email %s", buf);
-      hcache_store_email(fc->hc, buf, strlen(buf), e, 0);
+      store = true;
     }
   }
 #endif
 
   if (save)
   {
-    e->index = m->msg_count++;
-    e->read = false;
-    e->old = false;
-    e->deleted = false;
-    e->edata = nntp_edata_new();
-    e->edata_free = nntp_edata_free;
-    nntp_edata_get(e)->article_num = anum;
-    if (fc->restore)
+    fetch_ctx_add_email(fc, e, anum);
+    if (store)
+      ARRAY_ADD(&fc->hc_pending, e);
+  }
+  else
+  {
+    email_free(&e);
+  }
+
+  progress_update(fc->progress, anum - fc->first + 1, -1);
+  return 0;
+}
+
+/**
+ * fetch_overview_status - Check the status of an OVER response
+ * @param idx  Index of the command
+ * @param line Status line
+ * @param data FetchCtx
+ * @retval  0 Success
+ * @retval -1 Failure
+ */
+static int fetch_overview_status(size_t idx, const char *line, void *data)
+{
+  /* 423: no articles in that range */
+  if ((line[0] == '2') || mutt_str_startswith(line, "423"))
+    return 0;
+
+  log_fault("OVER: %s", line);
+  return -1;
+}
+
+/**
+ * nntp_fetch_overview - Fetch overview information for a range of articles
+ * @param fc    Fetch context
+ * @param first Number of first article
+ * @param last  Number of last article
+ * @retval  0 Success
+ * @retval <0 Failure
+ *
+ * A large range is split into windows of #NNTP_OVER_WINDOW articles, which
+ * are requested in a pipeline.  If the connection is lost, the remaining
+ * articles are requested with a single command, which reconnects.
+ */
+static int nntp_fetch_overview(struct FetchCtx *fc, anum_t first, anum_t last)
+{
+  struct NntpMboxData *mdata = fc->mailbox->mdata;
+  const char *cmd = mdata->adata->hasOVER ? "OVER" : "XOVER";
+  char buf[1024] = { 0 };
+  int rc;
+
+  const size_t num = ((last - first) / NNTP_OVER_WINDOW) + 1;
+  if (num > 1)
+  {
+    char **cmds = g_new0(char *, num + 1);
+    for (size_t i = 0; i < num; i++)
     {
-      e->changed = true;
+      anum_t from = first + (i * NNTP_OVER_WINDOW);
+      anum_t to = MIN(from + NNTP_OVER_WINDOW - 1, last);
+      cmds[i] = g_strdup_printf("%s " ANUM_FMT "-" ANUM_FMT "\r\n", cmd, from, to);
     }
-    else
+
+    size_t done = 0;
+    rc = nntp_fetch_lines_pipelined(mdata, cmds, num, fetch_overview_status,
+                                    parse_overview_line, fc, &done);
+    g_strfreev(cmds);
+    if (rc != -1)
+      return rc;
+
+    /* connection lost, carry on after the last article we've got */
+    first = MAX(first + (done * NNTP_OVER_WINDOW), mdata->last_loaded + 1);
+    if (first > last)
+      return 0;
+  }
+
+  snprintf(buf, sizeof(buf), "%s " ANUM_FMT "-" ANUM_FMT "\r\n", cmd, first, last);
+  rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, parse_overview_line, fc);
+  if (rc > 0)
+  {
+    log_fault("%s: %s", cmd, buf);
+  }
+  return rc;
+}
+
+/**
+ * nntp_fetch_head - Fetch the header of an article
+ * @param fc   Fetch context
+ * @param anum Article number
+ * @retval  0 Success, or no such article
+ * @retval <0 Failure
+ */
+static int nntp_fetch_head(struct FetchCtx *fc, anum_t anum)
+{
+  struct NntpMboxData *mdata = fc->mailbox->mdata;
+  char buf[1024] = { 0 };
+
+  FILE *fp = mutt_file_mkstemp();
+  if (!fp)
+  {
+    log_perror(_("Can't create temporary file"));
+    return -1;
+  }
+
+  snprintf(buf, sizeof(buf), "HEAD " ANUM_FMT "\r\n", anum);
+  int rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_tempfile, fp);
+  if (rc)
+  {
+    mutt_file_fclose(&fp);
+    if (rc < 0)
+      return rc;
+
+    /* invalid response */
+    if (!mutt_str_startswith(buf, "423"))
+    {
+      log_fault("HEAD: %s", buf);
+      return -1;
+    }
+
+    /* no such article */
+    if (mdata->bcache)
     {
-      nntp_article_status(m, e, NULL, anum);
-      if (!e->read)
-        nntp_parse_xref(m, e);
+      snprintf(buf, sizeof(buf), ANUM_FMT, anum);
+      log_debug2("#3 mutt_bcache_del %s", buf);
+      mutt_bcache_del(mdata->bcache, buf);
     }
-    if (anum > mdata->last_loaded)
-      mdata->last_loaded = anum;
+    return 0;
   }
-  else
+
+  /* parse header */
+  struct Email *e = email_new();
+  e->env = mutt_rfc822_read_header(fp, e, false, false);
+  e->received = e->date_sent;
+  mutt_file_fclose(&fp);
+
+  fetch_ctx_add_email(fc, e, anum);
+  return 0;
+}
+
+/**
+ * fetch_head_status - Check the status of a HEAD response
+ * @param idx  Index of the command
+ * @param line Status line
+ * @param data HeadCtx
+ * @retval  0 Success
+ * @retval -1 Failure
+ */
+static int fetch_head_status(size_t idx, const char *line, void *data)
+{
+  struct HeadCtx *hctx = data;
+  struct NntpMboxData *mdata = hctx->fc->mailbox->mdata;
+
+  hctx->anum = hctx->anums[idx];
+
+  if (line[0] == '2')
   {
-    email_free(&e);
+    hctx->fp = mutt_file_mkstemp();
+    if (!hctx->fp)
+    {
+      log_perror(_("Can't create temporary file"));
+      return -1;
+    }
+    return 0;
   }
 
-  progress_update(fc->progress, anum - fc->first + 1, -1);
+  /* invalid response */
+  if (!mutt_str_startswith(line, "423"))
+  {
+    log_fault("HEAD: %s", line);
+    return -1;
+  }
+
+  /* no such article */
+  if (mdata->bcache)
+  {
+    char buf[16] = { 0 };
+    snprintf(buf, sizeof(buf), ANUM_FMT, hctx->anum);
+    log_debug2("#3 mutt_bcache_del %s", buf);
+    mutt_bcache_del(mdata->bcache, buf);
+  }
   return 0;
 }
 
+/**
+ * fetch_head_line - Save a line of an article's header
+ * @param line Header line, or NULL at the end of the header
+ * @param data HeadCtx
+ * @retval  0 Success
+ * @retval -1 Failure
+ */
+static int fetch_head_line(char *line, void *data)
+{
+  struct HeadCtx *hctx = data;
+  if (!hctx->fp)
+    return -1;
+
+  if (line)
+    return fetch_tempfile(line, hctx->fp);
+
+  /* parse header */
+  rewind(hctx->fp);
+  struct Email *e = email_new();
+  e->env = mutt_rfc822_read_header(hctx->fp, e, false, false);
+  e->received = e->date_sent;
+  mutt_file_fclose(&hctx->fp);
+
+  fetch_ctx_add_email(hctx->fc, e, hctx->anum);
+  return 0;
+}
+
+/**
+ * nntp_fetch_heads - Fetch the headers of several articles
+ * @param fc    Fetch context
+ * @param anums Article numbers
+ * @param num   Number of articles
+ * @retval  0 Success
+ * @retval <0 Failure
+ *
+ * The HEAD commands are sent in a pipeline.  If the connection is lost, the
+ * remaining headers are fetched one by one, which reconnects.
+ */
+static int nntp_fetch_heads(struct FetchCtx *fc, const anum_t *anums, size_t num)
+{
+  struct NntpMboxData *mdata = fc->mailbox->mdata;
+  struct HeadCtx hctx = { fc, anums, 0, NULL };
+
+  char **cmds = g_new0(char *, num + 1);
+  for (size_t i = 0; i < num; i++)
+    cmds[i] = g_strdup_printf("HEAD " ANUM_FMT "\r\n", anums[i]);
+
+  size_t done = 0;
+  int rc = nntp_fetch_lines_pipelined(mdata, cmds, num, fetch_head_status,
+                                      fetch_head_line, &hctx, &done);
+  g_strfreev(cmds);
+  mutt_file_fclose(&hctx.fp);
+
+  /* connection lost, fetch the rest one by one */
+  if (rc == -1)
+  {
+    rc = 0;
+    for (size_t i = done; (i < num) && (rc == 0); i++)
+      rc = nntp_fetch_head(fc, anums[i]);
+  }
+
+  return rc;
+}
+
 /**
  * nntp_fetch_headers - Fetch headers
  * @param m       Mailbox
@@ -1206,6 +1599,7 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
   int rc = 0;
   anum_t current;
   anum_t first_over = first;
+  GArray *heads = NULL; // Articles to fetch with HEAD
 
   /* if empty group or nothing to do */
   if (!last || (first > last))
@@ -1220,6 +1614,7 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
   if (!fc.messages)
     return -1;
   fc.hc = hc;
+  heads = g_array_new(FALSE, FALSE, sizeof(anum_t));
 
   /* fetch list of articles */
   const bool c_nntp_listgroup = cs_subset_bool(SpaceMutt->sub, "nntp_listgroup");
@@ -1289,9 +1684,6 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
     if (!fc.messages[current - first])
       continue;
 
-    /* allocate memory for headers */
-    mx_alloc_memory(m, m->msg_count);
-
 #ifdef USE_HCACHE
     /* try to fetch header from cache */
     struct HCacheEntry hce = hcache_fetch_email(fc.hc, buf, strlen(buf), 0);
@@ -1299,7 +1691,6 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
     {
       log_debug2("hcache_fetch_email %s", buf);
       e = hce.email;
-      m->emails[m->msg_count] = e;
       e->edata = NULL;
 
       /* skip header marked as deleted in cache */
@@ -1334,87 +1725,49 @@ static int nntp_fetch_headers(struct Mailbox *m, void *hc, anum_t first, anum_t
     }
     else
     {
-      /* fetch header from server */
-      FILE *fp = mutt_file_mkstemp();
-      if (!fp)
-      {
-        log_perror(_("Can't create temporary file"));
-        rc = -1;
-        break;
-      }
+      /* fetch header from server, later */
+      g_array_append_val(heads, current);
+      continue;
+    }
 
-      snprintf(buf, sizeof(buf), "HEAD " ANUM_FMT "\r\n", current);
-      rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, fetch_tempfile, fp);
-      if (rc)
+    /* keep the articles in order, fetch the earlier headers first */
+    if (heads->len > 0)
+    {
+      rc = nntp_fetch_heads(&fc, (const anum_t *) heads->data, heads->len);
+      first_over = g_array_index(heads, anum_t, heads->len - 1) + 1;
+      g_array_set_size(heads, 0);
+      if (rc != 0)
       {
-        mutt_file_fclose(&fp);
-        if (rc < 0)
-          break;
-
-        /* invalid response */
-        if (!mutt_str_startswith(buf, "423"))
-        {
-          log_fault("HEAD: %s", buf);
-          break;
-        }
-
-        /* no such article */
-        if (mdata->bcache)
-        {
-          snprintf(buf, sizeof(buf), ANUM_FMT, current);
-          log_debug2("#3 mutt_bcache_del %s", buf);
-          mutt_bcache_del(mdata->bcache, buf);
-        }
-        rc = 0;
-        continue;
+        email_free(&e);
+        break;
       }
-
-      /* parse header */
-      m->emails[m->msg_count] = email_new();
-      e = m->emails[m->msg_count];
-      e->env = mutt_rfc822_read_header(fp, e, false, false);
-      e->received = e->date_sent;
-      mutt_file_fclose(&fp);
     }
 
     /* save header in context */
-    e->index = m->msg_count++;
-    e->read = false;
-    e->old = false;
-    e->deleted = false;
-    e->edata = nntp_edata_new();
-    e->edata_free = nntp_edata_free;
-    nntp_edata_get(e)->article_num = current;
-    if (restore)
-    {
-      e->changed = true;
-    }
-    else
-    {
-      nntp_article_status(m, e, NULL, nntp_edata_get(e)->article_num);
-      if (!e->read)
-        nntp_parse_xref(m, e);
-    }
-    if (current > mdata->last_loaded)
-      mdata->last_loaded = current;
+    fetch_ctx_add_email(&fc, e, current);
     first_over = current + 1;
   }
 
+  /* fetch headers from a server that lacks overview support */
+  if ((heads->len > 0) && (rc == 0))
+  {
+    rc = nntp_fetch_heads(&fc, (const anum_t *) heads->data, heads->len);
+    first_over = g_array_index(heads, anum_t, heads->len - 1) + 1;
+  }
+
   if (!c_nntp_listgroup || !mdata->adata->hasLISTGROUP)
     current = first_over;
 
   /* fetch overview information */
-  if ((current <= last) && (rc == 0) && !mdata->deleted)
+  if ((current <= last) && (rc == 0) && !mdata->deleted &&
+      (mdata->adata->hasOVER || mdata->adata->hasXOVER))
   {
-    char *cmd = mdata->adata->hasOVER ? "OVER" : "XOVER";
-    snprintf(buf, sizeof(buf), "%s " ANUM_FMT "-" ANUM_FMT "\r\n", cmd, current, last);
-    rc = nntp_fetch_lines(mdata, buf, sizeof(buf), NULL, parse_overview_line, &fc);
-    if (rc > 0)
-    {
-      log_fault("%s: %s", cmd, buf);
-    }
+    rc = nntp_fetch_overview(&fc, current, last);
   }
 
+  fetch_ctx_store_hcache(&fc);
+  ARRAY_FREE(&fc.hc_pending);
+  g_array_free(heads, TRUE);
   FREE(&fc.messages);
   progress_free(&fc.progress);
   if (rc != 0)
@@ -1588,6 +1941,7 @@ static enum MxStatus check_mailbox(struct Mailbox *m)
         m->emails[i]->flagged = flagged;
         m->emails[i]->read = false;
         m->emails[i]->old = false;
+        mailbox_hot_update(m, m->emails[i]);
         nntp_article_status(m, m->emails[i], NULL, anum);
         if (!m->emails[i]->read)
           nntp_parse_xref(m, m->emails[i]);
@@ -1918,6 +2272,25 @@ int nntp_open_connection(struct NntpAccountData *adata)
     }
   }
 
+#ifdef USE_ZLIB
+  /* RFC8054 */
+  const bool c_nntp_compress = cs_subset_bool(SpaceMutt->sub, "nntp_compress");
+  if (adata->hasCOMPRESS && c_nntp_compress)
+  {
+    if ((mutt_socket_send(conn, "COMPRESS DEFLATE\r\n") < 0) ||
+        (mutt_socket_readln(buf, sizeof(buf), conn) < 0))
+    {
+      nntp_connect_error(adata);
+      goto done;
+    }
+    if (mutt_str_startswith(buf, "206"))
+    {
+      log_debug2("NNTP compression is enabled on connection to %s", conn->account.host);
+      mutt_zstrm_wrap_conn(conn);
+    }
+  }
+#endif
+
   /* attempt features */
   if (nntp_attempt_features(adata) < 0)
     goto done;
@@ -2817,6 +3190,7 @@ const struct MxOps MxNntpOps = {
   .msg_close        = nntp_msg_close,
   .msg_padding_size = NULL,
   .msg_save_hcache  = NULL,
+  .mbox_hcache_gc   = NULL,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
   .path_probe       = nntp_path_probe,
@@ -34,6 +34,9 @@
 #include "mdata.h"
 #include "progress/lib.h"
 #include "query.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
 
 /**
  * nm_mdata_free - Free the private Mailbox data - Implements Mailbox::mdata_free() - @ingroup mailbox_mdata_free
@@ -54,6 +57,9 @@ void nm_mdata_free(void **ptr)
   url_free(&mdata->db_url);
   FREE(&mdata->db_query);
   progress_free(&mdata->progress);
+#ifdef USE_HCACHE
+  hcache_close(&mdata->hcache);
+#endif
   FREE(ptr);
 }
 
@@ -26,6 +26,7 @@
 #include <time.h>
 #include "query.h"
 
+struct HeaderCache;
 struct Mailbox;
 
 /**
@@ -42,6 +43,7 @@ struct NmMboxData
   int oldmsgcount;
   int ignmsgcount;             ///< Ignored messages
   struct timespec mtime;       ///< Time Mailbox was last changed
+  struct HeaderCache *hcache;  ///< Header cache, open while the Mailbox is
 };
 
 void                  nm_mdata_free(void **ptr);
@@ -51,6 +51,7 @@
 
 #include "config.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <notmuch.h>
 #include <stdbool.h>
@@ -112,28 +113,57 @@ void nm_init(void)
 }
 
 /**
- * nm_hcache_open - Open a header cache
+ * nm_hcache_open - Get the Mailbox's header cache
  * @param m Mailbox
- * @retval ptr Header cache handle
+ * @retval ptr Header cache handle, owned by the Mailbox
+ *
+ * The header cache is opened on first use and stays open until
+ * nm_hcache_close().  Its writes are batched.
  */
 static struct HeaderCache *nm_hcache_open(struct Mailbox *m)
 {
 #ifdef USE_HCACHE
-  const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
-  return hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+  struct NmMboxData *mdata = nm_mdata_get(m);
+  if (!mdata)
+    return NULL;
+
+  if (!mdata->hcache)
+  {
+    const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
+    mdata->hcache = hcache_open(c_header_cache, mailbox_path(m), NULL, true);
+    if (mdata->hcache)
+      mdata->hcache->batch = true;
+  }
+
+  return mdata->hcache;
 #else
   return NULL;
 #endif
 }
 
 /**
- * nm_hcache_close - Close the header cache
- * @param ptr Header cache handle
+ * nm_hcache_flush - Write the header cache's pending changes
+ * @param m Mailbox
  */
-static void nm_hcache_close(struct HeaderCache **ptr)
+static void nm_hcache_flush(struct Mailbox *m)
 {
 #ifdef USE_HCACHE
-  hcache_close(ptr);
+  struct NmMboxData *mdata = nm_mdata_get(m);
+  if (mdata)
+    hcache_flush(mdata->hcache);
+#endif
+}
+
+/**
+ * nm_hcache_close - Close the Mailbox's header cache
+ * @param m Mailbox
+ */
+static void nm_hcache_close(struct Mailbox *m)
+{
+#ifdef USE_HCACHE
+  struct NmMboxData *mdata = nm_mdata_get(m);
+  if (mdata)
+    hcache_close(&mdata->hcache);
 #endif
 }
 
@@ -740,94 +770,102 @@ static struct Email *get_mutt_email(struct Mailbox *m, notmuch_message_t *msg)
 }
 
 /**
- * append_message - Associate a message
- * @param hc    Header cache handle
- * @param m     Mailbox
- * @param msg   Notmuch message
- * @param dedup De-duplicate results
+ * is_duplicate_message - Should a message be skipped as a duplicate?
+ * @param m       Mailbox
+ * @param msg     Notmuch message
+ * @param dedup   De-duplicate results
+ * @param pending Ids of the messages waiting to be added, or NULL
+ * @retval true The message is already in the Mailbox, or waiting to be added
  */
-static void append_message(struct HeaderCache *hc, struct Mailbox *m,
-                           notmuch_message_t *msg, bool dedup)
+static bool is_duplicate_message(struct Mailbox *m, notmuch_message_t *msg,
+                                 bool dedup, GHashTable *pending)
 {
+  if (!dedup)
+    return false;
+
+  const char *id = notmuch_message_get_message_id(msg);
+  if (!(pending && id && g_hash_table_contains(pending, id)) && !get_mutt_email(m, msg))
+    return false;
+
   struct NmMboxData *mdata = nm_mdata_get(m);
-  if (!mdata)
-    return;
+  mdata->ignmsgcount++;
+  nm_progress_update(m);
+  log_debug2("nm: ignore id=%s, already in the m", notmuch_message_get_message_id(msg));
+  return true;
+}
 
-  char *newpath = NULL;
+/**
+ * parse_message_file - Parse the Email of a Notmuch message from its file
+ * @param[in]  path    Path to the message, as known by Notmuch
+ * @param[in]  fp      Open message file, or NULL
+ * @param[out] newpath Set to the new path, if the file has been moved
+ * @retval ptr  Parsed Email
+ * @retval NULL Error
+ *
+ * If fp is given, it is used (and closed) instead of opening path.
+ */
+static struct Email *parse_message_file(const char *path, FILE *fp, char **newpath)
+{
   struct Email *e = NULL;
 
-  /* deduplicate */
-  if (dedup && get_mutt_email(m, msg))
+  if (fp || (access(path, F_OK) == 0))
   {
-    mdata->ignmsgcount++;
-    nm_progress_update(m);
-    log_debug2("nm: ignore id=%s, already in the m",
-               notmuch_message_get_message_id(msg));
-    return;
+    /* We pass is_old=false as argument here, but e->old will be updated later
+     * by update_message_path() (called by init_email() below).  */
+    e = maildir_email_new();
+    bool parsed = fp ? maildir_parse_stream(fp, path, false, e) :
+                       maildir_parse_message(path, false, e);
+    if (!parsed)
+      email_free(&e);
+    mutt_file_fclose(&fp);
   }
-
-  const char *path = get_message_last_filename(msg);
-  if (!path)
-    return;
-
-  log_debug2("nm: appending message, i=%d, id=%s, path=%s",
-             m->msg_count, notmuch_message_get_message_id(msg), path);
-
-  mx_alloc_memory(m, m->msg_count);
-
-#ifdef USE_HCACHE
-  e = hcache_fetch_email(hc, path, mutt_str_len(path), 0).email;
-  if (!e)
-#endif
+  else
   {
-    if (access(path, F_OK) == 0)
-    {
-      /* We pass is_old=false as argument here, but e->old will be updated later
-       * by update_message_path() (called by init_email() below).  */
-      e = maildir_email_new();
-      if (!maildir_parse_message(path, false, e))
-        email_free(&e);
-    }
-    else
-    {
-      /* maybe moved try find it... */
-      char *folder = get_folder_from_path(path);
+    /* maybe moved try find it... */
+    char *folder = get_folder_from_path(path);
 
-      if (folder)
+    if (folder)
+    {
+      fp = maildir_open_find_message(folder, path, newpath);
+      if (fp)
       {
-        FILE *fp = maildir_open_find_message(folder, path, &newpath);
-        if (fp)
-        {
-          e = maildir_email_new();
-          if (!maildir_parse_stream(fp, newpath, false, e))
-            email_free(&e);
-          mutt_file_fclose(&fp);
+        e = maildir_email_new();
+        if (!maildir_parse_stream(fp, *newpath, false, e))
+          email_free(&e);
+        mutt_file_fclose(&fp);
 
-          log_debug1("nm: not up-to-date: %s -> %s", path, newpath);
-        }
+        log_debug1("nm: not up-to-date: %s -> %s", path, *newpath);
       }
-      FREE(&folder);
     }
+    FREE(&folder);
+  }
 
-    if (!e)
-    {
-      log_debug1("nm: failed to parse message: %s", path);
-      goto done;
-    }
+  if (!e)
+    log_debug1("nm: failed to parse message: %s", path);
 
-#ifdef USE_HCACHE
-    hcache_store_email(hc, newpath ? newpath : path,
-                       mutt_str_len(newpath ? newpath : path), e, 0);
-#endif
-  }
+  return e;
+}
 
+/**
+ * append_email - Add a loaded Email to the Mailbox
+ * @param m       Mailbox
+ * @param msg     Notmuch message
+ * @param e       Email, will be consumed
+ * @param path    Path to the message, as known by Notmuch
+ * @param newpath New path of the message, if it has been moved
+ */
+static void append_email(struct Mailbox *m, notmuch_message_t *msg,
+                         struct Email *e, const char *path, const char *newpath)
+{
   if (init_email(e, newpath ? newpath : path, msg) != 0)
   {
     email_free(&e);
     log_debug1("nm: failed to append email!");
-    goto done;
+    return;
   }
 
+  mx_alloc_memory(m, m->msg_count);
+
   e->active = true;
   e->index = m->msg_count;
   mailbox_size_add(m, e);
@@ -845,6 +883,52 @@ static void append_message(struct HeaderCache *hc, struct Mailbox *m,
     }
   }
   nm_progress_update(m);
+}
+
+/**
+ * append_message - Associate a message
+ * @param hc    Header cache handle
+ * @param m     Mailbox
+ * @param msg   Notmuch message
+ * @param dedup De-duplicate results
+ */
+static void append_message(struct HeaderCache *hc, struct Mailbox *m,
+                           notmuch_message_t *msg, bool dedup)
+{
+  struct NmMboxData *mdata = nm_mdata_get(m);
+  if (!mdata)
+    return;
+
+  char *newpath = NULL;
+  struct Email *e = NULL;
+
+  if (is_duplicate_message(m, msg, dedup, NULL))
+    return;
+
+  const char *path = get_message_last_filename(msg);
+  if (!path)
+    return;
+
+  log_debug2("nm: appending message, i=%d, id=%s, path=%s",
+             m->msg_count, notmuch_message_get_message_id(msg), path);
+
+#ifdef USE_HCACHE
+  e = hcache_fetch_email(hc, path, mutt_str_len(path), 0).email;
+  if (!e)
+#endif
+  {
+    e = parse_message_file(path, NULL, &newpath);
+    if (!e)
+      goto done;
+
+#ifdef USE_HCACHE
+    hcache_store_email(hc, newpath ? newpath : path,
+                       mutt_str_len(newpath ? newpath : path), e, 0);
+#endif
+  }
+
+  append_email(m, msg, e, path, newpath);
+
 done:
   FREE(&newpath);
 }
@@ -930,6 +1014,101 @@ static notmuch_messages_t *get_messages(notmuch_query_t *query)
   return msgs;
 }
 
+/// Number of messages loaded together by read_mesgs_query()
+#define NM_LOAD_BATCH 256
+/// Bytes of each message file to read ahead, enough for the headers
+#define NM_HEADER_READAHEAD (32 * 1024)
+
+/**
+ * struct NmLoadEntry - A Notmuch message waiting to be loaded
+ */
+struct NmLoadEntry
+{
+  notmuch_message_t *msg; ///< Notmuch message
+  const char *path;       ///< Last filename of the message, owned by msg
+  struct Email *email;    ///< Email, from the header cache or parsed
+  FILE *fp;               ///< Message file, opened ahead of parsing
+};
+ARRAY_HEAD(NmLoadArray, struct NmLoadEntry);
+
+/**
+ * load_batch - Load a batch of Notmuch messages into the Mailbox
+ * @param hc    Header cache handle
+ * @param m     Mailbox
+ * @param batch Messages to load, in query order
+ *
+ * The header cache is consulted for the whole batch first.  The files of the
+ * messages that missed are then opened and the kernel is asked to read their
+ * headers ahead, so that their I/O overlaps while they're parsed, one by one.
+ * Finally, the Emails are added to the Mailbox in query order.
+ */
+static void load_batch(struct HeaderCache *hc, struct Mailbox *m, struct NmLoadArray *batch)
+{
+  struct NmLoadEntry *ent = NULL;
+
+#ifdef USE_HCACHE
+  ARRAY_FOREACH(ent, batch)
+  {
+    ent->email = hcache_fetch_email(hc, ent->path, mutt_str_len(ent->path), 0).email;
+  }
+#endif
+
+  ARRAY_FOREACH(ent, batch)
+  {
+    if (ent->email)
+      continue;
+
+    ent->fp = mutt_file_fopen(ent->path, "r");
+#ifdef POSIX_FADV_WILLNEED
+    if (ent->fp)
+      posix_fadvise(fileno(ent->fp), 0, NM_HEADER_READAHEAD, POSIX_FADV_WILLNEED);
+#endif
+  }
+
+  ARRAY_FOREACH(ent, batch)
+  {
+    char *newpath = NULL;
+
+    log_debug2("nm: appending message, i=%d, id=%s, path=%s", m->msg_count,
+               notmuch_message_get_message_id(ent->msg), ent->path);
+
+    if (!ent->email)
+    {
+      ent->email = parse_message_file(ent->path, ent->fp, &newpath);
+      ent->fp = NULL;
+#ifdef USE_HCACHE
+      if (ent->email)
+      {
+        hcache_store_email(hc, newpath ? newpath : ent->path,
+                           mutt_str_len(newpath ? newpath : ent->path), ent->email, 0);
+      }
+#endif
+    }
+
+    if (ent->email)
+      append_email(m, ent->msg, ent->email, ent->path, newpath);
+
+    ent->email = NULL;
+    FREE(&newpath);
+  }
+}
+
+/**
+ * load_batch_clear - Release a batch of Notmuch messages
+ * @param batch Messages to release
+ */
+static void load_batch_clear(struct NmLoadArray *batch)
+{
+  struct NmLoadEntry *ent = NULL;
+  ARRAY_FOREACH(ent, batch)
+  {
+    email_free(&ent->email);
+    mutt_file_fclose(&ent->fp);
+    notmuch_message_destroy(ent->msg);
+  }
+  ARRAY_SHRINK(batch, ARRAY_SIZE(batch));
+}
+
 /**
  * read_mesgs_query - Search for matching messages
  * @param m     Mailbox
@@ -937,6 +1116,8 @@ static notmuch_messages_t *get_messages(notmuch_query_t *query)
  * @param dedup De-duplicate the results
  * @retval true  Success
  * @retval false Failure
+ *
+ * The results are loaded in batches, see load_batch().
  */
 static bool read_mesgs_query(struct Mailbox *m, notmuch_query_t *q, bool dedup)
 {
@@ -951,24 +1132,57 @@ static bool read_mesgs_query(struct Mailbox *m, notmuch_query_t *q, bool dedup)
   if (!msgs)
     return false;
 
+  bool rc = true;
+  struct NmLoadArray batch = ARRAY_HEAD_INITIALIZER;
+  ARRAY_RESERVE(&batch, NM_LOAD_BATCH);
+
   struct HeaderCache *hc = nm_hcache_open(m);
+  /* Ids of the messages in the batch, owned by the Notmuch messages */
+  GHashTable *pending = dedup ? g_hash_table_new(g_str_hash, g_str_equal) : NULL;
 
-  for (; notmuch_messages_valid(msgs) && ((limit == 0) || (m->msg_count < limit));
+  for (; notmuch_messages_valid(msgs) &&
+         ((limit == 0) || ((m->msg_count + ARRAY_SIZE(&batch)) < limit));
        notmuch_messages_move_to_next(msgs))
   {
     if (SigInt)
     {
-      nm_hcache_close(&hc);
       SigInt = false;
-      return false;
+      rc = false;
+      break;
     }
+
     notmuch_message_t *nm = notmuch_messages_get(msgs);
-    append_message(hc, m, nm, dedup);
-    notmuch_message_destroy(nm);
+    const char *path = NULL;
+    if (is_duplicate_message(m, nm, dedup, pending) || !(path = get_message_last_filename(nm)))
+    {
+      notmuch_message_destroy(nm);
+      continue;
+    }
+
+    struct NmLoadEntry ent = { nm, path, NULL, NULL };
+    ARRAY_ADD(&batch, ent);
+
+    const char *id = notmuch_message_get_message_id(nm);
+    if (pending && id)
+      g_hash_table_add(pending, (gpointer) id);
+
+    if (ARRAY_SIZE(&batch) >= NM_LOAD_BATCH)
+    {
+      load_batch(hc, m, &batch);
+      load_batch_clear(&batch);
+      if (pending)
+        g_hash_table_remove_all(pending);
+    }
   }
 
-  nm_hcache_close(&hc);
-  return true;
+  if (rc)
+    load_batch(hc, m, &batch);
+  load_batch_clear(&batch);
+  ARRAY_FREE(&batch);
+  if (pending)
+    g_hash_table_destroy(pending);
+
+  return rc;
 }
 
 /**
@@ -1025,7 +1239,6 @@ static bool read_threads_query(struct Mailbox *m, notmuch_query_t *q, bool dedup
   {
     if (SigInt)
     {
-      nm_hcache_close(&hc);
       SigInt = false;
       return false;
     }
@@ -1034,7 +1247,6 @@ static bool read_threads_query(struct Mailbox *m, notmuch_query_t *q, bool dedup
     notmuch_thread_destroy(thread);
   }
 
-  nm_hcache_close(&hc);
   return true;
 }
 
@@ -2188,8 +2400,6 @@ static enum MxStatus nm_mbox_check(struct Mailbox *m)
     notmuch_message_destroy(msg);
   }
 
-  nm_hcache_close(&hc);
-
   for (int i = 0; i < m->msg_count; i++)
   {
     struct Email *e = m->emails[i];
@@ -2343,7 +2553,7 @@ static enum MxStatus nm_mbox_sync(struct Mailbox *m)
     mdata->mtime.tv_nsec = 0;
   }
 
-  nm_hcache_close(&hc);
+  nm_hcache_flush(m);
 
   progress_free(&progress);
   FREE(&url);
@@ -2353,11 +2563,10 @@ static enum MxStatus nm_mbox_sync(struct Mailbox *m)
 
 /**
  * nm_mbox_close - Close a Mailbox - Implements MxOps::mbox_close() - @ingroup mx_mbox_close
- *
- * Nothing to do.
  */
 static enum MxStatus nm_mbox_close(struct Mailbox *m)
 {
+  nm_hcache_close(m);
   return MX_STATUS_OK;
 }
 
@@ -2493,6 +2702,7 @@ const struct MxOps MxNotmuchOps = {
   .msg_close        = nm_msg_close,
   .msg_padding_size = NULL,
   .msg_save_hcache  = NULL,
+  .mbox_hcache_gc   = NULL,
   .tags_edit        = nm_tags_edit,
   .tags_commit      = nm_tags_commit,
   .path_probe       = nm_path_probe,
@@ -881,7 +881,7 @@ static int format_line(struct MuttWindow *win, struct Line **lines, int line_num
     if (ch >= cnt)
       break;
 
-    k = mbrtowc(&wc, (char *) buf + ch, cnt - ch, &mbstate);
+    k = mutt_mb_mbrtowc(&wc, (char *) buf + ch, cnt - ch, &mbstate);
     if ((k == ICONV_BUF_TOO_SMALL) || (k == ICONV_ILLEGAL_SEQ))
     {
       if (k == ICONV_ILLEGAL_SEQ)
@@ -919,12 +919,12 @@ static int format_line(struct MuttWindow *win, struct Line **lines, int line_num
     {
       wchar_t wc1 = 0;
       mbstate_t mbstate1 = mbstate;
-      size_t k1 = mbrtowc(&wc1, (char *) buf + ch + k, cnt - ch - k, &mbstate1);
+      size_t k1 = mutt_mb_mbrtowc(&wc1, (char *) buf + ch + k, cnt - ch - k, &mbstate1);
       while ((k1 != ICONV_BUF_TOO_SMALL) && (k1 != ICONV_ILLEGAL_SEQ) &&
              (k1 > 0) && (wc1 == '\b'))
       {
-        const size_t k2 = mbrtowc(&wc1, (char *) buf + ch + k + k1,
-                                  cnt - ch - k - k1, &mbstate1);
+        const size_t k2 = mutt_mb_mbrtowc(&wc1, (char *) buf + ch + k + k1,
+                                                  cnt - ch - k - k1, &mbstate1);
         if ((k2 == ICONV_BUF_TOO_SMALL) || (k2 == ICONV_ILLEGAL_SEQ) ||
             (k2 == 0) || (!IsWPrint(wc1)))
         {
@@ -949,7 +949,7 @@ static int format_line(struct MuttWindow *win, struct Line **lines, int line_num
         ch += k + k1;
         k = k2;
         mbstate = mbstate1;
-        k1 = mbrtowc(&wc1, (char *) buf + ch + k, cnt - ch - k, &mbstate1);
+        k1 = mutt_mb_mbrtowc(&wc1, (char *) buf + ch + k, cnt - ch - k, &mbstate1);
       }
     }
 
@@ -967,7 +967,7 @@ static int format_line(struct MuttWindow *win, struct Line **lines, int line_num
       {
         space = ch;
       }
-      t = wcwidth(wc);
+      t = mutt_mb_char_width(wc);
       if (col + t > wrap_cols)
         break;
       col += t;
@@ -1031,8 +1031,8 @@ static int op_save(struct IndexSharedData *shared, struct PagerPrivateData *priv
     goto done;
   }
 
-  int bytes = mutt_file_copy_stream(priv->fp, fp_save);
-  if (bytes == -1)
+  const ssize_t bytes = mutt_file_copy_stream(priv->fp, fp_save);
+  if (bytes < 0)
   {
     log_perror("%s", buf_string(buf));
     goto done;
@@ -33,29 +33,17 @@
 #include "extract.h"
 
 /**
- * parse_rc_buffer - Parse a line of user config
- * @param line  config line to read
- * @param token scratch buffer to be used by parser
- * @param err   where to write error messages
+ * parse_rc_commands - Run the commands in the rest of a line
+ * @param line  Config line, read from line->dptr
+ * @param token Scratch buffer to be used by parser
+ * @param err   Where to write error messages
  * @retval #CommandResult Result e.g. #MUTT_CMD_SUCCESS
- *
- * The reason for `token` is to avoid having to allocate and deallocate a lot
- * of memory if we are parsing many lines.  the caller can pass in the memory
- * to use, which avoids having to create new space for every call to this function.
  */
-enum CommandResult parse_rc_buffer(struct Buffer *line, struct Buffer *token,
-                                   struct Buffer *err)
+static enum CommandResult parse_rc_commands(struct Buffer *line, struct Buffer *token,
+                                            struct Buffer *err)
 {
-  if (buf_is_empty(line))
-    return 0;
-
   enum CommandResult rc = MUTT_CMD_SUCCESS;
 
-  buf_reset(err);
-
-  /* Read from the beginning of line->data */
-  buf_seek(line, 0);
-
   SKIPWS(line->dptr);
   while (*line->dptr)
   {
@@ -95,6 +83,68 @@ finish:
   return rc;
 }
 
+/**
+ * parse_rc_buffer - Parse a line of user config
+ * @param line  config line to read
+ * @param token scratch buffer to be used by parser
+ * @param err   where to write error messages
+ * @retval #CommandResult Result e.g. #MUTT_CMD_SUCCESS
+ *
+ * The reason for `token` is to avoid having to allocate and deallocate a lot
+ * of memory if we are parsing many lines.  the caller can pass in the memory
+ * to use, which avoids having to create new space for every call to this function.
+ */
+enum CommandResult parse_rc_buffer(struct Buffer *line, struct Buffer *token,
+                                   struct Buffer *err)
+{
+  if (buf_is_empty(line))
+    return 0;
+
+  buf_reset(err);
+
+  /* Read from the beginning of line->data */
+  buf_seek(line, 0);
+
+  return parse_rc_commands(line, token, err);
+}
+
+/**
+ * parse_rc_command - Run a Command that has already been looked up
+ * @param cmd  Command to run
+ * @param args Arguments of the Command, optionally followed by more commands
+ * @param err  Where to write error messages
+ * @retval #CommandResult Result e.g. #MUTT_CMD_SUCCESS
+ *
+ * This is equivalent to parse_rc_line() of the Command's name and `args`, but
+ * it skips the search for the Command.
+ */
+enum CommandResult parse_rc_command(const struct Command *cmd, const char *args,
+                                    struct Buffer *err)
+{
+  if (!cmd || !cmd->parse)
+    return MUTT_CMD_ERROR;
+
+  struct Buffer *line = buf_pool_get();
+  struct Buffer *token = buf_pool_get();
+
+  buf_strcpy(line, NONULL(args));
+  buf_seek(line, 0);
+  buf_strcpy(token, cmd->name);
+  buf_reset(err);
+
+  log_debug1("NT_COMMAND: %s", cmd->name);
+  enum CommandResult rc = cmd->parse(token, line, cmd->data, err);
+  if ((rc != MUTT_CMD_WARNING) && (rc != MUTT_CMD_ERROR) && (rc != MUTT_CMD_FINISH))
+  {
+    notify_send(SpaceMutt->notify, NT_COMMAND, 0, (void *) cmd);
+    rc = parse_rc_commands(line, token, err);
+  }
+
+  buf_pool_release(&line);
+  buf_pool_release(&token);
+  return rc;
+}
+
 /**
  * parse_rc_line - Parse a line of user config
  * @param line Config line to read
@@ -95,9 +95,8 @@ static bool eat_regex(struct Pattern *pat, PatternCompFlags flags,
   else
   {
     pat->p.regex = g_new0(regex_t, 1);
-#ifdef USE_DEBUG_GRAPHVIZ
     pat->raw_pattern = mutt_str_dup(buf->data);
-#endif
+    pat->literal = mutt_regex_literal(buf->data);
     uint16_t case_flags = mutt_mb_is_lower(buf->data) ? REG_ICASE : 0;
     int rc2 = REG_COMP(pat->p.regex, buf->data, REG_NEWLINE | REG_NOSUB | case_flags);
     if (rc2 != 0)
@@ -803,9 +802,8 @@ void mutt_patternlist_free_full(PatternList *pat)
       FREE(&p->p.regex);
     }
 
-#ifdef USE_DEBUG_GRAPHVIZ
+    FREE(&p->literal);
     FREE(&p->raw_pattern);
-#endif
     mutt_patternlist_free_full(g_steal_pointer(&p->child));
     FREE(&p);
   }
@@ -52,6 +52,7 @@
 #include "send/lib.h"
 #include "copy.h"
 #include "handler.h"
+#include "imap/lib.h"
 #include "maillist.h"
 #include "mx.h"
 #include "mutt/gslist.h"
@@ -770,21 +771,32 @@ static int msg_search_sendmode(struct Email *e, struct Pattern *pat)
 
 /**
  * pattern_needs_msg - Check whether a pattern needs a full message
- * @param m Mailbox
+ * @param m   Mailbox
  * @param pat Pattern
+ * @param e   Email
  * @retval true The pattern needs a full message
  * @retval false The pattern does not need a full message
  */
-static bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat)
+static bool pattern_needs_msg(struct Mailbox *m, const struct Pattern *pat, struct Email *e)
 {
-  if ((pat->op == MUTT_PAT_MIMETYPE) || (pat->op == MUTT_PAT_MIMEATTACH))
+  if (pat->op == MUTT_PAT_MIMETYPE)
   {
     return true;
   }
 
+  if (pat->op == MUTT_PAT_MIMEATTACH)
+  {
+    return mutt_count_needs_message(e);
+  }
+
   if ((pat->op == MUTT_PAT_WHOLE_MSG) || (pat->op == MUTT_PAT_BODY) || (pat->op == MUTT_PAT_HEADER))
   {
-    return !((m->type == MUTT_IMAP) && pat->string_match);
+    if (m->type != MUTT_IMAP)
+      return true;
+    /* The server's result may be enough, see imap_search_match() */
+    if (pat->server)
+      return imap_search_match(m, pat, e) < 0;
+    return !pat->string_match;
   }
 
   if ((pat->op == MUTT_PAT_AND) || (pat->op == MUTT_PAT_OR))
@@ -792,7 +804,7 @@ static bool pattern_needs_msg(const struct Mailbox *m, const struct Pattern *pat
     for (GSList *np = pat->child; np != NULL; np = np->next)
     {
       struct Pattern *p = np->data;
-      if (pattern_needs_msg(m, p))
+      if (pattern_needs_msg(m, p, e))
       {
         return true;
       }
@@ -881,15 +893,25 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
        * This is also the case when message scoring.  */
       if (!m)
         return false;
-      /* IMAP search sets e->matched at search compile time */
-      if ((m->type == MUTT_IMAP) && pat->string_match)
-        return e->matched;
+      if (m->type == MUTT_IMAP)
+      {
+        /* imap_search() may already have the answer */
+        const int rc = imap_search_match(m, pat, e);
+        if (rc >= 0)
+          return pat->pat_not ^ (rc == 1);
+        /* Without a search, e->matched is the best we have */
+        if (pat->string_match && !pat->server)
+          return e->matched;
+      }
       return pat->pat_not ^ msg_search(pat, e, msg);
     case MUTT_PAT_SERVERSEARCH:
       if (!m)
         return false;
       if (m->type == MUTT_IMAP)
       {
+        const int rc = imap_search_match(m, pat, e);
+        if (rc >= 0)
+          return pat->pat_not ^ (rc == 1);
         return (pat->string_match) ? e->matched : false;
       }
       log_fault(_("error: server custom search only supported with IMAP"));
@@ -1092,7 +1114,7 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
       if (!m)
         return false;
       {
-        int count = mutt_count_body_parts(m, e, msg->fp);
+        int count = mutt_count_body_parts(m, e, msg ? msg->fp : NULL);
         return pat->pat_not ^ (count >= pat->min &&
                                (pat->max == MUTT_MAXRANGE || count <= pat->max));
       }
@@ -1130,7 +1152,7 @@ static bool pattern_exec(struct Pattern *pat, PatternExecFlags flags,
 bool mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags,
                        struct Mailbox *m, struct Email *e, struct PatternCache *cache)
 {
-  const bool needs_msg = pattern_needs_msg(m, pat);
+  const bool needs_msg = pattern_needs_msg(m, pat, e);
   struct Message *msg = needs_msg ? mx_msg_open(m, e) : NULL;
   if (needs_msg && !msg)
   {
@@ -1141,6 +1163,221 @@ bool mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags,
   return matched;
 }
 
+/**
+ * mutt_pattern_deps - What does a pattern depend on?
+ * @param pat Pattern to test
+ * @retval num Flags, e.g. #MUTT_PAT_DEP_FLAGS
+ *
+ * The result of a pattern that only depends on the Email's headers,
+ * #MUTT_PAT_DEP_NONE, won't change.  Otherwise it may change when one of the
+ * things it depends on does.
+ */
+PatternDeps mutt_pattern_deps(const PatternList *pat)
+{
+  PatternDeps deps = MUTT_PAT_DEP_NONE;
+
+  for (const GSList *np = pat; np; np = np->next)
+  {
+    const struct Pattern *p = np->data;
+    switch (p->op)
+    {
+      case MUTT_PAT_THREAD:
+      case MUTT_PAT_PARENT:
+      case MUTT_PAT_CHILDREN:
+      case MUTT_PAT_COLLAPSED:
+      case MUTT_PAT_DUPLICATED:
+      case MUTT_PAT_UNREFERENCED:
+      case MUTT_PAT_BROKEN:
+        deps |= MUTT_PAT_DEP_THREAD;
+        break;
+      case MUTT_EXPIRED:
+      case MUTT_SUPERSEDED:
+      case MUTT_FLAG:
+      case MUTT_TAG:
+      case MUTT_NEW:
+      case MUTT_UNREAD:
+      case MUTT_REPLIED:
+      case MUTT_OLD:
+      case MUTT_READ:
+      case MUTT_DELETED:
+        deps |= MUTT_PAT_DEP_FLAGS;
+        break;
+      case MUTT_PAT_CRYPT_SIGN:
+      case MUTT_PAT_CRYPT_VERIFIED:
+      case MUTT_PAT_CRYPT_ENCRYPT:
+      case MUTT_PAT_PGP_KEY:
+        deps |= MUTT_PAT_DEP_CRYPT;
+        break;
+      case MUTT_PAT_XLABEL:
+      case MUTT_PAT_DRIVER_TAGS:
+        deps |= MUTT_PAT_DEP_LABELS;
+        break;
+      case MUTT_PAT_SCORE:
+        deps |= MUTT_PAT_DEP_SCORE;
+        break;
+      case MUTT_PAT_MESSAGE:
+        deps |= MUTT_PAT_DEP_MSGNO;
+        break;
+      case MUTT_PAT_BODY:
+      case MUTT_PAT_HEADER:
+      case MUTT_PAT_WHOLE_MSG:
+      case MUTT_PAT_MIMETYPE:
+        deps |= MUTT_PAT_DEP_MESSAGE;
+        break;
+      case MUTT_PAT_MIMEATTACH:
+        /* The count depends on the 'attachments' command */
+        deps |= MUTT_PAT_DEP_MESSAGE | MUTT_PAT_DEP_CONFIG;
+        break;
+      case MUTT_PAT_LIST:
+      case MUTT_PAT_SUBSCRIBED_LIST:
+      case MUTT_PAT_PERSONAL_RECIP:
+      case MUTT_PAT_PERSONAL_FROM:
+        deps |= MUTT_PAT_DEP_CONFIG;
+        break;
+      case MUTT_PAT_ID_EXTERNAL:
+      case MUTT_PAT_SERVERSEARCH:
+        deps |= MUTT_PAT_DEP_SEARCH;
+        break;
+      case MUTT_PAT_DATE:
+      case MUTT_PAT_DATE_RECEIVED:
+        /* Otherwise, a relative range was fixed when it was compiled */
+        if (p->dynamic)
+          deps |= MUTT_PAT_DEP_TIME;
+        else
+          deps |= MUTT_PAT_DEP_CONFIG;
+        break;
+      default:
+        break;
+    }
+
+    /* Groups and aliases can be changed by commands */
+    if (p->group_match || p->is_alias)
+      deps |= MUTT_PAT_DEP_CONFIG;
+
+    deps |= mutt_pattern_deps(p->child);
+  }
+
+  return deps;
+}
+
+/**
+ * mutt_pattern_is_hot - Can a pattern be matched using only the packed view data?
+ * @param pat Pattern to test
+ * @retval true Every operator is a flag, date, score or size test
+ *
+ * If so, the pattern can be matched with mutt_pattern_exec_hot(), which
+ * doesn't need to look at the Email at all.
+ */
+bool mutt_pattern_is_hot(const PatternList *pat)
+{
+  if (!pat)
+    return false;
+
+  for (const GSList *np = pat; np; np = np->next)
+  {
+    const struct Pattern *p = np->data;
+    switch (p->op)
+    {
+      case MUTT_PAT_AND:
+      case MUTT_PAT_OR:
+        if (!mutt_pattern_is_hot(p->child))
+          return false;
+        break;
+      case MUTT_ALL:
+      case MUTT_EXPIRED:
+      case MUTT_SUPERSEDED:
+      case MUTT_FLAG:
+      case MUTT_TAG:
+      case MUTT_NEW:
+      case MUTT_UNREAD:
+      case MUTT_REPLIED:
+      case MUTT_OLD:
+      case MUTT_READ:
+      case MUTT_DELETED:
+      case MUTT_PAT_DATE:
+      case MUTT_PAT_DATE_RECEIVED:
+      case MUTT_PAT_SCORE:
+      case MUTT_PAT_SIZE:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * mutt_pattern_exec_hot - Match a pattern against the packed view data
+ * @param pat Pattern to match, see mutt_pattern_is_hot()
+ * @param hot Packed view data of the Mailbox
+ * @param idx Position of the Email in Mailbox.emails
+ * @retval true Pattern matched
+ *
+ * This gives the same answer as mutt_pattern_exec() for the operators allowed
+ * by mutt_pattern_is_hot().
+ */
+bool mutt_pattern_exec_hot(struct Pattern *pat, const struct MailboxHot *hot, int idx)
+{
+  const EmailHotFlags flags = hot->flags[idx];
+  const bool read = (flags & EMAIL_HOT_READ);
+  const bool old = (flags & EMAIL_HOT_OLD);
+
+  switch (pat->op)
+  {
+    case MUTT_PAT_AND:
+      for (GSList *np = pat->child; np; np = np->next)
+        if (!mutt_pattern_exec_hot(np->data, hot, idx))
+          return pat->pat_not;
+      return !pat->pat_not;
+    case MUTT_PAT_OR:
+      for (GSList *np = pat->child; np; np = np->next)
+        if (mutt_pattern_exec_hot(np->data, hot, idx))
+          return !pat->pat_not;
+      return pat->pat_not;
+    case MUTT_ALL:
+      return !pat->pat_not;
+    case MUTT_EXPIRED:
+      return pat->pat_not ^ ((flags & EMAIL_HOT_EXPIRED) != 0);
+    case MUTT_SUPERSEDED:
+      return pat->pat_not ^ ((flags & EMAIL_HOT_SUPERSEDED) != 0);
+    case MUTT_FLAG:
+      return pat->pat_not ^ ((flags & EMAIL_HOT_FLAGGED) != 0);
+    case MUTT_TAG:
+      return pat->pat_not ^ ((flags & EMAIL_HOT_TAGGED) != 0);
+    case MUTT_NEW:
+      return pat->pat_not ? old || read : !(old || read);
+    case MUTT_UNREAD:
+      return pat->pat_not ? read : !read;
+    case MUTT_REPLIED:
+      return pat->pat_not ^ ((flags & EMAIL_HOT_REPLIED) != 0);
+    case MUTT_OLD:
+      return pat->pat_not ? (!old || read) : (old && !read);
+    case MUTT_READ:
+      return pat->pat_not ^ read;
+    case MUTT_DELETED:
+      return pat->pat_not ^ ((flags & EMAIL_HOT_DELETED) != 0);
+    case MUTT_PAT_DATE:
+      if (pat->dynamic)
+        match_update_dynamic_date(pat);
+      return pat->pat_not ^
+             ((hot->date_sent[idx] >= pat->min) && (hot->date_sent[idx] <= pat->max));
+    case MUTT_PAT_DATE_RECEIVED:
+      if (pat->dynamic)
+        match_update_dynamic_date(pat);
+      return pat->pat_not ^
+             ((hot->received[idx] >= pat->min) && (hot->received[idx] <= pat->max));
+    case MUTT_PAT_SCORE:
+      return pat->pat_not ^ (hot->score[idx] >= pat->min &&
+                             (pat->max == MUTT_MAXRANGE || hot->score[idx] <= pat->max));
+    case MUTT_PAT_SIZE:
+      return pat->pat_not ^ (hot->size[idx] >= pat->min &&
+                             (pat->max == MUTT_MAXRANGE || hot->size[idx] <= pat->max));
+  }
+
+  return false;
+}
+
 /**
  * mutt_pattern_alias_exec - Match a pattern against an alias
  * @param pat   Pattern to match
@@ -58,6 +58,7 @@ struct AliasView;
 struct Email;
 struct Envelope;
 struct Mailbox;
+struct MailboxHot;
 struct MailboxView;
 struct Menu;
 
@@ -87,6 +88,7 @@ struct Pattern
   bool dynamic      : 1;         ///< Evaluate date ranges at run time
   bool sendmode     : 1;         ///< Evaluate searches in send-mode
   bool is_multi     : 1;         ///< Multiple case (only for ~I pattern now)
+  bool server       : 1;         ///< Has results from a server-side search, see imap_search()
   long min;                      ///< Minimum for range checks
   long max;                      ///< Maximum for range checks
   PatternList *child;            ///< Arguments to logical operation
@@ -96,12 +98,24 @@ struct Pattern
     char *str;                   ///< String, if string_match is set
     GSList *multi_cases;         ///< Multiple strings for ~I pattern
   } p;
-#ifdef USE_DEBUG_GRAPHVIZ
-  const char *raw_pattern;
-#endif
+  char *literal;                 ///< Text that every match of the regex contains (optional)
+  const char *raw_pattern;       ///< Source of the regex, if there is one
 };
 
 
+typedef uint16_t PatternDeps;              ///< Flags for mutt_pattern_deps(), e.g. #MUTT_PAT_DEP_FLAGS
+#define MUTT_PAT_DEP_NONE               0   ///< Only depends on the Email's headers
+#define MUTT_PAT_DEP_FLAGS        (1 << 0)  ///< Email's flags, e.g. read, tagged
+#define MUTT_PAT_DEP_CRYPT        (1 << 1)  ///< Email's security, e.g. signed
+#define MUTT_PAT_DEP_LABELS       (1 << 2)  ///< Email's label or driver tags
+#define MUTT_PAT_DEP_SCORE        (1 << 3)  ///< Email's score
+#define MUTT_PAT_DEP_THREAD       (1 << 4)  ///< Email's place in its thread
+#define MUTT_PAT_DEP_MSGNO        (1 << 5)  ///< Email's position in the Mailbox
+#define MUTT_PAT_DEP_MESSAGE      (1 << 6)  ///< Body or raw text of the message
+#define MUTT_PAT_DEP_CONFIG       (1 << 7)  ///< Session state, e.g. alternates, groups, a date range fixed when compiled
+#define MUTT_PAT_DEP_SEARCH       (1 << 8)  ///< Results of an external or server-side search
+#define MUTT_PAT_DEP_TIME         (1 << 9)  ///< Current time, e.g. `~d<1d` in a dynamic pattern
+
 typedef uint8_t PatternExecFlags;         ///< Flags for mutt_pattern_exec(), e.g. #MUTT_MATCH_FULL_ADDRESS
 #define MUTT_PAT_EXEC_NO_FLAGS         0  ///< No flags are set
 #define MUTT_MATCH_FULL_ADDRESS  (1 << 0) ///< Match the full address
@@ -185,6 +199,9 @@ bool mutt_pattern_exec(struct Pattern *pat, PatternExecFlags flags, struct Mailb
                        struct Email *e, struct PatternCache *cache);
 bool mutt_pattern_alias_exec(struct Pattern *pat, PatternExecFlags flags,
                              struct AliasView *av, struct PatternCache *cache);
+PatternDeps mutt_pattern_deps(const PatternList *pat);
+bool mutt_pattern_is_hot(const PatternList *pat);
+bool mutt_pattern_exec_hot(struct Pattern *pat, const struct MailboxHot *hot, int idx);
 
 PatternList *mutt_pattern_comp(struct MailboxView *mv, struct Menu *menu, const char *s, PatternCompFlags flags, struct Buffer *err);
 void mutt_check_simple(struct Buffer *s, const char *simple);
@@ -330,6 +330,9 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
   progress = progress_new(MUTT_PROGRESS_READ, (op == MUTT_LIMIT) ? m->msg_count : m->vcount);
   progress_set_message(progress, _("Executing command on matching messages..."));
 
+  /* Flag, date, score and size patterns can be matched from the packed data */
+  const bool hot = mutt_pattern_is_hot(pat);
+
   if (op == MUTT_LIMIT)
   {
     m->vcount = 0;
@@ -356,16 +359,18 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
       e->limit_visited = true;
       e->collapsed = false;
       e->num_hidden = 0;
+      hot_set(&m->hot, i, e);
 
-      if (match_all ||
-          mutt_pattern_exec(pat->data, MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
+      if (match_all || (hot && mutt_pattern_exec_hot(pat->data, &m->hot, i)) ||
+          (!hot && mutt_pattern_exec(pat->data, MUTT_MATCH_FULL_ADDRESS, m, e, NULL)))
       {
         e->vnum = m->vcount;
         e->visible = true;
+        m->hot.vnum[i] = e->vnum;
+        m->hot.flags[i] |= EMAIL_HOT_VISIBLE;
         m->v2r[m->vcount] = i;
         m->vcount++;
-        struct Body *b = e->body;
-        mv->vsize += b->length + b->offset - b->hdr_offset + padding;
+        mv->vsize += m->hot.size[i] + m->hot.hdr_size[i] + padding;
       }
     }
   }
@@ -373,6 +378,10 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
   {
     for (int i = 0; i < m->vcount; i++)
     {
+      /* Skip the non-matching Emails without touching them */
+      if (hot && !mutt_pattern_exec_hot(pat->data, &m->hot, m->v2r[i]))
+        continue;
+
       struct Email *e = mutt_get_virt_email(m, i);
       if (!e)
         continue;
@@ -384,7 +393,7 @@ int mutt_pattern_func(struct MailboxView *mv, int op, char *prompt)
         break;
       }
       progress_update(progress, i, -1);
-      if (mutt_pattern_exec(pat->data, MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
+      if (hot || mutt_pattern_exec(pat->data, MUTT_MATCH_FULL_ADDRESS, m, e, NULL))
       {
         switch (op)
         {
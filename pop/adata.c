@@ -30,6 +30,9 @@
 #include "core/lib.h"
 #include "conn/lib.h"
 #include "adata.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#endif
 
 /**
  * pop_adata_free - Free the private Account data - Implements Account::adata_free() - @ingroup account_adata_free
@@ -45,6 +48,9 @@ void pop_adata_free(void **ptr)
 
   struct PopAccountData *adata = *ptr;
   FREE(&adata->auth_list.data);
+#ifdef USE_HCACHE
+  hcache_close(&adata->hcache);
+#endif
 
   if (adata->conn)
   {
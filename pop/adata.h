@@ -28,6 +28,7 @@
 #include "private.h"
 #include "mutt/lib.h"
 
+struct HeaderCache;
 struct Mailbox;
 
 /**
@@ -53,6 +54,7 @@ struct PopAccountData
   struct Buffer auth_list; ///< list of auth mechanisms
   char *timestamp;
   struct BodyCache *bcache; ///< body cache
+  struct HeaderCache *hcache; ///< Header cache, open while the Mailbox is
   char err_msg[POP_CMD_RESPONSE];
   struct PopCache cache[POP_CACHE_LEN];
 };
@@ -292,24 +292,41 @@ static void pop_hcache_namer(const char *path, struct Buffer *dest)
 }
 
 /**
- * pop_hcache_open - Open the header cache
+ * pop_hcache_open - Get the header cache
  * @param adata POP Account data
  * @param path  Path to the mailbox
- * @retval ptr Header cache
+ * @retval ptr Header cache, owned by the Account
+ *
+ * The header cache is opened on first use and stays open until the Mailbox is
+ * closed.  Its writes are batched.
  */
 static struct HeaderCache *pop_hcache_open(struct PopAccountData *adata, const char *path)
 {
+  if (!adata)
+    return NULL;
+  if (adata->hcache)
+    return adata->hcache;
+
   const char *const c_header_cache = cs_subset_path(SpaceMutt->sub, "header_cache");
-  if (!adata || !adata->conn)
-    return hcache_open(c_header_cache, path, NULL, true);
+  if (adata->conn)
+  {
+    struct Url url = { 0 };
+    char p[1024] = { 0 };
 
-  struct Url url = { 0 };
-  char p[1024] = { 0 };
+    mutt_account_tourl(&adata->conn->account, &url);
+    url.path = HC_FNAME;
+    url_tostring(&url, p, sizeof(p), U_PATH);
+    adata->hcache = hcache_open(c_header_cache, p, pop_hcache_namer, true);
+  }
+  else
+  {
+    adata->hcache = hcache_open(c_header_cache, path, NULL, true);
+  }
+
+  if (adata->hcache)
+    adata->hcache->batch = true;
 
-  mutt_account_tourl(&adata->conn->account, &url);
-  url.path = HC_FNAME;
-  url_tostring(&url, p, sizeof(p), U_PATH);
-  return hcache_open(c_header_cache, p, pop_hcache_namer, true);
+  return adata->hcache;
 }
 #endif
 
@@ -381,6 +398,7 @@ static int pop_fetch_headers(struct Mailbox *m)
       if (edata->refno == -1)
       {
         m->emails[i]->deleted = true;
+        mailbox_hot_update(m, m->emails[i]);
         deleted++;
       }
     }
@@ -464,10 +482,6 @@ static int pop_fetch_headers(struct Mailbox *m)
   }
   progress_free(&progress);
 
-#ifdef USE_HCACHE
-  hcache_close(&hc);
-#endif
-
   if (rc < 0)
   {
     for (int i = m->msg_count; i < new_count; i++)
@@ -919,7 +933,7 @@ static enum MxStatus pop_mbox_sync(struct Mailbox *m)
     progress_free(&progress);
 
 #ifdef USE_HCACHE
-    hcache_close(&hc);
+    hcache_flush(hc);
 #endif
 
     if (rc == 0)
@@ -966,6 +980,9 @@ static enum MxStatus pop_mbox_close(struct Mailbox *m)
   pop_clear_cache(adata);
 
   mutt_bcache_close(&adata->bcache);
+#ifdef USE_HCACHE
+  hcache_close(&adata->hcache);
+#endif
 
   return MX_STATUS_OK;
 }
@@ -1145,12 +1162,38 @@ static int pop_msg_save_hcache(struct Mailbox *m, struct Email *e)
   struct PopEmailData *edata = e->edata;
   struct HeaderCache *hc = pop_hcache_open(adata, mailbox_path(m));
   rc = hcache_store_email(hc, edata->uid, strlen(edata->uid), e, 0);
-  hcache_close(&hc);
 #endif
 
   return rc;
 }
 
+/**
+ * pop_mbox_hcache_gc - Remove stale entries from the header cache - Implements MxOps::mbox_hcache_gc() - @ingroup mx_mbox_hcache_gc
+ */
+static int pop_mbox_hcache_gc(struct Mailbox *m, bool force)
+{
+  int rc = -1;
+#ifdef USE_HCACHE
+  struct PopAccountData *adata = pop_adata_get(m);
+  struct HeaderCache *hc = pop_hcache_open(adata, mailbox_path(m));
+  if (!hc || (!force && !hcache_gc_due(hc)))
+    return -1;
+
+  struct HashTable *live = mutt_hash_new(MAX(m->msg_count, 32), MUTT_HASH_NO_FLAGS);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    struct PopEmailData *edata = e ? e->edata : NULL;
+    if (edata && edata->uid)
+      mutt_hash_insert(live, edata->uid, e);
+  }
+
+  rc = hcache_gc(hc, live, NULL);
+  mutt_hash_free(&live);
+#endif
+  return rc;
+}
+
 /**
  * pop_path_probe - Is this a POP Mailbox? - Implements MxOps::path_probe() - @ingroup mx_path_probe
  */
@@ -1195,6 +1238,7 @@ const struct MxOps MxPopOps = {
   .msg_close        = pop_msg_close,
   .msg_padding_size = NULL,
   .msg_save_hcache  = pop_msg_save_hcache,
+  .mbox_hcache_gc   = pop_mbox_hcache_gc,
   .tags_edit        = NULL,
   .tags_commit      = NULL,
   .path_probe       = pop_path_probe,
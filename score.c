@@ -27,11 +27,22 @@
  * @page neo_score Routines for adding user scores to emails
  *
  * Routines for adding user scores to emails
+ *
+ * The score rules are compiled into a ScoreProgram.  Identical
+ * sub-expressions of different rules share a node, so they're only matched
+ * once per Email.
+ *
+ * Each Email remembers which rules its score was calculated with, and a hash
+ * of the fields that the rules depend on, e.g. its flags.  If neither has
+ * changed, the Email isn't matched again.  The score is stored in the header
+ * cache, so reopening a Mailbox doesn't need to score it again.
  */
 
 #include "config.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "mutt/lib.h"
 #include "config/lib.h"
 #include "email/lib.h"
@@ -43,6 +54,7 @@
 #include "pattern/lib.h"
 #include "globals.h"
 #include "mutt_thread.h"
+#include "mx.h"
 #include "protos.h"
 
 /**
@@ -54,12 +66,282 @@ struct Score
   PatternList *pat;
   int val;
   bool exact;         ///< If this rule matches, don't evaluate any more
+  PatternDeps deps;   ///< What the pattern depends on, see mutt_pattern_deps()
   struct Score *next; ///< Linked list
 };
 
+ARRAY_HEAD(ScoreNodeIdArray, int);
+
+/**
+ * struct ScoreNode - A distinct sub-expression of the score rules
+ */
+struct ScoreNode
+{
+  struct Pattern *pat;             ///< Pattern, owned by a Score rule
+  struct ScoreNodeIdArray children; ///< Nodes of the operands of an AND or OR
+  bool memo;                       ///< The result is the same for all the rules
+};
+ARRAY_HEAD(ScoreNodeArray, struct ScoreNode);
+
+/**
+ * struct ScoreProgram - The score rules, compiled for matching
+ */
+struct ScoreProgram
+{
+  struct ScoreNodeArray nodes;    ///< Distinct sub-expressions of the rules
+  struct ScoreNodeIdArray rules;  ///< Node of each rule's pattern, in order
+  signed char *results;           ///< Results for the current Email: 1 match, -1 no match, 0 unknown
+  PatternDeps deps;               ///< What the rules depend on
+  uint32_t key;                   ///< Identifies the rules, 0 if a score can't be reused
+};
+
+/// Rules whose results can change without the Email changing
+#define SCORE_DEPS_VOLATILE (MUTT_PAT_DEP_THREAD | MUTT_PAT_DEP_MSGNO | \
+                             MUTT_PAT_DEP_SEARCH | MUTT_PAT_DEP_TIME)
+
 /// Linked list of email scoring rules
 static struct Score *ScoreList = NULL;
 
+/// Compiled score rules, NULL if they need compiling
+static struct ScoreProgram *ScoreProg = NULL;
+
+/// Random value, so rules that depend on the config aren't reused by another session
+static uint32_t ScoreSalt = 0;
+
+/**
+ * score_program_free - Free the compiled score rules
+ */
+static void score_program_free(void)
+{
+  if (!ScoreProg)
+    return;
+
+  struct ScoreNode *sn = NULL;
+  ARRAY_FOREACH(sn, &ScoreProg->nodes)
+  {
+    ARRAY_FREE(&sn->children);
+  }
+  ARRAY_FREE(&ScoreProg->nodes);
+  ARRAY_FREE(&ScoreProg->rules);
+  FREE(&ScoreProg->results);
+  FREE(&ScoreProg);
+}
+
+/**
+ * score_signature - Describe a Pattern, so identical ones can be found
+ * @param pat Pattern
+ * @param buf Buffer for the result
+ */
+static void score_signature(const struct Pattern *pat, struct Buffer *buf)
+{
+  buf_add_printf(buf, "%d:%d%d%d%d%d%d%d%d:%ld:%ld", pat->op, pat->pat_not,
+                 pat->all_addr, pat->string_match, pat->group_match,
+                 pat->ign_case, pat->is_alias, pat->sendmode, pat->dynamic,
+                 pat->min, pat->max);
+
+  if (pat->is_multi || pat->group_match)
+    buf_add_printf(buf, ":p%p", (void *) pat->p.group);
+  else if (pat->string_match || pat->dynamic)
+    buf_add_printf(buf, ":s%zu:%s", strlen(pat->p.str), pat->p.str);
+  else if (pat->raw_pattern)
+    buf_add_printf(buf, ":r%zu:%s", strlen(pat->raw_pattern), pat->raw_pattern);
+
+  buf_addch(buf, '(');
+  for (const GSList *np = pat->child; np; np = np->next)
+  {
+    score_signature(np->data, buf);
+    buf_addch(buf, ',');
+  }
+  buf_addch(buf, ')');
+}
+
+/**
+ * score_node_add - Add a Pattern to the compiled rules
+ * @param prog  Compiled rules
+ * @param index Signatures of the existing nodes
+ * @param pat   Pattern to add
+ * @retval num Node of the Pattern
+ *
+ * If an identical Pattern has already been added, its node is reused.
+ */
+static int score_node_add(struct ScoreProgram *prog, GHashTable *index, struct Pattern *pat)
+{
+  struct Buffer *sig = buf_pool_get();
+  score_signature(pat, sig);
+
+  int idx = 0;
+  gpointer found = NULL;
+  if (g_hash_table_lookup_extended(index, buf_string(sig), NULL, &found))
+  {
+    idx = GPOINTER_TO_INT(found);
+  }
+  else
+  {
+    struct ScoreNode sn = { 0 };
+    sn.pat = pat;
+
+    /* A running score is different for each rule */
+    GSList one = { pat, NULL };
+    sn.memo = !(mutt_pattern_deps(&one) & MUTT_PAT_DEP_SCORE);
+
+    if ((pat->op == MUTT_PAT_AND) || (pat->op == MUTT_PAT_OR))
+    {
+      for (GSList *np = pat->child; np; np = np->next)
+        ARRAY_ADD(&sn.children, score_node_add(prog, index, np->data));
+    }
+
+    ARRAY_ADD(&prog->nodes, sn);
+    idx = ARRAY_SIZE(&prog->nodes) - 1;
+    g_hash_table_insert(index, buf_strdup(sig), GINT_TO_POINTER(idx));
+  }
+
+  buf_pool_release(&sig);
+  return idx;
+}
+
+/**
+ * score_program_get - Get the compiled score rules
+ * @retval ptr Compiled rules
+ */
+static struct ScoreProgram *score_program_get(void)
+{
+  if (ScoreProg)
+    return ScoreProg;
+
+  struct ScoreProgram *prog = g_new0(struct ScoreProgram, 1);
+  GHashTable *index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  GChecksum *checksum = g_checksum_new(G_CHECKSUM_MD5);
+  char num[32] = { 0 };
+
+  for (struct Score *sc = ScoreList; sc; sc = sc->next)
+  {
+    ARRAY_ADD(&prog->rules, score_node_add(prog, index, sc->pat->data));
+    prog->deps |= sc->deps;
+
+    snprintf(num, sizeof(num), "\n%s%d\n", sc->exact ? "=" : "", sc->val);
+    g_checksum_update(checksum, (const guchar *) sc->str, -1);
+    g_checksum_update(checksum, (const guchar *) num, -1);
+  }
+
+  prog->results = g_new0(signed char, ARRAY_SIZE(&prog->nodes) + 1);
+
+  if (!(prog->deps & SCORE_DEPS_VOLATILE))
+  {
+    guint8 digest[16] = { 0 };
+    gsize digest_len = sizeof(digest);
+    g_checksum_get_digest(checksum, digest, &digest_len);
+    memcpy(&prog->key, digest, sizeof(prog->key));
+
+    if (prog->deps & MUTT_PAT_DEP_CONFIG)
+    {
+      if (ScoreSalt == 0)
+        ScoreSalt = (uint32_t) mutt_rand64() | 1;
+      prog->key ^= ScoreSalt;
+    }
+
+    if (prog->key == 0)
+      prog->key = 1;
+  }
+
+  g_checksum_free(checksum);
+  g_hash_table_destroy(index);
+
+  log_debug2("compiled %zu score rules into %zu nodes, key %08x",
+             ARRAY_SIZE(&prog->rules), ARRAY_SIZE(&prog->nodes), prog->key);
+
+  ScoreProg = prog;
+  return prog;
+}
+
+/**
+ * mutt_score_nodes - Count the distinct sub-expressions of the score rules
+ * @retval num Number of nodes of the compiled rules
+ */
+size_t mutt_score_nodes(void)
+{
+  return ARRAY_SIZE(&score_program_get()->nodes);
+}
+
+/**
+ * score_node_match - Does a node of the compiled rules match an Email?
+ * @param prog  Compiled rules
+ * @param idx   Node to match
+ * @param e     Email
+ * @param cache Cache for the pattern functions
+ * @retval true The node matches
+ */
+static bool score_node_match(struct ScoreProgram *prog, int idx, struct Email *e,
+                             struct PatternCache *cache)
+{
+  if (prog->results[idx] != 0)
+    return (prog->results[idx] > 0);
+
+  struct ScoreNode *sn = ARRAY_GET(&prog->nodes, idx);
+  bool match = false;
+
+  if ((sn->pat->op == MUTT_PAT_AND) || (sn->pat->op == MUTT_PAT_OR))
+  {
+    /* AND stops at the first mismatch, OR at the first match */
+    const bool all = (sn->pat->op == MUTT_PAT_AND);
+    match = all;
+
+    int *child = NULL;
+    ARRAY_FOREACH(child, &sn->children)
+    {
+      if (score_node_match(prog, *child, e, cache) != all)
+      {
+        match = !all;
+        break;
+      }
+    }
+    match ^= sn->pat->pat_not;
+  }
+  else
+  {
+    match = mutt_pattern_exec(sn->pat, MUTT_MATCH_FULL_ADDRESS, NULL, e, cache);
+  }
+
+  if (sn->memo)
+    prog->results[idx] = match ? 1 : -1;
+
+  return match;
+}
+
+/**
+ * score_inputs - Hash the fields of an Email that the score rules depend on
+ * @param e    Email
+ * @param deps What the rules depend on, e.g. #MUTT_PAT_DEP_FLAGS
+ * @retval num Hash
+ */
+static uint32_t score_inputs(const struct Email *e, PatternDeps deps)
+{
+  uint32_t hash = 2166136261U;
+
+  if (deps & MUTT_PAT_DEP_FLAGS)
+  {
+    const uint32_t flags = (e->expired << 0) | (e->flagged << 1) | (e->old << 2) |
+                           (e->read << 3) | (e->replied << 4) | (e->superseded << 5) |
+                           (e->deleted << 6) | (e->tagged << 7);
+    hash = (hash ^ flags) * 16777619U;
+  }
+
+  if (deps & MUTT_PAT_DEP_CRYPT)
+    hash = (hash ^ e->security) * 16777619U;
+
+  if (deps & MUTT_PAT_DEP_LABELS)
+  {
+    const char *label = (e->env && e->env->x_label) ? e->env->x_label : "";
+    hash = (hash ^ g_str_hash(label)) * 16777619U;
+
+    struct Buffer *tags = buf_pool_get();
+    driver_tags_get_with_hidden(e->tags, tags);
+    hash = (hash ^ g_str_hash(buf_string(tags))) * 16777619U;
+    buf_pool_release(&tags);
+  }
+
+  return hash;
+}
+
 /**
  * mutt_check_rescore - Do the emails need to have their scores recalculated?
  * @param m Mailbox
@@ -108,6 +390,8 @@ enum CommandResult mutt_parse_score(struct Buffer *buf, struct Buffer *s,
     return MUTT_CMD_WARNING;
   }
 
+  score_program_free();
+
   /* look for an existing entry and update the value, else add it to the end
    * of the list */
   for (ptr = ScoreList, last = NULL; ptr; last = ptr, ptr = ptr->next)
@@ -138,6 +422,7 @@ enum CommandResult mutt_parse_score(struct Buffer *buf, struct Buffer *s,
       ScoreList = ptr;
     ptr->pat = pat;
     ptr->str = pattern;
+    ptr->deps = mutt_pattern_deps(pat);
   }
   pc = buf->data;
   if (*pc == '=')
@@ -160,27 +445,43 @@ enum CommandResult mutt_parse_score(struct Buffer *buf, struct Buffer *s,
  * @param m        Mailbox
  * @param e        Email
  * @param upd_mbox If true, update the Mailbox too
+ *
+ * If the Email was last scored with the same rules, and none of the fields the
+ * rules depend on have changed, the score is reused.
  */
 void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_mbox)
 {
-  struct Score *tmp = NULL;
-  struct PatternCache cache = { 0 };
+  struct ScoreProgram *prog = score_program_get();
+  const uint32_t old_rules = e->score_rules;
+  bool matched = false;
 
-  e->score = 0; /* in case of re-scoring */
-  for (tmp = ScoreList; tmp; tmp = tmp->next)
+  if ((prog->key == 0) || (e->score_rules != prog->key) ||
+      (e->score_inputs != score_inputs(e, prog->deps)))
   {
-    if (mutt_pattern_exec(tmp->pat->data, MUTT_MATCH_FULL_ADDRESS, NULL, e, &cache) > 0)
+    struct PatternCache cache = { 0 };
+    memset(prog->results, 0, ARRAY_SIZE(&prog->nodes));
+
+    e->score = 0; /* in case of re-scoring */
+    size_t i = 0;
+    for (struct Score *tmp = ScoreList; tmp; tmp = tmp->next, i++)
     {
-      if (tmp->exact || (tmp->val == 9999) || (tmp->val == -9999))
+      if (score_node_match(prog, *ARRAY_GET(&prog->rules, i), e, &cache))
       {
-        e->score = tmp->val;
-        break;
+        if (tmp->exact || (tmp->val == 9999) || (tmp->val == -9999))
+        {
+          e->score = tmp->val;
+          break;
+        }
+        e->score += tmp->val;
       }
-      e->score += tmp->val;
     }
+    if (e->score < 0)
+      e->score = 0;
+
+    matched = true;
   }
-  if (e->score < 0)
-    e->score = 0;
+  trace_counter(matched ? "score_matched" : "score_reused", 1);
+  mailbox_hot_update(m, e);
 
   const short c_score_threshold_delete = cs_subset_number(SpaceMutt->sub, "score_threshold_delete");
   const short c_score_threshold_flag = cs_subset_number(SpaceMutt->sub, "score_threshold_flag");
@@ -192,6 +493,18 @@ void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_mbox)
     mutt_set_flag(m, e, MUTT_READ, true, upd_mbox);
   if (e->score >= c_score_threshold_flag)
     mutt_set_flag(m, e, MUTT_FLAG, true, upd_mbox);
+
+  /* The thresholds may have changed the flags */
+  e->score_rules = prog->key;
+  e->score_inputs = (prog->key != 0) ? score_inputs(e, prog->deps) : 0;
+
+  /* Remember a new score, unless it depends on this session's config.
+   * The caller saves all the rescored Emails at once, see mx_hcache_flush() */
+  if (matched && (prog->key != 0) && (prog->key != old_rules) &&
+      !(prog->deps & MUTT_PAT_DEP_CONFIG))
+  {
+    mx_hcache_defer(m, e);
+  }
 }
 
 /**
@@ -202,6 +515,8 @@ enum CommandResult mutt_parse_unscore(struct Buffer *buf, struct Buffer *s,
 {
   struct Score *tmp = NULL, *last = NULL;
 
+  score_program_free();
+
   while (MoreArgs(s))
   {
     parse_extract_token(buf, s, TOKEN_NO_FLAGS);
@@ -24,6 +24,7 @@
 #define MUTT_SCORE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "core/lib.h"
 
@@ -34,5 +35,6 @@ void mutt_check_rescore(struct Mailbox *m);
 enum CommandResult mutt_parse_score(struct Buffer *buf, struct Buffer *s, intptr_t data, struct Buffer *err);
 enum CommandResult mutt_parse_unscore(struct Buffer *buf, struct Buffer *s, intptr_t data, struct Buffer *err);
 void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_mbox);
+size_t mutt_score_nodes(void);
 
 #endif /* MUTT_SCORE_H */
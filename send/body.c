@@ -28,6 +28,8 @@
 
 #include "config.h"
 #include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
 #include "mutt/lib.h"
 #include "email/lib.h"
 #include "body.h"
@@ -35,89 +37,87 @@
 #include "header.h"
 #include "muttlib.h"
 
-/**
- * struct B64Context - Cursor for the Base64 conversion
- */
-struct B64Context
-{
-  char buffer[3];
-  short size;
-  short linelen;
-};
-
-/**
- * b64_flush - Save the bytes to the file
- * @param bctx   Cursor for the base64 conversion
- * @param fp_out File to save the output
- */
-static void b64_flush(struct B64Context *bctx, FILE *fp_out)
-{
-  /* for some reasons, mutt_b64_encode expects the
-   * output buffer to be larger than 10B */
-  char encoded[11] = { 0 };
-  size_t rc;
-
-  if (bctx->size == 0)
-    return;
-
-  if (bctx->linelen >= 72)
-  {
-    fputc('\n', fp_out);
-    bctx->linelen = 0;
-  }
-
-  /* rc should always be equal to 4 here, because bctx->size
-   * is a value between 1 and 3 (included), but let's not hardcode it
-   * and prefer the return value of the function */
-  rc = mutt_b64_encode(bctx->buffer, bctx->size, encoded, sizeof(encoded));
-  for (size_t i = 0; i < rc; i++)
-  {
-    fputc(encoded[i], fp_out);
-    bctx->linelen++;
-  }
+/// Size of the blocks read when encoding a file
+#define ENCODE_BLOCK (64 * 1024)
 
-  bctx->size = 0;
-}
-
-/**
- * b64_putc - Base64-encode one character
- * @param bctx   Cursor for the base64 conversion
- * @param c      Character to encode
- * @param fp_out File to save the output
- */
-static void b64_putc(struct B64Context *bctx, char c, FILE *fp_out)
-{
-  if (bctx->size == 3)
-    b64_flush(bctx, fp_out);
+/// Number of bytes Base64-encoded on each line
+#define B64_LINE_BYTES 54
 
-  bctx->buffer[bctx->size++] = c;
-}
+/// Length of a Base64-encoded line, excluding the newline
+#define B64_LINE_CHARS 72
 
 /**
  * encode_base64 - Base64-encode some data
  * @param fc     Cursor for converting a file's encoding
  * @param fp_out File to store the result
  * @param istext Is the input text?
+ *
+ * The data is read in large blocks and encoded a line at a time.
  */
 static void encode_base64(struct FgetConv *fc, FILE *fp_out, int istext)
 {
-  struct B64Context bctx = { 0 };
-  int ch, ch1 = EOF;
+  /* A text block can double in size if every character is a newline.
+   * Whatever's left over from the previous block is kept at the front. */
+  const size_t inmax = B64_LINE_BYTES + (istext ? 2 : 1) * ENCODE_BLOCK;
+  const size_t outmax = (inmax / B64_LINE_BYTES + 1) * (B64_LINE_CHARS + 1) + 1;
+  char *raw = istext ? g_malloc(ENCODE_BLOCK) : NULL;
+  char *in = g_malloc(inmax);
+  char *out = g_malloc(outmax);
+  size_t len = 0;
+  size_t total = 0;
+  char ch1 = '\0';
+  size_t r;
 
-  while ((ch = mutt_ch_fgetconv(fc)) != EOF)
+  while ((r = mutt_ch_fgetconv_read(fc, istext ? raw : in + len, ENCODE_BLOCK)) > 0)
   {
     if (SigInt)
     {
       SigInt = false;
-      return;
+      goto done;
+    }
+
+    total += r;
+    if (istext)
+    {
+      for (size_t i = 0; i < r; i++)
+      {
+        if ((raw[i] == '\n') && (ch1 != '\r'))
+          in[len++] = '\r';
+        in[len++] = raw[i];
+        ch1 = raw[i];
+      }
+    }
+    else
+    {
+      len += r;
     }
-    if (istext && (ch == '\n') && (ch1 != '\r'))
-      b64_putc(&bctx, '\r', fp_out);
-    b64_putc(&bctx, ch, fp_out);
-    ch1 = ch;
+
+    const size_t lines = len / B64_LINE_BYTES;
+    char *op = out;
+    for (size_t i = 0; i < lines; i++)
+    {
+      op += mutt_b64_encode(in + (i * B64_LINE_BYTES), B64_LINE_BYTES, op,
+                            B64_LINE_CHARS + 1);
+      *op++ = '\n';
+    }
+    fwrite(out, 1, op - out, fp_out);
+
+    len -= lines * B64_LINE_BYTES;
+    memmove(in, in + (lines * B64_LINE_BYTES), len);
   }
-  b64_flush(&bctx, fp_out);
-  fputc('\n', fp_out);
+
+  /* A partial line, or an empty file, still needs a newline */
+  if ((len > 0) || (total == 0))
+  {
+    char *op = out + mutt_b64_encode(in, len, out, outmax);
+    *op++ = '\n';
+    fwrite(out, 1, op - out, fp_out);
+  }
+
+done:
+  FREE(&raw);
+  FREE(&in);
+  FREE(&out);
 }
 
 /**
@@ -127,17 +127,65 @@ static void encode_base64(struct FgetConv *fc, FILE *fp_out, int istext)
  */
 static void encode_8bit(struct FgetConv *fc, FILE *fp_out)
 {
-  int ch;
+  char *buf = g_malloc(ENCODE_BLOCK);
+  size_t r;
 
-  while ((ch = mutt_ch_fgetconv(fc)) != EOF)
+  while ((r = mutt_ch_fgetconv_read(fc, buf, ENCODE_BLOCK)) > 0)
   {
     if (SigInt)
     {
       SigInt = false;
-      return;
+      break;
     }
-    fputc(ch, fp_out);
+    fwrite(buf, 1, r, fp_out);
+  }
+
+  FREE(&buf);
+}
+
+/**
+ * struct BlockReader - Read a converted file a block at a time
+ */
+struct BlockReader
+{
+  struct FgetConv *fc; ///< Cursor for converting a file's encoding
+  char *buf;           ///< Block of converted data
+  size_t pos;          ///< Next character to return
+  size_t len;          ///< Length of the data in the block
+};
+
+/**
+ * block_getc - Get the next character from a BlockReader
+ * @param br BlockReader
+ * @retval num Next character
+ * @retval EOF End of the file
+ */
+static int block_getc(struct BlockReader *br)
+{
+  if (br->pos == br->len)
+  {
+    br->len = mutt_ch_fgetconv_read(br->fc, br->buf, ENCODE_BLOCK);
+    br->pos = 0;
+    if (br->len == 0)
+      return EOF;
   }
+
+  return (unsigned char) br->buf[br->pos++];
+}
+
+/**
+ * qp_escape - Write a quoted-printable escape sequence
+ * @param buf Buffer for the result, at least 4 bytes
+ * @param c   Character to escape
+ */
+static void qp_escape(char *buf, unsigned char c)
+{
+  static const char Hex[] = "0123456789ABCDEF";
+
+  buf[0] = '=';
+  buf[1] = Hex[c >> 4];
+  buf[2] = Hex[c & 0x0f];
+  buf[3] = '\0';
 }
 
 /**
@@ -150,8 +198,9 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
 {
   int c, linelen = 0;
   char line[77] = { 0 };
+  struct BlockReader br = { fc, g_malloc(ENCODE_BLOCK), 0, 0 };
 
-  while ((c = mutt_ch_fgetconv(fc)) != EOF)
+  while ((c = block_getc(&br)) != EOF)
   {
     /* Wrap the line if needed. */
     if ((linelen == 76) && ((istext && (c != '\n')) || !istext))
@@ -206,7 +255,7 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
       {
         if (linelen < 74)
         {
-          sprintf(line + linelen - 1, "=%2.2X", (unsigned char) line[linelen - 1]);
+          qp_escape(line + linelen - 1, line[linelen - 1]);
           fputs(line, fp_out);
         }
         else
@@ -216,7 +265,9 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
           line[linelen - 1] = '=';
           line[linelen] = 0;
           fputs(line, fp_out);
-          fprintf(fp_out, "\n=%2.2X", (unsigned char) savechar2);
+          qp_escape(line, savechar2);
+          fputc('\n', fp_out);
+          fputs(line, fp_out);
         }
       }
       else
@@ -239,7 +290,7 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
         fputc('\n', fp_out);
         linelen = 0;
       }
-      sprintf(line + linelen, "=%2.2X", (unsigned char) c);
+      qp_escape(line + linelen, c);
       linelen += 3;
     }
     else
@@ -258,7 +309,7 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
       /* take care of trailing whitespace */
       if (linelen < 74)
       {
-        sprintf(line + linelen - 1, "=%2.2X", (unsigned char) line[linelen - 1]);
+        qp_escape(line + linelen - 1, line[linelen - 1]);
       }
       else
       {
@@ -267,7 +318,7 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
         line[linelen] = 0;
         fputs(line, fp_out);
         fputc('\n', fp_out);
-        snprintf(line, sizeof(line), "=%2.2X", (unsigned char) savechar);
+        qp_escape(line, savechar);
       }
     }
     else
@@ -276,6 +327,8 @@ static void encode_quoted(struct FgetConv *fc, FILE *fp_out, bool istext)
     }
     fputs(line, fp_out);
   }
+
+  FREE(&br.buf);
 }
 
 /**
@@ -288,6 +288,15 @@ static struct ConfigDef SendVars[] = {
   { "nm_record", DT_BOOL, false, 0, NULL,
     "(notmuch) If the 'record' mailbox (sent mail) should be indexed"
   },
+  { "outbox", DT_PATH|D_PATH_DIR, 0, 0, NULL,
+    "Directory of messages waiting to be sent in the background"
+  },
+  { "outbox_retry_delay", DT_NUMBER|D_INTEGER_NOT_NEGATIVE, 60, 0, NULL,
+    "Seconds to wait before the first retry of a failed message"
+  },
+  { "outbox_retry_max", DT_NUMBER|D_INTEGER_NOT_NEGATIVE, 10, 0, NULL,
+    "Number of attempts to send a message before giving up"
+  },
   { "pgp_reply_inline", DT_BOOL, false, 0, NULL,
     "Reply using old-style inline PGP messages (not recommended)"
   },
@@ -0,0 +1,225 @@
+/**
+ * @file
+ * Outbox Dialog
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page send_dlg_outbox Outbox Dialog
+ *
+ * The Outbox Dialog shows the messages that are waiting to be sent.
+ *
+ * This is a @ref gui_simple
+ *
+ * ## Windows
+ *
+ * | Name          | Type          | See Also     |
+ * | :------------ | :------------ | :----------- |
+ * | Outbox Dialog | WT_DLG_OUTBOX | dlg_outbox() |
+ *
+ * **Parent**
+ * - @ref gui_dialog
+ *
+ * **Children**
+ * - See: @ref gui_simple
+ *
+ * ## Data
+ * - #OutboxEntryArray
+ *
+ * The Outbox is global, so the Menu doesn't store any data.
+ *
+ * ## Events
+ *
+ * Once constructed, it is controlled by the following events:
+ *
+ * | Event Type  | Handler                  |
+ * | :---------- | :----------------------- |
+ * | #NT_TIMEOUT | outbox_timeout_refresh() |
+ * | #NT_WINDOW  | outbox_window_observer() |
+ *
+ * The Outbox Dialog does not implement MuttWindow::recalc() or
+ * MuttWindow::repaint().
+ *
+ * Some other events are handled by the @ref gui_simple.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <time.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "gui/lib.h"
+#include "key/lib.h"
+#include "menu/lib.h"
+#include "functions.h"
+#include "mutt_logging.h"
+#include "outbox.h"
+
+/// Help Bar for the Outbox dialog
+static const struct Mapping OutboxHelp[] = {
+  // clang-format off
+  { N_("Exit"),     OP_EXIT },
+  { N_("Send now"), OP_GENERIC_SELECT_ENTRY },
+  { N_("Cancel"),   OP_DELETE },
+  { N_("Help"),     OP_HELP },
+  { NULL, 0 },
+  // clang-format on
+};
+
+/**
+ * outbox_make_entry - Format an Outbox entry for the Menu - Implements Menu::make_entry() - @ingroup menu_make_entry
+ */
+static int outbox_make_entry(struct Menu *menu, int line, int max_cols, struct Buffer *buf)
+{
+  struct OutboxEntry **oep = ARRAY_GET(outbox_entries(), line);
+  if (!oep)
+    return 0;
+
+  struct OutboxEntry *oe = *oep;
+  char when[32] = { 0 };
+
+  switch (oe->state)
+  {
+    case OUTBOX_SENDING:
+      mutt_str_copy(when, _("sending"), sizeof(when));
+      break;
+    case OUTBOX_FAILED:
+      mutt_str_copy(when, _("failed"), sizeof(when));
+      break;
+    default:
+      if (oe->next_try <= mutt_date_now())
+        mutt_str_copy(when, _("waiting"), sizeof(when));
+      else
+        mutt_date_localtime_format(when, sizeof(when), "%H:%M:%S", oe->next_try);
+      break;
+  }
+
+  buf_printf(buf, "%-8s %2d  %-24.24s  %s", when, oe->attempts, NONULL(oe->to),
+             NONULL(oe->subject));
+  if (oe->error)
+    buf_add_printf(buf, "  (%s)", oe->error);
+
+  return buf_len(buf);
+}
+
+/**
+ * outbox_timeout_refresh - Notification that a timeout has occurred - Implements ::observer_t - @ingroup observer_api
+ *
+ * The Outbox changes in the background, as messages are sent.
+ */
+static int outbox_timeout_refresh(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_TIMEOUT)
+    return 0;
+  if (!nc->global_data)
+    return -1;
+
+  struct Menu *menu = nc->global_data;
+  menu->max = ARRAY_SIZE(outbox_entries());
+  menu_queue_redraw(menu, MENU_REDRAW_FULL);
+  return 0;
+}
+
+/**
+ * outbox_window_observer - Notification that a Window has changed - Implements ::observer_t - @ingroup observer_api
+ *
+ * This function is triggered by changes to the windows.
+ *
+ * - Delete (this window): clean up the resources held by the Outbox
+ */
+static int outbox_window_observer(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_WINDOW)
+    return 0;
+  if (!nc->global_data || !nc->event_data)
+    return -1;
+  if (nc->event_subtype != NT_WINDOW_DELETE)
+    return 0;
+
+  struct MuttWindow *win_menu = nc->global_data;
+  struct EventWindow *ev_w = nc->event_data;
+  if (ev_w->win != win_menu)
+    return 0;
+
+  struct Menu *menu = win_menu->wdata;
+
+  notify_observer_remove(SpaceMutt->notify_timeout, outbox_timeout_refresh, menu);
+  notify_observer_remove(win_menu->notify, outbox_window_observer, win_menu);
+
+  log_debug5("window delete done");
+  return 0;
+}
+
+/**
+ * dlg_outbox - Show the messages waiting to be sent - @ingroup gui_dlg
+ *
+ * The Outbox Dialog lets the user retry a message immediately, or cancel it.
+ * A cancelled message is moved to `$postponed`.
+ */
+void dlg_outbox(void)
+{
+  struct MuttWindow *dlg = simple_dialog_new(MENU_OUTBOX, WT_DLG_OUTBOX, OutboxHelp);
+
+  struct Menu *menu = dlg->wdata;
+  menu->make_entry = outbox_make_entry;
+  menu->max = ARRAY_SIZE(outbox_entries());
+  menu->mdata = NULL;
+  menu->mdata_free = NULL;
+
+  struct OutboxData od = { menu, false };
+  dlg->wdata = &od;
+
+  notify_observer_add(SpaceMutt->notify_timeout, NT_TIMEOUT, outbox_timeout_refresh, menu);
+  notify_observer_add(menu->win->notify, NT_WINDOW, outbox_window_observer, menu->win);
+
+  struct MuttWindow *sbar = window_find_child(dlg, WT_STATUS_BAR);
+  sbar_set_title(sbar, _("Outbox"));
+
+  struct MuttWindow *old_focus = window_set_focus(menu->win);
+  // ---------------------------------------------------------------------------
+  // Event Loop
+  int op = OP_NULL;
+  do
+  {
+    menu_tagging_dispatcher(menu->win, op);
+    window_redraw(NULL);
+
+    op = km_dokey(MENU_OUTBOX, GETCH_NO_FLAGS);
+    log_debug1("Got op %s (%d)", opcodes_get_name(op), op);
+    if (op < 0)
+      continue;
+    if (op == OP_NULL)
+    {
+      km_error_key(MENU_OUTBOX);
+      continue;
+    }
+    mutt_clear_error();
+
+    int rc = outbox_function_dispatcher(dlg, op);
+
+    if (rc == FR_UNKNOWN)
+      rc = menu_function_dispatcher(menu->win, op);
+    if (rc == FR_UNKNOWN)
+      rc = global_function_dispatcher(NULL, op);
+  } while (!od.done);
+  // ---------------------------------------------------------------------------
+
+  window_set_focus(old_focus);
+  simple_dialog_free(&dlg);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file
+ * Outbox functions
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page send_functions Outbox functions
+ *
+ * Outbox functions
+ */
+
+#include "config.h"
+#ifdef _MAKEDOC
+#include "docs/makedoc_defs.h"
+#else
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "gui/lib.h"
+#include "functions.h"
+#include "key/lib.h"
+#include "menu/lib.h"
+#include "question/lib.h"
+#include "outbox.h"
+#endif
+
+// clang-format off
+/**
+ * OpOutbox - Functions for the Outbox Menu
+ */
+const struct MenuFuncOp OpOutbox[] = { /* map: outbox */
+  { "delete-entry",                  OP_DELETE },
+  { "exit",                          OP_EXIT },
+  { NULL, 0 },
+};
+
+/**
+ * OutboxDefaultBindings - Key bindings for the Outbox Menu
+ */
+const struct MenuOpSeq OutboxDefaultBindings[] = { /* map: outbox */
+  { OP_DELETE,                             "d" },
+  { OP_EXIT,                               "q" },
+  { 0, NULL },
+};
+// clang-format on
+
+/**
+ * current_entry - Get the highlighted Outbox entry
+ * @param od Outbox Data
+ * @retval ptr Outbox entry
+ */
+static struct OutboxEntry *current_entry(struct OutboxData *od)
+{
+  struct OutboxEntry **oep = ARRAY_GET(outbox_entries(), menu_get_index(od->menu));
+  return oep ? *oep : NULL;
+}
+
+/**
+ * op_delete - Cancel sending the current entry - Implements ::outbox_function_t - @ingroup outbox_function_api
+ */
+static int op_delete(struct OutboxData *od, int op)
+{
+  struct OutboxEntry *oe = current_entry(od);
+  if (!oe)
+    return FR_NO_ACTION;
+
+  if (oe->state == OUTBOX_SENDING)
+  {
+    log_fault(_("The message is being sent"));
+    return FR_ERROR;
+  }
+
+  if (query_yesorno(_("Cancel sending this message?"), MUTT_NO) != MUTT_YES)
+    return FR_NO_ACTION;
+
+  if (outbox_cancel(oe) != 0)
+  {
+    log_fault(_("Couldn't save the message to $postponed"));
+    return FR_ERROR;
+  }
+
+  od->menu->max = ARRAY_SIZE(outbox_entries());
+  menu_queue_redraw(od->menu, MENU_REDRAW_FULL);
+  return FR_SUCCESS;
+}
+
+/**
+ * op_exit - Exit this menu - Implements ::outbox_function_t - @ingroup outbox_function_api
+ */
+static int op_exit(struct OutboxData *od, int op)
+{
+  od->done = true;
+  return FR_SUCCESS;
+}
+
+/**
+ * op_generic_select_entry - Send the current entry now - Implements ::outbox_function_t - @ingroup outbox_function_api
+ */
+static int op_generic_select_entry(struct OutboxData *od, int op)
+{
+  struct OutboxEntry *oe = current_entry(od);
+  if (!oe)
+    return FR_NO_ACTION;
+
+  if (oe->state == OUTBOX_SENDING)
+    return FR_NO_ACTION;
+
+  outbox_retry(oe);
+  od->menu->max = ARRAY_SIZE(outbox_entries());
+  menu_queue_redraw(od->menu, MENU_REDRAW_FULL);
+  return FR_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * OutboxFunctions - All the SpaceMutt functions that the Outbox supports
+ */
+static const struct OutboxFunction OutboxFunctions[] = {
+  // clang-format off
+  { OP_DELETE,                 op_delete },
+  { OP_EXIT,                   op_exit },
+  { OP_GENERIC_SELECT_ENTRY,   op_generic_select_entry },
+  { 0, NULL },
+  // clang-format on
+};
+
+/**
+ * outbox_function_dispatcher - Perform an Outbox function - Implements ::function_dispatcher_t - @ingroup dispatcher_api
+ */
+int outbox_function_dispatcher(struct MuttWindow *win, int op)
+{
+  if (!win || !win->wdata)
+    return FR_UNKNOWN;
+
+  struct MuttWindow *dlg = dialog_find(win);
+  if (!dlg)
+    return FR_ERROR;
+
+  struct OutboxData *od = dlg->wdata;
+
+  int rc = FR_UNKNOWN;
+  for (size_t i = 0; OutboxFunctions[i].op != OP_NULL; i++)
+  {
+    const struct OutboxFunction *fn = &OutboxFunctions[i];
+    if (fn->op == op)
+    {
+      rc = fn->function(od, op);
+      break;
+    }
+  }
+
+  if (rc == FR_UNKNOWN) // Not our function
+    return rc;
+
+  const char *result = dispatcher_get_retval_name(rc);
+  log_debug1("Handled %s (%d) -> %s", opcodes_get_name(op), op, NONULL(result));
+
+  return rc;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * Outbox functions
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_SEND_FUNCTIONS_H
+#define MUTT_SEND_FUNCTIONS_H
+
+#include <stdbool.h>
+
+struct MuttWindow;
+
+/**
+ * struct OutboxData - Data to pass to the Outbox Functions
+ */
+struct OutboxData
+{
+  struct Menu *menu; ///< Outbox Menu
+  bool         done; ///< Should we close the Dialog?
+};
+
+/**
+ * @defgroup outbox_function_api Outbox Function API
+ * @ingroup dispatcher_api
+ *
+ * Prototype for an Outbox Function
+ *
+ * @param od Outbox Data
+ * @param op Operation to perform, e.g. OP_DELETE
+ * @retval enum #FunctionRetval
+ */
+typedef int (*outbox_function_t)(struct OutboxData *od, int op);
+
+/**
+ * struct OutboxFunction - A SpaceMutt function
+ */
+struct OutboxFunction
+{
+  int op;                     ///< Op code, e.g. OP_DELETE
+  outbox_function_t function; ///< Function to call
+};
+
+int outbox_function_dispatcher(struct MuttWindow *win, int op);
+
+#endif /* MUTT_SEND_FUNCTIONS_H */
@@ -25,16 +25,19 @@
  *
  * Shared code for sending Emails
  *
- * | File             | Description             |
- * | :--------------- | :---------------------- |
- * | send/body.c      | @subpage send_body      |
- * | send/config.c    | @subpage send_config    |
- * | send/header.c    | @subpage send_header    |
- * | send/multipart.c | @subpage send_multipart |
- * | send/send.c      | @subpage send_send      |
- * | send/sendlib.c   | @subpage send_sendlib   |
- * | send/sendmail.c  | @subpage send_sendmail  |
- * | send/smtp.c      | @subpage send_smtp      |
+ * | File              | Description              |
+ * | :---------------- | :----------------------- |
+ * | send/body.c       | @subpage send_body       |
+ * | send/config.c     | @subpage send_config     |
+ * | send/dlg_outbox.c | @subpage send_dlg_outbox |
+ * | send/functions.c  | @subpage send_functions  |
+ * | send/header.c     | @subpage send_header     |
+ * | send/multipart.c  | @subpage send_multipart  |
+ * | send/outbox.c     | @subpage send_outbox     |
+ * | send/send.c       | @subpage send_send       |
+ * | send/sendlib.c    | @subpage send_sendlib    |
+ * | send/sendmail.c   | @subpage send_sendmail   |
+ * | send/smtp.c       | @subpage send_smtp       |
  */
 
 #ifndef MUTT_SEND_LIB_H
@@ -44,6 +47,7 @@
 #include "body.h"
 #include "header.h"
 #include "multipart.h"
+#include "outbox.h"
 #include "send.h"
 #include "sendlib.h"
 #include "sendmail.h"
@@ -0,0 +1,1241 @@
+/**
+ * @file
+ * Queue of messages waiting to be sent
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page send_outbox Queue of messages waiting to be sent
+ *
+ * If `$outbox` is set, sending a message doesn't wait for the MTA.  The
+ * message is written to the `$outbox` directory and a worker process delivers
+ * it in the background, using `$smtp_url` or `$sendmail` as usual.
+ *
+ * If delivery fails, it's retried later.  The delay starts at
+ * `$outbox_retry_delay` and doubles after each failure, up to an hour.  After
+ * `$outbox_retry_max` attempts the message is left in the Outbox for the user
+ * to retry, or cancel.  A cancelled message is moved to `$postponed`.
+ *
+ * Once the message has been sent, it's saved to its Fcc folders.  The copy is
+ * the message exactly as it was sent, as if `$fcc_before_send` were set.  If
+ * `$fcc_clear` or `$fcc_attach` would change the copy, the caller saves it
+ * when the message is queued instead.
+ *
+ * Each message is stored as two files:
+ * - `<id>.msg` The message, as it will be sent
+ * - `<id>.env` The envelope and the state of the queue entry
+ *
+ * The worker writes its result to `<id>.res`, so it isn't lost if SpaceMutt
+ * exits before the worker finishes.  The queue is read again at startup.
+ *
+ * A worker has no terminal, so it can't ask for a password, or whether to trust
+ * the server's certificate.  Before the first worker is started, SpaceMutt logs
+ * in to the SMTP server in the foreground and asks any questions then.  Any
+ * password is handed to the workers.
+ *
+ * Several SpaceMutts may share an `$outbox`, and a worker may outlive the
+ * SpaceMutt that started it.  The worker holds a lock on `<id>.msg` until it
+ * exits, and an entry is only started, or its result processed, by whoever
+ * holds that lock.  `<id>.env` can't be locked because it's replaced on every
+ * save.
+ */
+
+#include "config.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "conn/lib.h"
+#include "outbox.h"
+#include "globals.h"
+#include "muttlib.h"
+#include "mx.h"
+#include "postpone/lib.h"
+#include "sendlib.h"
+#include "sendmail.h"
+#include "smtp.h"
+
+/// Longest delay between attempts, in seconds
+#define OUTBOX_MAX_BACKOFF (60 * 60)
+/// A worker that runs longer than this is assumed to be stuck, in seconds
+#define OUTBOX_WORKER_TIMEOUT (10 * 60)
+
+/// Messages waiting to be sent
+static struct OutboxEntryArray Outbox = ARRAY_HEAD_INITIALIZER;
+/// Has `$outbox` been read?
+static bool OutboxLoaded = false;
+/// Last error logged by a worker
+static char WorkerError[256];
+/// SMTP account the user has logged in to, see outbox_login()
+static struct ConnAccount OutboxAccount = { { 0 } };
+/// `$smtp_url` of #OutboxAccount, or NULL if the user hasn't logged in
+static char *OutboxSmtpUrl = NULL;
+/// Number of failed logins, see outbox_login()
+static int OutboxLoginFailures = 0;
+/// Don't try to log in again until this time
+static time_t OutboxLoginNext = 0;
+/// Is outbox_run() running?  Logging in may run the event loop.
+static bool OutboxRunning = false;
+
+/// Names of the states, as stored in the `.env` file
+static const struct Mapping OutboxStateNames[] = {
+  // clang-format off
+  { "waiting", OUTBOX_WAITING },
+  { "sending", OUTBOX_SENDING },
+  { "failed",  OUTBOX_FAILED },
+  { NULL, 0 },
+  // clang-format on
+};
+
+/**
+ * outbox_entry_free - Free an OutboxEntry
+ * @param ptr OutboxEntry to free
+ */
+void outbox_entry_free(struct OutboxEntry **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct OutboxEntry *oe = *ptr;
+  FREE(&oe->id);
+  FREE(&oe->from);
+  FREE(&oe->to);
+  FREE(&oe->cc);
+  FREE(&oe->bcc);
+  FREE(&oe->subject);
+  FREE(&oe->fcc);
+  FREE(&oe->error);
+  FREE(ptr);
+}
+
+/**
+ * outbox_file - Get the path of one of an entry's files
+ * @param buf Buffer for the result
+ * @param id  Entry id
+ * @param ext File extension, e.g. "msg"
+ */
+static void outbox_file(struct Buffer *buf, const char *id, const char *ext)
+{
+  const char *const c_outbox = cs_subset_path(SpaceMutt->sub, "outbox");
+  buf_printf(buf, "%s/%s.%s", NONULL(c_outbox), id, ext);
+}
+
+/**
+ * outbox_entry_save - Write an entry's envelope and state to `$outbox`
+ * @param oe Outbox entry
+ * @retval  0 Success
+ * @retval -1 Error
+ */
+int outbox_entry_save(const struct OutboxEntry *oe)
+{
+  struct Buffer *tmp = buf_pool_get();
+  struct Buffer *path = buf_pool_get();
+  int rc = -1;
+
+  outbox_file(path, oe->id, "env");
+  buf_printf(tmp, "%s.tmp", buf_string(path));
+
+  int fd = mutt_file_open(buf_string(tmp), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  FILE *fp = (fd < 0) ? NULL : fdopen(fd, "w");
+  if (!fp)
+  {
+    if (fd >= 0)
+      close(fd);
+    log_perror("%s", buf_string(tmp));
+    goto done;
+  }
+
+  fprintf(fp, "from %s\n", NONULL(oe->from));
+  fprintf(fp, "to %s\n", NONULL(oe->to));
+  fprintf(fp, "cc %s\n", NONULL(oe->cc));
+  fprintf(fp, "bcc %s\n", NONULL(oe->bcc));
+  fprintf(fp, "subject %s\n", NONULL(oe->subject));
+  fprintf(fp, "fcc %s\n", NONULL(oe->fcc));
+  fprintf(fp, "error %s\n", NONULL(oe->error));
+  fprintf(fp, "eightbit %d\n", oe->eightbit);
+  fprintf(fp, "state %s\n", mutt_map_get_name(oe->state, OutboxStateNames));
+  fprintf(fp, "attempts %d\n", oe->attempts);
+  fprintf(fp, "queued %ld\n", (long) oe->queued);
+  fprintf(fp, "next %ld\n", (long) oe->next_try);
+  fprintf(fp, "started %ld\n", (long) oe->started);
+  fprintf(fp, "pid %d\n", (int) oe->pid);
+
+  if ((mutt_file_fclose(&fp) != 0) || (rename(buf_string(tmp), buf_string(path)) != 0))
+  {
+    log_perror("%s", buf_string(path));
+    unlink(buf_string(tmp));
+    goto done;
+  }
+
+  rc = 0;
+
+done:
+  buf_pool_release(&tmp);
+  buf_pool_release(&path);
+  return rc;
+}
+
+/**
+ * outbox_entry_load - Read an entry from `$outbox`
+ * @param id Entry id
+ * @retval ptr New OutboxEntry
+ * @retval NULL Error
+ */
+struct OutboxEntry *outbox_entry_load(const char *id)
+{
+  struct Buffer *path = buf_pool_get();
+  outbox_file(path, id, "env");
+
+  FILE *fp = mutt_file_fopen(buf_string(path), "r");
+  buf_pool_release(&path);
+  if (!fp)
+    return NULL;
+
+  struct OutboxEntry *oe = g_new0(struct OutboxEntry, 1);
+  oe->id = mutt_str_dup(id);
+
+  char *line = NULL;
+  size_t linelen = 0;
+  while ((line = mutt_file_read_line(line, &linelen, fp, NULL, MUTT_RL_NO_FLAGS)))
+  {
+    char *value = strchr(line, ' ');
+    if (!value)
+      continue;
+    *value++ = '\0';
+
+    long num = 0;
+    if (mutt_str_equal(line, "from"))
+      mutt_str_replace(&oe->from, value);
+    else if (mutt_str_equal(line, "to"))
+      mutt_str_replace(&oe->to, value);
+    else if (mutt_str_equal(line, "cc"))
+      mutt_str_replace(&oe->cc, value);
+    else if (mutt_str_equal(line, "bcc"))
+      mutt_str_replace(&oe->bcc, value);
+    else if (mutt_str_equal(line, "subject"))
+      mutt_str_replace(&oe->subject, value);
+    else if (mutt_str_equal(line, "fcc"))
+      mutt_str_replace(&oe->fcc, value);
+    else if (mutt_str_equal(line, "error"))
+      mutt_str_replace(&oe->error, value);
+    else if (mutt_str_equal(line, "eightbit"))
+      oe->eightbit = mutt_str_equal(value, "1");
+    else if (mutt_str_equal(line, "state"))
+      oe->state = MAX(mutt_map_get_value(value, OutboxStateNames), OUTBOX_WAITING);
+    else if (mutt_str_equal(line, "attempts"))
+      mutt_str_atoi(value, &oe->attempts);
+    else if (mutt_str_equal(line, "queued") && mutt_str_atol_full(value, &num))
+      oe->queued = num;
+    else if (mutt_str_equal(line, "next") && mutt_str_atol_full(value, &num))
+      oe->next_try = num;
+    else if (mutt_str_equal(line, "started") && mutt_str_atol_full(value, &num))
+      oe->started = num;
+    else if (mutt_str_equal(line, "pid") && mutt_str_atol_full(value, &num))
+      oe->pid = num;
+  }
+  FREE(&line);
+  mutt_file_fclose(&fp);
+
+  return oe;
+}
+
+/**
+ * outbox_entry_refresh - Read an entry's state again
+ * @param oe Outbox entry
+ * @retval true  Success
+ * @retval false The entry has gone, e.g. another SpaceMutt sent it
+ *
+ * Another SpaceMutt, sharing `$outbox`, may have changed the entry.
+ */
+static bool outbox_entry_refresh(struct OutboxEntry *oe)
+{
+  struct OutboxEntry *disk = outbox_entry_load(oe->id);
+  if (!disk)
+    return false;
+
+  oe->state = disk->state;
+  oe->attempts = disk->attempts;
+  oe->next_try = disk->next_try;
+  oe->started = disk->started;
+  oe->pid = disk->pid;
+  mutt_str_replace(&oe->error, disk->error);
+  outbox_entry_free(&disk);
+  return true;
+}
+
+/**
+ * outbox_lock - Lock an entry, so only one process sends it
+ * @param oe Outbox entry
+ * @retval num File descriptor holding the lock
+ * @retval -1  The entry is locked by another process, or it has gone
+ *
+ * The lock is released when every copy of the file descriptor is closed.  A
+ * worker inherits it and holds it until it exits.
+ */
+static int outbox_lock(const struct OutboxEntry *oe)
+{
+  struct Buffer *path = buf_pool_get();
+  outbox_file(path, oe->id, "msg");
+  int fd = open(buf_string(path), O_RDONLY | O_CLOEXEC);
+  buf_pool_release(&path);
+
+  if ((fd >= 0) && (flock(fd, LOCK_EX | LOCK_NB) != 0))
+  {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+/**
+ * outbox_has_result - Has a worker left a result?
+ * @param oe Outbox entry
+ * @retval true `<id>.res` exists
+ */
+static bool outbox_has_result(const struct OutboxEntry *oe)
+{
+  struct Buffer *path = buf_pool_get();
+  outbox_file(path, oe->id, "res");
+  const bool found = (access(buf_string(path), F_OK) == 0);
+  buf_pool_release(&path);
+  return found;
+}
+
+/**
+ * outbox_entry_forget - Forget an entry, leaving its files alone
+ * @param oe Outbox entry
+ */
+static void outbox_entry_forget(struct OutboxEntry *oe)
+{
+  struct OutboxEntry **oep = NULL;
+  ARRAY_FOREACH(oep, &Outbox)
+  {
+    if (*oep == oe)
+    {
+      ARRAY_REMOVE(&Outbox, oep);
+      break;
+    }
+  }
+  outbox_entry_free(&oe);
+}
+
+/**
+ * outbox_entry_remove - Delete an entry's files and forget it
+ * @param oe Outbox entry
+ */
+static void outbox_entry_remove(struct OutboxEntry *oe)
+{
+  struct Buffer *path = buf_pool_get();
+  static const char *const exts[] = { "msg", "env", "res" };
+  for (size_t i = 0; i < mutt_array_size(exts); i++)
+  {
+    outbox_file(path, oe->id, exts[i]);
+    unlink(buf_string(path));
+  }
+  buf_pool_release(&path);
+
+  outbox_entry_forget(oe);
+}
+
+/**
+ * outbox_sort - Compare two Outbox entries by age - Implements ::sort_t - @ingroup sort_api
+ */
+static int outbox_sort(const void *a, const void *b, void *sdata)
+{
+  const struct OutboxEntry *oa = *(struct OutboxEntry const *const *) a;
+  const struct OutboxEntry *ob = *(struct OutboxEntry const *const *) b;
+
+  if (oa->queued != ob->queued)
+    return (oa->queued < ob->queued) ? -1 : 1;
+  return mutt_str_cmp(oa->id, ob->id);
+}
+
+/**
+ * outbox_load - Read the queued messages from `$outbox`
+ */
+static void outbox_load(void)
+{
+  OutboxLoaded = true;
+
+  const char *const c_outbox = cs_subset_path(SpaceMutt->sub, "outbox");
+  if (!c_outbox)
+    return;
+
+  DIR *dir = mutt_file_opendir(c_outbox, MUTT_OPENDIR_NONE);
+  if (!dir)
+    return;
+
+  struct dirent *de = NULL;
+  while ((de = readdir(dir)))
+  {
+    const size_t len = mutt_str_len(de->d_name);
+    if ((len < 5) || !mutt_str_equal(de->d_name + len - 4, ".env"))
+      continue;
+
+    char *id = g_strndup(de->d_name, len - 4);
+    struct OutboxEntry *oe = outbox_entry_load(id);
+    FREE(&id);
+    if (oe)
+      ARRAY_ADD(&Outbox, oe);
+  }
+  closedir(dir);
+
+  ARRAY_SORT(&Outbox, outbox_sort, NULL);
+  log_debug2("%d messages in the outbox", ARRAY_SIZE(&Outbox));
+}
+
+/**
+ * outbox_backoff - How long to wait before trying again
+ * @param attempts Number of failed attempts
+ * @param delay    Initial delay, `$outbox_retry_delay`
+ * @retval num Seconds to wait
+ */
+int outbox_backoff(int attempts, int delay)
+{
+  if ((attempts <= 0) || (delay <= 0))
+    return MAX(delay, 0);
+
+  long long wait = delay;
+  for (int i = 1; (i < attempts) && (wait < OUTBOX_MAX_BACKOFF); i++)
+    wait *= 2;
+
+  return MIN(wait, OUTBOX_MAX_BACKOFF);
+}
+
+/**
+ * outbox_append - Append a sent message to a Mailbox
+ * @param path Mailbox to append to
+ * @param oe   Outbox entry
+ * @param post true if the Mailbox is `$postponed`
+ * @retval  0 Success
+ * @retval -1 Error
+ *
+ * The 'Bcc' header was removed from the message before it was sent, so it's
+ * added back to the copy.
+ */
+static int outbox_append(const char *path, const struct OutboxEntry *oe, bool post)
+{
+  struct Buffer *msgfile = buf_pool_get();
+  outbox_file(msgfile, oe->id, "msg");
+
+  struct Mailbox *m = mx_path_resolve(path);
+  const bool old_append = m->append;
+  struct Email *e = NULL;
+  struct Message *msg = NULL;
+  char *line = NULL;
+  size_t linelen = 0;
+  int rc = -1;
+
+  FILE *fp_in = mutt_file_fopen(buf_string(msgfile), "r");
+  if (!fp_in)
+    goto done;
+
+  if (!mx_mbox_open(m, MUTT_APPEND | MUTT_QUIET))
+  {
+    log_debug1("unable to open mailbox %s in append-mode", path);
+    goto done;
+  }
+
+  e = email_new();
+  e->env = mutt_env_new();
+  mutt_addrlist_parse(e->env->from, oe->from);
+  e->read = !post;
+  e->received = mutt_date_now();
+
+  msg = mx_msg_open_new(m, e, post ? (MUTT_ADD_FROM | MUTT_SET_DRAFT) : MUTT_ADD_FROM);
+  if (!msg)
+  {
+    mx_mbox_close(m);
+    goto done;
+  }
+
+  /* Copy the header */
+  bool has_bcc = false;
+  while ((line = mutt_file_read_line(line, &linelen, fp_in, NULL, MUTT_RL_NO_FLAGS)))
+  {
+    if (line[0] == '\0')
+      break;
+    if (mutt_istr_startswith(line, "Bcc:"))
+      has_bcc = true;
+    fprintf(msg->fp, "%s\n", line);
+  }
+
+  if (!has_bcc && oe->bcc && (oe->bcc[0] != '\0'))
+    fprintf(msg->fp, "Bcc: %s\n", oe->bcc);
+
+  const LOFF_T body_start = ftello(fp_in);
+  if ((m->type == MUTT_MMDF) || (m->type == MUTT_MBOX))
+  {
+    /* A Content-Length avoids problems with body lines beginning "From " */
+    int lines = 0;
+    while ((line = mutt_file_read_line(line, &linelen, fp_in, NULL, MUTT_RL_NO_FLAGS)))
+      lines++;
+
+    if (!post)
+      fputs("Status: RO\n", msg->fp);
+    fprintf(msg->fp, "Content-Length: " OFF_T_FMT "\n", ftello(fp_in) - body_start);
+    fprintf(msg->fp, "Lines: %d\n", lines);
+  }
+  fputc('\n', msg->fp);
+
+  /* Copy the body */
+  ssize_t bytes = -1;
+  if (mutt_file_seek(fp_in, body_start, SEEK_SET))
+    bytes = mutt_file_copy_stream(fp_in, msg->fp);
+
+  if ((mx_msg_commit(m, msg) != 0) || (bytes < 0))
+    rc = -1;
+  else
+    rc = 0;
+  mx_msg_close(m, &msg);
+  mx_mbox_close(m);
+
+done:
+  m->append = old_append;
+  mailbox_free(&m);
+  email_free(&e);
+  FREE(&line);
+  mutt_file_fclose(&fp_in);
+  buf_pool_release(&msgfile);
+  return rc;
+}
+
+/**
+ * outbox_save_fcc - Save a copy of a sent message to its Fcc folders
+ * @param oe Outbox entry
+ * @retval  0 Success
+ * @retval -1 Error
+ *
+ * The copy is the message as it was sent.  `$fcc_clear` and `$fcc_attach`
+ * aren't applied; if they'd change the copy, it isn't queued.
+ */
+static int outbox_save_fcc(const struct OutboxEntry *oe)
+{
+  if (!oe->fcc || (oe->fcc[0] == '\0') || mutt_str_equal(oe->fcc, "/dev/null"))
+    return 0;
+
+  int rc = 0;
+  char *fccs = mutt_str_dup(oe->fcc);
+  struct Buffer *path = buf_pool_get();
+
+  char *save = NULL;
+  for (char *tok = strtok_r(fccs, FCC_DELIMITER, &save); tok;
+       tok = strtok_r(NULL, FCC_DELIMITER, &save))
+  {
+    if (*tok == '\0')
+      continue;
+
+    buf_strcpy(path, tok);
+    buf_expand_path(path);
+    if (outbox_append(buf_string(path), oe, false) != 0)
+    {
+      log_fault(_("Fcc to %s failed"), buf_string(path));
+      rc = -1;
+    }
+  }
+
+  buf_pool_release(&path);
+  FREE(&fccs);
+  return rc;
+}
+
+/**
+ * outbox_worker_log - Remember the errors of a worker - Implements GLogWriterFunc
+ */
+static GLogWriterOutput outbox_worker_log(GLogLevelFlags level, const GLogField *fields,
+                                          gsize n_fields, gpointer user_data)
+{
+  log_writer_file(level, fields, n_fields, user_data);
+
+  if ((level == LOG_LEVEL_FAULT) || (level & (G_LOG_LEVEL_CRITICAL | G_LOG_LEVEL_WARNING)))
+    mutt_str_copy(WorkerError, log_get_field(fields, n_fields, "MESSAGE"), sizeof(WorkerError));
+
+  return G_LOG_WRITER_HANDLED;
+}
+
+/**
+ * outbox_deliver - Send a queued message to the MTA
+ * @param oe  Outbox entry
+ * @param sub Config Subset
+ * @retval  0 Success
+ * @retval -1 Failure
+ *
+ * @note This runs in the worker process
+ */
+static int outbox_deliver(const struct OutboxEntry *oe, struct ConfigSubset *sub)
+{
+  struct Envelope *env = mutt_env_new();
+  mutt_addrlist_parse(env->from, oe->from);
+  mutt_addrlist_parse(env->to, oe->to);
+  mutt_addrlist_parse(env->cc, oe->cc);
+  mutt_addrlist_parse(env->bcc, oe->bcc);
+
+  struct Buffer *msgfile = buf_pool_get();
+  outbox_file(msgfile, oe->id, "msg");
+
+  int rc = -1;
+  const char *const c_smtp_url = cs_subset_string(sub, "smtp_url");
+  if (c_smtp_url)
+  {
+    rc = mutt_smtp_send(env->from, env->to, env->cc, env->bcc,
+                        buf_string(msgfile), oe->eightbit, sub);
+  }
+  else
+  {
+    /* sendmail deletes the file it's given */
+    struct Buffer *tmp = buf_pool_get();
+    buf_mktemp(tmp);
+    FILE *fp_in = mutt_file_fopen(buf_string(msgfile), "r");
+    FILE *fp_out = mutt_file_fopen(buf_string(tmp), "w");
+    if (fp_in && fp_out && (mutt_file_copy_stream(fp_in, fp_out) >= 0) &&
+        (mutt_file_fclose(&fp_out) == 0))
+    {
+      rc = mutt_invoke_sendmail(NULL, env->from, env->to, env->cc, env->bcc,
+                                buf_string(tmp), oe->eightbit, sub);
+      /* > 0 means that sendmail was put in the background */
+      rc = (rc < 0) ? -1 : 0;
+    }
+    else
+    {
+      log_perror("%s", buf_string(tmp));
+    }
+    mutt_file_fclose(&fp_in);
+    mutt_file_fclose(&fp_out);
+    unlink(buf_string(tmp));
+    buf_pool_release(&tmp);
+  }
+
+  buf_pool_release(&msgfile);
+  mutt_env_free(&env);
+  return (rc == 0) ? 0 : -1;
+}
+
+/**
+ * outbox_worker - Send a message in a worker process
+ * @param oe Outbox entry
+ *
+ * The result is written to `<id>.res`: the status on the first line, then the
+ * last error message.  The entry's lock, inherited from outbox_start(), is held
+ * until the worker exits.
+ *
+ * @note This function doesn't return
+ */
+static void outbox_worker(const struct OutboxEntry *oe)
+{
+  /* Keep running, even if the user quits */
+  setsid();
+  mutt_sig_reset_child_signals();
+
+  int fd = open("/dev/null", O_RDWR);
+  if (fd >= 0)
+  {
+    dup2(fd, STDIN_FILENO);
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    if (fd > STDERR_FILENO)
+      close(fd);
+  }
+
+  /* There's no terminal, so don't prompt or draw anything */
+  OptNoCurses = true;
+
+  /* Use the password that the user typed for outbox_login() */
+  if ((OutboxAccount.flags & MUTT_ACCT_PASS) && !cs_subset_string(SpaceMutt->sub, "smtp_pass"))
+    cs_subset_str_string_set(SpaceMutt->sub, "smtp_pass", OutboxAccount.pass, NULL);
+
+  MuttLogWriter = outbox_worker_log;
+  WorkerError[0] = '\0';
+
+  const int rc = outbox_deliver(oe, SpaceMutt->sub);
+
+  struct Buffer *path = buf_pool_get();
+  struct Buffer *tmp = buf_pool_get();
+  outbox_file(path, oe->id, "res");
+  buf_printf(tmp, "%s.tmp", buf_string(path));
+
+  FILE *fp = mutt_file_fopen(buf_string(tmp), "w");
+  if (fp)
+  {
+    fprintf(fp, "%d\n%s\n", rc, WorkerError);
+    if (mutt_file_fclose(&fp) == 0)
+      rename(buf_string(tmp), buf_string(path));
+  }
+
+  _exit((rc == 0) ? 0 : 1);
+}
+
+/**
+ * outbox_logout - Forget the SMTP account
+ */
+static void outbox_logout(void)
+{
+  memset(&OutboxAccount, 0, sizeof(OutboxAccount));
+  FREE(&OutboxSmtpUrl);
+  OutboxLoginFailures = 0;
+  OutboxLoginNext = 0;
+}
+
+/**
+ * outbox_login - Log in to the SMTP server, so that a worker won't need to ask
+ * @retval true The workers can send messages without the user
+ *
+ * The server is only checked once for each `$smtp_url`.  If the login fails,
+ * e.g. the user didn't give a password, it's retried later, like a message.
+ */
+static bool outbox_login(void)
+{
+  /* sendmail doesn't ask the user anything */
+  const char *const c_smtp_url = cs_subset_string(SpaceMutt->sub, "smtp_url");
+  if (!c_smtp_url)
+    return true;
+
+  if (mutt_str_equal(c_smtp_url, OutboxSmtpUrl))
+    return true;
+
+  /* $smtp_url has changed */
+  if (OutboxSmtpUrl)
+    outbox_logout();
+
+  const time_t now = mutt_date_now();
+  if (OutboxLoginNext > now)
+    return false;
+
+  if (mutt_smtp_login(SpaceMutt->sub, &OutboxAccount) != 0)
+  {
+    memset(&OutboxAccount, 0, sizeof(OutboxAccount));
+    const short c_outbox_retry_delay = cs_subset_number(SpaceMutt->sub, "outbox_retry_delay");
+    OutboxLoginFailures++;
+    OutboxLoginNext = now + outbox_backoff(OutboxLoginFailures, c_outbox_retry_delay);
+    log_debug1("outbox: login failed, attempt %d", OutboxLoginFailures);
+    return false;
+  }
+
+  OutboxSmtpUrl = mutt_str_dup(c_smtp_url);
+  OutboxLoginFailures = 0;
+  OutboxLoginNext = 0;
+  return true;
+}
+
+/**
+ * outbox_finish - Process the result of a worker
+ * @param oe Outbox entry
+ *
+ * Until the worker exits, it holds the entry's lock, so a missing result is
+ * only counted as a failure once the lock can be taken.
+ */
+static void outbox_finish(struct OutboxEntry *oe)
+{
+  const int lock = outbox_lock(oe);
+  if (lock < 0)
+  {
+    /* Still being sent, or another SpaceMutt has finished it */
+    if (!outbox_entry_refresh(oe))
+      outbox_entry_forget(oe);
+    return;
+  }
+
+  if (!outbox_entry_refresh(oe))
+  {
+    close(lock);
+    outbox_entry_forget(oe);
+    return;
+  }
+
+  /* Another SpaceMutt has already processed the result */
+  if ((oe->state != OUTBOX_SENDING) && !outbox_has_result(oe))
+  {
+    close(lock);
+    return;
+  }
+
+  struct Buffer *path = buf_pool_get();
+  outbox_file(path, oe->id, "res");
+
+  int status = -1;
+  char *error = NULL;
+  FILE *fp = mutt_file_fopen(buf_string(path), "r");
+  if (fp)
+  {
+    char *line = NULL;
+    size_t linelen = 0;
+    if ((line = mutt_file_read_line(line, &linelen, fp, NULL, MUTT_RL_NO_FLAGS)))
+      mutt_str_atoi(line, &status);
+    if ((line = mutt_file_read_line(line, &linelen, fp, NULL, MUTT_RL_NO_FLAGS)))
+      error = mutt_str_dup(line);
+    FREE(&line);
+    mutt_file_fclose(&fp);
+    unlink(buf_string(path));
+  }
+  buf_pool_release(&path);
+
+  oe->pid = 0;
+
+  if (status == 0)
+  {
+    trace_counter("outbox_sent", 1);
+    log_debug1("outbox: sent %s after %d failures", oe->id, oe->attempts);
+    outbox_save_fcc(oe);
+    log_message(_("Queued message to %s sent"), NONULL(oe->to));
+    outbox_entry_remove(oe);
+    close(lock);
+    FREE(&error);
+    return;
+  }
+
+  trace_counter("outbox_failed", 1);
+  oe->attempts++;
+  FREE(&oe->error);
+  oe->error = error ? error : mutt_str_dup(_("Delivery failed"));
+
+  const short c_outbox_retry_max = cs_subset_number(SpaceMutt->sub, "outbox_retry_max");
+  if ((c_outbox_retry_max > 0) && (oe->attempts >= c_outbox_retry_max))
+  {
+    oe->state = OUTBOX_FAILED;
+    oe->next_try = 0;
+    log_fault(_("Couldn't send message to %s: %s"), NONULL(oe->to), oe->error);
+  }
+  else
+  {
+    const short c_outbox_retry_delay = cs_subset_number(SpaceMutt->sub, "outbox_retry_delay");
+    oe->state = OUTBOX_WAITING;
+    oe->next_try = mutt_date_now() + outbox_backoff(oe->attempts, c_outbox_retry_delay);
+  }
+
+  log_debug1("outbox: %s failed, attempt %d: %s", oe->id, oe->attempts, oe->error);
+  outbox_entry_save(oe);
+  close(lock);
+}
+
+/**
+ * outbox_start - Start a worker to send a message
+ * @param oe Outbox entry
+ * @retval true A worker was started
+ *
+ * The entry is read again first, in case another SpaceMutt has sent it.
+ */
+static bool outbox_start(struct OutboxEntry *oe)
+{
+  const int lock = outbox_lock(oe);
+  if (lock < 0)
+  {
+    /* Another SpaceMutt is sending it, or has sent it */
+    if (!outbox_entry_refresh(oe))
+      outbox_entry_forget(oe);
+    return false;
+  }
+
+  if (!outbox_entry_refresh(oe))
+  {
+    close(lock);
+    outbox_entry_forget(oe);
+    return false;
+  }
+
+  /* A worker has finished, but its result wasn't processed */
+  if ((oe->state == OUTBOX_SENDING) || outbox_has_result(oe))
+  {
+    close(lock);
+    outbox_finish(oe);
+    return false;
+  }
+
+  if ((oe->state != OUTBOX_WAITING) || (oe->next_try > mutt_date_now()))
+  {
+    close(lock);
+    return false;
+  }
+
+  oe->state = OUTBOX_SENDING;
+  oe->started = mutt_date_now();
+
+  fflush(NULL);
+  pid_t pid = fork();
+  if (pid == 0)
+    outbox_worker(oe);
+
+  if (pid < 0)
+  {
+    log_perror(_("Can't start sending queued message"));
+    oe->state = OUTBOX_WAITING;
+    oe->next_try = mutt_date_now() + outbox_backoff(1, 60);
+    outbox_entry_save(oe);
+    close(lock);
+    return false;
+  }
+
+  /* The worker holds the lock now */
+  oe->pid = pid;
+  outbox_entry_save(oe);
+  close(lock);
+  log_debug1("outbox: sending %s, attempt %d, pid %d", oe->id, oe->attempts + 1, pid);
+  return true;
+}
+
+/**
+ * outbox_reap - Check on a worker
+ * @param oe Outbox entry
+ * @retval true The worker may have finished, see outbox_finish()
+ */
+static bool outbox_reap(struct OutboxEntry *oe)
+{
+  if (oe->pid <= 0)
+    return true;
+
+  int status = 0;
+  pid_t pid = waitpid(oe->pid, &status, WNOHANG);
+  if (pid == oe->pid)
+    return true;
+
+  const bool stuck = ((mutt_date_now() - oe->started) > OUTBOX_WORKER_TIMEOUT);
+
+  /* The worker was started by another SpaceMutt */
+  if ((pid < 0) && (errno == ECHILD))
+    return stuck || (kill(oe->pid, 0) != 0);
+
+  if (stuck)
+  {
+    log_debug1("outbox: worker %d for %s is stuck", oe->pid, oe->id);
+    kill(oe->pid, SIGTERM);
+    waitpid(oe->pid, &status, 0);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * outbox_run - Send the messages that are due
+ *
+ * Finished workers are processed and, if no worker is running, the next
+ * message that's due is sent.  Only one message is sent at a time.
+ */
+void outbox_run(void)
+{
+  if (!OutboxLoaded)
+    outbox_load();
+
+  if (ARRAY_EMPTY(&Outbox) || OutboxRunning)
+    return;
+
+  OutboxRunning = true;
+  bool busy = false;
+  for (size_t i = 0; i < ARRAY_SIZE(&Outbox);)
+  {
+    struct OutboxEntry *oe = *ARRAY_GET(&Outbox, i);
+    if ((oe->state == OUTBOX_SENDING) && outbox_reap(oe))
+    {
+      const size_t count = ARRAY_SIZE(&Outbox);
+      outbox_finish(oe);
+      if (ARRAY_SIZE(&Outbox) < count)
+        continue; // The entry was removed
+    }
+    if (oe->state == OUTBOX_SENDING)
+      busy = true;
+    i++;
+  }
+
+  const time_t now = mutt_date_now();
+  for (size_t i = 0; !busy && (i < ARRAY_SIZE(&Outbox));)
+  {
+    struct OutboxEntry *oe = *ARRAY_GET(&Outbox, i);
+    if ((oe->state == OUTBOX_WAITING) && (oe->next_try <= now))
+    {
+      if (!outbox_login())
+        break;
+
+      const size_t count = ARRAY_SIZE(&Outbox);
+      if (outbox_start(oe))
+        break;
+      if (ARRAY_SIZE(&Outbox) < count)
+        continue; // The entry was removed
+    }
+    i++;
+  }
+
+  OutboxRunning = false;
+}
+
+/**
+ * outbox_timeout_observer - Notification that a timeout has occurred - Implements ::observer_t - @ingroup observer_api
+ */
+static int outbox_timeout_observer(struct NotifyCallback *nc)
+{
+  if (nc->event_type != NT_TIMEOUT)
+    return 0;
+
+  outbox_run();
+  return 0;
+}
+
+/**
+ * outbox_global_observer - Notification that a child process has exited - Implements ::observer_t - @ingroup observer_api
+ *
+ * A worker may have finished, so the next message can be sent straight away.
+ */
+static int outbox_global_observer(struct NotifyCallback *nc)
+{
+  if ((nc->event_type != NT_GLOBAL) || (nc->event_subtype != NT_GLOBAL_CHILD))
+    return 0;
+
+  outbox_run();
+  return 0;
+}
+
+/**
+ * outbox_enabled - Should messages be queued?
+ * @param sub Config Subset
+ * @retval true `$outbox` is set
+ */
+bool outbox_enabled(struct ConfigSubset *sub)
+{
+  return cs_subset_path(sub, "outbox") != NULL;
+}
+
+/**
+ * outbox_enqueue - Queue a message to be sent
+ * @param msgfile  File containing the message, as it will be sent
+ * @param env      Envelope of the message
+ * @param eightbit Message contains 8-bit data
+ * @param fcc      Folders to save a copy to, once it's sent (may be NULL)
+ * @param sub      Config Subset
+ * @retval  0 Success, the message is queued
+ * @retval -1 Error
+ */
+int outbox_enqueue(const char *msgfile, const struct Envelope *env,
+                   bool eightbit, const char *fcc, struct ConfigSubset *sub)
+{
+  const char *const c_outbox = cs_subset_path(sub, "outbox");
+  if (!c_outbox || !msgfile || !env)
+    return -1;
+
+  if (!OutboxLoaded)
+    outbox_load();
+
+  if (mutt_file_mkdir(c_outbox, S_IRWXU) != 0)
+  {
+    log_perror("%s", c_outbox);
+    return -1;
+  }
+
+  static unsigned int counter = 0;
+  const time_t now = mutt_date_now();
+  struct Buffer *id = buf_pool_get();
+  struct Buffer *path = buf_pool_get();
+  FILE *fp_in = NULL;
+  FILE *fp_out = NULL;
+  int rc = -1;
+
+  /* Create the message file, with a unique name */
+  int fd = -1;
+  for (int i = 0; (fd < 0) && (i < 100); i++)
+  {
+    buf_printf(id, "%lld-%d-%u", (long long) now, (int) getpid(), counter++);
+    outbox_file(path, buf_string(id), "msg");
+    fd = mutt_file_open(buf_string(path), O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if ((fd < 0) && (errno != EEXIST))
+      break;
+  }
+
+  fp_out = (fd < 0) ? NULL : fdopen(fd, "w");
+  fp_in = mutt_file_fopen(msgfile, "r");
+  if (!fp_out || !fp_in || (mutt_file_copy_stream(fp_in, fp_out) < 0) ||
+      (mutt_file_fclose(&fp_out) != 0))
+  {
+    log_perror("%s", buf_string(path));
+    if (fd >= 0)
+      unlink(buf_string(path));
+    goto done;
+  }
+
+  struct OutboxEntry *oe = g_new0(struct OutboxEntry, 1);
+  oe->id = buf_strdup(id);
+
+  struct Buffer *buf = buf_pool_get();
+  mutt_addrlist_write(env->from, buf, false);
+  oe->from = buf_strdup(buf);
+  buf_reset(buf);
+  mutt_addrlist_write(env->to, buf, false);
+  oe->to = buf_strdup(buf);
+  buf_reset(buf);
+  mutt_addrlist_write(env->cc, buf, false);
+  oe->cc = buf_strdup(buf);
+  buf_reset(buf);
+  mutt_addrlist_write(env->bcc, buf, false);
+  oe->bcc = buf_strdup(buf);
+  buf_pool_release(&buf);
+
+  /* The subject is only for display, so it mustn't break the .env file */
+  oe->subject = mutt_str_dup(env->subject);
+  if (oe->subject)
+    g_strdelimit(oe->subject, "\r\n", ' ');
+
+  oe->fcc = mutt_str_dup(fcc);
+  oe->eightbit = eightbit;
+  oe->state = OUTBOX_WAITING;
+  oe->queued = now;
+  oe->next_try = now;
+
+  if (outbox_entry_save(oe) != 0)
+  {
+    unlink(buf_string(path));
+    outbox_entry_free(&oe);
+    goto done;
+  }
+
+  ARRAY_ADD(&Outbox, oe);
+  trace_counter("outbox_queued", 1);
+  rc = 0;
+
+  outbox_run();
+
+done:
+  mutt_file_fclose(&fp_in);
+  mutt_file_fclose(&fp_out);
+  buf_pool_release(&id);
+  buf_pool_release(&path);
+  return rc;
+}
+
+/**
+ * outbox_entries - Get the queued messages
+ * @retval ptr Array of Outbox entries, oldest first
+ */
+struct OutboxEntryArray *outbox_entries(void)
+{
+  if (!OutboxLoaded)
+    outbox_load();
+
+  return &Outbox;
+}
+
+/**
+ * outbox_retry - Try to send a message now
+ * @param oe Outbox entry
+ */
+void outbox_retry(struct OutboxEntry *oe)
+{
+  if (!oe || (oe->state == OUTBOX_SENDING))
+    return;
+
+  const int lock = outbox_lock(oe);
+  if (lock >= 0)
+  {
+    if (outbox_entry_refresh(oe) && (oe->state != OUTBOX_SENDING) &&
+        !outbox_has_result(oe))
+    {
+      oe->state = OUTBOX_WAITING;
+      oe->next_try = 0;
+      outbox_entry_save(oe);
+    }
+    close(lock);
+  }
+  outbox_run();
+}
+
+/**
+ * outbox_cancel - Stop trying to send a message
+ * @param oe Outbox entry
+ * @retval  0 Success, the message was moved to `$postponed`, or deleted
+ * @retval -1 Error, e.g. the message is being sent
+ *
+ * If `$postponed` is set, the message is saved there, so that it can be
+ * recalled and sent again.
+ */
+int outbox_cancel(struct OutboxEntry *oe)
+{
+  if (!oe || (oe->state == OUTBOX_SENDING))
+    return -1;
+
+  /* Another SpaceMutt may be sending it */
+  const int lock = outbox_lock(oe);
+  if (lock < 0)
+    return -1;
+
+  if (!outbox_entry_refresh(oe) || (oe->state == OUTBOX_SENDING) || outbox_has_result(oe))
+  {
+    close(lock);
+    return -1;
+  }
+
+  const char *const c_postponed = cs_subset_string(SpaceMutt->sub, "postponed");
+  if (c_postponed)
+  {
+    struct Buffer *path = buf_pool_get();
+    buf_strcpy(path, c_postponed);
+    buf_expand_path(path);
+    const int rc = outbox_append(buf_string(path), oe, true);
+    buf_pool_release(&path);
+    if (rc != 0)
+    {
+      close(lock);
+      return -1;
+    }
+    mutt_update_num_postponed();
+  }
+
+  outbox_entry_remove(oe);
+  close(lock);
+  return 0;
+}
+
+/**
+ * outbox_init - Start sending any queued messages
+ */
+void outbox_init(void)
+{
+  notify_observer_add(SpaceMutt->notify_timeout, NT_TIMEOUT, outbox_timeout_observer, NULL);
+  notify_observer_add(SpaceMutt->notify, NT_GLOBAL, outbox_global_observer, NULL);
+  outbox_run();
+}
+
+/**
+ * outbox_cleanup - Free the Outbox
+ *
+ * Running workers are left to finish.  Their results are processed by the
+ * next SpaceMutt.
+ */
+void outbox_cleanup(void)
+{
+  if (SpaceMutt)
+  {
+    notify_observer_remove(SpaceMutt->notify_timeout, outbox_timeout_observer, NULL);
+    notify_observer_remove(SpaceMutt->notify, outbox_global_observer, NULL);
+  }
+
+  struct OutboxEntry **oep = NULL;
+  ARRAY_FOREACH(oep, &Outbox)
+  {
+    outbox_entry_free(oep);
+  }
+  ARRAY_FREE(&Outbox);
+  OutboxLoaded = false;
+  outbox_logout();
+}
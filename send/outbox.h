@@ -0,0 +1,86 @@
+/**
+ * @file
+ * Queue of messages waiting to be sent
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_SEND_OUTBOX_H
+#define MUTT_SEND_OUTBOX_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <time.h>
+#include "mutt/lib.h"
+
+struct ConfigSubset;
+struct Envelope;
+
+/**
+ * enum OutboxState - State of a queued message
+ */
+enum OutboxState
+{
+  OUTBOX_WAITING,  ///< Waiting for its next attempt
+  OUTBOX_SENDING,  ///< Being sent by a worker process
+  OUTBOX_FAILED,   ///< Gave up after `$outbox_retry_max` attempts
+};
+
+/**
+ * struct OutboxEntry - A message in the Outbox
+ *
+ * The message is stored in `$outbox` as `<id>.msg`, exactly as it will be
+ * sent.  Everything else is stored in `<id>.env`.
+ */
+struct OutboxEntry
+{
+  char *id;               ///< Unique name of the spool files
+  char *from;             ///< Envelope sender
+  char *to;               ///< 'To' recipients
+  char *cc;               ///< 'Cc' recipients
+  char *bcc;              ///< 'Bcc' recipients
+  char *subject;          ///< Subject, for display
+  char *fcc;              ///< Folders to save a copy to, once it's sent
+  char *error;            ///< Why the last attempt failed
+  bool eightbit;          ///< Message contains 8-bit data
+  enum OutboxState state; ///< State, e.g. #OUTBOX_WAITING
+  int attempts;           ///< Number of failed attempts
+  time_t queued;          ///< When the message was queued
+  time_t next_try;        ///< When to try sending it again
+  time_t started;         ///< When the worker was started
+  pid_t pid;              ///< Worker process, if #OUTBOX_SENDING
+};
+ARRAY_HEAD(OutboxEntryArray, struct OutboxEntry *);
+
+bool                     outbox_enabled (struct ConfigSubset *sub);
+int                      outbox_enqueue (const char *msgfile, const struct Envelope *env, bool eightbit, const char *fcc, struct ConfigSubset *sub);
+struct OutboxEntryArray *outbox_entries (void);
+void                     outbox_run     (void);
+void                     outbox_retry   (struct OutboxEntry *oe);
+int                      outbox_cancel  (struct OutboxEntry *oe);
+int                      outbox_backoff (int attempts, int delay);
+
+void                outbox_entry_free(struct OutboxEntry **ptr);
+struct OutboxEntry *outbox_entry_load(const char *id);
+int                 outbox_entry_save(const struct OutboxEntry *oe);
+void                     outbox_init    (void);
+void                     outbox_cleanup (void);
+
+void dlg_outbox(void);
+
+#endif /* MUTT_SEND_OUTBOX_H */
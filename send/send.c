@@ -85,6 +85,7 @@
 #include "muttlib.h"
 #include "mx.h"
 #include "nntp/mdata.h"
+#include "outbox.h"
 #include "protos.h"
 #include "rfc3676.h"
 #include "sendlib.h"
@@ -936,6 +937,8 @@ static int default_to(AddressList *to, struct Envelope *env,
 int mutt_fetch_recips(struct Envelope *out, struct Envelope *in,
                       SendFlags flags, struct ConfigSubset *sub)
 {
+  mutt_env_materialize(in);
+
   enum QuadOption hmfupto = MUTT_ABORT;
   const struct Address *followup_to = g_queue_peek_head(in->mail_followup_to);
 
@@ -1483,13 +1486,17 @@ struct Address *mutt_default_from(struct ConfigSubset *sub)
 
 /**
  * invoke_mta - Send an email
- * @param m   Mailbox
- * @param e   Email
- * @param sub Config Subset
+ * @param m     Mailbox
+ * @param e     Email
+ * @param queue Queue the email in `$outbox`, rather than sending it
+ * @param fcc   Folders to save a copy to, once a queued email is sent
+ * @param sub   Config Subset
  * @retval  0 Success
+ * @retval >0 Sending in the background, or queued
  * @retval -1 Failure
  */
-static int invoke_mta(struct Mailbox *m, struct Email *e, struct ConfigSubset *sub)
+static int invoke_mta(struct Mailbox *m, struct Email *e, bool queue,
+                      const char *fcc, struct ConfigSubset *sub)
 {
   struct Buffer *tempfile = NULL;
   int rc = -1;
@@ -1526,6 +1533,16 @@ static int invoke_mta(struct Mailbox *m, struct Email *e, struct ConfigSubset *s
   if (OptNewsSend)
     goto sendmail;
 
+  if (queue)
+  {
+    rc = outbox_enqueue(buf_string(tempfile), e->env,
+                        (e->body->encoding == ENC_8BIT), fcc, sub);
+    unlink(buf_string(tempfile));
+    if (rc == 0)
+      rc = 1;
+    goto cleanup;
+  }
+
   if (c_smtp_url)
   {
     rc = mutt_smtp_send(e->env->from, e->env->to, e->env->cc, e->env->bcc,
@@ -1712,6 +1729,26 @@ static bool search_attach_keyword(char *filename, struct ConfigSubset *sub)
   return found;
 }
 
+/**
+ * fcc_is_altered - Will the Fcc copy differ from the message that's sent?
+ * @param e   Email to save
+ * @param sub Config Subset
+ * @retval true `$fcc_clear` or `$fcc_attach` will change the copy
+ *
+ * The Outbox can only save a copy of the message exactly as it was sent.
+ */
+static bool fcc_is_altered(const struct Email *e, struct ConfigSubset *sub)
+{
+  if ((WithCrypto != 0) && (e->security & (SEC_ENCRYPT | SEC_SIGN | SEC_AUTOCRYPT)) &&
+      cs_subset_bool(sub, "fcc_clear"))
+  {
+    return true;
+  }
+
+  return (e->body->type == TYPE_MULTIPART) &&
+         (cs_subset_quad(sub, "fcc_attach") != MUTT_YES);
+}
+
 /**
  * save_fcc - Save an Email to a 'sent mail' folder
  * @param[in]  m             Current Mailbox
@@ -2203,6 +2240,9 @@ int mutt_send_message(SendFlags flags, struct Email *e_templ, const char *tempfi
       e_templ->env = mutt_env_new();
   }
 
+  if (e_cur)
+    mutt_env_materialize(e_cur->env);
+
   /* Parse and use an eventual list-post header */
   if ((flags & SEND_LIST_REPLY) && e_cur && e_cur->env && e_cur->env->list_post)
   {
@@ -2833,11 +2873,15 @@ int mutt_send_message(SendFlags flags, struct Email *e_templ, const char *tempfi
 
   mutt_prepare_envelope(e_templ->env, true, sub);
 
+  /* A queued message is saved to $record once it's been sent, unless the copy
+   * needs to be changed by $fcc_clear or $fcc_attach */
+  const bool queue = !(flags & (SEND_BATCH | SEND_NEWS)) && outbox_enabled(sub);
   const bool c_fcc_before_send = cs_subset_bool(sub, "fcc_before_send");
+  const bool fcc_queued = queue && !c_fcc_before_send && !fcc_is_altered(e_templ, sub);
   if (c_fcc_before_send)
     save_fcc(m, e_templ, fcc, clear_content, pgpkeylist, flags, &finalpath, sub);
 
-  i = invoke_mta(m, e_templ, sub);
+  i = invoke_mta(m, e_templ, queue, fcc_queued ? buf_string(fcc) : NULL, sub);
   if (i < 0)
   {
     if (!(flags & SEND_BATCH))
@@ -2880,12 +2924,13 @@ int mutt_send_message(SendFlags flags, struct Email *e_templ, const char *tempfi
     }
   }
 
-  if (!c_fcc_before_send)
+  if (!c_fcc_before_send && !fcc_queued)
     save_fcc(m, e_templ, fcc, clear_content, pgpkeylist, flags, &finalpath, sub);
 
   if (!OptNoCurses)
   {
-    log_message((i != 0)            ? _("Sending in background") :
+    log_message(queue               ? _("Message queued") :
+                (i != 0)            ? _("Sending in background") :
                  (flags & SEND_NEWS) ? _("Article posted") :
                                        _("Mail sent"));
 #ifdef USE_NOTMUCH
@@ -3012,6 +3057,7 @@ bool mutt_send_list_subscribe(struct Mailbox *m, struct Email *e)
     return false;
   }
 
+  mutt_env_materialize(e->env);
   const char *mailto = e->env->list_subscribe;
   if (!mailto)
   {
@@ -3041,6 +3087,7 @@ bool mutt_send_list_unsubscribe(struct Mailbox *m, struct Email *e)
     return false;
   }
 
+  mutt_env_materialize(e->env);
   const char *mailto = e->env->list_unsubscribe;
   if (!mailto)
   {
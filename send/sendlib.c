@@ -1007,7 +1007,7 @@ int mutt_write_multiple_fcc(const char *path, struct Email *e, const char *msgid
 
   mutt_str_copy(fcc_tok, path, sizeof(fcc_tok));
 
-  char *tok = strtok(fcc_tok, ",");
+  char *tok = strtok(fcc_tok, FCC_DELIMITER);
   if (!tok)
     return -1;
 
@@ -1018,7 +1018,7 @@ int mutt_write_multiple_fcc(const char *path, struct Email *e, const char *msgid
     return status;
 
   struct Buffer *fcc_expanded = buf_pool_get();
-  while ((tok = strtok(NULL, ",")))
+  while ((tok = strtok(NULL, FCC_DELIMITER)))
   {
     if (*tok == '\0')
       continue;
@@ -1223,7 +1223,8 @@ int mutt_write_fcc(const char *path, struct Email *e, const char *msgid, bool po
 
     /* copy the body and clean up */
     rewind(fp_tmp);
-    rc = mutt_file_copy_stream(fp_tmp, msg->fp);
+    const ssize_t bytes = mutt_file_copy_stream(fp_tmp, msg->fp);
+    rc = (bytes < 0) ? -1 : 0;
     if (mutt_file_fclose(&fp_tmp) != 0)
       rc = -1;
     /* if there was an error, leave the temp version */
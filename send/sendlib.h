@@ -33,6 +33,9 @@ struct Mailbox;
 
 #define MUTT_RANDTAG_LEN 16
 
+/// Separates the folders of an Fcc, e.g. "=sent,=archive"
+#define FCC_DELIMITER ","
+
 int              mutt_bounce_message     (FILE *fp, struct Mailbox *m, struct Email *e, AddressList *to, struct ConfigSubset *sub);
 const char *     mutt_fqdn               (bool may_hide_host, const struct ConfigSubset *sub);
 enum ContentType mutt_lookup_mime_type   (struct Body *b, const char *path);
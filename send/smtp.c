@@ -1201,3 +1201,55 @@ int mutt_smtp_send(const AddressList *from, const AddressList *to,
   buf_pool_release(&buf);
   return rc;
 }
+
+/**
+ * mutt_smtp_login - Log in to the SMTP server, without sending a message
+ * @param[in]  sub Config Subset
+ * @param[out] cac Account, including any password the user typed
+ * @retval  0 Success
+ * @retval -1 Error
+ *
+ * Any questions, e.g. for a password, or whether to trust the server's
+ * certificate, are asked now.  This lets a process without a terminal send
+ * messages later.
+ */
+int mutt_smtp_login(struct ConfigSubset *sub, struct ConnAccount *cac)
+{
+  struct SmtpAccountData adata = { 0 };
+
+  adata.sub = sub;
+  adata.fqdn = mutt_fqdn(false, adata.sub);
+  if (!adata.fqdn)
+    adata.fqdn = NONULL(ShortHostname);
+
+  if (smtp_fill_account(&adata, cac) < 0)
+    return -1;
+
+  adata.conn = mutt_conn_find(cac);
+  if (!adata.conn)
+    return -1;
+
+  int rc = smtp_open(&adata, false);
+  FREE(&adata.auth_mechs);
+  if (rc == 0)
+  {
+    mutt_socket_send(adata.conn, "QUIT\r\n");
+    *cac = adata.conn->account;
+  }
+
+  mutt_socket_close(adata.conn);
+  FREE(&adata.conn);
+
+  /* The account outlives adata */
+  cac->get_field = NULL;
+  cac->gf_data = NULL;
+
+  if (rc == SMTP_ERR_READ)
+    log_fault(_("SMTP session failed: read error"));
+  else if (rc == SMTP_ERR_WRITE)
+    log_fault(_("SMTP session failed: write error"));
+  else if (rc == SMTP_ERR_CODE)
+    log_fault(_("Invalid server response"));
+
+  return (rc == 0) ? 0 : -1;
+}
@@ -28,10 +28,12 @@
 #include <stdbool.h>
 
 struct ConfigSubset;
+struct ConnAccount;
 
 bool smtp_auth_is_valid(const char *authenticator);
 int mutt_smtp_send(const AddressList *from, const AddressList *to,
                    const AddressList *cc, const AddressList *bcc,
                    const char *msgfile, bool eightbit, struct ConfigSubset *sub);
+int mutt_smtp_login(struct ConfigSubset *sub, struct ConnAccount *cac);
 
 #endif /* MUTT_SEND_SMTP_H */
@@ -248,6 +248,8 @@ static int sb_command_observer(struct NotifyCallback *nc)
     return 0;
 
   struct MuttWindow *win = nc->global_data;
+  struct SidebarWindowData *wdata = sb_wdata_get(win);
+  wdata->all_dirty = true;
   win->actions |= WA_RECALC;
   log_debug5("command done, request WA_RECALC");
   return 0;
@@ -327,12 +329,15 @@ static int sb_config_observer(struct NotifyCallback *nc)
   {
     struct SidebarWindowData *wdata = sb_wdata_get(win);
     calc_divider(wdata);
+    wdata->all_dirty = true;
     win->actions |= WA_RECALC;
     log_debug5("config done, request WA_RECALC");
     return 0;
   }
 
   // All the remaining config changes...
+  struct SidebarWindowData *wdata = sb_wdata_get(win);
+  wdata->all_dirty = true;
   win->actions |= WA_RECALC;
   log_debug5("config done, request WA_RECALC");
   return 0;
@@ -355,6 +360,7 @@ static int sb_index_observer(struct NotifyCallback *nc)
 
   struct SidebarWindowData *wdata = sb_wdata_get(win_sidebar);
   sb_set_current_mailbox(wdata, shared->mailbox);
+  wdata->all_dirty = true;
 
   win_sidebar->actions |= WA_RECALC;
   log_debug5("index done, request WA_RECALC");
@@ -385,6 +391,10 @@ static int sb_mailbox_observer(struct NotifyCallback *nc)
   {
     sb_remove_mailbox(wdata, ev_m->mailbox);
   }
+  else
+  {
+    sb_entry_changed(wdata, ev_m->mailbox);
+  }
 
   win->actions |= WA_RECALC;
   log_debug5("mailbox done, request WA_RECALC");
@@ -408,6 +418,8 @@ static int sb_window_observer(struct NotifyCallback *nc)
 
   if (nc->event_subtype == NT_WINDOW_STATE)
   {
+    struct SidebarWindowData *wdata = sb_wdata_get(win);
+    wdata->all_dirty = true;
     win->actions |= WA_RECALC;
     log_debug5("window state done, request WA_RECALC");
   }
@@ -45,6 +45,9 @@ struct SbEntry
   int depth;                      ///< Indentation depth
   struct Mailbox *mailbox;        ///< Mailbox this represents
   bool is_hidden;                 ///< Don't show, e.g. $sidebar_new_mail_only
+  bool dirty;                     ///< Entry is in SidebarWindowData.changed
+  bool box_valid;                 ///< box and depth are up to date
+  int display_width;              ///< Width display was rendered at, 0 if it's stale
   const struct AttrColor *color;  ///< Colour to use
 };
 ARRAY_HEAD(SbEntryArray, struct SbEntry *);
@@ -90,6 +93,8 @@ struct SidebarWindowData
   struct MuttWindow *win;                 ///< Sidebar Window
   struct IndexSharedData *shared;         ///< Shared Index Data
   struct SbEntryArray entries;            ///< Items to display in the sidebar
+  GHashTable *lookup;                     ///< Mailbox -> SbEntry, for notifications
+  struct SbEntryArray changed;            ///< Entries whose Mailbox has changed
 
   int top_index;             ///< First mailbox visible in sidebar
   int opn_index;             ///< Current (open) mailbox
@@ -97,12 +102,15 @@ struct SidebarWindowData
   int bot_index;             ///< Last mailbox visible in sidebar
 
   short previous_sort;       ///< Old `$sidebar_sort_method`
+  bool all_dirty;            ///< Every entry must be recalculated, e.g. config has changed
+  bool resort;               ///< Entries must be fully sorted, e.g. one was added
   enum DivType divider_type; ///< Type of divider to use, e.g. #SB_DIV_ASCII
   short divider_width;       ///< Width of the divider in screen columns
 };
 
 // sidebar.c
 void sb_add_mailbox        (struct SidebarWindowData *wdata, struct Mailbox *m);
+void sb_entry_changed      (struct SidebarWindowData *wdata, const struct Mailbox *m);
 void sb_remove_mailbox     (struct SidebarWindowData *wdata, const struct Mailbox *m);
 void sb_set_current_mailbox(struct SidebarWindowData *wdata, struct Mailbox *m);
 struct Mailbox *sb_get_highlight(struct MuttWindow *win);
@@ -120,7 +128,8 @@ int sb_insertion_window_observer(struct NotifyCallback *nc);
 void sb_win_add_observers(struct MuttWindow *win);
 
 // sort.c
-void sb_sort_entries(struct SidebarWindowData *wdata, enum SortType sort);
+void sb_sort_entries   (struct SidebarWindowData *wdata, enum SortType sort);
+bool sb_sort_reposition(struct SidebarWindowData *wdata, enum SortType sort);
 
 // wdata.c
 void                      sb_wdata_free(struct MuttWindow *win, void **ptr);
@@ -77,6 +77,21 @@ struct Mailbox *sb_get_highlight(struct MuttWindow *win)
   return (*sbep)->mailbox;
 }
 
+/**
+ * entry_mark_dirty - Queue a Sidebar entry to be recalculated
+ * @param wdata Sidebar data
+ * @param sbe   Entry that has changed
+ */
+static void entry_mark_dirty(struct SidebarWindowData *wdata, struct SbEntry *sbe)
+{
+  sbe->box_valid = false;
+  if (sbe->dirty)
+    return;
+
+  sbe->dirty = true;
+  ARRAY_ADD(&wdata->changed, sbe);
+}
+
 /**
  * sb_add_mailbox - Add a Mailbox to the Sidebar
  * @param wdata Sidebar data
@@ -90,12 +105,8 @@ void sb_add_mailbox(struct SidebarWindowData *wdata, struct Mailbox *m)
   if (!m)
     return;
 
-  struct SbEntry **sbep = NULL;
-  ARRAY_FOREACH(sbep, &wdata->entries)
-  {
-    if ((*sbep)->mailbox == m)
-      return;
-  }
+  if (g_hash_table_contains(wdata->lookup, m))
+    return;
 
   /* Any new/deleted mailboxes will cause a refresh.  As long as
    * they're valid, our pointers will be updated in prepare_sidebar() */
@@ -103,6 +114,9 @@ void sb_add_mailbox(struct SidebarWindowData *wdata, struct Mailbox *m)
   struct IndexSharedData *shared = wdata->shared;
   struct SbEntry *entry = g_new0(struct SbEntry, 1);
   entry->mailbox = m;
+  g_hash_table_insert(wdata->lookup, m, entry);
+  entry_mark_dirty(wdata, entry);
+  wdata->resort = true;
 
   if (wdata->top_index < 0)
     wdata->top_index = ARRAY_SIZE(&wdata->entries);
@@ -117,6 +131,22 @@ void sb_add_mailbox(struct SidebarWindowData *wdata, struct Mailbox *m)
   ARRAY_ADD(&wdata->entries, entry);
 }
 
+/**
+ * sb_entry_changed - A Mailbox has changed
+ * @param wdata Sidebar data
+ * @param m     Mailbox, NULL if unknown
+ *
+ * Only the changed entry will be recalculated by sb_recalc().
+ */
+void sb_entry_changed(struct SidebarWindowData *wdata, const struct Mailbox *m)
+{
+  struct SbEntry *sbe = m ? g_hash_table_lookup(wdata->lookup, m) : NULL;
+  if (sbe)
+    entry_mark_dirty(wdata, sbe);
+  else
+    wdata->all_dirty = true;
+}
+
 /**
  * sb_remove_mailbox - Remove a Mailbox from the Sidebar
  * @param wdata Sidebar data
@@ -131,6 +161,19 @@ void sb_remove_mailbox(struct SidebarWindowData *wdata, const struct Mailbox *m)
       continue;
 
     struct SbEntry *sbe_remove = *sbep;
+    g_hash_table_remove(wdata->lookup, m);
+    if (sbe_remove->dirty)
+    {
+      struct SbEntry **sbep_changed = NULL;
+      ARRAY_FOREACH(sbep_changed, &wdata->changed)
+      {
+        if (*sbep_changed == sbe_remove)
+        {
+          ARRAY_REMOVE(&wdata->changed, sbep_changed);
+          break;
+        }
+      }
+    }
     ARRAY_REMOVE(&wdata->entries, sbep);
     FREE(&sbe_remove);
 
@@ -30,6 +30,7 @@
 
 #include "config.h"
 #include <stdbool.h>
+#include <string.h>
 #include "private.h"
 #include "mutt/lib.h"
 #include "config/lib.h"
@@ -158,6 +159,32 @@ static int sb_sort_unsorted(const void *a, const void *b, void *sdata)
   return (sbe1->mailbox->gen - sbe2->mailbox->gen);
 }
 
+/**
+ * sb_sort_fn - Get the compare function for a sort order
+ * @param sort Sort order, e.g. #SORT_PATH
+ * @retval fn Compare function
+ */
+static sort_t sb_sort_fn(enum SortType sort)
+{
+  switch (sort & SORT_MASK)
+  {
+    case SORT_COUNT:
+      return sb_sort_count;
+    case SORT_DESC:
+      return sb_sort_desc;
+    case SORT_FLAGGED:
+      return sb_sort_flagged;
+    case SORT_PATH:
+      return sb_sort_path;
+    case SORT_UNREAD:
+      return sb_sort_unread;
+    case SORT_ORDER:
+      return sb_sort_order;
+    default:
+      return sb_sort_unsorted;
+  }
+}
+
 /**
  * sb_sort_entries - Sort the Sidebar entries
  * @param wdata Sidebar data
@@ -171,32 +198,78 @@ static int sb_sort_unsorted(const void *a, const void *b, void *sdata)
  */
 void sb_sort_entries(struct SidebarWindowData *wdata, enum SortType sort)
 {
-  sort_t fn = sb_sort_unsorted;
+  sort_t fn = sb_sort_fn(sort);
+  bool sort_reverse = (sort & SORT_REVERSE);
+  ARRAY_SORT(&wdata->entries, fn, &sort_reverse);
+}
 
-  switch (sort & SORT_MASK)
+/**
+ * sb_sort_reposition - Move the changed entries to their sorted positions
+ * @param wdata Sidebar data
+ * @param sort  Sort order, e.g. #SORT_PATH
+ * @retval true The order of the entries has changed
+ *
+ * The changed entries, `wdata->changed`, are taken out of the list.  The clean
+ * entries that remain are still in order, so each changed entry can be put
+ * back at the position found by a binary search.
+ *
+ * Only the orders that depend on the Mailbox's counts can move an entry.
+ */
+bool sb_sort_reposition(struct SidebarWindowData *wdata, enum SortType sort)
+{
+  const enum SortType method = sort & SORT_MASK;
+  if ((method != SORT_COUNT) && (method != SORT_FLAGGED) && (method != SORT_UNREAD))
+    return false;
+
+  const size_t count = ARRAY_SIZE(&wdata->entries);
+  if ((count == 0) || ARRAY_EMPTY(&wdata->changed))
+    return false;
+
+  struct SbEntry **base = ARRAY_GET(&wdata->entries, 0);
+  struct SbEntry **old = g_malloc(count * sizeof(*base));
+  memcpy(old, base, count * sizeof(*base));
+
+  /* Take out the changed entries, keeping the order of the rest */
+  size_t clean = 0;
+  for (size_t i = 0; i < count; i++)
   {
-    case SORT_COUNT:
-      fn = sb_sort_count;
-      break;
-    case SORT_DESC:
-      fn = sb_sort_desc;
-      break;
-    case SORT_FLAGGED:
-      fn = sb_sort_flagged;
-      break;
-    case SORT_PATH:
-      fn = sb_sort_path;
-      break;
-    case SORT_UNREAD:
-      fn = sb_sort_unread;
-      break;
-    case SORT_ORDER:
-      fn = sb_sort_order;
-      FALLTHROUGH;
-    default:
-      break;
+    if (!old[i]->dirty)
+      base[clean++] = old[i];
+  }
+
+  if ((clean + ARRAY_SIZE(&wdata->changed)) != count)
+  {
+    /* The changed list doesn't match the entries, so start again */
+    memcpy(base, old, count * sizeof(*base));
+    FREE(&old);
+    sb_sort_entries(wdata, sort);
+    return true;
   }
 
+  sort_t fn = sb_sort_fn(sort);
   bool sort_reverse = (sort & SORT_REVERSE);
-  ARRAY_SORT(&wdata->entries, fn, &sort_reverse);
+
+  /* Binary search the sorted entries for each changed entry's position */
+  struct SbEntry **sbep = NULL;
+  ARRAY_FOREACH(sbep, &wdata->changed)
+  {
+    size_t lo = 0;
+    size_t hi = clean;
+    while (lo < hi)
+    {
+      const size_t mid = lo + (hi - lo) / 2;
+      if (fn(&base[mid], sbep, &sort_reverse) <= 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+    memmove(base + lo + 1, base + lo, (clean - lo) * sizeof(*base));
+    base[lo] = *sbep;
+    clean++;
+  }
+
+  const bool moved = (memcmp(old, base, count * sizeof(*base)) != 0);
+  FREE(&old);
+  return moved;
 }
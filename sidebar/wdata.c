@@ -29,6 +29,7 @@
 
 #include "config.h"
 #include <stddef.h>
+#include <glib.h>
 #include "private.h"
 #include "mutt/lib.h"
 #include "gui/lib.h"
@@ -47,6 +48,9 @@ struct SidebarWindowData *sb_wdata_new(struct MuttWindow *win, struct IndexShare
   wdata->win = win;
   wdata->shared = shared;
   ARRAY_INIT(&wdata->entries);
+  ARRAY_INIT(&wdata->changed);
+  wdata->lookup = g_hash_table_new(g_direct_hash, g_direct_equal);
+  wdata->all_dirty = true;
   return wdata;
 }
 
@@ -66,6 +70,8 @@ void sb_wdata_free(struct MuttWindow *win, void **ptr)
     FREE(sbep);
   }
   ARRAY_FREE(&wdata->entries);
+  ARRAY_FREE(&wdata->changed);
+  g_hash_table_destroy(wdata->lookup);
 
   FREE(ptr);
 }
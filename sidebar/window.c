@@ -616,10 +616,12 @@ static void make_sidebar_entry(char *buf, size_t buflen, int width,
 }
 
 /**
- * update_entries_visibility - Should a SbEntry be displayed in the sidebar?
- * @param wdata Sidebar data
+ * update_entry_visibility - Should a SbEntry be displayed in the sidebar?
+ * @param wdata   Sidebar data
+ * @param sbe     Sidebar entry
+ * @param is_open true, if this is the open Mailbox
  *
- * For each SbEntry in the entries array, check whether we should display it.
+ * Check whether we should display the SbEntry.
  * This is determined by several criteria.  If the Mailbox:
  * * is the currently open mailbox
  * * is the currently highlighted mailbox
@@ -627,55 +629,101 @@ static void make_sidebar_entry(char *buf, size_t buflen, int width,
  * * has flagged messages
  * * is pinned
  */
-static void update_entries_visibility(struct SidebarWindowData *wdata)
+static void update_entry_visibility(struct SidebarWindowData *wdata,
+                                    struct SbEntry *sbe, bool is_open)
 {
-  /* Aliases for readability */
   const bool c_sidebar_new_mail_only = cs_subset_bool(SpaceMutt->sub, "sidebar_new_mail_only");
   const bool c_sidebar_non_empty_mailbox_only = cs_subset_bool(SpaceMutt->sub, "sidebar_non_empty_mailbox_only");
-  struct SbEntry *sbe = NULL;
-
   struct IndexSharedData *shared = wdata->shared;
-  struct SbEntry **sbep = NULL;
-  ARRAY_FOREACH(sbep, &wdata->entries)
+
+  sbe->is_hidden = false;
+
+  if (!sbe->mailbox->visible)
   {
-    int i = ARRAY_FOREACH_IDX;
-    sbe = *sbep;
+    sbe->is_hidden = true;
+    return;
+  }
 
-    sbe->is_hidden = false;
+  if (shared->mailbox && mutt_str_equal(sbe->mailbox->realpath, shared->mailbox->realpath))
+  {
+    /* Spool directories are always visible */
+    return;
+  }
 
-    if (!sbe->mailbox->visible)
-    {
-      sbe->is_hidden = true;
-      continue;
-    }
+  if (g_slist_find_str(SidebarPinned, mailbox_path(sbe->mailbox), false) ||
+      g_slist_find_str(SidebarPinned, sbe->mailbox->name, false))
+  {
+    /* Explicitly asked to be visible */
+    return;
+  }
 
-    if (shared->mailbox &&
-        mutt_str_equal(sbe->mailbox->realpath, shared->mailbox->realpath))
-    {
-      /* Spool directories are always visible */
-      continue;
-    }
+  if (c_sidebar_non_empty_mailbox_only && !is_open && (sbe->mailbox->msg_count == 0))
+  {
+    sbe->is_hidden = true;
+  }
 
-    if (g_slist_find_str(SidebarPinned, mailbox_path(sbe->mailbox), false) ||
-        g_slist_find_str(SidebarPinned, sbe->mailbox->name, false))
+  if (c_sidebar_new_mail_only && !is_open && (sbe->mailbox->msg_unread == 0) &&
+      (sbe->mailbox->msg_flagged == 0) && !sbe->mailbox->has_new)
+  {
+    sbe->is_hidden = true;
+  }
+}
+
+/**
+ * update_entries - Recalculate the entries that have changed
+ * @param wdata     Sidebar data
+ * @param opn_entry Entry of the open Mailbox
+ * @param sort      Sort order, e.g. #SORT_PATH
+ * @retval true The order of the entries has changed
+ *
+ * Normally only the entries whose Mailbox has changed are checked for
+ * visibility and moved to their sorted position.  If everything is dirty,
+ * e.g. the config has changed, all the entries are checked and re-sorted.
+ */
+static bool update_entries(struct SidebarWindowData *wdata,
+                           const struct SbEntry *opn_entry, enum SortType sort)
+{
+  struct SbEntry **sbep = NULL;
+
+  if (wdata->all_dirty)
+  {
+    ARRAY_FOREACH(sbep, &wdata->entries)
     {
-      /* Explicitly asked to be visible */
-      continue;
+      struct SbEntry *sbe = *sbep;
+      update_entry_visibility(wdata, sbe, (sbe == opn_entry));
+      sbe->dirty = false;
+      sbe->box_valid = false;
+      sbe->display_width = 0;
     }
-
-    if (c_sidebar_non_empty_mailbox_only && (i != wdata->opn_index) &&
-        (sbe->mailbox->msg_count == 0))
+    ARRAY_SHRINK(&wdata->changed, ARRAY_SIZE(&wdata->changed));
+    trace_counter("sidebar_entries_updated", ARRAY_SIZE(&wdata->entries));
+    wdata->all_dirty = false;
+    wdata->resort = true;
+  }
+  else
+  {
+    ARRAY_FOREACH(sbep, &wdata->changed)
     {
-      sbe->is_hidden = true;
+      struct SbEntry *sbe = *sbep;
+      update_entry_visibility(wdata, sbe, (sbe == opn_entry));
+      sbe->display_width = 0;
     }
 
-    if (c_sidebar_new_mail_only && (i != wdata->opn_index) &&
-        (sbe->mailbox->msg_unread == 0) && (sbe->mailbox->msg_flagged == 0) &&
-        !sbe->mailbox->has_new)
+    const bool moved = !wdata->resort && sb_sort_reposition(wdata, sort);
+    ARRAY_FOREACH(sbep, &wdata->changed)
     {
-      sbe->is_hidden = true;
+      (*sbep)->dirty = false;
     }
+    trace_counter("sidebar_entries_updated", ARRAY_SIZE(&wdata->changed));
+    ARRAY_SHRINK(&wdata->changed, ARRAY_SIZE(&wdata->changed));
+
+    if (!wdata->resort)
+      return moved;
   }
+
+  sb_sort_entries(wdata, sort);
+  wdata->resort = false;
+  return true;
 }
 
 /**
@@ -688,8 +736,7 @@ static void update_entries_visibility(struct SidebarWindowData *wdata)
  * Before painting the sidebar, we determine which are visible, sort
  * them and set up our page pointers.
  *
- * This is a lot of work to do each refresh, but there are many things that
- * can change outside of the sidebar that we don't hear about.
+ * Only the entries that have changed are recalculated, see update_entries().
  */
 static bool prepare_sidebar(struct SidebarWindowData *wdata, int page_size)
 {
@@ -701,15 +748,24 @@ static bool prepare_sidebar(struct SidebarWindowData *wdata, int page_size)
   const bool c_sidebar_non_empty_mailbox_only = cs_subset_bool(SpaceMutt->sub, "sidebar_non_empty_mailbox_only");
 
   sbep = (wdata->opn_index >= 0) ? ARRAY_GET(&wdata->entries, wdata->opn_index) : NULL;
-  const struct SbEntry *opn_entry = sbep ? *sbep : NULL;
+  struct SbEntry *opn_entry = sbep ? *sbep : NULL;
   sbep = (wdata->hil_index >= 0) ? ARRAY_GET(&wdata->entries, wdata->hil_index) : NULL;
   const struct SbEntry *hil_entry = sbep ? *sbep : NULL;
 
-  update_entries_visibility(wdata);
+  /* The open Mailbox's counts aren't always notified */
+  if (opn_entry && !opn_entry->dirty)
+  {
+    opn_entry->dirty = true;
+    ARRAY_ADD(&wdata->changed, opn_entry);
+  }
+
   const short c_sidebar_sort_method = cs_subset_sort(SpaceMutt->sub, "sidebar_sort_method");
-  sb_sort_entries(wdata, c_sidebar_sort_method);
+  if (c_sidebar_sort_method != wdata->previous_sort)
+    wdata->resort = true;
 
-  if (opn_entry || hil_entry)
+  const bool moved = update_entries(wdata, opn_entry, c_sidebar_sort_method);
+
+  if (moved && (opn_entry || hil_entry))
   {
     ARRAY_FOREACH(sbep, &wdata->entries)
     {
@@ -773,8 +829,58 @@ static bool prepare_sidebar(struct SidebarWindowData *wdata, int page_size)
   return (wdata->hil_index >= 0);
 }
 
+/**
+ * calc_entry_box - Abbreviate the path of a Sidebar entry
+ * @param sbe Sidebar entry
+ *
+ * Set SbEntry.box and SbEntry.depth from the Mailbox's path and the config.
+ */
+static void calc_entry_box(struct SbEntry *sbe)
+{
+  struct Mailbox *m = sbe->mailbox;
+  const char *path = mailbox_path(m);
+
+  const char *const c_folder = cs_subset_string(SpaceMutt->sub, "folder");
+  // Try to abbreviate the full path
+  const char *abbr = abbrev_folder(path, c_folder, m->type);
+  if (!abbr)
+    abbr = abbrev_url(path, m->type);
+  const char *short_path = abbr ? abbr : path;
+
+  /* Compute the depth */
+  const char *last_part = abbr;
+  const char *const c_sidebar_delim_chars = cs_subset_string(SpaceMutt->sub, "sidebar_delim_chars");
+  sbe->depth = calc_path_depth(abbr, c_sidebar_delim_chars, &last_part);
+
+  const bool short_path_is_abbr = (short_path == abbr);
+  const bool c_sidebar_short_path = cs_subset_bool(SpaceMutt->sub, "sidebar_short_path");
+  if (c_sidebar_short_path)
+  {
+    short_path = last_part;
+  }
+
+  // Don't indent if we were unable to create an abbreviation.
+  // Otherwise, the full path will be indent, and it looks unusual.
+  const bool c_sidebar_folder_indent = cs_subset_bool(SpaceMutt->sub, "sidebar_folder_indent");
+  if (c_sidebar_folder_indent && short_path_is_abbr)
+  {
+    const short c_sidebar_component_depth = cs_subset_number(SpaceMutt->sub, "sidebar_component_depth");
+    if (c_sidebar_component_depth > 0)
+      sbe->depth -= c_sidebar_component_depth;
+  }
+  else if (!c_sidebar_folder_indent)
+  {
+    sbe->depth = 0;
+  }
+
+  mutt_str_copy(sbe->box, short_path, sizeof(sbe->box));
+  sbe->box_valid = true;
+}
+
 /**
  * sb_recalc - Recalculate the Sidebar display - Implements MuttWindow::recalc() - @ingroup window_recalc
+ *
+ * Only the visible rows are rendered, and only if they're stale.
  */
 int sb_recalc(struct MuttWindow *win)
 {
@@ -811,6 +917,7 @@ int sb_recalc(struct MuttWindow *win)
 
   int width = num_cols - wdata->divider_width;
   int row = 0;
+  int rendered = 0;
   struct Mailbox *m_cur = shared->mailbox;
   struct SbEntry **sbep = NULL;
   ARRAY_FOREACH_FROM(sbep, &wdata->entries, wdata->top_index)
@@ -836,48 +943,21 @@ int sb_recalc(struct MuttWindow *win)
       m->msg_flagged = m_cur->msg_flagged;
     }
 
-    const char *path = mailbox_path(m);
+    if (!entry->box_valid)
+      calc_entry_box(entry);
 
-    const char *const c_folder = cs_subset_string(SpaceMutt->sub, "folder");
-    // Try to abbreviate the full path
-    const char *abbr = abbrev_folder(path, c_folder, m->type);
-    if (!abbr)
-      abbr = abbrev_url(path, m->type);
-    const char *short_path = abbr ? abbr : path;
-
-    /* Compute the depth */
-    const char *last_part = abbr;
-    const char *const c_sidebar_delim_chars = cs_subset_string(SpaceMutt->sub, "sidebar_delim_chars");
-    entry->depth = calc_path_depth(abbr, c_sidebar_delim_chars, &last_part);
-
-    const bool short_path_is_abbr = (short_path == abbr);
-    const bool c_sidebar_short_path = cs_subset_bool(SpaceMutt->sub, "sidebar_short_path");
-    if (c_sidebar_short_path)
-    {
-      short_path = last_part;
-    }
-
-    // Don't indent if we were unable to create an abbreviation.
-    // Otherwise, the full path will be indent, and it looks unusual.
-    const bool c_sidebar_folder_indent = cs_subset_bool(SpaceMutt->sub, "sidebar_folder_indent");
-    if (c_sidebar_folder_indent && short_path_is_abbr)
-    {
-      const short c_sidebar_component_depth = cs_subset_number(SpaceMutt->sub, "sidebar_component_depth");
-      if (c_sidebar_component_depth > 0)
-        entry->depth -= c_sidebar_component_depth;
-    }
-    else if (!c_sidebar_folder_indent)
+    if (entry->display_width != width)
     {
-      entry->depth = 0;
+      make_sidebar_entry(entry->display, sizeof(entry->display), width, entry, shared);
+      entry->display_width = width;
+      rendered++;
     }
-
-    mutt_str_copy(entry->box, short_path, sizeof(entry->box));
-    make_sidebar_entry(entry->display, sizeof(entry->display), width, entry, shared);
     row++;
   }
 
+  trace_counter("sidebar_rows_rendered", rendered);
   win->actions |= WA_REPAINT;
-  log_debug5("recalc done, request WA_REPAINT");
+  log_debug5("recalc done, rendered %d rows, request WA_REPAINT", rendered);
   return 0;
 }
 
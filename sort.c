@@ -372,6 +372,9 @@ void mutt_sort_headers(struct MailboxView *mv, bool init)
   if (m->verbose)
     log_message(_("Sorting mailbox..."));
 
+  struct TraceSpan span = { 0 };
+  trace_begin(&span, "sort", "mutt_sort_headers");
+
   const bool c_score = cs_subset_bool(SpaceMutt->sub, "score");
   if (OptNeedRescore && c_score)
   {
@@ -382,6 +385,7 @@ void mutt_sort_headers(struct MailboxView *mv, bool init)
         break;
       mutt_score_message(m, e, true);
     }
+    mx_hcache_flush(m);
   }
   OptNeedRescore = false;
 
@@ -424,6 +428,7 @@ void mutt_sort_headers(struct MailboxView *mv, bool init)
       m->vcount++;
     }
     e_cur->msgno = i;
+    hot_set(&m->hot, i, e_cur);
   }
 
   /* re-collapse threads marked as collapsed */
@@ -433,6 +438,8 @@ void mutt_sort_headers(struct MailboxView *mv, bool init)
     mv->vsize = mutt_set_vnum(m);
   }
 
+  trace_end(&span, mailbox_path(m));
+
   if (m->verbose)
     mutt_clear_error();
 }
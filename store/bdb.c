@@ -250,6 +250,69 @@ static int store_bdb_delete_record(StoreHandle *store, const char *key, size_t k
   return sdata->db->del(sdata->db, NULL, &dkey, 0);
 }
 
+/**
+ * store_bdb_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_bdb_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct BdbStoreData *sdata = store;
+
+  // Write the cached pages to the file
+  return (sdata->db->sync(sdata->db, 0) == 0) ? 0 : -1;
+}
+
+/**
+ * store_bdb_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_bdb_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct BdbStoreData *sdata = store;
+
+  DBC *cursor = NULL;
+  if (sdata->db->cursor(sdata->db, NULL, &cursor, 0) != 0)
+    return -1;
+
+  DBT dkey = { 0 };
+  DBT data = { 0 };
+  dbt_empty_init(&dkey);
+  dbt_empty_init(&data);
+  // Only the key is needed
+  data.flags = DB_DBT_PARTIAL;
+
+  int rc = 0;
+  while ((rc = cursor->get(cursor, &dkey, &data, DB_NEXT)) == 0)
+  {
+    if (!cb(dkey.data, dkey.size, wdata))
+      break;
+  }
+
+  cursor->close(cursor);
+  return ((rc == 0) || (rc == DB_NOTFOUND)) ? 0 : -1;
+}
+
+/**
+ * store_bdb_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_bdb_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct BdbStoreData *sdata = store;
+
+  // Merge sparse pages and return the free ones to the filesystem
+  return (sdata->db->compact(sdata->db, NULL, NULL, NULL, NULL, DB_FREE_SPACE, NULL) == 0) ? 0 : -1;
+}
+
 /**
  * store_bdb_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
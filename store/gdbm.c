@@ -131,6 +131,59 @@ static int store_gdbm_delete_record(StoreHandle *store, const char *key, size_t
   return gdbm_delete(db, dkey);
 }
 
+/**
+ * store_gdbm_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_gdbm_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Writes go straight to the file
+  return 0;
+}
+
+/**
+ * store_gdbm_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_gdbm_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  GDBM_FILE db = store;
+
+  datum dkey = gdbm_firstkey(db);
+  while (dkey.dptr)
+  {
+    if (!cb(dkey.dptr, dkey.dsize, wdata))
+    {
+      FREE(&dkey.dptr);
+      break;
+    }
+
+    datum next = gdbm_nextkey(db, dkey);
+    FREE(&dkey.dptr);
+    dkey = next;
+  }
+
+  return 0;
+}
+
+/**
+ * store_gdbm_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_gdbm_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  GDBM_FILE db = store;
+  return (gdbm_reorganize(db) == 0) ? 0 : -1;
+}
+
 /**
  * store_gdbm_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
@@ -128,6 +128,63 @@ static int store_kyotocabinet_delete_record(StoreHandle *store, const char *key,
   return 0;
 }
 
+/**
+ * store_kyotocabinet_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_kyotocabinet_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  KCDB *db = store;
+  return kcdbsync(db, false, NULL, NULL) ? 0 : -1;
+}
+
+/**
+ * store_kyotocabinet_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_kyotocabinet_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  KCDB *db = store;
+  KCCUR *cur = kcdbcursor(db);
+  if (!cur)
+    return -1;
+
+  if (kccurjump(cur))
+  {
+    size_t klen = 0;
+    char *key = NULL;
+    // Read the key and step to the next record
+    while ((key = kccurgetkey(cur, &klen, true)))
+    {
+      const bool more = cb(key, klen, wdata);
+      kcfree(key);
+      if (!more)
+        break;
+    }
+  }
+
+  kccurdel(cur);
+  return 0;
+}
+
+/**
+ * store_kyotocabinet_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_kyotocabinet_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // The C API has no defragmentation call; the tree database reuses free space
+  return 0;
+}
+
 /**
  * store_kyotocabinet_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
@@ -45,6 +45,7 @@
  * | @subpage store_gdbm    | store/gdbm.c    | https://www.gnu.org.ua/software/gdbm/     |
  * | @subpage store_kc      | store/kc.c      | https://dbmx.net/kyotocabinet/            |
  * | @subpage store_lmdb    | store/lmdb.c    | https://symas.com/lmdb/                   |
+ * | @subpage store_logdb   | store/logdb.c   | Built in                                  |
  * | @subpage store_qdbm    | store/qdbm.c    | https://dbmx.net/qdbm/                    |
  * | @subpage store_rocksdb | store/rocksdb.c | https://rocksdb.org/                      |
  * | @subpage store_tc      | store/tc.c      | https://dbmx.net/tokyocabinet/            |
@@ -60,6 +61,21 @@
 /// Opaque type for store backend
 typedef void StoreHandle;
 
+/**
+ * @defgroup store_walk_api Store Walk API
+ *
+ * store_walk_t - Prototype for a callback for each Key in a Store
+ * @param key   Key of the record
+ * @param klen  Length of the Key
+ * @param wdata Private data passed to walk()
+ * @retval true  Continue the walk
+ * @retval false Stop the walk
+ *
+ * @note The Key is only valid for the duration of the callback.
+ *       The Store must not be changed during the walk.
+ */
+typedef bool (*store_walk_t)(const char *key, size_t klen, void *wdata);
+
 /**
  * @defgroup store_api Key Value Store API
  *
@@ -137,6 +153,44 @@ struct StoreOps
    */
   int (*delete_record)(StoreHandle *store, const char *key, size_t klen);
 
+  /**
+   * @defgroup store_sync sync()
+   * @ingroup store_api
+   *
+   * sync - Commit the writes made so far
+   * @param[in] store Store retrieved via open()
+   * @retval  0 Success, or the backend writes straight to the file
+   * @retval -1 Error
+   *
+   * Until they're committed, writes may be hidden from other processes and
+   * lost in a crash.  Any Values returned by fetch() are invalidated.
+   */
+  int (*sync)(StoreHandle *store);
+
+  /**
+   * @defgroup store_walk walk()
+   * @ingroup store_api
+   *
+   * walk - Call a function for every Key in the Store
+   * @param[in] store Store retrieved via open()
+   * @param[in] cb    Callback function
+   * @param[in] wdata Private data passed to the callback
+   * @retval  0 Success
+   * @retval -1 Error
+   */
+  int (*walk)(StoreHandle *store, store_walk_t cb, void *wdata);
+
+  /**
+   * @defgroup store_compact compact()
+   * @ingroup store_api
+   *
+   * compact - Reclaim the space used by deleted records
+   * @param[in] store Store retrieved via open()
+   * @retval  0 Success, or the backend can't compact
+   * @retval -1 Error
+   */
+  int (*compact)(StoreHandle *store);
+
   /**
    * @defgroup store_close close()
    * @ingroup store_api
@@ -168,6 +222,9 @@ bool                   store_is_valid_backend(const char *str);
     .free           = store_##_name##_free,                                    \
     .store          = store_##_name##_store,                                   \
     .delete_record  = store_##_name##_delete_record,                           \
+    .sync           = store_##_name##_sync,                                    \
+    .walk           = store_##_name##_walk,                                    \
+    .compact        = store_##_name##_compact,                                 \
     .close          = store_##_name##_close,                                   \
     .version        = store_##_name##_version,                                 \
   };
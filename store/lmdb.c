@@ -30,10 +30,16 @@
  */
 
 #include "config.h"
+#include <errno.h>
+#include <fcntl.h>
 #include <lmdb.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include "mutt/lib.h"
 #include "lib.h"
@@ -69,6 +75,7 @@ struct LmdbStoreData
   MDB_txn *txn;
   MDB_dbi db;
   enum LmdbTxnMode txn_mode;
+  int lock_fd;               ///< Shared lock on the database file, see lmdb_lock()
 };
 
 /**
@@ -86,7 +93,50 @@ static void lmdb_sdata_free(struct LmdbStoreData **ptr)
  */
 static struct LmdbStoreData *lmdb_sdata_new(void)
 {
-  return g_new0(struct LmdbStoreData, 1);
+  struct LmdbStoreData *sdata = g_new0(struct LmdbStoreData, 1);
+  sdata->lock_fd = -1;
+  return sdata;
+}
+
+/**
+ * lmdb_lock - Lock the database file
+ * @param path      Path to the database
+ * @param operation flock() operation, e.g. LOCK_SH
+ * @param create    Create the file if it doesn't exist
+ * @retval >=0 File descriptor holding the lock
+ * @retval -1  Error, or the lock is held by someone else (LOCK_NB)
+ *
+ * Every connection holds a shared lock on the database file, so an exclusive
+ * lock means that nobody else has it open.  LMDB itself only uses fcntl()
+ * locks on its lock file, so these don't interfere.
+ *
+ * Compaction replaces the file, so after waiting for the lock, check that the
+ * file is still the one at path.
+ */
+static int lmdb_lock(const char *path, int operation, bool create)
+{
+  while (true)
+  {
+    int fd = open(path, O_RDONLY | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+    if (fd < 0)
+      return -1;
+
+    if (flock(fd, operation) != 0)
+    {
+      close(fd);
+      return -1;
+    }
+
+    struct stat st_fd = { 0 };
+    struct stat st_path = { 0 };
+    if ((fstat(fd, &st_fd) == 0) && (stat(path, &st_path) == 0) &&
+        (st_fd.st_dev == st_path.st_dev) && (st_fd.st_ino == st_path.st_ino))
+    {
+      return fd;
+    }
+
+    close(fd);
+  }
 }
 
 /**
@@ -98,6 +148,10 @@ static int lmdb_get_read_txn(struct LmdbStoreData *sdata)
 {
   int rc;
 
+  // A failed compaction leaves no environment
+  if (!sdata->env)
+    return MDB_PANIC;
+
   if (sdata->txn && ((sdata->txn_mode == TXN_READ) || (sdata->txn_mode == TXN_WRITE)))
     return MDB_SUCCESS;
 
@@ -126,6 +180,9 @@ static int lmdb_get_read_txn(struct LmdbStoreData *sdata)
  */
 static int lmdb_get_write_txn(struct LmdbStoreData *sdata)
 {
+  if (!sdata->env)
+    return MDB_PANIC;
+
   if (sdata->txn)
   {
     if (sdata->txn_mode == TXN_WRITE)
@@ -159,10 +216,20 @@ static StoreHandle *store_lmdb_open(const char *path, bool create)
 
   struct LmdbStoreData *sdata = lmdb_sdata_new();
 
+  // Hold off compaction by other processes while we use the file
+  sdata->lock_fd = lmdb_lock(path, LOCK_SH, create);
+  if (sdata->lock_fd < 0)
+  {
+    log_debug2("can't lock %s: %s", path, strerror(errno));
+    lmdb_sdata_free(&sdata);
+    return NULL;
+  }
+
   int rc = mdb_env_create(&sdata->env);
   if (rc != MDB_SUCCESS)
   {
     log_debug2("mdb_env_create: %s", mdb_strerror(rc));
+    close(sdata->lock_fd);
     lmdb_sdata_free(&sdata);
     return NULL;
   }
@@ -202,6 +269,7 @@ fail_dbi:
 
 fail_env:
   mdb_env_close(sdata->env);
+  close(sdata->lock_fd);
   lmdb_sdata_free(&sdata);
   return NULL;
 }
@@ -323,6 +391,180 @@ static int store_lmdb_delete_record(StoreHandle *store, const char *key, size_t
   return rc;
 }
 
+/**
+ * store_lmdb_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_lmdb_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LmdbStoreData *sdata = store;
+
+  if (!sdata->txn)
+    return 0;
+
+  int rc = MDB_SUCCESS;
+  if (sdata->txn_mode == TXN_WRITE)
+  {
+    // Committing frees the transaction
+    rc = mdb_txn_commit(sdata->txn);
+    if (rc != MDB_SUCCESS)
+      log_debug2("mdb_txn_commit: %s", mdb_strerror(rc));
+    sdata->txn = NULL;
+  }
+  else if (sdata->txn_mode == TXN_READ)
+  {
+    // Let the next read see what other processes have written
+    mdb_txn_reset(sdata->txn);
+  }
+
+  sdata->txn_mode = TXN_UNINITIALIZED;
+  return (rc == MDB_SUCCESS) ? 0 : -1;
+}
+
+/**
+ * store_lmdb_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_lmdb_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LmdbStoreData *sdata = store;
+
+  int rc = lmdb_get_read_txn(sdata);
+  if (rc != MDB_SUCCESS)
+  {
+    sdata->txn = NULL;
+    return -1;
+  }
+
+  MDB_cursor *cursor = NULL;
+  rc = mdb_cursor_open(sdata->txn, sdata->db, &cursor);
+  if (rc != MDB_SUCCESS)
+  {
+    log_debug2("mdb_cursor_open: %s", mdb_strerror(rc));
+    return -1;
+  }
+
+  MDB_val dkey = { 0 };
+  MDB_val data = { 0 };
+  while ((rc = mdb_cursor_get(cursor, &dkey, &data, MDB_NEXT)) == MDB_SUCCESS)
+  {
+    if (!cb(dkey.mv_data, dkey.mv_size, wdata))
+      break;
+  }
+
+  mdb_cursor_close(cursor);
+  return ((rc == MDB_SUCCESS) || (rc == MDB_NOTFOUND)) ? 0 : -1;
+}
+
+/**
+ * lmdb_compact_file - Replace a database file with a compacted copy
+ * @param path Path to the database
+ * @retval true Success
+ *
+ * @pre The caller holds an exclusive lock on the file, see lmdb_lock()
+ */
+static bool lmdb_compact_file(const char *path)
+{
+  MDB_env *env = NULL;
+  int rc = mdb_env_create(&env);
+  if (rc != MDB_SUCCESS)
+  {
+    log_debug2("mdb_env_create: %s", mdb_strerror(rc));
+    return false;
+  }
+
+  mdb_env_set_mapsize(env, LMDB_DB_SIZE);
+
+  struct Buffer *tmp_path = buf_pool_get();
+  buf_printf(tmp_path, "%s.tmp", path);
+
+  bool ok = false;
+  rc = mdb_env_open(env, path, MDB_NOSUBDIR, 0644);
+  if (rc == MDB_SUCCESS)
+    rc = mdb_env_copy2(env, buf_string(tmp_path), MDB_CP_COMPACT);
+  if (rc != MDB_SUCCESS)
+    log_debug2("mdb_env_copy2: %s", mdb_strerror(rc));
+  mdb_env_close(env);
+
+  if ((rc == MDB_SUCCESS) && (rename(buf_string(tmp_path), path) == 0))
+    ok = true;
+  else
+    unlink(buf_string(tmp_path));
+
+  buf_pool_release(&tmp_path);
+  return ok;
+}
+
+/**
+ * store_lmdb_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ *
+ * LMDB never shrinks its file, so write a compacted copy and swap it in.
+ * Other processes may have the file mapped, so this is only done if nobody
+ * else has it open.  Any Values returned by fetch() are invalidated.
+ */
+static int store_lmdb_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LmdbStoreData *sdata = store;
+
+  if (sdata->txn)
+  {
+    if (sdata->txn_mode == TXN_WRITE)
+      mdb_txn_commit(sdata->txn);
+    else
+      mdb_txn_abort(sdata->txn);
+
+    sdata->txn_mode = TXN_UNINITIALIZED;
+    sdata->txn = NULL;
+  }
+
+  const char *path = NULL;
+  if ((mdb_env_get_path(sdata->env, &path) != MDB_SUCCESS) || !path)
+    return -1;
+
+  struct Buffer *db_path = buf_pool_get();
+  buf_strcpy(db_path, path);
+
+  // Let go of the file, then see if anyone else is using it
+  mdb_env_close(sdata->env);
+  sdata->env = NULL;
+  close(sdata->lock_fd);
+  sdata->lock_fd = -1;
+
+  int fd = lmdb_lock(buf_string(db_path), LOCK_EX | LOCK_NB, false);
+  if (fd >= 0)
+  {
+    lmdb_compact_file(buf_string(db_path));
+    close(fd);
+  }
+  else
+  {
+    log_debug2("%s is in use, not compacting", buf_string(db_path));
+  }
+
+  // Reopen whichever file is now in place
+  int rc = -1;
+  struct LmdbStoreData *fresh = store_lmdb_open(buf_string(db_path), true);
+  if (fresh)
+  {
+    *sdata = *fresh;
+    lmdb_sdata_free(&fresh);
+    rc = 0;
+  }
+
+  buf_pool_release(&db_path);
+  return rc;
+}
+
 /**
  * store_lmdb_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
@@ -345,7 +587,10 @@ static void store_lmdb_close(StoreHandle **ptr)
     sdata->txn = NULL;
   }
 
-  mdb_env_close(sdata->env);
+  if (sdata->env)
+    mdb_env_close(sdata->env);
+  if (sdata->lock_fd >= 0)
+    close(sdata->lock_fd);
   lmdb_sdata_free((struct LmdbStoreData **) ptr);
 }
 
@@ -0,0 +1,1087 @@
+/**
+ * @file
+ * Built-in append-only log backend for the key/value Store
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page store_logdb Append-only log (built in)
+ *
+ * Built-in backend for the key/value Store.  It has no external dependencies
+ * and is tuned for the header cache: a bulk load, followed by many reads.
+ *
+ * The Store is two files:
+ *
+ * - `<path>`      An append-only log.  A store() appends the key and value;
+ *                 a delete_record() appends a tombstone.
+ * - `<path>.idx`  An open-addressing index, mmap()'d.  Each slot holds the
+ *                 hash of a key and the offset of its latest record.
+ *
+ * The index is only a cache of the log.  If it's missing, or it wasn't closed
+ * cleanly, it's rebuilt by replaying the log.
+ *
+ * The log is mmap()'d too, so fetch() returns a pointer into the mapping.
+ * The mapping is reserved larger than the file, so appended records become
+ * visible without remapping.
+ *
+ * Writes are committed in groups: records are collected in memory and
+ * appended with one write() once there are LOGDB_COMMIT_BYTES of them.
+ * The log is synced to disk when the Store is closed.
+ *
+ * When more than half of the log is dead (overwritten or deleted records), it
+ * is compacted: the live records are copied to a new log, which is renamed
+ * over the old one.
+ *
+ * Only one process may write to the Store; it holds a lock on the index.
+ * Other processes get read-only access and keep a private index.
+ */
+
+#include "config.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "lib.h"
+
+/// Magic string at the start of the log
+static const char LogdbLogMagic[8] = { 'S', 'M', 'L', 'O', 'G', 'D', 'B', '1' };
+/// Magic string at the start of the index
+static const char LogdbIdxMagic[8] = { 'S', 'M', 'L', 'O', 'G', 'I', 'X', '1' };
+/// Magic number at the start of each record
+#define LOGDB_RECORD_MAGIC 0x52474f4cU
+/// Value length of a deleted record
+#define LOGDB_TOMBSTONE UINT32_MAX
+/// Smallest index, must be a power of two
+#define LOGDB_MIN_SLOTS 1024
+/// Append records once there are this many bytes of them
+static const size_t LOGDB_COMMIT_BYTES = 1024 * 1024;
+/// Don't compact logs smaller than this
+static const size_t LOGDB_COMPACT_MIN = 1024 * 1024;
+
+#if (UINTPTR_MAX == 0xffffffff)
+/// Address space reserved past the end of the log: 32-bit, 16MiB
+static const size_t LOGDB_MAP_RESERVE = 16 * 1024 * 1024;
+#else
+/// Address space reserved past the end of the log: 64-bit, 256MiB
+static const size_t LOGDB_MAP_RESERVE = 256 * 1024 * 1024;
+#endif
+
+/**
+ * struct LogdbRecord - Header of a record in the log
+ *
+ * The header is followed by the key and the value, each padded to 8 bytes.
+ */
+struct LogdbRecord
+{
+  uint32_t magic;    ///< LOGDB_RECORD_MAGIC
+  uint32_t klen;     ///< Length of the key
+  uint32_t vlen;     ///< Length of the value, or LOGDB_TOMBSTONE
+  uint32_t reserved; ///< Unused, zero
+};
+
+/**
+ * struct LogdbSlot - A slot in the index
+ */
+struct LogdbSlot
+{
+  uint64_t hash;   ///< Hash of the key
+  uint64_t offset; ///< Offset of the record in the log, 0 if the slot is empty
+};
+
+/**
+ * struct LogdbIndexHeader - Header of the index file
+ *
+ * The header is followed by `num_slots` LogdbSlot.
+ */
+struct LogdbIndexHeader
+{
+  char magic[8];       ///< LogdbIdxMagic
+  uint32_t clean;      ///< Index matches the log, i.e. it was closed properly
+  uint32_t reserved;   ///< Unused, zero
+  uint64_t num_slots;  ///< Number of slots, a power of two
+  uint64_t count;      ///< Number of keys
+  uint64_t log_len;    ///< Length of the log the index describes
+  uint64_t live_bytes; ///< Bytes of the log used by live records
+  uint64_t spare[2];   ///< Unused, zero
+};
+
+/**
+ * struct LogdbMap - A mapping of the log
+ */
+struct LogdbMap
+{
+  void *addr; ///< Start of the mapping
+  size_t len; ///< Length of the mapping
+};
+ARRAY_HEAD(LogdbMapArray, struct LogdbMap);
+
+/**
+ * struct LogdbStoreData - Append-only log store
+ */
+struct LogdbStoreData
+{
+  char *path;                   ///< Path to the log
+  int log_fd;                   ///< Log file
+  int idx_fd;                   ///< Index file
+  bool readonly;                ///< Another process is writing to the Store
+  char *log_map;                ///< Mapping of the log
+  size_t log_map_len;           ///< Size of the log mapping
+  size_t log_len;               ///< Bytes of the log on disk
+  struct LogdbMapArray stale;   ///< Old log mappings, still referenced
+  struct LogdbIndexHeader *idx; ///< Mapping of the index
+  size_t idx_map_len;           ///< Size of the index mapping
+  struct LogdbSlot *slots;      ///< Slots of the index
+  struct Buffer *pending;       ///< Records waiting to be appended
+  int refs;                     ///< Values returned by fetch(), not yet freed
+};
+
+/**
+ * logdb_pad - Round a length up to a multiple of 8
+ * @param len Length
+ * @retval num Padded length
+ */
+static inline size_t logdb_pad(size_t len)
+{
+  return (len + 7) & ~(size_t) 7;
+}
+
+/**
+ * logdb_record_size - Size of a record in the log
+ * @param klen Length of the key
+ * @param vlen Length of the value, or LOGDB_TOMBSTONE
+ * @retval num Bytes
+ */
+static inline size_t logdb_record_size(uint32_t klen, uint32_t vlen)
+{
+  size_t size = sizeof(struct LogdbRecord) + logdb_pad(klen);
+  if (vlen != LOGDB_TOMBSTONE)
+    size += logdb_pad(vlen);
+  return size;
+}
+
+/**
+ * logdb_hash - Hash a key
+ * @param key  Key
+ * @param klen Length of the key
+ * @retval num Hash
+ *
+ * The hash is saved in the index, so it must never change.  This is 64-bit
+ * FNV-1a.
+ */
+static uint64_t logdb_hash(const char *key, size_t klen)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < klen; i++)
+  {
+    h ^= (unsigned char) key[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/**
+ * logdb_write_all - Write a buffer to a file at an offset
+ * @param fd   File descriptor
+ * @param data Data to write
+ * @param len  Length of the data
+ * @param off  Offset in the file
+ * @retval  0 Success
+ * @retval -1 Error, see errno
+ */
+static int logdb_write_all(int fd, const void *data, size_t len, off_t off)
+{
+  const char *p = data;
+  while (len > 0)
+  {
+    ssize_t rc = pwrite(fd, p, len, off);
+    if (rc < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    p += rc;
+    off += rc;
+    len -= rc;
+  }
+  return 0;
+}
+
+/**
+ * logdb_map_log - (Re)map the log
+ * @param sdata Log store
+ * @retval true Success
+ *
+ * The mapping is reserved past the end of the file.  If fetch() has handed out
+ * pointers into the old mapping, it's kept until the Store is closed.
+ */
+static bool logdb_map_log(struct LogdbStoreData *sdata)
+{
+  size_t len = sdata->log_len + LOGDB_MAP_RESERVE;
+  void *map = mmap(NULL, len, PROT_READ, MAP_SHARED, sdata->log_fd, 0);
+  if (map == MAP_FAILED)
+  {
+    log_debug1("mmap: %s: %s", sdata->path, strerror(errno));
+    return false;
+  }
+
+  if (sdata->log_map)
+  {
+    if (sdata->refs > 0)
+    {
+      struct LogdbMap lm = { sdata->log_map, sdata->log_map_len };
+      ARRAY_ADD(&sdata->stale, lm);
+    }
+    else
+      munmap(sdata->log_map, sdata->log_map_len);
+  }
+
+  sdata->log_map = map;
+  sdata->log_map_len = len;
+  return true;
+}
+
+/**
+ * logdb_record - Get a record from the log
+ * @param sdata  Log store
+ * @param offset Offset of the record
+ * @retval ptr  Record
+ * @retval NULL Offset doesn't point to a valid record
+ *
+ * Records that haven't been committed are read from the pending Buffer.
+ * Pointers into the Buffer are only valid until the next store().
+ */
+static const struct LogdbRecord *logdb_record(struct LogdbStoreData *sdata, uint64_t offset)
+{
+  const char *base = NULL;
+  size_t len = 0;
+
+  if (offset >= sdata->log_len)
+  {
+    offset -= sdata->log_len;
+    base = buf_string(sdata->pending);
+    len = buf_len(sdata->pending);
+  }
+  else
+  {
+    base = sdata->log_map;
+    len = sdata->log_len;
+  }
+
+  if ((offset + sizeof(struct LogdbRecord)) > len)
+    return NULL;
+
+  const struct LogdbRecord *rec = (const struct LogdbRecord *) (base + offset);
+  if ((rec->magic != LOGDB_RECORD_MAGIC) ||
+      ((offset + logdb_record_size(rec->klen, rec->vlen)) > len))
+  {
+    return NULL;
+  }
+
+  return rec;
+}
+
+/**
+ * logdb_record_key_equal - Does a record have this key?
+ * @param rec  Record
+ * @param key  Key
+ * @param klen Length of the key
+ * @retval true The keys match
+ */
+static inline bool logdb_record_key_equal(const struct LogdbRecord *rec,
+                                          const char *key, size_t klen)
+{
+  return rec && (rec->klen == klen) &&
+         (memcmp((const char *) (rec + 1), key, klen) == 0);
+}
+
+/**
+ * logdb_idx_find - Find the slot for a key
+ * @param sdata Log store
+ * @param key   Key
+ * @param klen  Length of the key
+ * @param hash  Hash of the key
+ * @retval num Index of the slot holding the key, or of the empty slot it belongs in
+ */
+static size_t logdb_idx_find(struct LogdbStoreData *sdata, const char *key,
+                             size_t klen, uint64_t hash)
+{
+  const size_t mask = sdata->idx->num_slots - 1;
+  size_t i = hash & mask;
+
+  for (; sdata->slots[i].offset != 0; i = (i + 1) & mask)
+  {
+    if ((sdata->slots[i].hash == hash) &&
+        logdb_record_key_equal(logdb_record(sdata, sdata->slots[i].offset), key, klen))
+    {
+      break;
+    }
+  }
+
+  return i;
+}
+
+/**
+ * logdb_idx_remove - Empty a slot of the index
+ * @param sdata Log store
+ * @param i     Slot to empty
+ *
+ * The following slots are shifted back, so lookups never need tombstones.
+ */
+static void logdb_idx_remove(struct LogdbStoreData *sdata, size_t i)
+{
+  const size_t mask = sdata->idx->num_slots - 1;
+  size_t j = i;
+
+  while (true)
+  {
+    j = (j + 1) & mask;
+    if (sdata->slots[j].offset == 0)
+      break;
+
+    // Leave the slot alone if its home lies cyclically in (i, j]
+    const size_t home = sdata->slots[j].hash & mask;
+    if ((i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j)))
+      continue;
+
+    sdata->slots[i] = sdata->slots[j];
+    i = j;
+  }
+
+  sdata->slots[i].hash = 0;
+  sdata->slots[i].offset = 0;
+}
+
+/**
+ * logdb_idx_map - Create an empty index
+ * @param sdata     Log store
+ * @param num_slots Number of slots, a power of two
+ * @retval true Success
+ *
+ * A writer keeps the index in the file; a reader keeps it in private memory.
+ */
+static bool logdb_idx_map(struct LogdbStoreData *sdata, size_t num_slots)
+{
+  const size_t len = sizeof(struct LogdbIndexHeader) + (num_slots * sizeof(struct LogdbSlot));
+  void *map = MAP_FAILED;
+
+  if (sdata->readonly)
+  {
+    map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  else
+  {
+    // Empty the file, then grow it, so that every slot reads as zero
+    if ((ftruncate(sdata->idx_fd, 0) == 0) && (ftruncate(sdata->idx_fd, len) == 0))
+      map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, sdata->idx_fd, 0);
+  }
+
+  if (map == MAP_FAILED)
+  {
+    log_debug1("index: %s: %s", sdata->path, strerror(errno));
+    return false;
+  }
+
+  sdata->idx = map;
+  sdata->idx_map_len = len;
+  sdata->slots = (struct LogdbSlot *) (sdata->idx + 1);
+
+  memcpy(sdata->idx->magic, LogdbIdxMagic, sizeof(LogdbIdxMagic));
+  sdata->idx->num_slots = num_slots;
+  return true;
+}
+
+/**
+ * logdb_idx_unmap - Release the index
+ * @param sdata Log store
+ */
+static void logdb_idx_unmap(struct LogdbStoreData *sdata)
+{
+  if (!sdata->idx)
+    return;
+
+  munmap(sdata->idx, sdata->idx_map_len);
+  sdata->idx = NULL;
+  sdata->slots = NULL;
+  sdata->idx_map_len = 0;
+}
+
+/**
+ * logdb_idx_grow - Double the size of the index
+ * @param sdata Log store
+ * @retval true Success
+ */
+static bool logdb_idx_grow(struct LogdbStoreData *sdata)
+{
+  const struct LogdbIndexHeader old = *sdata->idx;
+  struct LogdbSlot *slots = g_malloc_n(old.num_slots, sizeof(struct LogdbSlot));
+  memcpy(slots, sdata->slots, old.num_slots * sizeof(struct LogdbSlot));
+
+  logdb_idx_unmap(sdata);
+  if (!logdb_idx_map(sdata, old.num_slots * 2))
+  {
+    FREE(&slots);
+    return false;
+  }
+
+  sdata->idx->count = old.count;
+  sdata->idx->live_bytes = old.live_bytes;
+
+  const size_t mask = sdata->idx->num_slots - 1;
+  for (size_t i = 0; i < old.num_slots; i++)
+  {
+    if (slots[i].offset == 0)
+      continue;
+
+    size_t j = slots[i].hash & mask;
+    while (sdata->slots[j].offset != 0)
+      j = (j + 1) & mask;
+    sdata->slots[j] = slots[i];
+  }
+
+  FREE(&slots);
+  return true;
+}
+
+/**
+ * logdb_idx_apply - Apply a record to the index
+ * @param sdata  Log store
+ * @param rec    Record
+ * @param offset Offset of the record
+ * @retval true Success
+ */
+static bool logdb_idx_apply(struct LogdbStoreData *sdata,
+                            const struct LogdbRecord *rec, uint64_t offset)
+{
+  if (!rec)
+    return false;
+
+  if (((sdata->idx->count + 1) * 4) > (sdata->idx->num_slots * 3))
+  {
+    if (!logdb_idx_grow(sdata))
+      return false;
+  }
+
+  const char *key = (const char *) (rec + 1);
+  const uint64_t hash = logdb_hash(key, rec->klen);
+  const size_t i = logdb_idx_find(sdata, key, rec->klen, hash);
+  struct LogdbSlot *slot = &sdata->slots[i];
+
+  if (slot->offset != 0)
+  {
+    const struct LogdbRecord *old = logdb_record(sdata, slot->offset);
+    if (!old)
+      return false;
+    sdata->idx->live_bytes -= logdb_record_size(old->klen, old->vlen);
+    if (rec->vlen == LOGDB_TOMBSTONE)
+    {
+      logdb_idx_remove(sdata, i);
+      sdata->idx->count--;
+      return true;
+    }
+  }
+  else
+  {
+    if (rec->vlen == LOGDB_TOMBSTONE)
+      return true;
+    slot->hash = hash;
+    sdata->idx->count++;
+  }
+
+  slot->offset = offset;
+  sdata->idx->live_bytes += logdb_record_size(rec->klen, rec->vlen);
+  return true;
+}
+
+/**
+ * logdb_idx_rebuild - Rebuild the index by replaying the log
+ * @param sdata Log store
+ * @retval true Success
+ *
+ * A writer truncates any partial record at the end of the log.
+ */
+static bool logdb_idx_rebuild(struct LogdbStoreData *sdata)
+{
+  logdb_idx_unmap(sdata);
+  if (!logdb_idx_map(sdata, LOGDB_MIN_SLOTS))
+    return false;
+
+  uint64_t offset = sizeof(LogdbLogMagic);
+  while (offset < sdata->log_len)
+  {
+    const struct LogdbRecord *rec = logdb_record(sdata, offset);
+    if (!rec)
+      break;
+    if (!logdb_idx_apply(sdata, rec, offset))
+      return false;
+    offset += logdb_record_size(rec->klen, rec->vlen);
+  }
+
+  if ((offset < sdata->log_len) && !sdata->readonly)
+  {
+    log_debug1("%s: discarding %zu bytes at the end of the log", sdata->path,
+               (size_t) (sdata->log_len - offset));
+    if (ftruncate(sdata->log_fd, offset) == 0)
+      sdata->log_len = offset;
+  }
+
+  log_debug3("%s: rebuilt the index, %llu keys", sdata->path,
+             (unsigned long long) sdata->idx->count);
+  return true;
+}
+
+/**
+ * logdb_idx_load - Map the index file, if it matches the log
+ * @param sdata Log store
+ * @retval true The index is usable
+ */
+static bool logdb_idx_load(struct LogdbStoreData *sdata)
+{
+  struct stat st = { 0 };
+  struct LogdbIndexHeader hdr = { 0 };
+
+  if ((fstat(sdata->idx_fd, &st) != 0) || (pread(sdata->idx_fd, &hdr, sizeof(hdr), 0) != sizeof(hdr)))
+    return false;
+
+  if ((memcmp(hdr.magic, LogdbIdxMagic, sizeof(LogdbIdxMagic)) != 0) ||
+      (hdr.clean != 1) || (hdr.log_len != sdata->log_len) ||
+      (hdr.num_slots < LOGDB_MIN_SLOTS) || ((hdr.num_slots & (hdr.num_slots - 1)) != 0))
+  {
+    return false;
+  }
+
+  const size_t len = sizeof(struct LogdbIndexHeader) + (hdr.num_slots * sizeof(struct LogdbSlot));
+  if ((size_t) st.st_size != len)
+    return false;
+
+  // A reader takes a private copy; the writer may rewrite the file at any time
+  void *map = MAP_FAILED;
+  if (sdata->readonly)
+  {
+    map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((map != MAP_FAILED) && (pread(sdata->idx_fd, map, len, 0) != (ssize_t) len))
+    {
+      munmap(map, len);
+      return false;
+    }
+  }
+  else
+  {
+    map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, sdata->idx_fd, 0);
+  }
+
+  if (map == MAP_FAILED)
+    return false;
+
+  sdata->idx = map;
+  sdata->idx_map_len = len;
+  sdata->slots = (struct LogdbSlot *) (sdata->idx + 1);
+  return true;
+}
+
+/**
+ * logdb_commit - Append the pending records to the log
+ * @param sdata Log store
+ * @retval  0 Success
+ * @retval -1 Error
+ */
+static int logdb_commit(struct LogdbStoreData *sdata)
+{
+  const size_t len = buf_len(sdata->pending);
+  if (len == 0)
+    return 0;
+
+  if (logdb_write_all(sdata->log_fd, buf_string(sdata->pending), len, sdata->log_len) != 0)
+  {
+    log_debug1("write: %s: %s", sdata->path, strerror(errno));
+    // The index points at records that were lost
+    if (ftruncate(sdata->log_fd, sdata->log_len) != 0)
+      log_debug1("ftruncate: %s: %s", sdata->path, strerror(errno));
+    buf_reset(sdata->pending);
+    logdb_idx_rebuild(sdata);
+    return -1;
+  }
+
+  sdata->log_len += len;
+  buf_reset(sdata->pending);
+
+  if (sdata->log_len > sdata->log_map_len)
+    logdb_map_log(sdata);
+
+  return 0;
+}
+
+/**
+ * logdb_compact - Copy the live records to a new log
+ * @param sdata Log store
+ * @param force Compact any dead space, not just more than half the log
+ * @retval true The log was compacted
+ *
+ * Unless forced, this is only done when more than half the log is dead.
+ * It's never done while values from fetch() are outstanding.
+ */
+static bool logdb_compact(struct LogdbStoreData *sdata, bool force)
+{
+  const size_t live = sizeof(LogdbLogMagic) + sdata->idx->live_bytes;
+  if (sdata->readonly || (sdata->refs > 0) || (buf_len(sdata->pending) != 0) ||
+      (live >= sdata->log_len))
+  {
+    return false;
+  }
+
+  if (!force && ((sdata->log_len < LOGDB_COMPACT_MIN) || ((live * 2) > sdata->log_len)))
+    return false;
+
+  struct Buffer *tmp = buf_pool_get();
+  buf_printf(tmp, "%s.tmp", sdata->path);
+
+  const size_t num_slots = sdata->idx->num_slots;
+  uint64_t *offsets = g_malloc0_n(num_slots, sizeof(uint64_t));
+  struct Buffer *chunk = buf_pool_get();
+  bool rc = false;
+  uint64_t offset = sizeof(LogdbLogMagic);
+  uint64_t written = 0;
+
+  int fd = open(buf_string(tmp), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    log_debug1("open: %s: %s", buf_string(tmp), strerror(errno));
+    goto done;
+  }
+
+  buf_alloc(chunk, LOGDB_COMMIT_BYTES + 4096);
+  buf_addstr_n(chunk, LogdbLogMagic, sizeof(LogdbLogMagic));
+  for (size_t i = 0; i < num_slots; i++)
+  {
+    if (sdata->slots[i].offset == 0)
+      continue;
+
+    const struct LogdbRecord *rec = logdb_record(sdata, sdata->slots[i].offset);
+    if (!rec)
+      goto done;
+
+    const size_t size = logdb_record_size(rec->klen, rec->vlen);
+    buf_addstr_n(chunk, (const char *) rec, size);
+    offsets[i] = offset;
+    offset += size;
+
+    if (buf_len(chunk) >= LOGDB_COMMIT_BYTES)
+    {
+      if (logdb_write_all(fd, buf_string(chunk), buf_len(chunk), written) != 0)
+        goto done;
+      written += buf_len(chunk);
+      buf_reset(chunk);
+    }
+  }
+
+  if ((logdb_write_all(fd, buf_string(chunk), buf_len(chunk), written) != 0) ||
+      (fdatasync(fd) != 0) || (rename(buf_string(tmp), sdata->path) != 0))
+  {
+    goto done;
+  }
+
+  log_debug3("%s: compacted the log from %zu to %llu bytes", sdata->path,
+             sdata->log_len, (unsigned long long) offset);
+
+  close(sdata->log_fd);
+  sdata->log_fd = fd;
+  fd = -1;
+  sdata->log_len = offset;
+  for (size_t i = 0; i < num_slots; i++)
+    if (sdata->slots[i].offset != 0)
+      sdata->slots[i].offset = offsets[i];
+
+  munmap(sdata->log_map, sdata->log_map_len);
+  sdata->log_map = NULL;
+  logdb_map_log(sdata);
+
+  // Shrink an index that's mostly empty
+  if ((num_slots > LOGDB_MIN_SLOTS) && ((sdata->idx->count * 8) < num_slots))
+    logdb_idx_rebuild(sdata);
+  rc = true;
+
+done:
+  if (fd >= 0)
+  {
+    log_debug1("%s: compaction failed: %s", sdata->path, strerror(errno));
+    close(fd);
+    unlink(buf_string(tmp));
+  }
+  FREE(&offsets);
+  buf_pool_release(&chunk);
+  buf_pool_release(&tmp);
+  return rc;
+}
+
+/**
+ * logdb_sdata_free - Free Log Store Data
+ * @param ptr Log Store Data to free
+ */
+static void logdb_sdata_free(struct LogdbStoreData **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct LogdbStoreData *sdata = *ptr;
+
+  logdb_idx_unmap(sdata);
+  if (sdata->log_map)
+    munmap(sdata->log_map, sdata->log_map_len);
+
+  struct LogdbMap *lm = NULL;
+  ARRAY_FOREACH(lm, &sdata->stale)
+  {
+    munmap(lm->addr, lm->len);
+  }
+  ARRAY_FREE(&sdata->stale);
+
+  if (sdata->log_fd >= 0)
+    close(sdata->log_fd);
+  if (sdata->idx_fd >= 0)
+    close(sdata->idx_fd);
+
+  buf_free(&sdata->pending);
+  FREE(&sdata->path);
+  FREE(ptr);
+}
+
+/**
+ * logdb_sdata_new - Create new Log Store Data
+ * @retval ptr New Log Store Data
+ */
+static struct LogdbStoreData *logdb_sdata_new(void)
+{
+  struct LogdbStoreData *sdata = g_new0(struct LogdbStoreData, 1);
+
+  sdata->log_fd = -1;
+  sdata->idx_fd = -1;
+  ARRAY_INIT(&sdata->stale);
+  sdata->pending = buf_new(NULL);
+
+  return sdata;
+}
+
+/**
+ * store_logdb_open - Open a connection to a Store - Implements StoreOps::open() - @ingroup store_open
+ */
+static StoreHandle *store_logdb_open(const char *path, bool create)
+{
+  if (!path)
+    return NULL;
+
+  if (!create && (access(path, F_OK) != 0))
+    return NULL;
+
+  struct LogdbStoreData *sdata = logdb_sdata_new();
+  sdata->path = mutt_str_dup(path);
+
+  // The writer holds a lock on the index; the log is replaced by compaction
+  struct Buffer *idx_path = buf_pool_get();
+  buf_printf(idx_path, "%s.idx", path);
+  sdata->idx_fd = open(buf_string(idx_path), O_RDWR | O_CREAT, 0644);
+  if ((sdata->idx_fd < 0) || (flock(sdata->idx_fd, LOCK_EX | LOCK_NB) != 0))
+  {
+    log_debug1("%s is in use, opening it read-only", path);
+    sdata->readonly = true;
+    if (sdata->idx_fd < 0)
+      sdata->idx_fd = open(buf_string(idx_path), O_RDONLY);
+  }
+  buf_pool_release(&idx_path);
+
+  sdata->log_fd = open(path, sdata->readonly ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+  if (sdata->log_fd < 0)
+  {
+    log_debug1("open: %s: %s", path, strerror(errno));
+    goto fail;
+  }
+
+  struct stat st = { 0 };
+  char magic[sizeof(LogdbLogMagic)] = { 0 };
+  if (fstat(sdata->log_fd, &st) != 0)
+    goto fail;
+
+  if ((size_t) st.st_size < sizeof(LogdbLogMagic))
+  {
+    if (!sdata->readonly &&
+        ((ftruncate(sdata->log_fd, 0) != 0) ||
+         (logdb_write_all(sdata->log_fd, LogdbLogMagic, sizeof(LogdbLogMagic), 0) != 0)))
+    {
+      goto fail;
+    }
+    sdata->log_len = sdata->readonly ? 0 : sizeof(LogdbLogMagic);
+  }
+  else
+  {
+    if ((pread(sdata->log_fd, magic, sizeof(magic), 0) != sizeof(magic)) ||
+        (memcmp(magic, LogdbLogMagic, sizeof(magic)) != 0))
+    {
+      log_debug1("%s: not a log store", path);
+      goto fail;
+    }
+    sdata->log_len = st.st_size;
+  }
+
+  if (!logdb_map_log(sdata))
+    goto fail;
+
+  if (((sdata->idx_fd < 0) || !logdb_idx_load(sdata)) && !logdb_idx_rebuild(sdata))
+    goto fail;
+
+  if (!sdata->readonly)
+    sdata->idx->clean = 0;
+
+  // Return an opaque pointer
+  return (StoreHandle *) sdata;
+
+fail:
+  logdb_sdata_free(&sdata);
+  return NULL;
+}
+
+/**
+ * store_logdb_fetch - Fetch a Value from the Store - Implements StoreOps::fetch() - @ingroup store_fetch
+ *
+ * The Value points into the mapping of the log; it isn't copied.
+ */
+static void *store_logdb_fetch(StoreHandle *store, const char *key, size_t klen, size_t *vlen)
+{
+  if (!store || !key)
+    return NULL;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  const uint64_t hash = logdb_hash(key, klen);
+  const struct LogdbSlot *slot = &sdata->slots[logdb_idx_find(sdata, key, klen, hash)];
+  if (slot->offset == 0)
+    return NULL;
+
+  // Values are only handed out from the log, so commit a pending one
+  if ((slot->offset >= sdata->log_len) && (logdb_commit(sdata) != 0))
+    return NULL;
+
+  const struct LogdbRecord *rec = logdb_record(sdata, slot->offset);
+  if (!rec || (rec->vlen == LOGDB_TOMBSTONE))
+    return NULL;
+
+  sdata->refs++;
+  *vlen = rec->vlen;
+  return (char *) (rec + 1) + logdb_pad(rec->klen);
+}
+
+/**
+ * store_logdb_free - Free a Value returned by fetch() - Implements StoreOps::free() - @ingroup store_free
+ */
+static void store_logdb_free(StoreHandle *store, void **ptr)
+{
+  if (!store || !ptr || !*ptr)
+    return;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  /* The data is owned by the mapping */
+  sdata->refs--;
+  *ptr = NULL;
+}
+
+/**
+ * store_logdb_store - Write a Value to the Store - Implements StoreOps::store() - @ingroup store_store
+ */
+static int store_logdb_store(StoreHandle *store, const char *key, size_t klen,
+                             void *value, size_t vlen)
+{
+  if (!store || !key)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  if (sdata->readonly || (klen >= UINT32_MAX) || (vlen >= UINT32_MAX))
+    return -1;
+
+  // Buffers grow in small steps, so make room for a whole group
+  if (sdata->pending->dsize < LOGDB_COMMIT_BYTES)
+    buf_alloc(sdata->pending, LOGDB_COMMIT_BYTES + 4096);
+
+  static const char zeros[8] = { 0 };
+  const struct LogdbRecord hdr = { LOGDB_RECORD_MAGIC, klen, vlen, 0 };
+  const uint64_t offset = sdata->log_len + buf_len(sdata->pending);
+
+  buf_addstr_n(sdata->pending, (const char *) &hdr, sizeof(hdr));
+  buf_addstr_n(sdata->pending, key, klen);
+  buf_addstr_n(sdata->pending, zeros, logdb_pad(klen) - klen);
+  buf_addstr_n(sdata->pending, value, vlen);
+  buf_addstr_n(sdata->pending, zeros, logdb_pad(vlen) - vlen);
+
+  if (!logdb_idx_apply(sdata, logdb_record(sdata, offset), offset))
+    return -1;
+
+  if (buf_len(sdata->pending) >= LOGDB_COMMIT_BYTES)
+  {
+    if (logdb_commit(sdata) != 0)
+      return -1;
+    logdb_compact(sdata, false);
+  }
+
+  return 0;
+}
+
+/**
+ * store_logdb_delete_record - Delete a record from the Store - Implements StoreOps::delete_record() - @ingroup store_delete_record
+ */
+static int store_logdb_delete_record(StoreHandle *store, const char *key, size_t klen)
+{
+  if (!store || !key)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  if (sdata->readonly || (klen >= UINT32_MAX))
+    return -1;
+
+  const uint64_t hash = logdb_hash(key, klen);
+  if (sdata->slots[logdb_idx_find(sdata, key, klen, hash)].offset == 0)
+    return 0;
+
+  // A tombstone stops the key coming back if the index is rebuilt
+  static const char zeros[8] = { 0 };
+  const struct LogdbRecord hdr = { LOGDB_RECORD_MAGIC, klen, LOGDB_TOMBSTONE, 0 };
+  const uint64_t offset = sdata->log_len + buf_len(sdata->pending);
+
+  buf_addstr_n(sdata->pending, (const char *) &hdr, sizeof(hdr));
+  buf_addstr_n(sdata->pending, key, klen);
+  buf_addstr_n(sdata->pending, zeros, logdb_pad(klen) - klen);
+
+  if (!logdb_idx_apply(sdata, logdb_record(sdata, offset), offset))
+    return -1;
+
+  if (buf_len(sdata->pending) >= LOGDB_COMMIT_BYTES)
+    return logdb_commit(sdata);
+
+  return 0;
+}
+
+/**
+ * store_logdb_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_logdb_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  if (sdata->readonly)
+    return 0;
+
+  return logdb_commit(sdata);
+}
+
+/**
+ * store_logdb_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_logdb_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  // Deleted keys aren't in the index, so every slot is a live key
+  const size_t num_slots = sdata->idx->num_slots;
+  for (size_t i = 0; i < num_slots; i++)
+  {
+    if (sdata->slots[i].offset == 0)
+      continue;
+
+    const struct LogdbRecord *rec = logdb_record(sdata, sdata->slots[i].offset);
+    if (!rec)
+      return -1;
+
+    if (!cb((const char *) (rec + 1), rec->klen, wdata))
+      break;
+  }
+
+  return 0;
+}
+
+/**
+ * store_logdb_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_logdb_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = store;
+
+  if (sdata->readonly || (logdb_commit(sdata) != 0))
+    return -1;
+
+  logdb_compact(sdata, true);
+  return 0;
+}
+
+/**
+ * store_logdb_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
+ */
+static void store_logdb_close(StoreHandle **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  // Decloak an opaque pointer
+  struct LogdbStoreData *sdata = *ptr;
+
+  if (!sdata->readonly && (logdb_commit(sdata) == 0))
+  {
+    logdb_compact(sdata, false);
+    if (fdatasync(sdata->log_fd) == 0)
+    {
+      sdata->idx->log_len = sdata->log_len;
+      sdata->idx->clean = 1;
+      msync(sdata->idx, sdata->idx_map_len, MS_ASYNC);
+    }
+  }
+
+  logdb_sdata_free((struct LogdbStoreData **) ptr);
+}
+
+/**
+ * store_logdb_version - Get a Store version string - Implements StoreOps::version() - @ingroup store_version
+ */
+static const char *store_logdb_version(void)
+{
+  return "logdb 1";
+}
+
+STORE_BACKEND_OPS(logdb)
@@ -107,6 +107,61 @@ static int store_qdbm_delete_record(StoreHandle *store, const char *key, size_t
   return success ? 0 : dpecode ? dpecode : -1;
 }
 
+/**
+ * store_qdbm_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_qdbm_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  VILLA *db = store;
+  return vlsync(db) ? 0 : -1;
+}
+
+/**
+ * store_qdbm_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_qdbm_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  VILLA *db = store;
+  if (!vlcurfirst(db))
+    return 0;
+
+  do
+  {
+    int klen = 0;
+    char *key = vlcurkey(db, &klen);
+    if (!key)
+      break;
+
+    const bool more = cb(key, klen, wdata);
+    FREE(&key);
+    if (!more)
+      break;
+  } while (vlcurnext(db));
+
+  return 0;
+}
+
+/**
+ * store_qdbm_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_qdbm_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  VILLA *db = store;
+  return vloptimize(db) ? 0 : -1;
+}
+
 /**
  * store_qdbm_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
@@ -193,6 +193,67 @@ static int store_rocksdb_delete_record(StoreHandle *store, const char *key, size
   return 0;
 }
 
+/**
+ * store_rocksdb_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_rocksdb_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Writes go straight to the database
+  return 0;
+}
+
+/**
+ * store_rocksdb_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_rocksdb_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct RocksDbStoreData *sdata = store;
+
+  rocksdb_iterator_t *it = rocksdb_create_iterator(sdata->db, sdata->read_options);
+  for (rocksdb_iter_seek_to_first(it); rocksdb_iter_valid(it); rocksdb_iter_next(it))
+  {
+    size_t klen = 0;
+    const char *key = rocksdb_iter_key(it, &klen);
+    if (!cb(key, klen, wdata))
+      break;
+  }
+
+  int rc = 0;
+  rocksdb_iter_get_error(it, &sdata->err);
+  if (sdata->err)
+  {
+    rocksdb_free(sdata->err);
+    sdata->err = NULL;
+    rc = -1;
+  }
+
+  rocksdb_iter_destroy(it);
+  return rc;
+}
+
+/**
+ * store_rocksdb_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_rocksdb_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  struct RocksDbStoreData *sdata = store;
+
+  // Compact the whole key range, dropping the tombstones
+  rocksdb_compact_range(sdata->db, NULL, 0, NULL, 0);
+  return 0;
+}
+
 /**
  * store_rocksdb_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
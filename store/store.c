@@ -38,6 +38,7 @@ STORE_BACKEND(bdb)
 STORE_BACKEND(gdbm)
 STORE_BACKEND(kyotocabinet)
 STORE_BACKEND(lmdb)
+STORE_BACKEND(logdb)
 STORE_BACKEND(qdbm)
 STORE_BACKEND(rocksdb)
 STORE_BACKEND(tdb)
@@ -71,6 +72,9 @@ static const struct StoreOps *StoreOps[] = {
 #endif
 #ifdef HAVE_LMDB
   &store_lmdb_ops,
+#endif
+#ifdef HAVE_LOGDB
+  &store_logdb_ops,
 #endif
   NULL,
 };
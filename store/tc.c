@@ -31,6 +31,7 @@
 #include "config.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <tcbdb.h>
 #include <tcutil.h>
 #include "mutt/lib.h"
@@ -122,6 +123,68 @@ static int store_tokyocabinet_delete_record(StoreHandle *store, const char *key,
   return 0;
 }
 
+/**
+ * store_tokyocabinet_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_tokyocabinet_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  TCBDB *db = store;
+  return tcbdbsync(db) ? 0 : -1;
+}
+
+/**
+ * store_tokyocabinet_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_tokyocabinet_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  TCBDB *db = store;
+  BDBCUR *cur = tcbdbcurnew(db);
+  if (!cur)
+    return -1;
+
+  if (tcbdbcurfirst(cur))
+  {
+    do
+    {
+      int klen = 0;
+      const char *key = tcbdbcurkey3(cur, &klen);
+      if (!key || !cb(key, klen, wdata))
+        break;
+    } while (tcbdbcurnext(cur));
+  }
+
+  tcbdbcurdel(cur);
+  return 0;
+}
+
+/**
+ * store_tokyocabinet_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_tokyocabinet_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  TCBDB *db = store;
+  // Rebuild the file, keeping all the current tuning parameters
+  if (!tcbdboptimize(db, 0, 0, 0, -1, -1, UINT8_MAX))
+  {
+    int ecode = tcbdbecode(db);
+    log_debug2("tcbdboptimize failed: %s (ecode %d)", tcbdberrmsg(ecode), ecode);
+    return -1;
+  }
+  return 0;
+}
+
 /**
  * store_tokyocabinet_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
@@ -128,6 +128,65 @@ static int store_tdb_delete_record(StoreHandle *store, const char *key, size_t k
   return tdb_delete(db, dkey);
 }
 
+/**
+ * struct TdbWalk - Private data for tdb_walk_key()
+ */
+struct TdbWalk
+{
+  store_walk_t cb; ///< Callback function
+  void *wdata;     ///< Private data for the callback
+};
+
+/**
+ * tdb_walk_key - Pass a Key to a Store walk callback - Implements tdb_traverse_func
+ */
+static int tdb_walk_key(TDB_CONTEXT *db, TDB_DATA key, TDB_DATA data, void *private_data)
+{
+  struct TdbWalk *tw = private_data;
+  // A non-zero return stops the traversal
+  return tw->cb((const char *) key.dptr, key.dsize, tw->wdata) ? 0 : 1;
+}
+
+/**
+ * store_tdb_sync - Commit the writes made so far - Implements StoreOps::sync() - @ingroup store_sync
+ */
+static int store_tdb_sync(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Writes go straight to the file
+  return 0;
+}
+
+/**
+ * store_tdb_walk - Call a function for every Key in the Store - Implements StoreOps::walk() - @ingroup store_walk
+ */
+static int store_tdb_walk(StoreHandle *store, store_walk_t cb, void *wdata)
+{
+  if (!store || !cb)
+    return -1;
+
+  // Decloak an opaque pointer
+  TDB_CONTEXT *db = store;
+  struct TdbWalk tw = { cb, wdata };
+
+  return (tdb_traverse_read(db, tdb_walk_key, &tw) < 0) ? -1 : 0;
+}
+
+/**
+ * store_tdb_compact - Reclaim the space used by deleted records - Implements StoreOps::compact() - @ingroup store_compact
+ */
+static int store_tdb_compact(StoreHandle *store)
+{
+  if (!store)
+    return -1;
+
+  // Decloak an opaque pointer
+  TDB_CONTEXT *db = store;
+  return (tdb_repack(db) == 0) ? 0 : -1;
+}
+
 /**
  * store_tdb_close - Close a Store connection - Implements StoreOps::close() - @ingroup store_close
  */
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * Test code for arena_alloc()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mutt/lib.h"
+
+void test_arena_alloc(void)
+{
+  // void *arena_alloc(struct Arena *arena, size_t size);
+
+  {
+    TEST_CHECK(arena_alloc(NULL, 16) == NULL);
+  }
+
+  {
+    struct Arena *arena = arena_new(0);
+    TEST_CHECK(arena != NULL);
+
+    // Allocations are zeroed, aligned and don't overlap
+    char *prev = NULL;
+    for (size_t i = 0; i < 1000; i++)
+    {
+      const size_t size = (i % 37) + 1;
+      char *ptr = arena_alloc(arena, size);
+      TEST_CHECK(ptr != NULL);
+      TEST_CHECK(((uintptr_t) ptr % 16) == 0);
+      for (size_t j = 0; j < size; j++)
+        TEST_CHECK(ptr[j] == 0);
+      memset(ptr, 0xff, size);
+      TEST_CHECK(ptr != prev);
+      prev = ptr;
+    }
+
+    arena_free(&arena);
+    TEST_CHECK(arena == NULL);
+  }
+
+  {
+    // Oversized allocations get their own chunk
+    struct Arena *arena = arena_new(1024);
+    char *small = arena_alloc(arena, 32);
+    char *big = arena_alloc(arena, 4096);
+    char *next = arena_alloc(arena, 32);
+    TEST_CHECK(small != NULL);
+    TEST_CHECK(big != NULL);
+    TEST_CHECK(next == (small + 32));
+    TEST_CHECK(arena->allocated == (32 + 4096 + 32));
+    arena_free(&arena);
+  }
+
+  {
+    arena_free(NULL);
+    struct Arena *arena = NULL;
+    arena_free(&arena);
+  }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * Test code for arena_owns()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+
+void test_arena_owns(void)
+{
+  // bool arena_owns(const struct Arena *arena, const void *ptr);
+
+  {
+    int i = 0;
+    TEST_CHECK(!arena_owns(NULL, &i));
+  }
+
+  {
+    struct Arena *arena = arena_new(256);
+    TEST_CHECK(!arena_owns(arena, NULL));
+
+    void *ptr1 = arena_alloc(arena, 16);
+    void *ptr2 = arena_alloc(arena, 1000);
+    int i = 0;
+
+    TEST_CHECK(arena_owns(arena, ptr1));
+    TEST_CHECK(arena_owns(arena, ptr2));
+    TEST_CHECK(!arena_owns(arena, &i));
+
+    struct Arena *other = arena_new(256);
+    TEST_CHECK(!arena_owns(other, ptr1));
+    arena_free(&other);
+    arena_free(&arena);
+  }
+}
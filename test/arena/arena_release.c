@@ -0,0 +1,70 @@
+/**
+ * @file
+ * Test code for arena_release()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+
+void test_arena_release(void)
+{
+  // struct Arena *arena_ref(struct Arena *arena);
+  // void arena_release(struct Arena **ptr);
+
+  {
+    TEST_CHECK(arena_ref(NULL) == NULL);
+    arena_release(NULL);
+
+    struct Arena *arena = NULL;
+    arena_release(&arena);
+    TEST_CHECK(arena == NULL);
+  }
+
+  {
+    struct Arena *arena = arena_new(256);
+    TEST_CHECK(arena->refs == 1);
+    arena_release(&arena);
+    TEST_CHECK(arena == NULL);
+  }
+
+  {
+    struct Arena *arena = arena_new(256);
+    struct Arena *user = arena_ref(arena);
+    TEST_CHECK(user == arena);
+    TEST_CHECK(arena->refs == 2);
+
+    int *ptr = arena_alloc(arena, sizeof(int));
+    *ptr = 42;
+
+    // The owner lets go, but the memory is still in use
+    struct Arena *owner = arena;
+    arena_release(&owner);
+    TEST_CHECK(owner == NULL);
+    TEST_CHECK(user->refs == 1);
+    TEST_CHECK(arena_owns(user, ptr));
+    TEST_CHECK(*ptr == 42);
+
+    arena_release(&user);
+    TEST_CHECK(user == NULL);
+  }
+}
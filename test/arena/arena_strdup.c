@@ -0,0 +1,52 @@
+/**
+ * @file
+ * Test code for arena_strdup()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "test_common.h"
+
+void test_arena_strdup(void)
+{
+  // char *arena_strdup(struct Arena *arena, const char *str);
+
+  {
+    TEST_CHECK(arena_strdup(NULL, "apple") == NULL);
+  }
+
+  {
+    struct Arena *arena = arena_new(0);
+    TEST_CHECK(arena_strdup(arena, NULL) == NULL);
+
+    const char *str = "apple";
+    char *copy = arena_strdup(arena, str);
+    TEST_CHECK(copy != str);
+    TEST_CHECK_STR_EQ(copy, str);
+    TEST_CHECK(arena_owns(arena, copy));
+
+    copy = arena_strdup(arena, "");
+    TEST_CHECK_STR_EQ(copy, "");
+    arena_free(&arena);
+  }
+}
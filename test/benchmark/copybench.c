@@ -0,0 +1,183 @@
+/**
+ * @file
+ * Compare kernel and stdio file copying
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bench_copy Compare kernel and stdio file copying
+ *
+ * Time the copies that dominate rewriting a large mbox:
+ *
+ * | Stage       | Work                                                     |
+ * | :---------- | :------------------------------------------------------- |
+ * | copy_stream | Copy a whole mailbox to a new file                       |
+ * | copy_tail   | Copy the second half back into place, like mbox_mbox_sync() |
+ *
+ * Each stage is run twice: "kernel" is mutt_file_copy_stream(), which uses
+ * copy_file_range() where it can, and "stdio" is the previous read/write loop.
+ * The items are megabytes copied.
+ *
+ * Usage: `make benchmark BENCH_ARGS="-c 4096"` for a 4GB mailbox.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "copybench.h"
+#include "stats.h"
+
+/**
+ * copy_stdio - Copy a stream, the old way
+ * @param fp_in  Source file
+ * @param fp_out Destination file
+ * @retval num Number of bytes copied
+ * @retval -1  Error
+ */
+static ssize_t copy_stdio(FILE *fp_in, FILE *fp_out)
+{
+  size_t total = 0;
+  size_t l;
+  char buf[1024] = { 0 };
+
+  while ((l = fread(buf, 1, sizeof(buf), fp_in)) > 0)
+  {
+    if (fwrite(buf, 1, l, fp_out) != l)
+      return -1;
+    total += l;
+  }
+
+  if (fflush(fp_out) != 0)
+    return -1;
+  return total;
+}
+
+/**
+ * copy_make_mailbox - Create a large mbox-like file
+ * @param path    Path for the file
+ * @param size_mb Size in megabytes
+ * @retval true Success
+ */
+static bool copy_make_mailbox(const char *path, int size_mb)
+{
+  FILE *fp = mutt_file_fopen(path, "w");
+  if (!fp)
+    return false;
+
+  // One megabyte of short emails
+  struct Buffer *block = buf_pool_get();
+  for (int i = 0; buf_len(block) < (1024 * 1024); i++)
+  {
+    buf_add_printf(block,
+                   "From bench@example.com Mon Jan  1 00:00:00 2024\n"
+                   "From: Bench <bench@example.com>\n"
+                   "Subject: Email %d\n\n"
+                   "The quick brown fox jumps over the lazy dog.\n\n",
+                   i);
+  }
+
+  bool rc = true;
+  for (int i = 0; rc && (i < size_mb); i++)
+    rc = (fwrite(buf_string(block), 1, 1024 * 1024, fp) == (1024 * 1024));
+
+  buf_pool_release(&block);
+  return (mutt_file_fclose(&fp) == 0) && rc;
+}
+
+/**
+ * copy_run - Time one implementation
+ * @param src     Path of the mailbox
+ * @param dst     Path for the copy
+ * @param size_mb Size of the mailbox in megabytes
+ * @param kernel  Use mutt_file_copy_stream()
+ * @param version Version string for the report
+ * @param fp      File for the results
+ */
+static void copy_run(const char *src, const char *dst, int size_mb, bool kernel,
+                     const char *version, FILE *fp)
+{
+  struct BenchSample bs = { 0 };
+  struct BenchResult br = { "copy_stream", kernel ? "kernel" : "stdio", size_mb };
+  ssize_t (*copy)(FILE *, FILE *) = kernel ? mutt_file_copy_stream : copy_stdio;
+
+  FILE *fp_in = mutt_file_fopen(src, "r");
+  FILE *fp_out = mutt_file_fopen(dst, "w+");
+  if (!fp_in || !fp_out)
+  {
+    fprintf(stderr, "Can't open %s or %s\n", src, dst);
+    goto done;
+  }
+
+  bench_start(&bs);
+  if (copy(fp_in, fp_out) < 0)
+    fprintf(stderr, "copy_stream: copy failed\n");
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  // Rewrite the copy from the middle, with the second half of the mailbox
+  const off_t half = (off_t) (size_mb / 2) * 1024 * 1024;
+  br.stage = "copy_tail";
+  br.items = size_mb - (size_mb / 2);
+  bench_start(&bs);
+  if (!mutt_file_seek(fp_in, half, SEEK_SET) || !mutt_file_seek(fp_out, half, SEEK_SET) ||
+      (copy(fp_in, fp_out) < 0) || (ftruncate(fileno(fp_out), ftello(fp_out)) != 0))
+  {
+    fprintf(stderr, "copy_tail: copy failed\n");
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+done:
+  mutt_file_fclose(&fp_in);
+  mutt_file_fclose(&fp_out);
+  unlink(dst);
+}
+
+/**
+ * bench_copy - Compare kernel and stdio file copying
+ * @param dir     Directory for the files
+ * @param size_mb Size of the mailbox in megabytes
+ * @param version Version string for the report
+ * @param fp      File for the results
+ */
+void bench_copy(const char *dir, int size_mb, const char *version, FILE *fp)
+{
+  struct Buffer *src = buf_pool_get();
+  struct Buffer *dst = buf_pool_get();
+  buf_printf(src, "%s/copy-src", dir);
+  buf_printf(dst, "%s/copy-dst", dir);
+
+  if (copy_make_mailbox(buf_string(src), size_mb))
+  {
+    copy_run(buf_string(src), buf_string(dst), size_mb, false, version, fp);
+    copy_run(buf_string(src), buf_string(dst), size_mb, true, version, fp);
+  }
+  else
+  {
+    fprintf(stderr, "Can't create %s\n", buf_string(src));
+  }
+
+  unlink(buf_string(src));
+  buf_pool_release(&src);
+  buf_pool_release(&dst);
+}
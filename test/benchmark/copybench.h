@@ -0,0 +1,30 @@
+/**
+ * @file
+ * Compare kernel and stdio file copying
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_BENCHMARK_COPYBENCH_H
+#define TEST_BENCHMARK_COPYBENCH_H
+
+#include <stdio.h>
+
+void bench_copy(const char *dir, int size_mb, const char *version, FILE *fp);
+
+#endif /* TEST_BENCHMARK_COPYBENCH_H */
@@ -0,0 +1,394 @@
+/**
+ * @file
+ * Generate synthetic mailboxes for benchmarking
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bench_corpus Generate synthetic mailboxes
+ *
+ * Generate mbox, Maildir and MH mailboxes containing the same set of emails.
+ *
+ * The emails are arranged into threads: each email either starts a new thread,
+ * or replies to an email in one of the recently active threads.  Replies carry
+ * `In-Reply-To` and `References` headers, a "Re:" subject and quoted text, so
+ * the threading and pattern code have realistic work to do.
+ *
+ * The generator is deterministic for a given CorpusConfig.
+ */
+
+#include "config.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "mutt/lib.h"
+#include "corpus.h"
+
+/// Timestamp of the first email, 2024-01-01 00:00:00 UTC
+#define CORPUS_EPOCH 1704067200
+
+/// Maximum number of ancestors listed in the References header
+#define CORPUS_MAX_REFS 20
+
+/**
+ * struct CorpusEmail - Position of one email in the threads
+ */
+struct CorpusEmail
+{
+  int parent; ///< Index of the email being replied to, or -1
+  int thread; ///< Thread number
+  int depth;  ///< Depth in the thread, 0 for the root
+};
+
+/// Names of the authors of the emails
+static const char *const Names[] = {
+  "Alice Archer",  "Bob Baker",     "Carol Carter", "Dave Dawson",
+  "Erin Evans",    "Frank Fisher",  "Grace Green",  "Heidi Hughes",
+  "Ivan Irving",   "Judy Jones",    "Mallory Moss", "Niaj Nolan",
+  "Olivia Owens",  "Peggy Parker",  "Rupert Reed",  "Sybil Stone",
+};
+
+/// Words for the subjects and bodies
+static const char *const Words[] = {
+  "address", "buffer",  "cache",   "config",  "display", "email",  "folder",
+  "header",  "index",   "key",     "limit",   "mailbox", "message", "notify",
+  "pager",   "pattern", "quote",   "reply",   "search",  "sidebar", "sort",
+  "string",  "thread",  "update",  "view",    "window",  "zone",   "the",
+  "a",       "of",      "and",     "to",      "in",      "is",     "it",
+};
+
+/**
+ * corpus_rand - Generate a pseudo-random number
+ * @param state Generator state, updated
+ * @retval num Random number
+ *
+ * This is xorshift32, which is fast, deterministic and good enough for shaping
+ * test data.
+ */
+static uint32_t corpus_rand(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * corpus_email_seed - Get the random seed for one email
+ * @param cc  Corpus config
+ * @param idx Index of the email
+ * @retval num Seed
+ *
+ * Every email gets its own seed, so it has the same contents in every format.
+ */
+static uint32_t corpus_email_seed(const struct CorpusConfig *cc, int idx)
+{
+  uint32_t seed = cc->seed ^ ((uint32_t) (idx + 1) * 2654435761U);
+  return (seed == 0) ? 1 : seed;
+}
+
+/**
+ * corpus_plan - Arrange the emails into threads
+ * @param cc Corpus config
+ * @retval ptr Array of cc->num_emails CorpusEmail
+ */
+static struct CorpusEmail *corpus_plan(const struct CorpusConfig *cc)
+{
+  struct CorpusEmail *plan = g_new0(struct CorpusEmail, cc->num_emails);
+  const int active = MAX(cc->active_threads, 1);
+  int *latest = g_new0(int, active);
+  uint32_t rng = (cc->seed == 0) ? 1 : cc->seed;
+  int num_threads = 0;
+
+  for (int i = 0; i < cc->num_emails; i++)
+  {
+    if ((num_threads == 0) || ((int) (corpus_rand(&rng) % 100) < cc->new_thread_pct))
+    {
+      plan[i].parent = -1;
+      plan[i].thread = num_threads;
+      plan[i].depth = 0;
+      latest[num_threads % active] = i;
+      num_threads++;
+      continue;
+    }
+
+    // Reply to the latest email in a recent thread, or to one of its ancestors
+    const int slot = corpus_rand(&rng) % MIN(num_threads, active);
+    int parent = latest[slot];
+    for (int up = corpus_rand(&rng) % 3; (up > 0) && (plan[parent].parent >= 0); up--)
+      parent = plan[parent].parent;
+
+    plan[i].parent = parent;
+    plan[i].thread = plan[parent].thread;
+    plan[i].depth = plan[parent].depth + 1;
+    latest[slot] = i;
+  }
+
+  FREE(&latest);
+  return plan;
+}
+
+/**
+ * corpus_write_words - Write some random words
+ * @param fp    File to write to
+ * @param rng   Generator state
+ * @param count Number of words
+ */
+static void corpus_write_words(FILE *fp, uint32_t *rng, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (i > 0)
+      fputc(' ', fp);
+    fputs(Words[corpus_rand(rng) % mutt_array_size(Words)], fp);
+  }
+}
+
+/**
+ * corpus_write_subject - Write the subject of the root of a thread
+ * @param fp     File to write to
+ * @param cc     Corpus config
+ * @param plan   Thread plan
+ * @param idx    Index of the email
+ */
+static void corpus_write_subject(FILE *fp, const struct CorpusConfig *cc,
+                                 const struct CorpusEmail *plan, int idx)
+{
+  while (plan[idx].parent >= 0)
+    idx = plan[idx].parent;
+
+  uint32_t rng = corpus_email_seed(cc, idx);
+  fprintf(fp, "[topic %d] ", plan[idx].thread);
+  corpus_write_words(fp, &rng, 3 + (corpus_rand(&rng) % 5));
+}
+
+/**
+ * corpus_write_email - Write one email
+ * @param fp   File to write to
+ * @param cc   Corpus config
+ * @param plan Thread plan
+ * @param idx  Index of the email
+ * @param mbox True if the email needs an mbox "From " line
+ */
+static void corpus_write_email(FILE *fp, const struct CorpusConfig *cc,
+                               const struct CorpusEmail *plan, int idx, bool mbox)
+{
+  uint32_t rng = corpus_email_seed(cc, idx);
+  const char *name = Names[corpus_rand(&rng) % mutt_array_size(Names)];
+  const char *to = Names[corpus_rand(&rng) % mutt_array_size(Names)];
+  const time_t t = CORPUS_EPOCH + ((time_t) idx * 300) + (corpus_rand(&rng) % 300);
+
+  struct tm tm = { 0 };
+  gmtime_r(&t, &tm);
+
+  char user[64] = { 0 };
+  char to_user[64] = { 0 };
+  snprintf(user, sizeof(user), "%s@example.com", name);
+  snprintf(to_user, sizeof(to_user), "%s@example.com", to);
+  for (char *p = user; *p; p++)
+    *p = (*p == ' ') ? '.' : tolower(*p);
+  for (char *p = to_user; *p; p++)
+    *p = (*p == ' ') ? '.' : tolower(*p);
+
+  char date[128] = { 0 };
+  if (mbox)
+  {
+    strftime(date, sizeof(date), "%a %b %e %H:%M:%S %Y", &tm);
+    fprintf(fp, "From %s %s\n", user, date);
+  }
+
+  strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S +0000", &tm);
+  fprintf(fp, "Return-Path: <%s>\n", user);
+  fprintf(fp, "Date: %s\n", date);
+  fprintf(fp, "From: %s <%s>\n", name, user);
+  fprintf(fp, "To: devel@lists.example.org\n");
+  if ((corpus_rand(&rng) % 4) == 0)
+    fprintf(fp, "Cc: %s <%s>\n", to, to_user);
+
+  fputs((plan[idx].parent >= 0) ? "Subject: Re: " : "Subject: ", fp);
+  corpus_write_subject(fp, cc, plan, idx);
+  fputc('\n', fp);
+
+  fprintf(fp, "Message-ID: <%d.%d.bench@example.com>\n", plan[idx].thread, idx);
+
+  if (plan[idx].parent >= 0)
+  {
+    int refs[CORPUS_MAX_REFS] = { 0 };
+    int num_refs = 0;
+    for (int p = plan[idx].parent; (p >= 0) && (num_refs < CORPUS_MAX_REFS); p = plan[p].parent)
+      refs[num_refs++] = p;
+
+    const int parent = plan[idx].parent;
+    fprintf(fp, "In-Reply-To: <%d.%d.bench@example.com>\n", plan[parent].thread, parent);
+    fputs("References:", fp);
+    for (int r = num_refs - 1; r >= 0; r--)
+      fprintf(fp, "\n <%d.%d.bench@example.com>", plan[refs[r]].thread, refs[r]);
+    fputc('\n', fp);
+  }
+
+  fputs("List-Id: Development <devel.lists.example.org>\n", fp);
+  fputs("MIME-Version: 1.0\n", fp);
+  fputs("Content-Type: text/plain; charset=utf-8\n", fp);
+  fputs("Content-Transfer-Encoding: 8bit\n", fp);
+  fputc('\n', fp);
+
+  const int lines = (cc->body_lines / 2) + (corpus_rand(&rng) % (cc->body_lines + 1));
+  for (int i = 0; i < lines; i++)
+  {
+    if ((plan[idx].parent >= 0) && (i < (lines / 3)))
+      fputs("> ", fp);
+    corpus_write_words(fp, &rng, 4 + (corpus_rand(&rng) % 10));
+    fputc('\n', fp);
+  }
+
+  if (mbox)
+    fputc('\n', fp);
+}
+
+/**
+ * corpus_generate_mbox - Generate an mbox mailbox
+ * @param cc   Corpus config
+ * @param path Path of the mailbox file
+ * @retval true Success
+ */
+bool corpus_generate_mbox(const struct CorpusConfig *cc, const char *path)
+{
+  if (!cc || !path)
+    return false;
+
+  FILE *fp = mutt_file_fopen(path, "w");
+  if (!fp)
+    return false;
+
+  struct CorpusEmail *plan = corpus_plan(cc);
+  for (int i = 0; i < cc->num_emails; i++)
+    corpus_write_email(fp, cc, plan, i, true);
+  FREE(&plan);
+
+  return (mutt_file_fclose(&fp) == 0);
+}
+
+/**
+ * corpus_generate_maildir - Generate a Maildir mailbox
+ * @param cc   Corpus config
+ * @param path Path of the mailbox directory
+ * @retval true Success
+ *
+ * Most emails are put in "cur" with some flags set; the newest ones are left in
+ * "new".
+ */
+bool corpus_generate_maildir(const struct CorpusConfig *cc, const char *path)
+{
+  if (!cc || !path)
+    return false;
+
+  static const char *const subdirs[] = { "cur", "new", "tmp" };
+  static const char *const flags[] = { "S", "S", "S", "RS", "FS", "" };
+
+  bool rc = false;
+  struct Buffer *buf = buf_pool_get();
+
+  for (size_t i = 0; i < mutt_array_size(subdirs); i++)
+  {
+    buf_printf(buf, "%s/%s", path, subdirs[i]);
+    if (mutt_file_mkdir(buf_string(buf), S_IRWXU) != 0)
+      goto done;
+  }
+
+  struct CorpusEmail *plan = corpus_plan(cc);
+  const int first_new = cc->num_emails - (cc->num_emails / 10);
+  for (int i = 0; i < cc->num_emails; i++)
+  {
+    const time_t t = CORPUS_EPOCH + ((time_t) i * 300);
+    if (i >= first_new)
+      buf_printf(buf, "%s/new/%lld.R%d.bench", path, (long long) t, i);
+    else
+      buf_printf(buf, "%s/cur/%lld.R%d.bench:2,%s", path, (long long) t, i,
+                 flags[i % mutt_array_size(flags)]);
+
+    FILE *fp = mutt_file_fopen(buf_string(buf), "w");
+    if (!fp)
+    {
+      FREE(&plan);
+      goto done;
+    }
+    corpus_write_email(fp, cc, plan, i, false);
+    mutt_file_fclose(&fp);
+  }
+  FREE(&plan);
+  rc = true;
+
+done:
+  buf_pool_release(&buf);
+  return rc;
+}
+
+/**
+ * corpus_generate_mh - Generate an MH mailbox
+ * @param cc   Corpus config
+ * @param path Path of the mailbox directory
+ * @retval true Success
+ *
+ * The newest emails are listed in the "unseen" sequence.
+ */
+bool corpus_generate_mh(const struct CorpusConfig *cc, const char *path)
+{
+  if (!cc || !path)
+    return false;
+
+  if (mutt_file_mkdir(path, S_IRWXU) != 0)
+    return false;
+
+  bool rc = false;
+  struct Buffer *buf = buf_pool_get();
+
+  struct CorpusEmail *plan = corpus_plan(cc);
+  for (int i = 0; i < cc->num_emails; i++)
+  {
+    buf_printf(buf, "%s/%d", path, i + 1);
+    FILE *fp = mutt_file_fopen(buf_string(buf), "w");
+    if (!fp)
+    {
+      FREE(&plan);
+      goto done;
+    }
+    corpus_write_email(fp, cc, plan, i, false);
+    mutt_file_fclose(&fp);
+  }
+  FREE(&plan);
+
+  buf_printf(buf, "%s/.mh_sequences", path);
+  FILE *fp = mutt_file_fopen(buf_string(buf), "w");
+  if (!fp)
+    goto done;
+
+  const int first_unseen = cc->num_emails - (cc->num_emails / 10);
+  if (first_unseen < cc->num_emails)
+    fprintf(fp, "unseen: %d-%d\n", first_unseen + 1, cc->num_emails);
+  rc = (mutt_file_fclose(&fp) == 0);
+
+done:
+  buf_pool_release(&buf);
+  return rc;
+}
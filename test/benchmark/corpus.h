@@ -0,0 +1,45 @@
+/**
+ * @file
+ * Generate synthetic mailboxes for benchmarking
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_BENCHMARK_CORPUS_H
+#define TEST_BENCHMARK_CORPUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * struct CorpusConfig - Shape of a synthetic corpus
+ */
+struct CorpusConfig
+{
+  int num_emails;     ///< Number of emails in each mailbox
+  int new_thread_pct; ///< Percentage of emails that start a new thread
+  int active_threads; ///< Number of recent threads that replies are spread across
+  int body_lines;     ///< Average number of lines in each body
+  uint32_t seed;      ///< Seed for the random number generator
+};
+
+bool corpus_generate_mbox   (const struct CorpusConfig *cc, const char *path);
+bool corpus_generate_maildir(const struct CorpusConfig *cc, const char *path);
+bool corpus_generate_mh     (const struct CorpusConfig *cc, const char *path);
+
+#endif /* TEST_BENCHMARK_CORPUS_H */
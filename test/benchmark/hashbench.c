@@ -0,0 +1,292 @@
+/**
+ * @file
+ * Compare the Hash Table against a separately-chained one
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bench_hash Compare the Hash Table against a separately-chained one
+ *
+ * Time the common operations on a table of Message-IDs, like the one that
+ * mutt_sort_threads() builds:
+ *
+ * | Stage       | Work                                         |
+ * | :---------- | :------------------------------------------- |
+ * | hash_insert | Insert every key                             |
+ * | hash_find   | Look up every key, plus as many missing ones |
+ * | hash_delete | Delete every key                             |
+ *
+ * Each stage is run twice: "open" is mutt_hash_*() and "chained" is the
+ * previous implementation, one malloc per element, a fixed number of buckets
+ * and an additive string hash.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "hashbench.h"
+#include "stats.h"
+
+/**
+ * struct ChainElem - An element of the chained Hash Table
+ */
+struct ChainElem
+{
+  const char *key;        ///< Key
+  void *data;             ///< User data
+  struct ChainElem *next; ///< Next element in the bucket
+};
+
+/**
+ * struct ChainTable - A separately-chained Hash Table
+ */
+struct ChainTable
+{
+  size_t num_elems;         ///< Number of buckets
+  struct ChainElem **table; ///< Buckets
+};
+
+/**
+ * chain_hash - Hash a string, the old way
+ * @param s         String to hash
+ * @param num_elems Number of buckets
+ * @retval num Bucket
+ */
+static size_t chain_hash(const char *s, size_t num_elems)
+{
+  size_t hash = 0;
+  const unsigned char *p = (const unsigned char *) s;
+  while (*p != '\0')
+    hash += ((hash << 7) + *p++);
+  return (hash * 149711) % num_elems;
+}
+
+/**
+ * chain_new - Create a chained Hash Table
+ * @param num_elems Number of buckets
+ * @retval ptr New Hash Table
+ */
+static struct ChainTable *chain_new(size_t num_elems)
+{
+  struct ChainTable *table = g_new0(struct ChainTable, 1);
+  table->num_elems = (num_elems == 0) ? 2 : num_elems;
+  table->table = g_malloc0_n(table->num_elems, sizeof(struct ChainElem *));
+  return table;
+}
+
+/**
+ * chain_insert - Add a key to a chained Hash Table
+ * @param table Hash Table
+ * @param key   Key
+ * @param data  User data
+ * @retval true The key was added
+ */
+static bool chain_insert(struct ChainTable *table, const char *key, void *data)
+{
+  const size_t hash = chain_hash(key, table->num_elems);
+  struct ChainElem *tmp = NULL, *last = NULL;
+
+  for (tmp = table->table[hash]; tmp; last = tmp, tmp = tmp->next)
+  {
+    const int rc = mutt_str_cmp(tmp->key, key);
+    if (rc == 0)
+      return false;
+    if (rc > 0)
+      break;
+  }
+
+  struct ChainElem *ce = g_new0(struct ChainElem, 1);
+  ce->key = key;
+  ce->data = data;
+  ce->next = tmp;
+  if (last)
+    last->next = ce;
+  else
+    table->table[hash] = ce;
+  return true;
+}
+
+/**
+ * chain_find - Look up a key in a chained Hash Table
+ * @param table Hash Table
+ * @param key   Key
+ * @retval ptr User data
+ */
+static void *chain_find(const struct ChainTable *table, const char *key)
+{
+  const size_t hash = chain_hash(key, table->num_elems);
+  for (struct ChainElem *ce = table->table[hash]; ce; ce = ce->next)
+  {
+    if (mutt_str_equal(ce->key, key))
+      return ce->data;
+  }
+  return NULL;
+}
+
+/**
+ * chain_delete - Remove a key from a chained Hash Table
+ * @param table Hash Table
+ * @param key   Key
+ */
+static void chain_delete(struct ChainTable *table, const char *key)
+{
+  const size_t hash = chain_hash(key, table->num_elems);
+  struct ChainElem **last = &table->table[hash];
+  for (struct ChainElem *ce = *last; ce; last = &ce->next, ce = ce->next)
+  {
+    if (mutt_str_equal(ce->key, key))
+    {
+      *last = ce->next;
+      FREE(&ce);
+      return;
+    }
+  }
+}
+
+/**
+ * chain_free - Free a chained Hash Table
+ * @param ptr Hash Table to free
+ */
+static void chain_free(struct ChainTable **ptr)
+{
+  struct ChainTable *table = *ptr;
+  for (size_t i = 0; i < table->num_elems; i++)
+  {
+    struct ChainElem *ce = table->table[i];
+    while (ce)
+    {
+      struct ChainElem *next = ce->next;
+      FREE(&ce);
+      ce = next;
+    }
+  }
+  FREE(&table->table);
+  FREE(ptr);
+}
+
+/**
+ * bench_hash_keys - Generate some Message-IDs
+ * @param num Number of keys
+ * @retval ptr Array of keys, twice num: present then missing
+ */
+static char **bench_hash_keys(int num)
+{
+  char **keys = g_malloc0_n(num * 2, sizeof(char *));
+  char buf[128] = { 0 };
+  uint32_t seed = 1;
+
+  for (int i = 0; i < (num * 2); i++)
+  {
+    seed = (seed * 1103515245) + 12345;
+    snprintf(buf, sizeof(buf), "<%08x.%d.bench@%s.example.org>", seed, i,
+             (i % 3) ? "mail" : "lists");
+    keys[i] = mutt_str_dup(buf);
+  }
+  return keys;
+}
+
+/**
+ * bench_hash_run - Time one implementation
+ * @param num_keys Number of keys
+ * @param keys     Keys, bench_hash_keys()
+ * @param chained  Use the chained table
+ * @param version  Version string for the report
+ * @param fp       File for the results
+ */
+static void bench_hash_run(int num_keys, char **keys, bool chained,
+                           const char *version, FILE *fp)
+{
+  struct BenchSample bs = { 0 };
+  struct BenchResult br = { "hash_insert", chained ? "chained" : "open", num_keys };
+  struct ChainTable *ct = NULL;
+  struct HashTable *ht = NULL;
+
+  // Sized like the threading table, for a Mailbox half the size
+  const size_t size = MAX(num_keys / 2, 1) * 2;
+
+  bench_start(&bs);
+  if (chained)
+  {
+    ct = chain_new(size);
+    for (int i = 0; i < num_keys; i++)
+      chain_insert(ct, keys[i], keys[i]);
+  }
+  else
+  {
+    ht = mutt_hash_new(size, MUTT_HASH_NO_FLAGS);
+    for (int i = 0; i < num_keys; i++)
+      mutt_hash_insert(ht, keys[i], keys[i]);
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  int found = 0;
+  br.stage = "hash_find";
+  br.items = num_keys * 2;
+  bench_start(&bs);
+  for (int i = 0; i < (num_keys * 2); i++)
+  {
+    if (chained ? chain_find(ct, keys[i]) : mutt_hash_find(ht, keys[i]))
+      found++;
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+  if (found != num_keys)
+    fprintf(stderr, "hash_find: found %d of %d keys\n", found, num_keys);
+
+  br.stage = "hash_delete";
+  br.items = num_keys;
+  bench_start(&bs);
+  for (int i = 0; i < num_keys; i++)
+  {
+    if (chained)
+      chain_delete(ct, keys[i]);
+    else
+      mutt_hash_delete(ht, keys[i], NULL);
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  if (chained)
+    chain_free(&ct);
+  else
+    mutt_hash_free(&ht);
+}
+
+/**
+ * bench_hash - Compare the Hash Table against a separately-chained one
+ * @param num_keys Number of keys
+ * @param version  Version string for the report
+ * @param fp       File for the results
+ */
+void bench_hash(int num_keys, const char *version, FILE *fp)
+{
+  char **keys = bench_hash_keys(num_keys);
+
+  bench_hash_run(num_keys, keys, true, version, fp);
+  bench_hash_run(num_keys, keys, false, version, fp);
+
+  for (int i = 0; i < (num_keys * 2); i++)
+    FREE(&keys[i]);
+  FREE(&keys);
+}
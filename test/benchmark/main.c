@@ -0,0 +1,548 @@
+/**
+ * @file
+ * Benchmark the mailbox, sorting, threading and searching code
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bench_main Benchmark harness
+ *
+ * Generate synthetic mbox, Maildir and MH mailboxes, then run the expensive
+ * parts of NeoMutt over them, without curses:
+ *
+ * | Stage        | Work                                                  |
+ * | :----------- | :---------------------------------------------------- |
+ * | generate     | Write the corpus to disk                              |
+ * | open         | mx_mbox_open(), i.e. mbox_parse_mailbox(), maildir_read_dir() |
+ * | sort         | mutt_sort_headers() by date, without threads          |
+ * | thread       | mutt_sort_headers() with threads, i.e. mutt_sort_threads() |
+ * | pattern      | mutt_pattern_exec() for a set of typical searches      |
+ * | expando      | Render `$index_format` for every email                |
+ * | hcache_store | hcache_store_email() for every email                  |
+ * | hcache_fetch | hcache_fetch_email() for every email                  |
+ * | hash_*       | The Hash Table against the old chained one, see @ref bench_hash |
+ * | copy_*       | Kernel against stdio file copying, see @ref bench_copy |
+ * | store_*      | Every Store backend, see @ref bench_store              |
+ *
+ * Each stage writes one line of JSON, see bench_report().
+ *
+ * Usage: `make benchmark BENCH_ARGS="-n 50000"`
+ */
+
+#include "config.h"
+#include <locale.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "attach/lib.h"
+#include "expando/lib.h"
+#include "pattern/lib.h"
+#include "alternates.h"
+#include "copybench.h"
+#include "corpus.h"
+#include "globals.h"
+#include "hashbench.h"
+#include "hdrline.h"
+#include "init.h"
+#include "muttlib.h"
+#include "mview.h"
+#include "mx.h"
+#include "sort.h"
+#include "stats.h"
+#include "subjectrx.h"
+#ifdef USE_HCACHE
+#include "hcache/lib.h"
+#include "storebench.h"
+#endif
+
+bool StartupComplete = true;
+
+/// Searches run by the pattern stage
+static const char *const BenchPatterns[] = {
+  "~f alice",
+  "~s topic",
+  "~C devel@lists.example.org ~d <1y",
+  "!~N ~s \"cache|thread\"",
+  "~x bench@example.com",
+};
+
+/**
+ * struct BenchOptions - Command line options
+ */
+struct BenchOptions
+{
+  struct CorpusConfig corpus; ///< Shape of the corpus
+  const char *dir;            ///< Directory for the corpus
+  const char *output;         ///< File for the results
+  bool keep;                  ///< Don't delete the corpus afterwards
+  int copy_mb;                ///< Size of the file for the copy stages
+};
+
+/**
+ * usage - Display the command line options
+ * @param name Name of the program
+ */
+static void usage(const char *name)
+{
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -n NUM   Number of emails in each mailbox (default 10000)\n"
+          "  -t PCT   Percentage of emails that start a thread (default 25)\n"
+          "  -a NUM   Number of concurrently active threads (default 50)\n"
+          "  -b NUM   Average number of body lines (default 20)\n"
+          "  -s SEED  Random seed (default 1)\n"
+          "  -c MB    Size of the file for the copy stages (default 256, 0 to skip)\n"
+          "  -d DIR   Directory for the corpus (default: a temporary directory)\n"
+          "  -k       Keep the corpus afterwards\n"
+          "  -o FILE  Write the results to FILE (default: stdout)\n",
+          name);
+}
+
+/**
+ * bench_init - Set up a minimal, headless NeoMutt
+ * @retval ptr Config Set
+ */
+static struct ConfigSet *bench_init(void)
+{
+  logging_init();
+  setlocale(LC_ALL, "");
+  setenv("TZ", "UTC", 1);
+
+  mutt_str_replace(&Username, mutt_str_getenv("USER"));
+  mutt_str_replace(&HomeDir, mutt_str_getenv("HOME"));
+  if (!HomeDir)
+    HomeDir = mutt_str_dup("/");
+
+  OptNoCurses = true;
+
+  struct ConfigSet *cs = cs_new(500);
+  SpaceMutt = spacemutt_new(cs);
+  init_config(cs);
+  subjrx_init();
+  attach_init();
+  alternates_init();
+
+  return cs;
+}
+
+/**
+ * bench_cleanup - Tear down NeoMutt
+ * @param cs Config Set
+ */
+static void bench_cleanup(struct ConfigSet *cs)
+{
+  subjrx_cleanup();
+  attach_cleanup();
+  alternates_cleanup();
+  config_cache_cleanup();
+  spacemutt_free(&SpaceMutt);
+  cs_free(&cs);
+  buf_pool_cleanup();
+}
+
+/**
+ * bench_generate - Generate one mailbox
+ * @param opts    Command line options
+ * @param type    Type of mailbox, "mbox", "maildir" or "mh"
+ * @param path    Path for the mailbox
+ * @param version Version string for the report
+ * @param fp      File for the results
+ * @retval true Success
+ */
+static bool bench_generate(const struct BenchOptions *opts, const char *type,
+                           const char *path, const char *version, FILE *fp)
+{
+  struct BenchSample bs = { 0 };
+  struct BenchResult br = { "generate", type, opts->corpus.num_emails };
+  bool rc = false;
+
+  bench_start(&bs);
+  if (mutt_str_equal(type, "mbox"))
+    rc = corpus_generate_mbox(&opts->corpus, path);
+  else if (mutt_str_equal(type, "maildir"))
+    rc = corpus_generate_maildir(&opts->corpus, path);
+  else
+    rc = corpus_generate_mh(&opts->corpus, path);
+  bench_stop(&bs, &br);
+
+  if (!rc)
+  {
+    fprintf(stderr, "Can't generate %s mailbox: %s\n", type, path);
+    return false;
+  }
+
+  bench_report(fp, version, &br);
+  return true;
+}
+
+/**
+ * bench_pattern - Run some searches over a Mailbox
+ * @param mv MailboxView
+ * @retval num Number of matches
+ */
+static int bench_pattern(struct MailboxView *mv)
+{
+  struct Mailbox *m = mv->mailbox;
+  struct Buffer *err = buf_pool_get();
+  int matches = 0;
+
+  for (size_t i = 0; i < mutt_array_size(BenchPatterns); i++)
+  {
+    PatternList *pat = mutt_pattern_comp(mv, NULL, BenchPatterns[i],
+                                         MUTT_PC_NO_FLAGS, err);
+    if (!pat)
+    {
+      fprintf(stderr, "Can't compile pattern '%s': %s\n", BenchPatterns[i],
+              buf_string(err));
+      continue;
+    }
+
+    struct PatternCache cache = { 0 };
+    for (int j = 0; j < m->msg_count; j++)
+    {
+      struct Email *e = m->emails[j];
+      if (!e)
+        break;
+      if (mutt_pattern_exec(pat->data, MUTT_MATCH_FULL_ADDRESS, m, e, &cache))
+        matches++;
+    }
+    mutt_patternlist_free_full(pat);
+  }
+
+  buf_pool_release(&err);
+  return matches;
+}
+
+/**
+ * bench_expando - Render $index_format for every visible Email
+ * @param m Mailbox
+ * @retval num Number of bytes rendered
+ */
+static int bench_expando(struct Mailbox *m)
+{
+  const struct Expando *c_index_format = cs_subset_expando(SpaceMutt->sub, "index_format");
+  struct Buffer *buf = buf_pool_get();
+  int bytes = 0;
+
+  for (int i = 0; i < m->vcount; i++)
+  {
+    struct Email *e = mutt_get_virt_email(m, i);
+    if (!e)
+      continue;
+
+    buf_reset(buf);
+    mutt_make_string(buf, 200, c_index_format, m, -1, e,
+                     MUTT_FORMAT_TREE | MUTT_FORMAT_INDEX, NULL);
+    bytes += buf_len(buf);
+  }
+
+  buf_pool_release(&buf);
+  return bytes;
+}
+
+#ifdef USE_HCACHE
+/**
+ * bench_hcache_key - Generate the header cache key for an Email
+ * @param buf Buffer for the key
+ * @param e   Email
+ */
+static void bench_hcache_key(struct Buffer *buf, const struct Email *e)
+{
+  if (e->path)
+    buf_strcpy(buf, e->path);
+  else
+    buf_printf(buf, "%d", e->index);
+}
+
+/**
+ * bench_hcache - Store and fetch every Email in the header cache
+ * @param m       Mailbox
+ * @param dir     Directory for the header cache
+ * @param version Version string for the report
+ * @param type    Type of mailbox
+ * @param fp      File for the results
+ */
+static void bench_hcache(struct Mailbox *m, const char *dir, const char *version,
+                         const char *type, FILE *fp)
+{
+  struct HeaderCache *hc = hcache_open(dir, mailbox_path(m), NULL, true);
+  if (!hc)
+  {
+    fprintf(stderr, "Can't open the header cache in %s\n", dir);
+    return;
+  }
+
+  struct Buffer *key = buf_pool_get();
+  struct BenchSample bs = { 0 };
+  struct BenchResult br = { "hcache_store", type, 0 };
+
+  bench_start(&bs);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e)
+      break;
+    bench_hcache_key(key, e);
+    if (hcache_store_email(hc, buf_string(key), buf_len(key), e, 0) == 0)
+      br.items++;
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  br.stage = "hcache_fetch";
+  br.items = 0;
+  bench_start(&bs);
+  for (int i = 0; i < m->msg_count; i++)
+  {
+    struct Email *e = m->emails[i];
+    if (!e)
+      break;
+    bench_hcache_key(key, e);
+    struct HCacheEntry hce = hcache_fetch_email(hc, buf_string(key), buf_len(key), 0);
+    if (hce.email)
+    {
+      br.items++;
+      email_free(&hce.email);
+    }
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  buf_pool_release(&key);
+  hcache_close(&hc);
+}
+#endif
+
+/**
+ * bench_mailbox - Run all the stages on one Mailbox
+ * @param path    Path to the mailbox
+ * @param type    Type of mailbox
+ * @param hc_dir  Directory for the header cache
+ * @param version Version string for the report
+ * @param fp      File for the results
+ * @retval true Success
+ */
+static bool bench_mailbox(const char *path, const char *type, const char *hc_dir,
+                          const char *version, FILE *fp)
+{
+  struct ConfigSubset *sub = SpaceMutt->sub;
+  struct BenchSample bs = { 0 };
+  struct BenchResult br = { "open", type, 0 };
+
+  cs_subset_str_string_set(sub, "use_threads", "flat", NULL);
+  cs_subset_str_string_set(sub, "sort", "date", NULL);
+
+  struct Mailbox *m = mx_path_resolve(path);
+
+  bench_start(&bs);
+  if (!mx_mbox_open(m, MUTT_READONLY | MUTT_QUIET | MUTT_NOSORT))
+  {
+    fprintf(stderr, "Can't open %s mailbox: %s\n", type, path);
+    if (m->account)
+      account_mailbox_remove(m->account, m);
+    mailbox_free(&m);
+    return false;
+  }
+  bench_stop(&bs, &br);
+  br.items = m->msg_count;
+  bench_report(fp, version, &br);
+
+  m->verbose = false;
+  struct MailboxView *mv = mview_new(m, SpaceMutt->notify);
+
+  br.stage = "sort";
+  bench_start(&bs);
+  mutt_sort_headers(mv, true);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  cs_subset_str_string_set(sub, "use_threads", "threads", NULL);
+  br.stage = "thread";
+  bench_start(&bs);
+  mutt_sort_headers(mv, true);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  br.stage = "pattern";
+  bench_start(&bs);
+  br.items = bench_pattern(mv);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  br.stage = "expando";
+  br.items = m->vcount;
+  bench_start(&bs);
+  bench_expando(m);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+#ifdef USE_HCACHE
+  bench_hcache(m, hc_dir, version, type, fp);
+#endif
+
+  mview_free(&mv);
+  mx_mbox_close(m);
+  if (m->account)
+    account_mailbox_remove(m->account, m);
+  mailbox_free(&m);
+
+  return true;
+}
+
+/**
+ * main - Run the benchmarks
+ * @param argc Number of command line arguments
+ * @param argv List of command line arguments
+ * @retval 0 Success
+ * @retval 1 Error
+ */
+int main(int argc, char *argv[])
+{
+  static const char *const types[] = { "mbox", "maildir", "mh" };
+
+  struct BenchOptions opts = {
+    .corpus = { 10000, 25, 50, 20, 1 },
+    .copy_mb = 256,
+  };
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:t:a:b:s:c:d:ko:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        opts.corpus.num_emails = atoi(optarg);
+        break;
+      case 't':
+        opts.corpus.new_thread_pct = atoi(optarg);
+        break;
+      case 'a':
+        opts.corpus.active_threads = atoi(optarg);
+        break;
+      case 'b':
+        opts.corpus.body_lines = atoi(optarg);
+        break;
+      case 's':
+        opts.corpus.seed = strtoul(optarg, NULL, 10);
+        break;
+      case 'c':
+        opts.copy_mb = atoi(optarg);
+        break;
+      case 'd':
+        opts.dir = optarg;
+        break;
+      case 'k':
+        opts.keep = true;
+        break;
+      case 'o':
+        opts.output = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+
+  if ((opts.corpus.num_emails < 1) || (opts.corpus.body_lines < 0) || (opts.copy_mb < 0))
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  struct ConfigSet *cs = bench_init();
+  const char *version = mutt_make_version();
+  int rc = 1;
+
+  FILE *fp = stdout;
+  if (opts.output)
+  {
+    fp = mutt_file_fopen(opts.output, "w");
+    if (!fp)
+    {
+      fprintf(stderr, "Can't open %s\n", opts.output);
+      goto done;
+    }
+  }
+
+  struct Buffer *dir = buf_pool_get();
+  struct Buffer *path = buf_pool_get();
+  struct Buffer *hc_dir = buf_pool_get();
+
+  if (opts.dir)
+  {
+    buf_strcpy(dir, opts.dir);
+    if (mutt_file_mkdir(buf_string(dir), S_IRWXU) != 0)
+    {
+      fprintf(stderr, "Can't create %s\n", buf_string(dir));
+      goto cleanup;
+    }
+  }
+  else
+  {
+    const char *tmp = mutt_str_getenv("TMPDIR");
+    buf_printf(dir, "%s/spacemutt-bench-XXXXXX", tmp ? tmp : "/tmp");
+    if (!mkdtemp(dir->data))
+    {
+      fprintf(stderr, "Can't create a temporary directory\n");
+      goto cleanup;
+    }
+  }
+
+  rc = 0;
+  bench_hash(opts.corpus.num_emails * 10, version, fp);
+  if (opts.copy_mb > 0)
+    bench_copy(buf_string(dir), opts.copy_mb, version, fp);
+#ifdef USE_HCACHE
+  bench_store(buf_string(dir), opts.corpus.num_emails, version, fp);
+#endif
+
+  for (size_t i = 0; i < mutt_array_size(types); i++)
+  {
+    buf_printf(path, "%s/%s", buf_string(dir), types[i]);
+    buf_printf(hc_dir, "%s/hcache-%s/", buf_string(dir), types[i]);
+    mutt_file_mkdir(buf_string(hc_dir), S_IRWXU);
+
+    if (!bench_generate(&opts, types[i], buf_string(path), version, fp) ||
+        !bench_mailbox(buf_string(path), types[i], buf_string(hc_dir), version, fp))
+    {
+      rc = 1;
+    }
+  }
+
+  if (!opts.keep)
+    mutt_file_rmtree(buf_string(dir));
+
+cleanup:
+  buf_pool_release(&dir);
+  buf_pool_release(&path);
+  buf_pool_release(&hc_dir);
+  if (fp != stdout)
+    mutt_file_fclose(&fp);
+done:
+  bench_cleanup(cs);
+  return rc;
+}
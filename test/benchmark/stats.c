@@ -0,0 +1,189 @@
+/**
+ * @file
+ * Measure the cost of a benchmark stage
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bench_stats Measure the cost of a benchmark stage
+ *
+ * Each stage is measured by its wall-clock time, the number of heap
+ * allocations it made and the peak RSS of the process afterwards.
+ *
+ * On glibc, allocations are counted by wrapping malloc(), calloc() and
+ * realloc().  glib's allocators use these, so every allocation in NeoMutt is
+ * seen.  Elsewhere, the allocation counts are reported as `null`.
+ *
+ * The results are written as one JSON object per line.
+ */
+
+#include "config.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include "stats.h"
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+/// Number of allocations made by the process
+static uint64_t AllocCount = 0;
+/// Number of bytes requested by the process
+static uint64_t AllocBytes = 0;
+
+/**
+ * alloc_count - Count an allocation
+ * @param size Number of bytes requested
+ */
+static inline void alloc_count(size_t size)
+{
+  __atomic_add_fetch(&AllocCount, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&AllocBytes, size, __ATOMIC_RELAXED);
+}
+
+/**
+ * malloc - Count calls to malloc()
+ */
+void *malloc(size_t size)
+{
+  alloc_count(size);
+  return __libc_malloc(size);
+}
+
+/**
+ * calloc - Count calls to calloc()
+ */
+void *calloc(size_t nmemb, size_t size)
+{
+  alloc_count(nmemb * size);
+  return __libc_calloc(nmemb, size);
+}
+
+/**
+ * realloc - Count calls to realloc()
+ */
+void *realloc(void *ptr, size_t size)
+{
+  alloc_count(size);
+  return __libc_realloc(ptr, size);
+}
+#endif
+
+/**
+ * bench_now_ns - Read the monotonic clock
+ * @retval num Nanoseconds
+ */
+static uint64_t bench_now_ns(void)
+{
+  struct timespec ts = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * bench_max_rss_kb - Get the peak resident set size of the process
+ * @retval num Peak RSS in KiB, -1 if unknown
+ */
+static long bench_max_rss_kb(void)
+{
+  struct rusage ru = { 0 };
+  if (getrusage(RUSAGE_SELF, &ru) != 0)
+    return -1;
+  return ru.ru_maxrss;
+}
+
+/**
+ * bench_start - Start measuring a stage
+ * @param bs Sample to fill
+ */
+void bench_start(struct BenchSample *bs)
+{
+  if (!bs)
+    return;
+
+#ifdef __GLIBC__
+  bs->allocs = __atomic_load_n(&AllocCount, __ATOMIC_RELAXED);
+  bs->alloc_bytes = __atomic_load_n(&AllocBytes, __ATOMIC_RELAXED);
+#else
+  bs->allocs = 0;
+  bs->alloc_bytes = 0;
+#endif
+  bs->max_rss_kb = bench_max_rss_kb();
+  bs->time_ns = bench_now_ns();
+}
+
+/**
+ * bench_stop - Finish measuring a stage
+ * @param bs Sample taken by bench_start()
+ * @param br Result to fill (stage, mailbox and items are left alone)
+ */
+void bench_stop(const struct BenchSample *bs, struct BenchResult *br)
+{
+  if (!bs || !br)
+    return;
+
+  const uint64_t now = bench_now_ns();
+  br->wall_ms = (double) (now - bs->time_ns) / 1e6;
+
+#ifdef __GLIBC__
+  br->allocs = __atomic_load_n(&AllocCount, __ATOMIC_RELAXED) - bs->allocs;
+  br->alloc_bytes = __atomic_load_n(&AllocBytes, __ATOMIC_RELAXED) - bs->alloc_bytes;
+#else
+  br->allocs = -1;
+  br->alloc_bytes = -1;
+#endif
+
+  /* ru_maxrss is a high-water mark for the whole process.  A stage that
+   * stays below the peak of an earlier stage didn't grow it. */
+  br->process_peak_rss_kb = bench_max_rss_kb();
+  if ((br->process_peak_rss_kb < 0) || (bs->max_rss_kb < 0))
+    br->rss_growth_kb = -1;
+  else
+    br->rss_growth_kb = br->process_peak_rss_kb - bs->max_rss_kb;
+}
+
+/**
+ * bench_report - Write the result of a stage as JSON
+ * @param fp      File to write to
+ * @param version NeoMutt version string
+ * @param br      Result to write
+ */
+void bench_report(FILE *fp, const char *version, const struct BenchResult *br)
+{
+  if (!fp || !br)
+    return;
+
+  fprintf(fp, "{\"version\":\"%s\",\"stage\":\"%s\",\"mailbox\":\"%s\",\"items\":%d,\"wall_ms\":%.3f,",
+          version ? version : "", br->stage, br->mailbox ? br->mailbox : "",
+          br->items, br->wall_ms);
+
+  if (br->allocs < 0)
+    fputs("\"allocs\":null,\"alloc_bytes\":null,", fp);
+  else
+    fprintf(fp, "\"allocs\":%lld,\"alloc_bytes\":%lld,", (long long) br->allocs,
+            (long long) br->alloc_bytes);
+
+  fprintf(fp, "\"rss_growth_kb\":%ld,\"process_peak_rss_kb\":%ld}\n",
+          br->rss_growth_kb, br->process_peak_rss_kb);
+  fflush(fp);
+}
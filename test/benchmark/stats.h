@@ -0,0 +1,59 @@
+/**
+ * @file
+ * Measure the cost of a benchmark stage
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_BENCHMARK_STATS_H
+#define TEST_BENCHMARK_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * struct BenchSample - Snapshot taken at the start of a stage
+ */
+struct BenchSample
+{
+  uint64_t time_ns;     ///< Monotonic clock
+  uint64_t allocs;      ///< Number of allocations so far
+  uint64_t alloc_bytes; ///< Number of bytes allocated so far
+  long max_rss_kb;      ///< Peak resident set size of the process so far
+};
+
+/**
+ * struct BenchResult - Cost of one stage
+ */
+struct BenchResult
+{
+  const char *stage;        ///< Name of the stage, e.g. "sort"
+  const char *mailbox;      ///< Type of mailbox, e.g. "maildir"
+  int items;                ///< Number of items processed
+  double wall_ms;           ///< Elapsed time in milliseconds
+  int64_t allocs;           ///< Number of allocations, -1 if unknown
+  int64_t alloc_bytes;      ///< Number of bytes allocated, -1 if unknown
+  long rss_growth_kb;       ///< Growth of the process's peak RSS during the stage
+  long process_peak_rss_kb; ///< Peak resident set size of the whole process, so far
+};
+
+void bench_start (struct BenchSample *bs);
+void bench_stop  (const struct BenchSample *bs, struct BenchResult *br);
+void bench_report(FILE *fp, const char *version, const struct BenchResult *br);
+
+#endif /* TEST_BENCHMARK_STATS_H */
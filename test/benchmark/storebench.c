@@ -0,0 +1,184 @@
+/**
+ * @file
+ * Compare the Store backends
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page bench_store Compare the Store backends
+ *
+ * Run the header cache's workload against every compiled-in Store backend.
+ * The keys look like Maildir filenames and the values are the size of a
+ * serialised Email.
+ *
+ * | Stage        | Work                                               |
+ * | :----------- | :------------------------------------------------- |
+ * | store_put    | Open a new Store and write every key, then close it |
+ * | store_open   | Reopen the Store                                   |
+ * | store_get    | Fetch every key, plus as many missing ones         |
+ * | store_update | Overwrite a quarter of the keys, e.g. flag changes |
+ * | store_delete | Delete every key, then close the Store             |
+ *
+ * The "mailbox" field of the report holds the name of the backend.
+ */
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "store/lib.h"
+#include "stats.h"
+#include "storebench.h"
+
+/// Size of a typical serialised Email
+#define BENCH_VALUE_LEN 600
+
+/**
+ * bench_store_key - Generate a key for the Store
+ * @param buf Buffer for the key
+ * @param i   Number of the key
+ */
+static void bench_store_key(struct Buffer *buf, int i)
+{
+  buf_printf(buf, "cur/%d.M%dP%d.bench.example.org:2,S", 1700000000 + i,
+             (i * 7919) % 1000000, 1000 + (i % 5000));
+}
+
+/**
+ * bench_store_run - Time one backend
+ * @param ops      Store backend
+ * @param dir      Directory for the database
+ * @param num_keys Number of keys
+ * @param version  Version string for the report
+ * @param fp       File for the results
+ */
+static void bench_store_run(const struct StoreOps *ops, const char *dir,
+                            int num_keys, const char *version, FILE *fp)
+{
+  struct Buffer *path = buf_pool_get();
+  struct Buffer *key = buf_pool_get();
+  struct BenchSample bs = { 0 };
+  struct BenchResult br = { "store_put", ops->name, num_keys };
+  char value[BENCH_VALUE_LEN] = { 0 };
+  size_t vlen = 0;
+
+  buf_printf(path, "%s/store-%s", dir, ops->name);
+  for (size_t i = 0; i < sizeof(value); i++)
+    value[i] = 'a' + (i % 26);
+
+  bench_start(&bs);
+  StoreHandle *sh = ops->open(buf_string(path), true);
+  if (!sh)
+  {
+    fprintf(stderr, "Can't open %s store: %s\n", ops->name, buf_string(path));
+    goto done;
+  }
+  for (int i = 0; i < num_keys; i++)
+  {
+    bench_store_key(key, i);
+    ops->store(sh, buf_string(key), buf_len(key), value, sizeof(value));
+  }
+  ops->close(&sh);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  br.stage = "store_open";
+  br.items = 1;
+  bench_start(&bs);
+  sh = ops->open(buf_string(path), false);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+  if (!sh)
+    goto done;
+
+  int found = 0;
+  br.stage = "store_get";
+  br.items = num_keys * 2;
+  bench_start(&bs);
+  for (int i = 0; i < (num_keys * 2); i++)
+  {
+    bench_store_key(key, i);
+    void *data = ops->fetch(sh, buf_string(key), buf_len(key), &vlen);
+    if (data)
+    {
+      found++;
+      ops->free(sh, &data);
+    }
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+  if (found != num_keys)
+    fprintf(stderr, "%s: found %d of %d keys\n", ops->name, found, num_keys);
+
+  br.stage = "store_update";
+  br.items = num_keys / 4;
+  value[0] = 'Z';
+  bench_start(&bs);
+  for (int i = 0; i < num_keys; i += 4)
+  {
+    bench_store_key(key, i);
+    ops->store(sh, buf_string(key), buf_len(key), value, sizeof(value));
+  }
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+  br.stage = "store_delete";
+  br.items = num_keys;
+  bench_start(&bs);
+  for (int i = 0; i < num_keys; i++)
+  {
+    bench_store_key(key, i);
+    ops->delete_record(sh, buf_string(key), buf_len(key));
+  }
+  ops->close(&sh);
+  bench_stop(&bs, &br);
+  bench_report(fp, version, &br);
+
+done:
+  buf_pool_release(&path);
+  buf_pool_release(&key);
+}
+
+/**
+ * bench_store - Compare the Store backends
+ * @param dir      Directory for the databases
+ * @param num_keys Number of keys
+ * @param version  Version string for the report
+ * @param fp       File for the results
+ */
+void bench_store(const char *dir, int num_keys, const char *version, FILE *fp)
+{
+  const char *list = store_backend_list();
+  char *names = mutt_str_dup(list);
+  FREE(&list);
+
+  // The list looks like "tokyocabinet, lmdb, logdb"
+  char *saveptr = NULL;
+  for (char *name = strtok_r(names, ", ", &saveptr); name;
+       name = strtok_r(NULL, ", ", &saveptr))
+  {
+    const struct StoreOps *ops = store_get_backend_ops(name);
+    if (ops)
+      bench_store_run(ops, dir, num_keys, version, fp);
+  }
+
+  FREE(&names);
+}
@@ -208,9 +208,12 @@ enum QuadOption query_yesorno(const char *msg, enum QuadOption def)
   return MUTT_YES;
 }
 
+/// Mailbox returned by get_current_mailbox(), for the tests that need one
+struct Mailbox *TestCurrentMailbox = NULL;
+
 struct Mailbox *get_current_mailbox(void)
 {
-  return NULL;
+  return TestCurrentMailbox;
 }
 
 struct MailboxView *get_current_mailbox_view(void)
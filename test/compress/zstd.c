@@ -24,6 +24,8 @@
 #include "config.h"
 #include "acutest.h"
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 #include "mutt/lib.h"
 #include "compress/lib.h"
 #include "common.h" // IWYU pragma: keep
@@ -90,5 +92,71 @@ void test_compress_zstd(void)
     compr_ops->close(&compr_handle);
   }
 
+  {
+    // Dictionary
+    TEST_CHECK(compr_ops->dict_train(NULL, NULL, 0, NULL) == NULL);
+    TEST_CHECK(compr_ops->dict_load(NULL, NULL, 0) == false);
+
+    // Small, similar records, like a header cache
+    struct Buffer *samples = buf_pool_get();
+    size_t sizes[1000] = { 0 };
+    char record[256] = { 0 };
+    for (size_t i = 0; i < mutt_array_size(sizes); i++)
+    {
+      sizes[i] = snprintf(record, sizeof(record),
+                          "From: user%zu@example.com\nTo: list@example.org\n"
+                          "Subject: Re: [list] topic number %zu\n"
+                          "Message-ID: <%zu.%zu@mail.example.com>\n",
+                          i % 37, i % 101, i * 7919, i);
+      buf_addstr_n(samples, record, sizes[i]);
+    }
+
+    size_t dlen = 0;
+    void *dict = compr_ops->dict_train(buf_string(samples), sizes,
+                                       mutt_array_size(sizes), &dlen);
+    TEST_CHECK(dict != NULL);
+    TEST_CHECK(dlen != 0);
+
+    ComprHandle *plain = compr_ops->open(3);
+    ComprHandle *with_dict = compr_ops->open(3);
+    TEST_CHECK(compr_ops->dict_load(with_dict, dict, dlen));
+    TEST_CHECK(compr_ops->dict_load(with_dict, "garbage", 7) == false);
+
+    const int rlen = snprintf(record, sizeof(record),
+                              "From: user5@example.com\nTo: list@example.org\n"
+                              "Subject: Re: [list] topic number 42\n"
+                              "Message-ID: <1234567.5000@mail.example.com>\n");
+
+    size_t plain_len = 0;
+    void *cdata = compr_ops->compress(plain, record, rlen, &plain_len);
+    TEST_CHECK(cdata != NULL);
+    void *plain_copy = g_malloc(plain_len);
+    memcpy(plain_copy, cdata, plain_len);
+
+    size_t dict_len = 0;
+    cdata = compr_ops->compress(with_dict, record, rlen, &dict_len);
+    TEST_CHECK(cdata != NULL);
+    void *dict_copy = g_malloc(dict_len);
+    memcpy(dict_copy, cdata, dict_len);
+    TEST_CHECK(dict_len < plain_len);
+    TEST_MSG("plain %zu, dict %zu", plain_len, dict_len);
+
+    // The dictionary is needed to decompress
+    void *ddata = compr_ops->decompress(with_dict, dict_copy, dict_len);
+    TEST_CHECK((ddata != NULL) && (memcmp(ddata, record, rlen) == 0));
+    TEST_CHECK(compr_ops->decompress(plain, dict_copy, dict_len) == NULL);
+
+    // Data compressed without it can still be read
+    ddata = compr_ops->decompress(with_dict, plain_copy, plain_len);
+    TEST_CHECK((ddata != NULL) && (memcmp(ddata, record, rlen) == 0));
+
+    FREE(&plain_copy);
+    FREE(&dict_copy);
+    FREE(&dict);
+    compr_ops->close(&plain);
+    compr_ops->close(&with_dict);
+    buf_pool_release(&samples);
+  }
+
   compress_data_tests(compr_ops, MIN_COMP_LEVEL, MAX_COMP_LEVEL);
 }
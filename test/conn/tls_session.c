@@ -0,0 +1,321 @@
+/**
+ * @file
+ * Test code for the cache of TLS sessions
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "conn/lib.h"
+#include "conn/ssl.h"
+#include "test_common.h" // IWYU pragma: keep
+
+bool config_init_conn(struct ConfigSet *cs);
+
+/**
+ * file_has_line - Does the session file have a line for a server?
+ * @param path Session file
+ * @param key  Server, "host:port"
+ * @retval true The server's session was saved
+ */
+static bool file_has_line(const char *path, const char *key)
+{
+  FILE *fp = fopen(path, "r");
+  if (!fp)
+    return false;
+
+  bool found = false;
+  char line[8192] = { 0 };
+  const size_t keylen = strlen(key);
+  while (!found && fgets(line, sizeof(line), fp))
+    found = mutt_strn_equal(line, key, keylen) && (line[keylen] == ' ');
+
+  fclose(fp);
+  return found;
+}
+
+void test_tls_session_cache(void)
+{
+  // struct TlsSession *tls_session_get(const struct ConnAccount *cac);
+  // void tls_session_user_trusted(struct TlsSession *ts);
+
+  config_init_conn(SpaceMutt->sub->cs);
+
+  char tmpl[] = "/tmp/spacemutt-tls-XXXXXX";
+  const char *dir = mkdtemp(tmpl);
+  if (!TEST_CHECK(dir != NULL))
+    return;
+
+  char file[256] = { 0 };
+  snprintf(file, sizeof(file), "%s/sessions", dir);
+  cs_str_string_set(SpaceMutt->sub->cs, "ssl_session_file", file, NULL);
+
+  struct ConnAccount cac_ca = { 0 };
+  mutt_str_copy(cac_ca.host, "ca.example.com", sizeof(cac_ca.host));
+  cac_ca.port = 993;
+
+  struct ConnAccount cac_user = { 0 };
+  mutt_str_copy(cac_user.host, "user.example.com", sizeof(cac_user.host));
+  cac_user.port = 993;
+
+  unsigned char md[32] = { 0 };
+  memset(md, 0x42, sizeof(md));
+
+  {
+    // A certificate the library verified is remembered
+    struct TlsSession *ts = tls_session_get(&cac_ca);
+    TEST_CHECK(ts != NULL);
+    tls_session_set(ts, "session-ca", 10);
+    tls_session_cert_verified(ts, md, sizeof(md));
+    TEST_CHECK(tls_session_cert_known(ts, md, sizeof(md)));
+  }
+
+  {
+    // A certificate the user accepted is checked again next time
+    struct TlsSession *ts = tls_session_get(&cac_user);
+    TEST_CHECK(ts != NULL);
+    tls_session_set(ts, "session-user", 12);
+    tls_session_cert_verified(ts, md, sizeof(md));
+    tls_session_user_trusted(ts);
+    TEST_CHECK(!tls_session_cert_known(ts, md, sizeof(md)));
+  }
+
+  {
+    // The sessions aren't written until the cache is cleaned up
+    struct stat st = { 0 };
+    TEST_CHECK(stat(file, &st) != 0);
+
+    tls_sessions_cleanup();
+    TEST_CHECK(file_has_line(file, "ca.example.com:993"));
+    TEST_CHECK(!file_has_line(file, "user.example.com:993"));
+  }
+
+  {
+    // Only the verified session is read back
+    struct TlsSession *ts = tls_session_get(&cac_ca);
+    TEST_CHECK((ts->len == 10) && (memcmp(ts->data, "session-ca", 10) == 0));
+    TEST_CHECK(!tls_session_cert_known(ts, md, sizeof(md)));
+
+    ts = tls_session_get(&cac_user);
+    TEST_CHECK(ts->data == NULL);
+    tls_sessions_cleanup();
+  }
+
+  cs_str_reset(SpaceMutt->sub->cs, "ssl_session_file", NULL);
+  unlink(file);
+  rmdir(dir);
+}
+
+#ifdef USE_SSL_OPENSSL
+/**
+ * free_port - Find a free TCP port on localhost
+ * @retval num Port number
+ * @retval 0   Error
+ */
+static int free_port(void)
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return 0;
+
+  struct sockaddr_in sin = { 0 };
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(sin);
+  int port = 0;
+  if ((bind(fd, (struct sockaddr *) &sin, sizeof(sin)) == 0) &&
+      (getsockname(fd, (struct sockaddr *) &sin, &len) == 0))
+  {
+    port = ntohs(sin.sin_port);
+  }
+  close(fd);
+  return port;
+}
+
+/**
+ * server_ready - Wait for the test server to accept connections
+ * @param port Port number
+ * @retval true The server is listening
+ */
+static bool server_ready(int port)
+{
+  struct sockaddr_in sin = { 0 };
+  sin.sin_family = AF_INET;
+  sin.sin_port = htons(port);
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  for (int i = 0; i < 100; i++)
+  {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    bool ok = (fd >= 0) && (connect(fd, (struct sockaddr *) &sin, sizeof(sin)) == 0);
+    if (fd >= 0)
+      close(fd);
+    if (ok)
+      return true;
+    usleep(100000);
+  }
+  return false;
+}
+
+/**
+ * fetch_page - Connect to the test server and fetch its status page
+ * @param port Port number
+ * @retval true The page was fetched
+ */
+static bool fetch_page(int port)
+{
+  struct Connection *conn = mutt_socket_new(MUTT_CONNECTION_SSL);
+  if (!conn)
+    return false;
+
+  mutt_str_copy(conn->account.host, "localhost", sizeof(conn->account.host));
+  conn->account.port = port;
+
+  bool ok = false;
+  if (mutt_socket_open(conn) == 0)
+  {
+    // With TLS 1.3, the session arrives after the handshake
+    char buf[256] = { 0 };
+    ok = (mutt_socket_send(conn, "GET / HTTP/1.0\r\n\r\n") > 0) &&
+         (mutt_socket_readln(buf, sizeof(buf), conn) > 0) &&
+         mutt_str_startswith(buf, "HTTP/1.0 200");
+    mutt_socket_close(conn);
+  }
+  FREE(&conn);
+  return ok;
+}
+#endif
+
+void test_tls_session_resume(void)
+{
+  // int mutt_socket_open(struct Connection *conn);
+
+#ifdef USE_SSL_OPENSSL
+  if (system("openssl version > /dev/null 2>&1") != 0)
+  {
+    TEST_MSG("openssl command not found, skipping");
+    return;
+  }
+
+  config_init_conn(SpaceMutt->sub->cs);
+
+  char tmpl[] = "/tmp/spacemutt-tls-XXXXXX";
+  const char *dir = mkdtemp(tmpl);
+  if (!TEST_CHECK(dir != NULL))
+    return;
+
+  char cert[256] = { 0 };
+  char key[256] = { 0 };
+  char file[256] = { 0 };
+  char cmd[1024] = { 0 };
+  snprintf(cert, sizeof(cert), "%s/cert.pem", dir);
+  snprintf(key, sizeof(key), "%s/key.pem", dir);
+  snprintf(file, sizeof(file), "%s/sessions", dir);
+  snprintf(cmd, sizeof(cmd),
+           "openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj /CN=localhost "
+           "-addext subjectAltName=DNS:localhost -keyout %s -out %s > /dev/null 2>&1",
+           key, cert);
+  if (!TEST_CHECK(system(cmd) == 0))
+    goto done;
+
+  const int port = free_port();
+  if (!TEST_CHECK(port != 0))
+    goto done;
+
+  char listen_on[32] = { 0 };
+  snprintf(listen_on, sizeof(listen_on), "127.0.0.1:%d", port);
+
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    int fd = open("/dev/null", O_RDWR);
+    dup2(fd, STDIN_FILENO);
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    execlp("openssl", "openssl", "s_server", "-quiet", "-www", "-accept", listen_on,
+           "-cert", cert, "-key", key, (char *) NULL);
+    _exit(127);
+  }
+  if (!TEST_CHECK(pid > 0))
+    goto done;
+
+  // The server's certificate is trusted through $certificate_file only
+  struct ConfigSet *cs = SpaceMutt->sub->cs;
+  cs_str_string_set(cs, "certificate_file", cert, NULL);
+  cs_str_string_set(cs, "ssl_session_file", file, NULL);
+  cs_str_string_set(cs, "ssl_use_system_certs", "no", NULL);
+  cs_str_string_set(cs, "use_ipv6", "no", NULL);
+
+  if (TEST_CHECK(server_ready(port)))
+  {
+    unsigned int hits = 0, misses = 0;
+    tls_sessions_stats(&hits, &misses);
+
+    // The first connection needs a full handshake, the second resumes it
+    TEST_CHECK(fetch_page(port));
+    TEST_CHECK(fetch_page(port));
+
+    unsigned int hits2 = 0, misses2 = 0;
+    tls_sessions_stats(&hits2, &misses2);
+    TEST_CHECK(misses2 == (misses + 1));
+    TEST_MSG("Expected: %u full handshake(s)", misses + 1);
+    TEST_MSG("Actual  : %u", misses2);
+    TEST_CHECK(hits2 == (hits + 1));
+    TEST_MSG("Expected: %u resumed handshake(s)", hits + 1);
+    TEST_MSG("Actual  : %u", hits2);
+
+    // The verified session is saved when the cache is cleaned up
+    char server[64] = { 0 };
+    snprintf(server, sizeof(server), "localhost:%d", port);
+    TEST_CHECK(!file_has_line(file, server));
+    tls_sessions_cleanup();
+    TEST_CHECK(file_has_line(file, server));
+  }
+
+  kill(pid, SIGTERM);
+  waitpid(pid, NULL, 0);
+
+  cs_str_reset(cs, "certificate_file", NULL);
+  cs_str_reset(cs, "ssl_session_file", NULL);
+  cs_str_reset(cs, "ssl_use_system_certs", NULL);
+  cs_str_reset(cs, "use_ipv6", NULL);
+
+done:
+  unlink(cert);
+  unlink(key);
+  unlink(file);
+  rmdir(dir);
+#endif
+}
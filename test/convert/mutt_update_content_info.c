@@ -292,4 +292,34 @@ void test_mutt_update_content_info(void)
     TEST_CHECK(info.lobin == 7);
     TEST_MSG("Check failed: %d == 10", info.lobin);
   }
+
+  {
+    /* Check long runs, which are scanned a word at a time. */
+    static const char *line1 = "The quick brown fox jumps over the lazy dog \xc3\xa9\xc3\xa8        ";
+    static const char *line2 = "\n0123456789abcdef\x7f" "0123456789abcdef\n";
+    struct Content info = initial_info;
+    struct ContentState state = initial_state;
+
+    /* Split the trailing spaces across two calls */
+    mutt_update_content_info(&info, &state, (char *) line1, 51);
+    TEST_CHECK(state.whitespace == 3);
+    TEST_MSG("Check failed: %d == 3", state.whitespace);
+    TEST_CHECK(state.linelen == 51);
+    TEST_MSG("Check failed: %d == 51", state.linelen);
+    mutt_update_content_info(&info, &state, (char *) line1 + 51, 5);
+    TEST_CHECK(state.whitespace == 8);
+    TEST_MSG("Check failed: %d == 8", state.whitespace);
+
+    mutt_update_content_info(&info, &state, (char *) line2, 35);
+    TEST_CHECK(info.ascii == 84);
+    TEST_MSG("Check failed: %ld == 84", info.ascii);
+    TEST_CHECK(info.hibin == 4);
+    TEST_MSG("Check failed: %ld == 4", info.hibin);
+    TEST_CHECK(info.lobin == 1);
+    TEST_MSG("Check failed: %ld == 1", info.lobin);
+    TEST_CHECK(info.linemax == 57);
+    TEST_MSG("Check failed: %ld == 57", info.linemax);
+    TEST_CHECK(info.space);
+    TEST_MSG("Check failed: %d == 1", info.space);
+  }
 }
@@ -0,0 +1,52 @@
+/**
+ * @file
+ * Test code for mutt_date_make_imap_day()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <time.h>
+#include "mutt/lib.h"
+#include "test_common.h"
+
+void test_mutt_date_make_imap_day(void)
+{
+  // int mutt_date_make_imap_day(struct Buffer *buf, time_t timestamp);
+
+  {
+    TEST_CHECK(mutt_date_make_imap_day(NULL, 0) < 0);
+  }
+
+  {
+    struct Buffer *buf = buf_pool_get();
+    TEST_CHECK(mutt_date_make_imap_day(buf, 961930800) > 0);
+    TEST_CHECK_STR_EQ(buf_string(buf), "25-Jun-2000");
+    buf_pool_release(&buf);
+  }
+
+  {
+    // Always UTC: one second before midnight
+    struct Buffer *buf = buf_pool_get();
+    TEST_CHECK(mutt_date_make_imap_day(buf, 1457222399) > 0);
+    TEST_CHECK_STR_EQ(buf_string(buf), "5-Mar-2016");
+    buf_pool_release(&buf);
+  }
+}
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * Test code for dirscan_next()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+
+static int count_entries(struct DirScan *ds, bool *seen)
+{
+  int count = 0;
+  const struct DirEntry *de = NULL;
+  while ((de = dirscan_next(ds)))
+  {
+    TEST_CHECK(!mutt_str_equal(de->name, "."));
+    TEST_CHECK(!mutt_str_equal(de->name, ".."));
+    TEST_CHECK(de->ino != 0);
+
+    int num = 0;
+    if (seen && mutt_str_startswith(de->name, "msg.") &&
+        mutt_str_atoi(de->name + 4, &num) && (num >= 0))
+    {
+      seen[num] = true;
+    }
+    count++;
+  }
+  return count;
+}
+
+void test_dirscan_next(void)
+{
+  // const struct DirEntry *dirscan_next(struct DirScan *ds);
+
+  {
+    TEST_CHECK(dirscan_next(NULL) == NULL);
+    TEST_CHECK(dirscan_open(AT_FDCWD, NULL, false) == NULL);
+    TEST_CHECK(dirscan_fd(NULL) == -1);
+    TEST_CHECK(!dirscan_rewind(NULL));
+    dirscan_close(NULL);
+  }
+
+  char tmpl[] = "/tmp/spacemutt-dirscan-XXXXXX";
+  const char *dir = mkdtemp(tmpl);
+  if (!TEST_CHECK(dir != NULL))
+    return;
+
+  {
+    // A missing directory is only created on request
+    TEST_CHECK(dirscan_open(AT_FDCWD, "/tmp/spacemutt-dirscan-missing/x", false) == NULL);
+
+    char sub[256] = { 0 };
+    snprintf(sub, sizeof(sub), "%s/new", dir);
+    struct DirScan *ds = dirscan_open(AT_FDCWD, sub, true);
+    TEST_CHECK(ds != NULL);
+    TEST_CHECK(count_entries(ds, NULL) == 0);
+    dirscan_close(&ds);
+    TEST_CHECK(ds == NULL);
+  }
+
+  {
+    // Enough files to need several reads on Linux
+    const int num = 6000;
+    struct DirScan *ds = dirscan_open(AT_FDCWD, dir, false);
+    TEST_CHECK(ds != NULL);
+
+    const int fd = dirscan_fd(ds);
+    for (int i = 0; i < num; i++)
+    {
+      char name[64] = { 0 };
+      snprintf(name, sizeof(name), "msg.%d.padding-to-make-the-names-longer", i);
+      int fd_msg = openat(fd, name, O_WRONLY | O_CREAT | O_EXCL, 0600);
+      TEST_CHECK(fd_msg >= 0);
+      close(fd_msg);
+    }
+
+    bool *seen = g_new0(bool, num);
+    TEST_CHECK(count_entries(ds, seen) == (num + 1)); // + "new"
+    int missing = 0;
+    for (int i = 0; i < num; i++)
+      missing += !seen[i];
+    TEST_CHECK(missing == 0);
+    FREE(&seen);
+
+    // The type comes from the directory, if the filesystem knows it
+    struct stat st = { 0 };
+    TEST_CHECK(dirscan_rewind(ds));
+    const struct DirEntry *de = NULL;
+    while ((de = dirscan_next(ds)))
+    {
+      TEST_CHECK(fstatat(fd, de->name, &st, 0) == 0);
+      if (de->type != DT_UNKNOWN)
+        TEST_CHECK((de->type == DT_DIR) == S_ISDIR(st.st_mode));
+    }
+
+    // A rewind sees the changes
+    TEST_CHECK(unlinkat(fd, "msg.0.padding-to-make-the-names-longer", 0) == 0);
+    TEST_CHECK(dirscan_rewind(ds));
+    TEST_CHECK(count_entries(ds, NULL) == num);
+
+    TEST_CHECK(stat(dir, &st) == 0);
+    TEST_CHECK(dirscan_same(ds, &st));
+    TEST_CHECK(stat("/", &st) == 0);
+    TEST_CHECK(!dirscan_same(ds, &st));
+    TEST_CHECK(!dirscan_same(ds, NULL));
+
+    // A scan that's finished early must be rewound
+    TEST_CHECK(dirscan_rewind(ds));
+    TEST_CHECK(dirscan_next(ds) != NULL);
+    dirscan_finish(ds);
+    TEST_CHECK(dirscan_next(ds) == NULL);
+    TEST_CHECK(dirscan_rewind(ds));
+    TEST_CHECK(count_entries(ds, NULL) == num);
+    dirscan_finish(NULL);
+
+    // Two scans at once don't share a buffer
+    struct DirScan *ds2 = dirscan_open(AT_FDCWD, dir, false);
+    TEST_CHECK(dirscan_rewind(ds));
+    int count = 0;
+    int count2 = 0;
+    bool more = true;
+    while (more)
+    {
+      more = false;
+      if (dirscan_next(ds))
+      {
+        count++;
+        more = true;
+      }
+      if (dirscan_next(ds2))
+      {
+        count2++;
+        more = true;
+      }
+    }
+    TEST_CHECK((count == num) && (count2 == num));
+    TEST_MSG("Expected: %d, %d", num, num);
+    TEST_MSG("Actual  : %d, %d", count, count2);
+    dirscan_close(&ds2);
+
+    dirscan_close(&ds);
+  }
+
+  mutt_file_rmtree(dir);
+}
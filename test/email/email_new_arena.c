@@ -0,0 +1,83 @@
+/**
+ * @file
+ * Test code for email_new_arena()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+
+void test_email_new_arena(void)
+{
+  // struct Email *email_new_arena(struct Arena *arena);
+
+  {
+    struct Email *e = email_new_arena(NULL);
+    TEST_CHECK(e != NULL);
+    TEST_CHECK(e->arena == NULL);
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+  }
+
+  {
+    struct Arena *arena = arena_new(0);
+
+    struct Email *e = email_new_arena(arena);
+    TEST_CHECK(e != NULL);
+    TEST_CHECK(e->arena == arena);
+    TEST_CHECK(e->visible);
+    TEST_CHECK(arena_owns(arena, e));
+
+    e->env = mutt_env_new_arena(arena);
+    e->body = mutt_body_new_arena(arena);
+    TEST_CHECK(arena_owns(arena, e->env));
+    TEST_CHECK(arena_owns(arena, e->body));
+
+    // The strings are still on the heap
+    e->env->subject = mutt_str_dup("apple");
+    e->body->subtype = mutt_str_dup("plain");
+    TEST_CHECK(!arena_owns(arena, e->env->subject));
+
+    TEST_CHECK(arena->refs == 4);
+
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+    TEST_CHECK(arena->refs == 1);
+    arena_release(&arena);
+  }
+
+  {
+    // The Emails outlive their Mailbox's reference
+    struct Arena *arena = arena_new(0);
+    struct Email *e = email_new_arena(arena);
+    e->env = mutt_env_new_arena(arena);
+
+    struct Arena *owner = arena;
+    arena_release(&owner);
+    TEST_CHECK(arena->refs == 2);
+    TEST_CHECK(e->env->from != NULL);
+
+    email_free(&e);
+    TEST_CHECK(e == NULL);
+  }
+}
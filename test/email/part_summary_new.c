@@ -0,0 +1,108 @@
+/**
+ * @file
+ * Test code for part_summary_new()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+
+static struct Body *new_part(enum ContentType type, const char *subtype, LOFF_T length)
+{
+  struct Body *b = mutt_body_new();
+  b->type = type;
+  b->subtype = mutt_str_dup(subtype);
+  b->length = length;
+  return b;
+}
+
+void test_part_summary_new(void)
+{
+  // struct PartSummaryArray *part_summary_new(const struct Body *b);
+  // struct Body *part_summary_body(const struct PartSummaryArray *psa);
+
+  {
+    TEST_CHECK(part_summary_new(NULL) == NULL);
+    TEST_CHECK(part_summary_body(NULL) == NULL);
+  }
+
+  {
+    // multipart/mixed
+    //   multipart/signed
+    //     text/plain
+    //     application/pgp-signature
+    //   image/png (attachment)
+    struct Body *top = new_part(TYPE_MULTIPART, "mixed", 5000);
+    struct Body *sig = new_part(TYPE_MULTIPART, "signed", 1000);
+    struct Body *png = new_part(TYPE_IMAGE, "png", 4000);
+    png->disposition = DISP_ATTACH;
+    png->encoding = ENC_BASE64;
+    top->parts = sig;
+    sig->next = png;
+    sig->parts = new_part(TYPE_TEXT, "plain", 600);
+    sig->parts->next = new_part(TYPE_APPLICATION, "pgp-signature", 400);
+    sig->parts->next->goodsig = true;
+
+    struct PartSummaryArray *psa = part_summary_new(top);
+    TEST_CHECK(psa != NULL);
+    TEST_CHECK(ARRAY_SIZE(psa) == 5);
+
+    struct PartSummary *ps = ARRAY_GET(psa, 0);
+    TEST_CHECK((ps->type == TYPE_MULTIPART) && (ps->depth == 0));
+    ps = ARRAY_GET(psa, 1);
+    TEST_CHECK((ps->depth == 1) && (ps->flags == PART_SUM_SIGNED));
+    ps = ARRAY_GET(psa, 3);
+    TEST_CHECK(mutt_str_equal(ps->subtype, "pgp-signature"));
+    TEST_CHECK((ps->depth == 2) && (ps->flags == (PART_SUM_SIGNED | PART_SUM_GOODSIG)));
+    ps = ARRAY_GET(psa, 4);
+    TEST_CHECK((ps->depth == 1) && (ps->length == 4000));
+    TEST_CHECK((ps->disposition == DISP_ATTACH) && (ps->encoding == ENC_BASE64));
+
+    struct Body *b = part_summary_body(psa);
+    TEST_CHECK(b != NULL);
+    TEST_CHECK(mutt_str_equal(b->subtype, "mixed") && !b->next);
+    TEST_CHECK(mutt_str_equal(b->parts->subtype, "signed"));
+    TEST_CHECK(mutt_str_equal(b->parts->parts->subtype, "plain"));
+    TEST_CHECK(mutt_str_equal(b->parts->parts->next->subtype, "pgp-signature"));
+    TEST_CHECK(b->parts->parts->next->goodsig);
+    TEST_CHECK(mutt_str_equal(b->parts->next->subtype, "png"));
+    TEST_CHECK(b->parts->next->type == TYPE_IMAGE);
+    TEST_CHECK(b->parts->next->disposition == DISP_ATTACH);
+    TEST_CHECK(b->parts->next->next == NULL);
+
+    mutt_body_free(&b);
+    part_summary_free(&psa);
+    TEST_CHECK(psa == NULL);
+    mutt_body_free(&top);
+  }
+
+  {
+    // A child without a parent is malformed
+    struct PartSummaryArray psa = ARRAY_HEAD_INITIALIZER;
+    struct PartSummary ps = { 0 };
+    ps.depth = 1;
+    ARRAY_ADD(&psa, ps);
+    TEST_CHECK(part_summary_body(&psa) == NULL);
+    ARRAY_FREE(&psa);
+  }
+}
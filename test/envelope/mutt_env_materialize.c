@@ -0,0 +1,79 @@
+/**
+ * @file
+ * Test code for mutt_env_materialize()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "email/lib.h"
+#include "test_common.h"
+
+void test_mutt_env_materialize(void)
+{
+  // void mutt_env_materialize(struct Envelope *env);
+
+  {
+    mutt_env_materialize(NULL);
+    TEST_CHECK_(1, "mutt_env_materialize(NULL)");
+  }
+
+  {
+    struct Envelope *env = mutt_env_new();
+    mutt_env_materialize(env);
+    TEST_CHECK(env->lazy == NULL);
+    TEST_CHECK(g_queue_is_empty(env->mail_followup_to));
+    mutt_env_free(&env);
+  }
+
+  {
+    struct Envelope *env = mutt_env_new();
+    env->lazy = mutt_str_dup("Mail-Followup-To: list@example.com\n"
+                             "Organization: =?utf-8?Q?Caf=C3=A9?= Club\n"
+                             "List-Subscribe: <mailto:list-join@example.com>\n"
+                             "X-Original-To: me@example.com\n");
+
+    mutt_env_materialize(env);
+    TEST_CHECK(env->lazy == NULL);
+
+    const struct Address *a = g_queue_peek_head(env->mail_followup_to);
+    TEST_CHECK(a != NULL);
+    if (a)
+      TEST_CHECK_STR_EQ(buf_string(a->mailbox), "list@example.com");
+
+    TEST_CHECK_STR_EQ(env->list_subscribe, "mailto:list-join@example.com");
+
+    a = g_queue_peek_head(env->x_original_to);
+    TEST_CHECK(a != NULL);
+    if (a)
+      TEST_CHECK_STR_EQ(buf_string(a->mailbox), "me@example.com");
+
+    TEST_CHECK(env->organization != NULL);
+
+    // A second call does nothing
+    mutt_env_materialize(env);
+    TEST_CHECK(g_queue_get_length(env->mail_followup_to) == 1);
+
+    mutt_env_free(&env);
+  }
+}
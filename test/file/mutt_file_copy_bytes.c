@@ -24,8 +24,18 @@
 #include "config.h"
 #include "acutest.h"
 #include <stdio.h>
+#include <string.h>
 #include "mutt/lib.h"
 
+static FILE *big_file(size_t size)
+{
+  FILE *fp = tmpfile();
+  for (size_t i = 0; i < size; i++)
+    fputc('a' + (i % 26), fp);
+  rewind(fp);
+  return fp;
+}
+
 void test_mutt_file_copy_bytes(void)
 {
   // int mutt_file_copy_bytes(FILE *fp_in, FILE *fp_out, size_t size);
@@ -41,4 +51,31 @@ void test_mutt_file_copy_bytes(void)
     TEST_CHECK(mutt_file_copy_bytes(fp, NULL, 10) != 0);
     fclose(fp);
   }
+
+  {
+    // Large enough to be copied by the kernel, mixed with stdio on both sides
+    const size_t size = 300 * 1024;
+    FILE *fp_in = big_file(size);
+    FILE *fp_out = tmpfile();
+    TEST_CHECK(fgetc(fp_in) == 'a');
+    fputs("header\n", fp_out);
+
+    TEST_CHECK(mutt_file_copy_bytes(fp_in, fp_out, 200 * 1024) == 0);
+    TEST_CHECK(ftello(fp_in) == (200 * 1024) + 1);
+    TEST_CHECK(ftello(fp_out) == (200 * 1024) + 7);
+    TEST_CHECK(fgetc(fp_in) == 'a' + (((200 * 1024) + 1) % 26));
+    fputs("trailer", fp_out);
+
+    rewind(fp_out);
+    char buf[16] = { 0 };
+    TEST_CHECK(fread(buf, 1, 8, fp_out) == 8);
+    TEST_CHECK(memcmp(buf, "header\nb", 8) == 0);
+    TEST_CHECK(fseeko(fp_out, (200 * 1024) + 6, SEEK_SET) == 0);
+    TEST_CHECK(fread(buf, 1, 8, fp_out) == 8);
+    TEST_CHECK(buf[0] == 'a' + ((200 * 1024) % 26));
+    TEST_CHECK(memcmp(buf + 1, "trailer", 7) == 0);
+
+    fclose(fp_in);
+    fclose(fp_out);
+  }
 }
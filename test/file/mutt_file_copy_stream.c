@@ -24,6 +24,7 @@
 #include "config.h"
 #include "acutest.h"
 #include <stdio.h>
+#include <string.h>
 #include "mutt/lib.h"
 
 void test_mutt_file_copy_stream(void)
@@ -41,4 +42,30 @@ void test_mutt_file_copy_stream(void)
     TEST_CHECK(mutt_file_copy_stream(fp, NULL) != 0);
     fclose(fp);
   }
+
+  {
+    // Large enough to be copied by the kernel
+    const size_t size = 1024 * 1024 + 17;
+    FILE *fp_in = tmpfile();
+    FILE *fp_out = tmpfile();
+    for (size_t i = 0; i < size; i++)
+      fputc('0' + (i % 10), fp_in);
+    rewind(fp_in);
+    TEST_CHECK(fgetc(fp_in) == '0');
+
+    TEST_CHECK(mutt_file_copy_stream(fp_in, fp_out) == (ssize_t) (size - 1));
+    TEST_CHECK(ftello(fp_out) == (off_t) (size - 1));
+    TEST_CHECK(fgetc(fp_in) == EOF);
+
+    rewind(fp_out);
+    char buf[10] = { 0 };
+    TEST_CHECK(fread(buf, 1, 10, fp_out) == 10);
+    TEST_CHECK(memcmp(buf, "1234567890", 10) == 0);
+    TEST_CHECK(fseeko(fp_out, -6, SEEK_END) == 0);
+    TEST_CHECK(fread(buf, 1, 6, fp_out) == 6);
+    TEST_CHECK(memcmp(buf, "789012", 6) == 0);
+
+    fclose(fp_in);
+    fclose(fp_out);
+  }
 }
@@ -23,7 +23,9 @@
 #define TEST_NO_MAIN
 #include "config.h"
 #include "acutest.h"
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 #include "mutt/lib.h"
 
 void test_mutt_hash_delete(void)
@@ -59,6 +61,47 @@ void test_mutt_hash_delete(void)
     mutt_hash_insert(table, "banana", &dummy2);
     mutt_hash_insert(table, "cherry", &dummy3);
     mutt_hash_delete(table, "banana", NULL);
+    TEST_CHECK(!mutt_hash_find(table, "banana"));
+    TEST_CHECK(mutt_hash_find(table, "apple") == &dummy1);
+    TEST_CHECK(mutt_hash_find(table, "cherry") == &dummy3);
+    mutt_hash_free(&table);
+  }
+
+  {
+    struct HashTable *table = mutt_hash_new(10, MUTT_HASH_ALLOW_DUPS);
+    mutt_hash_insert(table, "apple", &dummy1);
+    mutt_hash_insert(table, "apple", &dummy2);
+    mutt_hash_delete(table, "apple", &dummy2);
+    TEST_CHECK(mutt_hash_find(table, "apple") == &dummy1);
+    mutt_hash_delete(table, "apple", NULL);
+    TEST_CHECK(!mutt_hash_find(table, "apple"));
+    TEST_CHECK(table->count == 0);
+    mutt_hash_free(&table);
+  }
+
+  {
+    // Deleting keys shifts the others back; they must still be found
+    struct HashTable *table = mutt_hash_new(4, MUTT_HASH_STRDUP_KEYS);
+    char buf[32];
+    for (int i = 0; i < 500; i++)
+    {
+      snprintf(buf, sizeof(buf), "key%d", i);
+      mutt_hash_insert(table, buf, &dummy1);
+    }
+    for (int i = 0; i < 500; i += 2)
+    {
+      snprintf(buf, sizeof(buf), "key%d", i);
+      mutt_hash_delete(table, buf, NULL);
+    }
+    bool ok = true;
+    for (int i = 0; i < 500; i++)
+    {
+      snprintf(buf, sizeof(buf), "key%d", i);
+      if ((mutt_hash_find(table, buf) != NULL) != ((i % 2) == 1))
+        ok = false;
+    }
+    TEST_CHECK(ok);
+    TEST_CHECK(table->count == 250);
     mutt_hash_free(&table);
   }
 }
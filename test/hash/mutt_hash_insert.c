@@ -24,6 +24,7 @@
 #include "config.h"
 #include "acutest.h"
 #include <stddef.h>
+#include <stdio.h>
 #include "mutt/lib.h"
 
 void test_mutt_hash_insert(void)
@@ -51,4 +52,34 @@ void test_mutt_hash_insert(void)
     TEST_CHECK(mutt_hash_insert(table, "", NULL) != NULL);
     mutt_hash_free(&table);
   }
+
+  {
+    // The table grows, but the HashElems don't move
+    struct HashTable *table = mutt_hash_new(4, MUTT_HASH_STRDUP_KEYS);
+    struct HashElem *first = mutt_hash_insert(table, "key0", NULL);
+    char buf[32];
+    for (int i = 1; i < 1000; i++)
+    {
+      snprintf(buf, sizeof(buf), "key%d", i);
+      TEST_CHECK(mutt_hash_insert(table, buf, NULL) != NULL);
+    }
+    TEST_CHECK(table->count == 1000);
+    TEST_CHECK(table->num_elems >= 1000);
+    TEST_CHECK(mutt_hash_find_elem(table, "key0") == first);
+    TEST_CHECK(!mutt_hash_insert(table, "key500", NULL));
+    mutt_hash_free(&table);
+  }
+
+  {
+    int dummy1 = 42;
+    int dummy2 = 13;
+    struct HashTable *table = mutt_hash_new(10, MUTT_HASH_ALLOW_DUPS);
+    mutt_hash_insert(table, "apple", &dummy1);
+    mutt_hash_insert(table, "apple", &dummy2);
+    TEST_CHECK(table->count == 1);
+    TEST_CHECK(mutt_hash_find(table, "apple") == &dummy2);
+    struct HashElem *he = mutt_hash_find_bucket(table, "apple");
+    TEST_CHECK(he && (he->data == &dummy2) && he->next && (he->next->data == &dummy1));
+    mutt_hash_free(&table);
+  }
 }
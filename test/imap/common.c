@@ -0,0 +1,46 @@
+/**
+ * @file
+ * Common code for IMAP tests
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "imap/private.h" // IWYU pragma: keep
+#include "common.h"
+
+struct Buffer *imap_exec_results = NULL; ///< Commands that were sent, one per line
+bool imap_exec_fail = false;             ///< Fail every command
+const char *imap_exec_search = NULL;     ///< Server's reply to a SEARCH, e.g. "SEARCH 1 2"
+
+int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags)
+{
+  if (imap_exec_fail)
+    return -1;
+
+  buf_add_printf(imap_exec_results, "%s\n", cmdstr);
+
+  if (imap_exec_search && mutt_str_startswith(cmdstr, "UID SEARCH "))
+    cmd_parse_search(adata, imap_exec_search);
+
+  return 0;
+}
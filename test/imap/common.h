@@ -0,0 +1,34 @@
+/**
+ * @file
+ * Common code for IMAP tests
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_IMAP_COMMON_H
+#define TEST_IMAP_COMMON_H
+
+#include <stdbool.h>
+
+struct Buffer;
+
+extern struct Buffer *imap_exec_results;
+extern bool imap_exec_fail;
+extern const char *imap_exec_search;
+
+#endif /* TEST_IMAP_COMMON_H */
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * Dummy code for working around build problems
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "imap/adata.h"
+#include "imap/edata.h"
+#include "imap/mdata.h"
+
+struct ImapAccountData *imap_adata_get(struct Mailbox *m)
+{
+  if (!m || (m->type != MUTT_IMAP) || !m->account)
+    return NULL;
+  return m->account->adata;
+}
+
+struct ImapEmailData *imap_edata_get(struct Email *e)
+{
+  if (!e)
+    return NULL;
+  return e->edata;
+}
+
+struct ImapMboxData *imap_mdata_get(struct Mailbox *m)
+{
+  if (!m || (m->type != MUTT_IMAP) || !m->mdata)
+    return NULL;
+  return m->mdata;
+}
+
+char *imap_next_word(char *s)
+{
+  while (*s && (*s != ' '))
+    s++;
+  SKIPWS(s);
+  return s;
+}
+
+void imap_quote_string(char *dest, size_t dlen, const char *src, bool quote_backtick)
+{
+  snprintf(dest, dlen, "\"%s\"", src);
+}
@@ -31,6 +31,7 @@
 #include "imap/lib.h"
 #include "imap/private.h" // IWYU pragma: keep
 #include "test_common.h"
+#include "common.h"
 
 struct ImapAccountData;
 
@@ -42,18 +43,6 @@ struct TestCase
   const char *result;
 };
 
-struct Buffer *imap_exec_results = NULL;
-bool imap_exec_fail = false;
-
-int imap_exec(struct ImapAccountData *adata, const char *cmdstr, ImapCmdFlags flags)
-{
-  if (imap_exec_fail)
-    return -1;
-
-  buf_add_printf(imap_exec_results, "%s\n", cmdstr);
-  return 0;
-}
-
 void test_sort(void)
 {
   TEST_CASE("sort");
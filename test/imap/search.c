@@ -0,0 +1,293 @@
+/**
+ * @file
+ * Test code for the IMAP server-side searches
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "imap/lib.h"
+#include "pattern/lib.h"
+#include "imap/adata.h"
+#include "imap/edata.h"
+#include "imap/mdata.h"
+#include "imap/private.h" // IWYU pragma: keep
+#include "common.h"
+#include "test_common.h"
+
+/**
+ * struct TestServer - A selected IMAP Mailbox
+ */
+struct TestServer
+{
+  struct Account account;
+  struct Mailbox mailbox;
+  struct ImapAccountData adata;
+  struct ImapMboxData mdata;
+  struct Email emails[4];
+  struct ImapEmailData edata[4];
+  struct Email *email_ptrs[4];
+};
+
+static void server_init(struct TestServer *ts, int count)
+{
+  memset(ts, 0, sizeof(*ts));
+  ts->account.adata = &ts->adata;
+  ts->adata.mailbox = &ts->mailbox;
+  ts->mailbox.type = MUTT_IMAP;
+  ts->mailbox.account = &ts->account;
+  ts->mailbox.mdata = &ts->mdata;
+  ts->mailbox.emails = ts->email_ptrs;
+  ts->mdata.uidvalidity = 42;
+
+  for (size_t i = 0; i < mutt_array_size(ts->emails); i++)
+  {
+    ts->edata[i].uid = i + 1;
+    ts->emails[i].edata = &ts->edata[i];
+    ts->email_ptrs[i] = &ts->emails[i];
+  }
+  ts->mailbox.msg_count = count;
+
+  imap_exec_results = buf_pool_get();
+  imap_exec_search = NULL;
+}
+
+static void server_free(struct TestServer *ts)
+{
+  imap_search_free(&ts->mdata, true);
+  buf_pool_release(&imap_exec_results);
+  imap_exec_search = NULL;
+}
+
+/**
+ * server_search - Search the server, recording the commands
+ * @param ts  Server
+ * @param pat Pattern
+ * @retval ptr Commands that were sent
+ */
+static const char *server_search(struct TestServer *ts, PatternList *pat)
+{
+  buf_reset(imap_exec_results);
+  TEST_CHECK(imap_search(&ts->mailbox, pat));
+  return buf_string(imap_exec_results);
+}
+
+/**
+ * first_leaf - Get the first leaf of a compiled Pattern
+ * @param pat Pattern
+ * @retval ptr Leaf
+ */
+static const struct Pattern *first_leaf(PatternList *pat)
+{
+  const struct Pattern *p = pat->data;
+  while (p->child)
+    p = p->child->data;
+  return p;
+}
+
+void test_imap_search_narrow(void)
+{
+  // The cheap patterns are translated into keys that narrow the search
+
+  static const struct
+  {
+    const char *pattern;
+    const char *command;
+  } tests[] = {
+    // clang-format off
+    { "=b foo",                      "UID SEARCH BODY \"foo\"\n" },
+    { "~b foo",                      "UID SEARCH BODY \"foo\"\n" },
+    { "=B foo",                      "UID SEARCH TEXT \"foo\"\n" },
+    { "=h \"X-Foo: bar\"",           "UID SEARCH HEADER \"X-Foo\" \"bar\"\n" },
+    { "~b fo",                       "" },
+    { "~b foo ~F",                   "UID SEARCH FLAGGED BODY \"foo\"\n" },
+    { "~b foo !~F",                  "UID SEARCH NOT FLAGGED BODY \"foo\"\n" },
+    { "~b foo ~U",                   "UID SEARCH NOT SEEN BODY \"foo\"\n" },
+    { "~b foo !~U ~Q",               "UID SEARCH SEEN ANSWERED BODY \"foo\"\n" },
+    { "~b foo ~N",                   "UID SEARCH NOT SEEN BODY \"foo\"\n" },
+    { "~b foo !~N",                  "UID SEARCH BODY \"foo\"\n" },
+    { "~b foo ~z 1000-",             "UID SEARCH LARGER 999 BODY \"foo\"\n" },
+    { "~b foo !~z 1000-",            "UID SEARCH BODY \"foo\"\n" },
+    { "~b foo ~f alice",             "UID SEARCH FROM \"alice\" BODY \"foo\"\n" },
+    { "~b foo =s Hello",             "UID SEARCH SUBJECT \"Hello\" BODY \"foo\"\n" },
+    { "~b foo =f <alice>",           "UID SEARCH BODY \"foo\"\n" },
+    { "~b foo !~f alice",            "UID SEARCH BODY \"foo\"\n" },
+    { "~b foo ~d 1/6/2020-",         "UID SEARCH SENTSINCE 31-May-2020 BODY \"foo\"\n" },
+    { "~b foo ~r 1/6/2020-3/6/2020", "UID SEARCH SINCE 31-May-2020 BEFORE 5-Jun-2020 BODY \"foo\"\n" },
+    { "~b foo (~F | ~s hello)",      "UID SEARCH BODY \"foo\"\n" },
+    { "~F (~b foo | ~s hello)",      "UID SEARCH FLAGGED BODY \"foo\"\n" },
+    { "~F ~(~b foo)",                "UID SEARCH BODY \"foo\"\n" },
+    // clang-format on
+  };
+
+  struct TestServer ts = { 0 };
+  struct Buffer *err = buf_pool_get();
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i].pattern);
+    server_init(&ts, 0);
+    buf_reset(err);
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, tests[i].pattern, MUTT_PC_NO_FLAGS, err);
+    if (!TEST_CHECK(pat != NULL))
+    {
+      TEST_MSG("Error: %s", buf_string(err));
+      server_free(&ts);
+      continue;
+    }
+
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), tests[i].command);
+    mutt_patternlist_free_full(pat);
+    server_free(&ts);
+  }
+  buf_pool_release(&err);
+}
+
+void test_imap_search_cache(void)
+{
+  // The results are cached until the UIDVALIDITY or MODSEQ changes
+
+  struct TestServer ts = { 0 };
+  struct Buffer *err = buf_pool_get();
+
+  {
+    server_init(&ts, 3);
+    imap_exec_search = "SEARCH 2";
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, "=b foo", MUTT_PC_NO_FLAGS, err);
+    TEST_CHECK(pat != NULL);
+
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH BODY \"foo\"\n");
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "");
+
+    // New Emails are searched for incrementally
+    ts.mailbox.msg_count = 4;
+    imap_exec_search = "SEARCH 4";
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH UID 4:* BODY \"foo\"\n");
+    TEST_CHECK(imap_search_match(&ts.mailbox, first_leaf(pat), &ts.emails[1]) == 1);
+    TEST_CHECK(imap_search_match(&ts.mailbox, first_leaf(pat), &ts.emails[3]) == 1);
+    TEST_CHECK(imap_search_match(&ts.mailbox, first_leaf(pat), &ts.emails[2]) == 0);
+
+    // If UID 5 has gone, the reply to "5:*" is the highest UID, which was already searched
+    ts.edata[3].uid = 3;
+    ts.edata[2].uid = 5;
+    imap_exec_search = "SEARCH 4";
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH UID 5:* BODY \"foo\"\n");
+    TEST_CHECK(imap_search_match(&ts.mailbox, first_leaf(pat), &ts.emails[2]) == 0);
+
+    // A new UIDVALIDITY invalidates everything
+    ts.mdata.uidvalidity++;
+    imap_exec_search = "SEARCH 1";
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH BODY \"foo\"\n");
+    TEST_CHECK(imap_search_match(&ts.mailbox, first_leaf(pat), &ts.emails[0]) == 1);
+    TEST_CHECK(imap_search_match(&ts.mailbox, first_leaf(pat), &ts.emails[1]) == 0);
+
+    // The MODSEQ doesn't matter without flags
+    ts.mdata.modseq = 7;
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "");
+
+    mutt_patternlist_free_full(pat);
+    server_free(&ts);
+  }
+
+  {
+    server_init(&ts, 3);
+    imap_exec_search = "SEARCH 2";
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, "=b foo ~F", MUTT_PC_NO_FLAGS, err);
+    TEST_CHECK(pat != NULL);
+
+    // Without a MODSEQ, the flags might have changed
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH FLAGGED BODY \"foo\"\n");
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH FLAGGED BODY \"foo\"\n");
+
+    ts.mdata.modseq = 7;
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH FLAGGED BODY \"foo\"\n");
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "");
+
+    ts.mdata.modseq = 8;
+    TEST_CHECK_STR_EQ(server_search(&ts, pat), "UID SEARCH FLAGGED BODY \"foo\"\n");
+
+    mutt_patternlist_free_full(pat);
+    server_free(&ts);
+  }
+
+  buf_pool_release(&err);
+}
+
+void test_imap_search_match(void)
+{
+  // int imap_search_match(struct Mailbox *m, const struct Pattern *pat, struct Email *e);
+
+  struct TestServer ts = { 0 };
+  struct Buffer *err = buf_pool_get();
+
+  {
+    server_init(&ts, 3);
+    TEST_CHECK(imap_search_match(NULL, NULL, NULL) == -1);
+    TEST_CHECK(imap_search_match(&ts.mailbox, NULL, &ts.emails[0]) == -1);
+    server_free(&ts);
+  }
+
+  {
+    // A regex is searched for its literal text, so the result is a superset
+    server_init(&ts, 3);
+    imap_exec_search = "SEARCH 2";
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, "~b foo", MUTT_PC_NO_FLAGS, err);
+    TEST_CHECK(pat != NULL);
+    server_search(&ts, pat);
+
+    const struct Pattern *leaf = first_leaf(pat);
+    TEST_CHECK(imap_search_match(&ts.mailbox, leaf, &ts.emails[0]) == 0);
+    TEST_CHECK(imap_search_match(&ts.mailbox, leaf, &ts.emails[1]) == -1);
+
+    // Emails that arrived after the search are evaluated locally
+    ts.mailbox.msg_count = 4;
+    TEST_CHECK(imap_search_match(&ts.mailbox, leaf, &ts.emails[3]) == -1);
+
+    mutt_patternlist_free_full(pat);
+    server_free(&ts);
+  }
+
+  {
+    // Local flag changes can make the server's answer stale
+    server_init(&ts, 3);
+    ts.mdata.modseq = 7;
+    ts.emails[1].flagged = true;
+    imap_exec_search = "SEARCH 2";
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, "=b foo ~F", MUTT_PC_NO_FLAGS, err);
+    TEST_CHECK(pat != NULL);
+    server_search(&ts, pat);
+
+    const struct Pattern *leaf = first_leaf(pat);
+    TEST_CHECK(imap_search_match(&ts.mailbox, leaf, &ts.emails[1]) == 1);
+    TEST_CHECK(imap_search_match(&ts.mailbox, leaf, &ts.emails[2]) == 0);
+    ts.emails[2].flagged = true;
+    TEST_CHECK(imap_search_match(&ts.mailbox, leaf, &ts.emails[2]) == -1);
+
+    mutt_patternlist_free_full(pat);
+    server_free(&ts);
+  }
+
+  buf_pool_release(&err);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file
+ * Test code for mailbox_hot_update()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+
+void test_mailbox_hot_update(void)
+{
+  // void mailbox_hot_update(struct Mailbox *m, const struct Email *e);
+
+  {
+    struct Mailbox m = { { 0 } };
+    mailbox_hot_update(NULL, NULL);
+    mailbox_hot_update(&m, NULL);
+    TEST_CHECK_(1, "mailbox_hot_update(&m, NULL)");
+  }
+
+  {
+    struct Mailbox *m = mailbox_new();
+    struct Email *e = email_new();
+    e->body = mutt_body_new();
+    e->body->hdr_offset = 100;
+    e->body->offset = 250;
+    e->body->length = 1234;
+    e->msgno = 3;
+    e->vnum = 2;
+    e->score = 42;
+    e->date_sent = 1000;
+    e->received = 2000;
+    e->read = true;
+    e->tagged = true;
+    m->emails[3] = e;
+    m->msg_count = 4;
+
+    // New slots are empty
+    TEST_CHECK(m->hot.flags[3] == EMAIL_HOT_NO_FLAGS);
+    TEST_CHECK(m->hot.vnum[3] == -1);
+
+    mailbox_hot_update(m, e);
+    TEST_CHECK(m->hot.flags[3] == (EMAIL_HOT_READ | EMAIL_HOT_TAGGED | EMAIL_HOT_VISIBLE));
+    TEST_CHECK(m->hot.vnum[3] == 2);
+    TEST_CHECK(m->hot.score[3] == 42);
+    TEST_CHECK(m->hot.date_sent[3] == 1000);
+    TEST_CHECK(m->hot.received[3] == 2000);
+    TEST_CHECK(m->hot.size[3] == 1234);
+    TEST_CHECK(m->hot.hdr_size[3] == 150);
+
+    e->tagged = false;
+    e->deleted = true;
+    mailbox_hot_update(m, e);
+    TEST_CHECK(m->hot.flags[3] == (EMAIL_HOT_READ | EMAIL_HOT_DELETED | EMAIL_HOT_VISIBLE));
+
+    // An Email that isn't at its msgno is ignored
+    e->msgno = 1;
+    e->flagged = true;
+    mailbox_hot_update(m, e);
+    TEST_CHECK(!(m->hot.flags[3] & EMAIL_HOT_FLAGGED));
+    TEST_CHECK(m->hot.flags[1] == EMAIL_HOT_NO_FLAGS);
+
+    m->emails[3] = NULL;
+    m->msg_count = 0;
+    email_free(&e);
+    mailbox_free(&m);
+  }
+}
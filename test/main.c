@@ -78,6 +78,12 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mutt_addrlist_write_list)                             \
   SPACEMUTT_TEST_ITEM(test_mutt_addrlist_write_wrap)                             \
                                                                                  \
+  /* arena */                                                                    \
+  SPACEMUTT_TEST_ITEM(test_arena_alloc)                                          \
+  SPACEMUTT_TEST_ITEM(test_arena_owns)                                           \
+  SPACEMUTT_TEST_ITEM(test_arena_release)                                        \
+  SPACEMUTT_TEST_ITEM(test_arena_strdup)                                         \
+                                                                                 \
   /* array */                                                                    \
   SPACEMUTT_TEST_ITEM(test_mutt_array_api)                                       \
                                                                                  \
@@ -226,6 +232,7 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mutt_date_localtime_format_locale)                    \
   SPACEMUTT_TEST_ITEM(test_mutt_date_make_date)                                  \
   SPACEMUTT_TEST_ITEM(test_mutt_date_make_imap)                                  \
+  SPACEMUTT_TEST_ITEM(test_mutt_date_make_imap_day)                              \
   SPACEMUTT_TEST_ITEM(test_mutt_date_make_time)                                  \
   SPACEMUTT_TEST_ITEM(test_mutt_date_make_tls)                                   \
   SPACEMUTT_TEST_ITEM(test_mutt_date_normalize_time)                             \
@@ -233,6 +240,9 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mutt_date_parse_imap)                                 \
   SPACEMUTT_TEST_ITEM(test_mutt_date_sleep_ms)                                   \
                                                                                  \
+  /* dirscan */                                                                  \
+  SPACEMUTT_TEST_ITEM(test_dirscan_next)                                         \
+                                                                                 \
   /* editor */                                                                   \
   SPACEMUTT_TEST_ITEM(test_editor_backspace)                                     \
   SPACEMUTT_TEST_ITEM(test_editor_backward_char)                                 \
@@ -256,9 +266,11 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_email_cmp_strict)                                     \
   SPACEMUTT_TEST_ITEM(test_email_free)                                           \
   SPACEMUTT_TEST_ITEM(test_email_new)                                            \
+  SPACEMUTT_TEST_ITEM(test_email_new_arena)                                      \
   SPACEMUTT_TEST_ITEM(test_email_size)                                           \
   SPACEMUTT_TEST_ITEM(test_mutt_autocrypthdr_free)                               \
   SPACEMUTT_TEST_ITEM(test_mutt_autocrypthdr_new)                                \
+  SPACEMUTT_TEST_ITEM(test_part_summary_new)                                     \
   SPACEMUTT_TEST_ITEM(test_email_header_find)                                    \
   SPACEMUTT_TEST_ITEM(test_email_header_add)                                     \
   SPACEMUTT_TEST_ITEM(test_email_header_update)                                  \
@@ -268,6 +280,7 @@ void test_fini(void);
   /* envelope */                                                                 \
   SPACEMUTT_TEST_ITEM(test_mutt_env_cmp_strict)                                  \
   SPACEMUTT_TEST_ITEM(test_mutt_env_free)                                        \
+  SPACEMUTT_TEST_ITEM(test_mutt_env_materialize)                                 \
   SPACEMUTT_TEST_ITEM(test_mutt_env_merge)                                       \
   SPACEMUTT_TEST_ITEM(test_mutt_env_new)                                         \
   SPACEMUTT_TEST_ITEM(test_mutt_env_to_intl)                                     \
@@ -424,6 +437,9 @@ void test_fini(void);
                                                                                  \
   /* imap */                                                                     \
   SPACEMUTT_TEST_ITEM(test_imap_msg_set)                                         \
+  SPACEMUTT_TEST_ITEM(test_imap_search_cache)                                    \
+  SPACEMUTT_TEST_ITEM(test_imap_search_match)                                    \
+  SPACEMUTT_TEST_ITEM(test_imap_search_narrow)                                   \
                                                                                  \
   /* logging */                                                                  \
   SPACEMUTT_TEST_ITEM(test_log_disp_file)                                        \
@@ -446,6 +462,7 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mailbox_find)                                         \
   SPACEMUTT_TEST_ITEM(test_mailbox_find_name)                                    \
   SPACEMUTT_TEST_ITEM(test_mailbox_free)                                         \
+  SPACEMUTT_TEST_ITEM(test_mailbox_hot_update)                                   \
   SPACEMUTT_TEST_ITEM(test_mailbox_new)                                          \
   SPACEMUTT_TEST_ITEM(test_mailbox_set_subset)                                   \
   SPACEMUTT_TEST_ITEM(test_mailbox_size_add)                                     \
@@ -459,12 +476,15 @@ void test_fini(void);
                                                                                  \
   /* mbyte */                                                                    \
   SPACEMUTT_TEST_ITEM(test_buf_mb_wcstombs)                                      \
+  SPACEMUTT_TEST_ITEM(test_mutt_mb_ascii_len)                                    \
+  SPACEMUTT_TEST_ITEM(test_mutt_mb_char_width)                                   \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_charlen)                                      \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_filter_unprintable)                           \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_get_initials)                                 \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_is_display_corrupting_utf8)                   \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_is_lower)                                     \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_is_shell_char)                                \
+  SPACEMUTT_TEST_ITEM(test_mutt_mb_mbrtowc)                                      \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_mbstowcs)                                     \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_wcswidth)                                     \
   SPACEMUTT_TEST_ITEM(test_mutt_mb_wcwidth)                                      \
@@ -509,6 +529,7 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mutt_parse_multipart)                                 \
   SPACEMUTT_TEST_ITEM(test_mutt_parse_part)                                      \
   SPACEMUTT_TEST_ITEM(test_mutt_read_mime_header)                                \
+  SPACEMUTT_TEST_ITEM(test_mutt_rfc822_next_field)                               \
   SPACEMUTT_TEST_ITEM(test_mutt_rfc822_parse_line)                               \
   SPACEMUTT_TEST_ITEM(test_mutt_rfc822_parse_message)                            \
   SPACEMUTT_TEST_ITEM(test_mutt_rfc822_read_header)                              \
@@ -533,6 +554,7 @@ void test_fini(void);
                                                                                  \
   /* pattern */                                                                  \
   SPACEMUTT_TEST_ITEM(test_mutt_pattern_comp)                                    \
+  SPACEMUTT_TEST_ITEM(test_mutt_pattern_deps)                                    \
   SPACEMUTT_TEST_ITEM(test_mutt_pattern_leak)                                    \
                                                                                  \
   /* prex */                                                                     \
@@ -547,6 +569,7 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mutt_regex_capture)                                   \
   SPACEMUTT_TEST_ITEM(test_mutt_regex_compile)                                   \
   SPACEMUTT_TEST_ITEM(test_mutt_regex_free)                                      \
+  SPACEMUTT_TEST_ITEM(test_mutt_regex_literal)                                   \
   SPACEMUTT_TEST_ITEM(test_mutt_regex_match)                                     \
   SPACEMUTT_TEST_ITEM(test_mutt_regex_new)                                       \
   SPACEMUTT_TEST_ITEM(test_mutt_regexlist_add)                                   \
@@ -572,6 +595,16 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_rfc2231_decode_parameters)                            \
   SPACEMUTT_TEST_ITEM(test_rfc2231_encode_string)                                \
                                                                                  \
+  /* score */                                                                    \
+  SPACEMUTT_TEST_ITEM(test_mutt_score_message)                                   \
+                                                                                 \
+  /* send */                                                                     \
+  SPACEMUTT_TEST_ITEM(test_outbox_backoff)                                       \
+  SPACEMUTT_TEST_ITEM(test_outbox_entry_load)                                    \
+                                                                                 \
+  /* sidebar */                                                                  \
+  SPACEMUTT_TEST_ITEM(test_sb_sort_reposition)                                   \
+                                                                                 \
   /* signal */                                                                   \
   SPACEMUTT_TEST_ITEM(test_mutt_sig_allow_interrupt)                             \
   SPACEMUTT_TEST_ITEM(test_mutt_sig_block)                                       \
@@ -651,6 +684,11 @@ void test_fini(void);
   SPACEMUTT_TEST_ITEM(test_mutt_break_thread)                                    \
   SPACEMUTT_TEST_ITEM(test_unlink_message)                                       \
                                                                                  \
+  /* trace */                                                                    \
+  SPACEMUTT_TEST_ITEM(test_trace_count)                                          \
+  SPACEMUTT_TEST_ITEM(test_trace_dump)                                           \
+  SPACEMUTT_TEST_ITEM(test_trace_span_end)                                       \
+                                                                                 \
   /* url */                                                                      \
   SPACEMUTT_TEST_ITEM(test_url_check_scheme)                                     \
   SPACEMUTT_TEST_ITEM(test_url_free)                                             \
@@ -672,6 +710,13 @@ SPACEMUTT_TEST_LIST
 #ifdef USE_LZ4
   SPACEMUTT_TEST_ITEM(test_compress_lz4)
 #endif
+#ifdef USE_INOTIFY
+  SPACEMUTT_TEST_ITEM(test_mutt_monitor_take_events)
+#endif
+#ifdef USE_SSL
+  SPACEMUTT_TEST_ITEM(test_tls_session_cache)
+  SPACEMUTT_TEST_ITEM(test_tls_session_resume)
+#endif
 #ifdef USE_NOTMUCH
   SPACEMUTT_TEST_ITEM(test_nm_parse_type_from_query)
   SPACEMUTT_TEST_ITEM(test_nm_query_type_to_string)
@@ -686,7 +731,7 @@ SPACEMUTT_TEST_LIST
 #ifdef USE_ZSTD
   SPACEMUTT_TEST_ITEM(test_compress_zstd)
 #endif
-#if defined(HAVE_BDB) || defined(HAVE_GDBM) || defined(HAVE_KC) || defined(HAVE_LMDB) || defined(HAVE_QDBM) || defined(HAVE_ROCKSDB) || defined(HAVE_TC) || defined(HAVE_TDB)
+#if defined(HAVE_BDB) || defined(HAVE_GDBM) || defined(HAVE_KC) || defined(HAVE_LMDB) || defined(HAVE_LOGDB) || defined(HAVE_QDBM) || defined(HAVE_ROCKSDB) || defined(HAVE_TC) || defined(HAVE_TDB)
   SPACEMUTT_TEST_ITEM(test_store_store)
 #endif
 #ifdef HAVE_BDB
@@ -701,6 +746,9 @@ SPACEMUTT_TEST_LIST
 #ifdef HAVE_LMDB
   SPACEMUTT_TEST_ITEM(test_store_lmdb)
 #endif
+#ifdef HAVE_LOGDB
+  SPACEMUTT_TEST_ITEM(test_store_logdb)
+#endif
 #ifdef HAVE_QDBM
   SPACEMUTT_TEST_ITEM(test_store_qdbm)
 #endif
@@ -724,6 +772,13 @@ SPACEMUTT_TEST_ITEM(test_compress_common)
 #ifdef USE_LZ4
   SPACEMUTT_TEST_ITEM(test_compress_lz4)
 #endif
+#ifdef USE_INOTIFY
+  SPACEMUTT_TEST_ITEM(test_mutt_monitor_take_events)
+#endif
+#ifdef USE_SSL
+  SPACEMUTT_TEST_ITEM(test_tls_session_cache)
+  SPACEMUTT_TEST_ITEM(test_tls_session_resume)
+#endif
 #ifdef USE_NOTMUCH
   SPACEMUTT_TEST_ITEM(test_nm_parse_type_from_query)
   SPACEMUTT_TEST_ITEM(test_nm_query_type_to_string)
@@ -738,7 +793,7 @@ SPACEMUTT_TEST_ITEM(test_compress_common)
 #ifdef USE_ZSTD
   SPACEMUTT_TEST_ITEM(test_compress_zstd)
 #endif
-#if defined(HAVE_BDB) || defined(HAVE_GDBM) || defined(HAVE_KC) || defined(HAVE_LMDB) || defined(HAVE_QDBM) || defined(HAVE_ROCKSDB) || defined(HAVE_TC) || defined(HAVE_TDB)
+#if defined(HAVE_BDB) || defined(HAVE_GDBM) || defined(HAVE_KC) || defined(HAVE_LMDB) || defined(HAVE_LOGDB) || defined(HAVE_QDBM) || defined(HAVE_ROCKSDB) || defined(HAVE_TC) || defined(HAVE_TDB)
   SPACEMUTT_TEST_ITEM(test_store_store)
 #endif
 #ifdef HAVE_BDB
@@ -753,6 +808,9 @@ SPACEMUTT_TEST_ITEM(test_compress_common)
 #ifdef HAVE_LMDB
   SPACEMUTT_TEST_ITEM(test_store_lmdb)
 #endif
+#ifdef HAVE_LOGDB
+  SPACEMUTT_TEST_ITEM(test_store_logdb)
+#endif
 #ifdef HAVE_QDBM
   SPACEMUTT_TEST_ITEM(test_store_qdbm)
 #endif
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * Test code for mutt_mb_ascii_len()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <string.h>
+#include "mutt/lib.h"
+
+void test_mutt_mb_ascii_len(void)
+{
+  // size_t mutt_mb_ascii_len(const char *s, size_t n);
+
+  {
+    TEST_CHECK(mutt_mb_ascii_len(NULL, 10) == 0);
+    TEST_CHECK(mutt_mb_ascii_len("apple", 0) == 0);
+  }
+
+  {
+    static const struct
+    {
+      const char *str;
+      size_t len;
+    } tests[] = {
+      // clang-format off
+      { "",                                    0 },
+      { "apple",                               5 },
+      { "The quick brown fox jumps over",     30 },
+      { "The quick brown fox\tjumps",         19 },
+      { "The quick brown fox\njumps",         19 },
+      { "12345678\x7f",                        8 },
+      { "1234567\x7f",                         7 },
+      { "1234567890123456 Ελληνικά",          17 },
+      { "\x01 apple",                          0 },
+      { "~}|{ !\"#$%&'()*+,-./",              20 },
+      // clang-format on
+    };
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      TEST_CASE(tests[i].str);
+      const size_t len = mutt_mb_ascii_len(tests[i].str, strlen(tests[i].str));
+      TEST_CHECK(len == tests[i].len);
+      TEST_MSG("Expected: %zu", tests[i].len);
+      TEST_MSG("Actual:   %zu", len);
+    }
+  }
+
+  {
+    // The length limits the count
+    TEST_CHECK(mutt_mb_ascii_len("apple banana cherry", 11) == 11);
+  }
+}
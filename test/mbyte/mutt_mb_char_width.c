@@ -0,0 +1,74 @@
+/**
+ * @file
+ * Test code for mutt_mb_char_width()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <locale.h>
+#include <stdbool.h>
+#include <wchar.h>
+#include <wctype.h>
+#include "mutt/lib.h"
+
+/// Locales to compare with libc, any that aren't installed are skipped
+static const char *Locales[] = {
+  "C", "C.UTF-8", "en_US.UTF-8", "en_US.ISO-8859-1", "ja_JP.eucJP", "zh_CN.GB18030",
+};
+
+void test_mutt_mb_char_width(void)
+{
+  // int mutt_mb_char_width(wchar_t wc);
+  // bool mutt_mb_char_print(wchar_t wc);
+
+  char *saved = mutt_str_dup(setlocale(LC_ALL, NULL));
+
+  for (size_t i = 0; i < mutt_array_size(Locales); i++)
+  {
+    if (!setlocale(LC_ALL, Locales[i]))
+      continue;
+
+    TEST_CASE(Locales[i]);
+    mutt_mb_width_reset();
+
+    int bad = 0;
+    for (wchar_t wc = 0; (wc < 0x32000) && (bad < 5); wc++)
+    {
+      const int width = mutt_mb_char_width(wc);
+      const bool print = mutt_mb_char_print(wc);
+      if (!TEST_CHECK(width == wcwidth(wc)) || !TEST_CHECK(print == (iswprint(wc) != 0)))
+      {
+        TEST_MSG("Character U+%04X", (unsigned int) wc);
+        TEST_MSG("Expected: %d, %d", wcwidth(wc), iswprint(wc) != 0);
+        TEST_MSG("Actual:   %d, %d", width, print);
+        bad++;
+      }
+    }
+
+    // Beyond the table
+    TEST_CHECK(mutt_mb_char_width(0x10ffff) == wcwidth(0x10ffff));
+    TEST_CHECK(mutt_mb_char_width(0x7fffffff) == wcwidth(0x7fffffff));
+  }
+
+  setlocale(LC_ALL, saved);
+  mutt_mb_width_reset();
+  FREE(&saved);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * Test code for mutt_mb_mbrtowc()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <locale.h>
+#include <string.h>
+#include <wchar.h>
+#include "mutt/lib.h"
+
+/// Locales to compare with libc, any that aren't installed are skipped
+static const char *Locales[] = {
+  "C", "C.UTF-8", "en_US.UTF-8", "en_US.ISO-8859-1", "ja_JP.eucJP", "zh_CN.GB18030",
+};
+
+void test_mutt_mb_mbrtowc(void)
+{
+  // size_t mutt_mb_mbrtowc(wchar_t *pwc, const char *s, size_t n, mbstate_t *ps);
+
+  static const char *tests[] = {
+    "apple",
+    "Ελληνικά",
+    "日本語 中文 한국어",
+    "emoji \xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf",
+    "overlong \xc0\xaf \xe0\x80\xaf \xf0\x80\x80\xaf",
+    "surrogate \xed\xa0\x80 \xed\xbf\xbf",
+    "too big \xf4\x90\x80\x80 \xf5\x80\x80\x80 \xff",
+    "bad continuation \xc3\x28 \xe2\x82\x28 \xe2\x28\xa1",
+    "control \x01\x1b[0m\x7f \xc2\x80\xc2\x9f",
+    "latin1 caf\xe9 na\xefve",
+    "truncated \xe6\x97",
+  };
+
+  char *saved = mutt_str_dup(setlocale(LC_ALL, NULL));
+
+  for (size_t i = 0; i < mutt_array_size(Locales); i++)
+  {
+    if (!setlocale(LC_ALL, Locales[i]))
+      continue;
+
+    mutt_mb_width_reset();
+    for (size_t j = 0; j < mutt_array_size(tests); j++)
+    {
+      TEST_CASE_("%s: %zu", Locales[i], j);
+      const char *str = tests[j];
+      const size_t len = strlen(str) + 1;
+
+      // Try every starting point, including the terminating NUL
+      for (size_t k = 0; k < len; k++)
+      {
+        mbstate_t mbs1 = { 0 };
+        mbstate_t mbs2 = { 0 };
+        wchar_t wc1 = 0;
+        wchar_t wc2 = 0;
+
+        const size_t rc1 = mbrtowc(&wc1, str + k, len - k - 1, &mbs1);
+        const size_t rc2 = mutt_mb_mbrtowc(&wc2, str + k, len - k - 1, &mbs2);
+        if (!TEST_CHECK(rc1 == rc2))
+        {
+          TEST_MSG("Offset %zu", k);
+          TEST_MSG("Expected: %zd", (ssize_t) rc1);
+          TEST_MSG("Actual:   %zd", (ssize_t) rc2);
+          continue;
+        }
+
+        if (rc1 < ICONV_BUF_TOO_SMALL)
+        {
+          TEST_CHECK(wc1 == wc2);
+          TEST_MSG("Offset %zu: expected U+%04X, got U+%04X", k,
+                   (unsigned int) wc1, (unsigned int) wc2);
+        }
+      }
+    }
+  }
+
+  setlocale(LC_ALL, saved);
+  mutt_mb_width_reset();
+  FREE(&saved);
+}
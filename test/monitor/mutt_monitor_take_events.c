@@ -0,0 +1,157 @@
+/**
+ * @file
+ * Test code for mutt_monitor_take_events()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "core/lib.h"
+#include "monitor.h"
+#include "test_common.h"
+
+static void make_file(const char *dir, const char *name)
+{
+  char path[PATH_MAX] = { 0 };
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0600);
+  TEST_CHECK(fd >= 0);
+  close(fd);
+}
+
+static struct Mailbox *make_maildir(const char *dir)
+{
+  char path[PATH_MAX] = { 0 };
+  const char *subdirs[] = { "cur", "new", "tmp" };
+  for (size_t i = 0; i < mutt_array_size(subdirs); i++)
+  {
+    snprintf(path, sizeof(path), "%s/%s", dir, subdirs[i]);
+    TEST_CHECK(mkdir(path, 0700) == 0);
+  }
+
+  struct Mailbox *m = mailbox_new();
+  m->type = MUTT_MAILDIR;
+  m->realpath = mutt_str_dup(dir);
+  return m;
+}
+
+void test_mutt_monitor_take_events(void)
+{
+  // bool mutt_monitor_take_events(struct Mailbox *m, struct MonitorEventArray *events);
+
+  {
+    struct MonitorEventArray events = ARRAY_HEAD_INITIALIZER;
+    TEST_CHECK(!mutt_monitor_take_events(NULL, &events));
+    TEST_CHECK(!mutt_monitor_take_events((struct Mailbox *) &events, NULL));
+  }
+
+  char tmpl[] = "/tmp/spacemutt-monitor-XXXXXX";
+  const char *dir = mkdtemp(tmpl);
+  if (!TEST_CHECK(dir != NULL))
+    return;
+
+  char path_cur[PATH_MAX] = { 0 };
+  char path_bg[PATH_MAX] = { 0 };
+  char file[PATH_MAX] = { 0 };
+  char file2[PATH_MAX] = { 0 };
+  snprintf(path_cur, sizeof(path_cur), "%s/current", dir);
+  snprintf(path_bg, sizeof(path_bg), "%s/background", dir);
+  TEST_CHECK(mkdir(path_cur, 0700) == 0);
+  TEST_CHECK(mkdir(path_bg, 0700) == 0);
+
+  struct Mailbox *m = make_maildir(path_cur);
+  struct Mailbox *m_bg = make_maildir(path_bg);
+
+  snprintf(file, sizeof(file), "%s/new", path_bg);
+  make_file(file, "1.old");
+
+  TestCurrentMailbox = m;
+  TEST_CHECK(mutt_monitor_add(NULL) == 0);
+  TEST_CHECK(mutt_monitor_add(m_bg) == 0);
+
+  struct MonitorEventArray events = ARRAY_HEAD_INITIALIZER;
+
+  {
+    // Changes before the monitor was attached are unknown, so the first check rescans
+    TEST_CHECK(MonitorCurMboxChanged);
+    TEST_CHECK(!mutt_monitor_take_events(m, &events));
+    TEST_CHECK(ARRAY_EMPTY(&events));
+    TEST_CHECK(!mutt_monitor_take_events(m_bg, &events));
+  }
+
+  {
+    // A new message, which is then read
+    snprintf(file, sizeof(file), "%s/new", path_cur);
+    make_file(file, "1.abc");
+    mutt_monitor_poll();
+
+    snprintf(file, sizeof(file), "%s/new/1.abc", path_cur);
+    snprintf(file2, sizeof(file2), "%s/cur/1.abc:2,S", path_cur);
+    TEST_CHECK(rename(file, file2) == 0);
+    mutt_monitor_poll();
+
+    TEST_CHECK(mutt_monitor_take_events(m, &events));
+    if (TEST_CHECK(ARRAY_SIZE(&events) == 3))
+    {
+      struct MonitorEvent *ev = ARRAY_GET(&events, 0);
+      TEST_CHECK((ev->type == MONITOR_EV_ADDED) && mutt_str_equal(ev->subdir, "new"));
+      TEST_CHECK_STR_EQ(ev->name, "1.abc");
+      ev = ARRAY_GET(&events, 1);
+      TEST_CHECK((ev->type == MONITOR_EV_REMOVED) && mutt_str_equal(ev->subdir, "new"));
+      TEST_CHECK_STR_EQ(ev->name, "1.abc");
+      ev = ARRAY_GET(&events, 2);
+      TEST_CHECK((ev->type == MONITOR_EV_ADDED) && mutt_str_equal(ev->subdir, "cur"));
+      TEST_CHECK_STR_EQ(ev->name, "1.abc:2,S");
+    }
+    mutt_monitor_events_free(&events);
+
+    // The queue is empty now
+    TEST_CHECK(mutt_monitor_take_events(m, &events));
+    TEST_CHECK(ARRAY_EMPTY(&events));
+  }
+
+  {
+    // Deleting a message in a background mailbox isn't reported
+    snprintf(file, sizeof(file), "%s/new/1.old", path_bg);
+    TEST_CHECK(unlink(file) == 0);
+    mutt_monitor_poll();
+    TEST_CHECK(!MonitorFilesChanged);
+  }
+
+  mutt_monitor_remove(m_bg);
+  mutt_monitor_remove(NULL);
+  TestCurrentMailbox = NULL;
+
+  {
+    // Once detached, the mailbox must be rescanned
+    TEST_CHECK(!mutt_monitor_take_events(m, &events));
+  }
+
+  mailbox_free(&m);
+  mailbox_free(&m_bg);
+  mutt_file_rmtree(dir);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * Test code for mutt_rfc822_next_field()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "email/lib.h"
+#include "test_common.h"
+
+static struct Rfc822NextFieldTestData
+{
+  const char *input;
+  const char *name;  ///< Expected name of the first field, NULL if no colon
+  const char *value; ///< Expected value, or whole line if there's no colon
+  size_t pos;        ///< Expected offset of the next field
+} test_data[] = {
+  /* clang-format off */
+  { "Subject: basic stuff\n",                 "Subject", "basic stuff",   21 },
+  { "Subject: basic stuff\n\n  ",             "Subject", "basic stuff",   21 },
+  { "Subject: long\n subject\n",              "Subject", "long subject",  23 },
+  { "Subject: long\n      subject\n",         "Subject", "long subject",  28 },
+  { "Subject: one\nAnother: two\n",           "Subject", "one",           13 },
+  { "Subject: one    \n",                     "Subject", "one",           17 },
+  { "Subject: one\r\n\tand two\r\n",          "Subject", "one and two",   24 },
+  { "Subject: no newline",                    "Subject", "no newline",    19 },
+  { "X-Empty:\nNext: one\n",                  "X-Empty", "",              9 },
+  { "From me@example.com Mon Jan  1 00:00:00 2024\n", NULL, "From me@example.com Mon Jan  1 00:00:00 2024", 45 },
+  /* clang-format on */
+};
+
+/**
+ * parse_chunked - Feed data to mutt_rfc822_next_field() a few bytes at a time
+ * @param input Header data
+ * @param chunk Number of bytes to add each time
+ * @param out   Buffer for the fields, "name=value" separated by '|'
+ */
+static void parse_chunked(const char *input, size_t chunk, struct Buffer *out)
+{
+  char buf[256] = { 0 };
+  size_t total = strlen(input);
+  size_t used = 0;
+  size_t pos = 0;
+  bool eof = false;
+
+  while (true)
+  {
+    struct HeaderField hf = { 0 };
+    enum HeaderToken rc = mutt_rfc822_next_field(buf, used, &pos, eof, &hf);
+    if (rc == HDR_END)
+      break;
+
+    if (rc == HDR_MORE)
+    {
+      memmove(buf, buf + pos, used - pos);
+      used -= pos;
+      pos = 0;
+      const size_t n = MIN(total, chunk);
+      memcpy(buf + used, input, n);
+      input += n;
+      total -= n;
+      used += n;
+      buf[used] = '\0';
+      if (n < chunk)
+        eof = true;
+      continue;
+    }
+
+    if (hf.name_len == 0)
+      break;
+
+    buf_add_printf(out, "%.*s=%s|", (int) hf.name_len, hf.line, hf.value);
+  }
+}
+
+void test_mutt_rfc822_next_field(void)
+{
+  // enum HeaderToken mutt_rfc822_next_field(char *buf, size_t len, size_t *pos, bool eof, struct HeaderField *hf);
+
+  {
+    size_t pos = 0;
+    struct HeaderField hf = { 0 };
+    TEST_CHECK(mutt_rfc822_next_field(NULL, 0, &pos, true, &hf) == HDR_END);
+  }
+
+  {
+    char buf[] = "Subject: one\n";
+    size_t pos = 0;
+    struct HeaderField hf = { 0 };
+    TEST_CHECK(mutt_rfc822_next_field(buf, 0, &pos, false, &hf) == HDR_MORE);
+    TEST_CHECK(mutt_rfc822_next_field(buf, 0, &pos, true, &hf) == HDR_END);
+  }
+
+  {
+    // We can't tell if the field continues onto the next line
+    char buf[] = "Subject: one\n";
+    size_t pos = 0;
+    struct HeaderField hf = { 0 };
+    TEST_CHECK(mutt_rfc822_next_field(buf, sizeof(buf) - 1, &pos, false, &hf) == HDR_MORE);
+    TEST_CHECK(pos == 0);
+    TEST_CHECK_STR_EQ(buf, "Subject: one\n");
+  }
+
+  {
+    // A blank line ends the header, leaving the body alone
+    char buf[] = "To: a@example.com\n\nBody: text\n";
+    size_t pos = 0;
+    struct HeaderField hf = { 0 };
+    TEST_CHECK(mutt_rfc822_next_field(buf, sizeof(buf) - 1, &pos, true, &hf) == HDR_FIELD);
+    TEST_CHECK(mutt_rfc822_next_field(buf, sizeof(buf) - 1, &pos, true, &hf) == HDR_END);
+    TEST_CHECK(pos == 19);
+    TEST_CHECK_STR_EQ(buf + pos, "Body: text\n");
+  }
+
+  for (size_t i = 0; i < mutt_array_size(test_data); i++)
+  {
+    TEST_CASE(test_data[i].input);
+    char buf[256] = { 0 };
+    mutt_str_copy(buf, test_data[i].input, sizeof(buf));
+    const size_t len = strlen(buf);
+
+    size_t pos = 0;
+    struct HeaderField hf = { 0 };
+    TEST_CHECK(mutt_rfc822_next_field(buf, len, &pos, true, &hf) == HDR_FIELD);
+
+    if (test_data[i].name)
+    {
+      TEST_CHECK(hf.name_len == strlen(test_data[i].name));
+      TEST_CHECK(mutt_strn_equal(hf.line, test_data[i].name, hf.name_len));
+      TEST_CHECK_STR_EQ(hf.value, test_data[i].value);
+      TEST_CHECK(hf.value_len == strlen(test_data[i].value));
+    }
+    else
+    {
+      TEST_CHECK(hf.name_len == 0);
+      TEST_CHECK(hf.len == strlen(test_data[i].value));
+      TEST_CHECK(mutt_strn_equal(hf.line, test_data[i].value, hf.len));
+    }
+
+    if (!TEST_CHECK(pos == test_data[i].pos))
+    {
+      TEST_MSG("Expected: %zu", test_data[i].pos);
+      TEST_MSG("Actual  : %zu", pos);
+    }
+  }
+
+  {
+    // The result mustn't depend on how the data arrives
+    const char *input = "Head1: val1.1\n  val1.2\nHead2: val2.1\n\tval2.2\nHead3: three\n\nbody\n";
+    const char *expected = "Head1=val1.1 val1.2|Head2=val2.1 val2.2|Head3=three|";
+    for (size_t chunk = 1; chunk < 70; chunk++)
+    {
+      struct Buffer *out = buf_pool_get();
+      parse_chunked(input, chunk, out);
+      TEST_CHECK_STR_EQ(buf_string(out), expected);
+      buf_pool_release(&out);
+    }
+  }
+}
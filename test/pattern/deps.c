@@ -0,0 +1,89 @@
+/**
+ * @file
+ * Test code for mutt_pattern_deps()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "pattern/lib.h"
+#include "test_common.h"
+
+void test_mutt_pattern_deps(void)
+{
+  // PatternDeps mutt_pattern_deps(const PatternList *pat);
+
+  static const struct
+  {
+    const char *pattern;
+    PatternDeps deps;
+  } tests[] = {
+    // clang-format off
+    { "=s hello",           MUTT_PAT_DEP_NONE },
+    { "~f alice ~s hello",  MUTT_PAT_DEP_NONE },
+    { "~F",                 MUTT_PAT_DEP_FLAGS },
+    { "!~N | ~T",           MUTT_PAT_DEP_FLAGS },
+    { "~y work",            MUTT_PAT_DEP_LABELS },
+    { "~n 10-",             MUTT_PAT_DEP_SCORE },
+    { "~l",                 MUTT_PAT_DEP_CONFIG },
+    { "~(~P)",              MUTT_PAT_DEP_THREAD | MUTT_PAT_DEP_CONFIG },
+    { "=s x (~D | ~G)",     MUTT_PAT_DEP_FLAGS | MUTT_PAT_DEP_CRYPT },
+    { "@~f alice",          MUTT_PAT_DEP_CONFIG },
+    { "~X 1-",              MUTT_PAT_DEP_MESSAGE | MUTT_PAT_DEP_CONFIG },
+    // The range is fixed when the pattern is compiled
+    { "~d <1d",             MUTT_PAT_DEP_CONFIG },
+    { "~s x !~r 1/1/2020-", MUTT_PAT_DEP_CONFIG },
+    // clang-format on
+  };
+
+  TEST_CHECK(mutt_pattern_deps(NULL) == MUTT_PAT_DEP_NONE);
+
+  struct Buffer *err = buf_pool_get();
+  for (size_t i = 0; i < mutt_array_size(tests); i++)
+  {
+    TEST_CASE(tests[i].pattern);
+    buf_reset(err);
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, tests[i].pattern, MUTT_PC_NO_FLAGS, err);
+    if (!TEST_CHECK(pat != NULL))
+    {
+      TEST_MSG("Error: %s", buf_string(err));
+      continue;
+    }
+
+    PatternDeps deps = mutt_pattern_deps(pat);
+    TEST_CHECK(deps == tests[i].deps);
+    TEST_MSG("Expected: %d", tests[i].deps);
+    TEST_MSG("Actual  : %d", deps);
+    mutt_patternlist_free_full(pat);
+  }
+
+  {
+    // A dynamic range is worked out each time it's matched
+    PatternList *pat = mutt_pattern_comp(NULL, NULL, "~d <1d", MUTT_PC_PATTERN_DYNAMIC, err);
+    if (TEST_CHECK(pat != NULL))
+    {
+      TEST_CHECK(mutt_pattern_deps(pat) == MUTT_PAT_DEP_TIME);
+      mutt_patternlist_free_full(pat);
+    }
+  }
+  buf_pool_release(&err);
+}
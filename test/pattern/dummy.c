@@ -45,7 +45,6 @@ struct Envelope;
 struct Mapping;
 struct MuttWindow;
 struct Pager;
-struct Pattern;
 struct State;
 
 enum WindowType
@@ -66,6 +65,7 @@ enum WindowType
   WT_DLG_PAGER,       ///< Pager Dialog,       dlg_pager()
   WT_DLG_HISTORY,     ///< History Dialog,     dlg_history()
   WT_DLG_INDEX,       ///< Index Dialog,       dlg_index()
+  WT_DLG_OUTBOX,      ///< Outbox Dialog,      dlg_outbox()
   WT_DLG_PATTERN,     ///< Pattern Dialog,     dlg_pattern()
   WT_DLG_PGP,         ///< Pgp Dialog,         dlg_pgp()
   WT_DLG_POSTPONED,   ///< Postponed Dialog,   dlg_postponed()
@@ -124,11 +124,6 @@ bool crypt_valid_passphrase(SecurityFlags flags)
   return 0;
 }
 
-bool imap_search(struct Mailbox *m, const struct Pattern *pat)
-{
-  return false;
-}
-
 bool mutt_addr_is_user(struct Address *addr)
 {
   return g_addr_is_user;
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * Test code for mutt_regex_literal()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include "mutt/lib.h"
+#include "test_common.h"
+
+struct LiteralTest
+{
+  const char *regex;   ///< Regex to examine
+  const char *literal; ///< Expected literal, NULL if none
+};
+
+void test_mutt_regex_literal(void)
+{
+  // char *mutt_regex_literal(const char *regex);
+
+  {
+    TEST_CHECK(!mutt_regex_literal(NULL));
+  }
+
+  {
+    static const struct LiteralTest tests[] = {
+      // clang-format off
+      { "invoice",          "invoice" },
+      { "^invoice [0-9]+$", "invoice " },
+      { "foo.*barbaz",      "barbaz" },
+      { "ab+c",             "ab" },
+      { "colou?r",          "colo" },
+      { "a{2,3}bcd",        "bcd" },
+      { "\\.config\\w+",    ".config" },
+      { "[abc]hello",       "hello" },
+      { "[]x]yy",           "yy" },
+      { "[[:digit:]]abc",   "abc" },
+      { "[^[:space:]x]abc", "abc" },
+      { "[[=e=]]mail",      "mail" },
+      { "[[.].]]abc",       "abc" },
+      { "\\<word\\>s",      "word" },
+      { "\\`start",         "start" },
+      { "end\\'",           "end" },
+      { "x|y",              NULL },
+      { "(ab)c",            NULL },
+      { "abc\\",            NULL },
+      { "[abc",             NULL },
+      { "[[:digit:]",       NULL },
+      { "[[:digit]]",       NULL },
+      { ".*",               NULL },
+      // clang-format on
+    };
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      TEST_CASE(tests[i].regex);
+      char *literal = mutt_regex_literal(tests[i].regex);
+      TEST_CHECK_STR_EQ(literal, tests[i].literal);
+      FREE(&literal);
+    }
+  }
+}
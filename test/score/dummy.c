@@ -0,0 +1,42 @@
+/**
+ * @file
+ * Dummy code for working around build problems
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include "core/lib.h"
+#include "mx.h"
+
+struct Email;
+
+bool OptNeedRescore;
+bool OptNeedResort;
+bool OptSortSubthreads;
+
+/// Number of times an Email was queued for the header cache
+int HcacheSaves = 0;
+
+void mx_hcache_defer(struct Mailbox *m, struct Email *e)
+{
+  HcacheSaves++;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * Test code for mutt_score_message()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "score.h"
+#include "test_common.h" // IWYU pragma: keep
+
+extern int HcacheSaves;
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "score_threshold_delete", DT_NUMBER, -1,   0, NULL, },
+  { "score_threshold_flag",   DT_NUMBER, 9999, 0, NULL, },
+  { "score_threshold_read",   DT_NUMBER, -1,   0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+/**
+ * score_rules - Replace the score rules
+ * @param rules Arguments of the 'score' commands, NULL terminated
+ */
+static void score_rules(const char *const *rules)
+{
+  struct Buffer *buf = buf_pool_get();
+  struct Buffer *line = buf_pool_get();
+  struct Buffer *err = buf_pool_get();
+
+  buf_strcpy(line, "*");
+  buf_seek(line, 0);
+  TEST_CHECK(mutt_parse_unscore(buf, line, 0, err) == MUTT_CMD_SUCCESS);
+
+  for (; *rules; rules++)
+  {
+    buf_strcpy(line, *rules);
+    buf_seek(line, 0);
+    if (!TEST_CHECK(mutt_parse_score(buf, line, 0, err) == MUTT_CMD_SUCCESS))
+      TEST_MSG("%s: %s", *rules, buf_string(err));
+  }
+
+  buf_pool_release(&buf);
+  buf_pool_release(&line);
+  buf_pool_release(&err);
+}
+
+void test_mutt_score_message(void)
+{
+  // void mutt_score_message(struct Mailbox *m, struct Email *e, bool upd_mbox);
+
+  TEST_CHECK(cs_register_variables(SpaceMutt->sub->cs, Vars));
+
+  struct Email *e = email_new();
+  e->env = mutt_env_new();
+  mutt_env_set_subject(e->env, "hello world");
+
+  {
+    // Identical sub-expressions share a node
+    static const char *const rules[] = {
+      "'~s hello' 10", "'~s hello ~F' 5", "'!~s hello' 1", NULL,
+    };
+    score_rules(rules);
+    TEST_CHECK(mutt_score_nodes() == 4);
+    TEST_MSG("Expected: 4 nodes");
+    TEST_MSG("Actual  : %zu", mutt_score_nodes());
+
+    mutt_score_message(NULL, e, false);
+    TEST_CHECK(e->score == 10);
+    TEST_MSG("Expected: 10");
+    TEST_MSG("Actual  : %d", e->score);
+  }
+
+  {
+    // The score is reused until something the rules depend on changes
+    e->score = 1234;
+    mutt_score_message(NULL, e, false);
+    TEST_CHECK(e->score == 1234);
+
+    e->flagged = true;
+    mutt_score_message(NULL, e, false);
+    TEST_CHECK(e->score == 15);
+    TEST_MSG("Expected: 15");
+    TEST_MSG("Actual  : %d", e->score);
+    e->flagged = false;
+  }
+
+  {
+    // ~n sees the running score, so its node isn't shared between rules
+    static const char *const rules[] = {
+      "'~s hello' 10", "'~n 10' 5", "'~n 10-10' 1", NULL,
+    };
+    score_rules(rules);
+    mutt_score_message(NULL, e, false);
+    TEST_CHECK(e->score == 15);
+    TEST_MSG("Expected: 15");
+    TEST_MSG("Actual  : %d", e->score);
+  }
+
+  {
+    // A score is only saved in the header cache if the next session can use it
+    static const char *const fixed[] = { "'~s hello' 10", NULL };
+    score_rules(fixed);
+    HcacheSaves = 0;
+    mutt_score_message(NULL, e, false);
+    TEST_CHECK(HcacheSaves == 1);
+
+    static const char *const relative[] = { "'~s hello ~d <1d' 10", NULL };
+    score_rules(relative);
+    HcacheSaves = 0;
+    e->date_sent = mutt_date_now();
+    mutt_score_message(NULL, e, false);
+    TEST_CHECK(e->score == 10);
+    TEST_CHECK(HcacheSaves == 0);
+  }
+
+  static const char *const none[] = { NULL };
+  score_rules(none);
+  email_free(&e);
+}
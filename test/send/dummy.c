@@ -0,0 +1,75 @@
+/**
+ * @file
+ * Dummy code for working around build problems
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "core/lib.h"
+#include "mx.h"
+#include "postpone/lib.h"
+#include "send/sendmail.h"
+#include "send/smtp.h"
+
+struct ConfigSubset;
+struct ConnAccount;
+
+int mutt_invoke_sendmail(struct Mailbox *m, AddressList *from,
+                         AddressList *to, AddressList *cc,
+                         AddressList *bcc, const char *msg,
+                         bool eightbit, struct ConfigSubset *sub)
+{
+  return -1;
+}
+
+int mutt_smtp_send(const AddressList *from, const AddressList *to,
+                   const AddressList *cc, const AddressList *bcc,
+                   const char *msgfile, bool eightbit, struct ConfigSubset *sub)
+{
+  return -1;
+}
+
+int mutt_smtp_login(struct ConfigSubset *sub, struct ConnAccount *cac)
+{
+  return -1;
+}
+
+void mutt_update_num_postponed(void)
+{
+}
+
+bool mx_mbox_open(struct Mailbox *m, OpenMailboxFlags flags)
+{
+  return false;
+}
+
+enum MxStatus mx_mbox_close(struct Mailbox *m)
+{
+  return MX_STATUS_ERROR;
+}
+
+int mx_msg_commit(struct Mailbox *m, struct Message *msg)
+{
+  return -1;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file
+ * Test code for outbox_backoff()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <limits.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "email/lib.h"
+#include "send/lib.h"
+#include "test_common.h" // IWYU pragma: keep
+
+void test_outbox_backoff(void)
+{
+  // int outbox_backoff(int attempts, int delay);
+
+  {
+    // Nothing has failed yet
+    TEST_CHECK(outbox_backoff(0, 60) == 60);
+    TEST_CHECK(outbox_backoff(-1, 60) == 60);
+  }
+
+  {
+    // No delay
+    TEST_CHECK(outbox_backoff(3, 0) == 0);
+    TEST_CHECK(outbox_backoff(3, -5) == 0);
+  }
+
+  {
+    // The delay doubles after each failure
+    TEST_CHECK(outbox_backoff(1, 60) == 60);
+    TEST_CHECK(outbox_backoff(2, 60) == 120);
+    TEST_CHECK(outbox_backoff(3, 60) == 240);
+    TEST_CHECK(outbox_backoff(6, 60) == 1920);
+  }
+
+  {
+    // Up to an hour
+    TEST_CHECK(outbox_backoff(7, 60) == 3600);
+    TEST_CHECK(outbox_backoff(1, 7200) == 3600);
+    TEST_CHECK(outbox_backoff(INT_MAX, 60) == 3600);
+    TEST_CHECK(outbox_backoff(40, INT_MAX) == 3600);
+  }
+}
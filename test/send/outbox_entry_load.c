@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Test code for outbox_entry_load()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "email/lib.h"
+#include "core/lib.h"
+#include "send/lib.h"
+#include "test_common.h" // IWYU pragma: keep
+
+static struct ConfigDef Vars[] = {
+  // clang-format off
+  { "outbox", DT_PATH|D_PATH_DIR, 0, 0, NULL, },
+  { NULL },
+  // clang-format on
+};
+
+void test_outbox_entry_load(void)
+{
+  // struct OutboxEntry *outbox_entry_load(const char *id);
+  // int outbox_entry_save(const struct OutboxEntry *oe);
+
+  struct ConfigSet *cs = SpaceMutt->sub->cs;
+  TEST_CHECK(cs_register_variables(cs, Vars));
+
+  char tmpl[] = "/tmp/spacemutt-outbox-XXXXXX";
+  const char *dir = mkdtemp(tmpl);
+  if (!TEST_CHECK(dir != NULL))
+    return;
+  cs_str_string_set(cs, "outbox", dir, NULL);
+
+  {
+    // A missing entry
+    TEST_CHECK(outbox_entry_load("missing") == NULL);
+  }
+
+  {
+    // Every field survives the round trip
+    struct OutboxEntry oe = { 0 };
+    oe.id = "1700000000-42-0";
+    oe.from = "Alice <alice@example.com>";
+    oe.to = "bob@example.com, carol@example.com";
+    oe.cc = "dave@example.com";
+    oe.bcc = "eve@example.com";
+    oe.subject = "Lunch?";
+    oe.fcc = "=sent,=archive";
+    oe.error = "Connection refused";
+    oe.eightbit = true;
+    oe.state = OUTBOX_SENDING;
+    oe.attempts = 3;
+    oe.queued = 1700000000;
+    oe.next_try = 1700000480;
+    oe.started = 1700000500;
+    oe.pid = 12345;
+    TEST_CHECK(outbox_entry_save(&oe) == 0);
+
+    struct OutboxEntry *load = outbox_entry_load(oe.id);
+    if (TEST_CHECK(load != NULL))
+    {
+      TEST_CHECK_STR_EQ(load->id, oe.id);
+      TEST_CHECK_STR_EQ(load->from, oe.from);
+      TEST_CHECK_STR_EQ(load->to, oe.to);
+      TEST_CHECK_STR_EQ(load->cc, oe.cc);
+      TEST_CHECK_STR_EQ(load->bcc, oe.bcc);
+      TEST_CHECK_STR_EQ(load->subject, oe.subject);
+      TEST_CHECK_STR_EQ(load->fcc, oe.fcc);
+      TEST_CHECK_STR_EQ(load->error, oe.error);
+      TEST_CHECK(load->eightbit);
+      TEST_CHECK(load->state == OUTBOX_SENDING);
+      TEST_CHECK(load->attempts == 3);
+      TEST_CHECK(load->queued == 1700000000);
+      TEST_CHECK(load->next_try == 1700000480);
+      TEST_CHECK(load->started == 1700000500);
+      // The worker may outlive the SpaceMutt that started it
+      TEST_CHECK(load->pid == 12345);
+      outbox_entry_free(&load);
+    }
+  }
+
+  {
+    // Saving again replaces the entry
+    struct OutboxEntry oe = { 0 };
+    oe.id = "1700000000-42-0";
+    oe.state = OUTBOX_FAILED;
+    TEST_CHECK(outbox_entry_save(&oe) == 0);
+
+    struct OutboxEntry *load = outbox_entry_load(oe.id);
+    if (TEST_CHECK(load != NULL))
+    {
+      TEST_CHECK(load->state == OUTBOX_FAILED);
+      TEST_CHECK(!load->eightbit);
+      TEST_CHECK(load->attempts == 0);
+      TEST_CHECK(load->pid == 0);
+      outbox_entry_free(&load);
+    }
+  }
+
+  char path[256] = { 0 };
+  snprintf(path, sizeof(path), "%s/1700000000-42-0.env", dir);
+  unlink(path);
+  rmdir(dir);
+  cs_str_reset(cs, "outbox", NULL);
+}
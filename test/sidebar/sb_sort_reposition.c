@@ -0,0 +1,200 @@
+/**
+ * @file
+ * Test code for sb_sort_reposition()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/lib.h"
+#include "config/lib.h"
+#include "core/lib.h"
+#include "sidebar/private.h"
+
+#define NUM_MAILBOXES 8
+
+/**
+ * same_order - Do two lists of entries have the same order?
+ * @param a First list
+ * @param b Second list
+ * @retval true The lists match
+ */
+static bool same_order(struct SbEntryArray *a, struct SbEntryArray *b)
+{
+  if (ARRAY_SIZE(a) != ARRAY_SIZE(b))
+    return false;
+
+  struct SbEntry **sbep = NULL;
+  ARRAY_FOREACH(sbep, a)
+  {
+    if (*sbep != *ARRAY_GET(b, ARRAY_FOREACH_IDX))
+    {
+      TEST_MSG("Differ at %zu: %s", ARRAY_FOREACH_IDX, mailbox_path((*sbep)->mailbox));
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * mark_changed - Change a Mailbox's unread count and mark its entry dirty
+ * @param wdata  Sidebar data
+ * @param sbe    Entry
+ * @param unread New unread count
+ */
+static void mark_changed(struct SidebarWindowData *wdata, struct SbEntry *sbe, int unread)
+{
+  sbe->mailbox->msg_unread = unread;
+  sbe->dirty = true;
+  ARRAY_ADD(&wdata->changed, sbe);
+}
+
+/**
+ * reposition - Reposition the changed entries and clear their dirty flags
+ * @param wdata Sidebar data
+ * @param sort  Sort order
+ * @retval true The order changed
+ */
+static bool reposition(struct SidebarWindowData *wdata, enum SortType sort)
+{
+  bool moved = sb_sort_reposition(wdata, sort);
+
+  struct SbEntry **sbep = NULL;
+  ARRAY_FOREACH(sbep, &wdata->changed)
+  {
+    (*sbep)->dirty = false;
+  }
+  ARRAY_SHRINK(&wdata->changed, ARRAY_SIZE(&wdata->changed));
+  return moved;
+}
+
+/**
+ * check_sorted - Check the entries match a full sort
+ * @param wdata Sidebar data
+ * @param sort  Sort order
+ * @retval true The entries are in order
+ */
+static bool check_sorted(struct SidebarWindowData *wdata, enum SortType sort)
+{
+  struct SidebarWindowData full = { 0 };
+  ARRAY_INIT(&full.entries);
+  struct SbEntry **sbep = NULL;
+  ARRAY_FOREACH(sbep, &wdata->entries)
+  {
+    ARRAY_ADD(&full.entries, *sbep);
+  }
+  sb_sort_entries(&full, sort);
+
+  bool rc = same_order(&wdata->entries, &full.entries);
+  ARRAY_FREE(&full.entries);
+  return rc;
+}
+
+void test_sb_sort_reposition(void)
+{
+  // bool sb_sort_reposition(struct SidebarWindowData *wdata, enum SortType sort);
+
+  struct Mailbox m[NUM_MAILBOXES] = { 0 };
+  struct SbEntry sbe[NUM_MAILBOXES] = { 0 };
+  struct SidebarWindowData wdata = { 0 };
+  ARRAY_INIT(&wdata.entries);
+  ARRAY_INIT(&wdata.changed);
+
+  for (int i = 0; i < NUM_MAILBOXES; i++)
+  {
+    char path[32] = { 0 };
+    snprintf(path, sizeof(path), "/mail/box%d", i);
+    buf_strcpy(&m[i].pathbuf, path);
+    m[i].msg_unread = 10 * i;
+    m[i].gen = i;
+    sbe[i].mailbox = &m[i];
+    ARRAY_ADD(&wdata.entries, &sbe[i]);
+  }
+
+  const enum SortType sort = SORT_UNREAD;
+  sb_sort_entries(&wdata, sort);
+  TEST_CHECK(check_sorted(&wdata, sort));
+
+  {
+    // Nothing has changed
+    TEST_CHECK(!reposition(&wdata, sort));
+  }
+
+  {
+    // One entry changes, but keeps its place
+    mark_changed(&wdata, &sbe[3], 31);
+    TEST_CHECK(!reposition(&wdata, sort));
+    TEST_CHECK(check_sorted(&wdata, sort));
+  }
+
+  {
+    // Several entries change, passing each other
+    mark_changed(&wdata, &sbe[1], 65);
+    mark_changed(&wdata, &sbe[6], 5);
+    mark_changed(&wdata, &sbe[2], 75);
+    mark_changed(&wdata, &sbe[5], 15);
+    TEST_CHECK(reposition(&wdata, sort));
+    TEST_CHECK(check_sorted(&wdata, sort));
+  }
+
+  {
+    // Neighbouring entries swap places
+    struct SbEntry *first = *ARRAY_GET(&wdata.entries, 0);
+    struct SbEntry *second = *ARRAY_GET(&wdata.entries, 1);
+    const int unread1 = first->mailbox->msg_unread;
+    const int unread2 = second->mailbox->msg_unread;
+    mark_changed(&wdata, first, unread2);
+    mark_changed(&wdata, second, unread1);
+    TEST_CHECK(reposition(&wdata, sort));
+    TEST_CHECK(check_sorted(&wdata, sort));
+    TEST_CHECK(*ARRAY_GET(&wdata.entries, 0) == second);
+  }
+
+  {
+    // Every entry changes, in reverse order
+    for (int i = 0; i < NUM_MAILBOXES; i++)
+      mark_changed(&wdata, &sbe[i], 100 - (7 * i) % 40);
+    reposition(&wdata, sort | SORT_REVERSE);
+    TEST_CHECK(check_sorted(&wdata, sort | SORT_REVERSE));
+  }
+
+  sb_sort_entries(&wdata, sort);
+
+  {
+    // Ties are broken by path
+    for (int i = 0; i < NUM_MAILBOXES; i += 2)
+      mark_changed(&wdata, &sbe[i], 50);
+    reposition(&wdata, sort);
+    TEST_CHECK(check_sorted(&wdata, sort));
+  }
+
+  {
+    // Orders that don't depend on the counts never move
+    mark_changed(&wdata, &sbe[0], 1000);
+    TEST_CHECK(!reposition(&wdata, SORT_PATH));
+  }
+
+  ARRAY_FREE(&wdata.entries);
+  ARRAY_FREE(&wdata.changed);
+  for (int i = 0; i < NUM_MAILBOXES; i++)
+    buf_dealloc(&m[i].pathbuf);
+}
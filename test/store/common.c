@@ -70,6 +70,15 @@ bool test_store_degenerate(const struct StoreOps *store_ops, const char *name)
   if (!TEST_CHECK(store_ops->delete_record(NULL, NULL, 0) != 0))
     return false;
 
+  if (!TEST_CHECK(store_ops->sync(NULL) != 0))
+    return false;
+
+  if (!TEST_CHECK(store_ops->walk(NULL, NULL, NULL) != 0))
+    return false;
+
+  if (!TEST_CHECK(store_ops->compact(NULL) != 0))
+    return false;
+
   store_ops->close(NULL);
   TEST_CHECK_(1, "store_ops->close(NULL)");
 
@@ -82,6 +91,16 @@ bool test_store_degenerate(const struct StoreOps *store_ops, const char *name)
   return true;
 }
 
+/**
+ * count_key - Count the Keys in a Store - Implements ::store_walk_t
+ */
+static bool count_key(const char *key, size_t klen, void *wdata)
+{
+  int *count = wdata;
+  (*count)++;
+  return true;
+}
+
 bool test_store_db(const struct StoreOps *store_ops, StoreHandle *store_handle)
 {
   if (!store_ops || !store_handle)
@@ -97,6 +116,10 @@ bool test_store_db(const struct StoreOps *store_ops, StoreHandle *store_handle)
   if (!TEST_CHECK(rc == 0))
     return false;
 
+  rc = store_ops->sync(store_handle);
+  if (!TEST_CHECK(rc == 0))
+    return false;
+
   void *data = NULL;
   vlen = 0;
   data = store_ops->fetch(store_handle, key, klen, &vlen);
@@ -106,9 +129,23 @@ bool test_store_db(const struct StoreOps *store_ops, StoreHandle *store_handle)
   store_ops->free(store_handle, &data);
   TEST_CHECK_(1, "store_ops->free(store_handle, &data)");
 
+  int count = 0;
+  rc = store_ops->walk(store_handle, count_key, &count);
+  if (!TEST_CHECK(rc == 0) || !TEST_CHECK(count == 1))
+    return false;
+
   rc = store_ops->delete_record(store_handle, key, klen);
   if (!TEST_CHECK(rc == 0))
     return false;
 
+  count = 0;
+  rc = store_ops->walk(store_handle, count_key, &count);
+  if (!TEST_CHECK(rc == 0) || !TEST_CHECK(count == 0))
+    return false;
+
+  rc = store_ops->compact(store_handle);
+  if (!TEST_CHECK(rc == 0))
+    return false;
+
   return true;
 }
@@ -26,12 +26,109 @@
 #include "acutest.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include "mutt/lib.h"
 #include "store/lib.h"
 #include "common.h" // IWYU pragma: keep
 
 #define DB_NAME "lmdb"
 
+/**
+ * file_size - Get the size of a file
+ * @param path Path to the file
+ * @retval num Size of the file
+ */
+static off_t file_size(const char *path)
+{
+  struct stat st = { 0 };
+  if (stat(path, &st) != 0)
+    return -1;
+  return st.st_size;
+}
+
+/**
+ * test_sync - Check that other connections see the writes once they're committed
+ * @param store_ops Store API
+ * @param path      Path to the database
+ */
+static void test_sync(const struct StoreOps *store_ops, const char *path)
+{
+  StoreHandle *sh = store_ops->open(path, true);
+  StoreHandle *other = store_ops->open(path, false);
+  TEST_CHECK(sh && other);
+
+  TEST_CHECK(store_ops->store(sh, "key", 3, "value", 5) == 0);
+
+  size_t vlen = 0;
+  void *data = store_ops->fetch(other, "key", 3, &vlen);
+  TEST_CHECK(data == NULL);
+
+  // The reader keeps its snapshot until it syncs, too
+  TEST_CHECK(store_ops->sync(sh) == 0);
+  TEST_CHECK(store_ops->sync(other) == 0);
+  data = store_ops->fetch(other, "key", 3, &vlen);
+  TEST_CHECK((data != NULL) && (vlen == 5));
+  store_ops->free(other, &data);
+
+  // Nothing to commit
+  TEST_CHECK(store_ops->sync(sh) == 0);
+
+  store_ops->close(&other);
+  store_ops->close(&sh);
+}
+
+/**
+ * test_compact - Check that compaction waits for other connections
+ * @param store_ops Store API
+ * @param path      Path to the database
+ */
+static void test_compact(const struct StoreOps *store_ops, const char *path)
+{
+  char key[32] = { 0 };
+  char value[1024] = { 0 };
+  memset(value, 'x', sizeof(value));
+
+  StoreHandle *sh = store_ops->open(path, true);
+  TEST_CHECK(sh != NULL);
+  for (int i = 0; i < 2000; i++)
+  {
+    snprintf(key, sizeof(key), "key%d", i);
+    store_ops->store(sh, key, strlen(key), value, sizeof(value));
+  }
+  for (int i = 1; i < 2000; i++)
+  {
+    snprintf(key, sizeof(key), "key%d", i);
+    store_ops->delete_record(sh, key, strlen(key));
+  }
+  store_ops->close(&sh);
+  const off_t full = file_size(path);
+
+  // Another connection has the file open, so it's left alone
+  sh = store_ops->open(path, false);
+  StoreHandle *other = store_ops->open(path, false);
+  TEST_CHECK(sh && other);
+  TEST_CHECK(store_ops->compact(sh) == 0);
+  TEST_CHECK(file_size(path) == full);
+
+  size_t vlen = 0;
+  void *data = store_ops->fetch(other, "key0", 4, &vlen);
+  TEST_CHECK((data != NULL) && (vlen == sizeof(value)));
+  store_ops->free(other, &data);
+  store_ops->close(&other);
+
+  // On its own, the file is replaced by a compacted copy
+  TEST_CHECK(store_ops->compact(sh) == 0);
+  TEST_CHECK(file_size(path) < full);
+  TEST_MSG("Size before %ld, after %ld", (long) full, (long) file_size(path));
+
+  data = store_ops->fetch(sh, "key0", 4, &vlen);
+  TEST_CHECK((data != NULL) && (vlen == sizeof(value)));
+  store_ops->free(sh, &data);
+  store_ops->close(&sh);
+}
+
 void test_store_lmdb(void)
 {
   struct Buffer *path = buf_pool_get();
@@ -53,5 +150,11 @@ void test_store_lmdb(void)
 
   store_ops->close(&store_handle);
 
+  buf_addstr(path, "-sync");
+  test_sync(store_ops, buf_string(path));
+
+  buf_addstr(path, "-compact");
+  test_compact(store_ops, buf_string(path));
+
   buf_pool_release(&path);
 }
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * Test code for the logdb store
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/lib.h"
+#include "store/lib.h"
+#include "common.h" // IWYU pragma: keep
+
+#define DB_NAME "logdb"
+
+/**
+ * check_value - Check the Value of a Key
+ * @param store_ops    Store API
+ * @param store_handle Store
+ * @param key          Key
+ * @param expected     Expected Value, NULL if the Key shouldn't exist
+ * @retval true The Value matches
+ */
+static bool check_value(const struct StoreOps *store_ops,
+                        StoreHandle *store_handle, const char *key, const char *expected)
+{
+  size_t vlen = 0;
+  void *data = store_ops->fetch(store_handle, key, strlen(key), &vlen);
+  bool rc;
+  if (expected)
+    rc = data && (vlen == strlen(expected)) && (memcmp(data, expected, vlen) == 0);
+  else
+    rc = !data;
+  store_ops->free(store_handle, &data);
+  return rc;
+}
+
+void test_store_logdb(void)
+{
+  struct Buffer *path = buf_pool_get();
+  struct Buffer *key = buf_pool_get();
+  struct Buffer *value = buf_pool_get();
+
+  const struct StoreOps *store_ops = store_get_backend_ops(DB_NAME);
+  TEST_CHECK(store_ops != NULL);
+
+  TEST_CHECK(test_store_degenerate(store_ops, DB_NAME) == true);
+
+  TEST_CHECK(test_store_setup(path) == true);
+
+  buf_addch(path, '/');
+  buf_addstr(path, DB_NAME);
+
+  StoreHandle *store_handle = store_ops->open(buf_string(path), true);
+  TEST_CHECK(store_handle != NULL);
+
+  TEST_CHECK(test_store_db(store_ops, store_handle) == true);
+
+  // Enough keys to grow the index, then overwrite and delete some
+  for (int i = 0; i < 5000; i++)
+  {
+    buf_printf(key, "key%d", i);
+    buf_printf(value, "value%d", i);
+    TEST_CHECK(store_ops->store(store_handle, buf_string(key), buf_len(key),
+                                value->data, buf_len(value)) == 0);
+  }
+  TEST_CHECK(store_ops->store(store_handle, "key1", 4, "changed", 7) == 0);
+  TEST_CHECK(store_ops->delete_record(store_handle, "key2", 4) == 0);
+  TEST_CHECK(store_ops->delete_record(store_handle, "missing", 7) == 0);
+
+  TEST_CHECK(check_value(store_ops, store_handle, "key1", "changed"));
+  TEST_CHECK(check_value(store_ops, store_handle, "key2", NULL));
+  TEST_CHECK(check_value(store_ops, store_handle, "key4999", "value4999"));
+
+  // Compaction drops the dead records, but keeps the live ones
+  struct stat st = { 0 };
+  TEST_CHECK(stat(buf_string(path), &st) == 0);
+  const off_t before = st.st_size;
+  for (int i = 2500; i < 5000; i++)
+  {
+    buf_printf(key, "key%d", i);
+    TEST_CHECK(store_ops->delete_record(store_handle, buf_string(key), buf_len(key)) == 0);
+  }
+  TEST_CHECK(store_ops->compact(store_handle) == 0);
+  TEST_CHECK(stat(buf_string(path), &st) == 0);
+  TEST_CHECK(st.st_size < before);
+  TEST_CHECK(check_value(store_ops, store_handle, "key1", "changed"));
+  TEST_CHECK(check_value(store_ops, store_handle, "key2499", "value2499"));
+  TEST_CHECK(check_value(store_ops, store_handle, "key2500", NULL));
+  for (int i = 2500; i < 5000; i++)
+  {
+    buf_printf(key, "key%d", i);
+    buf_printf(value, "value%d", i);
+    TEST_CHECK(store_ops->store(store_handle, buf_string(key), buf_len(key),
+                                value->data, buf_len(value)) == 0);
+  }
+
+  // A second connection is read-only while the first is open
+  StoreHandle *reader = store_ops->open(buf_string(path), false);
+  TEST_CHECK(reader != NULL);
+  TEST_CHECK(store_ops->store(reader, "key3", 4, "nope", 4) != 0);
+  store_ops->close(&reader);
+
+  store_ops->close(&store_handle);
+  TEST_CHECK(store_handle == NULL);
+
+  // The data survives, with or without the index
+  for (int i = 0; i < 2; i++)
+  {
+    store_handle = store_ops->open(buf_string(path), false);
+    TEST_CHECK(store_handle != NULL);
+    TEST_CHECK(check_value(store_ops, store_handle, "key0", "value0"));
+    TEST_CHECK(check_value(store_ops, store_handle, "key1", "changed"));
+    TEST_CHECK(check_value(store_ops, store_handle, "key2", NULL));
+    TEST_CHECK(check_value(store_ops, store_handle, "key4999", "value4999"));
+    store_ops->close(&store_handle);
+
+    buf_printf(key, "%s.idx", buf_string(path));
+    TEST_CHECK(unlink(buf_string(key)) == 0);
+  }
+
+  buf_pool_release(&path);
+  buf_pool_release(&key);
+  buf_pool_release(&value);
+}
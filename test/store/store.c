@@ -51,4 +51,8 @@ void test_store_store(void)
 #ifdef HAVE_TC
   TEST_CHECK(store_is_valid_backend("tokyocabinet") == true);
 #endif
+
+#ifdef HAVE_LOGDB
+  TEST_CHECK(store_is_valid_backend("logdb") == true);
+#endif
 }
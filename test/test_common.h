@@ -33,6 +33,10 @@
 #include <time.h>
 #include "mutt/lib.h"
 
+struct Mailbox;
+
+extern struct Mailbox *TestCurrentMailbox;
+
 void test_gen_path(struct Buffer *buf, const char *fmt);
 
 bool test_spacemutt_create(void);
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * Common code for the trace tests
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glib.h>
+#include "mutt/lib.h"
+#include "common.h"
+
+/**
+ * trace_read - Save the trace and read it back
+ * @retval ptr Contents of the trace file, must be freed
+ * @retval NULL Error
+ */
+char *trace_read(void)
+{
+  char path[] = "/tmp/spacemutt-trace-XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0)
+    return NULL;
+  close(fd);
+
+  char *json = NULL;
+  struct stat st = { 0 };
+  if (trace_dump(path) && (stat(path, &st) == 0))
+  {
+    FILE *fp = fopen(path, "r");
+    if (fp)
+    {
+      json = g_new0(char, st.st_size + 1);
+      if (fread(json, 1, st.st_size, fp) != (size_t) st.st_size)
+        FREE(&json);
+      fclose(fp);
+    }
+  }
+
+  unlink(path);
+  return json;
+}
+
+/**
+ * trace_event - Does an event have a field?
+ * @param json  Contents of the trace file
+ * @param name  Name of the event
+ * @param field Text to find in the event, e.g. "\"depth\":1"
+ * @retval true One of the events called name contains field
+ *
+ * Each event is written on a line of its own.
+ */
+bool trace_event(const char *json, const char *name, const char *field)
+{
+  char key[256] = { 0 };
+  snprintf(key, sizeof(key), "\"name\":\"%s\"", name);
+
+  for (const char *p = strstr(json, key); p; p = strstr(p + 1, key))
+  {
+    const char *start = p;
+    while ((start > json) && (start[-1] != '\n'))
+      start--;
+    const char *end = strchr(p, '\n');
+    if (!end)
+      end = p + strlen(p);
+
+    char *line = g_strndup(start, end - start);
+    const bool found = strstr(line, field);
+    FREE(&line);
+    if (found)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * trace_count_str - Count the occurrences of a string
+ * @param json Contents of the trace file
+ * @param str  String to count
+ * @retval num Number of occurrences
+ */
+int trace_count_str(const char *json, const char *str)
+{
+  int count = 0;
+  for (const char *p = strstr(json, str); p; p = strstr(p + 1, str))
+    count++;
+  return count;
+}
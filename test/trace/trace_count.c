@@ -0,0 +1,70 @@
+/**
+ * @file
+ * Test code for trace_count()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "common.h"
+
+void test_trace_count(void)
+{
+  // void trace_count(const char *name, int64_t delta);
+
+  trace_cleanup();
+
+  {
+    // Nothing is counted while tracing is disabled
+    trace_counter("disabled", 1);
+    trace_count(NULL, 1);
+  }
+
+  trace_enable(true);
+
+  {
+    trace_counter("hits", 2);
+    trace_counter("hits", 3);
+    trace_counter("misses", -1);
+
+    char *json = trace_read();
+    TEST_CHECK(json != NULL);
+    TEST_CHECK(trace_event(json, "hits", "\"ph\":\"C\""));
+    TEST_CHECK(trace_event(json, "hits", "\"args\":{\"value\":5}"));
+    TEST_CHECK(trace_event(json, "misses", "\"args\":{\"value\":-1}"));
+    TEST_CHECK(!strstr(json, "\"disabled\""));
+    FREE(&json);
+  }
+
+  {
+    // Turning tracing off keeps the counts
+    trace_enable(false);
+    trace_counter("hits", 10);
+
+    char *json = trace_read();
+    TEST_CHECK(json && trace_event(json, "hits", "\"args\":{\"value\":5}"));
+    FREE(&json);
+  }
+
+  trace_cleanup();
+}
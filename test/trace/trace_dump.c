@@ -0,0 +1,91 @@
+/**
+ * @file
+ * Test code for trace_dump()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stddef.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "common.h"
+
+void test_trace_dump(void)
+{
+  // bool trace_dump(const char *path);
+
+  trace_cleanup();
+
+  {
+    TEST_CHECK(!trace_dump(NULL));
+    TEST_CHECK(!trace_dump(""));
+  }
+
+  {
+    // An empty trace is still a complete file
+    char *json = trace_read();
+    TEST_CHECK(json != NULL);
+    TEST_CHECK(mutt_str_startswith(json, "{\"traceEvents\":[\n"));
+    TEST_CHECK(strstr(json, "\"histograms\":{}") != NULL);
+    TEST_CHECK(strstr(json, "\"droppedEvents\":0\n}\n") != NULL);
+    FREE(&json);
+  }
+
+  trace_enable(true);
+
+  {
+    // Strings are escaped
+    struct TraceSpan span = { 0 };
+    trace_begin(&span, "test", "escape");
+    trace_end(&span, "a\"b\\c\nd\x01");
+
+    char *json = trace_read();
+    TEST_CHECK(json != NULL);
+    TEST_CHECK(trace_event(json, "escape", "\"detail\":\"a\\\"b\\\\c\\u000ad\\u0001\""));
+    TEST_MSG("%s", json);
+    FREE(&json);
+  }
+
+  {
+    // Each async span is a begin and an end, with the same id
+    struct TraceSpan one = { 0 };
+    struct TraceSpan two = { 0 };
+    trace_begin_async(&one, "test", "one");
+    trace_begin_async(&two, "test", "two");
+    trace_end(&one, NULL);
+    trace_end(&two, NULL);
+
+    char *json = trace_read();
+    TEST_CHECK(json != NULL);
+    TEST_CHECK(trace_event(json, "one", "\"ph\":\"b\",\"id\":0,"));
+    TEST_CHECK(trace_event(json, "one", "\"ph\":\"e\",\"id\":0,"));
+    TEST_CHECK(trace_event(json, "two", "\"ph\":\"b\",\"id\":1,"));
+    TEST_CHECK(trace_event(json, "two", "\"ph\":\"e\",\"id\":1,"));
+    TEST_CHECK(trace_count_str(json, "\"ph\":\"b\"") == trace_count_str(json, "\"ph\":\"e\""));
+
+    // Every span has a histogram
+    TEST_CHECK(strstr(json, "\"one\":{\"count\":1,") != NULL);
+    TEST_CHECK(strstr(json, "\"escape\":{\"count\":1,") != NULL);
+    FREE(&json);
+  }
+
+  trace_cleanup();
+}
@@ -0,0 +1,94 @@
+/**
+ * @file
+ * Test code for trace_span_end()
+ *
+ * @authors
+ * Copyright (C) 2024 SpaceMutt developers
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "config.h"
+#include "acutest.h"
+#include <stdbool.h>
+#include <string.h>
+#include "mutt/lib.h"
+#include "common.h"
+
+void test_trace_span_end(void)
+{
+  // void trace_span_end(struct TraceSpan *span, const char *detail);
+
+  trace_cleanup();
+
+  {
+    // Nothing is recorded while tracing is disabled
+    struct TraceSpan span = { 0 };
+    trace_begin(&span, "test", "disabled");
+    TEST_CHECK(span.start_ns == 0);
+    trace_end(&span, NULL);
+    trace_span_end(NULL, NULL);
+
+    char *json = trace_read();
+    TEST_CHECK(json && !strstr(json, "\"disabled\""));
+    FREE(&json);
+  }
+
+  trace_enable(true);
+
+  {
+    // Nested spans record their depth
+    struct TraceSpan outer = { 0 };
+    struct TraceSpan inner = { 0 };
+    trace_begin(&outer, "test", "outer");
+    trace_begin(&inner, "test", "inner");
+    trace_end(&inner, NULL);
+    TEST_CHECK(inner.start_ns == 0);
+    trace_end(&outer, NULL);
+
+    // Ending a span twice doesn't record it twice
+    trace_end(&inner, NULL);
+
+    char *json = trace_read();
+    TEST_CHECK(json != NULL);
+    TEST_CHECK(trace_event(json, "inner", "\"ph\":\"X\""));
+    TEST_CHECK(trace_event(json, "inner", "\"depth\":1"));
+    TEST_CHECK(trace_event(json, "outer", "\"depth\":0"));
+    TEST_CHECK(trace_count_str(json, "\"name\":\"inner\",\"ph\"") == 1);
+    FREE(&json);
+  }
+
+  {
+    // An async span doesn't change the depth of the spans inside it
+    struct TraceSpan async = { 0 };
+    struct TraceSpan sync = { 0 };
+    trace_begin_async(&async, "test", "async");
+    trace_begin(&sync, "test", "sync");
+    trace_end(&sync, NULL);
+    trace_end(&async, "detail");
+
+    char *json = trace_read();
+    TEST_CHECK(json != NULL);
+    TEST_CHECK(trace_event(json, "sync", "\"depth\":0"));
+    TEST_CHECK(trace_event(json, "async", "\"ph\":\"b\""));
+    TEST_CHECK(trace_event(json, "async", "\"ph\":\"e\""));
+    TEST_CHECK(trace_event(json, "async", "\"args\":{\"detail\":\"detail\"}"));
+    TEST_CHECK(!trace_event(json, "async", "\"depth\""));
+    FREE(&json);
+  }
+
+  trace_cleanup();
+}